@@ -0,0 +1,507 @@
+/* =========================================================================
+   Copyright (c) 2010-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+//
+// *** System
+//
+#include <iostream>
+#include <vector>
+#include <map>
+#include <string>
+#include <cmath>
+#include <stdlib.h>
+
+//
+// *** Boost
+//
+#include <boost/numeric/ublas/matrix_sparse.hpp>
+#include <boost/numeric/ublas/vector.hpp>
+#include <boost/numeric/ublas/operation_sparse.hpp>
+
+//
+// *** ViennaCL
+//
+#define VIENNACL_WITH_UBLAS 1
+#include "viennacl/linalg/cg.hpp"
+#include "viennacl/linalg/amg.hpp"
+
+#include "sparse_test_problems.hpp"
+
+
+//
+// -------------------------------------------------------------
+//
+namespace ublas = boost::numeric::ublas;
+
+template <typename NumericT>
+void copy_to_ublas(std::vector< std::map<unsigned int, NumericT> > const & A_host, ublas::compressed_matrix<NumericT> & A)
+{
+  A = ublas::compressed_matrix<NumericT>(A_host.size(), A_host.size());
+  for (std::size_t i=0; i<A_host.size(); ++i)
+    for (typename std::map<unsigned int, NumericT>::const_iterator it = A_host[i].begin(); it != A_host[i].end(); ++it)
+      A(i, it->first) = it->second;
+}
+
+/** @brief Runs CG with the supplied AMG preconditioner, checks the residual and returns the number of iterations (zero on failure) */
+template <typename NumericT, typename PrecondT>
+std::size_t amg_cg(ublas::compressed_matrix<NumericT> const & A, ublas::vector<NumericT> const & b, PrecondT const & precond,
+                   NumericT epsilon, std::string const & name)
+{
+  viennacl::linalg::cg_tag tag(epsilon / 10, 500);
+  ublas::vector<NumericT> x = viennacl::linalg::solve(A, b, tag, precond);
+  ublas::vector<NumericT> r = b - ublas::prod(A, x);
+  NumericT res = ublas::norm_2(r) / ublas::norm_2(b);
+  std::cout << "  > " << name << ": " << tag.iters() << " iterations, residual " << res << std::endl;
+  if (res > 10 * epsilon)
+  {
+    std::cout << "# Error: residual too large" << std::endl;
+    return 0;
+  }
+  return tag.iters();
+}
+
+template <typename NumericT>
+int test_hierarchy(NumericT epsilon, std::size_t iters_unpreconditioned, unsigned int coarse, unsigned int interpol,
+                   NumericT threshold, NumericT interpolweight, std::string const & name, unsigned int slices = 0)
+{
+  typedef ublas::compressed_matrix<NumericT>    MatrixType;
+
+  std::size_t N = 24;
+  std::size_t n = N * N;
+
+  std::vector< std::map<unsigned int, NumericT> > A_host;
+  variable_diffusion_2d(N, NumericT(1), A_host);
+  MatrixType A;
+  copy_to_ublas(A_host, A);
+
+  std::vector<NumericT> b_host(n);
+  fill_reproducible(b_host, 71, NumericT(1));
+  ublas::vector<NumericT> b(n);
+  std::copy(b_host.begin(), b_host.end(), b.begin());
+
+  std::cout << "# Testing hierarchy, " << name << std::endl;
+
+  viennacl::linalg::amg_tag tag(coarse, interpol, threshold, interpolweight, 0.67, 2, 2, 0);
+  tag.set_slices(slices);
+  viennacl::linalg::amg_precond<MatrixType> precond(A, tag);
+  precond.setup();
+
+  ublas::vector<NumericT> avgstencil;
+  NumericT complexity = precond.calc_complexity(avgstencil);
+  std::cout << "  > levels: " << avgstencil.size() << ", operator complexity: " << complexity << std::endl;
+  if (avgstencil.size() < 2 || complexity < NumericT(1) || complexity > NumericT(6))
+  {
+    std::cout << "# Error: unexpected hierarchy" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::size_t iters = amg_cg(A, b, precond, epsilon, "CG with AMG");
+  if (iters == 0)
+    return EXIT_FAILURE;
+  if (iters >= iters_unpreconditioned)
+  {
+    std::cout << "# Error: AMG did not reduce the number of CG iterations" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // R = P^T, Galerkin coarse operators and symmetric smoothing yield a symmetric preconditioner: u^T M v = v^T M u
+  std::vector<NumericT> u_host(n), v_host(n);
+  fill_reproducible(u_host, 83);
+  fill_reproducible(v_host, 89);
+  ublas::vector<NumericT> u(n), v(n);
+  std::copy(u_host.begin(), u_host.end(), u.begin());
+  std::copy(v_host.begin(), v_host.end(), v.begin());
+  ublas::vector<NumericT> Mu = u, Mv = v;
+  precond.apply(Mu);
+  precond.apply(Mv);
+  NumericT asymmetry = std::fabs(ublas::inner_prod(u, Mv) - ublas::inner_prod(v, Mu)) / (ublas::norm_2(u) * ublas::norm_2(Mv));
+  std::cout << "  > |u^T M v - v^T M u| / (|u| |M v|) = " << asymmetry << std::endl;
+  if (asymmetry > epsilon)
+  {
+    std::cout << "# Error: AMG preconditioner is not symmetric" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+template <typename NumericT>
+int test_resetup(NumericT epsilon, unsigned int coarse, unsigned int interpol, NumericT threshold, NumericT interpolweight, std::string const & name)
+{
+  typedef ublas::compressed_matrix<NumericT>    MatrixType;
+
+  std::size_t N = 24;
+  std::size_t n = N * N;
+
+  std::vector< std::map<unsigned int, NumericT> > A_host;
+  variable_diffusion_2d(N, NumericT(1), A_host);
+  MatrixType A;
+  copy_to_ublas(A_host, A);
+
+  // same sparsity pattern, different coefficients:
+  variable_diffusion_2d(N, NumericT(1.5), A_host);
+  MatrixType A_new;
+  copy_to_ublas(A_host, A_new);
+
+  std::vector<NumericT> b_host(n);
+  fill_reproducible(b_host, 71, NumericT(1));
+  ublas::vector<NumericT> b(n);
+  std::copy(b_host.begin(), b_host.end(), b.begin());
+
+  std::cout << "# Testing numeric re-setup, " << name << std::endl;
+
+  viennacl::linalg::amg_tag tag(coarse, interpol, threshold, interpolweight, 0.67, 2, 2, 0);
+  viennacl::linalg::amg_precond<MatrixType> precond(A, tag);
+  precond.setup();
+  if (amg_cg(A, b, precond, epsilon, "initial setup") == 0)
+    return EXIT_FAILURE;
+
+  viennacl::linalg::amg_precond<MatrixType> precond_new(A_new, tag);
+  precond_new.setup();
+  std::size_t iters_new_setup = amg_cg(A_new, b, precond_new, epsilon, "full setup for new values");
+  if (iters_new_setup == 0)
+    return EXIT_FAILURE;
+
+  precond.resetup(A_new);
+  std::size_t iters_resetup = amg_cg(A_new, b, precond, epsilon, "re-setup for new values");
+  if (iters_resetup == 0)
+    return EXIT_FAILURE;
+  if (iters_resetup > iters_new_setup + 3)
+  {
+    std::cout << "# Error: re-setup is considerably worse than a full setup" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // re-setup with the original values reproduces the original hierarchy:
+  precond.resetup(A);
+  viennacl::linalg::amg_precond<MatrixType> precond_ref(A, tag);
+  precond_ref.setup();
+  ublas::vector<NumericT> v1 = b, v2 = b;
+  precond.apply(v1);
+  precond_ref.apply(v2);
+  NumericT diff = ublas::norm_2(v1 - v2) / ublas::norm_2(v2);
+  std::cout << "  > relative difference after re-setup with the original values: " << diff << std::endl;
+  if (diff > epsilon)
+  {
+    std::cout << "# Error: re-setup does not reproduce the original preconditioner" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+/** @brief Computes the number of coarse points of a two-level AG hierarchy, optionally with the constant near-nullspace vector (node aggregation) */
+template <typename NumericT>
+std::size_t ag_coarse_size(ublas::compressed_matrix<NumericT> const & A, NumericT threshold, bool with_nullspace)
+{
+  viennacl::linalg::amg_tag tag(VIENNACL_AMG_COARSE_AG, VIENNACL_AMG_INTERPOL_AG, threshold, 0, 0.67, 2, 2, 1);
+  viennacl::linalg::amg_precond<ublas::compressed_matrix<NumericT> > precond(A, tag);
+  if (with_nullspace)
+    precond.set_nullspace(std::vector< std::vector<NumericT> >(1, std::vector<NumericT>(A.size1(), NumericT(1))));
+  precond.setup();
+
+  // the coarse operator holds (complexity - 1) * nnz(A) nonzeros with avgstencil[1] nonzeros per row
+  ublas::vector<NumericT> avgstencil;
+  NumericT complexity = precond.calc_complexity(avgstencil);
+  return static_cast<std::size_t>((complexity - NumericT(1)) * NumericT(A.nnz()) / avgstencil[1] + NumericT(0.5));
+}
+
+/** @brief The strength threshold of AG coarsening applies on the finest level: weak couplings are not aggregated */
+template <typename NumericT>
+int test_strength_threshold()
+{
+  std::size_t N = 24;
+
+  // 9-point stencil with weak diagonal couplings
+  std::vector< std::map<unsigned int, NumericT> > A_host(N * N);
+  for (std::size_t i=0; i<N; ++i)
+    for (std::size_t j=0; j<N; ++j)
+    {
+      unsigned int row = static_cast<unsigned int>(i * N + j);
+      for (long di=-1; di<=1; ++di)
+        for (long dj=-1; dj<=1; ++dj)
+        {
+          long ii = static_cast<long>(i) + di;
+          long jj = static_cast<long>(j) + dj;
+          if ((di != 0 || dj != 0) && ii >= 0 && jj >= 0 && ii < static_cast<long>(N) && jj < static_cast<long>(N))
+            A_host[row][static_cast<unsigned int>(ii * static_cast<long>(N) + jj)] = (di != 0 && dj != 0) ? NumericT(-0.01) : NumericT(-1);
+        }
+      A_host[row][row] = NumericT(4.04);
+    }
+  ublas::compressed_matrix<NumericT> A;
+  copy_to_ublas(A_host, A);
+
+  std::cout << "# Testing strength threshold of AG coarsening on the finest level" << std::endl;
+
+  for (int with_nullspace = 0; with_nullspace < 2; ++with_nullspace)
+  {
+    std::size_t coarse_all = ag_coarse_size(A, NumericT(0), with_nullspace != 0);
+    std::size_t coarse_strong = ag_coarse_size(A, NumericT(0.08), with_nullspace != 0);
+    std::cout << "  > " << (with_nullspace ? "node" : "point") << " aggregation, coarse points without threshold: " << coarse_all
+              << ", with threshold: " << coarse_strong << std::endl;
+
+    // Without the weak diagonal couplings the aggregates are smaller, hence the coarse level is larger
+    if (coarse_strong <= coarse_all)
+    {
+      std::cout << "# Error: weak connections were aggregated on the finest level" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
+
+/** @brief The Chebyshev smoother with the Lanczos bounds for D^{-1} A on each level */
+template <typename NumericT>
+int test_chebyshev_smoother(NumericT epsilon, std::size_t iters_unpreconditioned)
+{
+  typedef ublas::compressed_matrix<NumericT>    MatrixType;
+
+  std::size_t N = 24;
+  std::size_t n = N * N;
+
+  std::vector< std::map<unsigned int, NumericT> > A_host;
+  variable_diffusion_2d(N, NumericT(1), A_host);
+  MatrixType A;
+  copy_to_ublas(A_host, A);
+
+  std::vector<NumericT> b_host(n);
+  fill_reproducible(b_host, 71, NumericT(1));
+  ublas::vector<NumericT> b(n);
+  std::copy(b_host.begin(), b_host.end(), b.begin());
+
+  std::cout << "# Testing Chebyshev smoother" << std::endl;
+
+  viennacl::linalg::amg_tag tag(VIENNACL_AMG_COARSE_RS, VIENNACL_AMG_INTERPOL_DIRECT, 0.25, 0.2, 0.67, 2, 2, 0);
+  tag.set_smoother(VIENNACL_AMG_SMOOTHER_CHEBYSHEV);
+  viennacl::linalg::amg_precond<MatrixType> precond(A, tag);
+  precond.setup();
+
+  std::size_t iters = amg_cg(A, b, precond, epsilon, "CG with AMG");
+  if (iters == 0)
+    return EXIT_FAILURE;
+  if (iters >= iters_unpreconditioned)
+  {
+    std::cout << "# Error: AMG did not reduce the number of CG iterations" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+template <typename NumericT>
+int test_nullspace(NumericT epsilon)
+{
+  typedef ublas::compressed_matrix<NumericT>    MatrixType;
+
+  std::size_t N = 16;
+  std::size_t n = N * N;
+
+  //
+  // The constant vector as near-nullspace reproduces the default aggregation
+  //
+  std::cout << "# Testing constant near-nullspace vector" << std::endl;
+  {
+    std::vector< std::map<unsigned int, NumericT> > A_host;
+    variable_diffusion_2d(N, NumericT(1), A_host);
+    MatrixType A;
+    copy_to_ublas(A_host, A);
+
+    std::vector<NumericT> b_host(n);
+    fill_reproducible(b_host, 73, NumericT(1));
+    ublas::vector<NumericT> b(n);
+    std::copy(b_host.begin(), b_host.end(), b.begin());
+
+    viennacl::linalg::amg_tag tag(VIENNACL_AMG_COARSE_AG, VIENNACL_AMG_INTERPOL_SA, 0.08, 0.67, 0.67, 2, 2, 0);
+    viennacl::linalg::amg_precond<MatrixType> precond(A, tag);
+    precond.setup();
+    std::size_t iters_default = amg_cg(A, b, precond, epsilon, "default aggregation");
+
+    std::vector< std::vector<NumericT> > B(1, std::vector<NumericT>(n, NumericT(1)));
+    viennacl::linalg::amg_precond<MatrixType> precond_nullspace(A, tag);
+    precond_nullspace.set_nullspace(B);
+    precond_nullspace.setup();
+    std::size_t iters_nullspace = amg_cg(A, b, precond_nullspace, epsilon, "constant near-nullspace vector");
+
+    if (iters_default == 0 || iters_nullspace == 0 || iters_nullspace > iters_default + 1 || iters_default > iters_nullspace + 1)
+    {
+      std::cout << "# Error: constant near-nullspace vector does not reproduce the default aggregation" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  //
+  // Two coupled unknowns per node, A = L (x) K. The near-nullspace consists of the two components,
+  // whereas scalar aggregation only approximates the constant vector.
+  //
+  std::cout << "# Testing two unknowns per node" << std::endl;
+  {
+    std::vector< std::map<unsigned int, NumericT> > L_host;
+    variable_diffusion_2d(N, NumericT(1), L_host);
+    NumericT K[2][2] = { { NumericT(1), NumericT(0.3) }, { NumericT(0.3), NumericT(1) } };
+    std::vector< std::map<unsigned int, NumericT> > A_host(2 * n);
+    for (std::size_t i=0; i<n; ++i)
+      for (typename std::map<unsigned int, NumericT>::const_iterator it = L_host[i].begin(); it != L_host[i].end(); ++it)
+        for (unsigned int a=0; a<2; ++a)
+          for (unsigned int c=0; c<2; ++c)
+            A_host[2*i + a][2*it->first + c] = it->second * K[a][c];
+    MatrixType A;
+    copy_to_ublas(A_host, A);
+
+    std::vector<NumericT> b_host(2 * n);
+    fill_reproducible(b_host, 79, NumericT(1));
+    ublas::vector<NumericT> b(2 * n);
+    std::copy(b_host.begin(), b_host.end(), b.begin());
+
+    std::vector< std::vector<NumericT> > B(2, std::vector<NumericT>(2 * n, NumericT(0)));
+    for (std::size_t i=0; i<n; ++i)
+    {
+      B[0][2*i]   = NumericT(1);
+      B[1][2*i+1] = NumericT(1);
+    }
+
+    viennacl::linalg::amg_tag tag(VIENNACL_AMG_COARSE_AG, VIENNACL_AMG_INTERPOL_SA, 0.08, 0.67, 0.67, 2, 2, 0);
+    viennacl::linalg::amg_precond<MatrixType> precond(A, tag);
+    precond.setup();
+    std::size_t iters_default = amg_cg(A, b, precond, epsilon, "scalar aggregation");
+
+    viennacl::linalg::amg_precond<MatrixType> precond_nullspace(A, tag);
+    precond_nullspace.set_nullspace(B, 2);
+    precond_nullspace.setup();
+    std::size_t iters_nullspace = amg_cg(A, b, precond_nullspace, epsilon, "node aggregation with near-nullspace");
+    if (iters_default == 0 || iters_nullspace == 0 || iters_nullspace > iters_default)
+    {
+      std::cout << "# Error: near-nullspace vectors did not improve convergence" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // re-setup keeps the aggregates of the nodes:
+    for (std::size_t i=0; i<2*n; ++i)
+      for (typename std::map<unsigned int, NumericT>::iterator it = A_host[i].begin(); it != A_host[i].end(); ++it)
+        it->second *= NumericT(1) + NumericT(0.2) * NumericT(i % 2 == it->first % 2);
+    MatrixType A_new;
+    copy_to_ublas(A_host, A_new);
+    precond_nullspace.resetup(A_new);
+    if (amg_cg(A_new, b, precond_nullspace, epsilon, "re-setup with near-nullspace") == 0)
+      return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+template <typename NumericT>
+int test(NumericT epsilon)
+{
+  {
+    std::size_t N = 24;
+    std::vector< std::map<unsigned int, NumericT> > A_host;
+    variable_diffusion_2d(N, NumericT(1), A_host);
+    ublas::compressed_matrix<NumericT> A;
+    copy_to_ublas(A_host, A);
+    std::vector<NumericT> b_host(N * N);
+    fill_reproducible(b_host, 71, NumericT(1));
+    ublas::vector<NumericT> b(N * N);
+    std::copy(b_host.begin(), b_host.end(), b.begin());
+
+    viennacl::linalg::cg_tag tag(epsilon / 10, 2000);
+    ublas::vector<NumericT> x = viennacl::linalg::solve(A, b, tag);
+    std::size_t iters_unpreconditioned = tag.iters();
+    std::cout << "# CG without preconditioner: " << iters_unpreconditioned << " iterations" << std::endl;
+
+    if (test_hierarchy(epsilon, iters_unpreconditioned, VIENNACL_AMG_COARSE_RS, VIENNACL_AMG_INTERPOL_DIRECT, NumericT(0.25), NumericT(0.2), "RS coarsening, direct interpolation") != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+    if (test_hierarchy(epsilon, iters_unpreconditioned, VIENNACL_AMG_COARSE_ONEPASS, VIENNACL_AMG_INTERPOL_DIRECT, NumericT(0.25), NumericT(0.2), "one-pass coarsening, direct interpolation") != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+    if (test_hierarchy(epsilon, iters_unpreconditioned, VIENNACL_AMG_COARSE_RS0, VIENNACL_AMG_INTERPOL_DIRECT, NumericT(0.25), NumericT(0.2), "RS0 coarsening, direct interpolation") != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+    if (test_hierarchy(epsilon, iters_unpreconditioned, VIENNACL_AMG_COARSE_RS3, VIENNACL_AMG_INTERPOL_DIRECT, NumericT(0.25), NumericT(0.2), "RS3 coarsening, direct interpolation") != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+    // the parallel coarsenings with a fixed number of slices, independent of the number of processors:
+    if (test_hierarchy(epsilon, iters_unpreconditioned, VIENNACL_AMG_COARSE_RS0, VIENNACL_AMG_INTERPOL_DIRECT, NumericT(0.25), NumericT(0.2), "RS0 coarsening with 2 slices, direct interpolation", 2) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+    if (test_hierarchy(epsilon, iters_unpreconditioned, VIENNACL_AMG_COARSE_RS0, VIENNACL_AMG_INTERPOL_DIRECT, NumericT(0.25), NumericT(0.2), "RS0 coarsening with 4 slices, direct interpolation", 4) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+    if (test_hierarchy(epsilon, iters_unpreconditioned, VIENNACL_AMG_COARSE_RS3, VIENNACL_AMG_INTERPOL_DIRECT, NumericT(0.25), NumericT(0.2), "RS3 coarsening with 2 slices, direct interpolation", 2) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+    if (test_hierarchy(epsilon, iters_unpreconditioned, VIENNACL_AMG_COARSE_RS3, VIENNACL_AMG_INTERPOL_DIRECT, NumericT(0.25), NumericT(0.2), "RS3 coarsening with 4 slices, direct interpolation", 4) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+    if (test_hierarchy(epsilon, iters_unpreconditioned, VIENNACL_AMG_COARSE_RS, VIENNACL_AMG_INTERPOL_CLASSIC, NumericT(0.25), NumericT(0.2), "RS coarsening, classical interpolation") != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+    if (test_hierarchy(epsilon, iters_unpreconditioned, VIENNACL_AMG_COARSE_AG, VIENNACL_AMG_INTERPOL_AG, NumericT(0.08), NumericT(0), "aggregation") != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+    if (test_hierarchy(epsilon, iters_unpreconditioned, VIENNACL_AMG_COARSE_AG, VIENNACL_AMG_INTERPOL_SA, NumericT(0.08), NumericT(0.67), "smoothed aggregation") != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+    if (test_chebyshev_smoother(epsilon, iters_unpreconditioned) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+  }
+
+  if (test_strength_threshold<NumericT>() != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  if (test_resetup(epsilon, VIENNACL_AMG_COARSE_RS, VIENNACL_AMG_INTERPOL_DIRECT, NumericT(0.25), NumericT(0.2), "RS coarsening, direct interpolation") != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+  if (test_resetup(epsilon, VIENNACL_AMG_COARSE_RS, VIENNACL_AMG_INTERPOL_CLASSIC, NumericT(0.25), NumericT(0.2), "RS coarsening, classical interpolation") != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+  if (test_resetup(epsilon, VIENNACL_AMG_COARSE_AG, VIENNACL_AMG_INTERPOL_AG, NumericT(0.08), NumericT(0), "aggregation") != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+  if (test_resetup(epsilon, VIENNACL_AMG_COARSE_AG, VIENNACL_AMG_INTERPOL_SA, NumericT(0.08), NumericT(0.67), "smoothed aggregation") != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  return test_nullspace(epsilon);
+}
+
+
+//
+// -------------------------------------------------------------
+//
+int main()
+{
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "## Test :: AMG hierarchy, re-setup and near-nullspace" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+  int retval = EXIT_SUCCESS;
+
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+  {
+    typedef double NumericT;
+    NumericT epsilon = 1.0E-8;
+    std::cout << "# Testing setup:" << std::endl;
+    std::cout << "  eps:     " << epsilon << std::endl;
+    std::cout << "  numeric: double" << std::endl;
+    retval = test<NumericT>(epsilon);
+    if( retval == EXIT_SUCCESS )
+      std::cout << "# Test passed" << std::endl;
+    else
+      return retval;
+  }
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+  std::cout << std::endl;
+  std::cout << "------- Test completed --------" << std::endl;
+  std::cout << std::endl;
+
+  return retval;
+}
@@ -0,0 +1,308 @@
+/* =========================================================================
+   Copyright (c) 2010-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+//
+// *** System
+//
+#include <iostream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <map>
+#include <cmath>
+#include <stdlib.h>
+
+//
+// *** ViennaCL
+//
+#include "viennacl/batched_compressed_matrix.hpp"
+#include "viennacl/linalg/batched_solve.hpp"
+
+#include "sparse_test_problems.hpp"
+
+
+//
+// -------------------------------------------------------------
+//
+
+/** @brief Returns ||b_i - A_i x_i|| / ||b_i|| for system i of the batch */
+template <typename NumericT>
+NumericT batched_relative_residual(viennacl::batched_compressed_matrix<NumericT> const & A, std::vector<NumericT> const & x, std::vector<NumericT> const & b, std::size_t i)
+{
+  NumericT norm_res = 0;
+  NumericT norm_rhs = 0;
+  for (std::size_t row = A.offset(i); row < A.offset(i+1); ++row)
+  {
+    NumericT sum = 0;
+    for (unsigned int k = A.row_buffer()[row]; k < A.row_buffer()[row+1]; ++k)
+      sum += A.elements()[k] * x[A.offset(i) + A.col_buffer()[k]];
+    norm_res += (b[row] - sum) * (b[row] - sum);
+    norm_rhs += b[row] * b[row];
+  }
+  return (norm_rhs > 0) ? std::sqrt(norm_res / norm_rhs) : std::sqrt(norm_res);
+}
+
+template <typename NumericT>
+int check_batch(viennacl::batched_compressed_matrix<NumericT> const & A, std::vector<NumericT> const & x, std::vector<NumericT> const & b,
+                NumericT tolerance, std::string const & name)
+{
+  if (x.size() != A.total_size())
+  {
+    std::cout << "# Error: result of " << name << " has wrong size" << std::endl;
+    return EXIT_FAILURE;
+  }
+  NumericT max_res = 0;
+  for (std::size_t i=0; i<A.size(); ++i)
+  {
+    NumericT res = batched_relative_residual(A, x, b, i);
+    if (!(res <= tolerance))
+    {
+      std::cout << "# Error: " << name << " failed for system " << i << " of size " << A.size1(i) << ", residual " << res << std::endl;
+      return EXIT_FAILURE;
+    }
+    max_res = std::max(max_res, res);
+  }
+  std::cout << "  > " << name << ": maximum residual " << max_res << std::endl;
+  return EXIT_SUCCESS;
+}
+
+template <typename NumericT>
+int test(NumericT epsilon)
+{
+  //
+  // Batches of symmetric positive definite and of nonsymmetric systems of sizes 0 (empty system), 1, 4, ..., 49
+  //
+  viennacl::batched_compressed_matrix<NumericT> A_spd;
+  viennacl::batched_compressed_matrix<NumericT> A_nonsym;
+  for (std::size_t i=0; i<60; ++i)
+  {
+    std::size_t N = i % 8;
+    std::vector< std::map<unsigned int, NumericT> > A_host;
+    variable_diffusion_2d(N, NumericT(0.1) * NumericT(i % 11), A_host);
+    A_spd.add_system(A_host);
+    convection_diffusion_2d(N, NumericT(0.05) * NumericT(i % 9), NumericT(0.1), A_host);
+    A_nonsym.add_system(A_host);
+  }
+  std::vector<NumericT> b(A_spd.total_size());
+  fill_reproducible(b, 43, NumericT(1));
+
+  std::cout << "# Testing batch of " << A_spd.size() << " symmetric positive definite systems" << std::endl;
+  {
+    viennacl::linalg::batched_cg_tag tag(epsilon, 500);
+    std::vector<NumericT> x = viennacl::linalg::solve(A_spd, b, tag);
+    if (check_batch(A_spd, x, b, 10 * epsilon, "CG") != EXIT_SUCCESS || tag.unconverged() > 0)
+      return EXIT_FAILURE;
+
+    viennacl::linalg::batched_cg_tag tag_jacobi(epsilon, 500, true);
+    x = viennacl::linalg::solve(A_spd, b, tag_jacobi);
+    if (check_batch(A_spd, x, b, 100 * epsilon, "CG with Jacobi preconditioner") != EXIT_SUCCESS || tag_jacobi.unconverged() > 0)
+      return EXIT_FAILURE;
+
+    viennacl::linalg::batched_dense_lu_tag tag_lu;
+    x = viennacl::linalg::solve(A_spd, b, tag_lu);
+    if (check_batch(A_spd, x, b, 10 * epsilon, "dense LU") != EXIT_SUCCESS || tag_lu.num_singular() > 0)
+      return EXIT_FAILURE;
+
+    // new values for the same sparsity pattern (next time step): A -> 2 A, hence x -> x / 2
+    std::vector<NumericT> x_old = x;
+    for (std::size_t k=0; k<A_spd.nnz(); ++k)
+      A_spd.elements()[k] *= NumericT(2);
+    viennacl::linalg::batched_banded_lu_tag tag_banded;
+    x = viennacl::linalg::solve(A_spd, b, tag_banded);
+    if (check_batch(A_spd, x, b, 10 * epsilon, "banded LU after in-place update") != EXIT_SUCCESS || tag_banded.num_singular() > 0)
+      return EXIT_FAILURE;
+    for (std::size_t k=0; k<x.size(); ++k)
+      if (std::fabs(x[k] - x_old[k] / NumericT(2)) > 100 * epsilon * (NumericT(1) + std::fabs(x_old[k])))
+      {
+        std::cout << "# Error: in-place update of the values not reflected in the result" << std::endl;
+        return EXIT_FAILURE;
+      }
+  }
+
+  std::cout << "# Testing batch of " << A_nonsym.size() << " nonsymmetric systems" << std::endl;
+  {
+    viennacl::linalg::batched_bicgstab_tag tag(epsilon, 500);
+    std::vector<NumericT> x = viennacl::linalg::solve(A_nonsym, b, tag);
+    if (check_batch(A_nonsym, x, b, 10 * epsilon, "BiCGStab") != EXIT_SUCCESS || tag.unconverged() > 0)
+      return EXIT_FAILURE;
+
+    viennacl::linalg::batched_bicgstab_tag tag_jacobi(epsilon, 500, true);
+    x = viennacl::linalg::solve(A_nonsym, b, tag_jacobi);
+    if (check_batch(A_nonsym, x, b, 10 * epsilon, "BiCGStab with Jacobi preconditioner") != EXIT_SUCCESS || tag_jacobi.unconverged() > 0)
+      return EXIT_FAILURE;
+
+    viennacl::linalg::batched_dense_lu_tag tag_lu;
+    x = viennacl::linalg::solve(A_nonsym, b, tag_lu);
+    if (check_batch(A_nonsym, x, b, 10 * epsilon, "dense LU") != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+
+    viennacl::linalg::batched_banded_lu_tag tag_banded;
+    x = viennacl::linalg::solve(A_nonsym, b, tag_banded);
+    if (check_batch(A_nonsym, x, b, 10 * epsilon, "banded LU") != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+  }
+
+  //
+  // Singular systems are flagged, their result is zero, and the other systems of the batch are not affected
+  //
+  std::cout << "# Testing batch with singular systems" << std::endl;
+  {
+    viennacl::batched_compressed_matrix<NumericT> A;
+    std::vector<bool> is_singular;
+    for (std::size_t i=0; i<10; ++i)
+    {
+      std::vector< std::map<unsigned int, NumericT> > A_host;
+      convection_diffusion_2d(4, NumericT(0.2), NumericT(0), A_host);
+      if (i % 3 == 1)
+        A_host[5].clear();  //zero row
+      if (i % 3 == 2)
+        A_host[7] = A_host[6];  //two identical rows
+      A.add_system(A_host);
+      is_singular.push_back(i % 3 == 1);  //identical rows are not necessarily detected due to round-off
+    }
+    std::vector<NumericT> b_singular(A.total_size());
+    fill_reproducible(b_singular, 47, NumericT(1));
+
+    viennacl::linalg::batched_dense_lu_tag tag_lu;
+    viennacl::linalg::batched_banded_lu_tag tag_banded;
+    std::vector<NumericT> x_lu     = viennacl::linalg::solve(A, b_singular, tag_lu);
+    std::vector<NumericT> x_banded = viennacl::linalg::solve(A, b_singular, tag_banded);
+    for (std::size_t i=0; i<A.size(); ++i)
+    {
+      if (i % 3 == 0)
+      {
+        if (tag_lu.singular(i) || tag_banded.singular(i)
+            || batched_relative_residual(A, x_lu, b_singular, i) > 10 * epsilon
+            || batched_relative_residual(A, x_banded, b_singular, i) > 10 * epsilon)
+        {
+          std::cout << "# Error: regular system " << i << " not solved" << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+      else if (is_singular[i])
+      {
+        NumericT norm_x = 0;
+        for (std::size_t k = A.offset(i); k < A.offset(i+1); ++k)
+          norm_x += std::fabs(x_lu[k]) + std::fabs(x_banded[k]);
+        if (!tag_lu.singular(i) || !tag_banded.singular(i) || norm_x > 0)
+        {
+          std::cout << "# Error: singular system " << i << " not detected" << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+    std::cout << "  > singular systems detected: " << tag_lu.num_singular() << " (dense LU), " << tag_banded.num_singular() << " (banded LU)" << std::endl;
+    if (tag_lu.num_singular() < 3 || tag_banded.num_singular() < 3)
+    {
+      std::cout << "# Error: wrong number of singular systems" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  //
+  // Empty batch
+  //
+  std::cout << "# Testing empty batch" << std::endl;
+  {
+    viennacl::batched_compressed_matrix<NumericT> A;
+    std::vector<NumericT> b_empty;
+
+    viennacl::linalg::batched_cg_tag tag_cg;
+    viennacl::linalg::batched_bicgstab_tag tag_bicgstab;
+    viennacl::linalg::batched_dense_lu_tag tag_lu;
+    viennacl::linalg::batched_banded_lu_tag tag_banded;
+    if (viennacl::linalg::solve(A, b_empty, tag_cg).size() != 0
+        || viennacl::linalg::solve(A, b_empty, tag_bicgstab).size() != 0
+        || viennacl::linalg::solve(A, b_empty, tag_lu).size() != 0
+        || viennacl::linalg::solve(A, b_empty, tag_banded).size() != 0
+        || tag_cg.iters() != 0 || tag_cg.error() > 0 || tag_cg.unconverged() != 0 || tag_lu.num_singular() != 0)
+    {
+      std::cout << "# Error: solving an empty batch failed" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // batch consisting of empty systems only:
+    std::vector< std::map<unsigned int, NumericT> > A_host;
+    A.add_system(A_host);
+    A.add_system(A_host);
+    if (viennacl::linalg::solve(A, b_empty, tag_cg).size() != 0 || viennacl::linalg::solve(A, b_empty, tag_banded).size() != 0
+        || tag_cg.unconverged() != 0 || tag_banded.num_singular() != 0)
+    {
+      std::cout << "# Error: solving a batch of empty systems failed" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
+//
+// -------------------------------------------------------------
+//
+int main()
+{
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "## Test :: Batched solvers for small sparse systems" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+  int retval = EXIT_SUCCESS;
+
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+  {
+    typedef float NumericT;
+    NumericT epsilon = static_cast<NumericT>(1E-4);
+    std::cout << "# Testing setup:" << std::endl;
+    std::cout << "  eps:     " << epsilon << std::endl;
+    std::cout << "  numeric: float" << std::endl;
+    retval = test<NumericT>(epsilon);
+    if( retval == EXIT_SUCCESS )
+        std::cout << "# Test passed" << std::endl;
+    else
+        return retval;
+  }
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+  {
+    typedef double NumericT;
+    NumericT epsilon = 1.0E-8;
+    std::cout << "# Testing setup:" << std::endl;
+    std::cout << "  eps:     " << epsilon << std::endl;
+    std::cout << "  numeric: double" << std::endl;
+    retval = test<NumericT>(epsilon);
+    if( retval == EXIT_SUCCESS )
+      std::cout << "# Test passed" << std::endl;
+    else
+      return retval;
+  }
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+  std::cout << std::endl;
+  std::cout << "------- Test completed --------" << std::endl;
+  std::cout << std::endl;
+
+  return retval;
+}
@@ -0,0 +1,260 @@
+/* =========================================================================
+   Copyright (c) 2010-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+//
+// *** System
+//
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <algorithm>
+#include <stdlib.h>
+
+//
+// *** Boost
+//
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/vector.hpp>
+
+//
+// *** ViennaCL
+//
+#include "viennacl/matrix.hpp"
+#include "viennacl/linalg/bisect.hpp"
+#include "viennacl/linalg/tridiagonal_dc.hpp"
+
+#include "sparse_test_problems.hpp"
+
+
+//
+// -------------------------------------------------------------
+//
+namespace ublas = boost::numeric::ublas;
+
+template <typename NumericT>
+NumericT max_difference(std::vector<NumericT> const & result, std::vector<NumericT> const & reference, std::size_t offset)
+{
+  NumericT diff = 0;
+  for (std::size_t i=0; i<result.size(); ++i)
+    diff = std::max(diff, std::fabs(result[i] - reference[offset + i]));
+  return diff;
+}
+
+/** @brief Checks bisect(), bisect_by_index() and bisect_by_value() against the ascending reference eigenvalues of the tridiagonal matrix (alphas, betas) */
+template <typename NumericT>
+int check_bisect(std::string const & name, std::vector<NumericT> const & alphas, std::vector<NumericT> const & betas,
+                 std::vector<NumericT> const & reference, NumericT epsilon)
+{
+  std::size_t n = alphas.size();
+  NumericT norm = 1;
+  for (std::size_t i=0; i<n; ++i)
+    norm = std::max(norm, std::fabs(alphas[i]) + ((i > 0) ? std::fabs(betas[i]) : NumericT(0)) + ((i+1 < n) ? std::fabs(betas[i+1]) : NumericT(0)));
+  NumericT tol = epsilon * norm;
+
+  // full spectrum
+  std::vector<NumericT> all = viennacl::linalg::bisect(alphas, betas);
+  NumericT err_all = (all.size() == n) ? max_difference(all, reference, 0) : NumericT(1);
+
+  // index ranges: the lower end, the middle, the upper end (clamped to n), and an empty range
+  std::size_t first[] = { 0, n / 3, (n > 4) ? n - 4 : 0, n / 2 };
+  std::size_t last[]  = { std::min<std::size_t>(5, n), n / 3 + n / 4 + 1, n + 3, n / 2 };
+  NumericT err_index = 0;
+  for (std::size_t k=0; k<4; ++k)
+  {
+    std::vector<NumericT> part = viennacl::linalg::bisect_by_index(alphas, betas, first[k], last[k]);
+    std::size_t expected = (std::min(last[k], n) > first[k]) ? std::min(last[k], n) - first[k] : 0;
+    if (part.size() != expected)
+    {
+      std::cout << "# Error: bisect_by_index() returned " << part.size() << " instead of " << expected << " eigenvalues" << std::endl;
+      return EXIT_FAILURE;
+    }
+    err_index = std::max(err_index, max_difference(part, reference, first[k]));
+  }
+
+  // value ranges: bounds halfway between two neighboring distinct eigenvalues, so the expected count is unambiguous
+  NumericT err_value = 0;
+  if (n > 2)
+  {
+    std::size_t i0 = n / 4, i1 = (3 * n) / 4;
+    while (i0 > 0 && reference[i0] - reference[i0 - 1] < 10 * tol)
+      --i0;
+    while (i1 < n && reference[i1] - reference[i1 - 1] < 10 * tol)
+      ++i1;
+    NumericT lower = (i0 > 0) ? (reference[i0 - 1] + reference[i0]) / NumericT(2) : reference[0] - NumericT(1);
+    NumericT upper = (i1 < n) ? (reference[i1 - 1] + reference[i1]) / NumericT(2) : reference[n - 1] + NumericT(1);
+
+    std::vector<NumericT> part = viennacl::linalg::bisect_by_value(alphas, betas, lower, upper);
+    if (part.size() != i1 - i0)
+    {
+      std::cout << "# Error: bisect_by_value() returned " << part.size() << " instead of " << i1 - i0 << " eigenvalues" << std::endl;
+      return EXIT_FAILURE;
+    }
+    err_value = max_difference(part, reference, i0);
+
+    // interval without eigenvalues
+    if (viennacl::linalg::bisect_by_value(alphas, betas, reference[n - 1] + norm, reference[n - 1] + 2 * norm).size() > 0)
+    {
+      std::cout << "# Error: bisect_by_value() returned eigenvalues outside of the spectrum" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::cout << "  > " << name << ", n = " << n << ": all " << err_all << ", by index " << err_index << ", by value " << err_value << std::endl;
+  if (err_all > tol || err_index > tol || err_value > tol)
+  {
+    std::cout << "# Error: eigenvalues from bisection differ from the reference" << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+/** @brief Reference eigenvalues from the divide-and-conquer solver */
+template <typename NumericT>
+std::vector<NumericT> dc_eigenvalues(std::vector<NumericT> const & alphas, std::vector<NumericT> const & betas)
+{
+  std::size_t n = alphas.size();
+  ublas::vector<NumericT> D(n), E(n);
+  std::copy(alphas.begin(), alphas.end(), D.begin());
+  std::copy(betas.begin(), betas.end(), E.begin());
+  viennacl::matrix<NumericT> Q = viennacl::identity_matrix<NumericT>(n);
+  viennacl::linalg::tridiagonal_dc(D, E, Q);
+  return std::vector<NumericT>(D.begin(), D.end());
+}
+
+template <typename NumericT>
+int test(NumericT epsilon)
+{
+  std::cout << "# Testing 1D Laplace matrix against the exact eigenvalues" << std::endl;
+  {
+    std::size_t n = 200;
+    std::vector<NumericT> alphas(n, NumericT(2)), betas(n, NumericT(-1));
+    std::vector<NumericT> reference(n);
+    for (std::size_t i=0; i<n; ++i)
+      reference[i] = NumericT(2.0 - 2.0 * std::cos(double(i + 1) * 3.14159265358979323846 / double(n + 1)));
+    if (check_bisect("Laplace", alphas, betas, reference, epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+  }
+
+  std::cout << "# Testing random tridiagonal matrices against divide-and-conquer" << std::endl;
+  {
+    std::size_t sizes[] = { 1, 2, 7, 64, 301 };
+    for (std::size_t k=0; k<5; ++k)
+    {
+      std::size_t n = sizes[k];
+      std::vector<NumericT> alphas(n), betas(n);
+      fill_reproducible(alphas, 500 + k);
+      fill_reproducible(betas, 600 + k);
+      betas[0] = 0;
+      if (check_bisect("random", alphas, betas, dc_eigenvalues(alphas, betas), epsilon) != EXIT_SUCCESS)
+        return EXIT_FAILURE;
+    }
+  }
+
+  // Wilkinson matrix W_{2m+1}^+: pairs of very close eigenvalues
+  std::cout << "# Testing Wilkinson matrix" << std::endl;
+  {
+    std::size_t m = 20;
+    std::size_t n = 2 * m + 1;
+    std::vector<NumericT> alphas(n), betas(n, NumericT(1));
+    for (std::size_t i=0; i<n; ++i)
+      alphas[i] = NumericT(i > m ? i - m : m - i);
+    if (check_bisect("Wilkinson", alphas, betas, dc_eigenvalues(alphas, betas), epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+  }
+
+  // decoupled blocks with multiple eigenvalues: the spectrum is the sorted diagonal
+  std::cout << "# Testing diagonal matrix with multiple eigenvalues" << std::endl;
+  {
+    std::size_t n = 40;
+    std::vector<NumericT> alphas(n), betas(n, NumericT(0)), reference(n);
+    for (std::size_t i=0; i<n; ++i)
+      alphas[i] = reference[i] = NumericT((i * 7) % 4);
+    std::sort(reference.begin(), reference.end());
+    if (check_bisect("diagonal", alphas, betas, reference, epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
+//
+// -------------------------------------------------------------
+//
+int main()
+{
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "## Test :: Bisection for tridiagonal eigenvalue problems" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+  int retval = EXIT_SUCCESS;
+
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+  {
+    typedef float NumericT;
+    NumericT epsilon = static_cast<NumericT>(1E-4);
+    std::cout << "# Testing setup:" << std::endl;
+    std::cout << "  eps:     " << epsilon << std::endl;
+    std::cout << "  numeric: float" << std::endl;
+    retval = test<NumericT>(epsilon);
+    if( retval == EXIT_SUCCESS )
+      std::cout << "# Test passed" << std::endl;
+    else
+      return retval;
+  }
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+#ifdef VIENNACL_WITH_OPENCL
+  if( viennacl::ocl::current_device().double_support() )
+#endif
+  {
+    {
+      typedef double NumericT;
+      NumericT epsilon = 1.0E-8;
+      std::cout << "# Testing setup:" << std::endl;
+      std::cout << "  eps:     " << epsilon << std::endl;
+      std::cout << "  numeric: double" << std::endl;
+      retval = test<NumericT>(epsilon);
+      if( retval == EXIT_SUCCESS )
+        std::cout << "# Test passed" << std::endl;
+      else
+        return retval;
+    }
+    std::cout << std::endl;
+    std::cout << "----------------------------------------------" << std::endl;
+    std::cout << std::endl;
+  }
+#ifdef VIENNACL_WITH_OPENCL
+  else
+    std::cout << "No double precision support, skipping test..." << std::endl;
+#endif
+
+  std::cout << std::endl;
+  std::cout << "------- Test completed --------" << std::endl;
+  std::cout << std::endl;
+
+  return retval;
+}
@@ -0,0 +1,235 @@
+/* =========================================================================
+   Copyright (c) 2010-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+//
+// *** System
+//
+#include <iostream>
+#include <vector>
+#include <map>
+#include <string>
+#include <cmath>
+#include <stdlib.h>
+
+//
+// *** ViennaCL
+//
+#include "viennacl/matrix.hpp"
+#include "viennacl/vector.hpp"
+#include "viennacl/compressed_matrix.hpp"
+#include "viennacl/ell_matrix.hpp"
+#include "viennacl/hyb_matrix.hpp"
+#include "viennacl/tools/adapter.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/norm_2.hpp"
+#include "viennacl/linalg/jacobi_precond.hpp"
+#include "viennacl/linalg/block_cg.hpp"
+
+#include "sparse_test_problems.hpp"
+
+
+//
+// -------------------------------------------------------------
+//
+template <typename NumericT, typename MatrixT, typename F>
+int check_columns(MatrixT const & A, viennacl::matrix<NumericT, F> const & B, viennacl::matrix<NumericT, F> const & X,
+                  viennacl::linalg::block_cg_tag const & tag, NumericT epsilon)
+{
+  std::vector< std::vector<NumericT> > B_host(B.size1(), std::vector<NumericT>(B.size2()));
+  std::vector< std::vector<NumericT> > X_host(X.size1(), std::vector<NumericT>(X.size2()));
+  viennacl::copy(B, B_host);
+  viennacl::copy(X, X_host);
+
+  std::cout << "  > block iterations: " << tag.iters() << std::endl;
+  for (std::size_t j=0; j<B.size2(); ++j)
+  {
+    std::vector<NumericT> b_col(B.size1()), x_col(X.size1());
+    for (std::size_t i=0; i<B.size1(); ++i)
+    {
+      b_col[i] = B_host[i][j];
+      x_col[i] = X_host[i][j];
+    }
+    viennacl::vector<NumericT> b(B.size1()), x(X.size1());
+    viennacl::copy(b_col, b);
+    viennacl::copy(x_col, x);
+
+    NumericT res = relative_residual(A, x, b);
+    std::cout << "  > column " << j << ": residual " << res << ", estimate " << tag.errors()[j] << ", iterations " << tag.column_iters()[j] << std::endl;
+    if (res > 10 * epsilon || tag.errors()[j] > epsilon || tag.column_iters()[j] > tag.iters())
+    {
+      std::cout << "# Error: column " << j << " did not converge" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+/** @brief Runs block CG without preconditioner for a different sparse matrix format. The number of iterations must match the one for compressed_matrix up to round-off. */
+template <typename NumericT, typename MatrixT, typename F>
+int test_format(std::vector< std::map<unsigned int, NumericT> > const & A_host, viennacl::matrix<NumericT, F> const & B,
+                unsigned int iters_compressed, std::string const & name, NumericT epsilon)
+{
+  std::cout << "# Testing block CG without preconditioner for " << name << std::endl;
+  MatrixT A;
+  viennacl::copy(viennacl::tools::const_sparse_matrix_adapter<NumericT>(A_host), A);
+
+  viennacl::linalg::block_cg_tag tag(epsilon, 1000);
+  viennacl::matrix<NumericT, F> X = viennacl::linalg::solve(A, B, tag);
+  if (check_columns(A, B, X, tag, epsilon) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+  if (tag.iters() > iters_compressed + 2 || tag.iters() + 2 < iters_compressed)
+  {
+    std::cout << "# Error: number of iterations differs from compressed_matrix (" << iters_compressed << ")" << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+template <typename NumericT, typename F>
+int test(NumericT epsilon)
+{
+  std::size_t N = 20;
+  std::size_t n = N * N;
+  std::size_t num_rhs = 6;
+
+  std::vector< std::map<unsigned int, NumericT> > A_host;
+  variable_diffusion_2d(N, NumericT(1.5), A_host);
+  viennacl::compressed_matrix<NumericT> A(n, n);
+  viennacl::copy(A_host, A);
+
+  // random right hand sides, the last one duplicates the first one (linearly dependent block):
+  std::vector< std::vector<NumericT> > B_host(n, std::vector<NumericT>(num_rhs));
+  std::vector<NumericT> values(n);
+  for (std::size_t j=0; j+1<num_rhs; ++j)
+  {
+    fill_reproducible(values, 1 + j);
+    for (std::size_t i=0; i<n; ++i)
+      B_host[i][j] = values[i];
+  }
+  for (std::size_t i=0; i<n; ++i)
+    B_host[i][num_rhs-1] = B_host[i][0];
+  viennacl::matrix<NumericT, F> B(n, num_rhs);
+  viennacl::copy(B_host, B);
+
+  std::cout << "# Testing block CG without preconditioner" << std::endl;
+  viennacl::linalg::block_cg_tag tag(epsilon, 1000);
+  viennacl::matrix<NumericT, F> X = viennacl::linalg::solve(A, B, tag);
+  if (check_columns(A, B, X, tag, epsilon) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+  unsigned int iters_unpreconditioned = tag.iters();
+
+  if (test_format<NumericT, viennacl::ell_matrix<NumericT> >(A_host, B, iters_unpreconditioned, "ell_matrix", epsilon) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+  if (test_format<NumericT, viennacl::hyb_matrix<NumericT> >(A_host, B, iters_unpreconditioned, "hyb_matrix", epsilon) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  std::cout << "# Testing block CG with Jacobi preconditioner" << std::endl;
+  viennacl::linalg::jacobi_precond< viennacl::compressed_matrix<NumericT> > precond(A, viennacl::linalg::jacobi_tag());
+  viennacl::linalg::block_cg_tag tag_precond(epsilon, 1000);
+  X = viennacl::linalg::solve(A, B, tag_precond, precond);
+  if (check_columns(A, B, X, tag_precond, epsilon) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+  if (tag_precond.iters() > iters_unpreconditioned)
+  {
+    std::cout << "# Error: Jacobi preconditioner increased the number of iterations" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
+//
+// -------------------------------------------------------------
+//
+int main()
+{
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "## Test :: Block CG solver" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+  int retval = EXIT_SUCCESS;
+
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+  {
+    typedef float NumericT;
+    NumericT epsilon = static_cast<NumericT>(1E-4);
+    std::cout << "# Testing setup:" << std::endl;
+    std::cout << "  eps:     " << epsilon << std::endl;
+    std::cout << "  numeric: float, row-major right hand sides" << std::endl;
+    retval = test<NumericT, viennacl::row_major>(epsilon);
+    if( retval == EXIT_SUCCESS )
+        std::cout << "# Test passed" << std::endl;
+    else
+        return retval;
+  }
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+#ifdef VIENNACL_WITH_OPENCL
+  if( viennacl::ocl::current_device().double_support() )
+#endif
+  {
+    {
+      typedef double NumericT;
+      NumericT epsilon = 1.0E-8;
+      std::cout << "# Testing setup:" << std::endl;
+      std::cout << "  eps:     " << epsilon << std::endl;
+      std::cout << "  numeric: double, row-major right hand sides" << std::endl;
+      retval = test<NumericT, viennacl::row_major>(epsilon);
+      if( retval == EXIT_SUCCESS )
+        std::cout << "# Test passed" << std::endl;
+      else
+        return retval;
+    }
+    std::cout << std::endl;
+    std::cout << "----------------------------------------------" << std::endl;
+    std::cout << std::endl;
+    {
+      typedef double NumericT;
+      NumericT epsilon = 1.0E-8;
+      std::cout << "# Testing setup:" << std::endl;
+      std::cout << "  eps:     " << epsilon << std::endl;
+      std::cout << "  numeric: double, column-major right hand sides" << std::endl;
+      retval = test<NumericT, viennacl::column_major>(epsilon);
+      if( retval == EXIT_SUCCESS )
+        std::cout << "# Test passed" << std::endl;
+      else
+        return retval;
+    }
+    std::cout << std::endl;
+    std::cout << "----------------------------------------------" << std::endl;
+    std::cout << std::endl;
+  }
+#ifdef VIENNACL_WITH_OPENCL
+  else
+    std::cout << "No double precision support, skipping test..." << std::endl;
+#endif
+
+  std::cout << std::endl;
+  std::cout << "------- Test completed --------" << std::endl;
+  std::cout << std::endl;
+
+  return retval;
+}
@@ -0,0 +1,274 @@
+/* =========================================================================
+   Copyright (c) 2010-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+//
+// *** System
+//
+#include <iostream>
+#include <vector>
+#include <string>
+#include <utility>
+#include <algorithm>
+#include <map>
+#include <cmath>
+#include <stdlib.h>
+
+//
+// *** ViennaCL
+//
+#include "viennacl/matrix.hpp"
+#include "viennacl/vector.hpp"
+#include "viennacl/compressed_matrix.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/norm_2.hpp"
+#include "viennacl/linalg/bicgstab.hpp"
+#include "viennacl/linalg/jacobi_precond.hpp"
+#include "viennacl/linalg/ilu.hpp"
+
+#include "sparse_test_problems.hpp"
+
+
+//
+// -------------------------------------------------------------
+//
+
+/** @brief Compares the application of two preconditioners to the same vector */
+template <typename NumericT, typename Precond1T, typename Precond2T>
+NumericT precond_difference(Precond1T const & precond1, Precond2T const & precond2, std::size_t n)
+{
+  std::vector<NumericT> v_host(n);
+  fill_reproducible(v_host, 61, NumericT(1));
+  viennacl::vector<NumericT> v1(n), v2(n);
+  viennacl::copy(v_host, v1);
+  viennacl::copy(v_host, v2);
+
+  precond1.apply(v1);
+  precond2.apply(v2);
+  NumericT norm_v2 = viennacl::linalg::norm_2(v2);
+  v1 -= v2;
+  return viennacl::linalg::norm_2(v1) / norm_v2;
+}
+
+/** @brief Solves with BiCGStab and the supplied preconditioner and checks the residual */
+template <typename NumericT, typename MatrixT, typename PrecondT>
+int check_solve(MatrixT const & A, viennacl::vector<NumericT> const & b, PrecondT const & precond, NumericT epsilon,
+                std::size_t max_iters, std::string const & name)
+{
+  viennacl::linalg::bicgstab_tag tag(epsilon, 1000);
+  viennacl::vector<NumericT> x = viennacl::linalg::solve(A, b, tag, precond);
+  NumericT res = relative_residual(A, x, b);
+  std::cout << "  > " << name << ": " << tag.iters() << " iterations, residual " << res << std::endl;
+  if (res > 100 * epsilon || tag.iters() > max_iters)
+  {
+    std::cout << "# Error: preconditioned solve failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+template <typename NumericT>
+int test(NumericT epsilon)
+{
+  typedef viennacl::compressed_matrix<NumericT>    MatrixType;
+  typedef viennacl::vector<NumericT>               VectorType;
+  typedef viennacl::linalg::block_ilu_precond<MatrixType, viennacl::linalg::ilu0_tag>    BlockILU0Type;
+  typedef typename BlockILU0Type::index_vector_type                                      IndexVectorType;
+
+  std::size_t N = 20;
+  std::size_t n = N * N;
+
+  std::vector< std::map<unsigned int, NumericT> > A_host;
+  convection_diffusion_2d(N, NumericT(0.3), NumericT(0), A_host);
+  // a few dense rows, so that balancing the number of nonzeros differs from balancing the number of rows:
+  for (std::size_t i=0; i<20; ++i)
+    for (std::size_t j=0; j<40; ++j)
+      A_host[i][static_cast<unsigned int>(i + 5 * j)] += NumericT(-0.01);
+  MatrixType A(n, n);
+  viennacl::copy(A_host, A);
+
+  std::vector<NumericT> b_host(n);
+  fill_reproducible(b_host, 67, NumericT(1));
+  VectorType b(n);
+  viennacl::copy(b_host, b);
+
+  viennacl::linalg::ilu0_tag ilu0_config;
+  viennacl::linalg::ilut_tag ilut_config;
+
+  //
+  // Automatic block boundaries balance the number of nonzeros
+  //
+  std::cout << "# Testing automatic block boundaries" << std::endl;
+  {
+    std::vector<unsigned int> row_buffer(n + 1, 0);
+    for (std::size_t i=0; i<n; ++i)
+      row_buffer[i+1] = row_buffer[i] + static_cast<unsigned int>(A_host[i].size());
+
+    std::size_t num_blocks_list[4] = { 1, 7, 16, n + 10 };
+    for (std::size_t k=0; k<4; ++k)
+    {
+      IndexVectorType blocks;
+      viennacl::linalg::detail::block_ilu_balanced_boundaries(&(row_buffer[0]), n, num_blocks_list[k], blocks);
+
+      std::size_t expected_blocks = std::min(num_blocks_list[k], n);
+      std::size_t max_nnz = 0;
+      std::size_t max_row_nnz = 0;
+      for (std::size_t i=0; i<n; ++i)
+        max_row_nnz = std::max<std::size_t>(max_row_nnz, A_host[i].size());
+      bool valid = (blocks.size() == expected_blocks && blocks.front().first == 0 && blocks.back().second == n);
+      for (std::size_t i=0; i<blocks.size() && valid; ++i)
+      {
+        valid = (blocks[i].first < blocks[i].second) && (i == 0 || blocks[i].first == blocks[i-1].second);
+        max_nnz = std::max<std::size_t>(max_nnz, row_buffer[blocks[i].second] - row_buffer[blocks[i].first]);
+      }
+      std::cout << "  > " << num_blocks_list[k] << " blocks requested: " << blocks.size() << " blocks, at most " << max_nnz << " nonzeros per block" << std::endl;
+      if (!valid || max_nnz > row_buffer[n] / expected_blocks + max_row_nnz)
+      {
+        std::cout << "# Error: invalid block boundaries" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  //
+  // Reference results: a single block is ILU0, blocks of single rows are Jacobi
+  //
+  std::cout << "# Testing block ILU against ILU0 and Jacobi" << std::endl;
+  {
+    viennacl::linalg::ilu0_precond<MatrixType> ilu0(A, ilu0_config);
+    BlockILU0Type block_ilu_single(A, ilu0_config, 1);
+    NumericT diff_ilu0 = precond_difference<NumericT>(block_ilu_single, ilu0, n);
+
+    viennacl::linalg::jacobi_precond<MatrixType> jacobi(A, viennacl::linalg::jacobi_tag());
+    BlockILU0Type block_ilu_rows(A, ilu0_config, n);
+    NumericT diff_jacobi = precond_difference<NumericT>(block_ilu_rows, jacobi, n);
+
+    IndexVectorType row_blocks(n);
+    for (std::size_t i=0; i<n; ++i)
+      row_blocks[i] = std::make_pair(i, i + 1);
+    BlockILU0Type block_ilu_explicit_rows(A, ilu0_config, row_blocks);
+    NumericT diff_jacobi_explicit = precond_difference<NumericT>(block_ilu_explicit_rows, jacobi, n);
+
+    std::cout << "  > relative difference to ILU0: " << diff_ilu0 << ", to Jacobi: " << diff_jacobi << " (automatic), " << diff_jacobi_explicit << " (explicit)" << std::endl;
+    if (diff_ilu0 > epsilon || diff_jacobi > epsilon || diff_jacobi_explicit > epsilon)
+    {
+      std::cout << "# Error: block ILU differs from reference" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  //
+  // Preconditioned solves
+  //
+  std::cout << "# Testing BiCGStab with block ILU preconditioners" << std::endl;
+  {
+    viennacl::linalg::bicgstab_tag tag(epsilon, 1000);
+    viennacl::linalg::solve(A, b, tag);
+    std::size_t iters_unpreconditioned = tag.iters();
+    std::cout << "  > without preconditioner: " << iters_unpreconditioned << " iterations" << std::endl;
+
+    BlockILU0Type block_ilu0_auto(A, ilu0_config);
+    if (check_solve(A, b, block_ilu0_auto, epsilon, iters_unpreconditioned / 2, "ILU0, automatic boundaries") != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+
+    // uneven explicit boundaries:
+    IndexVectorType blocks;
+    blocks.push_back(std::make_pair(std::size_t(0), std::size_t(7)));
+    blocks.push_back(std::make_pair(std::size_t(7), std::size_t(150)));
+    blocks.push_back(std::make_pair(std::size_t(150), std::size_t(151)));
+    blocks.push_back(std::make_pair(std::size_t(151), n));
+    BlockILU0Type block_ilu0_explicit(A, ilu0_config, blocks);
+    if (check_solve(A, b, block_ilu0_explicit, epsilon, iters_unpreconditioned / 2, "ILU0, explicit boundaries") != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+
+    viennacl::linalg::block_ilu_precond<MatrixType, viennacl::linalg::ilut_tag> block_ilut_auto(A, ilut_config, 5);
+    if (check_solve(A, b, block_ilut_auto, epsilon, iters_unpreconditioned / 2, "ILUT, 5 blocks") != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+
+    viennacl::linalg::block_ilu_precond<MatrixType, viennacl::linalg::ilut_tag> block_ilut_explicit(A, ilut_config, blocks);
+    if (check_solve(A, b, block_ilut_explicit, epsilon, iters_unpreconditioned / 2, "ILUT, explicit boundaries") != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
+//
+// -------------------------------------------------------------
+//
+int main()
+{
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "## Test :: Block ILU preconditioners" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+  int retval = EXIT_SUCCESS;
+
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+  {
+    typedef float NumericT;
+    NumericT epsilon = static_cast<NumericT>(1E-4);
+    std::cout << "# Testing setup:" << std::endl;
+    std::cout << "  eps:     " << epsilon << std::endl;
+    std::cout << "  numeric: float" << std::endl;
+    retval = test<NumericT>(epsilon);
+    if( retval == EXIT_SUCCESS )
+        std::cout << "# Test passed" << std::endl;
+    else
+        return retval;
+  }
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+#ifdef VIENNACL_WITH_OPENCL
+  if( viennacl::ocl::current_device().double_support() )
+#endif
+  {
+    {
+      typedef double NumericT;
+      NumericT epsilon = 1.0E-8;
+      std::cout << "# Testing setup:" << std::endl;
+      std::cout << "  eps:     " << epsilon << std::endl;
+      std::cout << "  numeric: double" << std::endl;
+      retval = test<NumericT>(epsilon);
+      if( retval == EXIT_SUCCESS )
+        std::cout << "# Test passed" << std::endl;
+      else
+        return retval;
+    }
+    std::cout << std::endl;
+    std::cout << "----------------------------------------------" << std::endl;
+    std::cout << std::endl;
+  }
+#ifdef VIENNACL_WITH_OPENCL
+  else
+    std::cout << "No double precision support, skipping test..." << std::endl;
+#endif
+
+  std::cout << std::endl;
+  std::cout << "------- Test completed --------" << std::endl;
+  std::cout << std::endl;
+
+  return retval;
+}
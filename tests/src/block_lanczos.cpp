@@ -0,0 +1,235 @@
+/* =========================================================================
+   Copyright (c) 2010-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+//
+// *** System
+//
+#include <iostream>
+#include <vector>
+#include <map>
+#include <string>
+#include <cmath>
+#include <algorithm>
+#include <functional>
+#include <stdlib.h>
+
+//
+// *** ViennaCL
+//
+#include "viennacl/matrix.hpp"
+#include "viennacl/compressed_matrix.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/block_lanczos.hpp"
+
+#include "sparse_test_problems.hpp"
+
+
+//
+// -------------------------------------------------------------
+//
+
+/** @brief Exact eigenvalues of the five-point Laplace matrix on an N x N grid in ascending order */
+template <typename NumericT>
+std::vector<NumericT> laplace_eigenvalues(std::size_t N)
+{
+  std::vector<NumericT> lambda;
+  for (std::size_t i=1; i<=N; ++i)
+    for (std::size_t j=1; j<=N; ++j)
+      lambda.push_back(NumericT(4.0 - 2.0 * std::cos(double(i) * 3.14159265358979323846 / double(N + 1))
+                                    - 2.0 * std::cos(double(j) * 3.14159265358979323846 / double(N + 1))));
+  std::sort(lambda.begin(), lambda.end());
+  return lambda;
+}
+
+/** @brief Checks the eigenvalues against the reference (ordered from the wanted end of the spectrum) and, if supplied, the residuals ||A x_i - lambda_i x_i|| and the orthonormality of the eigenvectors */
+template <typename NumericT>
+int check_eigenpairs(std::string const & name, std::vector< std::map<unsigned int, NumericT> > const & A,
+                     std::vector<NumericT> const & eigenvalues, std::vector<NumericT> const & reference,
+                     viennacl::matrix<NumericT, viennacl::column_major> const * eigenvectors,
+                     viennacl::linalg::block_lanczos_tag const & tag, NumericT epsilon)
+{
+  NumericT err_values = 0;
+  for (std::size_t i=0; i<eigenvalues.size(); ++i)
+    err_values = std::max(err_values, std::fabs(eigenvalues[i] - reference[i]));
+
+  NumericT err_res = 0;
+  NumericT err_orth = 0;
+  if (eigenvectors)
+  {
+    std::size_t n = A.size();
+    std::size_t k = eigenvalues.size();
+    std::vector< std::vector<NumericT> > X(n, std::vector<NumericT>(k));
+    viennacl::copy(*eigenvectors, X);
+    for (std::size_t q=0; q<k; ++q)
+    {
+      NumericT res = 0;
+      for (std::size_t i=0; i<n; ++i)
+      {
+        NumericT temp = -eigenvalues[q] * X[i][q];
+        for (typename std::map<unsigned int, NumericT>::const_iterator it = A[i].begin(); it != A[i].end(); ++it)
+          temp += it->second * X[it->first][q];
+        res += temp * temp;
+      }
+      err_res = std::max(err_res, std::sqrt(res) / std::max(std::fabs(eigenvalues[q]), NumericT(1)));
+
+      for (std::size_t p=0; p<=q; ++p)
+      {
+        NumericT dot = 0;
+        for (std::size_t i=0; i<n; ++i)
+          dot += X[i][p] * X[i][q];
+        err_orth = std::max(err_orth, std::fabs(dot - NumericT(p == q)));
+      }
+    }
+  }
+
+  std::cout << "  > " << name << ": " << tag.num_converged() << " converged after " << tag.restarts() << " restarts and "
+            << tag.matrix_products() << " products, eigenvalue error " << err_values;
+  if (eigenvectors)
+    std::cout << ", residual " << err_res << ", |X^T X - I| = " << err_orth;
+  std::cout << std::endl;
+  if (tag.num_converged() != eigenvalues.size() || err_values > 10 * epsilon || err_res > 10 * epsilon || err_orth > 10 * epsilon)
+  {
+    std::cout << "# Error: block Lanczos failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+template <typename NumericT>
+int test(NumericT epsilon)
+{
+  typedef viennacl::linalg::block_lanczos_tag   TagType;
+
+  std::size_t N = 20;
+  std::vector< std::map<unsigned int, NumericT> > A_host;
+  convection_diffusion_2d(N, NumericT(0), NumericT(0), A_host);
+  viennacl::compressed_matrix<NumericT> A(N * N, N * N);
+  viennacl::copy(A_host, A);
+
+  std::vector<NumericT> smallest = laplace_eigenvalues<NumericT>(N);
+  std::vector<NumericT> largest(smallest.rbegin(), smallest.rend());
+
+  // The spectrum of the Laplace matrix has many double eigenvalues, which a block size larger than one resolves
+  std::cout << "# Testing largest eigenpairs with full reorthogonalization" << std::endl;
+  TagType tag_largest(8, 4, 60, epsilon, 200, TagType::full_reorthogonalization, TagType::largest);
+  viennacl::matrix<NumericT, viennacl::column_major> X;
+  std::vector<NumericT> lambda = viennacl::linalg::eig(A, X, tag_largest);
+  if (check_eigenpairs("largest", A_host, lambda, largest, &X, tag_largest, epsilon) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  std::cout << "# Testing eigenvalues only" << std::endl;
+  TagType tag_values(8, 4, 60, epsilon, 200, TagType::full_reorthogonalization, TagType::largest);
+  std::vector<NumericT> lambda_values = viennacl::linalg::eig(A, tag_values);
+  if (check_eigenpairs("largest, no eigenvectors", A_host, lambda_values, largest, static_cast<viennacl::matrix<NumericT, viennacl::column_major> *>(NULL), tag_values, epsilon) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  // a small basis forces several thick restarts
+  std::cout << "# Testing smallest eigenpairs with selective reorthogonalization and restarts" << std::endl;
+  TagType tag_smallest(6, 3, 24, epsilon, 500, TagType::selective_reorthogonalization, TagType::smallest);
+  lambda = viennacl::linalg::eig(A, X, tag_smallest);
+  if (check_eigenpairs("smallest", A_host, lambda, smallest, &X, tag_smallest, epsilon) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+  if (tag_smallest.restarts() == 0)
+  {
+    std::cout << "# Error: no restart with a basis of 24 vectors" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // matrices smaller than the basis are solved densely
+  std::cout << "# Testing small matrix" << std::endl;
+  {
+    std::size_t N_small = 4;
+    std::vector< std::map<unsigned int, NumericT> > A_small_host;
+    convection_diffusion_2d(N_small, NumericT(0), NumericT(0), A_small_host);
+    viennacl::compressed_matrix<NumericT> A_small(N_small * N_small, N_small * N_small);
+    viennacl::copy(A_small_host, A_small);
+
+    TagType tag_small(5, 4, 100, epsilon, 100, TagType::full_reorthogonalization, TagType::smallest);
+    lambda = viennacl::linalg::eig(A_small, X, tag_small);
+    if (check_eigenpairs("small", A_small_host, lambda, laplace_eigenvalues<NumericT>(N_small), &X, tag_small, epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
+//
+// -------------------------------------------------------------
+//
+int main()
+{
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "## Test :: Block Lanczos eigensolver" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+  int retval = EXIT_SUCCESS;
+
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+  {
+    typedef float NumericT;
+    NumericT epsilon = static_cast<NumericT>(1E-4);
+    std::cout << "# Testing setup:" << std::endl;
+    std::cout << "  eps:     " << epsilon << std::endl;
+    std::cout << "  numeric: float" << std::endl;
+    retval = test<NumericT>(epsilon);
+    if( retval == EXIT_SUCCESS )
+      std::cout << "# Test passed" << std::endl;
+    else
+      return retval;
+  }
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+#ifdef VIENNACL_WITH_OPENCL
+  if( viennacl::ocl::current_device().double_support() )
+#endif
+  {
+    {
+      typedef double NumericT;
+      NumericT epsilon = 1.0E-8;
+      std::cout << "# Testing setup:" << std::endl;
+      std::cout << "  eps:     " << epsilon << std::endl;
+      std::cout << "  numeric: double" << std::endl;
+      retval = test<NumericT>(epsilon);
+      if( retval == EXIT_SUCCESS )
+        std::cout << "# Test passed" << std::endl;
+      else
+        return retval;
+    }
+    std::cout << std::endl;
+    std::cout << "----------------------------------------------" << std::endl;
+    std::cout << std::endl;
+  }
+#ifdef VIENNACL_WITH_OPENCL
+  else
+    std::cout << "No double precision support, skipping test..." << std::endl;
+#endif
+
+  std::cout << std::endl;
+  std::cout << "------- Test completed --------" << std::endl;
+  std::cout << std::endl;
+
+  return retval;
+}
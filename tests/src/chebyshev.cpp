@@ -0,0 +1,217 @@
+/* =========================================================================
+   Copyright (c) 2010-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+//
+// *** System
+//
+#include <iostream>
+#include <vector>
+#include <map>
+#include <cmath>
+#include <stdlib.h>
+
+//
+// *** ViennaCL
+//
+#include "viennacl/matrix.hpp"
+#include "viennacl/vector.hpp"
+#include "viennacl/compressed_matrix.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/norm_2.hpp"
+#include "viennacl/linalg/cg.hpp"
+#include "viennacl/linalg/chebyshev.hpp"
+
+#include "sparse_test_problems.hpp"
+
+
+//
+// -------------------------------------------------------------
+//
+template <typename NumericT, typename MatrixT, typename TagT>
+int check_solution(MatrixT const & A, viennacl::vector<NumericT> const & x, viennacl::vector<NumericT> const & b,
+                   TagT const & tag, NumericT epsilon)
+{
+  NumericT res = relative_residual(A, x, b);
+  std::cout << "  > " << tag.iters() << " iterations, residual " << res << ", estimate " << tag.error() << std::endl;
+  if (res > 10 * epsilon || tag.error() > epsilon)
+  {
+    std::cout << "# Error: residual too large" << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+template <typename NumericT>
+int test(NumericT epsilon)
+{
+  typedef viennacl::compressed_matrix<NumericT>    MatrixType;
+  typedef viennacl::vector<NumericT>               VectorType;
+
+  std::size_t N = 20;
+  std::size_t n = N * N;
+
+  std::vector< std::map<unsigned int, NumericT> > A_host;
+  convection_diffusion_2d(N, NumericT(0), NumericT(0), A_host);
+  MatrixType A(n, n);
+  viennacl::copy(A_host, A);
+
+  std::vector<NumericT> b_host(n);
+  fill_reproducible(b_host, 29, NumericT(1));
+  VectorType b(n);
+  viennacl::copy(b_host, b);
+
+  // the eigenvalues of the Laplace matrix are 4 - 2 cos(i pi / (N+1)) - 2 cos(j pi / (N+1)), i, j = 1, ..., N:
+  double lambda_min = 4.0 - 4.0 * std::cos(3.14159265358979 / double(N + 1));
+  double lambda_max = 4.0 + 4.0 * std::cos(3.14159265358979 / double(N + 1));
+
+  std::cout << "# Testing Chebyshev iteration with exact spectral bounds" << std::endl;
+  viennacl::linalg::chebyshev_tag tag_exact(epsilon, 1000, lambda_min, lambda_max);
+  VectorType x = viennacl::linalg::solve(A, b, tag_exact);
+  if (check_solution(A, x, b, tag_exact, epsilon) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  std::cout << "# Testing Chebyshev iteration with estimated spectral bounds" << std::endl;
+  viennacl::linalg::chebyshev_tag tag(epsilon, 1000);
+  x = viennacl::linalg::solve(A, b, tag);
+  if (check_solution(A, x, b, tag, epsilon) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  std::cout << "# Testing spectral bounds with diagonal scaling" << std::endl;
+  {
+    // the diagonal of the Laplace matrix is 4, so the bounds for D^{-1} A are those for A scaled by 1/4:
+    VectorType inv_diag = viennacl::scalar_vector<NumericT>(n, NumericT(0.25));
+    NumericT est_min = 0, est_max = 0, est_min_scaled = 0, est_max_scaled = 0;
+    viennacl::linalg::detail::chebyshev_estimate_spectrum(A, est_min, est_max);
+    viennacl::linalg::detail::chebyshev_estimate_spectrum(A, &inv_diag, est_min_scaled, est_max_scaled, 20);
+    std::cout << "  > bounds for A: [" << est_min << ", " << est_max << "], for D^{-1} A: [" << est_min_scaled << ", " << est_max_scaled << "]" << std::endl;
+    if (est_max_scaled < NumericT(lambda_max / 4.0) || std::fabs(4 * est_max_scaled - est_max) > 100 * epsilon * est_max
+        || std::fabs(4 * est_min_scaled - est_min) > 100 * epsilon * est_max)
+    {
+      std::cout << "# Error: spectral bounds with diagonal scaling are wrong" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::cout << "# Testing Chebyshev iteration with estimated spectral bounds for variable coefficients" << std::endl;
+  {
+    std::vector< std::map<unsigned int, NumericT> > A2_host;
+    variable_diffusion_2d(N, NumericT(1), A2_host);
+    MatrixType A2(n, n);
+    viennacl::copy(A2_host, A2);
+
+    viennacl::linalg::chebyshev_tag tag2(epsilon, 5000);
+    VectorType x2 = viennacl::linalg::solve(A2, b, tag2);
+    if (check_solution(A2, x2, b, tag2, epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+  }
+
+  std::cout << "# Testing Chebyshev preconditioner for CG" << std::endl;
+  viennacl::linalg::cg_tag cg_tag(epsilon, 1000);
+  x = viennacl::linalg::solve(A, b, cg_tag);
+  std::cout << "  > CG without preconditioner: " << cg_tag.iters() << " iterations" << std::endl;
+  unsigned int cg_iters = cg_tag.iters();
+
+  viennacl::linalg::chebyshev_precond<MatrixType> precond(A, viennacl::linalg::chebyshev_precond_tag(3));
+  std::cout << "  > spectral bounds: [" << precond.lambda_min() << ", " << precond.lambda_max() << "], exact: [" << lambda_min << ", " << lambda_max << "]" << std::endl;
+  if (precond.lambda_max() < NumericT(lambda_max) || precond.lambda_min() <= 0)
+  {
+    std::cout << "# Error: estimated upper bound below the largest eigenvalue" << std::endl;
+    return EXIT_FAILURE;
+  }
+  x = viennacl::linalg::solve(A, b, cg_tag, precond);
+  NumericT res = relative_residual(A, x, b);
+  std::cout << "  > CG with Chebyshev preconditioner of degree 3: " << cg_tag.iters() << " iterations, residual " << res << std::endl;
+  if (res > 10 * epsilon)
+  {
+    std::cout << "# Error: residual too large" << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (2 * cg_tag.iters() > cg_iters)
+  {
+    std::cout << "# Error: preconditioner did not reduce the number of iterations sufficiently" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
+//
+// -------------------------------------------------------------
+//
+int main()
+{
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "## Test :: Chebyshev iteration and preconditioner" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+  int retval = EXIT_SUCCESS;
+
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+  {
+    typedef float NumericT;
+    NumericT epsilon = static_cast<NumericT>(1E-4);
+    std::cout << "# Testing setup:" << std::endl;
+    std::cout << "  eps:     " << epsilon << std::endl;
+    std::cout << "  numeric: float" << std::endl;
+    retval = test<NumericT>(epsilon);
+    if( retval == EXIT_SUCCESS )
+        std::cout << "# Test passed" << std::endl;
+    else
+        return retval;
+  }
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+#ifdef VIENNACL_WITH_OPENCL
+  if( viennacl::ocl::current_device().double_support() )
+#endif
+  {
+    {
+      typedef double NumericT;
+      NumericT epsilon = 1.0E-8;
+      std::cout << "# Testing setup:" << std::endl;
+      std::cout << "  eps:     " << epsilon << std::endl;
+      std::cout << "  numeric: double" << std::endl;
+      retval = test<NumericT>(epsilon);
+      if( retval == EXIT_SUCCESS )
+        std::cout << "# Test passed" << std::endl;
+      else
+        return retval;
+    }
+    std::cout << std::endl;
+    std::cout << "----------------------------------------------" << std::endl;
+    std::cout << std::endl;
+  }
+#ifdef VIENNACL_WITH_OPENCL
+  else
+    std::cout << "No double precision support, skipping test..." << std::endl;
+#endif
+
+  std::cout << std::endl;
+  std::cout << "------- Test completed --------" << std::endl;
+  std::cout << std::endl;
+
+  return retval;
+}
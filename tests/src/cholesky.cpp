@@ -0,0 +1,273 @@
+/* =========================================================================
+   Copyright (c) 2010-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+//
+// *** System
+//
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <stdlib.h>
+
+//
+// *** ViennaCL
+//
+#include "viennacl/matrix.hpp"
+#include "viennacl/vector.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/cholesky.hpp"
+
+#include "sparse_test_problems.hpp"
+
+
+//
+// -------------------------------------------------------------
+//
+
+/** @brief Returns the symmetric positive definite matrix B B^T + shift * I for a reproducible random n x n matrix B */
+template <typename NumericT>
+std::vector< std::vector<NumericT> > spd_matrix(std::size_t n, NumericT shift, unsigned long seed)
+{
+  std::vector<NumericT> B(n * n);
+  fill_reproducible(B, seed);
+  std::vector< std::vector<NumericT> > A(n, std::vector<NumericT>(n));
+  for (std::size_t i=0; i<n; ++i)
+    for (std::size_t j=0; j<n; ++j)
+    {
+      NumericT sum = (i == j) ? shift : NumericT(0);
+      for (std::size_t k=0; k<n; ++k)
+        sum += B[i*n + k] * B[j*n + k];
+      A[i][j] = sum;
+    }
+  return A;
+}
+
+/** @brief Unblocked reference Cholesky factorization (Cholesky-Banachiewicz) in double precision */
+template <typename NumericT>
+std::vector< std::vector<double> > reference_cholesky(std::vector< std::vector<NumericT> > const & A)
+{
+  std::size_t n = A.size();
+  std::vector< std::vector<double> > L(n, std::vector<double>(n, 0.0));
+  for (std::size_t i=0; i<n; ++i)
+    for (std::size_t j=0; j<=i; ++j)
+    {
+      double sum = A[i][j];
+      for (std::size_t k=0; k<j; ++k)
+        sum -= L[i][k] * L[j][k];
+      L[i][j] = (i == j) ? std::sqrt(sum) : sum / L[j][j];
+    }
+  return L;
+}
+
+template <typename NumericT, typename F>
+int check_cholesky(std::size_t n, NumericT epsilon)
+{
+  std::vector< std::vector<NumericT> > A_host = spd_matrix(n, NumericT(1), 163 + n);
+  std::vector< std::vector<double> > L_ref = reference_cholesky(A_host);
+
+  viennacl::matrix<NumericT, F> A(n, n);
+  viennacl::copy(A_host, A);
+  if (!viennacl::linalg::cholesky_factorize(A))
+  {
+    std::cout << "# Error: SPD matrix reported as not positive definite" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::vector< std::vector<NumericT> > L_host(n, std::vector<NumericT>(n));
+  viennacl::copy(A, L_host);
+  double err_L = 0, norm_L = 0;
+  bool upper_unchanged = true;
+  for (std::size_t i=0; i<n; ++i)
+    for (std::size_t j=0; j<n; ++j)
+    {
+      if (j <= i)
+      {
+        err_L = std::max(err_L, std::fabs(L_host[i][j] - L_ref[i][j]));
+        norm_L = std::max(norm_L, std::fabs(L_ref[i][j]));
+      }
+      else if (L_host[i][j] != A_host[i][j])
+        upper_unchanged = false;
+    }
+  err_L /= norm_L;
+
+  // vector right hand side:
+  std::vector<NumericT> b_host(n);
+  fill_reproducible(b_host, 167);
+  viennacl::vector<NumericT> b(n);
+  viennacl::copy(b_host, b);
+  viennacl::vector<NumericT> x = b;
+  viennacl::linalg::cholesky_substitute(A, x);
+
+  std::vector<NumericT> x_host(n);
+  viennacl::copy(x, x_host);
+  double res_vec = 0, norm_b = 0;
+  for (std::size_t i=0; i<n; ++i)
+  {
+    double sum = b_host[i];
+    for (std::size_t j=0; j<n; ++j)
+      sum -= double(A_host[i][j]) * double(x_host[j]);
+    res_vec += sum * sum;
+    norm_b += double(b_host[i]) * double(b_host[i]);
+  }
+  res_vec = std::sqrt(res_vec / norm_b);
+
+  // matrix right hand side in row-major and column-major layout:
+  std::size_t num_rhs = 5;
+  std::vector< std::vector<NumericT> > B_host(n, std::vector<NumericT>(num_rhs));
+  std::vector<NumericT> column(n);
+  for (std::size_t k=0; k<num_rhs; ++k)
+  {
+    fill_reproducible(column, 173 + k);
+    for (std::size_t i=0; i<n; ++i)
+      B_host[i][k] = column[i];
+  }
+  viennacl::matrix<NumericT, viennacl::row_major>    X1(n, num_rhs);
+  viennacl::matrix<NumericT, viennacl::column_major> X2(n, num_rhs);
+  viennacl::copy(B_host, X1);
+  viennacl::copy(B_host, X2);
+  viennacl::linalg::cholesky_substitute(A, X1);
+  viennacl::linalg::cholesky_substitute(A, X2);
+
+  std::vector< std::vector<NumericT> > X1_host(n, std::vector<NumericT>(num_rhs)), X2_host(n, std::vector<NumericT>(num_rhs));
+  viennacl::copy(X1, X1_host);
+  viennacl::copy(X2, X2_host);
+  double res_mat = 0;
+  for (std::size_t k=0; k<num_rhs; ++k)
+  {
+    double res = 0, norm = 0;
+    for (std::size_t i=0; i<n; ++i)
+    {
+      double sum1 = B_host[i][k], sum2 = B_host[i][k];
+      for (std::size_t j=0; j<n; ++j)
+      {
+        sum1 -= double(A_host[i][j]) * double(X1_host[j][k]);
+        sum2 -= double(A_host[i][j]) * double(X2_host[j][k]);
+      }
+      res += std::max(sum1 * sum1, sum2 * sum2);
+      norm += double(B_host[i][k]) * double(B_host[i][k]);
+    }
+    res_mat = std::max(res_mat, std::sqrt(res / norm));
+  }
+
+  std::cout << "  > n = " << n << ": |L - L_ref| = " << err_L << ", residual vector rhs " << res_vec << ", residual matrix rhs " << res_mat << std::endl;
+  if (err_L > epsilon || !upper_unchanged || res_vec > epsilon || res_mat > epsilon)
+  {
+    std::cout << "# Error: Cholesky factorization or substitution failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+template <typename NumericT>
+int test(NumericT epsilon)
+{
+  std::size_t sizes[] = { 1, 7, 64, 65, 150 };
+
+  std::cout << "# Testing row-major matrices" << std::endl;
+  for (std::size_t k=0; k<5; ++k)
+    if (check_cholesky<NumericT, viennacl::row_major>(sizes[k], epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+
+  std::cout << "# Testing column-major matrices" << std::endl;
+  for (std::size_t k=0; k<5; ++k)
+    if (check_cholesky<NumericT, viennacl::column_major>(sizes[k], epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+
+  // B B^T - shift * I is indefinite for a shift larger than the smallest eigenvalue of B B^T:
+  std::cout << "# Testing indefinite matrix" << std::endl;
+  {
+    std::size_t n = 80;
+    std::vector< std::vector<NumericT> > A_host = spd_matrix(n, NumericT(-1), 179);
+    viennacl::matrix<NumericT> A(n, n);
+    viennacl::copy(A_host, A);
+    if (viennacl::linalg::cholesky_factorize(A))
+    {
+      std::cout << "# Error: indefinite matrix reported as positive definite" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
+//
+// -------------------------------------------------------------
+//
+int main()
+{
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "## Test :: Dense Cholesky factorization" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+  int retval = EXIT_SUCCESS;
+
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+  {
+    typedef float NumericT;
+    NumericT epsilon = static_cast<NumericT>(1E-4);
+    std::cout << "# Testing setup:" << std::endl;
+    std::cout << "  eps:     " << epsilon << std::endl;
+    std::cout << "  numeric: float" << std::endl;
+    retval = test<NumericT>(epsilon);
+    if( retval == EXIT_SUCCESS )
+      std::cout << "# Test passed" << std::endl;
+    else
+      return retval;
+  }
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+#ifdef VIENNACL_WITH_OPENCL
+  if( viennacl::ocl::current_device().double_support() )
+#endif
+  {
+    {
+      typedef double NumericT;
+      NumericT epsilon = 1.0E-8;
+      std::cout << "# Testing setup:" << std::endl;
+      std::cout << "  eps:     " << epsilon << std::endl;
+      std::cout << "  numeric: double" << std::endl;
+      retval = test<NumericT>(epsilon);
+      if( retval == EXIT_SUCCESS )
+        std::cout << "# Test passed" << std::endl;
+      else
+        return retval;
+    }
+    std::cout << std::endl;
+    std::cout << "----------------------------------------------" << std::endl;
+    std::cout << std::endl;
+  }
+#ifdef VIENNACL_WITH_OPENCL
+  else
+    std::cout << "No double precision support, skipping test..." << std::endl;
+#endif
+
+  std::cout << std::endl;
+  std::cout << "------- Test completed --------" << std::endl;
+  std::cout << std::endl;
+
+  return retval;
+}
@@ -0,0 +1,239 @@
+/* =========================================================================
+   Copyright (c) 2010-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+//
+// *** System
+//
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <map>
+#include <cmath>
+#include <stdlib.h>
+
+//
+// *** ViennaCL
+//
+#include "viennacl/matrix.hpp"
+#include "viennacl/vector.hpp"
+#include "viennacl/compressed_matrix.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/norm_2.hpp"
+#include "viennacl/linalg/cg.hpp"
+#include "viennacl/linalg/bicgstab.hpp"
+#include "viennacl/linalg/ilu.hpp"
+#include "viennacl/linalg/ichol.hpp"
+
+#include "sparse_test_problems.hpp"
+
+
+//
+// -------------------------------------------------------------
+//
+
+/** @brief Compares the application of two preconditioners to the same vector */
+template <typename NumericT, typename Precond1T, typename Precond2T>
+NumericT precond_difference(Precond1T const & precond1, Precond2T const & precond2, std::size_t n)
+{
+  std::vector<NumericT> v_host(n);
+  fill_reproducible(v_host, 53, NumericT(1));
+  viennacl::vector<NumericT> v1(n), v2(n);
+  viennacl::copy(v_host, v1);
+  viennacl::copy(v_host, v2);
+
+  precond1.apply(v1);
+  precond2.apply(v2);
+  NumericT norm_v2 = viennacl::linalg::norm_2(v2);
+  v1 -= v2;
+  return viennacl::linalg::norm_2(v1) / norm_v2;
+}
+
+template <typename NumericT>
+int test(NumericT epsilon)
+{
+  typedef viennacl::compressed_matrix<NumericT>    MatrixType;
+  typedef viennacl::vector<NumericT>               VectorType;
+
+  std::size_t N = 16;
+  std::size_t n = N * N;
+
+  std::vector< std::map<unsigned int, NumericT> > A_nonsym_host;
+  convection_diffusion_2d(N, NumericT(0.3), NumericT(0), A_nonsym_host);
+  MatrixType A_nonsym(n, n);
+  viennacl::copy(A_nonsym_host, A_nonsym);
+
+  std::vector< std::map<unsigned int, NumericT> > A_spd_host;
+  variable_diffusion_2d(N, NumericT(1), A_spd_host);
+  MatrixType A_spd(n, n);
+  viennacl::copy(A_spd_host, A_spd);
+
+  //
+  // The fixed-point sweeps converge to the classical ILU0/IC0 factors
+  //
+  std::cout << "# Testing convergence of the sweeps to the classical factorizations" << std::endl;
+  {
+    viennacl::linalg::ilu0_tag ilu0_config;
+    viennacl::linalg::ilu0_precond<MatrixType> ilu0(A_nonsym, ilu0_config);
+    viennacl::linalg::ichol0_tag ichol0_config;
+    viennacl::linalg::ichol0_precond<MatrixType> ichol0(A_spd, ichol0_config);
+
+    NumericT diff_ilu_prev = 0;
+    NumericT diff_ic_prev  = 0;
+    for (std::size_t sweeps = 1; sweeps <= 64; sweeps *= 4)
+    {
+      viennacl::linalg::chow_patel_tag tag(sweeps, 0);  //exact triangular solves
+      viennacl::linalg::chow_patel_ilu_precond<MatrixType> chow_patel_ilu(A_nonsym, tag);
+      viennacl::linalg::chow_patel_icc_precond<MatrixType> chow_patel_icc(A_spd, tag);
+      viennacl::linalg::ichol0_precond<MatrixType> ichol0_chow_patel(A_spd, tag);
+
+      NumericT diff_ilu = precond_difference<NumericT>(chow_patel_ilu, ilu0, n);
+      NumericT diff_ic  = precond_difference<NumericT>(chow_patel_icc, ichol0, n);
+      NumericT diff_ic_setup = precond_difference<NumericT>(ichol0_chow_patel, chow_patel_icc, n);
+      std::cout << "  > " << sweeps << " sweeps: relative difference to ILU0: " << diff_ilu << ", to IC0: " << diff_ic << std::endl;
+      if (diff_ic_setup > epsilon)
+      {
+        std::cout << "# Error: ichol0_precond with chow_patel_tag differs from chow_patel_icc_precond: " << diff_ic_setup << std::endl;
+        return EXIT_FAILURE;
+      }
+      if (sweeps > 1 && (diff_ilu > std::max(diff_ilu_prev, epsilon) || diff_ic > std::max(diff_ic_prev, epsilon)))  //up to round-off
+      {
+        std::cout << "# Error: sweeps do not converge" << std::endl;
+        return EXIT_FAILURE;
+      }
+      diff_ilu_prev = diff_ilu;
+      diff_ic_prev  = diff_ic;
+    }
+    if (diff_ilu_prev > 10 * epsilon || diff_ic_prev > 10 * epsilon)
+    {
+      std::cout << "# Error: sweeps do not converge to the classical factorizations" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::vector<NumericT> b_host(n);
+  fill_reproducible(b_host, 59, NumericT(1));
+  VectorType b(n);
+  viennacl::copy(b_host, b);
+
+  //
+  // Few sweeps and approximate triangular solves by Jacobi sweeps still yield a useful preconditioner
+  //
+  std::cout << "# Testing BiCGStab with Chow-Patel ILU preconditioner" << std::endl;
+  {
+    viennacl::linalg::bicgstab_tag solver_tag(epsilon, 1000);
+    VectorType x = viennacl::linalg::solve(A_nonsym, b, solver_tag);
+    std::cout << "  > without preconditioner: " << solver_tag.iters() << " iterations" << std::endl;
+    std::size_t iters_unpreconditioned = solver_tag.iters();
+
+    viennacl::linalg::chow_patel_ilu_precond<MatrixType> precond(A_nonsym, viennacl::linalg::chow_patel_tag());
+    x = viennacl::linalg::solve(A_nonsym, b, solver_tag, precond);
+    NumericT res = relative_residual(A_nonsym, x, b);
+    std::cout << "  > with preconditioner: " << solver_tag.iters() << " iterations, residual " << res << std::endl;
+    if (res > 100 * epsilon || 2 * solver_tag.iters() > iters_unpreconditioned)
+    {
+      std::cout << "# Error: preconditioned solve failed" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::cout << "# Testing CG with Chow-Patel IC preconditioner" << std::endl;
+  {
+    viennacl::linalg::cg_tag solver_tag(epsilon, 1000);
+    VectorType x = viennacl::linalg::solve(A_spd, b, solver_tag);
+    std::cout << "  > without preconditioner: " << solver_tag.iters() << " iterations" << std::endl;
+    std::size_t iters_unpreconditioned = solver_tag.iters();
+
+    viennacl::linalg::chow_patel_icc_precond<MatrixType> precond(A_spd, viennacl::linalg::chow_patel_tag());
+    x = viennacl::linalg::solve(A_spd, b, solver_tag, precond);
+    NumericT res = relative_residual(A_spd, x, b);
+    std::cout << "  > with preconditioner: " << solver_tag.iters() << " iterations, residual " << res << std::endl;
+    if (res > 100 * epsilon || 3 * solver_tag.iters() > 2 * iters_unpreconditioned)
+    {
+      std::cout << "# Error: preconditioned solve failed" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
+//
+// -------------------------------------------------------------
+//
+int main()
+{
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "## Test :: Chow-Patel ILU0 and IC0 preconditioners" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+  int retval = EXIT_SUCCESS;
+
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+  {
+    typedef float NumericT;
+    NumericT epsilon = static_cast<NumericT>(1E-4);
+    std::cout << "# Testing setup:" << std::endl;
+    std::cout << "  eps:     " << epsilon << std::endl;
+    std::cout << "  numeric: float" << std::endl;
+    retval = test<NumericT>(epsilon);
+    if( retval == EXIT_SUCCESS )
+        std::cout << "# Test passed" << std::endl;
+    else
+        return retval;
+  }
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+#ifdef VIENNACL_WITH_OPENCL
+  if( viennacl::ocl::current_device().double_support() )
+#endif
+  {
+    {
+      typedef double NumericT;
+      NumericT epsilon = 1.0E-8;
+      std::cout << "# Testing setup:" << std::endl;
+      std::cout << "  eps:     " << epsilon << std::endl;
+      std::cout << "  numeric: double" << std::endl;
+      retval = test<NumericT>(epsilon);
+      if( retval == EXIT_SUCCESS )
+        std::cout << "# Test passed" << std::endl;
+      else
+        return retval;
+    }
+    std::cout << std::endl;
+    std::cout << "----------------------------------------------" << std::endl;
+    std::cout << std::endl;
+  }
+#ifdef VIENNACL_WITH_OPENCL
+  else
+    std::cout << "No double precision support, skipping test..." << std::endl;
+#endif
+
+  std::cout << std::endl;
+  std::cout << "------- Test completed --------" << std::endl;
+  std::cout << std::endl;
+
+  return retval;
+}
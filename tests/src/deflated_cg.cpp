@@ -0,0 +1,210 @@
+/* =========================================================================
+   Copyright (c) 2010-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+//
+// *** System
+//
+#include <iostream>
+#include <vector>
+#include <map>
+#include <cmath>
+#include <stdlib.h>
+
+//
+// *** ViennaCL
+//
+#include "viennacl/matrix.hpp"
+#include "viennacl/vector.hpp"
+#include "viennacl/compressed_matrix.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/norm_2.hpp"
+#include "viennacl/linalg/cg.hpp"
+#include "viennacl/linalg/jacobi_precond.hpp"
+#include "viennacl/linalg/recycle_space.hpp"
+#include "viennacl/linalg/deflated_cg.hpp"
+
+#include "sparse_test_problems.hpp"
+
+
+//
+// -------------------------------------------------------------
+//
+template <typename NumericT>
+int test(NumericT epsilon)
+{
+  typedef viennacl::compressed_matrix<NumericT>    MatrixType;
+  typedef viennacl::vector<NumericT>               VectorType;
+
+  std::size_t N = 24;
+  std::size_t n = N * N;
+
+  //
+  // Sequence of slowly changing symmetric positive definite systems with different right hand sides.
+  // Deflating the smallest eigenvalues must reduce the number of matrix-vector products (including those for recomputing A W) compared to CG.
+  //
+  std::cout << "# Testing sequence of systems with and without deflation" << std::endl;
+  viennacl::linalg::recycle_space<VectorType> space(8);
+  std::size_t matvecs_cg = 0;
+  std::size_t matvecs_deflated = 0;
+  for (std::size_t step = 0; step < 5; ++step)
+  {
+    std::vector< std::map<unsigned int, NumericT> > A_host;
+    variable_diffusion_2d(N, NumericT(1) + NumericT(0.02) * NumericT(step), A_host);
+    MatrixType A(n, n);
+    viennacl::copy(A_host, A);
+
+    std::vector<NumericT> b_host(n);
+    fill_reproducible(b_host, 31 + step, NumericT(1));
+    VectorType b(n);
+    viennacl::copy(b_host, b);
+
+    viennacl::linalg::cg_tag tag_cg(epsilon, 2000);
+    VectorType x_cg = viennacl::linalg::solve(A, b, tag_cg);
+
+    std::size_t recycled_vectors = space.size();
+    viennacl::linalg::deflated_cg_tag tag(epsilon, 2000);
+    VectorType x = viennacl::linalg::solve(A, b, tag, space);
+
+    NumericT res_cg = relative_residual(A, x_cg, b);
+    NumericT res    = relative_residual(A, x, b);
+    std::cout << "  > step " << step << ": CG " << tag_cg.iters() << " iterations (residual " << res_cg << "), "
+              << "deflated CG " << tag.iters() << " + " << recycled_vectors << " iterations (residual " << res << ")" << std::endl;
+    if (res > 10 * epsilon || tag.error() > epsilon)
+    {
+      std::cout << "# Error: residual too large" << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (space.size() == 0 || space.size() > space.max_size())
+    {
+      std::cout << "# Error: invalid size of the recycled subspace after solve: " << space.size() << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    if (step > 0)  //the first solve has no subspace to deflate
+    {
+      matvecs_cg       += tag_cg.iters();
+      matvecs_deflated += tag.iters() + recycled_vectors;
+    }
+  }
+  std::cout << "  > total: CG " << matvecs_cg << ", deflated CG " << matvecs_deflated << std::endl;
+  if (matvecs_deflated >= matvecs_cg)
+  {
+    std::cout << "# Error: deflation did not reduce the number of matrix-vector products" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  //
+  // Jacobi preconditioner, and a system of different size which discards the recycled subspace
+  //
+  std::cout << "# Testing Jacobi preconditioner and change of system size" << std::endl;
+  {
+    std::size_t N2 = N - 4;
+    std::vector< std::map<unsigned int, NumericT> > A_host;
+    variable_diffusion_2d(N2, NumericT(1.5), A_host);
+    MatrixType A(N2 * N2, N2 * N2);
+    viennacl::copy(A_host, A);
+
+    std::vector<NumericT> b_host(N2 * N2);
+    fill_reproducible(b_host, 37);
+    VectorType b(N2 * N2);
+    viennacl::copy(b_host, b);
+
+    viennacl::linalg::jacobi_precond<MatrixType> precond(A, viennacl::linalg::jacobi_tag());
+    for (std::size_t run = 0; run < 2; ++run)
+    {
+      viennacl::linalg::deflated_cg_tag tag(epsilon, 2000);
+      VectorType x = viennacl::linalg::solve(A, b, tag, precond, space);
+
+      NumericT res = relative_residual(A, x, b);
+      std::cout << "  > run " << run << ": " << tag.iters() << " iterations, residual " << res << std::endl;
+      if (res > 100 * epsilon || space.size() == 0 || space.U()[0].size() != N2 * N2)
+      {
+        std::cout << "# Error: preconditioned solve failed" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
+//
+// -------------------------------------------------------------
+//
+int main()
+{
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "## Test :: Deflated CG solver with subspace recycling" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+  int retval = EXIT_SUCCESS;
+
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+  {
+    typedef float NumericT;
+    NumericT epsilon = static_cast<NumericT>(1E-4);
+    std::cout << "# Testing setup:" << std::endl;
+    std::cout << "  eps:     " << epsilon << std::endl;
+    std::cout << "  numeric: float" << std::endl;
+    retval = test<NumericT>(epsilon);
+    if( retval == EXIT_SUCCESS )
+        std::cout << "# Test passed" << std::endl;
+    else
+        return retval;
+  }
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+#ifdef VIENNACL_WITH_OPENCL
+  if( viennacl::ocl::current_device().double_support() )
+#endif
+  {
+    {
+      typedef double NumericT;
+      NumericT epsilon = 1.0E-8;
+      std::cout << "# Testing setup:" << std::endl;
+      std::cout << "  eps:     " << epsilon << std::endl;
+      std::cout << "  numeric: double" << std::endl;
+      retval = test<NumericT>(epsilon);
+      if( retval == EXIT_SUCCESS )
+        std::cout << "# Test passed" << std::endl;
+      else
+        return retval;
+    }
+    std::cout << std::endl;
+    std::cout << "----------------------------------------------" << std::endl;
+    std::cout << std::endl;
+  }
+#ifdef VIENNACL_WITH_OPENCL
+  else
+    std::cout << "No double precision support, skipping test..." << std::endl;
+#endif
+
+  std::cout << std::endl;
+  std::cout << "------- Test completed --------" << std::endl;
+  std::cout << std::endl;
+
+  return retval;
+}
@@ -0,0 +1,198 @@
+/* =========================================================================
+   Copyright (c) 2010-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+//
+// *** System
+//
+#include <iostream>
+#include <vector>
+#include <map>
+#include <cmath>
+#include <stdlib.h>
+
+//
+// *** ViennaCL
+//
+#include "viennacl/matrix.hpp"
+#include "viennacl/vector.hpp"
+#include "viennacl/compressed_matrix.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/norm_2.hpp"
+#include "viennacl/linalg/jacobi_precond.hpp"
+#include "viennacl/linalg/fgmres.hpp"
+
+#include "sparse_test_problems.hpp"
+
+
+//
+// -------------------------------------------------------------
+//
+template <typename NumericT, typename MatrixT>
+int check_solution(MatrixT const & A, viennacl::vector<NumericT> const & x, viennacl::vector<NumericT> const & b,
+                   viennacl::linalg::fgmres_tag const & tag, NumericT epsilon)
+{
+  // FGMRES uses right preconditioning, hence the estimate must agree with the true residual:
+  NumericT res = relative_residual(A, x, b);
+  std::cout << "  > " << tag.iters() << " iterations, residual " << res << ", estimate " << tag.error() << std::endl;
+  if (res > 10 * epsilon || tag.error() > epsilon)
+  {
+    std::cout << "# Error: residual too large" << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+template <typename NumericT>
+int test(NumericT epsilon)
+{
+  typedef viennacl::compressed_matrix<NumericT>    MatrixType;
+  typedef viennacl::vector<NumericT>               VectorType;
+
+  std::size_t N = 20;
+  std::size_t n = N * N;
+
+  std::vector< std::map<unsigned int, NumericT> > A_host;
+  convection_diffusion_2d(N, NumericT(0.3), NumericT(0.1), A_host);
+  MatrixType A(n, n);
+  viennacl::copy(A_host, A);
+
+  std::vector<NumericT> b_host(n);
+  fill_reproducible(b_host, 11, NumericT(1));
+  VectorType b(n);
+  viennacl::copy(b_host, b);
+
+  std::cout << "# Testing FGMRES without preconditioner" << std::endl;
+  viennacl::linalg::fgmres_tag tag(epsilon, 1000, 20);
+  VectorType x = viennacl::linalg::solve(A, b, tag);
+  if (check_solution(A, x, b, tag, epsilon) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+  unsigned int iters_unpreconditioned = tag.iters();
+
+  std::cout << "# Testing FGMRES with Jacobi preconditioner" << std::endl;
+  viennacl::linalg::jacobi_precond<MatrixType> jacobi(A, viennacl::linalg::jacobi_tag());
+  x = viennacl::linalg::solve(A, b, tag, jacobi);
+  if (check_solution(A, x, b, tag, epsilon) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  std::cout << "# Testing FGMRES with inner BiCGStab iteration as preconditioner" << std::endl;
+  viennacl::linalg::solver_precond<MatrixType, VectorType, viennacl::linalg::bicgstab_tag> inner_bicgstab(A, viennacl::linalg::bicgstab_tag(1e-2, 5));
+  x = viennacl::linalg::solve(A, b, tag, inner_bicgstab);
+  if (check_solution(A, x, b, tag, epsilon) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+  if (inner_bicgstab.inner_iters() == 0 || tag.iters() >= iters_unpreconditioned)
+  {
+    std::cout << "# Error: inner solver did not reduce the number of outer iterations" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "# Testing FGMRES with inner GMRES iteration as preconditioner and a reused workspace" << std::endl;
+  viennacl::linalg::solver_precond<MatrixType, VectorType, viennacl::linalg::gmres_tag,
+                                   viennacl::linalg::jacobi_precond<MatrixType> > inner_gmres(A, viennacl::linalg::gmres_tag(1e-2, 10, 10), jacobi);
+  viennacl::linalg::fgmres_workspace<VectorType> workspace;
+  x = viennacl::linalg::solve(A, b, tag, inner_gmres, workspace);
+  if (check_solution(A, x, b, tag, epsilon) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  // second solve with a different right hand side reuses the workspace:
+  fill_reproducible(b_host, 12);
+  viennacl::copy(b_host, b);
+  x = viennacl::linalg::solve(A, b, tag, inner_gmres, workspace);
+  if (check_solution(A, x, b, tag, epsilon) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  // the workspace adapts to a system of different size:
+  std::size_t N2 = N - 5;
+  convection_diffusion_2d(N2, NumericT(0.3), NumericT(0.1), A_host);
+  MatrixType A2(N2 * N2, N2 * N2);
+  viennacl::copy(A_host, A2);
+  std::vector<NumericT> b2_host(N2 * N2);
+  fill_reproducible(b2_host, 13);
+  VectorType b2(N2 * N2);
+  viennacl::copy(b2_host, b2);
+  VectorType x2 = viennacl::linalg::solve(A2, b2, tag, viennacl::linalg::no_precond(), workspace);
+  if (check_solution(A2, x2, b2, tag, epsilon) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  return EXIT_SUCCESS;
+}
+
+
+//
+// -------------------------------------------------------------
+//
+int main()
+{
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "## Test :: Flexible GMRES solver" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+  int retval = EXIT_SUCCESS;
+
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+  {
+    typedef float NumericT;
+    NumericT epsilon = static_cast<NumericT>(1E-4);
+    std::cout << "# Testing setup:" << std::endl;
+    std::cout << "  eps:     " << epsilon << std::endl;
+    std::cout << "  numeric: float" << std::endl;
+    retval = test<NumericT>(epsilon);
+    if( retval == EXIT_SUCCESS )
+        std::cout << "# Test passed" << std::endl;
+    else
+        return retval;
+  }
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+#ifdef VIENNACL_WITH_OPENCL
+  if( viennacl::ocl::current_device().double_support() )
+#endif
+  {
+    {
+      typedef double NumericT;
+      NumericT epsilon = 1.0E-8;
+      std::cout << "# Testing setup:" << std::endl;
+      std::cout << "  eps:     " << epsilon << std::endl;
+      std::cout << "  numeric: double" << std::endl;
+      retval = test<NumericT>(epsilon);
+      if( retval == EXIT_SUCCESS )
+        std::cout << "# Test passed" << std::endl;
+      else
+        return retval;
+    }
+    std::cout << std::endl;
+    std::cout << "----------------------------------------------" << std::endl;
+    std::cout << std::endl;
+  }
+#ifdef VIENNACL_WITH_OPENCL
+  else
+    std::cout << "No double precision support, skipping test..." << std::endl;
+#endif
+
+  std::cout << std::endl;
+  std::cout << "------- Test completed --------" << std::endl;
+  std::cout << std::endl;
+
+  return retval;
+}
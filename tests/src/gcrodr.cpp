@@ -0,0 +1,182 @@
+/* =========================================================================
+   Copyright (c) 2010-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+//
+// *** System
+//
+#include <iostream>
+#include <vector>
+#include <map>
+#include <cmath>
+#include <stdlib.h>
+
+//
+// *** ViennaCL
+//
+#include "viennacl/matrix.hpp"
+#include "viennacl/vector.hpp"
+#include "viennacl/compressed_matrix.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/norm_2.hpp"
+#include "viennacl/linalg/jacobi_precond.hpp"
+#include "viennacl/linalg/recycle_space.hpp"
+#include "viennacl/linalg/gcrodr.hpp"
+
+#include "sparse_test_problems.hpp"
+
+
+//
+// -------------------------------------------------------------
+//
+template <typename NumericT>
+int test(NumericT epsilon)
+{
+  std::size_t N = 30;
+  std::size_t n = N * N;
+
+  //
+  // Sequence of slowly changing, mildly nonsymmetric systems with different right hand sides.
+  // The recycled solves must converge and need fewer matrix-vector products (including those for recomputing C = A U) than solving from scratch.
+  //
+  std::cout << "# Testing sequence of systems with and without recycling" << std::endl;
+  viennacl::linalg::recycle_space< viennacl::vector<NumericT> > space(16);
+  std::size_t matvecs_cold = 0;
+  std::size_t matvecs_recycled = 0;
+  for (std::size_t step = 0; step < 5; ++step)
+  {
+    std::vector< std::map<unsigned int, NumericT> > A_host;
+    convection_diffusion_2d(N, NumericT(0.05), NumericT(0.002) * NumericT(step), A_host);
+    viennacl::compressed_matrix<NumericT> A(n, n);
+    viennacl::copy(A_host, A);
+
+    std::vector<NumericT> b_host(n);
+    fill_reproducible(b_host, 42 + step, NumericT(1));
+    viennacl::vector<NumericT> b(n);
+    viennacl::copy(b_host, b);
+
+    viennacl::linalg::gcrodr_tag tag_cold(epsilon, 2000, 40);
+    viennacl::linalg::recycle_space< viennacl::vector<NumericT> > no_space(16);
+    viennacl::vector<NumericT> x_cold = viennacl::linalg::solve(A, b, tag_cold, no_space);
+
+    std::size_t recycled_vectors = space.size();
+    viennacl::linalg::gcrodr_tag tag(epsilon, 2000, 40);
+    viennacl::vector<NumericT> x = viennacl::linalg::solve(A, b, tag, space);
+
+    NumericT res_cold = relative_residual(A, x_cold, b);
+    NumericT res      = relative_residual(A, x, b);
+    std::cout << "  > step " << step << ": cold " << tag_cold.iters() << " iterations (residual " << res_cold << "), "
+              << "recycled " << tag.iters() << " + " << recycled_vectors << " iterations (residual " << res << ")" << std::endl;
+    if (res_cold > 10 * epsilon || res > 10 * epsilon)
+    {
+      std::cout << "# Error: residual too large" << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (space.size() == 0)
+    {
+      std::cout << "# Error: no recycled subspace after solve" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    matvecs_cold     += tag_cold.iters();
+    matvecs_recycled += tag.iters() + recycled_vectors;
+  }
+  std::cout << "  > total: cold " << matvecs_cold << ", recycled " << matvecs_recycled << std::endl;
+  if (matvecs_recycled >= matvecs_cold)
+  {
+    std::cout << "# Error: recycling did not reduce the number of matrix-vector products" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  //
+  // Right preconditioning, and a system of different size which discards the recycled subspace
+  //
+  std::cout << "# Testing Jacobi preconditioner and change of system size" << std::endl;
+  {
+    std::size_t N2 = N + 3;
+    std::vector< std::map<unsigned int, NumericT> > A_host;
+    variable_diffusion_2d(N2, NumericT(2), A_host);
+    viennacl::compressed_matrix<NumericT> A(N2 * N2, N2 * N2);
+    viennacl::copy(A_host, A);
+
+    std::vector<NumericT> b_host(N2 * N2);
+    fill_reproducible(b_host, 7);
+    viennacl::vector<NumericT> b(N2 * N2);
+    viennacl::copy(b_host, b);
+
+    viennacl::linalg::jacobi_precond< viennacl::compressed_matrix<NumericT> > precond(A, viennacl::linalg::jacobi_tag());
+    viennacl::linalg::gcrodr_tag tag(epsilon, 2000, 40);
+    viennacl::vector<NumericT> x = viennacl::linalg::solve(A, b, tag, precond, space);
+
+    NumericT res = relative_residual(A, x, b);
+    std::cout << "  > iterations: " << tag.iters() << ", residual: " << res << std::endl;
+    if (res > 10 * epsilon || space.size() == 0 || space.U()[0].size() != N2 * N2)
+    {
+      std::cout << "# Error: preconditioned solve failed" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
+//
+// -------------------------------------------------------------
+//
+int main()
+{
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "## Test :: GCRO-DR solver with subspace recycling" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+  int retval = EXIT_SUCCESS;
+
+#ifdef VIENNACL_WITH_OPENCL
+  if( viennacl::ocl::current_device().double_support() )
+#endif
+  {
+    {
+      typedef double NumericT;
+      NumericT epsilon = 1.0E-8;
+      std::cout << "# Testing setup:" << std::endl;
+      std::cout << "  eps:     " << epsilon << std::endl;
+      std::cout << "  numeric: double" << std::endl;
+      retval = test<NumericT>(epsilon);
+      if( retval == EXIT_SUCCESS )
+        std::cout << "# Test passed" << std::endl;
+      else
+        return retval;
+    }
+    std::cout << std::endl;
+    std::cout << "----------------------------------------------" << std::endl;
+    std::cout << std::endl;
+  }
+#ifdef VIENNACL_WITH_OPENCL
+  else
+    std::cout << "No double precision support, skipping test..." << std::endl;
+#endif
+
+  std::cout << std::endl;
+  std::cout << "------- Test completed --------" << std::endl;
+  std::cout << std::endl;
+
+  return retval;
+}
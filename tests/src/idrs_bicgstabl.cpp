@@ -0,0 +1,201 @@
+/* =========================================================================
+   Copyright (c) 2010-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+//
+// *** System
+//
+#include <iostream>
+#include <vector>
+#include <map>
+#include <cmath>
+#include <stdlib.h>
+
+//
+// *** ViennaCL
+//
+#include "viennacl/matrix.hpp"
+#include "viennacl/vector.hpp"
+#include "viennacl/compressed_matrix.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/norm_2.hpp"
+#include "viennacl/linalg/jacobi_precond.hpp"
+#include "viennacl/linalg/idrs.hpp"
+#include "viennacl/linalg/bicgstabl.hpp"
+
+#include "sparse_test_problems.hpp"
+
+
+//
+// -------------------------------------------------------------
+//
+template <typename NumericT, typename MatrixT, typename TagT>
+int check_solution(MatrixT const & A, viennacl::vector<NumericT> const & x, viennacl::vector<NumericT> const & b,
+                   TagT const & tag, NumericT epsilon)
+{
+  // both solvers precondition from the right, hence the estimate refers to the true residual:
+  NumericT res = relative_residual(A, x, b);
+  std::cout << "  > " << tag.iters() << " iterations, residual " << res << ", estimate " << tag.error() << std::endl;
+  if (res > 10 * epsilon || tag.error() > epsilon)
+  {
+    std::cout << "# Error: residual too large" << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+template <typename NumericT>
+int test(NumericT epsilon)
+{
+  typedef viennacl::compressed_matrix<NumericT>    MatrixType;
+  typedef viennacl::vector<NumericT>               VectorType;
+
+  std::size_t N = 20;
+  std::size_t n = N * N;
+
+  std::vector< std::map<unsigned int, NumericT> > A_host;
+  convection_diffusion_2d(N, NumericT(0.4), NumericT(0.05), A_host);
+  MatrixType A(n, n);
+  viennacl::copy(A_host, A);
+
+  std::vector<NumericT> b_host(n);
+  fill_reproducible(b_host, 17, NumericT(1));
+  VectorType b(n);
+  viennacl::copy(b_host, b);
+
+  viennacl::linalg::jacobi_precond<MatrixType> jacobi(A, viennacl::linalg::jacobi_tag());
+
+  for (std::size_t s = 1; s <= 8; s *= 2)
+  {
+    std::cout << "# Testing IDR(" << s << ")" << std::endl;
+    viennacl::linalg::idrs_tag tag(epsilon, 1000, s);
+    VectorType x = viennacl::linalg::solve(A, b, tag);
+    if (check_solution(A, x, b, tag, epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+
+    std::cout << "# Testing IDR(" << s << ") with Jacobi preconditioner" << std::endl;
+    x = viennacl::linalg::solve(A, b, tag, jacobi);
+    if (check_solution(A, x, b, tag, epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+  }
+
+  // systems smaller than the shadow space dimension:
+  for (std::size_t n_small = 1; n_small <= 3; ++n_small)
+  {
+    std::cout << "# Testing IDR(4) for a system of size " << n_small << std::endl;
+    std::vector< std::map<unsigned int, NumericT> > A_small_host(n_small);
+    for (std::size_t i=0; i<n_small; ++i)
+    {
+      A_small_host[i][static_cast<unsigned int>(i)] = NumericT(2) + NumericT(i);
+      if (i > 0)
+        A_small_host[i][static_cast<unsigned int>(i-1)] = NumericT(0.5);
+    }
+    MatrixType A_small(n_small, n_small);
+    viennacl::copy(A_small_host, A_small);
+    std::vector<NumericT> b_small_host(n_small);
+    fill_reproducible(b_small_host, 19, NumericT(1));
+    VectorType b_small(n_small);
+    viennacl::copy(b_small_host, b_small);
+
+    viennacl::linalg::idrs_tag tag(epsilon, 100, 4);
+    VectorType x = viennacl::linalg::solve(A_small, b_small, tag);
+    if (check_solution(A_small, x, b_small, tag, epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+  }
+
+  for (std::size_t l = 1; l <= 4; ++l)
+  {
+    std::cout << "# Testing BiCGStab(" << l << ")" << std::endl;
+    viennacl::linalg::bicgstabl_tag tag(epsilon, 1000, l);
+    VectorType x = viennacl::linalg::solve(A, b, tag);
+    if (check_solution(A, x, b, tag, epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+
+    std::cout << "# Testing BiCGStab(" << l << ") with Jacobi preconditioner" << std::endl;
+    x = viennacl::linalg::solve(A, b, tag, jacobi);
+    if (check_solution(A, x, b, tag, epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
+//
+// -------------------------------------------------------------
+//
+int main()
+{
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "## Test :: IDR(s) and BiCGStab(l) solvers" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+  int retval = EXIT_SUCCESS;
+
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+  {
+    typedef float NumericT;
+    NumericT epsilon = static_cast<NumericT>(1E-4);
+    std::cout << "# Testing setup:" << std::endl;
+    std::cout << "  eps:     " << epsilon << std::endl;
+    std::cout << "  numeric: float" << std::endl;
+    retval = test<NumericT>(epsilon);
+    if( retval == EXIT_SUCCESS )
+        std::cout << "# Test passed" << std::endl;
+    else
+        return retval;
+  }
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+#ifdef VIENNACL_WITH_OPENCL
+  if( viennacl::ocl::current_device().double_support() )
+#endif
+  {
+    {
+      typedef double NumericT;
+      NumericT epsilon = 1.0E-8;
+      std::cout << "# Testing setup:" << std::endl;
+      std::cout << "  eps:     " << epsilon << std::endl;
+      std::cout << "  numeric: double" << std::endl;
+      retval = test<NumericT>(epsilon);
+      if( retval == EXIT_SUCCESS )
+        std::cout << "# Test passed" << std::endl;
+      else
+        return retval;
+    }
+    std::cout << std::endl;
+    std::cout << "----------------------------------------------" << std::endl;
+    std::cout << std::endl;
+  }
+#ifdef VIENNACL_WITH_OPENCL
+  else
+    std::cout << "No double precision support, skipping test..." << std::endl;
+#endif
+
+  std::cout << std::endl;
+  std::cout << "------- Test completed --------" << std::endl;
+  std::cout << std::endl;
+
+  return retval;
+}
@@ -0,0 +1,253 @@
+/* =========================================================================
+   Copyright (c) 2010-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+//
+// *** System
+//
+#include <iostream>
+#include <vector>
+#include <map>
+#include <string>
+#include <cmath>
+#include <algorithm>
+#include <stdlib.h>
+
+//
+// *** Boost
+//
+#include <boost/numeric/ublas/vector.hpp>
+
+//
+// *** ViennaCL
+//
+#include "viennacl/matrix.hpp"
+#include "viennacl/compressed_matrix.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/jacobi_precond.hpp"
+#include "viennacl/linalg/ilu.hpp"
+#include "viennacl/linalg/qr-method.hpp"
+#include "viennacl/linalg/lobpcg.hpp"
+
+#include "sparse_test_problems.hpp"
+
+
+//
+// -------------------------------------------------------------
+//
+
+/** @brief Reference eigenvalues in ascending order from the dense symmetric eigensolver */
+template <typename NumericT>
+std::vector<NumericT> dense_eigenvalues(std::vector< std::map<unsigned int, NumericT> > const & A)
+{
+  std::size_t n = A.size();
+  std::vector< std::vector<NumericT> > A_dense(n, std::vector<NumericT>(n));
+  for (std::size_t i=0; i<n; ++i)
+    for (typename std::map<unsigned int, NumericT>::const_iterator it = A[i].begin(); it != A[i].end(); ++it)
+      A_dense[i][it->first] = it->second;
+
+  viennacl::matrix<NumericT> vcl_A(n, n), vcl_Q(n, n);
+  viennacl::copy(A_dense, vcl_A);
+  boost::numeric::ublas::vector<NumericT> D(n);
+  viennacl::linalg::qr_method_sym(vcl_A, vcl_Q, D);
+
+  std::vector<NumericT> lambda(D.begin(), D.end());
+  std::sort(lambda.begin(), lambda.end());
+  return lambda;
+}
+
+/** @brief Checks the eigenvalues against the reference, the residuals ||A x_i - lambda_i x_i|| / lambda_i and the orthonormality of the eigenvectors */
+template <typename NumericT>
+int check_eigenpairs(std::string const & name, std::vector< std::map<unsigned int, NumericT> > const & A,
+                     std::vector<NumericT> const & eigenvalues, std::vector<NumericT> const & reference,
+                     viennacl::matrix<NumericT, viennacl::column_major> const & eigenvectors,
+                     viennacl::linalg::lobpcg_tag const & tag, NumericT epsilon)
+{
+  std::size_t n = A.size();
+  std::size_t k = tag.num_eigenvalues();
+
+  std::vector< std::vector<NumericT> > X(n, std::vector<NumericT>(k));
+  viennacl::copy(eigenvectors, X);
+
+  NumericT err_values = 0;
+  NumericT err_res = 0;
+  NumericT err_orth = 0;
+  for (std::size_t q=0; q<k; ++q)
+  {
+    err_values = std::max(err_values, std::fabs(eigenvalues[q] - reference[q]) / reference[q]);
+
+    NumericT res = 0;
+    for (std::size_t i=0; i<n; ++i)
+    {
+      NumericT temp = -eigenvalues[q] * X[i][q];
+      for (typename std::map<unsigned int, NumericT>::const_iterator it = A[i].begin(); it != A[i].end(); ++it)
+        temp += it->second * X[it->first][q];
+      res += temp * temp;
+    }
+    err_res = std::max(err_res, std::sqrt(res) / eigenvalues[q]);
+
+    for (std::size_t p=0; p<=q; ++p)
+    {
+      NumericT dot = 0;
+      for (std::size_t i=0; i<n; ++i)
+        dot += X[i][p] * X[i][q];
+      err_orth = std::max(err_orth, std::fabs(dot - NumericT(p == q)));
+    }
+  }
+
+  std::cout << "  > " << name << ": " << tag.num_converged() << " converged after " << tag.iters() << " iterations and "
+            << tag.matrix_products() << " products, eigenvalue error " << err_values << ", residual " << err_res
+            << ", |X^T X - I| = " << err_orth << std::endl;
+  if (eigenvalues.size() != k || tag.num_converged() != k || err_values > 10 * epsilon || err_res > 10 * epsilon || err_orth > 10 * epsilon)
+  {
+    std::cout << "# Error: LOBPCG failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+template <typename NumericT>
+int test(NumericT epsilon)
+{
+  typedef viennacl::compressed_matrix<NumericT>   MatrixType;
+
+  std::size_t N = 16;
+  std::size_t n = N * N;
+  std::size_t k = 6;
+
+  std::vector< std::map<unsigned int, NumericT> > A_host;
+  variable_diffusion_2d(N, NumericT(2), A_host);
+  MatrixType A(n, n);
+  viennacl::copy(A_host, A);
+  std::vector<NumericT> reference = dense_eigenvalues(A_host);
+
+  std::cout << "# Testing LOBPCG without preconditioner" << std::endl;
+  viennacl::linalg::lobpcg_tag tag(k, epsilon, 1000);
+  viennacl::matrix<NumericT, viennacl::column_major> X;
+  std::vector<NumericT> lambda = viennacl::linalg::eig(A, X, tag);
+  if (check_eigenpairs("no preconditioner", A_host, lambda, reference, X, tag, epsilon) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  std::cout << "# Testing LOBPCG with Jacobi preconditioner" << std::endl;
+  viennacl::linalg::jacobi_precond<MatrixType> jacobi(A, viennacl::linalg::jacobi_tag());
+  viennacl::linalg::lobpcg_tag tag_jacobi(k, epsilon, 1000);
+  viennacl::matrix<NumericT, viennacl::column_major> X_jacobi;
+  lambda = viennacl::linalg::eig(A, X_jacobi, tag_jacobi, jacobi);
+  if (check_eigenpairs("Jacobi", A_host, lambda, reference, X_jacobi, tag_jacobi, epsilon) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+  if (tag_jacobi.matrix_products() >= tag.matrix_products())
+  {
+    std::cout << "# Error: Jacobi preconditioner did not reduce the number of matrix-vector products" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "# Testing LOBPCG with ILU0 preconditioner" << std::endl;
+  viennacl::linalg::ilu0_precond<MatrixType> ilu0(A, viennacl::linalg::ilu0_tag());
+  viennacl::linalg::lobpcg_tag tag_ilu0(k, epsilon, 1000);
+  viennacl::matrix<NumericT, viennacl::column_major> X_ilu0;
+  lambda = viennacl::linalg::eig(A, X_ilu0, tag_ilu0, ilu0);
+  if (check_eigenpairs("ILU0", A_host, lambda, reference, X_ilu0, tag_ilu0, epsilon) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+  if (tag_ilu0.matrix_products() >= tag.matrix_products())
+  {
+    std::cout << "# Error: ILU0 preconditioner did not reduce the number of matrix-vector products" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "# Testing LOBPCG with additional block vectors" << std::endl;
+  viennacl::linalg::lobpcg_tag tag_block(k, epsilon, 1000, k + 3);
+  viennacl::matrix<NumericT, viennacl::column_major> X_block;
+  lambda = viennacl::linalg::eig(A, X_block, tag_block, ilu0);
+  if (check_eigenpairs("ILU0, block size 9", A_host, lambda, reference, X_block, tag_block, epsilon) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  // the eigenvectors of the original matrix are the initial guess for a slightly perturbed matrix (block size k, hence used):
+  std::cout << "# Testing LOBPCG with initial guess" << std::endl;
+  {
+    std::vector< std::map<unsigned int, NumericT> > A2_host;
+    variable_diffusion_2d(N, NumericT(2.05), A2_host);
+    MatrixType A2(n, n);
+    viennacl::copy(A2_host, A2);
+    std::vector<NumericT> reference2 = dense_eigenvalues(A2_host);
+    viennacl::linalg::ilu0_precond<MatrixType> ilu0_2(A2, viennacl::linalg::ilu0_tag());
+
+    viennacl::linalg::lobpcg_tag tag_cold(k, epsilon, 1000);
+    viennacl::matrix<NumericT, viennacl::column_major> X_cold;
+    lambda = viennacl::linalg::eig(A2, X_cold, tag_cold, ilu0_2);
+    if (check_eigenpairs("perturbed, no initial guess", A2_host, lambda, reference2, X_cold, tag_cold, epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+
+    viennacl::linalg::lobpcg_tag tag_guess(k, epsilon, 1000);
+    lambda = viennacl::linalg::eig(A2, X_ilu0, tag_guess, ilu0_2);
+    if (check_eigenpairs("perturbed, initial guess", A2_host, lambda, reference2, X_ilu0, tag_guess, epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+    if (tag_guess.matrix_products() >= tag_cold.matrix_products())
+    {
+      std::cout << "# Error: initial guess did not reduce the number of matrix-vector products" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
+//
+// -------------------------------------------------------------
+//
+int main()
+{
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "## Test :: LOBPCG eigensolver" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+  int retval = EXIT_SUCCESS;
+
+#ifdef VIENNACL_WITH_OPENCL
+  if( viennacl::ocl::current_device().double_support() )
+#endif
+  {
+    {
+      typedef double NumericT;
+      NumericT epsilon = 1.0E-8;
+      std::cout << "# Testing setup:" << std::endl;
+      std::cout << "  eps:     " << epsilon << std::endl;
+      std::cout << "  numeric: double" << std::endl;
+      retval = test<NumericT>(epsilon);
+      if( retval == EXIT_SUCCESS )
+        std::cout << "# Test passed" << std::endl;
+      else
+        return retval;
+    }
+    std::cout << std::endl;
+    std::cout << "----------------------------------------------" << std::endl;
+    std::cout << std::endl;
+  }
+#ifdef VIENNACL_WITH_OPENCL
+  else
+    std::cout << "No double precision support, skipping test..." << std::endl;
+#endif
+
+  std::cout << std::endl;
+  std::cout << "------- Test completed --------" << std::endl;
+  std::cout << std::endl;
+
+  return retval;
+}
@@ -0,0 +1,195 @@
+/* =========================================================================
+   Copyright (c) 2010-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+//
+// *** System
+//
+#include <iostream>
+#include <vector>
+#include <map>
+#include <cmath>
+#include <stdlib.h>
+
+//
+// *** ViennaCL
+//
+#include "viennacl/matrix.hpp"
+#include "viennacl/vector.hpp"
+#include "viennacl/compressed_matrix.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/norm_2.hpp"
+#include "viennacl/linalg/jacobi_precond.hpp"
+#include "viennacl/linalg/minres.hpp"
+
+#include "sparse_test_problems.hpp"
+
+
+//
+// -------------------------------------------------------------
+//
+template <typename NumericT, typename MatrixT>
+int check_solution(MatrixT const & A, viennacl::vector<NumericT> const & x, viennacl::vector<NumericT> const & b,
+                   viennacl::linalg::minres_tag const & tag, NumericT tolerance)
+{
+  NumericT res = relative_residual(A, x, b);
+  std::cout << "  > " << tag.iters() << " iterations, residual " << res << ", estimate " << tag.error() << std::endl;
+  if (res > tolerance || tag.error() > tag.tolerance())
+  {
+    std::cout << "# Error: residual too large" << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+template <typename NumericT>
+int test(NumericT epsilon)
+{
+  typedef viennacl::compressed_matrix<NumericT>    MatrixType;
+  typedef viennacl::vector<NumericT>               VectorType;
+
+  std::size_t N = 20;
+  std::size_t n = N * N;
+
+  std::vector<NumericT> b_host(n);
+  fill_reproducible(b_host, 23, NumericT(1));
+  VectorType b(n);
+  viennacl::copy(b_host, b);
+
+  std::cout << "# Testing MINRES for the symmetric positive definite Laplace matrix" << std::endl;
+  {
+    std::vector< std::map<unsigned int, NumericT> > A_host;
+    convection_diffusion_2d(N, NumericT(0), NumericT(0), A_host);
+    MatrixType A(n, n);
+    viennacl::copy(A_host, A);
+
+    viennacl::linalg::minres_tag tag(epsilon, 1000);
+    VectorType x = viennacl::linalg::solve(A, b, tag);
+    if (check_solution(A, x, b, tag, 10 * epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+  }
+
+  // Laplace matrix shifted into the interior of its spectrum (0, 8): symmetric indefinite, for which CG is not applicable
+  std::cout << "# Testing MINRES for the shifted (indefinite) Laplace matrix" << std::endl;
+  {
+    std::vector< std::map<unsigned int, NumericT> > A_host;
+    convection_diffusion_2d(N, NumericT(0), NumericT(-1.5), A_host);
+    MatrixType A(n, n);
+    viennacl::copy(A_host, A);
+
+    viennacl::linalg::minres_tag tag(epsilon, 1000);
+    VectorType x = viennacl::linalg::solve(A, b, tag);
+    if (check_solution(A, x, b, tag, 10 * epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+  }
+
+  // Variable coefficients shifted to be indefinite while keeping a positive diagonal, so that Jacobi is a symmetric positive definite preconditioner
+  std::cout << "# Testing MINRES with Jacobi preconditioner for an indefinite matrix with variable coefficients" << std::endl;
+  {
+    std::vector< std::map<unsigned int, NumericT> > A_host;
+    variable_diffusion_2d(N, NumericT(1.5), A_host);
+    for (std::size_t i=0; i<n; ++i)
+      A_host[i][static_cast<unsigned int>(i)] -= NumericT(0.5);
+    MatrixType A(n, n);
+    viennacl::copy(A_host, A);
+
+    viennacl::linalg::minres_tag tag(epsilon, 1000);
+    VectorType x = viennacl::linalg::solve(A, b, tag);
+    if (check_solution(A, x, b, tag, 10 * epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+
+    // the estimate refers to the preconditioned residual, hence allow for the condition number of the diagonal:
+    viennacl::linalg::jacobi_precond<MatrixType> jacobi(A, viennacl::linalg::jacobi_tag());
+    viennacl::linalg::minres_tag tag_precond(epsilon, 1000);
+    x = viennacl::linalg::solve(A, b, tag_precond, jacobi);
+    if (check_solution(A, x, b, tag_precond, 100 * epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+    if (tag_precond.iters() >= tag.iters())
+    {
+      std::cout << "# Error: Jacobi preconditioner did not reduce the number of iterations" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
+//
+// -------------------------------------------------------------
+//
+int main()
+{
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "## Test :: MINRES solver" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+  int retval = EXIT_SUCCESS;
+
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+  {
+    typedef float NumericT;
+    NumericT epsilon = static_cast<NumericT>(1E-4);
+    std::cout << "# Testing setup:" << std::endl;
+    std::cout << "  eps:     " << epsilon << std::endl;
+    std::cout << "  numeric: float" << std::endl;
+    retval = test<NumericT>(epsilon);
+    if( retval == EXIT_SUCCESS )
+        std::cout << "# Test passed" << std::endl;
+    else
+        return retval;
+  }
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+#ifdef VIENNACL_WITH_OPENCL
+  if( viennacl::ocl::current_device().double_support() )
+#endif
+  {
+    {
+      typedef double NumericT;
+      NumericT epsilon = 1.0E-8;
+      std::cout << "# Testing setup:" << std::endl;
+      std::cout << "  eps:     " << epsilon << std::endl;
+      std::cout << "  numeric: double" << std::endl;
+      retval = test<NumericT>(epsilon);
+      if( retval == EXIT_SUCCESS )
+        std::cout << "# Test passed" << std::endl;
+      else
+        return retval;
+    }
+    std::cout << std::endl;
+    std::cout << "----------------------------------------------" << std::endl;
+    std::cout << std::endl;
+  }
+#ifdef VIENNACL_WITH_OPENCL
+  else
+    std::cout << "No double precision support, skipping test..." << std::endl;
+#endif
+
+  std::cout << std::endl;
+  std::cout << "------- Test completed --------" << std::endl;
+  std::cout << std::endl;
+
+  return retval;
+}
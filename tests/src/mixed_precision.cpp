@@ -0,0 +1,275 @@
+/* =========================================================================
+   Copyright (c) 2010-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+//
+// *** System
+//
+#include <iostream>
+#include <vector>
+#include <map>
+#include <cmath>
+#include <stdlib.h>
+
+//
+// *** ViennaCL
+//
+#include "viennacl/matrix.hpp"
+#include "viennacl/vector.hpp"
+#include "viennacl/vector_proxy.hpp"
+#include "viennacl/compressed_matrix.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/norm_2.hpp"
+#include "viennacl/linalg/cg.hpp"
+#include "viennacl/linalg/bicgstab.hpp"
+#include "viennacl/linalg/gmres.hpp"
+#include "viennacl/linalg/jacobi_precond.hpp"
+#include "viennacl/linalg/mixed_precision.hpp"
+
+#include "sparse_test_problems.hpp"
+
+
+//
+// -------------------------------------------------------------
+//
+template <typename MatrixT, typename TagT>
+int check_solution(MatrixT const & A, viennacl::vector<double> const & x, viennacl::vector<double> const & b,
+                   TagT const & tag, double epsilon)
+{
+  double res = relative_residual(A, x, b);
+  std::cout << "  > " << tag.refinements() << " refinements, " << tag.iters() << " inner iterations, residual " << res << ", reported " << tag.error() << std::endl;
+  if (res > 10 * epsilon || tag.error() > epsilon)
+  {
+    std::cout << "# Error: residual too large" << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (std::fabs(res - tag.error()) > 1e-2 * res)
+  {
+    std::cout << "# Error: reported residual does not match the true residual" << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+int test(double epsilon)
+{
+  typedef viennacl::compressed_matrix<double>    MatrixType;
+  typedef viennacl::vector<double>               VectorType;
+
+  std::size_t N = 20;
+  std::size_t n = N * N;
+
+  std::vector<double> b_host(n);
+  fill_reproducible(b_host, 41, 1.0);
+  VectorType b(n);
+  viennacl::copy(b_host, b);
+
+  std::cout << "# Testing conversion of vectors" << std::endl;
+  {
+    viennacl::vector<float> b_float(n);
+    viennacl::linalg::convert(b_float, b, 0.5);
+    viennacl::linalg::inplace_add_converted(b, b_float, 2.0);   // b += 2 * (b / 2) = 2b up to float rounding
+
+    std::vector<float>  b_float_host(n);
+    std::vector<double> b_twice_host(n);
+    viennacl::copy(b_float, b_float_host);
+    viennacl::copy(b, b_twice_host);
+    for (std::size_t i=0; i<n; ++i)
+    {
+      if (std::fabs(double(b_float_host[i]) - 0.5 * b_host[i]) > 1e-7 * std::fabs(b_host[i])
+          || std::fabs(b_twice_host[i] - 2.0 * b_host[i]) > 1e-7 * std::fabs(b_host[i]))
+      {
+        std::cout << "# Error: conversion failed at index " << i << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+    viennacl::copy(b_host, b);
+  }
+
+  std::cout << "# Testing conversion in main memory for OpenCL and CUDA, using a range and a slice" << std::endl;
+  {
+    // the fallback is independent of the memory domain, so it is compared with the kernels here:
+    viennacl::vector<float>  src_float(2 * n);
+    viennacl::vector<double> dst(n + 4);
+    viennacl::vector<double> dst_ref(n + 4);
+    viennacl::linalg::convert(src_float, viennacl::vector<double>(viennacl::scalar_vector<double>(2 * n, 3.0)));
+    dst     = viennacl::scalar_vector<double>(n + 4, -1.0);
+    dst_ref = viennacl::scalar_vector<double>(n + 4, -1.0);
+
+    viennacl::slice s(1, 2, n);
+    viennacl::range r(2, n + 2);
+    viennacl::vector_slice< viennacl::vector<float> >  src_slice(src_float, s);
+    viennacl::vector_range< viennacl::vector<double> > dst_range(dst, r);
+    viennacl::vector_range< viennacl::vector<double> > dst_ref_range(dst_ref, r);
+    viennacl::vector_range< viennacl::vector<double> > b_range(b, viennacl::range(0, n));
+
+    viennacl::linalg::convert(src_slice, b_range, 0.5);
+    viennacl::linalg::detail::inplace_add_converted_in_main_memory(dst_range, src_slice, 2.0);
+    viennacl::linalg::inplace_add_converted(dst_ref_range, src_slice, 2.0);
+    viennacl::linalg::detail::convert_in_main_memory(src_slice, dst_range, 0.25);
+
+    std::vector<double> dst_host(n + 4), dst_ref_host(n + 4);
+    std::vector<float> src_host(2 * n);
+    viennacl::copy(dst, dst_host);
+    viennacl::copy(dst_ref, dst_ref_host);
+    viennacl::copy(src_float, src_host);
+    for (std::size_t i=0; i<n + 4; ++i)
+    {
+      if (dst_host[i] != dst_ref_host[i])
+      {
+        std::cout << "# Error: update in main memory differs at index " << i << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+    for (std::size_t i=0; i<2 * n; ++i)
+    {
+      // odd entries: 0.25 * (-1 + 2 * 0.5 b), even entries are not part of the slice:
+      double expected = (i % 2 == 1) ? 0.25 * (b_host[i / 2] - 1.0) : 3.0;
+      if (std::fabs(double(src_host[i]) - expected) > 1e-6 * (1.0 + std::fabs(expected)))
+      {
+        std::cout << "# Error: conversion in main memory failed at index " << i << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  std::cout << "# Testing conversion of a sparse matrix" << std::endl;
+  std::vector< std::map<unsigned int, double> > A_host;
+  convection_diffusion_2d(N, 0.0, 0.0, A_host);
+  MatrixType A(n, n);
+  viennacl::copy(A_host, A);
+  {
+    viennacl::compressed_matrix<float> A_float(A.size1(), A.size2(), A.nnz(), viennacl::traits::context(A));
+    viennacl::linalg::convert(A_float, A);
+
+    std::vector< std::map<unsigned int, float> > A_float_host(n);
+    viennacl::copy(A_float, A_float_host);
+    for (std::size_t i=0; i<n; ++i)
+    {
+      if (A_float_host[i].size() != A_host[i].size())
+      {
+        std::cout << "# Error: sparsity pattern of converted matrix differs in row " << i << std::endl;
+        return EXIT_FAILURE;
+      }
+      for (std::map<unsigned int, double>::const_iterator it = A_host[i].begin(); it != A_host[i].end(); ++it)
+        if (double(A_float_host[i][it->first]) != it->second)
+        {
+          std::cout << "# Error: converted matrix entry differs in row " << i << std::endl;
+          return EXIT_FAILURE;
+        }
+    }
+  }
+
+  std::cout << "# Testing refinement with inner CG" << std::endl;
+  viennacl::linalg::mixed_precision_tag<viennacl::linalg::cg_tag> cg_tag(viennacl::linalg::cg_tag(1e-3, 200), epsilon);
+  VectorType x = viennacl::linalg::solve(A, b, cg_tag);
+  if (check_solution(A, x, b, cg_tag, epsilon) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  std::cout << "# Testing refinement with inner Jacobi-preconditioned CG on a user-supplied single precision matrix" << std::endl;
+  {
+    std::vector< std::map<unsigned int, double> > A2_host;
+    variable_diffusion_2d(N, 1.5, A2_host);
+    MatrixType A2(n, n);
+    viennacl::copy(A2_host, A2);
+    viennacl::compressed_matrix<float> A2_float(A2.size1(), A2.size2(), A2.nnz(), viennacl::traits::context(A2));
+    viennacl::linalg::convert(A2_float, A2);
+
+    viennacl::linalg::jacobi_precond< viennacl::compressed_matrix<float> > precond(A2_float, viennacl::linalg::jacobi_tag());
+    viennacl::linalg::mixed_precision_tag<viennacl::linalg::cg_tag> tag(viennacl::linalg::cg_tag(1e-3, 500), epsilon);
+    VectorType x2 = viennacl::linalg::solve(A2, A2_float, b, tag, precond);
+    if (check_solution(A2, x2, b, tag, epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+  }
+
+  std::cout << "# Testing refinement with inner BiCGStab and GMRES for a nonsymmetric matrix" << std::endl;
+  {
+    std::vector< std::map<unsigned int, double> > A3_host;
+    convection_diffusion_2d(N, 0.3, 0.1, A3_host);
+    MatrixType A3(n, n);
+    viennacl::copy(A3_host, A3);
+
+    viennacl::linalg::mixed_precision_tag<viennacl::linalg::bicgstab_tag> bicgstab_tag(viennacl::linalg::bicgstab_tag(1e-3, 200), epsilon);
+    VectorType x3 = viennacl::linalg::solve(A3, b, bicgstab_tag);
+    if (check_solution(A3, x3, b, bicgstab_tag, epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+
+    viennacl::linalg::mixed_precision_tag<viennacl::linalg::gmres_tag> gmres_tag(viennacl::linalg::gmres_tag(1e-3, 200, 20), epsilon);
+    x3 = viennacl::linalg::solve(A3, b, gmres_tag);
+    if (check_solution(A3, x3, b, gmres_tag, epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+  }
+
+  std::cout << "# Testing zero right hand side" << std::endl;
+  {
+    VectorType zero = viennacl::zero_vector<double>(n);
+    x = viennacl::linalg::solve(A, zero, cg_tag);
+    if (viennacl::linalg::norm_2(x) != 0 || cg_tag.refinements() != 0)
+    {
+      std::cout << "# Error: nonzero solution for zero right hand side" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
+//
+// -------------------------------------------------------------
+//
+int main()
+{
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "## Test :: Mixed precision iterative refinement" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+  int retval = EXIT_SUCCESS;
+
+#ifdef VIENNACL_WITH_OPENCL
+  if( viennacl::ocl::current_device().double_support() )
+#endif
+  {
+    {
+      double epsilon = 1.0E-10;   //beyond the accuracy of the single precision inner solves
+      std::cout << "# Testing setup:" << std::endl;
+      std::cout << "  eps:     " << epsilon << std::endl;
+      std::cout << "  numeric: double (inner solves: float)" << std::endl;
+      retval = test(epsilon);
+      if( retval == EXIT_SUCCESS )
+        std::cout << "# Test passed" << std::endl;
+      else
+        return retval;
+    }
+    std::cout << std::endl;
+    std::cout << "----------------------------------------------" << std::endl;
+    std::cout << std::endl;
+  }
+#ifdef VIENNACL_WITH_OPENCL
+  else
+    std::cout << "No double precision support, skipping test..." << std::endl;
+#endif
+
+  std::cout << std::endl;
+  std::cout << "------- Test completed --------" << std::endl;
+  std::cout << std::endl;
+
+  return retval;
+}
@@ -17,8 +17,10 @@
 
 #include <ctime>
 #include <cmath>
+#include <map>
 
 
+#include "viennacl/compressed_matrix.hpp"
 #include "viennacl/linalg/prod.hpp"
 #include "viennacl/linalg/nmf.hpp"
 
@@ -101,6 +103,90 @@ void test_nmf(std::size_t m, std::size_t k, std::size_t n)
       exit(EXIT_FAILURE);
 }
 
+
+bool check_history(viennacl::linalg::nmf_config const & conf)
+{
+    if (conf.iteration_times().size() != conf.iters() || conf.relative_residuals().size() != conf.iters())
+    {
+      printf("[FAIL] history has %lu times and %lu residuals for %lu iterations\n",
+             static_cast<unsigned long>(conf.iteration_times().size()), static_cast<unsigned long>(conf.relative_residuals().size()),
+             static_cast<unsigned long>(conf.iters()));
+      return false;
+    }
+
+    // the multiplicative updates never increase the residual (up to round-off):
+    std::vector<double> const & res = conf.relative_residuals();
+    for (std::size_t i = 1; i < res.size(); ++i)
+    {
+      if (res[i] > res[i-1] * (1.0 + 1e-4))
+      {
+        printf("[FAIL] residual increases in iteration %lu: %g -> %g\n", static_cast<unsigned long>(i), res[i-1], res[i]);
+        return false;
+      }
+    }
+    return true;
+}
+
+/** @brief Factorizes the same sparse matrix once as a dense matrix and once as a compressed_matrix. Both runs must take the same iterates. */
+void test_nmf_sparse(std::size_t m, std::size_t k, std::size_t n)
+{
+    std::vector< std::map<unsigned int, ScalarType> > stl_v_sparse(m);
+    std::vector< std::vector<ScalarType> > stl_v(m, std::vector<ScalarType>(n));
+    for (std::size_t i = 0; i < m; i++)
+    {
+      for (std::size_t j = 0; j < n; ++j)
+      {
+        if (rand() % 8 == 0)
+        {
+          stl_v[i][j] = static_cast<ScalarType>(rand()) / RAND_MAX;
+          stl_v_sparse[i][static_cast<unsigned int>(j)] = stl_v[i][j];
+        }
+      }
+    }
+
+    viennacl::matrix<ScalarType> v_dense(m, n);
+    viennacl::compressed_matrix<ScalarType> v_sparse(m, n);
+    viennacl::copy(stl_v, v_dense);
+    viennacl::copy(stl_v_sparse, v_sparse);
+
+    std::vector< std::vector<ScalarType> > stl_w(m, std::vector<ScalarType>(k));
+    std::vector< std::vector<ScalarType> > stl_h(k, std::vector<ScalarType>(n));
+    fill_random(stl_w);
+    fill_random(stl_h);
+
+    viennacl::matrix<ScalarType> w_dense(m, k), w_sparse(m, k);
+    viennacl::matrix<ScalarType> h_dense(k, n), h_sparse(k, n);
+    viennacl::copy(stl_w, w_dense);
+    viennacl::copy(stl_h, h_dense);
+    viennacl::copy(stl_w, w_sparse);
+    viennacl::copy(stl_h, h_sparse);
+
+    // fixed number of iterations with the residual recorded in each of them:
+    viennacl::linalg::nmf_config conf;
+    conf.tolerance(0);
+    conf.stagnation_tolerance(0);
+    conf.max_iterations(200);
+    conf.check_after_steps(1);
+
+    viennacl::linalg::nmf(v_dense, w_dense, h_dense, conf);
+    double res_dense = conf.residual();
+    bool ok = check_history(conf);
+
+    // reusing the configuration object must reset the history:
+    viennacl::linalg::nmf(v_sparse, w_sparse, h_sparse, conf);
+    double res_sparse = conf.residual();
+    ok = ok && check_history(conf);
+
+    double diff = std::fabs(res_dense - res_sparse) / res_dense;
+    ok = ok && diff < 1e-3;
+
+    printf("%6s [%lux%lux%lu] sparse vs. dense: residual %g vs. %g (%lu iterations)\n", ok ? "[[OK]]":"[FAIL]", m, k, n,
+           res_sparse, res_dense, static_cast<unsigned long>(conf.iters()));
+
+    if (!ok)
+      exit(EXIT_FAILURE);
+}
+
 int main()
 {
   //srand(time(NULL));  //let's use deterministic tests, so keep the default srand() initialization
@@ -111,6 +197,9 @@ int main()
   test_nmf(140, 73, 180);
   test_nmf(427, 21, 523);
 
+  test_nmf_sparse(40, 5, 30);
+  test_nmf_sparse(200, 10, 150);
+
   std::cout << std::endl;
   std::cout << "------- Test completed --------" << std::endl;
   std::cout << std::endl;
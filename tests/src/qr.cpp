@@ -0,0 +1,291 @@
+/* =========================================================================
+   Copyright (c) 2010-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+//
+// *** System
+//
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <stdlib.h>
+
+//
+// *** Boost
+//
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/vector.hpp>
+
+//
+// *** ViennaCL
+//
+#define VIENNACL_WITH_UBLAS 1
+#include "viennacl/matrix.hpp"
+#include "viennacl/matrix_proxy.hpp"
+#include "viennacl/linalg/qr.hpp"
+
+#include "sparse_test_problems.hpp"
+
+
+//
+// -------------------------------------------------------------
+//
+namespace ublas = boost::numeric::ublas;
+
+template <typename NumericT>
+ublas::matrix<NumericT> random_matrix(std::size_t rows, std::size_t cols, unsigned long seed)
+{
+  std::vector<NumericT> values(rows * cols);
+  fill_reproducible(values, seed);
+  ublas::matrix<NumericT> A(rows, cols);
+  for (std::size_t i=0; i<rows; ++i)
+    for (std::size_t j=0; j<cols; ++j)
+      A(i, j) = values[i * cols + j];
+  return A;
+}
+
+template <typename NumericT>
+NumericT relative_difference(ublas::matrix<NumericT> const & A, ublas::matrix<NumericT> const & B)
+{
+  NumericT norm_B = ublas::norm_frobenius(B);
+  return ublas::norm_frobenius(A - B) / (norm_B > 0 ? norm_B : NumericT(1));
+}
+
+/** @brief Factors A with the given block size and checks Q R = A, Q^T Q = I, the triangular shape of R and Q^T b */
+template <typename NumericT>
+int check_qr(ublas::matrix<NumericT> const & A_orig, std::size_t block_size, NumericT epsilon)
+{
+  std::size_t m = A_orig.size1();
+  std::size_t n = A_orig.size2();
+
+  ublas::matrix<NumericT> A = A_orig;
+  std::vector<NumericT> betas = viennacl::linalg::inplace_qr(A, block_size);
+
+  ublas::matrix<NumericT> Q(m, m), R(m, n);
+  viennacl::linalg::recoverQ(A, betas, Q, R, block_size);
+
+  NumericT err_QR = relative_difference(ublas::matrix<NumericT>(ublas::prod(Q, R)), A_orig);
+
+  ublas::matrix<NumericT> QtQ = ublas::prod(ublas::trans(Q), Q);
+  ublas::identity_matrix<NumericT> I(m);
+  NumericT err_orth = ublas::norm_frobenius(QtQ - I) / std::sqrt(NumericT(m));
+
+  NumericT lower_part = 0;
+  for (std::size_t i=0; i<m; ++i)
+    for (std::size_t j=0; j<std::min(i, n); ++j)
+      lower_part = std::max(lower_part, std::fabs(R(i, j)));
+
+  std::vector<NumericT> b_values(m);
+  fill_reproducible(b_values, 97);
+  ublas::vector<NumericT> b(m);
+  std::copy(b_values.begin(), b_values.end(), b.begin());
+  ublas::vector<NumericT> Qtb_ref = ublas::prod(ublas::trans(Q), b);
+  viennacl::linalg::inplace_qr_apply_trans_Q(A, betas, b, block_size);
+  NumericT err_Qtb = ublas::norm_2(b - Qtb_ref) / ublas::norm_2(Qtb_ref);
+
+  std::cout << "  > " << m << " x " << n << ", block size " << block_size << ": |QR - A| = " << err_QR << ", |Q^T Q - I| = " << err_orth
+            << ", |Q^T b - ref| = " << err_Qtb << std::endl;
+  if (err_QR > epsilon || err_orth > epsilon || lower_part > 0 || err_Qtb > epsilon)
+  {
+    std::cout << "# Error: QR factorization failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+/** @brief Factors a viennacl::matrix and compares with the factorization of the uBLAS matrix */
+template <typename NumericT, typename F>
+int check_viennacl_qr(ublas::matrix<NumericT> const & A_orig, std::size_t block_size, NumericT epsilon)
+{
+  ublas::matrix<NumericT> A_ublas = A_orig;
+  std::vector<NumericT> betas_ublas = viennacl::linalg::inplace_qr(A_ublas, block_size);
+
+  viennacl::matrix<NumericT, F> A(A_orig.size1(), A_orig.size2());
+  viennacl::copy(A_orig, A);
+  std::vector<NumericT> betas = viennacl::linalg::inplace_qr(A, block_size);
+  ublas::matrix<NumericT> A_result(A_orig.size1(), A_orig.size2());
+  viennacl::copy(A, A_result);
+
+  NumericT err_betas = 0;
+  for (std::size_t i=0; i<betas.size(); ++i)
+    err_betas = std::max(err_betas, std::fabs(betas[i] - betas_ublas[i]));
+  NumericT err = relative_difference(A_result, A_ublas);
+  std::cout << "  > viennacl::matrix, block size " << block_size << ": difference to uBLAS " << err << ", betas " << err_betas << std::endl;
+  if (betas.size() != betas_ublas.size() || err > epsilon || err_betas > epsilon)
+  {
+    std::cout << "# Error: QR factorization of viennacl::matrix differs" << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+/** @brief Copies between a uBLAS matrix and row ranges of a wider viennacl::matrix starting at column zero. Columns outside the range must be preserved. */
+template <typename NumericT, typename F>
+int check_range_copy()
+{
+  std::size_t rows = 9;
+  std::size_t cols = 7;
+  ublas::matrix<NumericT> A_host = random_matrix<NumericT>(rows, cols, 101);
+  viennacl::matrix<NumericT, F> A(rows, cols);
+  viennacl::copy(A_host, A);
+
+  viennacl::range r1(2, 6);
+  viennacl::range r2(0, 4);
+  viennacl::matrix_range< viennacl::matrix<NumericT, F> > A_sub(A, r1, r2);
+
+  // read:
+  ublas::matrix<NumericT> block(r1.size(), r2.size());
+  viennacl::copy(A_sub, block);
+  for (std::size_t i=0; i<r1.size(); ++i)
+    for (std::size_t j=0; j<r2.size(); ++j)
+      if (block(i, j) != A_host(r1.start() + i, j))
+      {
+        std::cout << "# Error: copy from row range returned wrong entry (" << i << ", " << j << ")" << std::endl;
+        return EXIT_FAILURE;
+      }
+
+  // write:
+  ublas::matrix<NumericT> new_block = random_matrix<NumericT>(r1.size(), r2.size(), 103);
+  viennacl::copy(new_block, A_sub);
+  for (std::size_t i=0; i<r1.size(); ++i)
+    for (std::size_t j=0; j<r2.size(); ++j)
+      A_host(r1.start() + i, j) = new_block(i, j);
+
+  ublas::matrix<NumericT> A_result(rows, cols);
+  viennacl::copy(A, A_result);
+  for (std::size_t i=0; i<rows; ++i)
+    for (std::size_t j=0; j<cols; ++j)
+      if (A_result(i, j) != A_host(i, j))
+      {
+        std::cout << "# Error: copy to row range changed entry (" << i << ", " << j << ")" << std::endl;
+        return EXIT_FAILURE;
+      }
+
+  return EXIT_SUCCESS;
+}
+
+template <typename NumericT>
+int test(NumericT epsilon)
+{
+  std::cout << "# Testing copies of row ranges" << std::endl;
+  if (check_range_copy<NumericT, viennacl::row_major>() != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+  if (check_range_copy<NumericT, viennacl::column_major>() != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  std::cout << "# Testing blocked QR factorization" << std::endl;
+  std::size_t block_sizes[] = { 1, 4, 16, 64 };
+  std::size_t shapes[][2] = { { 70, 30 }, { 33, 33 }, { 20, 45 } };
+  for (std::size_t s=0; s<3; ++s)
+  {
+    ublas::matrix<NumericT> A = random_matrix<NumericT>(shapes[s][0], shapes[s][1], 107 + s);
+    for (std::size_t k=0; k<4; ++k)
+      if (check_qr(A, block_sizes[k], epsilon) != EXIT_SUCCESS)
+        return EXIT_FAILURE;
+  }
+
+  // zero and duplicate columns (zero Householder reflectors):
+  std::cout << "# Testing rank-deficient matrix" << std::endl;
+  {
+    ublas::matrix<NumericT> A = random_matrix<NumericT>(40, 12, 113);
+    for (std::size_t i=0; i<A.size1(); ++i)
+    {
+      A(i, 3) = 0;
+      A(i, 7) = A(i, 1);
+    }
+    if (check_qr(A, 4, epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+  }
+
+  std::cout << "# Testing QR factorization of viennacl::matrix" << std::endl;
+  {
+    ublas::matrix<NumericT> A = random_matrix<NumericT>(50, 24, 127);
+    if (check_viennacl_qr<NumericT, viennacl::row_major>(A, 8, epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+    if (check_viennacl_qr<NumericT, viennacl::column_major>(A, 5, epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
+//
+// -------------------------------------------------------------
+//
+int main()
+{
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "## Test :: Blocked Householder QR factorization" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+  int retval = EXIT_SUCCESS;
+
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+  {
+    typedef float NumericT;
+    NumericT epsilon = static_cast<NumericT>(1E-4);
+    std::cout << "# Testing setup:" << std::endl;
+    std::cout << "  eps:     " << epsilon << std::endl;
+    std::cout << "  numeric: float" << std::endl;
+    retval = test<NumericT>(epsilon);
+    if( retval == EXIT_SUCCESS )
+      std::cout << "# Test passed" << std::endl;
+    else
+      return retval;
+  }
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+#ifdef VIENNACL_WITH_OPENCL
+  if( viennacl::ocl::current_device().double_support() )
+#endif
+  {
+    {
+      typedef double NumericT;
+      NumericT epsilon = 1.0E-8;
+      std::cout << "# Testing setup:" << std::endl;
+      std::cout << "  eps:     " << epsilon << std::endl;
+      std::cout << "  numeric: double" << std::endl;
+      retval = test<NumericT>(epsilon);
+      if( retval == EXIT_SUCCESS )
+        std::cout << "# Test passed" << std::endl;
+      else
+        return retval;
+    }
+    std::cout << std::endl;
+    std::cout << "----------------------------------------------" << std::endl;
+    std::cout << std::endl;
+  }
+#ifdef VIENNACL_WITH_OPENCL
+  else
+    std::cout << "No double precision support, skipping test..." << std::endl;
+#endif
+
+  std::cout << std::endl;
+  std::cout << "------- Test completed --------" << std::endl;
+  std::cout << std::endl;
+
+  return retval;
+}
@@ -0,0 +1,258 @@
+/* =========================================================================
+   Copyright (c) 2010-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+//
+// *** System
+//
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <algorithm>
+#include <stdlib.h>
+
+//
+// *** Boost
+//
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/vector.hpp>
+
+//
+// *** ViennaCL
+//
+#define VIENNACL_WITH_UBLAS 1
+#include "viennacl/matrix.hpp"
+#include "viennacl/linalg/qr.hpp"
+#include "viennacl/linalg/qr-method.hpp"
+
+#include "sparse_test_problems.hpp"
+
+
+//
+// -------------------------------------------------------------
+//
+namespace ublas = boost::numeric::ublas;
+
+/** @brief Returns a reproducible random orthogonal matrix (Q factor of a random matrix) */
+template <typename NumericT>
+ublas::matrix<NumericT> random_orthogonal(std::size_t n, unsigned long seed)
+{
+  std::vector<NumericT> values(n * n);
+  fill_reproducible(values, seed);
+  ublas::matrix<NumericT> B(n, n);
+  for (std::size_t i=0; i<n; ++i)
+    for (std::size_t j=0; j<n; ++j)
+      B(i, j) = values[i * n + j];
+  std::vector<NumericT> betas = viennacl::linalg::inplace_qr(B);
+  ublas::matrix<NumericT> Q(n, n), R(n, n);
+  viennacl::linalg::recoverQ(B, betas, Q, R);
+  return Q;
+}
+
+/** @brief Runs qr_method_sym() on A and checks A V = V diag(D), V^T V = I, the diagonal matrix returned in A and the eigenvalues against the sorted reference eigenvalues */
+template <typename NumericT, typename F>
+int check_eigen(std::string const & name, ublas::matrix<NumericT> const & A, std::vector<NumericT> reference, NumericT epsilon)
+{
+  std::size_t n = A.size1();
+
+  viennacl::matrix<NumericT, F> vcl_A(n, n), vcl_V(n, n);
+  viennacl::copy(A, vcl_A);
+  ublas::vector<NumericT> D(n);
+  viennacl::linalg::qr_method_sym(vcl_A, vcl_V, D);
+
+  ublas::matrix<NumericT> A_out(n, n), V(n, n);
+  viennacl::copy(vcl_A, A_out);
+  viennacl::copy(vcl_V, V);
+
+  NumericT norm_A = std::max(NumericT(ublas::norm_frobenius(A)), NumericT(1));
+  ublas::matrix<NumericT> AV = ublas::prod(A, V);
+  NumericT err_eigen = 0;
+  NumericT err_diag = 0;
+  for (std::size_t i=0; i<n; ++i)
+    for (std::size_t j=0; j<n; ++j)
+    {
+      err_eigen = std::max(err_eigen, std::fabs(AV(i, j) - V(i, j) * D(j)));
+      err_diag  = std::max(err_diag,  std::fabs(A_out(i, j) - ((i == j) ? D(j) : NumericT(0))));
+    }
+  err_eigen /= norm_A;
+
+  ublas::matrix<NumericT> VtV = ublas::prod(ublas::trans(V), V);
+  NumericT err_orth = 0;
+  for (std::size_t i=0; i<n; ++i)
+    for (std::size_t j=0; j<n; ++j)
+      err_orth = std::max(err_orth, std::fabs(VtV(i, j) - NumericT(i == j)));
+
+  std::vector<NumericT> eigenvalues(D.begin(), D.end());
+  std::sort(eigenvalues.begin(), eigenvalues.end());
+  std::sort(reference.begin(), reference.end());
+  NumericT err_ref = 0;
+  for (std::size_t i=0; i<reference.size(); ++i)
+    err_ref = std::max(err_ref, std::fabs(reference[i] - eigenvalues[i]));
+  err_ref /= norm_A;
+
+  std::cout << "  > " << name << ", n = " << n << ": |A V - V D| = " << err_eigen << ", |V^T V - I| = " << err_orth
+            << ", eigenvalue error " << err_ref << std::endl;
+  if (err_eigen > epsilon || err_orth > epsilon || err_ref > epsilon || err_diag > 0)
+  {
+    std::cout << "# Error: symmetric QR method failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+template <typename NumericT, typename F>
+int test(NumericT epsilon)
+{
+  // sizes below, at and above the semi-bandwidth of the two-stage reduction and several of its panels:
+  std::size_t sizes[] = { 1, 2, 17, 32, 33, 65, 130 };
+
+  std::cout << "# Testing A = Q diag(lambda) Q^T with known eigenvalues" << std::endl;
+  for (std::size_t k=0; k<7; ++k)
+  {
+    std::size_t n = sizes[k];
+    ublas::matrix<NumericT> Q = random_orthogonal<NumericT>(n, 300 + k);
+
+    // distinct eigenvalues of both signs, and triple eigenvalues:
+    std::vector<NumericT> lambda(n), lambda_multiple(n);
+    for (std::size_t i=0; i<n; ++i)
+    {
+      lambda[i]          = NumericT(i) - NumericT(n) / NumericT(3) + NumericT(0.5);
+      lambda_multiple[i] = NumericT(i / 3);
+    }
+
+    ublas::matrix<NumericT> QL(n, n), QL_multiple(n, n);
+    for (std::size_t i=0; i<n; ++i)
+      for (std::size_t j=0; j<n; ++j)
+      {
+        QL(i, j)          = Q(i, j) * lambda[j];
+        QL_multiple(i, j) = Q(i, j) * lambda_multiple[j];
+      }
+    ublas::matrix<NumericT> A = ublas::prod(QL, ublas::trans(Q));
+    ublas::matrix<NumericT> A_multiple = ublas::prod(QL_multiple, ublas::trans(Q));
+
+    if (check_eigen<NumericT, F>("distinct", A, lambda, epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+    if (check_eigen<NumericT, F>("multiple", A_multiple, lambda_multiple, epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+  }
+
+  // matrices which are already banded or diagonal skip most of the reduction
+  std::cout << "# Testing banded and diagonal matrices" << std::endl;
+  {
+    std::size_t n = 80;
+    ublas::matrix<NumericT> A(n, n);
+    A.clear();
+    std::vector<NumericT> values(n * n);
+    fill_reproducible(values, 401);
+    for (std::size_t i=0; i<n; ++i)
+      for (std::size_t j=0; j<=i && j+5>i; ++j)
+        A(i, j) = A(j, i) = values[i * n + j];
+    if (check_eigen<NumericT, F>("band", A, std::vector<NumericT>(), epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+
+    A.clear();
+    std::vector<NumericT> lambda(n);
+    for (std::size_t i=0; i<n; ++i)
+      A(i, i) = lambda[i] = values[i];
+    if (check_eigen<NumericT, F>("diagonal", A, lambda, epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
+//
+// -------------------------------------------------------------
+//
+int main()
+{
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "## Test :: Symmetric eigenvalue problem (QR method)" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+  int retval = EXIT_SUCCESS;
+
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+  {
+    typedef float NumericT;
+    NumericT epsilon = static_cast<NumericT>(1E-4);
+    std::cout << "# Testing setup:" << std::endl;
+    std::cout << "  eps:     " << epsilon << std::endl;
+    std::cout << "  numeric: float, row-major" << std::endl;
+    retval = test<NumericT, viennacl::row_major>(epsilon);
+    if( retval == EXIT_SUCCESS )
+      std::cout << "# Test passed" << std::endl;
+    else
+      return retval;
+  }
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+#ifdef VIENNACL_WITH_OPENCL
+  if( viennacl::ocl::current_device().double_support() )
+#endif
+  {
+    {
+      typedef double NumericT;
+      NumericT epsilon = 1.0E-8;
+      std::cout << "# Testing setup:" << std::endl;
+      std::cout << "  eps:     " << epsilon << std::endl;
+      std::cout << "  numeric: double, row-major" << std::endl;
+      retval = test<NumericT, viennacl::row_major>(epsilon);
+      if( retval == EXIT_SUCCESS )
+        std::cout << "# Test passed" << std::endl;
+      else
+        return retval;
+    }
+    std::cout << std::endl;
+    std::cout << "----------------------------------------------" << std::endl;
+    std::cout << std::endl;
+    {
+      typedef double NumericT;
+      NumericT epsilon = 1.0E-8;
+      std::cout << "# Testing setup:" << std::endl;
+      std::cout << "  eps:     " << epsilon << std::endl;
+      std::cout << "  numeric: double, column-major" << std::endl;
+      retval = test<NumericT, viennacl::column_major>(epsilon);
+      if( retval == EXIT_SUCCESS )
+        std::cout << "# Test passed" << std::endl;
+      else
+        return retval;
+    }
+    std::cout << std::endl;
+    std::cout << "----------------------------------------------" << std::endl;
+    std::cout << std::endl;
+  }
+#ifdef VIENNACL_WITH_OPENCL
+  else
+    std::cout << "No double precision support, skipping test..." << std::endl;
+#endif
+
+  std::cout << std::endl;
+  std::cout << "------- Test completed --------" << std::endl;
+  std::cout << std::endl;
+
+  return retval;
+}
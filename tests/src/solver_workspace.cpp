@@ -0,0 +1,263 @@
+/* =========================================================================
+   Copyright (c) 2010-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+//
+// *** System
+//
+#include <iostream>
+#include <vector>
+#include <map>
+#include <string>
+#include <cmath>
+#include <stdlib.h>
+
+//
+// *** ViennaCL
+//
+#include "viennacl/vector.hpp"
+#include "viennacl/compressed_matrix.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/norm_2.hpp"
+#include "viennacl/linalg/jacobi_precond.hpp"
+#include "viennacl/linalg/cg.hpp"
+#include "viennacl/linalg/bicgstab.hpp"
+#include "viennacl/linalg/gmres.hpp"
+
+#include "sparse_test_problems.hpp"
+
+
+//
+// -------------------------------------------------------------
+//
+
+/** @brief A system of size N*N with the five-point convection-diffusion stencil and a reproducible right hand side */
+template <typename NumericT>
+struct test_system
+{
+  test_system(std::size_t N, NumericT conv, unsigned long seed) : A(N * N, N * N), b(N * N)
+  {
+    std::vector< std::map<unsigned int, NumericT> > A_host;
+    convection_diffusion_2d(N, conv, NumericT(0), A_host);
+    viennacl::copy(A_host, A);
+
+    std::vector<NumericT> b_host(N * N);
+    fill_reproducible(b_host, seed, NumericT(1));
+    viennacl::copy(b_host, b);
+  }
+
+  viennacl::compressed_matrix<NumericT> A;
+  viennacl::vector<NumericT> b;
+};
+
+/** @brief Checks that x agrees with the reference solution obtained with a temporary workspace and reaches at least the same residual */
+template <typename NumericT>
+int check_solution(std::string const & name, test_system<NumericT> const & sys, viennacl::vector<NumericT> const & x,
+                   viennacl::vector<NumericT> const & x_ref, NumericT epsilon)
+{
+  viennacl::vector<NumericT> diff = x - x_ref;
+  NumericT res = relative_residual(sys.A, x, sys.b);
+  NumericT res_ref = relative_residual(sys.A, x_ref, sys.b);
+  NumericT dev = viennacl::linalg::norm_2(diff) / viennacl::linalg::norm_2(x_ref);
+  std::cout << "  > " << name << ": residual " << res << ", deviation from temporary workspace " << dev << std::endl;
+  if (res > res_ref + epsilon || res_ref > NumericT(0.1) || dev > epsilon)
+  {
+    std::cout << "# Error: solution obtained with workspace is wrong" << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+template <typename WorkspaceT>
+int check_allocations(WorkspaceT const & workspace, std::size_t expected)
+{
+  std::cout << "  > allocations: " << workspace.allocations() << ", expected " << expected << std::endl;
+  if (workspace.allocations() != expected)
+  {
+    std::cout << "# Error: unexpected number of workspace allocations" << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+/** @brief Solves a sequence of systems with one workspace: Results must match the overloads with temporary workspaces, and the buffers must only be reallocated when the size changes */
+template <typename NumericT, typename TagT, typename PrecondT, typename WorkspaceT>
+int test_sequence(std::string const & name, test_system<NumericT> const & sys, test_system<NumericT> const & sys_other_size,
+                  TagT const & tag, PrecondT const & precond, PrecondT const & precond_other_size, WorkspaceT & workspace, NumericT epsilon)
+{
+  std::cout << "# Testing " << name << std::endl;
+
+  viennacl::vector<NumericT> x_ref = viennacl::linalg::solve(sys.A, sys.b, tag, precond);
+  viennacl::vector<NumericT> x_caller_owned(sys.b.size());
+  for (std::size_t i=0; i<3; ++i)
+  {
+    viennacl::vector<NumericT> x = viennacl::linalg::solve(sys.A, sys.b, tag, precond, workspace);
+    if (check_solution("returned result", sys, x, x_ref, epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+
+    viennacl::linalg::solve(sys.A, sys.b, tag, precond, workspace, x_caller_owned);
+    if (check_solution("caller-owned result", sys, x_caller_owned, x_ref, epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+  }
+  if (check_allocations(workspace, 1) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  // a different system size requires new buffers; an empty result vector is allocated by the solver:
+  viennacl::vector<NumericT> x_ref_other = viennacl::linalg::solve(sys_other_size.A, sys_other_size.b, tag, precond_other_size);
+  viennacl::vector<NumericT> x_empty;
+  viennacl::linalg::solve(sys_other_size.A, sys_other_size.b, tag, precond_other_size, workspace, x_empty);
+  if (check_solution("other size", sys_other_size, x_empty, x_ref_other, epsilon) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+  if (check_allocations(workspace, 2) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  // back to the original size:
+  viennacl::linalg::solve(sys.A, sys.b, tag, precond, workspace, x_caller_owned);
+  if (check_solution("original size", sys, x_caller_owned, x_ref, epsilon) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+  return check_allocations(workspace, 3);
+}
+
+template <typename NumericT>
+int test(NumericT epsilon)
+{
+  typedef viennacl::vector<NumericT>                  VectorType;
+  typedef viennacl::compressed_matrix<NumericT>       MatrixType;
+  typedef viennacl::linalg::jacobi_precond<MatrixType> JacobiType;
+
+  test_system<NumericT> spd(12, NumericT(0), 3);
+  test_system<NumericT> spd_other(9, NumericT(0), 5);
+  test_system<NumericT> nonsym(12, NumericT(0.3), 7);
+  test_system<NumericT> nonsym_other(9, NumericT(0.3), 11);
+
+  JacobiType jacobi(spd.A, viennacl::linalg::jacobi_tag());
+  JacobiType jacobi_other(spd_other.A, viennacl::linalg::jacobi_tag());
+  JacobiType jacobi_nonsym(nonsym.A, viennacl::linalg::jacobi_tag());
+  JacobiType jacobi_nonsym_other(nonsym_other.A, viennacl::linalg::jacobi_tag());
+  viennacl::linalg::no_precond none;
+
+  {
+    viennacl::linalg::cg_workspace<VectorType> workspace;
+    if (test_sequence("CG without preconditioner", spd, spd_other, viennacl::linalg::cg_tag(epsilon, 500), none, none, workspace, epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+  }
+  {
+    viennacl::linalg::cg_workspace<VectorType> workspace;
+    if (test_sequence("CG with Jacobi preconditioner", spd, spd_other, viennacl::linalg::cg_tag(epsilon, 500), jacobi, jacobi_other, workspace, epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+  }
+  {
+    viennacl::linalg::bicgstab_workspace<VectorType> workspace;
+    if (test_sequence("BiCGStab without preconditioner", nonsym, nonsym_other, viennacl::linalg::bicgstab_tag(epsilon, 500), none, none, workspace, epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+  }
+  {
+    viennacl::linalg::bicgstab_workspace<VectorType> workspace;
+    if (test_sequence("BiCGStab with Jacobi preconditioner", nonsym, nonsym_other, viennacl::linalg::bicgstab_tag(epsilon, 500), jacobi_nonsym, jacobi_nonsym_other, workspace, epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+  }
+  {
+    viennacl::linalg::gmres_workspace<VectorType> workspace;
+    if (test_sequence("GMRES without preconditioner", nonsym, nonsym_other, viennacl::linalg::gmres_tag(epsilon, 500, 20), none, none, workspace, epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+  }
+  {
+    viennacl::linalg::gmres_workspace<VectorType> workspace;
+    if (test_sequence("GMRES with Jacobi preconditioner", nonsym, nonsym_other, viennacl::linalg::gmres_tag(epsilon, 500, 20), jacobi_nonsym, jacobi_nonsym_other, workspace, epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+
+    // a different Krylov space dimension requires new buffers for the Householder reflectors:
+    std::cout << "# Testing GMRES with a different Krylov space dimension" << std::endl;
+    viennacl::linalg::gmres_tag tag(epsilon, 500, 10);
+    VectorType x_ref = viennacl::linalg::solve(nonsym.A, nonsym.b, tag, jacobi_nonsym);
+    VectorType x(nonsym.b.size());
+    viennacl::linalg::solve(nonsym.A, nonsym.b, tag, jacobi_nonsym, workspace, x);
+    if (check_solution("Krylov dimension 10", nonsym, x, x_ref, epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+    viennacl::linalg::solve(nonsym.A, nonsym.b, tag, jacobi_nonsym, workspace, x);
+    if (check_allocations(workspace, 4) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
+//
+// -------------------------------------------------------------
+//
+int main()
+{
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "## Test :: Reusable solver workspaces" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+  int retval = EXIT_SUCCESS;
+
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+  {
+    typedef float NumericT;
+    NumericT epsilon = static_cast<NumericT>(1E-4);
+    std::cout << "# Testing setup:" << std::endl;
+    std::cout << "  eps:     " << epsilon << std::endl;
+    std::cout << "  numeric: float" << std::endl;
+    retval = test<NumericT>(epsilon);
+    if( retval == EXIT_SUCCESS )
+      std::cout << "# Test passed" << std::endl;
+    else
+      return retval;
+  }
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+#ifdef VIENNACL_WITH_OPENCL
+  if( viennacl::ocl::current_device().double_support() )
+#endif
+  {
+    {
+      typedef double NumericT;
+      NumericT epsilon = 1.0E-8;
+      std::cout << "# Testing setup:" << std::endl;
+      std::cout << "  eps:     " << epsilon << std::endl;
+      std::cout << "  numeric: double" << std::endl;
+      retval = test<NumericT>(epsilon);
+      if( retval == EXIT_SUCCESS )
+        std::cout << "# Test passed" << std::endl;
+      else
+        return retval;
+    }
+    std::cout << std::endl;
+    std::cout << "----------------------------------------------" << std::endl;
+    std::cout << std::endl;
+  }
+#ifdef VIENNACL_WITH_OPENCL
+  else
+    std::cout << "No double precision support, skipping test..." << std::endl;
+#endif
+
+  std::cout << std::endl;
+  std::cout << "------- Test completed --------" << std::endl;
+  std::cout << std::endl;
+
+  return retval;
+}
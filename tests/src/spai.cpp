@@ -0,0 +1,320 @@
+/* =========================================================================
+   Copyright (c) 2010-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+//
+// Tests SPAI and FSPAI for uBLAS matrices and SPAI for a ViennaCL compressed_matrix, which uses the host setup unless the matrix resides in OpenCL memory.
+//
+
+//
+// *** System
+//
+#include <iostream>
+#include <vector>
+#include <map>
+#include <string>
+#include <cmath>
+#include <algorithm>
+#include <stdlib.h>
+
+//
+// *** Boost
+//
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/matrix_sparse.hpp>
+#include <boost/numeric/ublas/vector.hpp>
+#include <boost/numeric/ublas/operation_sparse.hpp>
+
+//
+// *** ViennaCL
+//
+#define VIENNACL_WITH_UBLAS 1
+#include "viennacl/linalg/cg.hpp"
+#include "viennacl/linalg/bicgstab.hpp"
+#include "viennacl/compressed_matrix.hpp"
+#include "viennacl/vector.hpp"
+#include "viennacl/linalg/spai.hpp"
+
+#include "sparse_test_problems.hpp"
+
+
+//
+// -------------------------------------------------------------
+//
+namespace ublas = boost::numeric::ublas;
+
+template <typename NumericT>
+void copy_to_ublas(std::vector< std::map<unsigned int, NumericT> > const & A_host, ublas::compressed_matrix<NumericT> & A)
+{
+  A = ublas::compressed_matrix<NumericT>(A_host.size(), A_host.size());
+  for (std::size_t i=0; i<A_host.size(); ++i)
+    for (typename std::map<unsigned int, NumericT>::const_iterator it = A_host[i].begin(); it != A_host[i].end(); ++it)
+      A(i, it->first) = it->second;
+}
+
+/** @brief Returns the preconditioner as a dense matrix by applying it to the unit vectors */
+template <typename NumericT, typename PrecondT>
+ublas::matrix<NumericT> dense_preconditioner(PrecondT const & precond, std::size_t n)
+{
+  ublas::matrix<NumericT> M(n, n);
+  for (std::size_t j=0; j<n; ++j)
+  {
+    ublas::vector<NumericT> e(n);
+    e.clear();
+    e[j] = NumericT(1);
+    precond.apply(e);
+    for (std::size_t i=0; i<n; ++i)
+      M(i, j) = e[i];
+  }
+  return M;
+}
+
+/** @brief Returns the number of iterations of BiCGStab, or zero if the residual is too large */
+template <typename NumericT, typename PrecondT>
+std::size_t bicgstab_iterations(ublas::compressed_matrix<NumericT> const & A, ublas::vector<NumericT> const & b, PrecondT const & precond, NumericT epsilon)
+{
+  viennacl::linalg::bicgstab_tag tag(epsilon, 1000);
+  ublas::vector<NumericT> x = viennacl::linalg::solve(A, b, tag, precond);
+  ublas::vector<NumericT> r = b - ublas::prod(A, x);
+  NumericT res = ublas::norm_2(r) / ublas::norm_2(b);
+  std::cout << "  > BiCGStab: " << tag.iters() << " iterations, residual " << res << std::endl;
+  return (res > 10 * epsilon) ? 0 : tag.iters();
+}
+
+/** @brief Checks the least-squares property of a SPAI matrix M: Each column (right) or row (left) of M minimizes ||A M - I||_F resp. ||M A - I||_F on its sparsity pattern.
+*
+* The residual is thus orthogonal to A (resp. A^T) on the pattern: (A^T (A M - I))_{ij} = 0 resp. ((M A - I) A^T)_{ij} = 0 for all nonzeros M_{ij}.
+* Returns ||A M - I||_F resp. ||M A - I||_F, or a negative value if the check fails.
+*/
+template <typename NumericT>
+NumericT check_least_squares(ublas::matrix<NumericT> const & A, ublas::matrix<NumericT> const & M, bool is_right, bool is_static, NumericT epsilon)
+{
+  std::size_t n = A.size1();
+  ublas::matrix<NumericT> R = is_right ? ublas::matrix<NumericT>(ublas::prod(A, M)) : ublas::matrix<NumericT>(ublas::prod(M, A));
+  for (std::size_t i=0; i<n; ++i)
+    R(i, i) -= NumericT(1);
+  ublas::matrix<NumericT> G = is_right ? ublas::matrix<NumericT>(ublas::prod(ublas::trans(A), R)) : ublas::matrix<NumericT>(ublas::prod(R, ublas::trans(A)));
+
+  NumericT norm_A = ublas::norm_frobenius(A);
+  NumericT max_gradient = 0;
+  std::size_t nnz = 0;
+  for (std::size_t i=0; i<n; ++i)
+    for (std::size_t j=0; j<n; ++j)
+    {
+      if (M(i, j) == 0)
+        continue;
+      ++nnz;
+      max_gradient = std::max(max_gradient, std::fabs(G(i, j)));
+      if (is_static && A(i, j) == 0 && A(j, i) == 0)
+      {
+        std::cout << "# Error: entry (" << i << ", " << j << ") of static SPAI is outside the pattern of A" << std::endl;
+        return NumericT(-1);
+      }
+    }
+
+  NumericT residual = ublas::norm_frobenius(R);
+  std::cout << "  > nonzeros: " << nnz << ", residual norm: " << residual << ", largest gradient entry: " << max_gradient << std::endl;
+  if (max_gradient > epsilon * norm_A)
+  {
+    std::cout << "# Error: SPAI entries do not solve the least-squares problems" << std::endl;
+    return NumericT(-1);
+  }
+  return residual;
+}
+
+template <typename NumericT>
+int test(NumericT epsilon)
+{
+  typedef ublas::compressed_matrix<NumericT>    MatrixType;
+
+  //
+  // SPAI for a nonsymmetric matrix, left and right, static and dynamic pattern
+  //
+  {
+    std::size_t N = 10;
+    std::size_t n = N * N;
+    std::vector< std::map<unsigned int, NumericT> > A_host;
+    convection_diffusion_2d(N, NumericT(0.4), NumericT(0.1), A_host);
+    MatrixType A;
+    copy_to_ublas(A_host, A);
+    ublas::matrix<NumericT> A_dense(A);
+
+    std::vector<NumericT> b_host(n);
+    fill_reproducible(b_host, 83, NumericT(1));
+    ublas::vector<NumericT> b(n);
+    std::copy(b_host.begin(), b_host.end(), b.begin());
+
+    std::size_t iters_unpreconditioned = bicgstab_iterations(A, b, viennacl::linalg::no_precond(), epsilon);
+    if (iters_unpreconditioned == 0)
+      return EXIT_FAILURE;
+
+    for (int is_right = 0; is_right < 2; ++is_right)
+    {
+      NumericT residual_static = 0;
+      for (int is_static = 1; is_static >= 0; --is_static)
+      {
+        std::cout << "# Testing " << (is_static ? "static" : "dynamic") << " SPAI, " << (is_right ? "right" : "left") << " preconditioner" << std::endl;
+        viennacl::linalg::spai_tag tag(1e-3, 3, 5e-2, is_static == 1, is_right == 1);
+        viennacl::linalg::spai_precond<MatrixType> precond(A, tag);
+
+        NumericT residual = check_least_squares(A_dense, dense_preconditioner<NumericT>(precond, n), is_right == 1, is_static == 1, epsilon);
+        if (residual < 0)
+          return EXIT_FAILURE;
+        if (is_static)
+          residual_static = residual;
+        else if (residual > residual_static * (1 + epsilon))
+        {
+          std::cout << "# Error: pattern update increased the residual norm" << std::endl;
+          return EXIT_FAILURE;
+        }
+
+        std::size_t iters = bicgstab_iterations(A, b, precond, epsilon);
+        if (iters == 0 || iters >= iters_unpreconditioned)
+        {
+          std::cout << "# Error: SPAI did not reduce the number of iterations" << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+
+    std::cout << "# Testing static SPAI for a ViennaCL compressed_matrix" << std::endl;
+    viennacl::linalg::spai_tag tag(1e-3, 3, 5e-2, true, true);
+    viennacl::linalg::spai_precond<MatrixType> precond_ublas(A, tag);
+
+    viennacl::compressed_matrix<NumericT> vcl_A(n, n);
+    viennacl::copy(A, vcl_A);
+    viennacl::linalg::spai_precond< viennacl::compressed_matrix<NumericT> > precond_vcl(vcl_A, tag);
+
+    ublas::vector<NumericT> v = b;
+    viennacl::vector<NumericT> vcl_v(n);
+    viennacl::copy(v, vcl_v);
+    precond_ublas.apply(v);
+    precond_vcl.apply(vcl_v);
+
+    ublas::vector<NumericT> v_from_vcl(n);
+    viennacl::copy(vcl_v, v_from_vcl);
+    NumericT diff = ublas::norm_2(v - v_from_vcl) / ublas::norm_2(v);
+    std::cout << "  > relative difference to the uBLAS preconditioner: " << diff << std::endl;
+    if (diff > 10 * epsilon)
+    {
+      std::cout << "# Error: SPAI for compressed_matrix differs from the uBLAS version" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  //
+  // FSPAI for a symmetric positive definite matrix: M = L L^T is symmetric and accelerates CG
+  //
+  std::cout << "# Testing FSPAI" << std::endl;
+  {
+    std::size_t N = 12;
+    std::size_t n = N * N;
+    std::vector< std::map<unsigned int, NumericT> > A_host;
+    variable_diffusion_2d(N, NumericT(1.5), A_host);
+    MatrixType A;
+    copy_to_ublas(A_host, A);
+
+    std::vector<NumericT> b_host(n);
+    fill_reproducible(b_host, 89, NumericT(1));
+    ublas::vector<NumericT> b(n);
+    std::copy(b_host.begin(), b_host.end(), b.begin());
+
+    viennacl::linalg::fspai_tag tag;
+    viennacl::linalg::fspai_precond<MatrixType> precond(A, tag);
+
+    ublas::matrix<NumericT> M = dense_preconditioner<NumericT>(precond, n);
+    NumericT asymmetry = ublas::norm_frobenius(M - ublas::trans(M)) / ublas::norm_frobenius(M);
+    std::cout << "  > relative asymmetry of L L^T: " << asymmetry << std::endl;
+    if (asymmetry > epsilon)
+    {
+      std::cout << "# Error: FSPAI preconditioner is not symmetric" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    viennacl::linalg::cg_tag tag_plain(epsilon, 1000);
+    ublas::vector<NumericT> x_plain = viennacl::linalg::solve(A, b, tag_plain);
+
+    viennacl::linalg::cg_tag tag_cg(epsilon, 1000);
+    ublas::vector<NumericT> x = viennacl::linalg::solve(A, b, tag_cg, precond);
+    ublas::vector<NumericT> r = b - ublas::prod(A, x);
+    NumericT res = ublas::norm_2(r) / ublas::norm_2(b);
+    std::cout << "  > CG: " << tag_plain.iters() << " iterations, with FSPAI: " << tag_cg.iters() << " iterations, residual " << res << std::endl;
+    if (res > 10 * epsilon || tag_cg.iters() >= tag_plain.iters())
+    {
+      std::cout << "# Error: FSPAI-preconditioned CG failed" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
+//
+// -------------------------------------------------------------
+//
+int main()
+{
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "## Test :: SPAI and FSPAI preconditioners" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+  int retval = EXIT_SUCCESS;
+
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+  {
+    typedef float NumericT;
+    NumericT epsilon = static_cast<NumericT>(1E-4);
+    std::cout << "# Testing setup:" << std::endl;
+    std::cout << "  eps:     " << epsilon << std::endl;
+    std::cout << "  numeric: float" << std::endl;
+    retval = test<NumericT>(epsilon);
+    if( retval == EXIT_SUCCESS )
+      std::cout << "# Test passed" << std::endl;
+    else
+      return retval;
+  }
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+  {
+    typedef double NumericT;
+    NumericT epsilon = 1.0E-8;
+    std::cout << "# Testing setup:" << std::endl;
+    std::cout << "  eps:     " << epsilon << std::endl;
+    std::cout << "  numeric: double" << std::endl;
+    retval = test<NumericT>(epsilon);
+    if( retval == EXIT_SUCCESS )
+      std::cout << "# Test passed" << std::endl;
+    else
+      return retval;
+  }
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+  std::cout << std::endl;
+  std::cout << "------- Test completed --------" << std::endl;
+  std::cout << std::endl;
+
+  return retval;
+}
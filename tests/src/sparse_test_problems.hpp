@@ -0,0 +1,103 @@
+/* =========================================================================
+   Copyright (c) 2010-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+#ifndef _SPARSE_TEST_PROBLEMS_HPP_
+#define _SPARSE_TEST_PROBLEMS_HPP_
+
+//
+// Reproducible model problems for the tests of the iterative solvers, preconditioners and eigensolvers
+//
+
+#include <vector>
+#include <map>
+#include <cmath>
+
+#include "viennacl/vector.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/norm_2.hpp"
+
+/** @brief Five-point finite difference stencil of -Laplace(u) + conv * (u_x + u_y) + shift * u on an N x N grid (unit mesh size).
+*
+* conv = 0 yields the symmetric positive definite Laplace matrix, a negative shift below the smallest eigenvalue an indefinite matrix.
+*/
+template <typename NumericT>
+void convection_diffusion_2d(std::size_t N, NumericT conv, NumericT shift, std::vector< std::map<unsigned int, NumericT> > & A)
+{
+  A.clear();
+  A.resize(N * N);
+  for (std::size_t i=0; i<N; ++i)
+    for (std::size_t j=0; j<N; ++j)
+    {
+      unsigned int row = static_cast<unsigned int>(i * N + j);
+      A[row][row] = NumericT(4) + shift;
+      if (i > 0)   A[row][static_cast<unsigned int>(row - N)] = NumericT(-1) - conv;
+      if (i+1 < N) A[row][static_cast<unsigned int>(row + N)] = NumericT(-1) + conv;
+      if (j > 0)   A[row][row - 1] = NumericT(-1) - conv;
+      if (j+1 < N) A[row][row + 1] = NumericT(-1) + conv;
+    }
+}
+
+/** @brief Five-point stencil of -div(k grad u) on an N x N grid with a smoothly varying coefficient k between exp(-contrast) and exp(contrast). Symmetric positive definite. */
+template <typename NumericT>
+void variable_diffusion_2d(std::size_t N, NumericT contrast, std::vector< std::map<unsigned int, NumericT> > & A)
+{
+  A.clear();
+  A.resize(N * N);
+  for (std::size_t i=0; i<N; ++i)
+    for (std::size_t j=0; j<N; ++j)
+    {
+      unsigned int row = static_cast<unsigned int>(i * N + j);
+      NumericT k_row = std::exp(contrast * std::sin(NumericT(6) * NumericT(i) / NumericT(N)) * std::cos(NumericT(5) * NumericT(j) / NumericT(N)));
+      NumericT diag = 0;
+      for (int neighbor = 0; neighbor < 4; ++neighbor)
+      {
+        std::size_t ni = i, nj = j;
+        if      (neighbor == 0) { if (i == 0)   continue; ni = i - 1; }
+        else if (neighbor == 1) { if (i+1 == N) continue; ni = i + 1; }
+        else if (neighbor == 2) { if (j == 0)   continue; nj = j - 1; }
+        else                    { if (j+1 == N) continue; nj = j + 1; }
+        NumericT k_col = std::exp(contrast * std::sin(NumericT(6) * NumericT(ni) / NumericT(N)) * std::cos(NumericT(5) * NumericT(nj) / NumericT(N)));
+        NumericT k_face = (k_row + k_col) / NumericT(2);
+        A[row][static_cast<unsigned int>(ni * N + nj)] = -k_face;
+        diag += k_face;
+      }
+      A[row][row] = diag + NumericT(1e-2) * k_row;  //boundary condition of Robin type keeps the matrix nonsingular
+    }
+}
+
+/** @brief Fills a vector with reproducible pseudo-random entries in [-0.5, 0.5) plus 'offset' */
+template <typename NumericT>
+void fill_reproducible(std::vector<NumericT> & values, unsigned long seed, NumericT offset = 0)
+{
+  unsigned long state = seed;
+  for (std::size_t i=0; i<values.size(); ++i)
+  {
+    state = (1103515245ul * state + 12345ul) % 2147483648ul;
+    values[i] = NumericT(state) / NumericT(2147483648.0) - NumericT(0.5) + offset;
+  }
+}
+
+/** @brief Returns ||b - A x|| / ||b|| */
+template <typename MatrixT, typename NumericT>
+NumericT relative_residual(MatrixT const & A, viennacl::vector<NumericT> const & x, viennacl::vector<NumericT> const & b)
+{
+  viennacl::vector<NumericT> r = viennacl::linalg::prod(A, x);
+  r -= b;
+  return viennacl::linalg::norm_2(r) / viennacl::linalg::norm_2(b);
+}
+
+#endif
@@ -0,0 +1,198 @@
+/* =========================================================================
+   Copyright (c) 2010-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+//
+// *** System
+//
+#include <iostream>
+#include <vector>
+#include <map>
+#include <cmath>
+#include <stdlib.h>
+
+//
+// *** ViennaCL
+//
+#include "viennacl/matrix.hpp"
+#include "viennacl/vector.hpp"
+#include "viennacl/compressed_matrix.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/norm_2.hpp"
+#include "viennacl/linalg/jacobi_precond.hpp"
+#include "viennacl/linalg/gmres.hpp"
+#include "viennacl/linalg/sstep_gmres.hpp"
+
+#include "sparse_test_problems.hpp"
+
+
+//
+// -------------------------------------------------------------
+//
+template <typename NumericT, typename MatrixT, typename PrecondT>
+int run_solver(MatrixT const & A, viennacl::vector<NumericT> const & b, PrecondT const & precond, unsigned int step_size,
+               unsigned int gmres_iters, NumericT epsilon)
+{
+  viennacl::linalg::sstep_gmres_tag tag(epsilon, 1000, 20, step_size);
+  viennacl::vector<NumericT> x = viennacl::linalg::solve(A, b, tag, precond);
+
+  NumericT res = relative_residual(A, x, b);
+  std::cout << "  > step size " << step_size << ": " << tag.iters() << " iterations (GMRES: " << gmres_iters << "), residual " << res << std::endl;
+  if (res > 10 * epsilon)
+  {
+    std::cout << "# Error: residual too large" << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (2 * tag.iters() > 3 * gmres_iters)
+  {
+    std::cout << "# Error: s-step GMRES needs significantly more iterations than GMRES" << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+template <typename NumericT, typename MatrixT, typename PrecondT>
+int test_precond(MatrixT const & A, viennacl::vector<NumericT> const & b, PrecondT const & precond, NumericT epsilon)
+{
+  viennacl::linalg::gmres_tag gmres_tag(epsilon, 1000, 20);
+  viennacl::linalg::solve(A, b, gmres_tag, precond);
+
+  // step size 1 (standard Arnoldi), a divisor and a non-divisor of the Krylov space dimension:
+  if (run_solver(A, b, precond, 1, gmres_tag.iters(), epsilon) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+  if (run_solver(A, b, precond, 4, gmres_tag.iters(), epsilon) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+  if (run_solver(A, b, precond, 6, gmres_tag.iters(), epsilon) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+  return EXIT_SUCCESS;
+}
+
+template <typename NumericT>
+int test(NumericT epsilon)
+{
+  std::size_t N = 20;
+  std::size_t n = N * N;
+
+  std::vector< std::map<unsigned int, NumericT> > A_host;
+  convection_diffusion_2d(N, NumericT(0.3), NumericT(0.1), A_host);
+  viennacl::compressed_matrix<NumericT> A(n, n);
+  viennacl::copy(A_host, A);
+
+  std::vector<NumericT> b_host(n);
+  fill_reproducible(b_host, 3, NumericT(1));
+  viennacl::vector<NumericT> b(n);
+  viennacl::copy(b_host, b);
+
+  std::cout << "# Testing s-step GMRES without preconditioner" << std::endl;
+  if (test_precond(A, b, viennacl::linalg::no_precond(), epsilon) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  std::cout << "# Testing s-step GMRES with Jacobi preconditioner" << std::endl;
+  viennacl::linalg::jacobi_precond< viennacl::compressed_matrix<NumericT> > precond(A, viennacl::linalg::jacobi_tag());
+  if (test_precond(A, b, precond, epsilon) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  std::cout << "# Testing system smaller than the Krylov space" << std::endl;
+  {
+    std::vector< std::map<unsigned int, NumericT> > A_small_host;
+    convection_diffusion_2d(3, NumericT(0.3), NumericT(0), A_small_host);
+    viennacl::compressed_matrix<NumericT> A_small(9, 9);
+    viennacl::copy(A_small_host, A_small);
+    viennacl::vector<NumericT> b_small(9);
+    std::vector<NumericT> b_small_host(9);
+    fill_reproducible(b_small_host, 5);
+    viennacl::copy(b_small_host, b_small);
+
+    viennacl::linalg::sstep_gmres_tag tag(epsilon, 100, 20, 4);
+    viennacl::vector<NumericT> x = viennacl::linalg::solve(A_small, b_small, tag);
+    NumericT res = relative_residual(A_small, x, b_small);
+    std::cout << "  > " << tag.iters() << " iterations, residual " << res << std::endl;
+    if (res > 10 * epsilon)
+    {
+      std::cout << "# Error: residual too large" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
+//
+// -------------------------------------------------------------
+//
+int main()
+{
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "## Test :: s-step GMRES solver" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+  int retval = EXIT_SUCCESS;
+
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+  {
+    typedef float NumericT;
+    NumericT epsilon = static_cast<NumericT>(1E-4);
+    std::cout << "# Testing setup:" << std::endl;
+    std::cout << "  eps:     " << epsilon << std::endl;
+    std::cout << "  numeric: float" << std::endl;
+    retval = test<NumericT>(epsilon);
+    if( retval == EXIT_SUCCESS )
+        std::cout << "# Test passed" << std::endl;
+    else
+        return retval;
+  }
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+#ifdef VIENNACL_WITH_OPENCL
+  if( viennacl::ocl::current_device().double_support() )
+#endif
+  {
+    {
+      typedef double NumericT;
+      NumericT epsilon = 1.0E-8;
+      std::cout << "# Testing setup:" << std::endl;
+      std::cout << "  eps:     " << epsilon << std::endl;
+      std::cout << "  numeric: double" << std::endl;
+      retval = test<NumericT>(epsilon);
+      if( retval == EXIT_SUCCESS )
+        std::cout << "# Test passed" << std::endl;
+      else
+        return retval;
+    }
+    std::cout << std::endl;
+    std::cout << "----------------------------------------------" << std::endl;
+    std::cout << std::endl;
+  }
+#ifdef VIENNACL_WITH_OPENCL
+  else
+    std::cout << "No double precision support, skipping test..." << std::endl;
+#endif
+
+  std::cout << std::endl;
+  std::cout << "------- Test completed --------" << std::endl;
+  std::cout << std::endl;
+
+  return retval;
+}
@@ -239,11 +239,13 @@ int test(ScalarType epsilon)
     test_svd<ScalarType>(std::string("../examples/testdata/svd/pysvd.example"), epsilon);
     test_svd<ScalarType>(std::string("../examples/testdata/svd/random.example"), epsilon);
 
+#ifdef VIENNACL_WITH_OPENCL  //timings of large matrices take several minutes with the host backend, hence only for the compute devices
     time_svd<ScalarType>(500, 500);
     time_svd<ScalarType>(1000, 1000);
     time_svd<ScalarType>(4096, 512);
     time_svd<ScalarType>(2048, 2048);
     //time_svd(4096, 4096);  //takes too long for a standard sanity test. Feel free to uncomment
+#endif
 
     return EXIT_SUCCESS;
 }
@@ -281,7 +283,9 @@ int main()
    std::cout << std::endl;
    std::cout << "----------------------------------------------" << std::endl;
    std::cout << std::endl;
+#ifdef VIENNACL_WITH_OPENCL
    if( viennacl::ocl::current_device().double_support() )
+#endif
    {
       {
         typedef double NumericT;
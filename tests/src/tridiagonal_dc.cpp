@@ -0,0 +1,304 @@
+/* =========================================================================
+   Copyright (c) 2010-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+//
+// *** System
+//
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <algorithm>
+#include <stdlib.h>
+
+//
+// *** Boost
+//
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/vector.hpp>
+
+//
+// *** ViennaCL
+//
+#define VIENNACL_WITH_UBLAS 1
+#include "viennacl/matrix.hpp"
+#include "viennacl/linalg/qr.hpp"
+#include "viennacl/linalg/tridiagonal_dc.hpp"
+
+#include "sparse_test_problems.hpp"
+
+
+//
+// -------------------------------------------------------------
+//
+namespace ublas = boost::numeric::ublas;
+
+/** @brief Solves the tridiagonal eigenproblem with Q = Q0 on entry and checks (Q0 T Q0^T) Q = Q diag(D), Q^T Q = I, the order of the eigenvalues and, if supplied, the reference eigenvalues */
+template <typename NumericT, typename F>
+int check_dc(std::string const & name, ublas::vector<NumericT> const & d, ublas::vector<NumericT> const & e,
+             ublas::matrix<NumericT> const & Q0, std::vector<double> const & reference, NumericT epsilon)
+{
+  std::size_t n = d.size();
+
+  // dense A = Q0 T Q0^T
+  ublas::matrix<NumericT> T(n, n);
+  T.clear();
+  for (std::size_t i=0; i<n; ++i)
+  {
+    T(i, i) = d(i);
+    if (i > 0)
+      T(i, i-1) = T(i-1, i) = e(i);
+  }
+  ublas::matrix<NumericT> TQ0t = ublas::prod(T, ublas::trans(Q0));
+  ublas::matrix<NumericT> A = ublas::prod(Q0, TQ0t);
+
+  viennacl::matrix<NumericT, F> Q(n, n);
+  viennacl::copy(Q0, Q);
+  ublas::vector<NumericT> D = d;
+  viennacl::linalg::tridiagonal_dc(D, e, Q);
+
+  ublas::matrix<NumericT> Z(n, n);
+  viennacl::copy(Q, Z);
+
+  NumericT norm_A = std::max(NumericT(ublas::norm_frobenius(A)), NumericT(1));
+  ublas::matrix<NumericT> AZ = ublas::prod(A, Z);
+  NumericT err_eigen = 0;
+  for (std::size_t i=0; i<n; ++i)
+    for (std::size_t j=0; j<n; ++j)
+      err_eigen = std::max(err_eigen, std::fabs(AZ(i, j) - Z(i, j) * D(j)));
+  err_eigen /= norm_A;
+
+  ublas::matrix<NumericT> ZtZ = ublas::prod(ublas::trans(Z), Z);
+  NumericT err_orth = 0;
+  for (std::size_t i=0; i<n; ++i)
+    for (std::size_t j=0; j<n; ++j)
+      err_orth = std::max(err_orth, std::fabs(ZtZ(i, j) - NumericT(i == j)));
+
+  bool ascending = true;
+  for (std::size_t i=1; i<n; ++i)
+    if (D(i) < D(i-1))
+      ascending = false;
+
+  double err_ref = 0;
+  for (std::size_t i=0; i<reference.size(); ++i)
+    err_ref = std::max(err_ref, std::fabs(reference[i] - double(D(i))));
+  err_ref /= double(norm_A);
+
+  std::cout << "  > " << name << ", n = " << n << ": |A Z - Z D| = " << err_eigen << ", |Z^T Z - I| = " << err_orth;
+  if (reference.size() > 0)
+    std::cout << ", eigenvalue error " << err_ref;
+  std::cout << std::endl;
+  if (err_eigen > epsilon || err_orth > epsilon || !ascending || err_ref > epsilon)
+  {
+    std::cout << "# Error: divide-and-conquer eigensolver failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+template <typename NumericT, typename F>
+int check_dc(std::string const & name, ublas::vector<NumericT> const & d, ublas::vector<NumericT> const & e,
+             std::vector<double> const & reference, NumericT epsilon)
+{
+  ublas::matrix<NumericT> I = ublas::identity_matrix<NumericT>(d.size());
+  return check_dc<NumericT, F>(name, d, e, I, reference, epsilon);
+}
+
+template <typename NumericT>
+void random_tridiagonal(std::size_t n, unsigned long seed, ublas::vector<NumericT> & d, ublas::vector<NumericT> & e)
+{
+  std::vector<NumericT> values(2 * n);
+  fill_reproducible(values, seed);
+  d.resize(n);
+  e.resize(n);
+  for (std::size_t i=0; i<n; ++i)
+  {
+    d(i) = values[i];
+    e(i) = (i > 0) ? values[n + i] : NumericT(0);
+  }
+}
+
+template <typename NumericT, typename F>
+int test(NumericT epsilon)
+{
+  std::vector<double> no_reference;
+  ublas::vector<NumericT> d, e;
+
+  std::cout << "# Testing 1D Laplace matrix against the exact eigenvalues" << std::endl;
+  std::size_t laplace_sizes[] = { 33, 257 };
+  for (std::size_t k=0; k<2; ++k)
+  {
+    std::size_t n = laplace_sizes[k];
+    d = ublas::scalar_vector<NumericT>(n, NumericT(2));
+    e = ublas::scalar_vector<NumericT>(n, NumericT(-1));
+    std::vector<double> reference(n);
+    for (std::size_t i=0; i<n; ++i)
+      reference[i] = 2.0 - 2.0 * std::cos(double(i + 1) * 3.14159265358979323846 / double(n + 1));
+    if (check_dc<NumericT, F>("Laplace", d, e, reference, epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+  }
+
+  std::cout << "# Testing random tridiagonal matrices" << std::endl;
+  {
+    std::size_t sizes[] = { 1, 2, 31, 33, 70, 150 };
+    for (std::size_t k=0; k<6; ++k)
+    {
+      random_tridiagonal(sizes[k], 191 + k, d, e);
+      if (check_dc<NumericT, F>("random", d, e, no_reference, epsilon) != EXIT_SUCCESS)
+        return EXIT_FAILURE;
+    }
+  }
+
+  // Wilkinson matrix W_{2m+1}^+: pairs of eigenvalues agreeing to many digits (deflation of close eigenvalues)
+  std::cout << "# Testing Wilkinson matrix" << std::endl;
+  {
+    std::size_t m = 30;
+    std::size_t n = 2 * m + 1;
+    d.resize(n);
+    e = ublas::scalar_vector<NumericT>(n, NumericT(1));
+    for (std::size_t i=0; i<n; ++i)
+      d(i) = NumericT(i > m ? i - m : m - i);
+    if (check_dc<NumericT, F>("Wilkinson", d, e, no_reference, epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+  }
+
+  // Zero off-diagonal entries split the matrix. Without any coupling, the eigenvalues are the sorted diagonal with many multiple eigenvalues.
+  std::cout << "# Testing split and diagonal matrices" << std::endl;
+  {
+    std::size_t n = 90;
+    random_tridiagonal(n, 197, d, e);
+    e(17) = 0;
+    e(45) = 0;
+    e(46) = 0;
+    if (check_dc<NumericT, F>("split", d, e, no_reference, epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+
+    e = ublas::zero_vector<NumericT>(n);
+    std::vector<double> reference(n);
+    for (std::size_t i=0; i<n; ++i)
+    {
+      d(i) = NumericT((i * 7) % 5);
+      reference[i] = double(d(i));
+    }
+    std::sort(reference.begin(), reference.end());
+    if (check_dc<NumericT, F>("diagonal", d, e, reference, epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+  }
+
+  // On entry, Q holds the orthogonal transformation of a tridiagonal reduction, which is multiplied by the eigenvectors of T:
+  std::cout << "# Testing accumulation into an orthogonal matrix" << std::endl;
+  {
+    std::size_t n = 60;
+    std::vector<NumericT> values(n * n);
+    fill_reproducible(values, 199);
+    ublas::matrix<NumericT> B(n, n);
+    for (std::size_t i=0; i<n; ++i)
+      for (std::size_t j=0; j<n; ++j)
+        B(i, j) = values[i * n + j];
+    std::vector<NumericT> betas = viennacl::linalg::inplace_qr(B);
+    ublas::matrix<NumericT> Q0(n, n), R(n, n);
+    viennacl::linalg::recoverQ(B, betas, Q0, R);
+
+    random_tridiagonal(n, 211, d, e);
+    if (check_dc<NumericT, F>("Q0 T Q0^T", d, e, Q0, no_reference, epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
+//
+// -------------------------------------------------------------
+//
+int main()
+{
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "## Test :: Divide-and-conquer tridiagonal eigensolver" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+  int retval = EXIT_SUCCESS;
+
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+  {
+    typedef float NumericT;
+    NumericT epsilon = static_cast<NumericT>(1E-4);
+    std::cout << "# Testing setup:" << std::endl;
+    std::cout << "  eps:     " << epsilon << std::endl;
+    std::cout << "  numeric: float, row-major eigenvectors" << std::endl;
+    retval = test<NumericT, viennacl::row_major>(epsilon);
+    if( retval == EXIT_SUCCESS )
+      std::cout << "# Test passed" << std::endl;
+    else
+      return retval;
+  }
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+#ifdef VIENNACL_WITH_OPENCL
+  if( viennacl::ocl::current_device().double_support() )
+#endif
+  {
+    {
+      typedef double NumericT;
+      NumericT epsilon = 1.0E-8;
+      std::cout << "# Testing setup:" << std::endl;
+      std::cout << "  eps:     " << epsilon << std::endl;
+      std::cout << "  numeric: double, row-major eigenvectors" << std::endl;
+      retval = test<NumericT, viennacl::row_major>(epsilon);
+      if( retval == EXIT_SUCCESS )
+        std::cout << "# Test passed" << std::endl;
+      else
+        return retval;
+    }
+    std::cout << std::endl;
+    std::cout << "----------------------------------------------" << std::endl;
+    std::cout << std::endl;
+    {
+      typedef double NumericT;
+      NumericT epsilon = 1.0E-8;
+      std::cout << "# Testing setup:" << std::endl;
+      std::cout << "  eps:     " << epsilon << std::endl;
+      std::cout << "  numeric: double, column-major eigenvectors" << std::endl;
+      retval = test<NumericT, viennacl::column_major>(epsilon);
+      if( retval == EXIT_SUCCESS )
+        std::cout << "# Test passed" << std::endl;
+      else
+        return retval;
+    }
+    std::cout << std::endl;
+    std::cout << "----------------------------------------------" << std::endl;
+    std::cout << std::endl;
+  }
+#ifdef VIENNACL_WITH_OPENCL
+  else
+    std::cout << "No double precision support, skipping test..." << std::endl;
+#endif
+
+  std::cout << std::endl;
+  std::cout << "------- Test completed --------" << std::endl;
+  std::cout << std::endl;
+
+  return retval;
+}
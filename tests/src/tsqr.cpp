@@ -0,0 +1,337 @@
+/* =========================================================================
+   Copyright (c) 2010-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+//
+// *** System
+//
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <stdlib.h>
+
+//
+// *** Boost
+//
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/vector.hpp>
+
+//
+// *** ViennaCL
+//
+#define VIENNACL_WITH_UBLAS 1
+#include "viennacl/matrix.hpp"
+#include "viennacl/linalg/qr.hpp"
+#include "viennacl/linalg/tsqr.hpp"
+
+#include "sparse_test_problems.hpp"
+
+
+//
+// -------------------------------------------------------------
+//
+namespace ublas = boost::numeric::ublas;
+
+template <typename NumericT>
+ublas::matrix<NumericT> random_matrix(std::size_t rows, std::size_t cols, unsigned long seed)
+{
+  std::vector<NumericT> values(rows * cols);
+  fill_reproducible(values, seed);
+  ublas::matrix<NumericT> A(rows, cols);
+  for (std::size_t i=0; i<rows; ++i)
+    for (std::size_t j=0; j<cols; ++j)
+      A(i, j) = values[i * cols + j];
+  return A;
+}
+
+template <typename NumericT>
+NumericT relative_difference(ublas::matrix<NumericT> const & A, ublas::matrix<NumericT> const & B)
+{
+  NumericT norm_B = ublas::norm_frobenius(B);
+  return ublas::norm_frobenius(A - B) / (norm_B > 0 ? norm_B : NumericT(1));
+}
+
+/** @brief Returns the largest difference of the absolute values of two upper triangular factors (the diagonal signs of R are not unique) */
+template <typename NumericT>
+NumericT R_difference(ublas::matrix<NumericT> const & R1, ublas::matrix<NumericT> const & R2)
+{
+  NumericT diff = 0;
+  for (std::size_t i=0; i<std::min(R1.size1(), R1.size2()); ++i)
+    for (std::size_t j=i; j<R1.size2(); ++j)
+      diff = std::max(diff, std::fabs(std::fabs(R1(i, j)) - std::fabs(R2(i, j))));
+  return diff / ublas::norm_frobenius(R2);
+}
+
+/** @brief Checks TSQR with explicit Q and R-only TSQR against the factors of the blocked Householder QR */
+template <typename NumericT>
+int check_tsqr(ublas::matrix<NumericT> const & A, std::size_t num_blocks, NumericT epsilon)
+{
+  std::size_t m = A.size1();
+  std::size_t n = A.size2();
+
+  ublas::matrix<NumericT> A_ref = A;
+  std::vector<NumericT> betas_ref = viennacl::linalg::inplace_qr(A_ref);
+  ublas::matrix<NumericT> Q_ref(m, m), R_ref(m, n);
+  viennacl::linalg::recoverQ(A_ref, betas_ref, Q_ref, R_ref);
+  ublas::matrix<NumericT> R_ref_square = ublas::subrange(R_ref, 0, n, 0, n);
+
+  ublas::matrix<NumericT> Q(m, n), R(n, n);
+  viennacl::linalg::tsqr(A, Q, R, num_blocks, 4);
+
+  NumericT err_QR = relative_difference(ublas::matrix<NumericT>(ublas::prod(Q, R)), A);
+  ublas::matrix<NumericT> QtQ = ublas::prod(ublas::trans(Q), Q);
+  ublas::identity_matrix<NumericT> I(n);
+  NumericT err_orth = ublas::norm_frobenius(QtQ - I) / std::sqrt(NumericT(n));
+  NumericT lower_part = 0;
+  for (std::size_t i=0; i<n; ++i)
+    for (std::size_t j=0; j<i; ++j)
+      lower_part = std::max(lower_part, std::fabs(R(i, j)));
+  NumericT err_R = R_difference(R, R_ref_square);
+
+  ublas::matrix<NumericT> R_only(n, n);
+  viennacl::linalg::tsqr(A, R_only, num_blocks, 4);
+  NumericT err_R_only = relative_difference(R_only, R);
+
+  std::cout << "  > " << m << " x " << n << ", " << num_blocks << " blocks: |QR - A| = " << err_QR << ", |Q^T Q - I| = " << err_orth
+            << ", |R - R_ref| = " << err_R << std::endl;
+  if (err_QR > epsilon || err_orth > epsilon || lower_part > 0 || err_R > epsilon || err_R_only > 0)
+  {
+    std::cout << "# Error: TSQR factors are wrong" << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+/** @brief Checks that the output of inplace_tsqr() can be used with recoverQ() and inplace_qr_apply_trans_Q() */
+template <typename NumericT>
+int check_inplace_tsqr(ublas::matrix<NumericT> const & A_orig, std::size_t num_blocks, NumericT epsilon)
+{
+  std::size_t m = A_orig.size1();
+  std::size_t n = A_orig.size2();
+
+  ublas::matrix<NumericT> A = A_orig;
+  std::vector<NumericT> betas = viennacl::linalg::inplace_tsqr(A, num_blocks, 4);
+
+  ublas::matrix<NumericT> Q(m, m), R(m, n);
+  viennacl::linalg::recoverQ(A, betas, Q, R);
+  NumericT err_QR = relative_difference(ublas::matrix<NumericT>(ublas::prod(Q, R)), A_orig);
+  ublas::matrix<NumericT> QtQ = ublas::prod(ublas::trans(Q), Q);
+  ublas::identity_matrix<NumericT> I(m);
+  NumericT err_orth = ublas::norm_frobenius(QtQ - I) / std::sqrt(NumericT(m));
+
+  std::vector<NumericT> b_values(m);
+  fill_reproducible(b_values, 131);
+  ublas::vector<NumericT> b(m);
+  std::copy(b_values.begin(), b_values.end(), b.begin());
+  ublas::vector<NumericT> Qtb_ref = ublas::prod(ublas::trans(Q), b);
+  viennacl::linalg::inplace_qr_apply_trans_Q(A, betas, b);
+  NumericT err_Qtb = ublas::norm_2(b - Qtb_ref) / ublas::norm_2(Qtb_ref);
+
+  std::cout << "  > inplace, " << num_blocks << " blocks: |QR - A| = " << err_QR << ", |Q^T Q - I| = " << err_orth << ", |Q^T b - ref| = " << err_Qtb << std::endl;
+  if (betas.size() != n || err_QR > epsilon || err_orth > epsilon || err_Qtb > epsilon)
+  {
+    std::cout << "# Error: Householder representation of TSQR is wrong" << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+template <typename NumericT>
+int test(NumericT epsilon)
+{
+  std::cout << "# Testing TSQR against blocked Householder QR" << std::endl;
+  {
+    ublas::matrix<NumericT> A = random_matrix<NumericT>(150, 10, 137);
+    std::size_t block_counts[] = { 1, 2, 3, 5, 8, 15, 100 };
+    for (std::size_t k=0; k<7; ++k)
+    {
+      if (check_tsqr(A, block_counts[k], epsilon) != EXIT_SUCCESS)
+        return EXIT_FAILURE;
+      if (check_inplace_tsqr(A, block_counts[k], epsilon) != EXIT_SUCCESS)
+        return EXIT_FAILURE;
+    }
+  }
+
+  std::cout << "# Testing square matrix and a single column" << std::endl;
+  {
+    ublas::matrix<NumericT> A = random_matrix<NumericT>(12, 12, 139);
+    if (check_tsqr(A, 4, epsilon) != EXIT_SUCCESS || check_inplace_tsqr(A, 4, epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+    ublas::matrix<NumericT> a = random_matrix<NumericT>(40, 1, 149);
+    if (check_tsqr(a, 6, epsilon) != EXIT_SUCCESS || check_inplace_tsqr(a, 6, epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+  }
+
+  std::cout << "# Testing matrix with a zero block of rows and nearly dependent columns" << std::endl;
+  {
+    ublas::matrix<NumericT> A = random_matrix<NumericT>(96, 8, 151);
+    for (std::size_t i=0; i<A.size1(); ++i)
+    {
+      if (i < 30)
+        for (std::size_t j=0; j<A.size2(); ++j)
+          A(i, j) = 0;
+      A(i, 5) = A(i, 2) + NumericT(1e-3) * A(i, 5);
+    }
+    if (check_tsqr(A, 4, NumericT(100) * epsilon) != EXIT_SUCCESS || check_inplace_tsqr(A, 4, epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+  }
+
+  std::cout << "# Testing matrix with fewer rows than columns" << std::endl;
+  {
+    std::size_t m = 3;
+    std::size_t n = 8;
+    ublas::matrix<NumericT> A = random_matrix<NumericT>(m, n, 157);
+
+    ublas::matrix<NumericT> A_ref = A;
+    std::vector<NumericT> betas_ref = viennacl::linalg::inplace_qr(A_ref);
+    ublas::matrix<NumericT> Q_ref(m, m), R_ref(m, n);
+    viennacl::linalg::recoverQ(A_ref, betas_ref, Q_ref, R_ref);
+
+    ublas::matrix<NumericT> Q(m, n), R(n, n), R_only(n, n);
+    viennacl::linalg::tsqr(A, Q, R, 4, 4);
+    viennacl::linalg::tsqr(A, R_only, 4, 4);
+
+    NumericT err_QR = relative_difference(ublas::matrix<NumericT>(ublas::prod(Q, R)), A);
+    ublas::matrix<NumericT> Q_square = ublas::subrange(Q, 0, m, 0, m);
+    ublas::matrix<NumericT> QtQ = ublas::prod(ublas::trans(Q_square), Q_square);
+    ublas::identity_matrix<NumericT> I(m);
+    NumericT err_orth = ublas::norm_frobenius(QtQ - I) / std::sqrt(NumericT(m));
+    NumericT err_R = relative_difference(ublas::matrix<NumericT>(ublas::subrange(R, 0, m, 0, n)), R_ref);
+    NumericT padding = 0;
+    for (std::size_t i=0; i<n; ++i)
+      for (std::size_t j=0; j<n; ++j)
+      {
+        if (i >= m)
+          padding = std::max(padding, std::fabs(R(i, j)));
+        if (i < m && j >= m)
+          padding = std::max(padding, std::fabs(Q(i, j)));
+      }
+    NumericT err_R_only = relative_difference(R_only, R);
+
+    std::cout << "  > " << m << " x " << n << ": |QR - A| = " << err_QR << ", |Q^T Q - I| = " << err_orth << ", |R - R_ref| = " << err_R << std::endl;
+    if (err_QR > epsilon || err_orth > epsilon || err_R > epsilon || padding > 0 || err_R_only > 0)
+    {
+      std::cout << "# Error: TSQR factors of a wide matrix are wrong" << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (check_inplace_tsqr(A, 4, epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+  }
+
+  std::cout << "# Testing viennacl::matrix overloads" << std::endl;
+  {
+    std::size_t m = 80;
+    std::size_t n = 6;
+    ublas::matrix<NumericT> A_host = random_matrix<NumericT>(m, n, 157);
+    viennacl::matrix<NumericT> A(m, n), Q(m, n), R(n, n);
+    viennacl::copy(A_host, A);
+
+    ublas::matrix<NumericT> Q_ref(m, n), R_ref(n, n);
+    viennacl::linalg::tsqr(A_host, Q_ref, R_ref, 4);
+    viennacl::linalg::tsqr(A, Q, R, 4);
+    ublas::matrix<NumericT> Q_result(m, n), R_result(n, n);
+    viennacl::copy(Q, Q_result);
+    viennacl::copy(R, R_result);
+
+    ublas::matrix<NumericT> A_inplace_ref = A_host;
+    std::vector<NumericT> betas_ref = viennacl::linalg::inplace_tsqr(A_inplace_ref, 4);
+    std::vector<NumericT> betas = viennacl::linalg::inplace_tsqr(A, 4);
+    ublas::matrix<NumericT> A_result(m, n);
+    viennacl::copy(A, A_result);
+
+    NumericT err_betas = 0;
+    for (std::size_t i=0; i<n; ++i)
+      err_betas = std::max(err_betas, std::fabs(betas[i] - betas_ref[i]));
+    NumericT err = std::max(relative_difference(Q_result, Q_ref), relative_difference(R_result, R_ref));
+    err = std::max(err, relative_difference(A_result, A_inplace_ref));
+    std::cout << "  > difference to uBLAS: " << err << ", betas: " << err_betas << std::endl;
+    if (err > epsilon || err_betas > epsilon)
+    {
+      std::cout << "# Error: TSQR of viennacl::matrix differs" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
+//
+// -------------------------------------------------------------
+//
+int main()
+{
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "## Test :: Tall-skinny QR factorization" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+  int retval = EXIT_SUCCESS;
+
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+  {
+    typedef float NumericT;
+    NumericT epsilon = static_cast<NumericT>(1E-4);
+    std::cout << "# Testing setup:" << std::endl;
+    std::cout << "  eps:     " << epsilon << std::endl;
+    std::cout << "  numeric: float" << std::endl;
+    retval = test<NumericT>(epsilon);
+    if( retval == EXIT_SUCCESS )
+      std::cout << "# Test passed" << std::endl;
+    else
+      return retval;
+  }
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+#ifdef VIENNACL_WITH_OPENCL
+  if( viennacl::ocl::current_device().double_support() )
+#endif
+  {
+    {
+      typedef double NumericT;
+      NumericT epsilon = 1.0E-8;
+      std::cout << "# Testing setup:" << std::endl;
+      std::cout << "  eps:     " << epsilon << std::endl;
+      std::cout << "  numeric: double" << std::endl;
+      retval = test<NumericT>(epsilon);
+      if( retval == EXIT_SUCCESS )
+        std::cout << "# Test passed" << std::endl;
+      else
+        return retval;
+    }
+    std::cout << std::endl;
+    std::cout << "----------------------------------------------" << std::endl;
+    std::cout << std::endl;
+  }
+#ifdef VIENNACL_WITH_OPENCL
+  else
+    std::cout << "No double precision support, skipping test..." << std::endl;
+#endif
+
+  std::cout << std::endl;
+  std::cout << "------- Test completed --------" << std::endl;
+  std::cout << std::endl;
+
+  return retval;
+}
@@ -0,0 +1,145 @@
+#ifndef VIENNACL_BATCHED_COMPRESSED_MATRIX_HPP_
+#define VIENNACL_BATCHED_COMPRESSED_MATRIX_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/batched_compressed_matrix.hpp
+    @brief Implementation of the batched_compressed_matrix class, which holds a large number of small independent sparse systems in a common set of buffers.
+*/
+
+#include <vector>
+#include <map>
+#include <cassert>
+#include "viennacl/forwards.h"
+
+namespace viennacl
+{
+  /** @brief A batch of small, independent square sparse matrices in CSR format, stored back to back in a common set of buffers in main memory.
+  *
+  * System i occupies the rows offset(i), ..., offset(i+1)-1 of the row index array, its column indices are local to the system (i.e. range from 0 to size1(i)-1).
+  * The entries of system i are thus located contiguously in elements()[row_buffer()[offset(i)]], ..., elements()[row_buffer()[offset(i+1)] - 1],
+  * so that the values of all systems can be updated in place for a new time step without reallocation.
+  * The right hand side and result vectors of a batch are concatenated in the same order, see viennacl/linalg/batched_solve.hpp.
+  *
+  * @tparam SCALARTYPE    The floating point type (either float or double)
+  */
+  template <typename SCALARTYPE>
+  class batched_compressed_matrix
+  {
+    public:
+      typedef SCALARTYPE      value_type;
+
+      /** @brief Creates an empty batch */
+      batched_compressed_matrix() : system_offsets_(1, 0), row_buffer_(1, 0) {}
+
+      /** @brief Preallocates memory for the supplied number of systems, total number of rows and total number of nonzeros */
+      void reserve(vcl_size_t num_systems, vcl_size_t total_rows, vcl_size_t total_nonzeros)
+      {
+        system_offsets_.reserve(num_systems + 1);
+        row_buffer_.reserve(total_rows + 1);
+        col_buffer_.reserve(total_nonzeros);
+        elements_.reserve(total_nonzeros);
+      }
+
+      /** @brief Appends a system given in CSR format
+      *
+      * @param rows          Number of rows (and columns) of the system
+      * @param row_jumper    Array of length rows+1 holding the index of the first entry of each row, starting with zero
+      * @param col_buffer    Array holding the (local) column index of each entry
+      * @param elements      Array holding the entries
+      * @return The index of the system within the batch
+      */
+      template <typename IndexType>
+      vcl_size_t add_system(vcl_size_t rows, IndexType const * row_jumper, IndexType const * col_buffer, SCALARTYPE const * elements)
+      {
+        unsigned int base = static_cast<unsigned int>(elements_.size());
+        for (vcl_size_t i=0; i<rows; ++i)
+        {
+          for (IndexType k = row_jumper[i]; k < row_jumper[i+1]; ++k)
+          {
+            assert(static_cast<vcl_size_t>(col_buffer[k]) < rows && bool("Column index exceeds system size in batched_compressed_matrix::add_system()"));
+            col_buffer_.push_back(static_cast<unsigned int>(col_buffer[k]));
+            elements_.push_back(elements[k]);
+          }
+          row_buffer_.push_back(base + static_cast<unsigned int>(row_jumper[i+1]));
+        }
+        system_offsets_.push_back(static_cast<unsigned int>(row_buffer_.size() - 1));
+        return system_offsets_.size() - 2;
+      }
+
+      /** @brief Appends a system given as a STL sparse matrix (one std::map per row)
+      *
+      * @return The index of the system within the batch
+      */
+      vcl_size_t add_system(std::vector< std::map<unsigned int, SCALARTYPE> > const & cpu_matrix)
+      {
+        for (vcl_size_t i=0; i<cpu_matrix.size(); ++i)
+        {
+          for (typename std::map<unsigned int, SCALARTYPE>::const_iterator it = cpu_matrix[i].begin(); it != cpu_matrix[i].end(); ++it)
+          {
+            assert(static_cast<vcl_size_t>(it->first) < cpu_matrix.size() && bool("Column index exceeds system size in batched_compressed_matrix::add_system()"));
+            col_buffer_.push_back(it->first);
+            elements_.push_back(it->second);
+          }
+          row_buffer_.push_back(static_cast<unsigned int>(elements_.size()));
+        }
+        system_offsets_.push_back(static_cast<unsigned int>(row_buffer_.size() - 1));
+        return system_offsets_.size() - 2;
+      }
+
+      /** @brief Removes all systems from the batch. Allocated memory is kept. */
+      void clear()
+      {
+        system_offsets_.resize(1);
+        row_buffer_.resize(1);
+        col_buffer_.clear();
+        elements_.clear();
+      }
+
+      /** @brief Returns the number of systems in the batch */
+      vcl_size_t size() const { return system_offsets_.size() - 1; }
+      /** @brief Returns the number of rows of system i */
+      vcl_size_t size1(vcl_size_t i) const { return system_offsets_[i+1] - system_offsets_[i]; }
+      /** @brief Returns the index of the first row of system i in the concatenated batch, which is also the offset of system i in the right hand side and result vectors */
+      vcl_size_t offset(vcl_size_t i) const { return system_offsets_[i]; }
+      /** @brief Returns the total number of rows of all systems */
+      vcl_size_t total_size() const { return row_buffer_.size() - 1; }
+      /** @brief Returns the total number of nonzeros of all systems */
+      vcl_size_t nnz() const { return elements_.size(); }
+
+      /** @brief Returns the array of first rows of each system (length size()+1) */
+      std::vector<unsigned int> const & system_offsets() const { return system_offsets_; }
+      /** @brief Returns the row index array (length total_size()+1). Entries refer to the positions in col_buffer() and elements(). */
+      std::vector<unsigned int> const & row_buffer() const { return row_buffer_; }
+      /** @brief Returns the array of (system-local) column indices */
+      std::vector<unsigned int> const & col_buffer() const { return col_buffer_; }
+      /** @brief Returns the array of entries */
+      std::vector<SCALARTYPE> const & elements() const { return elements_; }
+      /** @brief Returns the array of entries for in-place updates of the values. The sparsity pattern must not be altered. */
+      std::vector<SCALARTYPE>       & elements()       { return elements_; }
+
+    private:
+      std::vector<unsigned int> system_offsets_;
+      std::vector<unsigned int> row_buffer_;
+      std::vector<unsigned int> col_buffer_;
+      std::vector<SCALARTYPE>   elements_;
+  };
+
+} //namespace viennacl
+
+#endif
@@ -32,11 +32,13 @@
 #include <boost/numeric/ublas/vector.hpp>
 #include <boost/numeric/ublas/triangular.hpp>
 #include <vector>
+#include <algorithm>
 #include <cmath>
 #include "viennacl/forwards.h"
 #include "viennacl/tools/tools.hpp"
 #include "viennacl/linalg/prod.hpp"
 #include "viennacl/linalg/direct_solve.hpp"
+#include "viennacl/linalg/chebyshev.hpp"
 
 #include "viennacl/linalg/detail/amg/amg_base.hpp"
 #include "viennacl/linalg/detail/amg/amg_coarse.hpp"
@@ -66,33 +68,33 @@ namespace viennacl
     * @param A      Operator matrices on all levels
     * @param P      Prolongation/Interpolation operators on all levels
     * @param Pointvector  Vector of points on all levels
+    * @param Nullspace  Near-nullspace vectors and nodes on all levels (only used for aggregation based AMG)
     * @param tag    AMG preconditioner tag
     */
-    template <typename InternalType1, typename InternalType2>
-    void amg_setup(InternalType1 & A, InternalType1 & P, InternalType2 & Pointvector, amg_tag & tag)
+    template <typename InternalType1, typename InternalType2, typename InternalType3>
+    void amg_setup(InternalType1 & A, InternalType1 & P, InternalType2 & Pointvector, InternalType3 & Nullspace, amg_tag & tag)
     {
       typedef typename InternalType2::value_type PointVectorType;
 
       unsigned int i, iterations, c_points, f_points;
-      detail::amg::amg_slicing<InternalType1,InternalType2> Slicing;
+      detail::amg::amg_slicing Slicing;
 
       // Set number of iterations. If automatic coarse grid construction is chosen (0), then set a maximum size and stop during the process.
       iterations = tag.get_coarselevels();
       if (iterations == 0)
         iterations = VIENNACL_AMG_MAX_LEVELS;
 
-      // For parallel coarsenings build data structures (number of threads set automatically).
+      // For parallel coarsenings build data structures (number of slices set automatically unless specified in the tag).
       if (tag.get_coarse() == VIENNACL_AMG_COARSE_RS0 || tag.get_coarse() == VIENNACL_AMG_COARSE_RS3)
-        Slicing.init(iterations);
+        Slicing.init(iterations, tag.get_slices());
 
       for (i=0; i<iterations; ++i)
       {
         // Initialize Pointvector on level i and construct points.
         Pointvector[i] = PointVectorType(static_cast<unsigned int>(A[i].size1()));
-        Pointvector[i].init_points();
 
         // Construct C and F points on coarse level (i is fine level, i+1 coarse level).
-        detail::amg::amg_coarse (i, A, Pointvector, Slicing, tag);
+        detail::amg::amg_coarse (i, A, Pointvector, Slicing, Nullspace, tag);
 
         // Calculate number of C and F points on level i.
         c_points = Pointvector[i].get_cpoints();
@@ -109,23 +111,23 @@ namespace viennacl
           break;
 
         // Construct interpolation matrix for level i.
-        detail::amg::amg_interpol (i, A, P, Pointvector, tag);
+        detail::amg::amg_interpol (i, A, P, Pointvector, Nullspace, tag);
+
+        // Stop if there is no actual coarsening (possible if an aggregate holds several near-nullspace vectors). Coarsest level is level i.
+        if (P[i].size2() == 0 || P[i].size2() >= A[i].size1())
+          break;
 
         // Compute coarse grid operator (A[i+1] = R * A[i] * P) with R = trans(P).
+        // The influences are kept in Pointvector for a numeric re-setup.
         detail::amg::amg_galerkin_prod(A[i], P[i], A[i+1]);
 
-        // Test triple matrix product. Very slow for large matrix sizes (ublas).
-        // test_triplematprod(A[i],P[i],A[i+1]);
-
-        Pointvector[i].delete_points();
-
         #ifdef VIENNACL_AMG_DEBUG
         std::cout << "Coarse Grid Operator Matrix:" << std::endl;
         printmatrix (A[i+1]);
         #endif
 
         // If Limit of coarse points is reached then stop. Coarsest level is level i+1.
-        if (tag.get_coarselevels() == 0 && c_points <= VIENNACL_AMG_COARSE_LIMIT)
+        if (tag.get_coarselevels() == 0 && P[i].size2() <= VIENNACL_AMG_COARSE_LIMIT)
         {
           tag.set_coarselevels(i+1);
           return;
@@ -134,6 +136,29 @@ namespace viennacl
       tag.set_coarselevels(i);
     }
 
+    /** @brief Numeric re-setup of the AMG preconditioner after the values of the operator matrix on the finest level have changed.
+    *
+    * Reuses the C/F splitting, the aggregates and the influences from amg_setup(). Only the interpolation weights and the coarse grid operators are recomputed.
+    * Pure aggregation (VIENNACL_AMG_INTERPOL_AG) does not depend on the matrix values, hence its prolongations are kept as well.
+    *
+    * @param A      Operator matrices on all levels. A[0] holds the new values.
+    * @param P      Prolongation/Interpolation operators on all levels
+    * @param Pointvector  Vector of points on all levels
+    * @param Nullspace  Near-nullspace vectors and nodes on all levels (only used for aggregation based AMG)
+    * @param tag    AMG preconditioner tag
+    */
+    template <typename InternalType1, typename InternalType2, typename InternalType3>
+    void amg_setup_numeric(InternalType1 & A, InternalType1 & P, InternalType2 & Pointvector, InternalType3 & Nullspace, amg_tag & tag)
+    {
+      for (unsigned int i=0; i<tag.get_coarselevels(); ++i)
+      {
+        if (tag.get_interpol() != VIENNACL_AMG_INTERPOL_AG)
+          detail::amg::amg_interpol (i, A, P, Pointvector, Nullspace, tag);
+
+        detail::amg::amg_galerkin_prod(A[i], P[i], A[i+1]);
+      }
+    }
+
     /** @brief Initialize AMG preconditioner
     *
     * @param mat    System matrix
@@ -178,7 +203,7 @@ namespace viennacl
     template <typename InternalType1, typename InternalType2>
     void amg_transform_cpu (InternalType1 & A, InternalType1 & P, InternalType1 & R, InternalType2 & A_setup, InternalType2 & P_setup, amg_tag & tag)
     {
-      //typedef typename InternalType1::value_type MatrixType;
+      typedef typename InternalType2::value_type SparseMatrixType;
 
       // Resize internal data structures to actual size.
       A.resize(tag.get_coarselevels()+1);
@@ -187,21 +212,14 @@ namespace viennacl
 
       // Transform into matrix type.
       for (unsigned int i=0; i<tag.get_coarselevels()+1; ++i)
-      {
-        A[i].resize(A_setup[i].size1(),A_setup[i].size2(),false);
-        A[i] = A_setup[i];
-      }
+        detail::amg::amg_copy(A_setup[i], A[i]);
       for (unsigned int i=0; i<tag.get_coarselevels(); ++i)
-      {
-        P[i].resize(P_setup[i].size1(),P_setup[i].size2(),false);
-        P[i] = P_setup[i];
-      }
+        detail::amg::amg_copy(P_setup[i], P[i]);
       for (unsigned int i=0; i<tag.get_coarselevels(); ++i)
       {
-        R[i].resize(P_setup[i].size2(),P_setup[i].size1(),false);
-        P_setup[i].set_trans(true);
-        R[i] = P_setup[i];
-        P_setup[i].set_trans(false);
+        SparseMatrixType R_setup;
+        detail::amg::amg_transpose(P_setup[i], R_setup);
+        detail::amg::amg_copy(R_setup, R[i]);
       }
     }
 
@@ -218,32 +236,30 @@ namespace viennacl
     template <typename InternalType1, typename InternalType2>
     void amg_transform_gpu (InternalType1 & A, InternalType1 & P, InternalType1 & R, InternalType2 & A_setup, InternalType2 & P_setup, amg_tag & tag, viennacl::context ctx)
     {
+      typedef typename InternalType2::value_type SparseMatrixType;
+
       // Resize internal data structures to actual size.
       A.resize(tag.get_coarselevels()+1);
       P.resize(tag.get_coarselevels());
       R.resize(tag.get_coarselevels());
 
-      // Copy to GPU using the internal sparse matrix structure: std::vector<std::map>.
+      // Copy to GPU. The CSR setup matrices provide the iterator interface required by viennacl::copy().
       for (unsigned int i=0; i<tag.get_coarselevels()+1; ++i)
       {
         viennacl::switch_memory_context(A[i], ctx);
-        //A[i].resize(A_setup[i].size1(),A_setup[i].size2(),false);
-        viennacl::copy(*(A_setup[i].get_internal_pointer()),A[i]);
+        viennacl::copy(A_setup[i],A[i]);
       }
       for (unsigned int i=0; i<tag.get_coarselevels(); ++i)
       {
         viennacl::switch_memory_context(P[i], ctx);
-        //P[i].resize(P_setup[i].size1(),P_setup[i].size2(),false);
-        viennacl::copy(*(P_setup[i].get_internal_pointer()),P[i]);
-        //viennacl::copy((boost::numeric::ublas::compressed_matrix<ScalarType>)P_setup[i],P[i]);
+        viennacl::copy(P_setup[i],P[i]);
       }
       for (unsigned int i=0; i<tag.get_coarselevels(); ++i)
       {
+        SparseMatrixType R_setup;
+        detail::amg::amg_transpose(P_setup[i], R_setup);
         viennacl::switch_memory_context(R[i], ctx);
-        //R[i].resize(P_setup[i].size2(),P_setup[i].size1(),false);
-        P_setup[i].set_trans(true);
-        viennacl::copy(*(P_setup[i].get_internal_pointer()),R[i]);
-        P_setup[i].set_trans(false);
+        viennacl::copy(R_setup,R[i]);
       }
     }
 
@@ -333,6 +349,58 @@ namespace viennacl
       boost::numeric::ublas::lu_factorize(op,Permutation);
     }
 
+    /** @brief Computes the inverse diagonal D^{-1} on each level. Used by the Chebyshev smoother.
+    *
+    * @param inv_diag    Inverse diagonals on all levels. Rows with a nonpositive diagonal entry are not scaled.
+    * @param A           Operator matrices on all levels from setup phase
+    * @param tag         AMG preconditioner tag
+    */
+    template <typename ScalarType, typename SparseMatrixType>
+    void amg_inverse_diagonal(std::vector< std::vector<ScalarType> > & inv_diag, SparseMatrixType const & A, amg_tag const & tag)
+    {
+      inv_diag.resize(tag.get_coarselevels()+1);
+      for (unsigned int level=0; level < tag.get_coarselevels()+1; ++level)
+      {
+        typename SparseMatrixType::value_type const & A_level = A[level];
+        long n = static_cast<long>(A_level.size1());
+
+        inv_diag[level].resize(static_cast<vcl_size_t>(n));
+#ifdef VIENNACL_WITH_OPENMP
+        #pragma omp parallel for
+#endif
+        for (long i=0; i<n; ++i)
+        {
+          ScalarType diag = 0;
+          for (unsigned int j = A_level.row_buffer()[i]; j < A_level.row_buffer()[i+1]; ++j)
+            if (A_level.col_buffer()[j] == static_cast<unsigned int>(i))
+              diag = A_level.elements()[j];
+          inv_diag[level][i] = (diag > 0) ? ScalarType(1) / diag : ScalarType(1);
+        }
+      }
+    }
+
+    /** @brief Computes an upper bound for the spectrum of D^{-1} A on each level. Used by the Chebyshev smoother.
+    *
+    * The largest eigenvalue is estimated by a few Lanczos steps of detail::chebyshev_estimate_spectrum() with the operator matrices of the precondition phase.
+    *
+    * @param lambda_max  Upper bounds for the spectra of D^{-1} A on all levels
+    * @param A           Operator matrices on all levels for precondition phase
+    * @param inv_diag    Inverse diagonals on all levels, see amg_inverse_diagonal()
+    * @param tag         AMG preconditioner tag
+    * @param steps       Number of Lanczos steps
+    */
+    template <typename ScalarType, typename InternalType1, typename InternalType2>
+    void amg_spectral_bounds(std::vector<ScalarType> & lambda_max, InternalType1 const & A, InternalType2 const & inv_diag,
+                             amg_tag const & tag, vcl_size_t steps = 10)
+    {
+      lambda_max.resize(tag.get_coarselevels()+1);
+      for (unsigned int level=0; level < tag.get_coarselevels()+1; ++level)
+      {
+        ScalarType lambda_min_level = 0;
+        detail::chebyshev_estimate_spectrum(A[level], &(inv_diag[level]), lambda_min_level, lambda_max[level], steps);
+      }
+    }
+
     /** @brief AMG preconditioner class, can be supplied to solve()-routines
     */
     template <typename MatrixType>
@@ -345,8 +413,6 @@ namespace viennacl
 
       typedef typename SparseMatrixType::const_iterator1 InternalConstRowIterator;
       typedef typename SparseMatrixType::const_iterator2 InternalConstColIterator;
-      typedef typename SparseMatrixType::iterator1 InternalRowIterator;
-      typedef typename SparseMatrixType::iterator2 InternalColIterator;
 
       boost::numeric::ublas::vector <SparseMatrixType> A_setup;
       boost::numeric::ublas::vector <SparseMatrixType> P_setup;
@@ -354,6 +420,7 @@ namespace viennacl
       boost::numeric::ublas::vector <MatrixType> P;
       boost::numeric::ublas::vector <MatrixType> R;
       boost::numeric::ublas::vector <PointVectorType> Pointvector;
+      detail::amg::amg_nullspace<ScalarType> Nullspace_;
 
       mutable boost::numeric::ublas::compressed_matrix<ScalarType> op;
       mutable boost::numeric::ublas::permutation_matrix<> Permutation;
@@ -362,6 +429,9 @@ namespace viennacl
       mutable boost::numeric::ublas::vector <VectorType> rhs;
       mutable boost::numeric::ublas::vector <VectorType> residual;
 
+      mutable std::vector<ScalarType> lambda_max_;
+      mutable boost::numeric::ublas::vector <VectorType> inv_diag_;
+
       mutable bool done_init_apply;
 
       amg_tag tag_;
@@ -387,13 +457,40 @@ namespace viennacl
       void setup()
       {
         // Start setup phase.
-        amg_setup(A_setup,P_setup,Pointvector,tag_);
+        amg_setup(A_setup,P_setup,Pointvector,Nullspace_,tag_);
         // Transform to CPU-Matrixtype for precondition phase.
         amg_transform_cpu(A,P,R,A_setup,P_setup,tag_);
 
         done_init_apply = false;
       }
 
+      /** @brief Sets near-nullspace vectors (e.g. rigid body modes for elasticity) for aggregation based AMG (VIENNACL_AMG_COARSE_AG). Must be called before setup().
+      *
+      * @param B              The near-nullspace vectors. B[j][i] is entry i of vector j.
+      * @param dofs_per_node  Number of consecutive unknowns forming a node. All unknowns of a node are put into the same aggregate.
+      */
+      template <typename VectorArrayType>
+      void set_nullspace(VectorArrayType const & B, unsigned int dofs_per_node = 1)
+      {
+        Nullspace_.init(B, static_cast<unsigned int>(A_setup[0].size1()), dofs_per_node);
+      }
+
+      /** @brief Numeric re-setup for a system matrix with new values after setup() has been called.
+      *  Reuses the coarsening (C/F splitting, aggregates) and the sparsity patterns of the interpolation, only values and coarse grid operators are recomputed.
+      *
+      * @param mat  System matrix with the same size and a similar sparsity pattern as the one passed to the constructor
+      */
+      void resetup(MatrixType const & mat)
+      {
+        assert(mat.size1() == A_setup[0].size1() && bool("Error in amg_precond::resetup(): Size of system matrix changed!"));
+
+        A_setup[0] = SparseMatrixType(mat);
+        amg_setup_numeric(A_setup,P_setup,Pointvector,Nullspace_,tag_);
+        amg_transform_cpu(A,P,R,A_setup,P_setup,tag_);
+
+        done_init_apply = false;
+      }
+
       /** @brief Prepare data structures for preconditioning:
        *  Build data structures for precondition phase.
        *  Do LU factorization on coarsest level.
@@ -404,6 +501,19 @@ namespace viennacl
         amg_setup_apply(result,rhs,residual,A_setup,tag_);
         // Do LU factorization for direct solve.
         amg_lu(op,Permutation,A_setup[tag_.get_coarselevels()]);
+        // Diagonal scaling and spectral bounds for the Chebyshev smoother.
+        if (tag_.get_smoother() == VIENNACL_AMG_SMOOTHER_CHEBYSHEV)
+        {
+          std::vector< std::vector<ScalarType> > inv_diag;
+          amg_inverse_diagonal(inv_diag,A_setup,tag_);
+          inv_diag_.resize(inv_diag.size());
+          for (vcl_size_t level=0; level < inv_diag.size(); ++level)
+          {
+            inv_diag_[level] = VectorType(inv_diag[level].size());
+            std::copy(inv_diag[level].begin(), inv_diag[level].end(), inv_diag_[level].begin());
+          }
+          amg_spectral_bounds(lambda_max_,A,inv_diag_,tag_);
+        }
 
         done_init_apply = true;
       }
@@ -417,24 +527,14 @@ namespace viennacl
       ScalarType calc_complexity(VectorType & avgstencil)
       {
         avgstencil = VectorType (tag_.get_coarselevels()+1);
-        unsigned int nonzero=0, systemmat_nonzero=0, level_coefficients=0;
+        vcl_size_t nonzero=0, systemmat_nonzero=A_setup[0].nnz();
 
         for (unsigned int level=0; level < tag_.get_coarselevels()+1; ++level)
         {
-          level_coefficients = 0;
-          for (InternalRowIterator row_iter = A_setup[level].begin1(); row_iter != A_setup[level].end1(); ++row_iter)
-          {
-            for (InternalColIterator col_iter = row_iter.begin(); col_iter != row_iter.end(); ++col_iter)
-            {
-              if (level == 0)
-                systemmat_nonzero++;
-              nonzero++;
-              level_coefficients++;
-            }
-          }
-          avgstencil[level] = level_coefficients/static_cast<ScalarType>(A_setup[level].size1());
+          nonzero += A_setup[level].nnz();
+          avgstencil[level] = static_cast<ScalarType>(A_setup[level].nnz())/static_cast<ScalarType>(A_setup[level].size1());
         }
-        return nonzero/static_cast<ScalarType>(systemmat_nonzero);
+        return static_cast<ScalarType>(nonzero)/static_cast<ScalarType>(systemmat_nonzero);
       }
 
       /** @brief Precondition Operation
@@ -457,7 +557,7 @@ namespace viennacl
           result[level].clear();
 
           // Apply Smoother presmooth_ times.
-          smooth_jacobi (level, tag_.get_presmooth(), result[level], rhs[level]);
+          smooth (level, tag_.get_presmooth(), result[level], rhs[level]);
 
           #ifdef VIENNACL_AMG_DEBUG
           std::cout << "After presmooth:" << std::endl;
@@ -506,7 +606,7 @@ namespace viennacl
           #endif
 
           // Apply Smoother postsmooth_ times.
-          smooth_jacobi (level, tag_.get_postsmooth(), result[level], rhs[level]);
+          smooth (level, tag_.get_postsmooth(), result[level], rhs[level]);
 
           #ifdef VIENNACL_AMG_DEBUG
           std::cout << "After postsmooth: " << std::endl;
@@ -516,6 +616,42 @@ namespace viennacl
         vec = result[0];
       }
 
+      /** @brief Applies the smoother selected in the AMG tag
+      * @param level    Coarse level to which smoother is applied to
+      * @param iterations  Number of smoother iterations
+      * @param x     The vector smoothing is applied to
+      * @param rhs    The right hand side of the equation for the smoother
+      */
+      template <typename VectorType>
+      void smooth(int level, int const iterations, VectorType & x, VectorType const & rhs) const
+      {
+        if (tag_.get_smoother() == VIENNACL_AMG_SMOOTHER_CHEBYSHEV)
+          smooth_chebyshev(level, iterations, x, rhs);
+        else
+          smooth_jacobi(level, iterations, x, rhs);
+      }
+
+      /** @brief Chebyshev Smoother (CPU version). Damps the error components of D^{-1} A in [lambda_max/4, lambda_max] without any inner products.
+      * @param level    Coarse level to which smoother is applied to
+      * @param iterations  Number of smoother iterations (degree of the Chebyshev polynomial)
+      * @param x     The vector smoothing is applied to
+      * @param rhs    The right hand side of the equation for the smoother
+      */
+      template <typename VectorType>
+      void smooth_chebyshev(int level, int const iterations, VectorType & x, VectorType const & rhs) const
+      {
+        if (iterations <= 0)
+          return;
+
+        VectorType r = rhs - boost::numeric::ublas::prod(A[level], x);
+        VectorType d(x.size());
+        VectorType tmp(x.size());
+        ScalarType rho = 0;
+        detail::chebyshev_iterate(A[level], &(inv_diag_[level]), x, r, d, tmp,
+                                  lambda_max_[level] / ScalarType(4), lambda_max_[level], rho,
+                                  static_cast<vcl_size_t>(iterations), true, false);
+      }
+
       /** @brief (Weighted) Jacobi Smoother (CPU version)
       * @param level    Coarse level to which smoother is applied to
       * @param iterations  Number of smoother iterations
@@ -557,9 +693,10 @@ namespace viennacl
       amg_tag & tag() { return tag_; }
     };
 
+#ifdef VIENNACL_WITH_OPENCL
     /** @brief AMG preconditioner class, can be supplied to solve()-routines.
     *
-    *  Specialization for compressed_matrix
+    *  Specialization for compressed_matrix. Requires the OpenCL backend for the Jacobi smoother.
     */
     template <typename ScalarType, unsigned int MAT_ALIGNMENT>
     class amg_precond< compressed_matrix<ScalarType, MAT_ALIGNMENT> >
@@ -571,8 +708,6 @@ namespace viennacl
 
       typedef typename SparseMatrixType::const_iterator1 InternalConstRowIterator;
       typedef typename SparseMatrixType::const_iterator2 InternalConstColIterator;
-      typedef typename SparseMatrixType::iterator1 InternalRowIterator;
-      typedef typename SparseMatrixType::iterator2 InternalColIterator;
 
       boost::numeric::ublas::vector <SparseMatrixType> A_setup;
       boost::numeric::ublas::vector <SparseMatrixType> P_setup;
@@ -580,6 +715,7 @@ namespace viennacl
       boost::numeric::ublas::vector <MatrixType> P;
       boost::numeric::ublas::vector <MatrixType> R;
       boost::numeric::ublas::vector <PointVectorType> Pointvector;
+      detail::amg::amg_nullspace<ScalarType> Nullspace_;
 
       mutable boost::numeric::ublas::compressed_matrix<ScalarType> op;
       mutable boost::numeric::ublas::permutation_matrix<> Permutation;
@@ -590,6 +726,9 @@ namespace viennacl
 
       viennacl::context ctx_;
 
+      mutable std::vector<ScalarType> lambda_max_;
+      mutable boost::numeric::ublas::vector <VectorType> inv_diag_;
+
       mutable bool done_init_apply;
 
       amg_tag tag_;
@@ -607,12 +746,8 @@ namespace viennacl
       {
         tag_ = tag;
 
-        // Copy to CPU. Internal structure of sparse matrix is used for copy operation.
-        std::vector<std::map<unsigned int, ScalarType> > mat2 = std::vector<std::map<unsigned int, ScalarType> >(mat.size1());
-        viennacl::copy(mat, mat2);
-
-        // Initialize data structures.
-        amg_init (mat2,A_setup,P_setup,Pointvector,tag_);
+        // Initialize data structures. The CSR arrays of mat are copied to the host directly.
+        amg_init (mat,A_setup,P_setup,Pointvector,tag_);
 
         done_init_apply = false;
       }
@@ -622,13 +757,40 @@ namespace viennacl
       void setup()
       {
         // Start setup phase.
-        amg_setup(A_setup,P_setup,Pointvector, tag_);
+        amg_setup(A_setup,P_setup,Pointvector,Nullspace_, tag_);
         // Transform to GPU-Matrixtype for precondition phase.
         amg_transform_gpu(A,P,R,A_setup,P_setup, tag_, ctx_);
 
         done_init_apply = false;
       }
 
+      /** @brief Sets near-nullspace vectors (e.g. rigid body modes for elasticity) for aggregation based AMG (VIENNACL_AMG_COARSE_AG). Must be called before setup().
+      *
+      * @param B              The near-nullspace vectors on the host. B[j][i] is entry i of vector j.
+      * @param dofs_per_node  Number of consecutive unknowns forming a node. All unknowns of a node are put into the same aggregate.
+      */
+      template <typename VectorArrayType>
+      void set_nullspace(VectorArrayType const & B, unsigned int dofs_per_node = 1)
+      {
+        Nullspace_.init(B, static_cast<unsigned int>(A_setup[0].size1()), dofs_per_node);
+      }
+
+      /** @brief Numeric re-setup for a system matrix with new values after setup() has been called.
+      *  Reuses the coarsening (C/F splitting, aggregates) and the sparsity patterns of the interpolation, only values and coarse grid operators are recomputed.
+      *
+      * @param mat  System matrix with the same size and a similar sparsity pattern as the one passed to the constructor
+      */
+      void resetup(compressed_matrix<ScalarType, MAT_ALIGNMENT> const & mat)
+      {
+        assert(mat.size1() == A_setup[0].size1() && bool("Error in amg_precond::resetup(): Size of system matrix changed!"));
+
+        A_setup[0] = SparseMatrixType(mat);
+        amg_setup_numeric(A_setup,P_setup,Pointvector,Nullspace_,tag_);
+        amg_transform_gpu(A,P,R,A_setup,P_setup, tag_, ctx_);
+
+        done_init_apply = false;
+      }
+
       /** @brief Prepare data structures for preconditioning:
        *  Build data structures for precondition phase.
        *  Do LU factorization on coarsest level.
@@ -639,6 +801,19 @@ namespace viennacl
         amg_setup_apply(result,rhs,residual,A_setup,tag_, ctx_);
         // Do LU factorization for direct solve.
         amg_lu(op,Permutation,A_setup[tag_.get_coarselevels()]);
+        // Diagonal scaling and spectral bounds for the Chebyshev smoother.
+        if (tag_.get_smoother() == VIENNACL_AMG_SMOOTHER_CHEBYSHEV)
+        {
+          std::vector< std::vector<ScalarType> > inv_diag;
+          amg_inverse_diagonal(inv_diag,A_setup,tag_);
+          inv_diag_.resize(inv_diag.size());
+          for (vcl_size_t level=0; level < inv_diag.size(); ++level)
+          {
+            inv_diag_[level] = VectorType(inv_diag[level].size(), ctx_);
+            viennacl::copy(inv_diag[level], inv_diag_[level]);
+          }
+          amg_spectral_bounds(lambda_max_,A,inv_diag_,tag_);
+        }
 
         done_init_apply = true;
       }
@@ -652,24 +827,14 @@ namespace viennacl
       ScalarType calc_complexity(VectorType & avgstencil)
       {
         avgstencil = VectorType (tag_.get_coarselevels()+1);
-        unsigned int nonzero=0, systemmat_nonzero=0, level_coefficients=0;
+        vcl_size_t nonzero=0, systemmat_nonzero=A_setup[0].nnz();
 
         for (unsigned int level=0; level < tag_.get_coarselevels()+1; ++level)
         {
-          level_coefficients = 0;
-          for (InternalRowIterator row_iter = A_setup[level].begin1(); row_iter != A_setup[level].end1(); ++row_iter)
-          {
-            for (InternalColIterator col_iter = row_iter.begin(); col_iter != row_iter.end(); ++col_iter)
-            {
-              if (level == 0)
-                systemmat_nonzero++;
-              nonzero++;
-              level_coefficients++;
-            }
-          }
-          avgstencil[level] = level_coefficients/(double)A[level].size1();
+          nonzero += A_setup[level].nnz();
+          avgstencil[level] = static_cast<double>(A_setup[level].nnz())/(double)A[level].size1();
         }
-        return nonzero/static_cast<double>(systemmat_nonzero);
+        return static_cast<double>(nonzero)/static_cast<double>(systemmat_nonzero);
       }
 
       /** @brief Precondition Operation
@@ -691,7 +856,7 @@ namespace viennacl
           result[level].clear();
 
           // Apply Smoother presmooth_ times.
-          smooth_jacobi (level, tag_.get_presmooth(), result[level], rhs[level]);
+          smooth (level, tag_.get_presmooth(), result[level], rhs[level]);
 
           #ifdef VIENNACL_AMG_DEBUG
           std::cout << "After presmooth: " << std::endl;
@@ -748,7 +913,7 @@ namespace viennacl
           #endif
 
           // Apply Smoother postsmooth_ times.
-          smooth_jacobi (level, tag_.get_postsmooth(), result[level], rhs[level]);
+          smooth (level, tag_.get_postsmooth(), result[level], rhs[level]);
 
           #ifdef VIENNACL_AMG_DEBUG
           std::cout << "After postsmooth: " << std::endl;
@@ -758,6 +923,43 @@ namespace viennacl
         vec = result[0];
       }
 
+      /** @brief Applies the smoother selected in the AMG tag
+      * @param level       Coarse level to which smoother is applied to
+      * @param iterations  Number of smoother iterations
+      * @param x           The vector smoothing is applied to
+      * @param rhs         The right hand side of the equation for the smoother
+      */
+      template <typename VectorType>
+      void smooth(int level, unsigned int iterations, VectorType & x, VectorType const & rhs) const
+      {
+        if (tag_.get_smoother() == VIENNACL_AMG_SMOOTHER_CHEBYSHEV)
+          smooth_chebyshev(level, iterations, x, rhs);
+        else
+          smooth_jacobi(level, iterations, x, rhs);
+      }
+
+      /** @brief Chebyshev Smoother (GPU version). Damps the error components of D^{-1} A in [lambda_max/4, lambda_max] without any inner products.
+      * @param level       Coarse level to which smoother is applied to
+      * @param iterations  Number of smoother iterations (degree of the Chebyshev polynomial)
+      * @param x           The vector smoothing is applied to
+      * @param rhs         The right hand side of the equation for the smoother
+      */
+      template <typename VectorType>
+      void smooth_chebyshev(int level, unsigned int iterations, VectorType & x, VectorType const & rhs) const
+      {
+        if (iterations == 0)
+          return;
+
+        VectorType r = viennacl::linalg::prod(A[level], x);
+        r = rhs - r;
+        VectorType d = r;
+        VectorType tmp = r;
+        ScalarType rho = 0;
+        detail::chebyshev_iterate(A[level], &(inv_diag_[level]), x, r, d, tmp,
+                                  lambda_max_[level] / ScalarType(4), lambda_max_[level], rho,
+                                  static_cast<vcl_size_t>(iterations), true, false);
+      }
+
       /** @brief Jacobi Smoother (GPU version)
       * @param level       Coarse level to which smoother is applied to
       * @param iterations  Number of smoother iterations
@@ -790,6 +992,7 @@ namespace viennacl
 
       amg_tag & tag() { return tag_; }
     };
+#endif
 
   }
 }
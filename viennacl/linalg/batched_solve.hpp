@@ -0,0 +1,641 @@
+#ifndef VIENNACL_LINALG_BATCHED_SOLVE_HPP_
+#define VIENNACL_LINALG_BATCHED_SOLVE_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/batched_solve.hpp
+    @brief Solvers for batches of small independent sparse systems stored in a batched_compressed_matrix. Parallelized across systems using OpenMP.
+*/
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <cassert>
+#include "viennacl/forwards.h"
+#include "viennacl/batched_compressed_matrix.hpp"
+
+#ifdef VIENNACL_WITH_OPENMP
+#include <omp.h>
+#endif
+
+// Number of systems assigned to an OpenMP thread at once:
+#ifndef VIENNACL_OPENMP_BATCHED_CHUNK_SIZE
+  #define VIENNACL_OPENMP_BATCHED_CHUNK_SIZE  8
+#endif
+
+namespace viennacl
+{
+  namespace linalg
+  {
+    namespace detail
+    {
+      /** @brief Common base class of the tags for batched iterative solvers. Holds the solver parameters and the per-system iteration counts and errors. */
+      class batched_iterative_tag
+      {
+        public:
+          batched_iterative_tag(double tol, unsigned int max_iterations, bool use_jacobi)
+            : tol_(tol), iterations_(max_iterations), use_jacobi_(use_jacobi) {}
+
+          /** @brief Returns the relative tolerance */
+          double tolerance() const { return tol_; }
+          /** @brief Returns the maximum number of iterations per system */
+          unsigned int max_iterations() const { return iterations_; }
+          /** @brief Returns true if each system is preconditioned with its diagonal */
+          bool use_jacobi() const { return use_jacobi_; }
+
+          /** @brief Returns the maximum number of iterations over all systems of the last batch */
+          unsigned int iters() const { return iters_.size() > 0 ? *std::max_element(iters_.begin(), iters_.end()) : 0; }
+          /** @brief Returns the number of iterations for system i of the last batch */
+          unsigned int iters(vcl_size_t i) const { return iters_[i]; }
+
+          /** @brief Returns the maximum relative residual over all systems of the last batch */
+          double error() const { return errors_.size() > 0 ? *std::max_element(errors_.begin(), errors_.end()) : 0; }
+          /** @brief Returns the relative residual for system i of the last batch */
+          double error(vcl_size_t i) const { return errors_[i]; }
+
+          /** @brief Returns the number of systems of the last batch which did not reach the tolerance */
+          vcl_size_t unconverged() const
+          {
+            vcl_size_t count = 0;
+            for (vcl_size_t i=0; i<errors_.size(); ++i)
+              if (!(errors_[i] < tol_))
+                ++count;
+            return count;
+          }
+
+          /** @brief Stores the result of system i. Called by the solver. */
+          void result(vcl_size_t i, unsigned int iterations, double error) const
+          {
+            iters_[i]  = iterations;
+            errors_[i] = error;
+          }
+          /** @brief Prepares the storage of the results for a batch of the given size. Called by the solver. */
+          void resize(vcl_size_t num_systems) const
+          {
+            iters_.assign(num_systems, 0);
+            errors_.assign(num_systems, 0);
+          }
+
+        private:
+          double tol_;
+          unsigned int iterations_;
+          bool use_jacobi_;
+
+          //return values from solver
+          mutable std::vector<unsigned int> iters_;
+          mutable std::vector<double> errors_;
+      };
+
+      /** @brief Common base class of the tags for batched direct solvers. Holds the per-system information on singularity. */
+      class batched_direct_tag
+      {
+        public:
+          /** @brief Returns true if a zero pivot was encountered in system i of the last batch. The result of such a system is set to zero. */
+          bool singular(vcl_size_t i) const { return singular_[i] != 0; }
+
+          /** @brief Returns the number of singular systems of the last batch */
+          vcl_size_t num_singular() const { return static_cast<vcl_size_t>(std::count(singular_.begin(), singular_.end(), static_cast<unsigned char>(1))); }
+
+          /** @brief Stores the singularity flag of system i. Called by the solver. */
+          void result(vcl_size_t i, bool is_singular) const { singular_[i] = is_singular ? 1 : 0; }
+          /** @brief Prepares the storage of the results for a batch of the given size. Called by the solver. */
+          void resize(vcl_size_t num_systems) const { singular_.assign(num_systems, 0); }
+
+        private:
+          mutable std::vector<unsigned char> singular_;
+      };
+    }
+
+    /** @brief A tag for the batched conjugate gradient solver. Used for supplying solver parameters and for dispatching the solve() function
+    */
+    class batched_cg_tag : public detail::batched_iterative_tag
+    {
+      public:
+        /** @brief The constructor
+        *
+        * @param tol              Relative tolerance for the residual of each system (solver quits if ||r_i|| < tol * ||b_i||)
+        * @param max_iterations   The maximum number of iterations per system
+        * @param use_jacobi       If true, each system is preconditioned with its diagonal
+        */
+        batched_cg_tag(double tol = 1e-8, unsigned int max_iterations = 300, bool use_jacobi = false)
+          : detail::batched_iterative_tag(tol, max_iterations, use_jacobi) {}
+    };
+
+    /** @brief A tag for the batched stabilized bi-conjugate gradient solver. Used for supplying solver parameters and for dispatching the solve() function
+    */
+    class batched_bicgstab_tag : public detail::batched_iterative_tag
+    {
+      public:
+        /** @brief The constructor
+        *
+        * @param tol              Relative tolerance for the residual of each system (solver quits if ||r_i|| < tol * ||b_i||)
+        * @param max_iterations   The maximum number of iterations per system
+        * @param use_jacobi       If true, each system is preconditioned with its diagonal (from the right, hence the tolerance refers to the unpreconditioned residual)
+        */
+        batched_bicgstab_tag(double tol = 1e-8, unsigned int max_iterations = 300, bool use_jacobi = false)
+          : detail::batched_iterative_tag(tol, max_iterations, use_jacobi) {}
+    };
+
+    /** @brief A tag for the batched direct solver based on dense LU factorizations with partial pivoting. Suitable for systems with up to a few hundred unknowns.
+    */
+    class batched_dense_lu_tag : public detail::batched_direct_tag {};
+
+    /** @brief A tag for the batched direct solver based on banded LU factorizations with partial pivoting. The bandwidth is determined for each system separately.
+    */
+    class batched_banded_lu_tag : public detail::batched_direct_tag {};
+
+
+    namespace detail
+    {
+      /** @brief Pointers to the data of a single system of a batch */
+      template <typename T>
+      struct batched_system
+      {
+        batched_system(viennacl::batched_compressed_matrix<T> const & A, vcl_size_t i)
+          : size(A.size1(i)),
+            row_buffer(&(A.row_buffer()[0]) + A.offset(i)),
+            col_buffer(A.nnz() > 0 ? &(A.col_buffer()[0]) : NULL),
+            elements(A.nnz() > 0 ? &(A.elements()[0]) : NULL) {}
+
+        /** @brief y = A x */
+        void prod(T const * x, T * y) const
+        {
+          for (vcl_size_t row = 0; row < size; ++row)
+          {
+            T sum = 0;
+            for (unsigned int k = row_buffer[row]; k < row_buffer[row+1]; ++k)
+              sum += elements[k] * x[col_buffer[k]];
+            y[row] = sum;
+          }
+        }
+
+        /** @brief Writes the reciprocal diagonal entries to 'inv_diag'. Zero diagonal entries are replaced by one. */
+        void inverse_diagonal(T * inv_diag) const
+        {
+          for (vcl_size_t row = 0; row < size; ++row)
+          {
+            T diag = 0;
+            for (unsigned int k = row_buffer[row]; k < row_buffer[row+1]; ++k)
+              if (col_buffer[k] == row)
+                diag = elements[k];
+            inv_diag[row] = (diag != 0) ? T(1) / diag : T(1);
+          }
+        }
+
+        vcl_size_t size;
+        unsigned int const * row_buffer;
+        unsigned int const * col_buffer;
+        T const * elements;
+      };
+
+      template <typename T>
+      T batched_dot(T const * x, T const * y, vcl_size_t n)
+      {
+        T sum = 0;
+        for (vcl_size_t i = 0; i < n; ++i)
+          sum += x[i] * y[i];
+        return sum;
+      }
+
+
+      /** @brief Conjugate gradients for a single system of the batch, following the algorithm in the book by Y. Saad "Iterative Methods for sparse linear systems" */
+      template <typename T>
+      struct batched_cg_kernel
+      {
+        batched_cg_kernel(batched_cg_tag const & tag) : tag_(tag) {}
+
+        void operator()(batched_system<T> const & A, vcl_size_t system_id, T const * b, T * x, std::vector<T> & workspace) const
+        {
+          vcl_size_t n = A.size;
+          workspace.resize(5 * n);
+          T * r = &(workspace[0]);
+          T * z = r + n;
+          T * p = z + n;
+          T * Ap = p + n;
+          T * inv_diag = Ap + n;
+
+          if (tag_.use_jacobi())
+            A.inverse_diagonal(inv_diag);
+          else
+            std::fill(inv_diag, inv_diag + n, T(1));
+
+          T norm_b = std::sqrt(batched_dot(b, b, n));
+          std::fill(x, x + n, T(0));
+          if (norm_b == 0) //solution is zero if RHS norm is zero
+          {
+            tag_.result(system_id, 0, 0);
+            return;
+          }
+
+          T rz = 0;
+          for (vcl_size_t i = 0; i < n; ++i)
+          {
+            r[i] = b[i];
+            z[i] = inv_diag[i] * r[i];
+            p[i] = z[i];
+            rz += r[i] * z[i];
+          }
+
+          T norm_r = norm_b;
+          unsigned int iters = 0;
+          while (iters < tag_.max_iterations() && norm_r / norm_b >= tag_.tolerance())
+          {
+            ++iters;
+            A.prod(p, Ap);
+            T pAp = batched_dot(p, Ap, n);
+            if (pAp == 0) //breakdown
+              break;
+            T alpha = rz / pAp;
+
+            T rr = 0;
+            T rz_new = 0;
+            for (vcl_size_t i = 0; i < n; ++i)
+            {
+              x[i] += alpha * p[i];
+              r[i] -= alpha * Ap[i];
+              z[i]  = inv_diag[i] * r[i];
+              rr     += r[i] * r[i];
+              rz_new += r[i] * z[i];
+            }
+            norm_r = std::sqrt(rr);
+
+            T beta = rz_new / rz;
+            rz = rz_new;
+            for (vcl_size_t i = 0; i < n; ++i)
+              p[i] = z[i] + beta * p[i];
+          }
+
+          tag_.result(system_id, iters, norm_r / norm_b);
+        }
+
+        batched_cg_tag const & tag_;
+      };
+
+
+      /** @brief Right preconditioned BiCGStab for a single system of the batch, following the algorithm by H. A. van der Vorst */
+      template <typename T>
+      struct batched_bicgstab_kernel
+      {
+        batched_bicgstab_kernel(batched_bicgstab_tag const & tag) : tag_(tag) {}
+
+        void operator()(batched_system<T> const & A, vcl_size_t system_id, T const * b, T * x, std::vector<T> & workspace) const
+        {
+          vcl_size_t n = A.size;
+          workspace.resize(8 * n);
+          T * r        = &(workspace[0]);
+          T * r0star   = r + n;
+          T * p        = r0star + n;
+          T * p_hat    = p + n;
+          T * v        = p_hat + n;
+          T * s_hat    = v + n;
+          T * t        = s_hat + n;
+          T * inv_diag = t + n;
+
+          if (tag_.use_jacobi())
+            A.inverse_diagonal(inv_diag);
+          else
+            std::fill(inv_diag, inv_diag + n, T(1));
+
+          T norm_b = std::sqrt(batched_dot(b, b, n));
+          std::fill(x, x + n, T(0));
+          if (norm_b == 0) //solution is zero if RHS norm is zero
+          {
+            tag_.result(system_id, 0, 0);
+            return;
+          }
+
+          for (vcl_size_t i = 0; i < n; ++i)
+          {
+            r[i] = b[i];
+            r0star[i] = b[i];
+            p[i] = 0;
+            v[i] = 0;
+          }
+
+          T rho = 1, alpha = 1, omega = 1;
+          T norm_r = norm_b;
+          unsigned int iters = 0;
+          while (iters < tag_.max_iterations() && norm_r / norm_b >= tag_.tolerance())
+          {
+            ++iters;
+            T rho_new = batched_dot(r0star, r, n);
+            if (rho_new == 0 || omega == 0) //breakdown
+              break;
+            T beta = (rho_new / rho) * (alpha / omega);
+            rho = rho_new;
+
+            for (vcl_size_t i = 0; i < n; ++i)
+            {
+              p[i] = r[i] + beta * (p[i] - omega * v[i]);
+              p_hat[i] = inv_diag[i] * p[i];
+            }
+            A.prod(p_hat, v);
+
+            T r0v = batched_dot(r0star, v, n);
+            if (r0v == 0) //breakdown
+              break;
+            alpha = rho / r0v;
+
+            // s is stored in r:
+            T ss = 0;
+            for (vcl_size_t i = 0; i < n; ++i)
+            {
+              r[i] -= alpha * v[i];
+              s_hat[i] = inv_diag[i] * r[i];
+              ss += r[i] * r[i];
+            }
+            if (std::sqrt(ss) / norm_b < tag_.tolerance())
+            {
+              for (vcl_size_t i = 0; i < n; ++i)
+                x[i] += alpha * p_hat[i];
+              norm_r = std::sqrt(ss);
+              break;
+            }
+
+            A.prod(s_hat, t);
+            T ts = 0, tt = 0;
+            for (vcl_size_t i = 0; i < n; ++i)
+            {
+              ts += t[i] * r[i];
+              tt += t[i] * t[i];
+            }
+            omega = (tt != 0) ? ts / tt : T(0);
+
+            T rr = 0;
+            for (vcl_size_t i = 0; i < n; ++i)
+            {
+              x[i] += alpha * p_hat[i] + omega * s_hat[i];
+              r[i] -= omega * t[i];
+              rr += r[i] * r[i];
+            }
+            norm_r = std::sqrt(rr);
+          }
+
+          tag_.result(system_id, iters, norm_r / norm_b);
+        }
+
+        batched_bicgstab_tag const & tag_;
+      };
+
+
+      /** @brief Dense LU factorization with partial pivoting and substitution for a single system of the batch */
+      template <typename T>
+      struct batched_dense_lu_kernel
+      {
+        batched_dense_lu_kernel(batched_dense_lu_tag const & tag) : tag_(tag) {}
+
+        void operator()(batched_system<T> const & A, vcl_size_t system_id, T const * b, T * x, std::vector<T> & workspace) const
+        {
+          vcl_size_t n = A.size;
+          workspace.assign(n * n, T(0));
+          T * LU = &(workspace[0]);
+
+          for (vcl_size_t row = 0; row < n; ++row)
+            for (unsigned int k = A.row_buffer[row]; k < A.row_buffer[row+1]; ++k)
+              LU[row * n + A.col_buffer[k]] += A.elements[k];
+          std::copy(b, b + n, x);
+
+          for (vcl_size_t k = 0; k < n; ++k)
+          {
+            vcl_size_t pivot_row = k;
+            for (vcl_size_t i = k + 1; i < n; ++i)
+              if (std::fabs(LU[i * n + k]) > std::fabs(LU[pivot_row * n + k]))
+                pivot_row = i;
+            if (LU[pivot_row * n + k] == 0)
+            {
+              std::fill(x, x + n, T(0));
+              tag_.result(system_id, true);
+              return;
+            }
+            if (pivot_row != k)
+            {
+              std::swap_ranges(LU + k * n + k, LU + k * n + n, LU + pivot_row * n + k);
+              std::swap(x[k], x[pivot_row]);
+            }
+
+            T inv_pivot = T(1) / LU[k * n + k];
+            for (vcl_size_t i = k + 1; i < n; ++i)
+            {
+              T factor = LU[i * n + k] * inv_pivot;
+              if (factor == 0)
+                continue;
+              for (vcl_size_t j = k + 1; j < n; ++j)
+                LU[i * n + j] -= factor * LU[k * n + j];
+              x[i] -= factor * x[k];
+            }
+          }
+
+          for (vcl_size_t k = n; k-- > 0; )
+          {
+            T sum = x[k];
+            for (vcl_size_t j = k + 1; j < n; ++j)
+              sum -= LU[k * n + j] * x[j];
+            x[k] = sum / LU[k * n + k];
+          }
+          tag_.result(system_id, false);
+        }
+
+        batched_dense_lu_tag const & tag_;
+      };
+
+
+      /** @brief Banded LU factorization with partial pivoting and substitution for a single system of the batch.
+      *
+      * Row i is stored with the columns i - kl, ..., i + ku + kl, where kl and ku denote the lower and upper bandwidth of the system.
+      * The additional kl superdiagonals hold the fill-in caused by row interchanges.
+      */
+      template <typename T>
+      struct batched_banded_lu_kernel
+      {
+        batched_banded_lu_kernel(batched_banded_lu_tag const & tag) : tag_(tag) {}
+
+        void operator()(batched_system<T> const & A, vcl_size_t system_id, T const * b, T * x, std::vector<T> & workspace) const
+        {
+          vcl_size_t n = A.size;
+
+          vcl_size_t kl = 0;
+          vcl_size_t ku = 0;
+          for (vcl_size_t row = 0; row < n; ++row)
+            for (unsigned int k = A.row_buffer[row]; k < A.row_buffer[row+1]; ++k)
+            {
+              vcl_size_t col = A.col_buffer[k];
+              if (col < row)
+                kl = std::max(kl, row - col);
+              else
+                ku = std::max(ku, col - row);
+            }
+
+          vcl_size_t width = 2 * kl + ku + 1;
+          workspace.assign(n * width, T(0));
+          T * LU = &(workspace[0]);   // entry (i, j) is located at LU[i * width + j + kl - i]
+
+          for (vcl_size_t row = 0; row < n; ++row)
+            for (unsigned int k = A.row_buffer[row]; k < A.row_buffer[row+1]; ++k)
+              LU[row * width + A.col_buffer[k] + kl - row] += A.elements[k];
+          std::copy(b, b + n, x);
+
+          for (vcl_size_t k = 0; k < n; ++k)
+          {
+            vcl_size_t last_row = std::min(n - 1, k + kl);
+            vcl_size_t last_col = std::min(n - 1, k + ku + kl);
+
+            vcl_size_t pivot_row = k;
+            for (vcl_size_t i = k + 1; i <= last_row; ++i)
+              if (std::fabs(LU[i * width + k + kl - i]) > std::fabs(LU[pivot_row * width + k + kl - pivot_row]))
+                pivot_row = i;
+            if (LU[pivot_row * width + k + kl - pivot_row] == 0)
+            {
+              std::fill(x, x + n, T(0));
+              tag_.result(system_id, true);
+              return;
+            }
+            if (pivot_row != k)
+            {
+              for (vcl_size_t j = k; j <= last_col; ++j)
+                std::swap(LU[k * width + j + kl - k], LU[pivot_row * width + j + kl - pivot_row]);
+              std::swap(x[k], x[pivot_row]);
+            }
+
+            T inv_pivot = T(1) / LU[k * width + kl];
+            for (vcl_size_t i = k + 1; i <= last_row; ++i)
+            {
+              T factor = LU[i * width + k + kl - i] * inv_pivot;
+              if (factor == 0)
+                continue;
+              for (vcl_size_t j = k + 1; j <= last_col; ++j)
+                LU[i * width + j + kl - i] -= factor * LU[k * width + j + kl - k];
+              x[i] -= factor * x[k];
+            }
+          }
+
+          for (vcl_size_t k = n; k-- > 0; )
+          {
+            vcl_size_t last_col = std::min(n - 1, k + ku + kl);
+            T sum = x[k];
+            for (vcl_size_t j = k + 1; j <= last_col; ++j)
+              sum -= LU[k * width + j + kl - k] * x[j];
+            x[k] = sum / LU[k * width + kl];
+          }
+          tag_.result(system_id, false);
+        }
+
+        batched_banded_lu_tag const & tag_;
+      };
+
+
+      /** @brief Applies the single-system solver 'kernel' to all systems of the batch.
+      *
+      * Systems are distributed dynamically over the OpenMP threads in chunks of VIENNACL_OPENMP_BATCHED_CHUNK_SIZE consecutive systems,
+      * each thread reuses its own workspace, so the data of a system stays in the private caches of the core while it is solved.
+      */
+      template <typename T, typename KernelType>
+      void batched_solve_impl(viennacl::batched_compressed_matrix<T> const & A, std::vector<T> const & rhs, std::vector<T> & result, KernelType const & kernel)
+      {
+        assert(rhs.size() == A.total_size() && bool("Size of right hand side does not match the batch in solve()"));
+
+        long num_systems = static_cast<long>(A.size());
+        result.resize(A.total_size());
+
+#ifdef VIENNACL_WITH_OPENMP
+        #pragma omp parallel if (num_systems > 1)
+#endif
+        {
+          std::vector<T> workspace;
+
+#ifdef VIENNACL_WITH_OPENMP
+          #pragma omp for schedule(dynamic, VIENNACL_OPENMP_BATCHED_CHUNK_SIZE)
+#endif
+          for (long i = 0; i < num_systems; ++i)
+          {
+            batched_system<T> system(A, static_cast<vcl_size_t>(i));
+            if (system.size > 0)
+              kernel(system, static_cast<vcl_size_t>(i), &(rhs[0]) + A.offset(i), &(result[0]) + A.offset(i), workspace);
+          }
+        }
+      }
+    }
+
+
+    /** @brief Solves all systems of the batch using the conjugate gradient method. The systems must be symmetric positive definite.
+    *
+    * @param A     The batch of system matrices
+    * @param rhs   The concatenated right hand sides of all systems
+    * @param tag   Solver configuration tag. Holds the iteration counts and errors of each system on return.
+    * @return The concatenated results of all systems
+    */
+    template <typename T>
+    std::vector<T> solve(viennacl::batched_compressed_matrix<T> const & A, std::vector<T> const & rhs, batched_cg_tag const & tag)
+    {
+      std::vector<T> result;
+      tag.resize(A.size());
+      detail::batched_solve_impl(A, rhs, result, detail::batched_cg_kernel<T>(tag));
+      return result;
+    }
+
+    /** @brief Solves all systems of the batch using the stabilized bi-conjugate gradient method.
+    *
+    * @param A     The batch of system matrices
+    * @param rhs   The concatenated right hand sides of all systems
+    * @param tag   Solver configuration tag. Holds the iteration counts and errors of each system on return.
+    * @return The concatenated results of all systems
+    */
+    template <typename T>
+    std::vector<T> solve(viennacl::batched_compressed_matrix<T> const & A, std::vector<T> const & rhs, batched_bicgstab_tag const & tag)
+    {
+      std::vector<T> result;
+      tag.resize(A.size());
+      detail::batched_solve_impl(A, rhs, result, detail::batched_bicgstab_kernel<T>(tag));
+      return result;
+    }
+
+    /** @brief Solves all systems of the batch using dense LU factorizations with partial pivoting.
+    *
+    * @param A     The batch of system matrices
+    * @param rhs   The concatenated right hand sides of all systems
+    * @param tag   Solver tag. Holds the information on singular systems on return.
+    * @return The concatenated results of all systems
+    */
+    template <typename T>
+    std::vector<T> solve(viennacl::batched_compressed_matrix<T> const & A, std::vector<T> const & rhs, batched_dense_lu_tag const & tag)
+    {
+      std::vector<T> result;
+      tag.resize(A.size());
+      detail::batched_solve_impl(A, rhs, result, detail::batched_dense_lu_kernel<T>(tag));
+      return result;
+    }
+
+    /** @brief Solves all systems of the batch using banded LU factorizations with partial pivoting.
+    *
+    * @param A     The batch of system matrices
+    * @param rhs   The concatenated right hand sides of all systems
+    * @param tag   Solver tag. Holds the information on singular systems on return.
+    * @return The concatenated results of all systems
+    */
+    template <typename T>
+    std::vector<T> solve(viennacl::batched_compressed_matrix<T> const & A, std::vector<T> const & rhs, batched_banded_lu_tag const & tag)
+    {
+      std::vector<T> result;
+      tag.resize(A.size());
+      detail::batched_solve_impl(A, rhs, result, detail::batched_banded_lu_kernel<T>(tag));
+      return result;
+    }
+
+  }
+}
+
+#endif
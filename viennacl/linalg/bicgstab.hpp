@@ -32,6 +32,7 @@
 #include "viennacl/traits/clear.hpp"
 #include "viennacl/traits/size.hpp"
 #include "viennacl/meta/result_of.hpp"
+#include "viennacl/linalg/detail/solver_workspace.hpp"
 
 namespace viennacl
 {
@@ -79,29 +80,56 @@ namespace viennacl
     };
 
 
-    /** @brief Implementation of the stabilized Bi-conjugate gradient solver
+    /** @brief Reusable storage for the temporary vectors of the stabilized Bi-conjugate gradient solver.
+    *
+    * Pass the same workspace object to repeated calls of solve() in order to avoid the allocation of temporaries in each call.
+    * The buffers are only reallocated if the size of the right hand side changes.
+    */
+    template <typename VectorType>
+    class bicgstab_workspace : public detail::solver_workspace_base<VectorType>
+    {
+        typedef detail::solver_workspace_base<VectorType>   base_type;
+
+      public:
+        /** @brief Makes the work vectors available for a system with the size of 'rhs'. Called by the solver. */
+        void prepare(VectorType const & rhs) { base_type::prepare(rhs, 6); }
+
+        VectorType & residual() { return base_type::vec(0); }
+        VectorType & p()        { return base_type::vec(1); }
+        VectorType & r0star()   { return base_type::vec(2); }
+        VectorType & tmp0()     { return base_type::vec(3); }
+        VectorType & tmp1()     { return base_type::vec(4); }
+        VectorType & s()        { return base_type::vec(5); }
+    };
+
+
+    /** @brief Implementation of the stabilized Bi-conjugate gradient solver without preconditioner using a user-provided workspace and result vector
     *
     * Following the description in "Iterative Methods for Sparse Linear Systems" by Y. Saad
     *
     * @param matrix     The system matrix
     * @param rhs        The load vector
     * @param tag        Solver configuration tag
-    * @return The result vector
+    * @param workspace  Storage for the temporaries, reused across calls
+    * @param result     The result vector. Must either be empty or have the size of rhs, in which case no memory is allocated
     */
     template <typename MatrixType, typename VectorType>
-    VectorType solve(const MatrixType & matrix, VectorType const & rhs, bicgstab_tag const & tag)
+    void solve(const MatrixType & matrix, VectorType const & rhs, bicgstab_tag const & tag, viennacl::linalg::no_precond, bicgstab_workspace<VectorType> & workspace, VectorType & result)
     {
       typedef typename viennacl::result_of::value_type<VectorType>::type        ScalarType;
       typedef typename viennacl::result_of::cpu_value_type<ScalarType>::type    CPU_ScalarType;
-      VectorType result = rhs;
+      if (viennacl::traits::size(result) != viennacl::traits::size(rhs))
+        result = rhs;
       viennacl::traits::clear(result);
 
-      VectorType residual = rhs;
-      VectorType p = rhs;
-      VectorType r0star = rhs;
-      VectorType tmp0 = rhs;
-      VectorType tmp1 = rhs;
-      VectorType s = rhs;
+      workspace.prepare(rhs);
+      VectorType & residual = workspace.residual();
+      VectorType & p        = workspace.p();
+      VectorType & r0star   = workspace.r0star();
+      VectorType & tmp0     = workspace.tmp0();
+      VectorType & tmp1     = workspace.tmp1();
+      VectorType & s        = workspace.s();
+      residual = rhs;
 
       CPU_ScalarType norm_rhs_host = viennacl::linalg::norm_2(residual);
       CPU_ScalarType ip_rr0star = norm_rhs_host * norm_rhs_host;
@@ -113,7 +141,7 @@ namespace viennacl
       CPU_ScalarType residual_norm = norm_rhs_host;
 
       if (norm_rhs_host == 0) //solution is zero if RHS norm is zero
-        return result;
+        return;
 
       bool restart_flag = true;
       vcl_size_t last_restart = 0;
@@ -164,17 +192,49 @@ namespace viennacl
 
       //store last error estimate:
       tag.error(residual_norm / norm_rhs_host);
+    }
 
+    /** @brief Implementation of the stabilized Bi-conjugate gradient solver without preconditioner using a user-provided workspace
+    *
+    * Following the description in "Iterative Methods for Sparse Linear Systems" by Y. Saad
+    *
+    * @param matrix     The system matrix
+    * @param rhs        The load vector
+    * @param tag        Solver configuration tag
+    * @param workspace  Storage for the temporaries, reused across calls
+    * @return The result vector. This is the only vector allocated per call, pass a result vector to the overload above to avoid it
+    */
+    template <typename MatrixType, typename VectorType>
+    VectorType solve(const MatrixType & matrix, VectorType const & rhs, bicgstab_tag const & tag, viennacl::linalg::no_precond, bicgstab_workspace<VectorType> & workspace)
+    {
+      VectorType result = rhs;
+      solve(matrix, rhs, tag, viennacl::linalg::no_precond(), workspace, result);
       return result;
     }
 
+    /** @brief Implementation of the stabilized Bi-conjugate gradient solver
+    *
+    * Following the description in "Iterative Methods for Sparse Linear Systems" by Y. Saad
+    *
+    * @param matrix     The system matrix
+    * @param rhs        The load vector
+    * @param tag        Solver configuration tag
+    * @return The result vector
+    */
+    template <typename MatrixType, typename VectorType>
+    VectorType solve(const MatrixType & matrix, VectorType const & rhs, bicgstab_tag const & tag)
+    {
+      bicgstab_workspace<VectorType> workspace;
+      return solve(matrix, rhs, tag, viennacl::linalg::no_precond(), workspace);
+    }
+
     template <typename MatrixType, typename VectorType>
     VectorType solve(const MatrixType & matrix, VectorType const & rhs, bicgstab_tag const & tag, viennacl::linalg::no_precond)
     {
       return solve(matrix, rhs, tag);
     }
 
-    /** @brief Implementation of the preconditioned stabilized Bi-conjugate gradient solver
+    /** @brief Implementation of the preconditioned stabilized Bi-conjugate gradient solver using a user-provided workspace and result vector
     *
     * Following the description of the unpreconditioned case in "Iterative Methods for Sparse Linear Systems" by Y. Saad
     *
@@ -182,23 +242,26 @@ namespace viennacl
     * @param rhs        The load vector
     * @param tag        Solver configuration tag
     * @param precond    A preconditioner. Precondition operation is done via member function apply()
-    * @return The result vector
+    * @param workspace  Storage for the temporaries, reused across calls
+    * @param result     The result vector. Must either be empty or have the size of rhs, in which case no memory is allocated
     */
     template <typename MatrixType, typename VectorType, typename PreconditionerType>
-    VectorType solve(const MatrixType & matrix, VectorType const & rhs, bicgstab_tag const & tag, PreconditionerType const & precond)
+    void solve(const MatrixType & matrix, VectorType const & rhs, bicgstab_tag const & tag, PreconditionerType const & precond, bicgstab_workspace<VectorType> & workspace, VectorType & result)
     {
       typedef typename viennacl::result_of::value_type<VectorType>::type        ScalarType;
       typedef typename viennacl::result_of::cpu_value_type<ScalarType>::type    CPU_ScalarType;
-      VectorType result = rhs;
+      if (viennacl::traits::size(result) != viennacl::traits::size(rhs))
+        result = rhs;
       viennacl::traits::clear(result);
 
-      VectorType residual = rhs;
-      VectorType r0star = residual;  //can be chosen arbitrarily in fact
-      VectorType tmp0 = rhs;
-      VectorType tmp1 = rhs;
-      VectorType s = rhs;
-
-      VectorType p = residual;
+      workspace.prepare(rhs);
+      VectorType & residual = workspace.residual();
+      VectorType & r0star   = workspace.r0star();  //can be chosen arbitrarily in fact
+      VectorType & tmp0     = workspace.tmp0();
+      VectorType & tmp1     = workspace.tmp1();
+      VectorType & s        = workspace.s();
+      VectorType & p        = workspace.p();
+      residual = rhs;
 
       CPU_ScalarType ip_rr0star = viennacl::linalg::norm_2(residual);
       CPU_ScalarType norm_rhs_host = viennacl::linalg::norm_2(residual);
@@ -209,7 +272,7 @@ namespace viennacl
       CPU_ScalarType residual_norm = norm_rhs_host;
 
       if (norm_rhs_host == 0) //solution is zero if RHS norm is zero
-        return result;
+        return;
 
       bool restart_flag = true;
       vcl_size_t last_restart = 0;
@@ -266,10 +329,44 @@ namespace viennacl
 
       //store last error estimate:
       tag.error(residual_norm / norm_rhs_host);
+    }
 
+    /** @brief Implementation of the preconditioned stabilized Bi-conjugate gradient solver using a user-provided workspace
+    *
+    * Following the description of the unpreconditioned case in "Iterative Methods for Sparse Linear Systems" by Y. Saad
+    *
+    * @param matrix     The system matrix
+    * @param rhs        The load vector
+    * @param tag        Solver configuration tag
+    * @param precond    A preconditioner. Precondition operation is done via member function apply()
+    * @param workspace  Storage for the temporaries, reused across calls
+    * @return The result vector. This is the only vector allocated per call, pass a result vector to the overload above to avoid it
+    */
+    template <typename MatrixType, typename VectorType, typename PreconditionerType>
+    VectorType solve(const MatrixType & matrix, VectorType const & rhs, bicgstab_tag const & tag, PreconditionerType const & precond, bicgstab_workspace<VectorType> & workspace)
+    {
+      VectorType result = rhs;
+      solve(matrix, rhs, tag, precond, workspace, result);
       return result;
     }
 
+    /** @brief Implementation of the preconditioned stabilized Bi-conjugate gradient solver
+    *
+    * Following the description of the unpreconditioned case in "Iterative Methods for Sparse Linear Systems" by Y. Saad
+    *
+    * @param matrix     The system matrix
+    * @param rhs        The load vector
+    * @param tag        Solver configuration tag
+    * @param precond    A preconditioner. Precondition operation is done via member function apply()
+    * @return The result vector
+    */
+    template <typename MatrixType, typename VectorType, typename PreconditionerType>
+    VectorType solve(const MatrixType & matrix, VectorType const & rhs, bicgstab_tag const & tag, PreconditionerType const & precond)
+    {
+      bicgstab_workspace<VectorType> workspace;
+      return solve(matrix, rhs, tag, precond, workspace);
+    }
+
   }
 }
 
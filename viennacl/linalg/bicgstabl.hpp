@@ -0,0 +1,231 @@
+#ifndef VIENNACL_LINALG_BICGSTABL_HPP_
+#define VIENNACL_LINALG_BICGSTABL_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/bicgstabl.hpp
+    @brief The BiCGStab(l) method, which combines BiCG with a minimal residual polynomial of degree l, is implemented here
+*/
+
+#include <vector>
+#include <cmath>
+#include "viennacl/forwards.h"
+#include "viennacl/vector.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/inner_prod.hpp"
+#include "viennacl/linalg/norm_2.hpp"
+#include "viennacl/traits/context.hpp"
+#include "viennacl/linalg/detail/small_dense.hpp"
+#include "viennacl/linalg/detail/multi_vector.hpp"
+
+namespace viennacl
+{
+  namespace linalg
+  {
+
+    /** @brief A tag for the BiCGStab(l) solver. Used for supplying solver parameters and for dispatching the solve() function
+    */
+    class bicgstabl_tag
+    {
+      public:
+        /** @brief The constructor
+        *
+        * @param tol              Relative tolerance for the residual (solver quits if ||r|| < tol * ||b||)
+        * @param max_iters        The maximum number of iterations, counted as matrix-vector products
+        * @param l                Degree of the minimal residual polynomial. l = 1 is mathematically equivalent to BiCGStab.
+        */
+        bicgstabl_tag(double tol = 1e-8, unsigned int max_iters = 400, vcl_size_t l = 2)
+          : tol_(tol), iterations_(max_iters), l_(l > 0 ? l : 1), iters_taken_(0), last_error_(0) {}
+
+        /** @brief Returns the relative tolerance */
+        double tolerance() const { return tol_; }
+        /** @brief Returns the maximum number of iterations */
+        unsigned int max_iterations() const { return iterations_; }
+        /** @brief Returns the degree of the minimal residual polynomial */
+        vcl_size_t degree() const { return l_; }
+
+        /** @brief Return the number of solver iterations (matrix-vector products): */
+        unsigned int iters() const { return iters_taken_; }
+        void iters(unsigned int i) const { iters_taken_ = i; }
+
+        /** @brief Returns the estimated relative error at the end of the solver run */
+        double error() const { return last_error_; }
+        /** @brief Sets the estimated relative error at the end of the solver run */
+        void error(double e) const { last_error_ = e; }
+
+      private:
+        double tol_;
+        unsigned int iterations_;
+        vcl_size_t l_;
+
+        //return values from solver
+        mutable unsigned int iters_taken_;
+        mutable double last_error_;
+    };
+
+
+    /** @brief Implementation of the BiCGStab(l) solver
+    *
+    * Following "BiCGstab(l) for linear equations involving unsymmetric matrices with complex spectrum" by G. L. G. Sleijpen and D. R. Fokkema, ETNA 1, 1993.
+    * The minimal residual part is carried out via the Gram matrix of the residuals r_0, ..., r_l, which is computed by l+1 multiple inner product kernels
+    * instead of the (l+1)(l+2)/2 individual reductions of the modified Gram-Schmidt formulation.
+    * The preconditioner is applied from the right, hence the error estimate refers to the unpreconditioned residual.
+    *
+    * @param matrix     The system matrix
+    * @param rhs        The load vector
+    * @param tag        Solver configuration tag
+    * @param precond    A preconditioner. Precondition operation is done via member function apply()
+    * @return The result vector
+    */
+    template <typename MatrixType, typename T, typename PreconditionerType>
+    viennacl::vector<T> solve(MatrixType const & matrix, viennacl::vector<T> const & rhs, bicgstabl_tag const & tag, PreconditionerType const & precond)
+    {
+      vcl_size_t n = rhs.size();
+      vcl_size_t l = tag.degree();
+      viennacl::context ctx = viennacl::traits::context(rhs);
+
+      // iterate on the right preconditioned system A M^{-1} y = b, with x = M^{-1} y:
+      viennacl::vector<T> result = viennacl::zero_vector<T>(n, ctx);
+      viennacl::vector<T> r0star = rhs;  //shadow residual
+      viennacl::vector<T> tmp(n, ctx);
+      viennacl::vector<T> dot_buffer(l + 1, ctx);
+      std::vector< viennacl::vector<T> > r(l + 1, viennacl::zero_vector<T>(n, ctx));
+      std::vector< viennacl::vector<T> > u(l + 1, viennacl::zero_vector<T>(n, ctx));
+      r[0] = rhs;
+
+      std::vector<viennacl::vector_base<T> const *> r_ptrs(l + 1);
+      for (vcl_size_t i=0; i<=l; ++i)
+        r_ptrs[i] = &(r[i]);
+      viennacl::vector_tuple<T> r_tuple(r_ptrs);
+
+      std::vector< std::vector<T> > gram(l + 1);
+      std::vector< std::vector<T> > Z;
+      std::vector< std::vector<T> > gamma;
+
+      tag.iters(0);
+      tag.error(0);
+
+      T norm_rhs = viennacl::linalg::norm_2(rhs);
+      if (norm_rhs == 0) //solution is zero if RHS norm is zero
+        return result;
+
+      T norm_res = norm_rhs;
+      T rho_0 = 1;
+      T alpha = 0;
+      T omega = 1;
+      bool done = false;
+      while (!done && tag.iters() < tag.max_iterations())
+      {
+        rho_0 = -omega * rho_0;
+
+        //
+        // BiCG part:
+        //
+        for (vcl_size_t j=0; j<l; ++j)
+        {
+          T rho_1 = viennacl::linalg::inner_prod(r[j], r0star);
+          if (rho_0 == 0)  //breakdown
+          {
+            done = true;
+            break;
+          }
+          T beta = alpha * rho_1 / rho_0;
+          rho_0 = rho_1;
+
+          for (vcl_size_t i=0; i<=j; ++i)
+          {
+            u[i] *= -beta;
+            u[i] += r[i];
+          }
+
+          tmp = u[j];
+          precond.apply(tmp);
+          u[j+1] = viennacl::linalg::prod(matrix, tmp);
+
+          T sigma = viennacl::linalg::inner_prod(u[j+1], r0star);
+          if (sigma == 0)  //breakdown
+          {
+            done = true;
+            break;
+          }
+          alpha = rho_0 / sigma;
+
+          for (vcl_size_t i=0; i<=j; ++i)
+            r[i] -= alpha * u[i+1];
+
+          tmp = r[j];
+          precond.apply(tmp);
+          r[j+1] = viennacl::linalg::prod(matrix, tmp);
+          tag.iters(tag.iters() + 2);
+
+          result += alpha * u[0];
+        }
+
+        if (done)
+          break;
+
+        //
+        // MR part: minimize ||r_0 - sum_j gamma_j r_j|| via the normal equations with the Gram matrix of r_1, ..., r_l
+        //
+        for (vcl_size_t j=0; j<=l; ++j)
+          detail::multi_inner_prod(r[j], r_tuple, dot_buffer, gram[j]);
+
+        detail::small_dense_resize(Z, l, l);
+        detail::small_dense_resize(gamma, l, 1);
+        for (vcl_size_t i=0; i<l; ++i)
+        {
+          for (vcl_size_t j=0; j<l; ++j)
+            Z[i][j] = gram[i+1][j+1];
+          gamma[i][0] = gram[i+1][0];
+        }
+        if (!detail::small_dense_solve(Z, gamma, l, vcl_size_t(1)))  //breakdown: residuals linearly dependent
+          break;
+
+        omega = gamma[l-1][0];
+        for (vcl_size_t j=1; j<=l; ++j)
+        {
+          T g = gamma[j-1][0];
+          result += g * r[j-1];
+          r[0]   -= g * r[j];
+          u[0]   -= g * u[j];
+        }
+
+        norm_res = viennacl::linalg::norm_2(r[0]);
+        if (norm_res / norm_rhs < tag.tolerance() || omega == 0)
+          break;
+      }
+
+      //store last error estimate:
+      tag.error(norm_res / norm_rhs);
+
+      precond.apply(result);
+      return result;
+    }
+
+    /** @brief Convenience overload of the solve() function using BiCGStab(l). Per default, no preconditioner is used
+    */
+    template <typename MatrixType, typename T>
+    viennacl::vector<T> solve(MatrixType const & matrix, viennacl::vector<T> const & rhs, bicgstabl_tag const & tag)
+    {
+      return solve(matrix, rhs, tag, viennacl::linalg::no_precond());
+    }
+
+  }
+}
+
+#endif
@@ -28,6 +28,7 @@
 #include <cmath>
 #include <limits>
 #include <cstddef>
+#include <algorithm>
 #include "viennacl/meta/result_of.hpp"
 
 namespace viennacl
@@ -58,117 +59,273 @@ namespace viennacl
         for (vcl_size_t i=0; i<src.size(); ++i)
           dest[i] = src[i];
       }
-    }
 
-    /**
-    *   @brief Implementation of the bisect-algorithm for the calculation of the eigenvalues of a tridiagonal matrix. Experimental - interface might change.
-    *
-    *   @param alphas       Elements of the main diagonal
-    *   @param betas        Elements of the secondary diagonal
-    *   @return             Returns the eigenvalues of the tridiagonal matrix defined by alpha and beta
-    */
-    template< typename VectorT >
-    std::vector<
-            typename viennacl::result_of::cpu_value_type<typename VectorT::value_type>::type
-            >
-    bisect(VectorT const & alphas, VectorT const & betas)
-    {
-      typedef typename viennacl::result_of::value_type<VectorT>::type           ScalarType;
-      typedef typename viennacl::result_of::cpu_value_type<ScalarType>::type    CPU_ScalarType;
-
-      vcl_size_t size = betas.size();
-      std::vector<CPU_ScalarType>  x_temp(size);
-
-
-      std::vector<CPU_ScalarType> beta_bisect;
-      std::vector<CPU_ScalarType> wu;
-
-      double rel_error = std::numeric_limits<CPU_ScalarType>::epsilon();
-      beta_bisect.push_back(0);
+      /** @brief Number of Sturm counts evaluated simultaneously in one pass over the tridiagonal matrix */
+      enum { bisect_batch_size = 8 };
 
-      for(vcl_size_t i = 1; i < size; i++){
-              beta_bisect.push_back(betas[i] * betas[i]);
-      }
-
-      double xmin = alphas[size - 1] - std::fabs(betas[size - 1]);
-      double xmax = alphas[size - 1] + std::fabs(betas[size - 1]);
-
-      for(vcl_size_t i = 0; i < size - 1; i++)
+      /** @brief An interval [lower, upper) of the spectrum together with the number of eigenvalues smaller than its bounds */
+      template <typename ScalarType>
+      struct bisect_interval
       {
-        double h = std::fabs(betas[i]) + std::fabs(betas[i + 1]);
-        if (alphas[i] + h > xmax)
-          xmax = alphas[i] + h;
-        if (alphas[i] - h < xmin)
-          xmin = alphas[i] - h;
-      }
-
-
-      double eps1 = 1e-6;
-      /*double eps2 = (xmin + xmax > 0) ? (rel_error * xmax) : (-rel_error * xmin);
-      if(eps1 <= 0)
-        eps1 = eps2;
-      else
-        eps2 = 0.5 * eps1 + 7.0 * eps2; */
+        bisect_interval(ScalarType lo, ScalarType up, vcl_size_t count_lo, vcl_size_t count_up)
+          : lower(lo), upper(up), count_lower(count_lo), count_upper(count_up) {}
 
-      double x0 = xmax;
+        ScalarType lower;
+        ScalarType upper;
+        vcl_size_t count_lower;
+        vcl_size_t count_upper;
+      };
 
-      for(vcl_size_t i = 0; i < size; i++)
+      /** @brief Evaluates the Sturm counts, i.e. the number of eigenvalues smaller than x[l], for bisect_batch_size shifts x[0], x[1], ... in a single pass over the matrix.
+      *
+      * The shifts are independent of each other, hence the inner loop over the shifts is vectorized by the compiler.
+      *
+      * @param d        Diagonal of the tridiagonal matrix
+      * @param e2       Squared off-diagonal elements, e2[i] couples i-1 and i. e2[0] is not referenced
+      * @param n        Size of the matrix
+      * @param pivmin   Smallest admissible magnitude of a pivot
+      * @param x        The shifts
+      * @param counts   The Sturm counts on exit
+      */
+      template <typename ScalarType>
+      void sturm_counts(ScalarType const * d, ScalarType const * e2, vcl_size_t n, ScalarType pivmin, ScalarType const * x, vcl_size_t * counts)
       {
-        x_temp[i] = xmax;
-        wu.push_back(xmin);
-      }
+        ScalarType q[bisect_batch_size];
+        vcl_size_t c[bisect_batch_size];
 
-      for(long k = static_cast<long>(size) - 1; k >= 0; --k)
-      {
-        double xu = xmin;
-        for(long i = k; i >= 0; --i)
+        for (vcl_size_t l = 0; l < bisect_batch_size; ++l)
+        {
+          ScalarType t = d[0] - x[l];
+          t = (std::fabs(t) < pivmin) ? -pivmin : t;
+          q[l] = t;
+          c[l] = (t < 0) ? 1 : 0;
+        }
+
+        for (vcl_size_t i = 1; i < n; ++i)
         {
-          if(xu < wu[k-i])
+          ScalarType d_i  = d[i];
+          ScalarType e2_i = e2[i];
+          for (vcl_size_t l = 0; l < bisect_batch_size; ++l)
           {
-            xu = wu[i];
-            break;
+            ScalarType t = d_i - x[l] - e2_i / q[l];
+            t = (std::fabs(t) < pivmin) ? -pivmin : t;
+            q[l] = t;
+            c[l] += (t < 0) ? 1 : 0;
           }
         }
 
-        if(x0 > x_temp[k])
-          x0 = x_temp[k];
+        for (vcl_size_t l = 0; l < bisect_batch_size; ++l)
+          counts[l] = c[l];
+      }
+
+      /** @brief Computes the eigenvalues with indices first, ..., last-1 (in ascending order) within the interval [lower, upper) by bisection.
+      *
+      * All intervals of one bisection step are processed together: Their midpoints are evaluated in batches of bisect_batch_size shifts, and the batches are distributed dynamically over the threads.
+      * Results therefore do not depend on the number of threads.
+      *
+      * @param d             Diagonal of the tridiagonal matrix
+      * @param e2            Squared off-diagonal elements, e2[i] couples i-1 and i
+      * @param n             Size of the matrix
+      * @param start         Initial interval, which must contain the requested eigenvalues
+      * @param first         Index of the first requested eigenvalue
+      * @param last          Index past the last requested eigenvalue
+      * @param abstol        Absolute tolerance for the width of the final intervals
+      * @param pivmin        Smallest admissible magnitude of a pivot in the Sturm sequences
+      * @param result        The eigenvalue with index i is written to result[i - first]
+      */
+      template <typename ScalarType>
+      void bisect_intervals(ScalarType const * d, ScalarType const * e2, vcl_size_t n, bisect_interval<ScalarType> const & start,
+                            vcl_size_t first, vcl_size_t last, ScalarType abstol, ScalarType pivmin, ScalarType * result)
+      {
+        ScalarType eps = std::numeric_limits<ScalarType>::epsilon();
+        std::vector<bisect_interval<ScalarType> > current, next;
+        std::vector<ScalarType> midpoints;
+        std::vector<vcl_size_t> counts;
 
-        double x1 = (xu + x0) / 2.0;
-        while (x0 - xu > 2.0 * rel_error * (std::fabs(xu) + std::fabs(x0)) + eps1)
+        current.push_back(start);
+        while (!current.empty())
         {
-          vcl_size_t a = 0;
-          double q = 1;
-          for(vcl_size_t i = 0; i < size; i++)
+          vcl_size_t num_batches = (current.size() + bisect_batch_size - 1) / bisect_batch_size;
+          midpoints.resize(num_batches * bisect_batch_size);
+          counts.resize(num_batches * bisect_batch_size);
+          for (vcl_size_t i = 0; i < midpoints.size(); ++i)
           {
-            if(q != 0)
-              q = alphas[i] - x1 - beta_bisect[i] / q;
-            else
-              q = alphas[i] - x1 - std::fabs(betas[i] / rel_error);
-
-            if(q < 0)
-              a++;
+            bisect_interval<ScalarType> const & I = current[std::min(i, current.size() - 1)];
+            midpoints[i] = (I.lower + I.upper) / 2;
           }
 
-          if (a <= static_cast<vcl_size_t>(k))
+#ifdef VIENNACL_WITH_OPENMP
+          #pragma omp parallel for schedule(dynamic) if (num_batches > 1)
+#endif
+          for (long b = 0; b < static_cast<long>(num_batches); ++b)
+            sturm_counts(d, e2, n, pivmin,
+                         &(midpoints[static_cast<vcl_size_t>(b) * bisect_batch_size]),
+                         &(counts[static_cast<vcl_size_t>(b) * bisect_batch_size]));
+
+          next.clear();
+          for (vcl_size_t i = 0; i < current.size(); ++i)
           {
-            xu = x1;
-            if(a < 1)
-              wu[0] = x1;
-            else
+            bisect_interval<ScalarType> const & I = current[i];
+            ScalarType mid = midpoints[i];
+            vcl_size_t count_mid = std::min(std::max(counts[i], I.count_lower), I.count_upper);
+
+            bisect_interval<ScalarType> halves[2] = { bisect_interval<ScalarType>(I.lower, mid, I.count_lower, count_mid),
+                                                      bisect_interval<ScalarType>(mid, I.upper, count_mid, I.count_upper) };
+            for (vcl_size_t h = 0; h < 2; ++h)
             {
-              wu[a] = x1;
-              if(x_temp[a - 1] > x1)
-                  x_temp[a - 1] = x1;
+              bisect_interval<ScalarType> const & H = halves[h];
+              if (H.count_lower == H.count_upper || H.count_upper <= first || H.count_lower >= last)
+                continue;
+
+              ScalarType tol = std::max(abstol, 2 * eps * std::max(std::fabs(H.lower), std::fabs(H.upper)));
+              ScalarType H_mid = (H.lower + H.upper) / 2;
+              if (H.upper - H.lower <= tol || H_mid <= H.lower || H_mid >= H.upper)
+              {
+                for (vcl_size_t k = std::max(H.count_lower, first); k < std::min(H.count_upper, last); ++k)
+                  result[k - first] = H_mid;
+              }
+              else
+                next.push_back(H);
             }
           }
-          else
-            x0 = x1;
+          current.swap(next);
+        }
+      }
+
+      /** @brief Sets up the squared off-diagonal, the Gerschgorin interval, and the tolerances for bisection. Returns the size of the matrix. */
+      template <typename VectorT, typename ScalarType>
+      vcl_size_t bisect_setup(VectorT const & alphas, VectorT const & betas,
+                              std::vector<ScalarType> & d, std::vector<ScalarType> & e2,
+                              ScalarType & lower, ScalarType & upper, ScalarType & abstol, ScalarType & pivmin)
+      {
+        vcl_size_t n = betas.size();
+        d.resize(n);
+        e2.resize(n);
+        std::vector<ScalarType> e_abs(n + 1);
+        for (vcl_size_t i = 0; i < n; ++i)
+        {
+          d[i] = static_cast<ScalarType>(alphas[i]);
+          e_abs[i] = (i > 0) ? std::fabs(static_cast<ScalarType>(betas[i])) : 0;
+          e2[i] = e_abs[i] * e_abs[i];
+        }
 
-          x1 = (xu + x0) / 2.0;
+        ScalarType e2_max = 1;
+        lower = (n > 0) ? d[0] : 0;
+        upper = lower;
+        for (vcl_size_t i = 0; i < n; ++i)
+        {
+          ScalarType r = e_abs[i] + e_abs[i + 1];
+          lower = std::min(lower, d[i] - r);
+          upper = std::max(upper, d[i] + r);
+          e2_max = std::max(e2_max, e2[i]);
         }
-        x_temp[k] = x1;
+
+        ScalarType eps = std::numeric_limits<ScalarType>::epsilon();
+        ScalarType tnorm = std::max(std::fabs(lower), std::fabs(upper));
+        pivmin = std::numeric_limits<ScalarType>::min() * e2_max;
+        abstol = eps * tnorm;
+
+        // widen the interval such that no eigenvalue is lost due to round-off in the Sturm counts (cf. LAPACK's xSTEBZ):
+        ScalarType fudge = ScalarType(2.1) * (eps * tnorm * static_cast<ScalarType>(n) + 2 * pivmin);
+        lower -= fudge;
+        upper += fudge;
+
+        return n;
       }
-      return x_temp;
+    }
+
+    /**
+    *   @brief Computes the eigenvalues of a tridiagonal matrix with indices first, ..., last-1 in ascending order by bisection. Experimental - interface might change.
+    *
+    *   @param alphas       Elements of the main diagonal
+    *   @param betas        Elements of the secondary diagonal, betas[i] couples the rows i-1 and i. betas[0] is not referenced
+    *   @param first        Index of the first eigenvalue (counted from the smallest eigenvalue)
+    *   @param last         Index past the last eigenvalue
+    *   @return             Returns the last-first eigenvalues in ascending order
+    */
+    template< typename VectorT >
+    std::vector<
+            typename viennacl::result_of::cpu_value_type<typename VectorT::value_type>::type
+            >
+    bisect_by_index(VectorT const & alphas, VectorT const & betas, vcl_size_t first, vcl_size_t last)
+    {
+      typedef typename viennacl::result_of::value_type<VectorT>::type           ScalarType;
+      typedef typename viennacl::result_of::cpu_value_type<ScalarType>::type    CPU_ScalarType;
+
+      std::vector<CPU_ScalarType> d, e2;
+      CPU_ScalarType lower, upper, abstol, pivmin;
+      vcl_size_t n = detail::bisect_setup(alphas, betas, d, e2, lower, upper, abstol, pivmin);
+
+      last = std::min(last, n);
+      std::vector<CPU_ScalarType> eigenvalues;
+      if (first >= last)
+        return eigenvalues;
+
+      eigenvalues.resize(last - first);
+      detail::bisect_intervals(&(d[0]), &(e2[0]), n, detail::bisect_interval<CPU_ScalarType>(lower, upper, 0, n),
+                               first, last, abstol, pivmin, &(eigenvalues[0]));
+      return eigenvalues;
+    }
+
+    /**
+    *   @brief Computes all eigenvalues of a tridiagonal matrix in the interval [lower, upper) by bisection. Experimental - interface might change.
+    *
+    *   @param alphas       Elements of the main diagonal
+    *   @param betas        Elements of the secondary diagonal, betas[i] couples the rows i-1 and i. betas[0] is not referenced
+    *   @param lower        Lower bound of the interval
+    *   @param upper        Upper bound of the interval
+    *   @return             Returns the eigenvalues in the interval in ascending order
+    */
+    template< typename VectorT >
+    std::vector<
+            typename viennacl::result_of::cpu_value_type<typename VectorT::value_type>::type
+            >
+    bisect_by_value(VectorT const & alphas, VectorT const & betas,
+                    typename viennacl::result_of::cpu_value_type<typename VectorT::value_type>::type lower,
+                    typename viennacl::result_of::cpu_value_type<typename VectorT::value_type>::type upper)
+    {
+      typedef typename viennacl::result_of::value_type<VectorT>::type           ScalarType;
+      typedef typename viennacl::result_of::cpu_value_type<ScalarType>::type    CPU_ScalarType;
+
+      std::vector<CPU_ScalarType> d, e2;
+      CPU_ScalarType gl, gu, abstol, pivmin;
+      vcl_size_t n = detail::bisect_setup(alphas, betas, d, e2, gl, gu, abstol, pivmin);
+
+      std::vector<CPU_ScalarType> eigenvalues;
+      lower = std::max(lower, gl);
+      upper = std::min(upper, gu);
+      if (n == 0 || lower >= upper)
+        return eigenvalues;
+
+      CPU_ScalarType x[detail::bisect_batch_size];
+      vcl_size_t counts[detail::bisect_batch_size];
+      for (vcl_size_t l = 0; l < detail::bisect_batch_size; ++l)
+        x[l] = (l == 0) ? lower : upper;
+      detail::sturm_counts(&(d[0]), &(e2[0]), n, pivmin, x, counts);
+
+      if (counts[0] >= counts[1])
+        return eigenvalues;
+
+      eigenvalues.resize(counts[1] - counts[0]);
+      detail::bisect_intervals(&(d[0]), &(e2[0]), n, detail::bisect_interval<CPU_ScalarType>(lower, upper, counts[0], counts[1]),
+                               counts[0], counts[1], abstol, pivmin, &(eigenvalues[0]));
+      return eigenvalues;
+    }
+
+    /**
+    *   @brief Implementation of the bisect-algorithm for the calculation of the eigenvalues of a tridiagonal matrix. Experimental - interface might change.
+    *
+    *   @param alphas       Elements of the main diagonal
+    *   @param betas        Elements of the secondary diagonal
+    *   @return             Returns the eigenvalues of the tridiagonal matrix defined by alpha and beta in ascending order
+    */
+    template< typename VectorT >
+    std::vector<
+            typename viennacl::result_of::cpu_value_type<typename VectorT::value_type>::type
+            >
+    bisect(VectorT const & alphas, VectorT const & betas)
+    {
+      return bisect_by_index(alphas, betas, 0, betas.size());
     }
 
   } // end namespace linalg
@@ -0,0 +1,255 @@
+#ifndef VIENNACL_LINALG_BLOCK_CG_HPP_
+#define VIENNACL_LINALG_BLOCK_CG_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/block_cg.hpp
+    @brief The block conjugate gradient method for multiple right hand sides is implemented here
+*/
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include "viennacl/forwards.h"
+#include "viennacl/matrix.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/traits/context.hpp"
+#include "viennacl/linalg/detail/small_dense.hpp"
+#include "viennacl/linalg/detail/multi_vector.hpp"
+
+namespace viennacl
+{
+  namespace linalg
+  {
+
+    /** @brief A tag for the block conjugate gradient solver. Used for supplying solver parameters and for dispatching the solve() function
+    */
+    class block_cg_tag
+    {
+      public:
+        /** @brief The constructor
+        *
+        * @param tol              Relative tolerance for the residual of each right hand side (column j is converged if ||r_j|| < tol * ||b_j||)
+        * @param max_iterations   The maximum number of iterations
+        */
+        block_cg_tag(double tol = 1e-8, unsigned int max_iterations = 300) : tol_(tol), iterations_(max_iterations), iters_taken_(0), last_error_(0) {}
+
+        /** @brief Returns the relative tolerance */
+        double tolerance() const { return tol_; }
+        /** @brief Returns the maximum number of iterations */
+        unsigned int max_iterations() const { return iterations_; }
+
+        /** @brief Return the number of solver iterations: */
+        unsigned int iters() const { return iters_taken_; }
+        void iters(unsigned int i) const { iters_taken_ = i; }
+
+        /** @brief Returns the largest estimated relative error over all right hand sides at the end of the solver run */
+        double error() const { return last_error_; }
+        /** @brief Sets the estimated relative error at the end of the solver run */
+        void error(double e) const { last_error_ = e; }
+
+        /** @brief Returns the estimated relative error for each right hand side at the end of the solver run */
+        std::vector<double> const & errors() const { return errors_; }
+        /** @brief Returns the number of iterations after which each right hand side has converged (or the total number of iterations if not converged) */
+        std::vector<unsigned int> const & column_iters() const { return column_iters_; }
+
+        /** @brief Resets the per-column statistics. Called by the solver. */
+        void reset_column_info(vcl_size_t num_columns) const
+        {
+          errors_.assign(num_columns, 0.0);
+          column_iters_.assign(num_columns, 0);
+        }
+        void column_info(vcl_size_t j, double err, unsigned int iters) const { errors_[j] = err; column_iters_[j] = iters; }
+
+      private:
+        double tol_;
+        unsigned int iterations_;
+
+        //return values from solver
+        mutable unsigned int iters_taken_;
+        mutable double last_error_;
+        mutable std::vector<double> errors_;
+        mutable std::vector<unsigned int> column_iters_;
+    };
+
+
+    namespace detail
+    {
+      template <typename MatrixType>
+      void block_cg_apply_precond(viennacl::linalg::no_precond const &, MatrixType &) {}
+
+      template <typename PreconditionerType, typename MatrixType>
+      void block_cg_apply_precond(PreconditionerType const & precond, MatrixType & Z) { precond.apply(Z); }
+
+      /** @brief Computes coeffs = sign * (P^T Q)^{-1} * coeffs for the leading 'rank' rows. Rows from 'rank' on are zeroed. Returns false if P^T Q is singular. */
+      template <typename T>
+      bool block_cg_projected_solve(std::vector< std::vector<T> > const & PtQ,
+                                    std::vector< std::vector<T> > & coeffs,
+                                    vcl_size_t rank, T sign)
+      {
+        std::vector< std::vector<T> > A = PtQ;
+        vcl_size_t s = coeffs.size();
+        vcl_size_t m = s > 0 ? coeffs[0].size() : 0;
+        bool success = small_dense_solve(A, coeffs, rank, m);
+        for (vcl_size_t i=0; i<s; ++i)
+          for (vcl_size_t j=0; j<m; ++j)
+            coeffs[i][j] = (i < rank && success) ? sign * coeffs[i][j] : T(0);
+        return success;
+      }
+    }
+
+
+    /** @brief Implementation of the (preconditioned) block conjugate gradient solver for multiple right hand sides.
+    *
+    * Follows the breakdown-free block CG method by Ji and Li (2017), which orthonormalizes the block of search directions in each step and drops linearly dependent directions.
+    * Each iteration requires a single sparse matrix-matrix product and a few reductions of tall-skinny matrices to small dense matrices.
+    * Right hand sides which have converged are deflated from the iteration.
+    *
+    * @param matrix     The system matrix (any sparse matrix type supporting prod() with a dense matrix)
+    * @param rhs        The right hand sides, one per column
+    * @param tag        Solver configuration tag
+    * @param precond    A preconditioner with a multi-vector apply(viennacl::matrix_base<T> &) member function
+    * @return The matrix of solution vectors
+    */
+    template <typename MatrixType, typename T, typename F, typename PreconditionerType>
+    viennacl::matrix<T, F> solve(MatrixType const & matrix, viennacl::matrix<T, F> const & rhs, block_cg_tag const & tag, PreconditionerType const & precond)
+    {
+      typedef viennacl::matrix<T, F>                          MultiVectorType;
+      typedef viennacl::matrix<T, viennacl::column_major>     SmallMatrixType;
+
+      vcl_size_t n = rhs.size1();
+      vcl_size_t s = rhs.size2();
+      viennacl::context ctx = viennacl::traits::context(rhs);
+
+      MultiVectorType result(n, s, ctx);
+      MultiVectorType residual = rhs;
+      MultiVectorType buffer_1(n, s, ctx);
+      MultiVectorType buffer_2(n, s, ctx);
+      MultiVectorType Q(n, s, ctx);
+
+      SmallMatrixType G_dev(s, s, ctx);
+      SmallMatrixType coeffs_dev(s, s, ctx);
+      std::vector< std::vector<T> > PtQ;
+      std::vector< std::vector<T> > coeffs;
+
+      tag.iters(0);
+      tag.error(0);
+      tag.reset_column_info(s);
+
+      // column norms of the right hand side:
+      std::vector<T> norm_rhs;
+      std::vector<T> norm_res;
+      detail::column_norms(residual, norm_rhs);
+      std::vector<bool> converged(s);
+      vcl_size_t num_converged = 0;
+      for (vcl_size_t j=0; j<s; ++j)
+      {
+        converged[j] = (norm_rhs[j] <= 0); //solution is zero if RHS norm is zero
+        if (converged[j])
+          ++num_converged;
+      }
+      if (num_converged == s)
+        return result;
+
+      T rank_tol = detail::block_orthonormalize_tolerance<T>(s);
+
+      // initial search directions: P = orth(M^{-1} R)
+      MultiVectorType * P = &buffer_1;
+      MultiVectorType * Z = &buffer_2;
+      *P = residual;
+      detail::block_cg_apply_precond(precond, *P);
+      vcl_size_t rank = detail::block_orthonormalize(*P, *Z, G_dev, rank_tol);
+
+      for (unsigned int i = 0; i < tag.max_iterations(); ++i)
+      {
+        tag.iters(i+1);
+
+        Q = viennacl::linalg::prod(matrix, *P);
+
+        // alpha = (P^T Q)^{-1} P^T R
+        detail::gram_matrix(*P, Q, G_dev, PtQ);
+        detail::gram_matrix(*P, residual, G_dev, coeffs);
+        if (!detail::block_cg_projected_solve(PtQ, coeffs, rank, T(1)))  //breakdown: P^T A P singular (matrix not SPD?)
+          break;
+        viennacl::copy(coeffs, coeffs_dev);
+
+        result   += viennacl::linalg::prod(*P, coeffs_dev);
+        residual -= viennacl::linalg::prod(Q, coeffs_dev);
+
+        // per-column convergence check. Converged columns are removed from the residual block and hence no longer contribute new search directions:
+        detail::column_norms(residual, norm_res);
+        double max_error = 0;
+        for (vcl_size_t j=0; j<s; ++j)
+        {
+          if (converged[j])
+            continue;
+
+          double rel_res = static_cast<double>(norm_res[j] / norm_rhs[j]);
+          tag.column_info(j, rel_res, i+1);
+          max_error = std::max(max_error, rel_res);
+          if (rel_res < tag.tolerance())
+          {
+            converged[j] = true;
+            ++num_converged;
+            viennacl::vector_base<T> r_j = detail::column_view(residual, j);
+            r_j.clear();
+          }
+        }
+        tag.error(max_error);
+
+        if (num_converged == s)
+          break;
+
+        // beta = -(P^T Q)^{-1} Q^T Z
+        *Z = residual;
+        detail::block_cg_apply_precond(precond, *Z);
+        detail::gram_matrix(Q, *Z, G_dev, coeffs);
+        if (!detail::block_cg_projected_solve(PtQ, coeffs, rank, T(-1)))
+          break;
+        viennacl::copy(coeffs, coeffs_dev);
+
+        // P = orth(Z + P beta)
+        *Z += viennacl::linalg::prod(*P, coeffs_dev);
+        rank = detail::block_orthonormalize(*Z, Q, G_dev, rank_tol);
+        std::swap(P, Z);
+
+        if (rank == 0)  //no more search directions available
+          break;
+      }
+
+      //recompute the largest error over the remaining columns:
+      double max_error = 0;
+      for (vcl_size_t j=0; j<s; ++j)
+        max_error = std::max(max_error, tag.errors()[j]);
+      tag.error(max_error);
+
+      return result;
+    }
+
+    /** @brief Convenience overload of the block conjugate gradient solver without preconditioner
+    */
+    template <typename MatrixType, typename T, typename F>
+    viennacl::matrix<T, F> solve(MatrixType const & matrix, viennacl::matrix<T, F> const & rhs, block_cg_tag const & tag)
+    {
+      return solve(matrix, rhs, tag, viennacl::linalg::no_precond());
+    }
+
+  }
+}
+
+#endif
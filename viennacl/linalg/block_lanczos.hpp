@@ -0,0 +1,455 @@
+#ifndef VIENNACL_LINALG_BLOCK_LANCZOS_HPP_
+#define VIENNACL_LINALG_BLOCK_LANCZOS_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/block_lanczos.hpp
+    @brief The thick-restart block Lanczos method for extremal eigenpairs of symmetric (sparse) matrices. Experimental.
+*/
+
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include "viennacl/forwards.h"
+#include "viennacl/matrix.hpp"
+#include "viennacl/matrix_proxy.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/traits/size.hpp"
+#include "viennacl/traits/context.hpp"
+#include "viennacl/linalg/detail/small_dense.hpp"
+#include "viennacl/linalg/detail/multi_vector.hpp"
+#include "viennacl/linalg/tridiagonal_reduction.hpp"
+
+namespace viennacl
+{
+  namespace linalg
+  {
+
+    /** @brief A tag for the block Lanczos method. Used for supplying parameters and for dispatching the eig() function
+    */
+    class block_lanczos_tag
+    {
+      public:
+
+        enum
+        {
+          full_reorthogonalization = 0,
+          selective_reorthogonalization
+        };
+
+        enum
+        {
+          largest = 0,
+          smallest
+        };
+
+        /** @brief The constructor
+        *
+        * @param numeig          Number of eigenpairs to be computed
+        * @param block_size      Number of vectors the operator is applied to at once
+        * @param max_basis       Maximum number of basis vectors kept in memory. The method is restarted once the basis is full
+        * @param tol             Relative tolerance for the residual norm of each eigenpair
+        * @param max_restarts    Maximum number of restarts
+        * @param reorth          full_reorthogonalization or selective_reorthogonalization
+        * @param which           Compute the largest or the smallest eigenvalues
+        */
+        block_lanczos_tag(vcl_size_t numeig = 10,
+                          vcl_size_t block_size = 4,
+                          vcl_size_t max_basis = 100,
+                          double tol = 1e-8,
+                          unsigned int max_restarts = 100,
+                          int reorth = full_reorthogonalization,
+                          int which = largest)
+          : num_eigenvalues_(numeig), block_size_(block_size), max_basis_size_(max_basis), tol_(tol), max_restarts_(max_restarts),
+            reorth_(reorth), which_(which), restarts_(0), matrix_products_(0), num_converged_(0) {}
+
+        /** @brief Sets the number of eigenpairs */
+        void num_eigenvalues(vcl_size_t numeig) { num_eigenvalues_ = numeig; }
+        /** @brief Returns the number of eigenpairs */
+        vcl_size_t num_eigenvalues() const { return num_eigenvalues_; }
+
+        /** @brief Sets the block size */
+        void block_size(vcl_size_t s) { block_size_ = s; }
+        /** @brief Returns the block size */
+        vcl_size_t block_size() const { return block_size_; }
+
+        /** @brief Sets the maximum number of basis vectors */
+        void max_basis_size(vcl_size_t m) { max_basis_size_ = m; }
+        /** @brief Returns the maximum number of basis vectors */
+        vcl_size_t max_basis_size() const { return max_basis_size_; }
+
+        /** @brief Returns the relative tolerance */
+        double tolerance() const { return tol_; }
+
+        /** @brief Returns the maximum number of restarts */
+        unsigned int max_restarts() const { return max_restarts_; }
+
+        /** @brief Sets the reorthogonalization strategy */
+        void reorthogonalization(int r) { reorth_ = r; }
+        /** @brief Returns the reorthogonalization strategy */
+        int reorthogonalization() const { return reorth_; }
+
+        /** @brief Sets whether the largest or the smallest eigenvalues are computed */
+        void which(int w) { which_ = w; }
+        /** @brief Returns whether the largest or the smallest eigenvalues are computed */
+        int which() const { return which_; }
+
+        /** @brief Returns the number of restarts of the last run */
+        unsigned int restarts() const { return restarts_; }
+        void restarts(unsigned int r) const { restarts_ = r; }
+
+        /** @brief Returns the number of vectors the operator was applied to in the last run */
+        vcl_size_t matrix_products() const { return matrix_products_; }
+        void matrix_products(vcl_size_t num) const { matrix_products_ = num; }
+
+        /** @brief Returns the number of converged eigenpairs of the last run */
+        vcl_size_t num_converged() const { return num_converged_; }
+        void num_converged(vcl_size_t num) const { num_converged_ = num; }
+
+        /** @brief Returns the residual norms ||A x_i - lambda_i x_i|| of the computed eigenpairs */
+        std::vector<double> const & residuals() const { return residuals_; }
+        void residuals(std::vector<double> const & r) const { residuals_ = r; }
+
+      private:
+        vcl_size_t num_eigenvalues_;
+        vcl_size_t block_size_;
+        vcl_size_t max_basis_size_;
+        double tol_;
+        unsigned int max_restarts_;
+        int reorth_;
+        int which_;
+
+        //return values from solver
+        mutable unsigned int restarts_;
+        mutable vcl_size_t matrix_products_;
+        mutable vcl_size_t num_converged_;
+        mutable std::vector<double> residuals_;
+    };
+
+
+    namespace detail
+    {
+      /** @brief Orthogonalizes W against the columns first, ..., last-1 of V (classical Gram-Schmidt by two matrix-matrix products) and adds the coefficients V(:, first:last)^T W to the rows first, ..., last-1 of the columns col, col+1, ... of T_proj (if not NULL). */
+      template <typename T>
+      void block_lanczos_project_out(viennacl::matrix<T, viennacl::column_major> & V, vcl_size_t first, vcl_size_t last,
+                                     viennacl::matrix_base<T> & W, std::vector< std::vector<T> > * T_proj, vcl_size_t col)
+      {
+        if (first >= last)
+          return;
+
+        viennacl::matrix_range<viennacl::matrix<T, viennacl::column_major> > V_R(V, viennacl::range(0, V.size1()), viennacl::range(first, last));
+        viennacl::matrix<T, viennacl::column_major> H_dev(last - first, W.size2(), viennacl::traits::context(V));
+        std::vector< std::vector<T> > H;
+        gram_matrix(V_R, W, H_dev, H);
+        W -= viennacl::linalg::prod(V_R, H_dev);
+
+        if (T_proj)
+          for (vcl_size_t i=0; i<H.size(); ++i)
+            for (vcl_size_t j=0; j<H[i].size(); ++j)
+              (*T_proj)[first + i][col + j] += H[i][j];
+      }
+
+      /** @brief Computes the eigenpairs of a small symmetric matrix given by nested std::vectors. Eigenvalues in ascending order, Y is column-major. */
+      template <typename T>
+      void block_lanczos_rayleigh_ritz(std::vector< std::vector<T> > const & T_proj, vcl_size_t c, std::vector<T> & theta, std::vector<T> & Y)
+      {
+        std::vector<T> S(c * c);
+        for (vcl_size_t j=0; j<c; ++j)
+          for (vcl_size_t i=0; i<c; ++i)
+            S[j * c + i] = (T_proj[i][j] + T_proj[j][i]) / T(2);
+        theta.resize(c);
+        Y.resize(c * c);
+        symmetric_eigen_host(&(S[0]), c, &(theta[0]), &(Y[0]));
+      }
+
+      /** @brief Fallback for matrices too small for the block Lanczos method: The matrix is assembled by a product with the identity and solved densely. */
+      template <typename MatrixT, typename T>
+      void block_lanczos_dense(MatrixT const & A, vcl_size_t n, std::vector<T> & theta, viennacl::matrix<T, viennacl::column_major> & V, std::vector<T> & Y)
+      {
+        std::vector< std::vector<T> > I(n, std::vector<T>(n));
+        for (vcl_size_t i=0; i<n; ++i)
+          I[i][i] = T(1);
+        viennacl::copy(I, V);
+
+        viennacl::matrix<T, viennacl::column_major> AV(n, n, viennacl::traits::context(V));
+        AV = viennacl::linalg::prod(A, V);
+        std::vector< std::vector<T> > T_proj;
+        small_dense_resize(T_proj, n, n);
+        viennacl::copy(AV, T_proj);
+        block_lanczos_rayleigh_ritz(T_proj, n, theta, Y);
+      }
+
+      /** @brief Implementation of the thick-restart block Lanczos method.
+      *
+      * The basis is extended block by block. Each step applies the operator to a whole block by a single sparse matrix-matrix product and orthogonalizes the result
+      * against the basis by two passes of classical block Gram-Schmidt, i.e. by matrix-matrix products. With selective reorthogonalization,
+      * only the Ritz vectors kept at the last restart and the last two blocks are considered.
+      * Once the basis is full, the wanted Ritz vectors are kept and the basis is rebuilt from them (thick restart), which bounds the memory consumption.
+      *
+      * @param A              The system matrix
+      * @param tag            The block Lanczos tag
+      * @param eigenvectors   If not NULL, the eigenvectors are written to the columns
+      * @return The eigenvalues, ordered from the wanted end of the spectrum
+      */
+      template <typename MatrixT, typename T>
+      std::vector<T> block_lanczos(MatrixT const & A, block_lanczos_tag const & tag, viennacl::matrix<T, viennacl::column_major> * eigenvectors)
+      {
+        typedef viennacl::matrix<T, viennacl::column_major>   DenseMatrix;
+        typedef viennacl::matrix_range<DenseMatrix>           DenseMatrixRange;
+
+        vcl_size_t n = viennacl::traits::size1(A);
+        vcl_size_t k = std::min(tag.num_eigenvalues(), n);
+        vcl_size_t b = std::max<vcl_size_t>(1, std::min(tag.block_size(), n));
+        bool wanted_largest = (tag.which() == block_lanczos_tag::largest);
+        viennacl::context ctx = viennacl::traits::context(A);
+
+        tag.restarts(0);
+        tag.matrix_products(0);
+        tag.num_converged(0);
+        tag.residuals(std::vector<double>());
+
+        std::vector<T> eigenvalues;
+        if (k == 0)
+          return eigenvalues;
+
+        // the basis holds m vectors plus the next block, which must not exhaust the whole space:
+        vcl_size_t m = std::max(tag.max_basis_size(), k + 2 * b);
+        m = (m + b - 1) / b * b;
+
+        std::vector<T> theta, Y;
+        std::vector<double> residuals;
+        vcl_size_t c = 0;
+        DenseMatrix V(n, (m + b <= n) ? m + b : n, ctx);
+
+        if (m + b > n)
+        {
+          block_lanczos_dense(A, n, theta, V, Y);
+          tag.matrix_products(n);
+          c = n;
+          residuals.assign(n, 0);
+        }
+        else
+        {
+          DenseMatrix W(n, b, ctx);
+          DenseMatrix W_copy(n, b, ctx);
+          DenseMatrix tmp(n, b, ctx);
+          DenseMatrix coeffs_dev(b, b, ctx);
+          DenseMatrix ortho_work(b, b, ctx);
+          viennacl::range all_rows(0, n);
+          std::vector< std::vector<T> > T_proj;
+          std::vector< std::vector<T> > B;
+          small_dense_resize(T_proj, m + b, m + b);
+          T rank_tol = block_orthonormalize_tolerance<T>(b);
+          unsigned long state = 12345;
+
+          // random initial block:
+          DenseMatrixRange V_0(V, all_rows, viennacl::range(0, b));
+          fill_random_columns(V_0, 0, b, state);
+          block_orthonormalize(V_0, tmp, ortho_work, rank_tol);
+
+          vcl_size_t l = 0;   //number of Ritz vectors kept at the last restart
+          vcl_size_t matrix_products = 0;
+          for (unsigned int restart = 0; ; ++restart)
+          {
+            //
+            // extend the basis up to m vectors. The current block occupies the columns c, ..., c+b-1:
+            //
+            for (; c + b <= m; c += b)
+            {
+              tmp = DenseMatrixRange(V, all_rows, viennacl::range(c, c + b));
+              W = viennacl::linalg::prod(A, tmp);
+              matrix_products += b;
+
+              for (vcl_size_t pass = 0; pass < 2; ++pass)
+              {
+                if (tag.reorthogonalization() == block_lanczos_tag::full_reorthogonalization)
+                  block_lanczos_project_out(V, 0, c + b, W, &T_proj, c);
+                else
+                {
+                  vcl_size_t local_start = std::max(l, (c >= b) ? c - b : 0);
+                  block_lanczos_project_out(V, 0, l, W, &T_proj, c);
+                  block_lanczos_project_out(V, local_start, c + b, W, &T_proj, c);
+                }
+              }
+              for (vcl_size_t i=0; i<c; ++i)
+                for (vcl_size_t j=c; j<c+b; ++j)
+                  T_proj[j][i] = T_proj[i][j];
+
+              // next block and its coupling B = V_next^T W:
+              W_copy = W;
+              DenseMatrixRange V_next(V, all_rows, viennacl::range(c + b, c + 2 * b));
+              vcl_size_t rank = block_orthonormalize(W, tmp, ortho_work, rank_tol);
+              V_next = W;
+              if (rank < b)  //invariant subspace found: continue with random directions
+              {
+                DenseMatrixRange V_fill(V, all_rows, viennacl::range(c + b + rank, c + 2 * b));
+                DenseMatrixRange tmp_fill(tmp, all_rows, viennacl::range(rank, b));
+                fill_random_columns(V_fill, 0, b - rank, state);
+                for (vcl_size_t pass = 0; pass < 2; ++pass)
+                {
+                  tmp_fill = V_fill;
+                  block_lanczos_project_out(V, 0, c + b + rank, tmp_fill, static_cast<std::vector< std::vector<T> > *>(NULL), 0);
+                  V_fill = tmp_fill;
+                }
+                DenseMatrixRange tmp_work(W, all_rows, viennacl::range(rank, b));
+                block_orthonormalize(V_fill, tmp_work, ortho_work, rank_tol);
+              }
+
+              gram_matrix(V_next, W_copy, coeffs_dev, B);
+              for (vcl_size_t i=0; i<b; ++i)
+                for (vcl_size_t j=0; j<b; ++j)
+                  T_proj[c + b + i][c + j] = B[i][j];  //the transposed block is recomputed by the projection in the next step
+            }
+
+            //
+            // Rayleigh-Ritz and residual norms ||B_last Y(c-b:c, i)||:
+            //
+            block_lanczos_rayleigh_ritz(T_proj, c, theta, Y);
+
+            T norm_estimate = std::max(std::fabs(theta[0]), std::fabs(theta[c - 1]));
+            residuals.resize(c);
+            for (vcl_size_t i=0; i<c; ++i)
+            {
+              T res = 0;
+              for (vcl_size_t r=0; r<b; ++r)
+              {
+                T temp = 0;
+                for (vcl_size_t p=0; p<b; ++p)
+                  temp += T_proj[c + r][c - b + p] * Y[i * c + c - b + p];
+                res += temp * temp;
+              }
+              residuals[i] = std::sqrt(res);
+            }
+
+            vcl_size_t num_converged = 0;
+            for (vcl_size_t i=0; i<k; ++i)
+            {
+              vcl_size_t index = wanted_largest ? c - 1 - i : i;
+              T scale = std::max(std::fabs(theta[index]), std::numeric_limits<T>::epsilon() * norm_estimate);
+              if (residuals[index] <= tag.tolerance() * scale)
+                ++num_converged;
+            }
+            tag.num_converged(num_converged);
+            tag.restarts(restart);
+            tag.matrix_products(matrix_products);
+
+            if (num_converged == k || restart == tag.max_restarts())
+              break;
+
+            //
+            // thick restart: keep the l wanted Ritz vectors, followed by the last block
+            //
+            l = std::min(c - b, k + (c - k) / 2);
+            vcl_size_t keep_start = wanted_largest ? c - l : 0;
+
+            std::vector< std::vector<T> > Y_keep(c, std::vector<T>(l));
+            for (vcl_size_t q=0; q<l; ++q)
+              for (vcl_size_t i=0; i<c; ++i)
+                Y_keep[i][q] = Y[(keep_start + q) * c + i];
+            DenseMatrix Y_dev(c, l, ctx);
+            viennacl::copy(Y_keep, Y_dev);
+            DenseMatrix X(n, l, ctx);
+            X = viennacl::linalg::prod(DenseMatrixRange(V, all_rows, viennacl::range(0, c)), Y_dev);
+
+            DenseMatrixRange V_kept(V, all_rows, viennacl::range(0, l));
+            V_kept = X;
+            W = DenseMatrixRange(V, all_rows, viennacl::range(c, c + b));
+            DenseMatrixRange V_last(V, all_rows, viennacl::range(l, l + b));
+            V_last = W;
+
+            // projected matrix: Ritz values on the diagonal, coupling to the last block B_last Y(c-b:c, kept) in the arrow:
+            std::vector< std::vector<T> > T_new;
+            small_dense_resize(T_new, m + b, m + b);
+            for (vcl_size_t q=0; q<l; ++q)
+            {
+              T_new[q][q] = theta[keep_start + q];
+              for (vcl_size_t r=0; r<b; ++r)
+              {
+                T temp = 0;
+                for (vcl_size_t p=0; p<b; ++p)
+                  temp += T_proj[c + r][c - b + p] * Y[(keep_start + q) * c + c - b + p];
+                T_new[l + r][q] = temp;
+              }
+            }
+            T_proj.swap(T_new);
+            c = l;
+          }
+        }
+
+        //
+        // wanted eigenpairs, ordered from the wanted end of the spectrum:
+        //
+        eigenvalues.resize(k);
+        std::vector<double> wanted_residuals(k);
+        std::vector< std::vector<T> > Y_wanted(c, std::vector<T>(k));
+        for (vcl_size_t q=0; q<k; ++q)
+        {
+          vcl_size_t index = wanted_largest ? c - 1 - q : q;
+          eigenvalues[q] = theta[index];
+          wanted_residuals[q] = residuals[index];
+          for (vcl_size_t i=0; i<c; ++i)
+            Y_wanted[i][q] = Y[index * c + i];
+        }
+        tag.residuals(wanted_residuals);
+        if (m + b > n)
+          tag.num_converged(k);
+
+        if (eigenvectors)
+        {
+          DenseMatrix Y_dev(c, k, ctx);
+          viennacl::copy(Y_wanted, Y_dev);
+          eigenvectors->resize(n, k, false);
+          *eigenvectors = viennacl::linalg::prod(DenseMatrixRange(V, viennacl::range(0, n), viennacl::range(0, c)), Y_dev);
+        }
+
+        return eigenvalues;
+      }
+    }
+
+    /** @brief Computes extremal eigenvalues and eigenvectors of a symmetric matrix with the thick-restart block Lanczos method.
+    *
+    * @param matrix         The system matrix (any sparse matrix type supporting prod() with a dense matrix)
+    * @param eigenvectors   The eigenvectors on exit, one per column
+    * @param tag            Tag with the parameters of the block Lanczos method
+    * @return The tag.num_eigenvalues() eigenvalues, ordered from the wanted end of the spectrum (i.e. descending if the largest eigenvalues are computed)
+    */
+    template <typename MatrixT, typename T>
+    std::vector<T> eig(MatrixT const & matrix, viennacl::matrix<T, viennacl::column_major> & eigenvectors, block_lanczos_tag const & tag)
+    {
+      return detail::block_lanczos(matrix, tag, &eigenvectors);
+    }
+
+    /** @brief Computes extremal eigenvalues of a symmetric matrix with the thick-restart block Lanczos method.
+    *
+    * @param matrix         The system matrix (any sparse matrix type supporting prod() with a dense matrix)
+    * @param tag            Tag with the parameters of the block Lanczos method
+    * @return The tag.num_eigenvalues() eigenvalues, ordered from the wanted end of the spectrum (i.e. descending if the largest eigenvalues are computed)
+    */
+    template <typename MatrixT>
+    std::vector< typename viennacl::result_of::cpu_value_type<typename MatrixT::value_type>::type >
+    eig(MatrixT const & matrix, block_lanczos_tag const & tag)
+    {
+      typedef typename viennacl::result_of::cpu_value_type<typename MatrixT::value_type>::type    CPU_ScalarType;
+      return detail::block_lanczos(matrix, tag, static_cast<viennacl::matrix<CPU_ScalarType, viennacl::column_major> *>(NULL));
+    }
+
+  }
+}
+
+#endif
@@ -34,6 +34,7 @@
 #include "viennacl/traits/clear.hpp"
 #include "viennacl/traits/size.hpp"
 #include "viennacl/meta/result_of.hpp"
+#include "viennacl/linalg/detail/solver_workspace.hpp"
 
 namespace viennacl
 {
@@ -77,28 +78,52 @@ namespace viennacl
     };
 
 
-    /** @brief Implementation of the conjugate gradient solver without preconditioner
+    /** @brief Reusable storage for the temporary vectors of the conjugate gradient solver.
+    *
+    * Pass the same workspace object to repeated calls of solve() in order to avoid the allocation of temporaries in each call.
+    * The buffers are only reallocated if the size of the right hand side changes.
+    */
+    template <typename VectorType>
+    class cg_workspace : public detail::solver_workspace_base<VectorType>
+    {
+        typedef detail::solver_workspace_base<VectorType>   base_type;
+
+      public:
+        /** @brief Makes the work vectors available for a system with the size of 'rhs'. Called by the solver. */
+        void prepare(VectorType const & rhs) { base_type::prepare(rhs, 4); }
+
+        VectorType & residual() { return base_type::vec(0); }
+        VectorType & p()        { return base_type::vec(1); }
+        VectorType & tmp()      { return base_type::vec(2); }
+        VectorType & z()        { return base_type::vec(3); }
+    };
+
+
+    /** @brief Implementation of the conjugate gradient solver without preconditioner using a user-provided workspace and result vector
     *
     * Following the algorithm in the book by Y. Saad "Iterative Methods for sparse linear systems"
     *
     * @param matrix     The system matrix
     * @param rhs        The load vector
     * @param tag        Solver configuration tag
-    * @return The result vector
+    * @param workspace  Storage for the temporaries, reused across calls
+    * @param result     The result vector. Must either be empty or have the size of rhs, in which case no memory is allocated
     */
     template <typename MatrixType, typename VectorType>
-    VectorType solve(const MatrixType & matrix, VectorType const & rhs, cg_tag const & tag)
+    void solve(const MatrixType & matrix, VectorType const & rhs, cg_tag const & tag, viennacl::linalg::no_precond, cg_workspace<VectorType> & workspace, VectorType & result)
     {
-      //typedef typename VectorType::value_type      ScalarType;
       typedef typename viennacl::result_of::value_type<VectorType>::type        ScalarType;
       typedef typename viennacl::result_of::cpu_value_type<ScalarType>::type    CPU_ScalarType;
-      //std::cout << "Starting CG" << std::endl;
-      VectorType result = rhs;
+      if (viennacl::traits::size(result) != viennacl::traits::size(rhs))
+        result = rhs;
       viennacl::traits::clear(result);
 
-      VectorType residual = rhs;
-      VectorType p = rhs;
-      VectorType tmp = rhs;
+      workspace.prepare(rhs);
+      VectorType & residual = workspace.residual();
+      VectorType & p        = workspace.p();
+      VectorType & tmp      = workspace.tmp();
+      residual = rhs;
+      p = rhs;
 
       CPU_ScalarType ip_rr = viennacl::linalg::inner_prod(rhs,rhs);
       CPU_ScalarType alpha;
@@ -108,7 +133,7 @@ namespace viennacl
 
       //std::cout << "Starting CG solver iterations... " << std::endl;
       if (norm_rhs == 0) //solution is zero if RHS norm is zero
-        return result;
+        return;
 
       for (unsigned int i = 0; i < tag.max_iterations(); ++i)
       {
@@ -132,17 +157,49 @@ namespace viennacl
 
       //store last error estimate:
       tag.error(std::sqrt(new_ip_rr) / norm_rhs);
+    }
 
+    /** @brief Implementation of the conjugate gradient solver without preconditioner using a user-provided workspace
+    *
+    * Following the algorithm in the book by Y. Saad "Iterative Methods for sparse linear systems"
+    *
+    * @param matrix     The system matrix
+    * @param rhs        The load vector
+    * @param tag        Solver configuration tag
+    * @param workspace  Storage for the temporaries, reused across calls
+    * @return The result vector. This is the only vector allocated per call, pass a result vector to the overload above to avoid it
+    */
+    template <typename MatrixType, typename VectorType>
+    VectorType solve(const MatrixType & matrix, VectorType const & rhs, cg_tag const & tag, viennacl::linalg::no_precond, cg_workspace<VectorType> & workspace)
+    {
+      VectorType result = rhs;
+      solve(matrix, rhs, tag, viennacl::linalg::no_precond(), workspace, result);
       return result;
     }
 
+    /** @brief Implementation of the conjugate gradient solver without preconditioner
+    *
+    * Following the algorithm in the book by Y. Saad "Iterative Methods for sparse linear systems"
+    *
+    * @param matrix     The system matrix
+    * @param rhs        The load vector
+    * @param tag        Solver configuration tag
+    * @return The result vector
+    */
+    template <typename MatrixType, typename VectorType>
+    VectorType solve(const MatrixType & matrix, VectorType const & rhs, cg_tag const & tag)
+    {
+      cg_workspace<VectorType> workspace;
+      return solve(matrix, rhs, tag, viennacl::linalg::no_precond(), workspace);
+    }
+
     template <typename MatrixType, typename VectorType>
     VectorType solve(const MatrixType & matrix, VectorType const & rhs, cg_tag const & tag, viennacl::linalg::no_precond)
     {
       return solve(matrix, rhs, tag);
     }
 
-    /** @brief Implementation of the preconditioned conjugate gradient solver
+    /** @brief Implementation of the preconditioned conjugate gradient solver using a user-provided workspace and result vector
     *
     * Following Algorithm 9.1 in "Iterative Methods for Sparse Linear Systems" by Y. Saad
     *
@@ -150,23 +207,29 @@ namespace viennacl
     * @param rhs        The load vector
     * @param tag        Solver configuration tag
     * @param precond    A preconditioner. Precondition operation is done via member function apply()
-    * @return The result vector
+    * @param workspace  Storage for the temporaries, reused across calls
+    * @param result     The result vector. Must either be empty or have the size of rhs, in which case no memory is allocated
     */
     template <typename MatrixType, typename VectorType, typename PreconditionerType>
-    VectorType solve(const MatrixType & matrix, VectorType const & rhs, cg_tag const & tag, PreconditionerType const & precond)
+    void solve(const MatrixType & matrix, VectorType const & rhs, cg_tag const & tag, PreconditionerType const & precond, cg_workspace<VectorType> & workspace, VectorType & result)
     {
       typedef typename viennacl::result_of::value_type<VectorType>::type        ScalarType;
       typedef typename viennacl::result_of::cpu_value_type<ScalarType>::type    CPU_ScalarType;
 
-      VectorType result = rhs;
+      if (viennacl::traits::size(result) != viennacl::traits::size(rhs))
+        result = rhs;
       viennacl::traits::clear(result);
 
-      VectorType residual = rhs;
-      VectorType tmp = rhs;
-      VectorType z = rhs;
+      workspace.prepare(rhs);
+      VectorType & residual = workspace.residual();
+      VectorType & tmp      = workspace.tmp();
+      VectorType & z        = workspace.z();
+      VectorType & p        = workspace.p();
+      residual = rhs;
+      z = rhs;
 
       precond.apply(z);
-      VectorType p = z;
+      p = z;
 
       CPU_ScalarType ip_rr = viennacl::linalg::inner_prod(residual, z);
       CPU_ScalarType alpha;
@@ -176,7 +239,7 @@ namespace viennacl
       CPU_ScalarType new_ipp_rr_over_norm_rhs;
 
       if (norm_rhs_squared == 0) //solution is zero if RHS norm is zero
-        return result;
+        return;
 
       for (unsigned int i = 0; i < tag.max_iterations(); ++i)
       {
@@ -203,10 +266,44 @@ namespace viennacl
 
       //store last error estimate:
       tag.error(std::sqrt(std::fabs(new_ip_rr / norm_rhs_squared)));
+    }
 
+    /** @brief Implementation of the preconditioned conjugate gradient solver using a user-provided workspace
+    *
+    * Following Algorithm 9.1 in "Iterative Methods for Sparse Linear Systems" by Y. Saad
+    *
+    * @param matrix     The system matrix
+    * @param rhs        The load vector
+    * @param tag        Solver configuration tag
+    * @param precond    A preconditioner. Precondition operation is done via member function apply()
+    * @param workspace  Storage for the temporaries, reused across calls
+    * @return The result vector. This is the only vector allocated per call, pass a result vector to the overload above to avoid it
+    */
+    template <typename MatrixType, typename VectorType, typename PreconditionerType>
+    VectorType solve(const MatrixType & matrix, VectorType const & rhs, cg_tag const & tag, PreconditionerType const & precond, cg_workspace<VectorType> & workspace)
+    {
+      VectorType result = rhs;
+      solve(matrix, rhs, tag, precond, workspace, result);
       return result;
     }
 
+    /** @brief Implementation of the preconditioned conjugate gradient solver
+    *
+    * Following Algorithm 9.1 in "Iterative Methods for Sparse Linear Systems" by Y. Saad
+    *
+    * @param matrix     The system matrix
+    * @param rhs        The load vector
+    * @param tag        Solver configuration tag
+    * @param precond    A preconditioner. Precondition operation is done via member function apply()
+    * @return The result vector
+    */
+    template <typename MatrixType, typename VectorType, typename PreconditionerType>
+    VectorType solve(const MatrixType & matrix, VectorType const & rhs, cg_tag const & tag, PreconditionerType const & precond)
+    {
+      cg_workspace<VectorType> workspace;
+      return solve(matrix, rhs, tag, precond, workspace);
+    }
+
   }
 }
 
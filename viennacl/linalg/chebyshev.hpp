@@ -0,0 +1,492 @@
+#ifndef VIENNACL_LINALG_CHEBYSHEV_HPP_
+#define VIENNACL_LINALG_CHEBYSHEV_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/chebyshev.hpp
+    @brief The Chebyshev semi-iterative method and a Chebyshev polynomial preconditioner for symmetric positive definite systems are implemented here
+*/
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include "viennacl/forwards.h"
+#include "viennacl/vector.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/inner_prod.hpp"
+#include "viennacl/linalg/norm_2.hpp"
+#include "viennacl/traits/clear.hpp"
+#include "viennacl/traits/size.hpp"
+#include "viennacl/traits/context.hpp"
+#include "viennacl/meta/result_of.hpp"
+#include "viennacl/linalg/detail/small_dense.hpp"
+
+namespace viennacl
+{
+  namespace linalg
+  {
+
+    /** @brief A tag for the Chebyshev semi-iterative method. Used for supplying solver parameters and for dispatching the solve() function
+    */
+    class chebyshev_tag
+    {
+      public:
+        /** @brief The constructor
+        *
+        * @param tol              Relative tolerance for the residual (solver quits if ||r|| < tol * ||r_initial||)
+        * @param max_iterations   The maximum number of iterations
+        * @param lambda_min       Lower bound for the spectrum of the system matrix. Estimated by a few Lanczos steps if zero.
+        * @param lambda_max       Upper bound for the spectrum of the system matrix. Estimated by a few Lanczos steps if zero.
+        * @param check_interval   Number of iterations after which the residual norm is computed. This is the only reduction of the method.
+        */
+        chebyshev_tag(double tol = 1e-8, unsigned int max_iterations = 300,
+                      double lambda_min = 0, double lambda_max = 0,
+                      unsigned int check_interval = 10)
+          : tol_(tol), iterations_(max_iterations), lambda_min_(lambda_min), lambda_max_(lambda_max),
+            check_interval_(check_interval > 0 ? check_interval : 1), iters_taken_(0), last_error_(0) {}
+
+        /** @brief Returns the relative tolerance */
+        double tolerance() const { return tol_; }
+        /** @brief Returns the maximum number of iterations */
+        unsigned int max_iterations() const { return iterations_; }
+        /** @brief Returns the lower bound of the spectrum (zero if to be estimated) */
+        double lambda_min() const { return lambda_min_; }
+        /** @brief Returns the upper bound of the spectrum (zero if to be estimated) */
+        double lambda_max() const { return lambda_max_; }
+        /** @brief Returns the number of iterations after which the residual norm is checked */
+        unsigned int check_interval() const { return check_interval_; }
+
+        /** @brief Return the number of solver iterations: */
+        unsigned int iters() const { return iters_taken_; }
+        void iters(unsigned int i) const { iters_taken_ = i; }
+
+        /** @brief Returns the estimated relative error at the end of the solver run */
+        double error() const { return last_error_; }
+        /** @brief Sets the estimated relative error at the end of the solver run */
+        void error(double e) const { last_error_ = e; }
+
+      private:
+        double tol_;
+        unsigned int iterations_;
+        double lambda_min_;
+        double lambda_max_;
+        unsigned int check_interval_;
+
+        //return values from solver
+        mutable unsigned int iters_taken_;
+        mutable double last_error_;
+    };
+
+
+    namespace detail
+    {
+      /** @brief Fills a vector with (reproducible) pseudo-random entries. Generic version using element access. */
+      template <typename VectorType, typename T>
+      void chebyshev_fill(VectorType & vec, std::vector<T> const & values)
+      {
+        for (vcl_size_t i=0; i<values.size(); ++i)
+          vec[i] = values[i];
+      }
+
+      /** @brief Fills a vector with (reproducible) pseudo-random entries. ViennaCL vectors are filled by a single copy. */
+      template <typename T, unsigned int A>
+      void chebyshev_fill(viennacl::vector<T, A> & vec, std::vector<T> const & values)
+      {
+        viennacl::copy(values, vec);
+      }
+
+      /** @brief Resizes a vector to the number of rows of A. Generic version. */
+      template <typename VectorType, typename MatrixType>
+      void chebyshev_init_vector(VectorType & vec, MatrixType const & A)
+      {
+        vec.resize(viennacl::traits::size1(A));
+      }
+
+      /** @brief Resizes a ViennaCL vector to the number of rows of A and places it in the memory context of A. */
+      template <typename T, unsigned int Alignment, typename MatrixType>
+      void chebyshev_init_vector(viennacl::vector<T, Alignment> & vec, MatrixType const & A)
+      {
+        if (viennacl::traits::size1(A) > 0)
+          vec.resize(viennacl::traits::size1(A), viennacl::traits::context(A), false);
+      }
+
+      /** @brief Computes spectral bounds for the Chebyshev iteration from the Lanczos coefficients.
+      *
+      * The largest Ritz value is enlarged by ten percent, since it approaches the largest eigenvalue from below,
+      * while an underestimated upper bound renders the Chebyshev polynomial unstable.
+      *
+      * @param alphas       Diagonal of the Lanczos tridiagonal matrix
+      * @param betas        Off-diagonal of the Lanczos tridiagonal matrix (one entry less than alphas)
+      * @param lambda_min   Smallest Ritz value. If not positive, lambda_max / 100 is returned.
+      * @param lambda_max   Upper bound for the largest eigenvalue
+      */
+      template <typename T>
+      void chebyshev_lanczos_bounds(std::vector<T> const & alphas, std::vector<T> const & betas, T & lambda_min, T & lambda_max)
+      {
+        vcl_size_t m = alphas.size();
+        std::vector< std::vector<T> > H;
+        detail::small_dense_resize(H, m, m);
+        for (vcl_size_t i=0; i<m; ++i)
+        {
+          H[i][i] = alphas[i];
+          if (i+1 < m)
+          {
+            H[i+1][i] = betas[i];
+            H[i][i+1] = betas[i];
+          }
+        }
+
+        std::vector<T> wr, wi;
+        detail::small_dense_hessenberg_eigenvalues(H, m, wr, wi);
+
+        T ritz_min = *std::min_element(wr.begin(), wr.end());
+        T ritz_max = *std::max_element(wr.begin(), wr.end());
+
+        lambda_max = T(1.1) * ritz_max;
+        lambda_min = (ritz_min > 0 && ritz_min < ritz_max) ? ritz_min : lambda_max / T(100);
+      }
+
+      /** @brief Computes result = D^{-1} r for the diagonal scaling of the Chebyshev iteration. Generic version using element access. */
+      template <typename VectorType>
+      void chebyshev_diag_scale(VectorType const & inv_diag, VectorType const & r, VectorType & result)
+      {
+        for (vcl_size_t i=0; i<viennacl::traits::size(r); ++i)
+          result[i] = inv_diag[i] * r[i];
+      }
+
+      /** @brief Computes result = D^{-1} r for the diagonal scaling of the Chebyshev iteration. ViennaCL vectors use a single element-wise product. */
+      template <typename T, unsigned int A>
+      void chebyshev_diag_scale(viennacl::vector<T, A> const & inv_diag, viennacl::vector<T, A> const & r, viennacl::vector<T, A> & result)
+      {
+        result = viennacl::linalg::element_prod(inv_diag, r);
+      }
+
+      /** @brief Estimates the extremal eigenvalues of a symmetric matrix A, or of D^{-1} A if the inverse diagonal is given, by a few steps of the Lanczos method without reorthogonalization.
+      *
+      * D^{-1} A is self-adjoint with respect to the inner product induced by D, which is used in the Lanczos recurrence then.
+      * Only five vectors are kept, the bounds are obtained from the resulting tridiagonal matrix by chebyshev_lanczos_bounds().
+      *
+      * @param A            The system matrix
+      * @param inv_diag     The inverse diagonal of A (with positive entries), or NULL if the spectrum of A itself is estimated
+      * @param lambda_min   Estimate for the smallest eigenvalue. If the estimate is not positive, lambda_max / 100 is returned.
+      * @param lambda_max   Upper bound for the largest eigenvalue
+      * @param steps        Number of Lanczos steps
+      */
+      template <typename MatrixType, typename VectorType, typename ScalarType>
+      void chebyshev_estimate_spectrum(MatrixType const & A, VectorType const * inv_diag, ScalarType & lambda_min, ScalarType & lambda_max, vcl_size_t steps)
+      {
+        typedef typename viennacl::result_of::cpu_value_type<typename viennacl::result_of::value_type<VectorType>::type>::type   CPU_ScalarType;
+
+        vcl_size_t n = viennacl::traits::size1(A);
+        steps = std::min(steps, n);
+
+        std::vector<CPU_ScalarType> values(n);
+        unsigned long state = 12345;  //simple linear congruential generator, independent of std::rand()
+        for (vcl_size_t i=0; i<n; ++i)
+        {
+          state = (1103515245ul * state + 12345ul) % 2147483648ul;
+          values[i] = CPU_ScalarType(state) / CPU_ScalarType(2147483648.0) - CPU_ScalarType(0.5);
+        }
+
+        // Lanczos vectors v, and u = D v for the D-inner product:
+        VectorType v;
+        VectorType u;
+        VectorType u_prev;
+        VectorType w;
+        VectorType z;
+        chebyshev_init_vector(v, A);
+        chebyshev_init_vector(u, A);
+        chebyshev_init_vector(u_prev, A);
+        chebyshev_init_vector(w, A);
+        chebyshev_init_vector(z, A);
+        chebyshev_fill(u, values);
+        if (inv_diag)
+          chebyshev_diag_scale(*inv_diag, u, v);
+        else
+          v = u;
+        CPU_ScalarType norm_v = std::sqrt(CPU_ScalarType(viennacl::linalg::inner_prod(u, v)));
+        u /= norm_v;
+        v /= norm_v;
+        viennacl::traits::clear(u_prev);
+
+        std::vector<CPU_ScalarType> alphas, betas;
+        CPU_ScalarType beta = 0;
+        for (vcl_size_t j=0; j<steps; ++j)
+        {
+          w = viennacl::linalg::prod(A, v);
+          CPU_ScalarType alpha = viennacl::linalg::inner_prod(w, v);
+          alphas.push_back(alpha);
+          w -= alpha * u + beta * u_prev;
+          if (inv_diag)
+            chebyshev_diag_scale(*inv_diag, w, z);
+          else
+            z = w;
+          CPU_ScalarType beta_squared = viennacl::linalg::inner_prod(w, z);
+          beta = (beta_squared > 0) ? std::sqrt(beta_squared) : 0;
+          if (beta <= 0 || j+1 == steps)  //invariant subspace found
+            break;
+          betas.push_back(beta);
+          u_prev = u;
+          u = w;
+          u /= beta;
+          v = z;
+          v /= beta;
+        }
+
+        CPU_ScalarType est_min = 0, est_max = 0;
+        chebyshev_lanczos_bounds(alphas, betas, est_min, est_max);
+        lambda_min = static_cast<ScalarType>(est_min);
+        lambda_max = static_cast<ScalarType>(est_max);
+      }
+
+      /** @brief Estimates the extremal eigenvalues of a symmetric matrix by a few steps of the Lanczos method without reorthogonalization. See the overload above for details.
+      *
+      * @param A            The system matrix
+      * @param lambda_min   Estimate for the smallest eigenvalue. If the estimate is not positive, lambda_max / 100 is returned.
+      * @param lambda_max   Upper bound for the largest eigenvalue
+      * @param steps        Number of Lanczos steps
+      */
+      template <typename MatrixType, typename ScalarType>
+      void chebyshev_estimate_spectrum(MatrixType const & A, ScalarType & lambda_min, ScalarType & lambda_max, vcl_size_t steps = 20)
+      {
+        typedef typename viennacl::result_of::vector_for_matrix<MatrixType>::type   VectorType;
+
+        chebyshev_estimate_spectrum(A, static_cast<VectorType const *>(NULL), lambda_min, lambda_max, steps);
+      }
+
+      /** @brief Runs a number of steps of the (optionally Jacobi-scaled) Chebyshev iteration for A x = b. Common kernel of the Chebyshev solver, the Chebyshev preconditioner and the Chebyshev smoother of AMG.
+      *
+      * Following Algorithm 12.1 in "Iterative Methods for Sparse Linear Systems" by Y. Saad, applied to D^{-1} A x = D^{-1} b if inv_diag is given.
+      * The spectrum of A (or D^{-1} A, respectively) is assumed to be contained in [lambda_min, lambda_max].
+      * Each step requires one matrix-vector product and no inner products.
+      *
+      * @param A            The system matrix
+      * @param inv_diag     The inverse diagonal of A, or NULL if no scaling is used
+      * @param x            The current iterate, updated in-place
+      * @param r            The residual b - A x on entry, updated together with x
+      * @param d            The search direction. Initialized from r if 'restart' is set, otherwise continued from a previous call
+      * @param tmp          Work vector of the same size as r
+      * @param lambda_min   Lower bound of the spectrum
+      * @param lambda_max   Upper bound of the spectrum
+      * @param rho          State of the recurrence. Initialized if 'restart' is set, otherwise continued from a previous call
+      * @param steps        Number of updates of x
+      * @param restart      Whether to start the recurrence anew
+      * @param update_last_residual  If false, the matrix-vector product for the residual after the last update of x is skipped, leaving r outdated
+      */
+      template <typename MatrixType, typename XVectorType, typename VectorType, typename ScalarType>
+      void chebyshev_iterate(MatrixType const & A, VectorType const * inv_diag,
+                             XVectorType & x, VectorType & r, VectorType & d, VectorType & tmp,
+                             ScalarType lambda_min, ScalarType lambda_max, ScalarType & rho,
+                             vcl_size_t steps, bool restart, bool update_last_residual)
+      {
+        ScalarType theta = (lambda_max + lambda_min) / ScalarType(2);
+        ScalarType delta = (lambda_max - lambda_min) / ScalarType(2);
+        ScalarType sigma = theta / delta;
+
+        for (vcl_size_t i=0; i<steps; ++i)
+        {
+          VectorType const * z = &r;   // z = D^{-1} r
+          if (inv_diag)
+          {
+            chebyshev_diag_scale(*inv_diag, r, tmp);
+            z = &tmp;
+          }
+
+          if (restart && i == 0)
+          {
+            rho = ScalarType(1) / sigma;
+            d = *z;
+            d /= theta;
+          }
+          else
+          {
+            ScalarType rho_new = ScalarType(1) / (ScalarType(2) * sigma - rho);
+            d = (rho_new * rho) * d + (ScalarType(2) * rho_new / delta) * (*z);
+            rho = rho_new;
+          }
+
+          x += d;
+
+          if (i+1 < steps || update_last_residual)
+          {
+            tmp = viennacl::linalg::prod(A, d);
+            r -= tmp;
+          }
+        }
+      }
+    }
+
+
+    /** @brief Implementation of the Chebyshev semi-iterative method
+    *
+    * Following Algorithm 12.1 in "Iterative Methods for Sparse Linear Systems" by Y. Saad.
+    * The system matrix needs to be symmetric positive definite with spectrum in [lambda_min, lambda_max].
+    * Other than CG, the iteration does not require any inner products, each step consists of one matrix-vector product and two vector updates.
+    * The residual norm is only computed every check_interval() iterations in order to test for convergence.
+    *
+    * @param matrix     The system matrix
+    * @param rhs        The load vector
+    * @param tag        Solver configuration tag
+    * @return The result vector
+    */
+    template <typename MatrixType, typename VectorType>
+    VectorType solve(const MatrixType & matrix, VectorType const & rhs, chebyshev_tag const & tag)
+    {
+      typedef typename viennacl::result_of::value_type<VectorType>::type        ScalarType;
+      typedef typename viennacl::result_of::cpu_value_type<ScalarType>::type    CPU_ScalarType;
+
+      VectorType result = rhs;
+      viennacl::traits::clear(result);
+
+      tag.iters(0);
+      tag.error(0);
+
+      CPU_ScalarType norm_rhs = viennacl::linalg::norm_2(rhs);
+      if (norm_rhs == 0) //solution is zero if RHS norm is zero
+        return result;
+
+      CPU_ScalarType lambda_min = static_cast<CPU_ScalarType>(tag.lambda_min());
+      CPU_ScalarType lambda_max = static_cast<CPU_ScalarType>(tag.lambda_max());
+      if (lambda_min <= 0 || lambda_max <= 0)
+      {
+        CPU_ScalarType est_min = 0, est_max = 0;
+        detail::chebyshev_estimate_spectrum(matrix, est_min, est_max);
+        if (lambda_min <= 0)
+          lambda_min = est_min;
+        if (lambda_max <= 0)
+          lambda_max = est_max;
+      }
+
+      VectorType residual = rhs;
+      VectorType d = rhs;
+      VectorType tmp = rhs;
+      CPU_ScalarType rho = 0;
+
+      CPU_ScalarType norm_res = norm_rhs;
+      for (unsigned int i = 0; i < tag.max_iterations(); i += tag.check_interval())
+      {
+        unsigned int steps = std::min(tag.check_interval(), tag.max_iterations() - i);
+        detail::chebyshev_iterate(matrix, static_cast<VectorType const *>(NULL), result, residual, d, tmp,
+                                  lambda_min, lambda_max, rho, steps, i == 0, true);
+        tag.iters(i + steps);
+
+        norm_res = viennacl::linalg::norm_2(residual);
+        if (norm_res / norm_rhs < tag.tolerance())
+          break;
+      }
+
+      //store last error estimate:
+      tag.error(norm_res / norm_rhs);
+
+      return result;
+    }
+
+
+    /** @brief A tag for the Chebyshev polynomial preconditioner
+    */
+    class chebyshev_precond_tag
+    {
+      public:
+        /** @brief The constructor
+        *
+        * @param degree       Degree of the polynomial. Each application of the preconditioner requires 'degree' matrix-vector products.
+        * @param lambda_min   Lower bound of the spectrum targeted by the polynomial. Estimated by a few Lanczos steps if zero.
+        * @param lambda_max   Upper bound for the spectrum of the system matrix. Estimated by a few Lanczos steps if zero.
+        */
+        chebyshev_precond_tag(unsigned int degree = 3, double lambda_min = 0, double lambda_max = 0)
+          : degree_(degree), lambda_min_(lambda_min), lambda_max_(lambda_max) {}
+
+        unsigned int degree() const { return degree_; }
+        void degree(unsigned int d) { degree_ = d; }
+
+        double lambda_min() const { return lambda_min_; }
+        void lambda_min(double l) { lambda_min_ = l; }
+
+        double lambda_max() const { return lambda_max_; }
+        void lambda_max(double l) { lambda_max_ = l; }
+
+      private:
+        unsigned int degree_;
+        double lambda_min_;
+        double lambda_max_;
+    };
+
+
+    /** @brief Chebyshev polynomial preconditioner for symmetric positive definite matrices.
+    *
+    * The preconditioner is given by degree+1 steps of the Chebyshev iteration with zero initial guess, hence it is a fixed polynomial in the system matrix
+    * and can be used with CG. Since an application consists of matrix-vector products and vector updates only, it is well suited for massively parallel architectures.
+    * The system matrix is referenced, not copied, so it must outlive the preconditioner.
+    * With a small degree and lambda_min set to a fraction of lambda_max (e.g. lambda_max / 4), the preconditioner is a smoother for the high-frequency error components.
+    */
+    template <typename MatrixType>
+    class chebyshev_precond
+    {
+      typedef typename viennacl::result_of::vector_for_matrix<MatrixType>::type    VectorType;
+      typedef typename viennacl::result_of::cpu_value_type<typename MatrixType::value_type>::type  ScalarType;
+
+      public:
+        chebyshev_precond(MatrixType const & mat, chebyshev_precond_tag const & tag)
+          : A_(mat), tag_(tag),
+            lambda_min_(static_cast<ScalarType>(tag.lambda_min())), lambda_max_(static_cast<ScalarType>(tag.lambda_max())),
+            residual_(), d_(), tmp_()
+        {
+          detail::chebyshev_init_vector(residual_, mat);
+          detail::chebyshev_init_vector(d_, mat);
+          detail::chebyshev_init_vector(tmp_, mat);
+
+          if (lambda_min_ <= 0 || lambda_max_ <= 0)
+          {
+            ScalarType est_min = 0, est_max = 0;
+            detail::chebyshev_estimate_spectrum(mat, est_min, est_max);
+            if (lambda_min_ <= 0)
+              lambda_min_ = est_min;
+            if (lambda_max_ <= 0)
+              lambda_max_ = est_max;
+          }
+        }
+
+        /** @brief Returns the lower bound of the spectrum used for the polynomial */
+        ScalarType lambda_min() const { return lambda_min_; }
+        /** @brief Returns the upper bound of the spectrum used for the polynomial */
+        ScalarType lambda_max() const { return lambda_max_; }
+
+        template <typename VectorT>
+        void apply(VectorT & vec) const
+        {
+          ScalarType rho = 0;
+          residual_ = vec;
+          viennacl::traits::clear(vec);
+          detail::chebyshev_iterate(A_, static_cast<VectorType const *>(NULL), vec, residual_, d_, tmp_,
+                                    lambda_min_, lambda_max_, rho, tag_.degree() + 1, true, false);
+        }
+
+      private:
+        MatrixType const & A_;
+        chebyshev_precond_tag tag_;
+        ScalarType lambda_min_;
+        ScalarType lambda_max_;
+        mutable VectorType residual_;
+        mutable VectorType d_;
+        mutable VectorType tmp_;
+    };
+
+  }
+}
+
+#endif
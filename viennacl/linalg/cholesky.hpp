@@ -0,0 +1,330 @@
+#ifndef VIENNACL_LINALG_CHOLESKY_HPP
+#define VIENNACL_LINALG_CHOLESKY_HPP
+
+/* =========================================================================
+   Copyright (c) 2010-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/cholesky.hpp
+    @brief Implementation of a blocked Cholesky factorization A = L L^T for symmetric positive definite dense matrices.
+*/
+
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+
+#include "viennacl/matrix.hpp"
+#include "viennacl/vector.hpp"
+#include "viennacl/linalg/direct_solve.hpp"
+
+namespace viennacl
+{
+  namespace linalg
+  {
+    namespace detail
+    {
+      //
+      // Host kernels for the right-looking blocked Cholesky factorization. All matrices are stored column-major with leading dimension n,
+      // only the lower triangular part is referenced. For each block column starting at j, the diagonal block is factored (POTRF),
+      // the block column below is obtained from a triangular solve (TRSM), and the trailing matrix receives a symmetric rank-nb update (SYRK).
+      //
+
+      /** @brief Number of columns of a block column */
+      inline vcl_size_t cholesky_block_size() { return 64; }
+
+      /** @brief Number of rows processed by a thread at once in the TRSM and SYRK kernels */
+      inline vcl_size_t cholesky_row_block_size() { return 256; }
+
+      /** @brief Unblocked Cholesky factorization of the diagonal block A(j:j+nb, j:j+nb). Returns false if a pivot is not positive. */
+      template <typename ScalarType>
+      bool cholesky_factor_diagonal_block(ScalarType * A, vcl_size_t n, vcl_size_t j, vcl_size_t nb)
+      {
+        for (vcl_size_t k=0; k<nb; ++k)
+        {
+          ScalarType * col_k = A + (j+k)*n;
+          ScalarType d = col_k[j+k];
+          if ( !(d > 0) )
+            return false;
+
+          d = std::sqrt(d);
+          col_k[j+k] = d;
+          for (vcl_size_t i=j+k+1; i<j+nb; ++i)
+            col_k[i] /= d;
+
+          for (vcl_size_t l=k+1; l<nb; ++l)
+          {
+            ScalarType * col_l = A + (j+l)*n;
+            ScalarType L_lk = col_k[j+l];
+            for (vcl_size_t i=j+l; i<j+nb; ++i)
+              col_l[i] -= col_k[i] * L_lk;
+          }
+        }
+        return true;
+      }
+
+      /** @brief Computes the block column L_21 = A_21 L_11^{-T} below the diagonal block starting at j. Rows are distributed over the threads. */
+      template <typename ScalarType>
+      void cholesky_trsm_block_column(ScalarType * A, vcl_size_t n, vcl_size_t j, vcl_size_t nb)
+      {
+        vcl_size_t row_block_size = cholesky_row_block_size();
+        vcl_size_t first_row = j + nb;
+        long num_row_blocks = static_cast<long>((n - first_row + row_block_size - 1) / row_block_size);
+#ifdef VIENNACL_WITH_OPENMP
+        #pragma omp parallel for
+#endif
+        for (long rb=0; rb<num_row_blocks; ++rb)
+        {
+          vcl_size_t row_start = first_row + static_cast<vcl_size_t>(rb) * row_block_size;
+          vcl_size_t row_stop  = std::min(n, row_start + row_block_size);
+          for (vcl_size_t k=0; k<nb; ++k)
+          {
+            ScalarType * col_k = A + (j+k)*n;
+            for (vcl_size_t l=0; l<k; ++l)
+            {
+              ScalarType const * col_l = A + (j+l)*n;
+              ScalarType L_kl = col_l[j+k];
+              for (vcl_size_t i=row_start; i<row_stop; ++i)
+                col_k[i] -= col_l[i] * L_kl;
+            }
+            ScalarType L_kk = col_k[j+k];
+            for (vcl_size_t i=row_start; i<row_stop; ++i)
+              col_k[i] /= L_kk;
+          }
+        }
+      }
+
+      /** @brief Symmetric rank-nb update A_22 -= L_21 L_21^T of the lower triangular part of the trailing matrix. Tiles of the trailing matrix are distributed over the threads. */
+      template <typename ScalarType>
+      void cholesky_syrk_update(ScalarType * A, vcl_size_t n, vcl_size_t j, vcl_size_t nb)
+      {
+        vcl_size_t first = j + nb;
+        vcl_size_t col_tile_size = cholesky_block_size();
+        vcl_size_t row_tile_size = cholesky_row_block_size();
+
+        //tiles (first row, first column) on or below the diagonal:
+        std::vector< std::pair<vcl_size_t, vcl_size_t> > tiles;
+        for (vcl_size_t col_start = first; col_start < n; col_start += col_tile_size)
+          for (vcl_size_t row_start = col_start; row_start < n; row_start += row_tile_size)
+            tiles.push_back(std::make_pair(row_start, col_start));
+
+#ifdef VIENNACL_WITH_OPENMP
+        #pragma omp parallel for schedule(dynamic)
+#endif
+        for (long t=0; t<static_cast<long>(tiles.size()); ++t)
+        {
+          vcl_size_t row_start = tiles[static_cast<vcl_size_t>(t)].first;
+          vcl_size_t row_stop  = std::min(n, row_start + row_tile_size);
+          vcl_size_t col_start = tiles[static_cast<vcl_size_t>(t)].second;
+          vcl_size_t col_stop  = std::min(n, col_start + col_tile_size);
+          for (vcl_size_t c=col_start; c<col_stop; ++c)
+          {
+            ScalarType * col_c = A + c*n;
+            vcl_size_t i_start = std::max(row_start, c);
+            for (vcl_size_t l=0; l<nb; ++l)
+            {
+              ScalarType const * col_l = A + (j+l)*n;
+              ScalarType L_cl = col_l[c];
+              for (vcl_size_t i=i_start; i<row_stop; ++i)
+                col_c[i] -= col_l[i] * L_cl;
+            }
+          }
+        }
+      }
+
+      /** @brief Right-looking blocked Cholesky factorization of the column-major n x n buffer A. Returns false if A is not positive definite. */
+      template <typename ScalarType>
+      bool cholesky_factor_buffer(ScalarType * A, vcl_size_t n)
+      {
+        vcl_size_t block_size = cholesky_block_size();
+        for (vcl_size_t j=0; j<n; j += block_size)
+        {
+          vcl_size_t nb = std::min(n, j + block_size) - j;
+
+          if (!cholesky_factor_diagonal_block(A, n, j, nb))
+            return false;
+
+          if (j + nb < n)
+          {
+            cholesky_trsm_block_column(A, n, j, nb);
+            cholesky_syrk_update(A, n, j, nb);
+          }
+        }
+        return true;
+      }
+
+      /** @brief Solves L L^T X = B for the num_cols columns of the column-major buffer B (leading dimension n), where L is the lower triangular part of the column-major buffer L.
+      *
+      * The right hand sides are processed in chunks, so that each column of L is loaded once per chunk. Chunks are distributed over the threads.
+      */
+      template <typename ScalarType>
+      void cholesky_substitute_buffer(ScalarType const * L, vcl_size_t n, ScalarType * B, vcl_size_t num_cols)
+      {
+        vcl_size_t chunk_size = 16;
+        long num_chunks = static_cast<long>((num_cols + chunk_size - 1) / chunk_size);
+#ifdef VIENNACL_WITH_OPENMP
+        #pragma omp parallel for
+#endif
+        for (long ch=0; ch<num_chunks; ++ch)
+        {
+          vcl_size_t col_start = static_cast<vcl_size_t>(ch) * chunk_size;
+          vcl_size_t col_stop  = std::min(num_cols, col_start + chunk_size);
+
+          //forward substitution L Y = B:
+          for (vcl_size_t j=0; j<n; ++j)
+          {
+            ScalarType const * L_col = L + j*n;
+            for (vcl_size_t c=col_start; c<col_stop; ++c)
+            {
+              ScalarType * b = B + c*n;
+              ScalarType y_j = b[j] / L_col[j];
+              b[j] = y_j;
+              for (vcl_size_t i=j+1; i<n; ++i)
+                b[i] -= L_col[i] * y_j;
+            }
+          }
+
+          //backward substitution L^T X = Y:
+          for (vcl_size_t j=n; j>0; --j)
+          {
+            ScalarType const * L_col = L + (j-1)*n;
+            for (vcl_size_t c=col_start; c<col_stop; ++c)
+            {
+              ScalarType * b = B + c*n;
+              ScalarType temp = b[j-1];
+              for (vcl_size_t i=j; i<n; ++i)
+                temp -= L_col[i] * b[i];
+              b[j-1] = temp / L_col[j-1];
+            }
+          }
+        }
+      }
+
+      /** @brief Copies the lower triangular part of a ViennaCL matrix to the column-major n x n buffer L. A_buffer holds the raw entries of A (including padding) on exit. */
+      template <typename SCALARTYPE, typename F, unsigned int ALIGNMENT>
+      void cholesky_read_lower(matrix<SCALARTYPE, F, ALIGNMENT> const & A, std::vector<SCALARTYPE> & L, std::vector<SCALARTYPE> & A_buffer)
+      {
+        vcl_size_t n = A.size1();
+        A_buffer.resize(A.internal_size());
+        viennacl::backend::memory_read(A.handle(), 0, sizeof(SCALARTYPE) * A.internal_size(), &(A_buffer[0]));
+
+        L.assign(n * n, SCALARTYPE(0));
+        for (vcl_size_t j=0; j<n; ++j)
+          for (vcl_size_t i=j; i<n; ++i)
+            L[j*n + i] = A_buffer[F::mem_index(i, j, A.internal_size1(), A.internal_size2())];
+      }
+
+      /** @brief Copies the lower triangular part of a ViennaCL matrix to the column-major n x n buffer L */
+      template <typename SCALARTYPE, typename F, unsigned int ALIGNMENT>
+      void cholesky_read_lower(matrix<SCALARTYPE, F, ALIGNMENT> const & A, std::vector<SCALARTYPE> & L)
+      {
+        std::vector<SCALARTYPE> A_buffer;
+        cholesky_read_lower(A, L, A_buffer);
+      }
+    } //namespace detail
+
+
+    /** @brief Blocked Cholesky factorization A = L L^T of a symmetric positive definite dense matrix.
+    *
+    * The factorization is computed on the host, where the updates of the trailing matrix use multiple threads if OpenMP is enabled.
+    * Only the lower triangular part of A is referenced, the strictly upper triangular part is left unchanged.
+    *
+    * @param A    The system matrix. On exit, L is stored in the lower triangular part.
+    * @return     False if A is not (numerically) positive definite. A is then only partially factored.
+    */
+    template<typename SCALARTYPE, typename F, unsigned int ALIGNMENT>
+    bool cholesky_factorize(matrix<SCALARTYPE, F, ALIGNMENT> & A)
+    {
+      assert(A.size1() == A.size2() && bool("Matrix must be square"));
+
+      vcl_size_t n = A.size1();
+      if (n == 0)
+        return true;
+
+      std::vector<SCALARTYPE> L, A_buffer;
+      detail::cholesky_read_lower(A, L, A_buffer);
+
+      bool success = detail::cholesky_factor_buffer(&(L[0]), n);
+
+      for (vcl_size_t j=0; j<n; ++j)
+        for (vcl_size_t i=j; i<n; ++i)
+          A_buffer[F::mem_index(i, j, A.internal_size1(), A.internal_size2())] = L[j*n + i];
+      viennacl::backend::memory_write(A.handle(), 0, sizeof(SCALARTYPE) * A.internal_size(), &(A_buffer[0]));
+
+      return success;
+    }
+
+
+    //
+    // Convenience layer:
+    //
+
+    /** @brief Cholesky substitution for the system L L^T X = B with multiple right hand sides.
+    *
+    * The right hand sides are solved for in parallel on the host if OpenMP is enabled.
+    *
+    * @param A    The matrix holding L in its lower triangular part as obtained from cholesky_factorize()
+    * @param B    The matrix of load vectors, where the solution is directly written to
+    */
+    template<typename SCALARTYPE, typename F1, typename F2, unsigned int ALIGNMENT_A, unsigned int ALIGNMENT_B>
+    void cholesky_substitute(matrix<SCALARTYPE, F1, ALIGNMENT_A> const & A,
+                             matrix<SCALARTYPE, F2, ALIGNMENT_B> & B)
+    {
+      assert(A.size1() == A.size2() && bool("Matrix must be square"));
+      assert(A.size1() == B.size1() && bool("Size mismatch: number of rows of B must match size of A"));
+
+      vcl_size_t n = B.size1();
+      vcl_size_t num_cols = B.size2();
+      if (n == 0 || num_cols == 0)
+        return;
+
+      std::vector<SCALARTYPE> L;
+      detail::cholesky_read_lower(A, L);
+
+      std::vector<SCALARTYPE> B_buffer(B.internal_size());
+      viennacl::backend::memory_read(B.handle(), 0, sizeof(SCALARTYPE) * B.internal_size(), &(B_buffer[0]));
+
+      std::vector<SCALARTYPE> X(n * num_cols);
+      for (vcl_size_t j=0; j<num_cols; ++j)
+        for (vcl_size_t i=0; i<n; ++i)
+          X[j*n + i] = B_buffer[F2::mem_index(i, j, B.internal_size1(), B.internal_size2())];
+
+      detail::cholesky_substitute_buffer(&(L[0]), n, &(X[0]), num_cols);
+
+      for (vcl_size_t j=0; j<num_cols; ++j)
+        for (vcl_size_t i=0; i<n; ++i)
+          B_buffer[F2::mem_index(i, j, B.internal_size1(), B.internal_size2())] = X[j*n + i];
+      viennacl::backend::memory_write(B.handle(), 0, sizeof(SCALARTYPE) * B.internal_size(), &(B_buffer[0]));
+    }
+
+    /** @brief Cholesky substitution for the system L L^T x = rhs.
+    *
+    * @param A      The matrix holding L in its lower triangular part as obtained from cholesky_factorize()
+    * @param vec    The load vector, where the solution is directly written to
+    */
+    template<typename SCALARTYPE, typename F, unsigned int ALIGNMENT, unsigned int VEC_ALIGNMENT>
+    void cholesky_substitute(matrix<SCALARTYPE, F, ALIGNMENT> const & A,
+                             vector<SCALARTYPE, VEC_ALIGNMENT> & vec)
+    {
+      assert(A.size1() == A.size2() && bool("Matrix must be square"));
+      inplace_solve(A, vec, lower_tag());
+      inplace_solve(trans(A), vec, upper_tag());
+    }
+
+  }
+}
+
+#endif
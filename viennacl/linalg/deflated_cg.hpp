@@ -0,0 +1,405 @@
+#ifndef VIENNACL_LINALG_DEFLATED_CG_HPP_
+#define VIENNACL_LINALG_DEFLATED_CG_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/deflated_cg.hpp
+    @brief The deflated conjugate gradient method for sequences of symmetric positive definite systems is implemented here
+*/
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include "viennacl/forwards.h"
+#include "viennacl/vector.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/inner_prod.hpp"
+#include "viennacl/linalg/norm_2.hpp"
+#include "viennacl/traits/context.hpp"
+#include "viennacl/linalg/recycle_space.hpp"
+#include "viennacl/linalg/detail/small_dense.hpp"
+#include "viennacl/linalg/detail/multi_vector.hpp"
+
+namespace viennacl
+{
+  namespace linalg
+  {
+
+    /** @brief A tag for the deflated conjugate gradient solver. Used for supplying solver parameters and for dispatching the solve() function
+    */
+    class deflated_cg_tag
+    {
+      public:
+        /** @brief The constructor
+        *
+        * @param tol              Relative tolerance for the residual (solver quits if ||r|| < tol * ||b||)
+        * @param max_iterations   The maximum number of iterations
+        * @param harvest_size     Number of iterations of each solve whose search directions are used for updating the recycled subspace. Zero selects ten times the size of the recycled subspace.
+        */
+        deflated_cg_tag(double tol = 1e-8, unsigned int max_iterations = 300, vcl_size_t harvest_size = 0)
+          : tol_(tol), iterations_(max_iterations), harvest_size_(harvest_size), iters_taken_(0), last_error_(0) {}
+
+        /** @brief Returns the relative tolerance */
+        double tolerance() const { return tol_; }
+        /** @brief Returns the maximum number of iterations */
+        unsigned int max_iterations() const { return iterations_; }
+        /** @brief Returns the number of iterations whose search directions are used for updating the recycled subspace (zero: ten times the size of the subspace) */
+        vcl_size_t harvest_size() const { return harvest_size_; }
+
+        /** @brief Return the number of solver iterations: */
+        unsigned int iters() const { return iters_taken_; }
+        void iters(unsigned int i) const { iters_taken_ = i; }
+
+        /** @brief Returns the estimated relative error at the end of the solver run */
+        double error() const { return last_error_; }
+        /** @brief Sets the estimated relative error at the end of the solver run */
+        void error(double e) const { last_error_ = e; }
+
+      private:
+        double tol_;
+        unsigned int iterations_;
+        vcl_size_t harvest_size_;
+
+        //return values from solver
+        mutable unsigned int iters_taken_;
+        mutable double last_error_;
+    };
+
+
+    namespace detail
+    {
+      /** @brief Solves (W^T A W) mu = rhs with the Cholesky factor L of W^T A W (lower triangular, k x k) */
+      template <typename T>
+      void deflated_cg_solve_small(std::vector< std::vector<T> > const & L, std::vector<T> const & rhs, std::vector<T> & mu)
+      {
+        vcl_size_t k = rhs.size();
+        mu = rhs;
+        for (vcl_size_t i=0; i<k; ++i)
+        {
+          for (vcl_size_t j=0; j<i; ++j)
+            mu[i] -= L[i][j] * mu[j];
+          mu[i] /= L[i][i];
+        }
+        for (vcl_size_t i=k; i-- > 0; )
+        {
+          for (vcl_size_t j=i+1; j<k; ++j)
+            mu[i] -= L[j][i] * mu[j];
+          mu[i] /= L[i][i];
+        }
+      }
+
+      /** @brief Compresses span{Y, P} to the Ritz vectors for the smallest eigenvalues of A by a Rayleigh-Ritz procedure
+      *
+      * Following Section 5 in "A deflated version of the conjugate gradient algorithm" by Y. Saad, M. Yeung, J. Erhel and F. Guyomarc'h, SIAM J. Sci. Comput. 21(5), 2000.
+      * Solves the generalized eigenvalue problem Z^T A Z y = theta Z^T Z y with Z = [Y, P] via the Cholesky factor of Z^T A Z.
+      * Applied repeatedly to windows of search directions, the Ritz vectors accumulate the spectral information of many iterations in a fixed amount of memory.
+      *
+      * @param Y          Current approximate eigenvectors, replaced by the new (A-orthonormal) Ritz vectors
+      * @param AY         Images of Y under A, updated by the same linear combinations
+      * @param P          Search directions
+      * @param AP         Images of the search directions under A
+      * @param count      Number of search directions in P to be used
+      * @param max_size   Maximum number of Ritz vectors
+      * @param Y_new      Scratch storage for the new vectors
+      * @param AY_new     Scratch storage for the images of the new vectors
+      * @param dot_buffer Scratch buffer for the multiple inner products
+      */
+      template <typename T>
+      void deflated_cg_compress(std::vector< viennacl::vector<T> > & Y, std::vector< viennacl::vector<T> > & AY,
+                                std::vector< viennacl::vector<T> > const & P, std::vector< viennacl::vector<T> > const & AP, vcl_size_t count,
+                                vcl_size_t max_size,
+                                std::vector< viennacl::vector<T> > & Y_new, std::vector< viennacl::vector<T> > & AY_new,
+                                viennacl::vector<T> & dot_buffer)
+      {
+        vcl_size_t k = Y.size();
+        vcl_size_t s = k + count;
+        vcl_size_t k_new = std::min(max_size, s);
+        if (k_new == 0)
+          return;
+
+        std::vector<viennacl::vector_base<T> const *> Z(s), AZ(s), Z_and_AZ(2 * s);
+        for (vcl_size_t i=0; i<s; ++i)
+        {
+          Z[i]  = (i < k) ? &(Y[i])  : &(P[i-k]);
+          AZ[i] = (i < k) ? &(AY[i]) : &(AP[i-k]);
+          Z_and_AZ[i]     = Z[i];
+          Z_and_AZ[s + i] = AZ[i];
+        }
+        viennacl::vector_tuple<T> Z_and_AZ_tuple(Z_and_AZ);
+
+        // Gram matrices F = Z^T Z and G = Z^T A Z (symmetrized):
+        std::vector< std::vector<T> > F, G;
+        small_dense_resize(F, s, s);
+        small_dense_resize(G, s, s);
+        std::vector<T> dots;
+        for (vcl_size_t i=0; i<s; ++i)
+        {
+          multi_inner_prod(*Z[i], Z_and_AZ_tuple, dot_buffer, dots);
+          for (vcl_size_t j=0; j<s; ++j)
+          {
+            F[i][j] = dots[j];
+            G[i][j] = dots[s + j];
+          }
+        }
+        for (vcl_size_t i=0; i<s; ++i)
+          for (vcl_size_t j=0; j<i; ++j)
+          {
+            F[i][j] = F[j][i] = (F[i][j] + F[j][i]) / T(2);
+            G[i][j] = G[j][i] = (G[i][j] + G[j][i]) / T(2);
+          }
+
+        // G = L L^T, then the eigenvalues of L^{-1} F L^{-T} are 1/theta:
+        if (!small_dense_cholesky(G, s))  //directions (numerically) dependent, keep the current vectors
+          return;
+        small_dense_invert_lower(G, s);
+
+        std::vector< std::vector<T> > LF, M, evecs;
+        small_dense_resize(LF, s, s);
+        small_dense_resize(M, s, s);
+        for (vcl_size_t i=0; i<s; ++i)
+          for (vcl_size_t j=0; j<s; ++j)
+            for (vcl_size_t l=0; l<=i; ++l)
+              LF[i][j] += G[i][l] * F[l][j];
+        for (vcl_size_t i=0; i<s; ++i)
+          for (vcl_size_t j=0; j<=i; ++j)
+          {
+            T sum = 0;
+            for (vcl_size_t l=0; l<=j; ++l)
+              sum += LF[i][l] * G[j][l];
+            M[i][j] = M[j][i] = sum;
+          }
+        std::vector<T> evals;
+        small_dense_symmetric_eigen(M, s, evals, evecs);
+
+        // coefficients of the new vectors with respect to Z: L^{-T} times the eigenvectors for the largest values of 1/theta:
+        std::vector<T> coeffs(s);
+        Y_new.resize(k_new, P[0]);
+        AY_new.resize(k_new, P[0]);
+        for (vcl_size_t j=0; j<k_new; ++j)
+        {
+          vcl_size_t col = s - 1 - j;
+          for (vcl_size_t i=0; i<s; ++i)
+          {
+            T sum = 0;
+            for (vcl_size_t l=i; l<s; ++l)
+              sum += G[l][i] * evecs[l][col];
+            coeffs[i] = sum;
+          }
+          multi_vector_combination(Z,  coeffs, Y_new[j]);
+          multi_vector_combination(AZ, coeffs, AY_new[j]);
+        }
+        Y.swap(Y_new);
+        AY.swap(AY_new);
+      }
+    }
+
+
+    /** @brief Implementation of the deflated (preconditioned) conjugate gradient solver with subspace recycling
+    *
+    * Following Algorithm 3.6 in "A deflated version of the conjugate gradient algorithm" by Y. Saad, M. Yeung, J. Erhel and F. Guyomarc'h, SIAM J. Sci. Comput. 21(5), 2000.
+    * The search directions are kept A-orthogonal to the recycled vectors W, which removes the corresponding (smallest) eigenvalues from the convergence behavior.
+    * Each iteration requires k additional vector updates and one additional multiple inner product compared to CG, where k is the size of the recycled subspace.
+    * At the beginning of a solve, the images A W are recomputed with the current system matrix (k matrix-vector products).
+    * During the first harvest_size() iterations, approximate eigenvectors to the smallest eigenvalues of A are computed from W and the search directions,
+    * compressing every window of k search directions by a Rayleigh-Ritz procedure. These vectors replace the recycled subspace after the solve.
+    *
+    * @param matrix     The system matrix
+    * @param rhs        The load vector
+    * @param tag        Solver configuration tag
+    * @param precond    A symmetric positive definite preconditioner. Precondition operation is done via member function apply()
+    * @param space      The recycled subspace, updated on exit
+    * @return The result vector
+    */
+    template <typename MatrixType, typename T, typename PreconditionerType>
+    viennacl::vector<T> solve(MatrixType const & matrix, viennacl::vector<T> const & rhs, deflated_cg_tag const & tag, PreconditionerType const & precond,
+                              recycle_space< viennacl::vector<T> > & space)
+    {
+      vcl_size_t n = rhs.size();
+      viennacl::context ctx = viennacl::traits::context(rhs);
+
+      space.prepare(rhs);
+      std::vector< viennacl::vector<T> > & W  = space.U();
+      std::vector< viennacl::vector<T> > & AW = space.C();
+      vcl_size_t harvest_size = (tag.harvest_size() > 0) ? tag.harvest_size() : 10 * space.max_size();
+      vcl_size_t window_size  = space.max_size();
+      if (window_size == 0)
+        harvest_size = 0;
+
+      viennacl::vector<T> result = viennacl::zero_vector<T>(n, ctx);
+      viennacl::vector<T> residual = rhs;
+      viennacl::vector<T> z(n, ctx);
+      viennacl::vector<T> p(n, ctx);
+      viennacl::vector<T> tmp(n, ctx);
+      viennacl::vector<T> dot_buffer(1, ctx);
+
+      tag.iters(0);
+      tag.error(0);
+
+      T norm_rhs = viennacl::linalg::norm_2(rhs);
+      if (norm_rhs == 0) //solution is zero if RHS norm is zero
+        return result;
+
+      //
+      // Images of the recycled vectors under the current matrix and Cholesky factor of W^T A W:
+      //
+      vcl_size_t k = W.size();
+      std::vector< std::vector<T> > L;
+      std::vector<T> dots, mu;
+      std::vector<viennacl::vector_base<T> const *> W_ptrs(k), AW_ptrs(k);
+      if (k > 0)
+      {
+        AW.resize(k, rhs);
+        for (vcl_size_t i=0; i<k; ++i)
+        {
+          AW[i] = viennacl::linalg::prod(matrix, W[i]);
+          W_ptrs[i]  = &(W[i]);
+          AW_ptrs[i] = &(AW[i]);
+        }
+        viennacl::vector_tuple<T> AW_tuple(AW_ptrs);
+
+        detail::small_dense_resize(L, k, k);
+        for (vcl_size_t i=0; i<k; ++i)
+        {
+          detail::multi_inner_prod(W[i], AW_tuple, dot_buffer, dots);
+          for (vcl_size_t j=0; j<k; ++j)
+            L[i][j] += dots[j] / T(2);
+          for (vcl_size_t j=0; j<k; ++j)
+            L[j][i] += dots[j] / T(2);
+        }
+        if (!detail::small_dense_cholesky(L, k))  //recycled vectors (numerically) dependent for this matrix: start over
+        {
+          space.clear();
+          k = 0;
+          W_ptrs.clear();
+          AW_ptrs.clear();
+        }
+      }
+      viennacl::vector_tuple<T> W_tuple(W_ptrs);
+      viennacl::vector_tuple<T> AW_tuple(AW_ptrs);
+
+      // x_0 = W (W^T A W)^{-1} W^T b,  r_0 = b - A x_0:
+      if (k > 0)
+      {
+        detail::multi_inner_prod(rhs, W_tuple, dot_buffer, dots);
+        detail::deflated_cg_solve_small(L, dots, mu);
+        detail::multi_vector_combination(W_ptrs, mu, result);
+        detail::multi_vector_combination(AW_ptrs, mu, tmp);
+        residual -= tmp;
+      }
+
+      // p_0 = z_0 - W mu with (W^T A W) mu = (AW)^T z_0:
+      z = residual;
+      precond.apply(z);
+      p = z;
+      if (k > 0)
+      {
+        detail::multi_inner_prod(z, AW_tuple, dot_buffer, dots);
+        detail::deflated_cg_solve_small(L, dots, mu);
+        detail::multi_vector_combination(W_ptrs, mu, tmp);
+        p -= tmp;
+      }
+
+      // Ritz vectors Y (and A Y) for the update of the recycled subspace, computed from W and windows of search directions:
+      std::vector< viennacl::vector<T> > Y, AY, Y_new, AY_new, P, AP;
+      if (harvest_size > 0)
+      {
+        Y = W;
+        AY = AW;
+        P.resize(window_size, viennacl::vector<T>(n, ctx));
+        AP.resize(window_size, viennacl::vector<T>(n, ctx));
+      }
+      vcl_size_t num_harvested = 0;
+      vcl_size_t num_in_window = 0;
+
+      std::vector<T> rz_rr;
+      T ip_rz = viennacl::linalg::inner_prod(residual, z);
+      T norm_res = viennacl::linalg::norm_2(residual);
+      for (unsigned int i = 0; i < tag.max_iterations() && norm_res / norm_rhs >= tag.tolerance(); ++i)
+      {
+        tag.iters(i+1);
+        tmp = viennacl::linalg::prod(matrix, p);
+        T ip_pAp = viennacl::linalg::inner_prod(tmp, p);
+        if (ip_pAp <= 0)  //matrix (numerically) not positive definite on the search space
+          break;
+
+        if (num_harvested < harvest_size)
+        {
+          P[num_in_window]  = p;
+          AP[num_in_window] = tmp;
+          ++num_harvested;
+          if (++num_in_window == window_size)
+          {
+            detail::deflated_cg_compress(Y, AY, P, AP, num_in_window, space.max_size(), Y_new, AY_new, dot_buffer);
+            num_in_window = 0;
+          }
+        }
+
+        T alpha = ip_rz / ip_pAp;
+        result   += alpha * p;
+        residual -= alpha * tmp;
+
+        z = residual;
+        precond.apply(z);
+
+        viennacl::vector_tuple<T> z_and_r(z, residual);
+        detail::multi_inner_prod(residual, z_and_r, dot_buffer, rz_rr);
+        norm_res = std::sqrt(rz_rr[1]);
+        if (norm_res / norm_rhs < tag.tolerance())
+          break;
+
+        T beta = rz_rr[0] / ip_rz;
+        ip_rz = rz_rr[0];
+
+        p = z + beta * p;
+        if (k > 0)
+        {
+          detail::multi_inner_prod(z, AW_tuple, dot_buffer, dots);
+          detail::deflated_cg_solve_small(L, dots, mu);
+          detail::multi_vector_combination(W_ptrs, mu, tmp);
+          p -= tmp;
+        }
+      }
+
+      //store last error estimate:
+      tag.error(norm_res / norm_rhs);
+
+      // update the recycled subspace:
+      if (num_harvested > 0)
+      {
+        if (num_in_window > 0)
+          detail::deflated_cg_compress(Y, AY, P, AP, num_in_window, space.max_size(), Y_new, AY_new, dot_buffer);
+        W.swap(Y);
+        AW.clear();  //recomputed with the system matrix of the next solve
+      }
+
+      return result;
+    }
+
+    /** @brief Convenience overload of the solve() function using deflated CG. Per default, no preconditioner is used
+    */
+    template <typename MatrixType, typename T>
+    viennacl::vector<T> solve(MatrixType const & matrix, viennacl::vector<T> const & rhs, deflated_cg_tag const & tag,
+                              recycle_space< viennacl::vector<T> > & space)
+    {
+      return solve(matrix, rhs, tag, viennacl::linalg::no_precond(), space);
+    }
+
+  }
+}
+
+#endif
@@ -28,7 +28,7 @@
 #include <boost/numeric/ublas/vector.hpp>
 #include <cmath>
 #include <set>
-#include <list>
+#include <vector>
 #include <algorithm>
 
 #include <map>
@@ -36,6 +36,10 @@
 #include <omp.h>
 #endif
 
+#include "viennacl/forwards.h"
+#include "viennacl/backend/memory.hpp"
+#include "viennacl/backend/util.hpp"
+
 #include "amg_debug.hpp"
 
 #define VIENNACL_AMG_COARSE_RS 1
@@ -47,6 +51,8 @@
 #define VIENNACL_AMG_INTERPOL_CLASSIC 2
 #define VIENNACL_AMG_INTERPOL_AG 3
 #define VIENNACL_AMG_INTERPOL_SA 4
+#define VIENNACL_AMG_SMOOTHER_JACOBI 1
+#define VIENNACL_AMG_SMOOTHER_CHEBYSHEV 2
 
 namespace viennacl
 {
@@ -83,7 +89,7 @@ namespace viennacl
                     unsigned int coarselevels = 0)
             : coarse_(coarse), interpol_(interpol),
               threshold_(threshold), interpolweight_(interpolweight), jacobiweight_(jacobiweight),
-              presmooth_(presmooth), postsmooth_(postsmooth), coarselevels_(coarselevels) {}
+              presmooth_(presmooth), postsmooth_(postsmooth), coarselevels_(coarselevels), smoother_(VIENNACL_AMG_SMOOTHER_JACOBI), slices_(0) {}
 
             // Getter-/Setter-Functions
             void set_coarse(unsigned int coarse) { if (coarse > 0) coarse_ = coarse; }
@@ -110,1072 +116,561 @@ namespace viennacl
             void set_coarselevels(int coarselevels)  { if (coarselevels >= 0) coarselevels_ = coarselevels; }
             unsigned int get_coarselevels() const { return coarselevels_; }
 
+            /** @brief Sets the smoother (VIENNACL_AMG_SMOOTHER_JACOBI or VIENNACL_AMG_SMOOTHER_CHEBYSHEV). For the Chebyshev smoother, the number of pre- and postsmoothing steps is the polynomial degree. */
+            void set_smoother(unsigned int smoother) { if (smoother > 0) smoother_ = smoother; }
+            unsigned int get_smoother() const { return smoother_; }
+
+            /** @brief Sets the number of slices the system matrix is partitioned into for the parallel coarsenings VIENNACL_AMG_COARSE_RS0 and VIENNACL_AMG_COARSE_RS3 (Default: 0 = number of processors if OpenMP is enabled, otherwise one slice) */
+            void set_slices(unsigned int slices) { slices_ = slices; }
+            unsigned int get_slices() const { return slices_; }
+
           private:
             unsigned int coarse_, interpol_;
             double threshold_, interpolweight_, jacobiweight_;
             unsigned int presmooth_, postsmooth_, coarselevels_;
+            unsigned int smoother_;
+            unsigned int slices_;
         };
 
-        /** @brief A class for a scalar that can be written to the sparse matrix or sparse vector datatypes.
-        *  @brief Values are only written to those datatypes if non-zero to optimize memory usage and performance.
-        *  @brief Needed for the []- and ()-operators.
-        */
-        template <typename InternalType, typename IteratorType, typename ScalarType>
-        class amg_nonzero_scalar
-        {
-          private:
-            InternalType *m_;
-            IteratorType iter_;
-            unsigned int i_,j_;
-            ScalarType s_;
-
-          public:
-            amg_nonzero_scalar();
-
-            /** @brief The constructor.
-            *  @param m    Pointer to the sparse vector/matrix the scalar will be written to
-            *  @param iter    Iterator pointing to the respective element in the vector/matrix if available
-            *  @param i    Row index scalar will be written to
-            *  @param j    Col index scalar will be written to
-            *  @param s    Value of the scalar (usually used as dummy here as it will be set by the assignment operator)
-            */
-            amg_nonzero_scalar(InternalType *m,
-                              IteratorType & iter,
-                              unsigned int i,
-                              unsigned int j,
-                              ScalarType s = 0): m_(m), iter_(iter), i_(i), j_(j), s_(s) {}
-
-            /** @brief Assignment operator. Writes value into matrix at the given position.
-            *  @param value  Value that will be written
-            */
-            ScalarType operator = (const ScalarType value)
-            {
-              s_ = value;
-              // Only write if scalar is nonzero
-              if (s_ == 0) return s_;
-              // Write to m_ using iterator iter_ or indices (i_,j_)
-              m_->addscalar (iter_,i_,j_,s_);
-              return s_;
-            }
-
-            /** @brief Addition operator. Adds a constant.
-            *  @param value  Value that will be written
-            */
-            ScalarType operator += (const ScalarType value)
-            {
-              // If zero is added, then no change necessary
-              if (value == 0)
-                return s_;
-
-              s_ += value;
-              // Remove entry if resulting scalar is zero
-              if (s_ == 0)
-              {
-                m_->removescalar(iter_,i_);
-                return s_;
-              }
-              //Write to m_ using iterator iter_ or indices (i_,j_)
-              m_->addscalar (iter_,i_,j_,s_);
-              return s_;
-            }
-            ScalarType operator ++ (int)
-            {
-              s_++;
-              if (s_ == 0)
-                m_->removescalar(iter_,i_);
-              m_->addscalar (iter_,i_,j_,s_);
-              return s_;
-            }
-            ScalarType operator ++ ()
-            {
-              s_++;
-              if (s_ == 0)
-                m_->removescalar(iter_,i_);
-              m_->addscalar (iter_,i_,j_,s_);
-              return s_;
-            }
-            operator ScalarType (void) { return s_;  }
-        };
+        template <typename ScalarType>
+        class amg_sparsematrix;
 
-        /** @brief Defines an iterator for the sparse vector type.
-        */
-        template <typename InternalType>
-        class amg_sparsevector_iterator
+        /** @brief Iterator over the entries of a row of amg_sparsematrix. Provides the interface of ublas iterators needed by viennacl::copy(). */
+        template <typename ScalarType>
+        class amg_sparsematrix_const_iterator2
         {
-          private:
-            typedef amg_sparsevector_iterator<InternalType> self_type;
-            typedef typename InternalType::mapped_type ScalarType;
-
-            InternalType & internal_vec;
-            typename InternalType::iterator iter;
+            typedef amg_sparsematrix_const_iterator2<ScalarType> self_type;
 
           public:
+            amg_sparsematrix_const_iterator2(amg_sparsematrix<ScalarType> const & mat, vcl_size_t row, vcl_size_t index) : mat_(&mat), row_(row), index_(index) {}
 
-            /** @brief The constructor.
-            *  @param vec    Internal sparse vector
-            *  @param begin  Whether the iterator starts at the beginning or end of vec
-            */
-            amg_sparsevector_iterator(InternalType & vec, bool begin=true): internal_vec(vec)
-            {
-              if (begin)
-                iter = internal_vec.begin();
-              else
-                iter = internal_vec.end();
-            }
+            bool operator == (self_type const & other) const { return index_ == other.index_; }
+            bool operator != (self_type const & other) const { return index_ != other.index_; }
 
-            bool operator == (self_type other)
-            {
-              if (iter == other.iter)
-                return true;
-              else
-                return false;
-            }
-            bool operator != (self_type other)
-            {
-              if (iter != other.iter)
-                return true;
-              else
-                return false;
-            }
+            self_type & operator ++ () { ++index_; return *this; }
+            ScalarType operator * () const { return mat_->elements()[index_]; }
+            vcl_size_t index1() const { return row_; }
+            vcl_size_t index2() const { return mat_->col_buffer()[index_]; }
 
-            self_type & operator ++ () const { iter++; return *this; }
-            self_type & operator ++ () { iter++; return *this; }
-            self_type & operator -- () const { iter--; return *this; }
-            self_type & operator -- () { iter--; return *this; }
-            ScalarType & operator * () const { return (*iter).second; }
-            ScalarType & operator * () { return (*iter).second; }
-            unsigned int index() const { return (*iter).first; }
-            unsigned int index() { return (*iter).first; }
+          private:
+            amg_sparsematrix<ScalarType> const * mat_;
+            vcl_size_t row_;
+            vcl_size_t index_;
         };
 
-        /** @brief A class for the sparse vector type.
-        */
+        /** @brief Iterator over the rows of amg_sparsematrix. Provides the interface of ublas iterators needed by viennacl::copy(). */
         template <typename ScalarType>
-        class amg_sparsevector
+        class amg_sparsematrix_const_iterator1
         {
-          public:
-            typedef ScalarType value_type;
-
-          private:
-            // A map is used internally which saves all non-zero elements with pairs of (index,value)
-            typedef std::map<unsigned int,ScalarType> InternalType;
-            typedef amg_sparsevector<ScalarType> self_type;
-            typedef amg_nonzero_scalar<self_type,typename InternalType::iterator,ScalarType> NonzeroScalarType;
-
-            // Size is only a dummy variable. Not needed for internal map structure but for compatible vector interface.
-            unsigned int size_;
-            InternalType internal_vector;
+            typedef amg_sparsematrix_const_iterator1<ScalarType> self_type;
 
           public:
-            typedef amg_sparsevector_iterator<InternalType> iterator;
-            typedef typename InternalType::const_iterator const_iterator;
+            amg_sparsematrix_const_iterator1(amg_sparsematrix<ScalarType> const & mat, vcl_size_t row) : mat_(&mat), row_(row) {}
 
-          public:
-            /** @brief The constructor.
-            *  @param size    Size of the vector
-            */
-            amg_sparsevector(unsigned int size = 0): size_(size)
-            {
-              internal_vector = InternalType();
-            }
+            bool operator == (self_type const & other) const { return row_ == other.row_; }
+            bool operator != (self_type const & other) const { return row_ != other.row_; }
 
-            void resize(unsigned int size) { size_ = size; }
-            unsigned int size() const { return size_;}
+            self_type & operator ++ () { ++row_; return *this; }
+            self_type & operator += (vcl_size_t offset) { row_ += offset; return *this; }
+            vcl_size_t index1() const { return row_; }
 
-            // Returns number of non-zero entries in vector equal to the size of the underlying map.
-            unsigned int internal_size() const { return static_cast<unsigned int>(internal_vector.size()); }
-            // Delete underlying map.
-            void clear() { internal_vector.clear();  }
-            // Remove entry at position i.
-            void remove(unsigned int i) { internal_vector.erase(i); }
+            amg_sparsematrix_const_iterator2<ScalarType> begin() const { return amg_sparsematrix_const_iterator2<ScalarType>(*mat_, row_, mat_->row_buffer()[row_]); }
+            amg_sparsematrix_const_iterator2<ScalarType> end()   const { return amg_sparsematrix_const_iterator2<ScalarType>(*mat_, row_, mat_->row_buffer()[row_+1]); }
 
-            // Add s to the entry at position i
-            void add (unsigned int i, ScalarType s)
-            {
-              typename InternalType::iterator iter = internal_vector.find(i);
-              // If there is no entry at position i, add new entry at that position
-              if (iter == internal_vector.end())
-                addscalar(iter,i,i,s);
-              else
-              {
-                s += (*iter).second;
-                // If new value is zero, then erase the entry, otherwise write new value
-                if (s != 0)
-                  (*iter).second = s;
-                else
-                  internal_vector.erase(iter);
-              }
-            }
-
-            // Write to the map. Is called from non-zero scalar type.
-            template <typename IteratorType>
-            void addscalar(IteratorType & iter, unsigned int i, unsigned int /* j */, ScalarType s)
-            {
-              // Don't write if value is zero
-              if (s == 0)
-                return;
-
-              // If entry is already present, overwrite value, otherwise make new entry
-              if (iter != internal_vector.end())
-                (*iter).second = s;
-              else
-                internal_vector[i] = s;
-            }
-
-            // Remove value from the map. Is called from non-zero scalar type.
-            template <typename IteratorType>
-            void removescalar(IteratorType & iter, unsigned int /* i */) { internal_vector.erase(iter); }
-
-            // Bracket operator. Returns non-zero scalar type with actual values of the respective entry which calls addscalar/removescalar after value is altered.
-            NonzeroScalarType operator [] (unsigned int i)
-            {
-              typename InternalType::iterator it = internal_vector.find(i);
-              // If value is already present then build non-zero scalar with actual value, otherwise 0.
-              if (it != internal_vector.end())
-                return NonzeroScalarType (this,it,i,i,(*it).second);
-              else
-                return NonzeroScalarType (this,it,i,i,0);
-            }
-
-            // Use internal data structure directly for read-only access. No need to use non-zero scalar as no write access possible.
-            ScalarType operator [] (unsigned int i) const
-            {
-              const_iterator it = internal_vector.find(i);
-
-              if (it != internal_vector.end())
-                return (*it).second;
-              else
-                return 0;
-            }
-
-            // Iterator functions.
-            iterator begin() { return iterator(internal_vector); }
-            const_iterator begin() const { return internal_vector.begin(); }
-            iterator end() { return iterator(internal_vector,false); }
-            const_iterator end() const { return internal_vector.end(); }
-
-            // checks whether value at index i is nonzero. More efficient than doing [] == 0.
-            bool isnonzero(unsigned int i) const { return internal_vector.find(i) != internal_vector.end();  }
-
-            // Copies data into a ublas vector type.
-            operator boost::numeric::ublas::vector<ScalarType> (void)
-            {
-              boost::numeric::ublas::vector<ScalarType> vec (size_);
-              for (iterator iter = begin(); iter != end(); ++iter)
-                vec [iter.index()] = *iter;
-              return vec;
-            }
-         };
+          private:
+            amg_sparsematrix<ScalarType> const * mat_;
+            vcl_size_t row_;
+        };
 
-        /** @brief A class for the sparse matrix type.
-        *  Uses vector of maps as data structure for higher performance and lower memory usage.
-        *  Uses similar interface as ublas::compressed_matrix.
-        *  Can deal with transposed of matrix internally: Creation, Storage, Iterators, etc.
+        /** @brief A sparse matrix in compressed sparse row (CSR) format used throughout the AMG setup phase.
+        *
+        *  The entries of row i are located at positions row_buffer()[i], ..., row_buffer()[i+1]-1 of col_buffer() and elements().
+        *  Column indices are sorted in ascending order within each row, which allows for lookups by binary search.
+        *  Compared to a std::map per row, the memory footprint is only a fraction and all entries are traversed contiguously.
         */
         template <typename ScalarType>
         class amg_sparsematrix
         {
           public:
             typedef ScalarType value_type;
-          private:
-            typedef std::map<unsigned int,ScalarType> RowType;
-            typedef std::vector<RowType> InternalType;
-            typedef amg_sparsematrix<ScalarType> self_type;
-
-            // Adapter is used for certain functionality, especially iterators.
-            typedef typename viennacl::tools::sparse_matrix_adapter<ScalarType> AdapterType;
-            typedef typename viennacl::tools::const_sparse_matrix_adapter<ScalarType> ConstAdapterType;
-
-            // Non-zero scalar is used to write to the matrix.
-            typedef amg_nonzero_scalar<self_type,typename RowType::iterator,ScalarType> NonzeroScalarType;
-
-            // Holds matrix coefficients.
-            InternalType internal_mat;
-            // Holds matrix coefficient of transposed matrix if built.
-            // Note: Only internal_mat is written using operators and methods while internal_mat_trans is built from internal_mat using do_trans().
-            InternalType internal_mat_trans;
-            // Saves sizes.
-            vcl_size_t s1, s2;
-
-            // True if the transposed of the matrix is used (for calculations, iteration, etc.).
-            bool transposed_mode;
-            // True if the transposed is already built (saved in internal_mat_trans) and also up to date (no changes to internal_mat).
-            bool transposed;
-
-          public:
-            typedef typename AdapterType::iterator1 iterator1;
-            typedef typename AdapterType::iterator2 iterator2;
-            typedef typename ConstAdapterType::const_iterator1 const_iterator1;
-            typedef typename ConstAdapterType::const_iterator2 const_iterator2;
+            typedef vcl_size_t size_type;
+            typedef amg_sparsematrix_const_iterator1<ScalarType> const_iterator1;
+            typedef amg_sparsematrix_const_iterator2<ScalarType> const_iterator2;
 
             /** @brief Standard constructor. */
-            amg_sparsematrix ()
-            {
-              transposed_mode = false;
-              transposed = false;
-            }
+            amg_sparsematrix() : s1_(0), s2_(0), row_buffer_(1, 0) {}
 
-            /** @brief Constructor. Builds matrix of size (i,j).
+            /** @brief Constructor. Builds an empty matrix of size (i,j).
               * @param i  Size of first dimension
               * @param j  Size of second dimension
               */
-            amg_sparsematrix (unsigned int i, unsigned int j)
-            {
-              AdapterType a (internal_mat, i, j);
-              a.resize (i,j,false);
-              AdapterType a_trans (internal_mat_trans, j, i);
-              a_trans.resize (j,i,false);
-              s1 = i;
-              s2 = j;
-              a.clear();
-              a_trans.clear();
-              transposed_mode = false;
-              transposed = false;
-            }
+            amg_sparsematrix(vcl_size_t i, vcl_size_t j) : s1_(i), s2_(j), row_buffer_(i+1, 0) {}
 
             /** @brief Constructor. Builds matrix via std::vector<std::map> by copying memory
-            * (Only necessary feature of this other matrix type is to have const iterators)
             * @param mat  Vector of maps
             */
-            amg_sparsematrix (std::vector<std::map<unsigned int, ScalarType> > const & mat)
+            amg_sparsematrix(std::vector<std::map<unsigned int, ScalarType> > const & mat) : s1_(mat.size()), s2_(mat.size()), row_buffer_(mat.size()+1, 0)
             {
-              AdapterType a (internal_mat, mat.size(), mat.size());
-              AdapterType a_trans (internal_mat_trans, mat.size(), mat.size());
-              a.resize(mat.size(), mat.size());
-              a_trans.resize(mat.size(), mat.size());
-
-              internal_mat = mat;
-              s1 = s2 = mat.size();
+              vcl_size_t nonzeros = 0;
+              for (vcl_size_t i=0; i<mat.size(); ++i)
+                nonzeros += mat[i].size();
+              col_buffer_.reserve(nonzeros);
+              elements_.reserve(nonzeros);
 
-              transposed_mode = false;
-              transposed = false;
+              for (vcl_size_t i=0; i<mat.size(); ++i)
+              {
+                for (typename std::map<unsigned int, ScalarType>::const_iterator iter = mat[i].begin(); iter != mat[i].end(); ++iter)
+                {
+                  col_buffer_.push_back(iter->first);
+                  elements_.push_back(iter->second);
+                }
+                row_buffer_[i+1] = static_cast<unsigned int>(elements_.size());
+              }
             }
 
             /** @brief Constructor. Builds matrix via another matrix type.
-              * (Only necessary feature of this other matrix type is to have const iterators)
+              * (Only necessary feature of this other matrix type is to have const iterators with entries sorted by column index)
               * @param mat  Matrix
               */
             template <typename MatrixType>
-            amg_sparsematrix (MatrixType const & mat)
+            amg_sparsematrix(MatrixType const & mat) : s1_(mat.size1()), s2_(mat.size2()), row_buffer_(mat.size1()+1, 0)
             {
-              AdapterType a (internal_mat, mat.size1(), mat.size2());
-              AdapterType a_trans (internal_mat_trans, mat.size2(), mat.size1());
-              a.resize(mat.size1(), mat.size2());
-              a_trans.resize(mat.size2(), mat.size1());
-              s1 = mat.size1();
-              s2 = mat.size2();
-              a.clear();
-              a_trans.clear();
-
               for (typename MatrixType::const_iterator1 row_iter = mat.begin1(); row_iter != mat.end1(); ++row_iter)
               {
                 for (typename MatrixType::const_iterator2 col_iter = row_iter.begin(); col_iter != row_iter.end(); ++col_iter)
                 {
                   if (*col_iter != 0)
                   {
-                    unsigned int x = static_cast<unsigned int>(col_iter.index1());
-                    unsigned int y = static_cast<unsigned int>(col_iter.index2());
-                    a (x,y) = *col_iter;
-                    a_trans (y,x) = *col_iter;
+                    col_buffer_.push_back(static_cast<unsigned int>(col_iter.index2()));
+                    elements_.push_back(*col_iter);
                   }
                 }
+                row_buffer_[row_iter.index1() + 1] = static_cast<unsigned int>(elements_.size());
               }
-              transposed_mode = false;
-              transposed = true;
-            }
 
-            // Build transposed of the current matrix.
-            void do_trans()
-            {
-              // Do it only once if called in a parallel section
-            #ifdef VIENNACL_WITH_OPENMP
-              #pragma omp critical
-            #endif
-              {
-                // Only build transposed if it is not built or not up to date
-                if (!transposed)
-                {
-                  // Mode has to be set to standard mode temporarily
-                  bool save_mode = transposed_mode;
-                  transposed_mode = false;
-
-                  for (iterator1 row_iter = begin1(); row_iter != end1(); ++row_iter)
-                    for (iterator2 col_iter = row_iter.begin(); col_iter != row_iter.end(); ++col_iter)
-                      internal_mat_trans[col_iter.index2()][static_cast<unsigned int>(col_iter.index1())] = *col_iter;
-
-                  transposed_mode = save_mode;
-                  transposed = true;
-                }
-              }
-            } //do_trans()
-
-            // Set transposed mode (true=transposed, false=regular)
-            void set_trans(bool mode)
-            {
-              transposed_mode = mode;
-              if (mode)
-                do_trans();
+              // Rows skipped by the iterators are empty:
+              for (vcl_size_t i=0; i<s1_; ++i)
+                row_buffer_[i+1] = std::max(row_buffer_[i+1], row_buffer_[i]);
             }
 
-            bool get_trans() const { return transposed_mode; }
-
-            // Checks whether coefficient (i,j) is non-zero. More efficient than using (i,j) == 0.
-            bool isnonzero (unsigned int i, unsigned int j) const
-            {
-              if (!transposed_mode)
-              {
-                if (internal_mat[i].find(j) != internal_mat[i].end())
-                  return true;
-                else
-                  return false;
-              }
-              else
-              {
-                if (internal_mat[j].find(i) != internal_mat[j].end())
-                  return true;
-                else
-                  return false;
-              }
-            } //isnonzero()
-
-            // Add s to value at (i,j)
-            void add (unsigned int i, unsigned int j, ScalarType s)
+            /** @brief Constructor. Copies a compressed_matrix from its memory domain. */
+            template <unsigned int ALIGNMENT>
+            amg_sparsematrix(viennacl::compressed_matrix<ScalarType, ALIGNMENT> const & mat) : s1_(mat.size1()), s2_(mat.size2()), row_buffer_(mat.size1()+1, 0)
             {
-              // If zero is added then do nothing.
-              if (s == 0)
+              if (mat.nnz() == 0)
                 return;
 
-              typename RowType::iterator col_iter = internal_mat[i].find(j);
-              // If there is no entry at position (i,j), then make new entry.
-              if (col_iter == internal_mat[i].end())
-                addscalar(col_iter,i,j,s);
-              else
-              {
-                s += (*col_iter).second;
-                // Update value and erase entry if value is zero.
-                if (s != 0)
-                  (*col_iter).second = s;
-                else
-                  internal_mat[i].erase(col_iter);
-              }
-              transposed = false;
-            } //add()
+              viennacl::backend::typesafe_host_array<unsigned int> row_buffer(mat.handle1(), mat.size1() + 1);
+              viennacl::backend::typesafe_host_array<unsigned int> col_buffer(mat.handle2(), mat.nnz());
+              std::vector<ScalarType> elements(mat.nnz());
 
-            // Write to the internal data structure. Is called from non-zero scalar type.
-            template <typename IteratorType>
-            void addscalar(IteratorType & iter, unsigned int i, unsigned int j, ScalarType s)
-            {
-              // Don't write if value is zero
-              if (s == 0)
-                return;
+              viennacl::backend::memory_read(mat.handle1(), 0, row_buffer.raw_size(), row_buffer.get());
+              viennacl::backend::memory_read(mat.handle2(), 0, col_buffer.raw_size(), col_buffer.get());
+              viennacl::backend::memory_read(mat.handle(),  0, sizeof(ScalarType) * mat.nnz(), &(elements[0]));
 
-              if (iter != internal_mat[i].end())
-                (*iter).second = s;
-              else
-                internal_mat[i][j] = s;
-
-              transposed = false;
-            }
-
-            // Remove entry from internal data structure. Is called from non-zero scalar type.
-            template <typename IteratorType>
-            void removescalar(IteratorType & iter, unsigned int i)
-            {
-              internal_mat[i].erase(iter);
-              transposed = false;
-            }
-
-            // Return non-zero scalar at position (i,j). Value is written to the non-zero scalar and updated via addscalar()/removescalar().
-            NonzeroScalarType operator()(unsigned int i, unsigned int j)
-            {
-              typename RowType::iterator iter;
-
-              if (!transposed_mode)
-              {
-                iter = internal_mat[i].find(j);
-                if (iter != internal_mat[i].end())
-                  return NonzeroScalarType (this,iter,i,j,(*iter).second);
-                else
-                  return NonzeroScalarType (this,iter,i,j,0);
-              }
-              else
+              col_buffer_.reserve(mat.nnz());
+              elements_.reserve(mat.nnz());
+              for (vcl_size_t i=0; i<s1_; ++i)
               {
-                iter = internal_mat[j].find(i);
-                if (iter != internal_mat[j].end())
-                  return NonzeroScalarType (this,iter,j,i,(*iter).second);
-                else
-                  return NonzeroScalarType (this,iter,j,i,0);
+                for (vcl_size_t k=row_buffer[i]; k<row_buffer[i+1]; ++k)
+                {
+                  if (elements[k] != 0) //also skips padding due to alignment
+                  {
+                    col_buffer_.push_back(static_cast<unsigned int>(col_buffer[k]));
+                    elements_.push_back(elements[k]);
+                  }
+                }
+                row_buffer_[i+1] = static_cast<unsigned int>(elements_.size());
               }
             }
 
-            // For read-only access return the actual value directly. Non-zero datatype not needed as no write access possible.
-            ScalarType operator()(unsigned int i, unsigned int j) const
+            /** @brief Resizes the matrix to size (i,j) with storage for 'nonzeros' entries. All rows are set to be empty. */
+            void resize(vcl_size_t i, vcl_size_t j, vcl_size_t nonzeros = 0)
             {
-              typename RowType::const_iterator iter;
-
-              if (!transposed_mode)
-              {
-                iter = internal_mat[i].find(j);
-                if (iter != internal_mat[i].end())
-                  return (*iter).second;
-                else
-                  return 0;
-              }
-              else
-              {
-                iter = internal_mat[j].find(i);
-                if (iter != internal_mat[j].end())
-                  return (*iter).second;
-                else
-                  return 0;
-              }
+              s1_ = i;
+              s2_ = j;
+              row_buffer_.assign(i+1, 0);
+              col_buffer_.resize(nonzeros);
+              elements_.resize(nonzeros);
             }
 
-            void resize(unsigned int i, unsigned int j, bool preserve = true)
-            {
-              AdapterType a (internal_mat);
-              a.resize(i,j,preserve);
-              AdapterType a_trans (internal_mat_trans);
-              a_trans.resize(j,i,preserve);
-              s1 = i;
-              s2 = j;
-            }
+            vcl_size_t size1() const { return s1_; }
+            vcl_size_t size2() const { return s2_; }
+            vcl_size_t nnz() const { return row_buffer_[s1_]; }
 
-            void clear()
+            // Returns the value at (i,j). Lookup via binary search within row i.
+            ScalarType operator()(unsigned int i, unsigned int j) const
             {
-              AdapterType a (internal_mat, s1, s2);
-              a.clear();
-              AdapterType a_trans (internal_mat_trans, s2, s1);
-              a_trans.clear();
-              transposed = true;
+              std::vector<unsigned int>::const_iterator row_begin = col_buffer_.begin() + row_buffer_[i];
+              std::vector<unsigned int>::const_iterator row_end   = col_buffer_.begin() + row_buffer_[i+1];
+              std::vector<unsigned int>::const_iterator iter = std::lower_bound(row_begin, row_end, j);
+              if (iter != row_end && *iter == j)
+                return elements_[iter - col_buffer_.begin()];
+              return 0;
             }
 
-            vcl_size_t size1()
-            {
-              if (!transposed_mode)
-                return s1;
-              else
-                return s2;
-            }
+            const_iterator1 begin1() const { return const_iterator1(*this, 0); }
+            const_iterator1 end1()   const { return const_iterator1(*this, s1_); }
 
-            vcl_size_t size1() const
-            {
-              if (!transposed_mode)
-                return s1;
-              else
-                return s2;
-            }
+            // Direct access to the CSR arrays.
+            std::vector<unsigned int> const & row_buffer() const { return row_buffer_; }
+            std::vector<unsigned int>       & row_buffer()       { return row_buffer_; }
+            std::vector<unsigned int> const & col_buffer() const { return col_buffer_; }
+            std::vector<unsigned int>       & col_buffer()       { return col_buffer_; }
+            std::vector<ScalarType>   const & elements()   const { return elements_; }
+            std::vector<ScalarType>         & elements()         { return elements_; }
 
+          private:
+            vcl_size_t s1_, s2_;
+            std::vector<unsigned int> row_buffer_;
+            std::vector<unsigned int> col_buffer_;
+            std::vector<ScalarType>   elements_;
+        };
 
-            vcl_size_t size2()
-            {
-              if (!transposed_mode)
-                return s2;
-              else
-                return s1;
-            }
+        /** @brief Removes the unused tail of each row of a matrix which was allocated for an upper bound of the number of entries per row.
+        *
+        * @param A            Matrix with row i being written to positions A.row_buffer()[i], ..., A.row_buffer()[i] + row_lengths[i] - 1
+        * @param row_lengths  Actual number of entries of each row
+        */
+        template <typename ScalarType>
+        void amg_compress(amg_sparsematrix<ScalarType> & A, std::vector<unsigned int> const & row_lengths)
+        {
+          std::vector<unsigned int> & row_buffer = A.row_buffer();
+          std::vector<unsigned int> & col_buffer = A.col_buffer();
+          std::vector<ScalarType>   & elements   = A.elements();
 
-            vcl_size_t size2() const
+          unsigned int index = 0;
+          for (vcl_size_t i=0; i<A.size1(); ++i)
+          {
+            unsigned int row_start = row_buffer[i];
+            row_buffer[i] = index;
+            for (unsigned int k=row_start; k<row_start + row_lengths[i]; ++k, ++index)
             {
-              if (!transposed_mode)
-                return s2;
-              else
-                return s1;
+              col_buffer[index] = col_buffer[k];
+              elements[index]   = elements[k];
             }
+          }
+          row_buffer[A.size1()] = index;
+          col_buffer.resize(index);
+          elements.resize(index);
+        }
 
-            iterator1 begin1(bool trans = false)
+        /** @brief Computes the transposed of a matrix. Rows of the result are sorted as a consequence of the traversal order.
+        *
+        * @param A        The matrix to be transposed
+        * @param A_trans  The result matrix
+        */
+        template <typename ScalarType>
+        void amg_transpose(amg_sparsematrix<ScalarType> const & A, amg_sparsematrix<ScalarType> & A_trans)
+        {
+          std::vector<unsigned int> const & row_buffer = A.row_buffer();
+          std::vector<unsigned int> const & col_buffer = A.col_buffer();
+          std::vector<ScalarType>   const & elements   = A.elements();
+
+          A_trans.resize(A.size2(), A.size1(), A.nnz());
+          std::vector<unsigned int> & trans_row_buffer = A_trans.row_buffer();
+          std::vector<unsigned int> & trans_col_buffer = A_trans.col_buffer();
+          std::vector<ScalarType>   & trans_elements   = A_trans.elements();
+
+          // Count entries per column, then determine offsets:
+          for (vcl_size_t k=0; k<A.nnz(); ++k)
+            ++trans_row_buffer[col_buffer[k] + 1];
+          for (vcl_size_t j=0; j<A.size2(); ++j)
+            trans_row_buffer[j+1] += trans_row_buffer[j];
+
+          std::vector<unsigned int> position(trans_row_buffer.begin(), trans_row_buffer.end() - 1);
+          for (vcl_size_t i=0; i<A.size1(); ++i)
+          {
+            for (unsigned int k=row_buffer[i]; k<row_buffer[i+1]; ++k)
             {
-              if (!trans && !transposed_mode)
-              {
-                AdapterType a (internal_mat, s1, s2);
-                return a.begin1();
-              }
-              else
-              {
-                do_trans();
-                AdapterType a_trans (internal_mat_trans, s2, s1);
-                return a_trans.begin1();
-              }
+              unsigned int index = position[col_buffer[k]]++;
+              trans_col_buffer[index] = static_cast<unsigned int>(i);
+              trans_elements[index]   = elements[k];
             }
+          }
+        }
 
-            iterator1 end1(bool trans = false)
-            {
-              if (!trans && !transposed_mode)
-              {
-                AdapterType a (internal_mat, s1, s2);
-                return a.end1();
-              }
-              else
-              {
-                //do_trans();
-                AdapterType a_trans (internal_mat_trans, s2, s1);
-                return a_trans.end1();
-              }
-            }
+        /** @brief Copies a matrix to another matrix type (ublas-like, requires resize(), clear() and operator()). Entries are written in row-major order.
+        *
+        * @param A     The source matrix
+        * @param mat   The target matrix
+        */
+        template <typename ScalarType, typename MatrixType>
+        void amg_copy(amg_sparsematrix<ScalarType> const & A, MatrixType & mat)
+        {
+          mat.resize(A.size1(), A.size2(), false);
+          mat.clear();
 
-            iterator2 begin2(bool trans = false)
-            {
-              if (!trans && !transposed_mode)
-              {
-                AdapterType a (internal_mat, s1, s2);
-                return a.begin2();
-              }
-              else
-              {
-                do_trans();
-                AdapterType a_trans (internal_mat_trans, s2, s1);
-                return a_trans.begin2();
-              }
-            }
+          for (vcl_size_t i=0; i<A.size1(); ++i)
+            for (unsigned int k=A.row_buffer()[i]; k<A.row_buffer()[i+1]; ++k)
+              mat(i, A.col_buffer()[k]) = A.elements()[k];
+        }
+
+        /** @brief Sparse matrix product. Calculates RES = A*B. Multithreaded!
+          *
+          * Rows of the result are computed independently: A symbolic pass determines an upper bound for the number of entries of each row,
+          * the numeric pass then accumulates each row in a dense work array of the calling thread. Entries which cancel out exactly are not stored.
+          *
+          * @param A    Left Matrix
+          * @param B    Right Matrix
+          * @param RES    Result Matrix
+          */
+        template <typename ScalarType>
+        void amg_mat_prod(amg_sparsematrix<ScalarType> const & A, amg_sparsematrix<ScalarType> const & B, amg_sparsematrix<ScalarType> & RES)
+        {
+          std::vector<unsigned int> const & A_row_buffer = A.row_buffer();
+          std::vector<unsigned int> const & A_col_buffer = A.col_buffer();
+          std::vector<ScalarType>   const & A_elements   = A.elements();
+          std::vector<unsigned int> const & B_row_buffer = B.row_buffer();
+          std::vector<unsigned int> const & B_col_buffer = B.col_buffer();
+          std::vector<ScalarType>   const & B_elements   = B.elements();
+
+          RES.resize(A.size1(), B.size2());
+          std::vector<unsigned int> & RES_row_buffer = RES.row_buffer();
+          std::vector<unsigned int> row_lengths(A.size1());
+
+          // Symbolic pass: Number of entries in each row of the result
+#ifdef VIENNACL_WITH_OPENMP
+          #pragma omp parallel
+#endif
+          {
+            std::vector<long> marker(B.size2(), -1);
 
-            iterator2 end2(bool trans = false)
+#ifdef VIENNACL_WITH_OPENMP
+            #pragma omp for
+#endif
+            for (long x=0; x<static_cast<long>(A.size1()); ++x)
             {
-              if (!trans && !transposed_mode)
+              unsigned int num_entries = 0;
+              for (unsigned int k=A_row_buffer[x]; k<A_row_buffer[x+1]; ++k)
               {
-                AdapterType a (internal_mat, s1, s2);
-                return a.end2();
-              }
-              else
-              {
-                //do_trans();
-                AdapterType a_trans (internal_mat_trans, s2, s1);
-                return a_trans.end2();
+                unsigned int y = A_col_buffer[k];
+                for (unsigned int l=B_row_buffer[y]; l<B_row_buffer[y+1]; ++l)
+                {
+                  unsigned int z = B_col_buffer[l];
+                  if (marker[z] != x)
+                  {
+                    marker[z] = x;
+                    ++num_entries;
+                  }
+                }
               }
+              RES_row_buffer[x+1] = num_entries;
             }
+          }
 
-            const_iterator1 begin1() const
-            {
-              // Const_iterator of transposed can only be used if transposed matrix is already built and up to date.
-              assert((!transposed_mode || (transposed_mode && transposed)) && bool("Error: Cannot build const_iterator when transposed has not been built yet!"));
-                    ConstAdapterType a_const (internal_mat, s1, s2);
-              return a_const.begin1();
-            }
-
-            const_iterator1 end1(bool trans = false) const
-            {
-              assert((!transposed_mode || (transposed_mode && transposed)) && bool("Error: Cannot build const_iterator when transposed has not been built yet!"));
-              ConstAdapterType a_const (internal_mat, trans ? s2 : s1, trans ? s1 : s2);
-              return a_const.end1();
-            }
+          for (vcl_size_t x=0; x<A.size1(); ++x)
+            RES_row_buffer[x+1] += RES_row_buffer[x];
+          RES.col_buffer().resize(RES_row_buffer[A.size1()]);
+          RES.elements().resize(RES_row_buffer[A.size1()]);
 
-            const_iterator2 begin2(bool trans = false) const
-            {
-              assert((!transposed_mode || (transposed_mode && transposed)) && bool("Error: Cannot build const_iterator when transposed has not been built yet!"));
-              ConstAdapterType a_const (internal_mat, trans ? s2 : s1, trans ? s1 : s2);
-              return a_const.begin2();
-            }
-
-            const_iterator2 end2(bool trans = false) const
-            {
-              assert((!transposed_mode || (transposed_mode && transposed)) && bool("Error: Cannot build const_iterator when transposed has not been built yet!"));
-              ConstAdapterType a_const (internal_mat, trans ? s2 : s1, trans ? s1 : s2);
-              return a_const.end2();
-            }
+          unsigned int * RES_col_buffer = RES_row_buffer[A.size1()] > 0 ? &(RES.col_buffer()[0]) : NULL;
+          ScalarType   * RES_elements   = RES_row_buffer[A.size1()] > 0 ? &(RES.elements()[0])   : NULL;
 
-            // Returns pointer to the internal data structure. Improves performance of copy operation to GPU.
-            std::vector<std::map<unsigned int, ScalarType> > * get_internal_pointer()
-            {
-              if (!transposed_mode)
-                return &internal_mat;
+          // Numeric pass: Accumulate rows
+#ifdef VIENNACL_WITH_OPENMP
+          #pragma omp parallel
+#endif
+          {
+            std::vector<long> marker(B.size2(), -1);
+            std::vector<ScalarType> row(B.size2());
 
-              if (!transposed)
-                do_trans();
-              return &internal_mat_trans;
-            }
-            operator boost::numeric::ublas::compressed_matrix<ScalarType> (void)
+#ifdef VIENNACL_WITH_OPENMP
+            #pragma omp for
+#endif
+            for (long x=0; x<static_cast<long>(A.size1()); ++x)
             {
-              boost::numeric::ublas::compressed_matrix<ScalarType> mat;
-              mat.resize(size1(),size2(),false);
-              mat.clear();
+              unsigned int * row_cols = RES_col_buffer + RES_row_buffer[x];
+              unsigned int num_entries = 0;
+              for (unsigned int k=A_row_buffer[x]; k<A_row_buffer[x+1]; ++k)
+              {
+                unsigned int y = A_col_buffer[k];
+                for (unsigned int l=B_row_buffer[y]; l<B_row_buffer[y+1]; ++l)
+                {
+                  unsigned int z = B_col_buffer[l];
+                  if (marker[z] != x)
+                  {
+                    marker[z] = x;
+                    row[z] = A_elements[k] * B_elements[l];
+                    row_cols[num_entries++] = z;
+                  }
+                  else
+                    row[z] += A_elements[k] * B_elements[l];
+                }
+              }
 
-              for (iterator1 row_iter = begin1(); row_iter != end1(); ++row_iter)
-                  for (iterator2 col_iter = row_iter.begin(); col_iter != row_iter.end(); ++col_iter)
-                    mat (col_iter.index1(), col_iter.index2()) = *col_iter;
+              std::sort(row_cols, row_cols + num_entries);
 
-              return mat;
+              unsigned int row_length = 0;
+              for (unsigned int k=0; k<num_entries; ++k)
+              {
+                unsigned int z = row_cols[k];
+                if (row[z] != 0)
+                {
+                  row_cols[row_length] = z;
+                  RES_elements[RES_row_buffer[x] + row_length] = row[z];
+                  ++row_length;
+                }
+              }
+              row_lengths[x] = row_length;
             }
-            operator boost::numeric::ublas::matrix<ScalarType> (void)
-            {
-              boost::numeric::ublas::matrix<ScalarType> mat;
-              mat.resize(size1(),size2(),false);
-              mat.clear();
-
-              for (iterator1 row_iter = begin1(); row_iter != end1(); ++row_iter)
-                  for (iterator2 col_iter = row_iter.begin(); col_iter != row_iter.end(); ++col_iter)
-                    mat (col_iter.index1(), col_iter.index2()) = *col_iter;
+          }
 
-              return mat;
-            }
-        };
+          amg_compress(RES, row_lengths);
+        }
 
-        /** @brief A class for the AMG points.
-        *   Saves point index and influence measure
-        *  Holds information whether point is undecided, C or F point.
-        *  Holds lists of points that are influenced by or influencing this point
-        */
-        class amg_point
+        /** @brief Sparse Galerkin product: Calculates RES = trans(P)*A*P. Multithreaded!
+          * @param A    Operator matrix (quadratic)
+          * @param P    Prolongation/Interpolation matrix
+          * @param RES    Result Matrix (Galerkin operator)
+          */
+        template <typename ScalarType>
+        void amg_galerkin_prod(amg_sparsematrix<ScalarType> const & A, amg_sparsematrix<ScalarType> const & P, amg_sparsematrix<ScalarType> & RES)
         {
-          private:
-            typedef amg_sparsevector<amg_point*> ListType;
-
-            unsigned int index_;
-            unsigned int influence_;
-            // Determines whether point is undecided.
-            bool undecided_;
-            // Determines wheter point is C point (true) or F point (false).
-            bool cpoint_;
-            unsigned int coarse_index_;
-            // Index offset of parallel coarsening. In that case a point acts as if it had an index of index_-offset_ and treats other points as if they had an index of index+offset_
-            unsigned int offset_;
-            // Aggregate the point belongs to.
-            unsigned int aggregate_;
-
-            // Holds all points influencing this point.
-            ListType influencing_points;
-            // Holds all points that are influenced by this point.
-            ListType influenced_points;
+          amg_sparsematrix<ScalarType> R;
+          amg_transpose(P, R);
 
-          public:
-            typedef ListType::iterator iterator;
-            typedef ListType::const_iterator const_iterator;
+          amg_sparsematrix<ScalarType> RA;
+          amg_mat_prod(R, A, RA);
+          amg_mat_prod(RA, P, RES);
 
-            /** @brief The constructor.
-            */
-            amg_point (unsigned int index, unsigned int size): index_(index), influence_(0), undecided_(true), cpoint_(false), coarse_index_(0), offset_(0), aggregate_(0)
-            {
-              influencing_points = ListType(size);
-              influenced_points = ListType(size);
-            }
-
-            void set_offset(unsigned int offset) { offset_ = offset; }
-            unsigned int get_offset() { return offset_; }
-            void set_index(unsigned int index) { index_ = index+offset_; }
-            unsigned int get_index() const { return index_-offset_;  }
-            unsigned int get_influence() const { return influence_;  }
-            void set_aggregate(unsigned int aggregate) { aggregate_ = aggregate; }
-            unsigned int get_aggregate () { return aggregate_; }
-
-            bool is_cpoint() const { return cpoint_ && !undecided_;  }
-            bool is_fpoint() const { return !cpoint_ && !undecided_; }
-            bool is_undecided() const { return undecided_; }
-
-            // Returns number of influencing points
-            unsigned int number_influencing() const  { return influencing_points.internal_size(); }
-            // Returns true if *point is influencing this point
-            bool is_influencing(amg_point* point) const { return influencing_points.isnonzero(point->get_index()+offset_); }
-            // Add *point to influencing points
-            void add_influencing_point(amg_point* point) { influencing_points[point->get_index()+offset_] = point;  }
-            // Add *point to influenced points
-            void add_influenced_point(amg_point* point) { influenced_points[point->get_index()+offset_] = point; }
-
-            // Clear influencing points
-            void clear_influencing() { influencing_points.clear(); }
-            // Clear influenced points
-            void clear_influenced() {influenced_points.clear(); }
-
-
-            unsigned int get_coarse_index() const { return coarse_index_; }
-            void set_coarse_index(unsigned int index) { coarse_index_ = index; }
-
-            // Calculates the initial influence measure equal to the number of influenced points.
-            void calc_influence() { influence_ = influenced_points.internal_size();  }
-
-            // Add to influence measure.
-            unsigned int add_influence(int add)
-            {
-              influence_ += add;
-              return influence_;
-            }
-            // Make this point C point. Only call via amg_pointvector.
-            void make_cpoint()
-            {
-              undecided_ = false;
-              cpoint_ = true;
-              influence_ = 0;
-            }
-            // Make this point F point. Only call via amg_pointvector.
-            void make_fpoint()
-            {
-              undecided_ = false;
-              cpoint_ = false;
-              influence_ = 0;
-            }
-            // Switch point from F to C point. Only call via amg_pointvector.
-            void switch_ftoc() { cpoint_ = true; }
-
-            // Iterator handling for influencing and influenced points.
-            iterator begin_influencing() { return influencing_points.begin(); }
-            iterator end_influencing() { return influencing_points.end(); }
-            const_iterator begin_influencing() const { return influencing_points.begin(); }
-            const_iterator end_influencing() const { return influencing_points.end(); }
-            iterator begin_influenced() { return influenced_points.begin();  }
-            iterator end_influenced() { return influenced_points.end(); }
-            const_iterator begin_influenced() const { return influenced_points.begin(); }
-            const_iterator end_influenced() const { return influenced_points.end(); }
-        };
-
-        /** @brief Comparison class for the sorted set of points in amg_pointvector. Set is sorted by influence measure from lower to higher with the point-index as tie-breaker.
-        */
-        struct classcomp
-        {
-          // Function returns true if l comes before r in the ordering.
-          bool operator() (amg_point* l, amg_point* r) const
-          {
-            // Map is sorted by influence number starting with the highest
-            // If influence number is the same then lowest point index comes first
-            return (l->get_influence() < r->get_influence() || (l->get_influence() == r->get_influence() && l->get_index() > r->get_index()));
-          }
-        };
+          #ifdef VIENNACL_AMG_DEBUG
+          std::cout << "Galerkin Operator: " << std::endl;
+          printmatrix (RES);
+          #endif
+        }
 
         /** @brief A class for the AMG points.
-        *  Holds pointers of type amg_point in a vector that can be accessed using [point-index].
-        *  Additional list of pointers sorted by influence number and index to improve coarsening performance (see amg_coarse_classic_onepass() in amg_coarse.hpp)
-        *  Constructs indices for C points on the coarse level, needed for interpolation.
+        *  Holds for each point whether it is undecided, C or F point, its index on the coarse level and the aggregate it belongs to.
+        *  The strong influences among the points are stored in CSR format: For each point the sorted list of points influencing it, and the sorted list of points influenced by it.
         */
         class amg_pointvector
         {
           private:
-            // Type for the sorted list
-            typedef std::set<amg_point*,classcomp> ListType;
-            // Type for the vector of pointers
-            typedef std::vector<amg_point*> VectorType;
-            VectorType pointvector;
-            ListType pointlist;
-            unsigned int size_;
+            enum { undecided_point = 0, c_point = 1, f_point = 2 };
+
+            std::vector<char> point_types_;
+            std::vector<unsigned int> coarse_indices_;
+            std::vector<unsigned int> aggregates_;
             unsigned int c_points, f_points;
 
-          public:
-            typedef VectorType::iterator iterator;
-            typedef VectorType::const_iterator const_iterator;
+            // Points influencing a point: influencing_points_[influencing_offsets_[i]], ..., influencing_points_[influencing_offsets_[i+1]-1]
+            std::vector<unsigned int> influencing_offsets_;
+            std::vector<unsigned int> influencing_points_;
+            // Points influenced by a point:
+            std::vector<unsigned int> influenced_offsets_;
+            std::vector<unsigned int> influenced_points_;
 
+          public:
             /** @brief The constructor.
             *  @param size    Number of points
             */
-            amg_pointvector(unsigned int size = 0): size_(size)
-            {
-              pointvector = VectorType(size);
-              c_points = f_points = 0;
-            }
+            amg_pointvector(unsigned int size = 0)
+              : point_types_(size, undecided_point), coarse_indices_(size, 0), aggregates_(size, 0), c_points(0), f_points(0),
+                influencing_offsets_(size+1, 0), influenced_offsets_(size+1, 0) {}
 
-            // Construct all the points dynamically and save pointers into vector.
-            void init_points()
-            {
-              for (unsigned int i=0; i<size(); ++i)
-                pointvector[i] = new amg_point(i,size());
-            }
-            // Delete all the points.
-            void delete_points()
-            {
-              for (unsigned int i=0; i<size(); ++i)
-                delete pointvector[i];
-            }
-            // Add point to the vector. Note: User has to make sure that point at point->get_index() does not exist yet, otherwise it will be overwritten!
-            void add_point(amg_point *point)
-            {
-              pointvector[point->get_index()] = point;
-              if (point->is_cpoint()) c_points++;
-              else if (point->is_fpoint()) f_points++;
-            }
-
-            // Update C and F count for point *point.
-            // Necessary if C and F points were constructed outside this data structure (e.g. by parallel coarsening RS0 or RS3).
-            void update_cf(amg_point *point)
-            {
-              if (point->is_cpoint()) c_points++;
-              else if (point->is_fpoint()) f_points++;
-            }
-            // Clear the C and F point count.
-            void clear_cf() { c_points = f_points = 0; }
-
-            // Clear both point lists.
-            void clear_influencelists()
-            {
-              for (iterator iter = pointvector.begin(); iter != pointvector.end(); ++iter)
-              {
-                (*iter)->clear_influencing();
-                (*iter)->clear_influenced();
-              }
-            }
-
-            amg_point* operator [] (unsigned int i) const { return pointvector[i]; }
-            iterator begin() { return pointvector.begin(); }
-            iterator end() { return pointvector.end(); }
-            const_iterator begin() const { return pointvector.begin(); }
-            const_iterator end() const { return pointvector.end(); }
-
-            void resize(unsigned int size)
-            {
-              size_ = size;
-              pointvector = VectorType(size);
-            }
-            unsigned int size() const { return size_; }
+            unsigned int size() const { return static_cast<unsigned int>(point_types_.size()); }
 
             // Returns number of C points
             unsigned int get_cpoints() const { return c_points; }
             // Returns number of F points
             unsigned int get_fpoints() const { return f_points; }
 
-            // Does the initial sorting of points into the list. Sorting is automatically done by the std::set data type.
-            void sort()
-            {
-              for (iterator iter = begin(); iter != end(); ++iter)
-                pointlist.insert(*iter);
-            }
-            // Returns the point with the highest influence measure
-            amg_point* get_nextpoint()
-            {
-              // No points remaining? Return NULL such that coarsening will stop.
-              if (pointlist.size() == 0)
-                return NULL;
-              // If point with highest influence measure (end of the list) has measure of zero, then no further C points can be constructed. Return NULL.
-              if ((*(--pointlist.end()))->get_influence() == 0)
-                return NULL;
-              // Otherwise, return the point with highest influence measure located at the end of the list.
-              else
-                return *(--pointlist.end());
-            }
-            // Add "add" to influence measure for point *point in the sorted list.
-            void add_influence(amg_point* point, unsigned int add)
-            {
-              ListType::iterator iter = pointlist.find(point);
-              // If point is not in the list then stop.
-              if (iter == pointlist.end()) return;
-
-              // Save iterator and decrement
-              ListType::iterator iter2 = iter;
-              iter2--;
+            bool is_cpoint(unsigned int i) const { return point_types_[i] == c_point; }
+            bool is_fpoint(unsigned int i) const { return point_types_[i] == f_point; }
+            bool is_undecided(unsigned int i) const { return point_types_[i] == undecided_point; }
 
-              // Point has to be erased first as changing the value does not re-order the std::set
-              pointlist.erase(iter);
-              point->add_influence(add);
+            void make_cpoint(unsigned int i) { point_types_[i] = c_point; c_points++; }
+            void make_fpoint(unsigned int i) { point_types_[i] = f_point; f_points++; }
+            // Switch point from F to C point.
+            void switch_ftoc(unsigned int i) { point_types_[i] = c_point; c_points++; f_points--; }
 
-              // Insert point back into the list. Using the iterator improves performance. The new position has to be at the same position or to the right of the old.
-              pointlist.insert(iter2,point);
-            }
-            // Make *point to C point and remove from sorted list
-            void make_cpoint(amg_point* point)
+            // Copies the C and F points of 'points' to the points starting at index 'offset'.
+            // The C and F point count is not updated, call update_cf() afterwards. Thus, this can be called for disjoint index ranges in parallel.
+            void assign(unsigned int offset, amg_pointvector const & points)
             {
-              pointlist.erase(point);
-              point->make_cpoint();
-              c_points++;
+              std::copy(points.point_types_.begin(), points.point_types_.end(), point_types_.begin() + offset);
             }
-            // Make *point to F point and remove from sorted list
-            void make_fpoint(amg_point* point)
+            // Makes all points in the index range [start, stop) C points. The C and F point count is not updated.
+            void assign_cpoints(unsigned int start, unsigned int stop)
             {
-              pointlist.erase(point);
-              point->make_fpoint();
-              f_points++;
+              std::fill(point_types_.begin() + start, point_types_.begin() + stop, static_cast<char>(c_point));
             }
-            // Swich *point from F to C point
-            void switch_ftoc(amg_point* point)
+            // Recomputes the C and F point count.
+            void update_cf()
             {
-              point->switch_ftoc();
-              c_points++;
-              f_points--;
+              c_points = f_points = 0;
+              for (vcl_size_t i=0; i<point_types_.size(); ++i)
+              {
+                if (point_types_[i] == c_point) c_points++;
+                else if (point_types_[i] == f_point) f_points++;
+              }
             }
 
             // Build vector of indices for C point on the coarse level.
             void build_index()
             {
               unsigned int count = 0;
-              // Use simple counter for index creation.
-              for (iterator iter = pointvector.begin(); iter != pointvector.end(); ++iter)
-              {
-                // Set index on coarse level using counter variable
-                if ((*iter)->is_cpoint())
-                {
-                  (*iter)->set_coarse_index(count);
-                  count++;
-                }
-              }
+              for (vcl_size_t i=0; i<point_types_.size(); ++i)
+                if (point_types_[i] == c_point)
+                  coarse_indices_[i] = count++;
             }
+            unsigned int get_coarse_index(unsigned int i) const { return coarse_indices_[i]; }
 
-            // Return information for debugging purposes
-            template <typename MatrixType>
-            void get_influence_matrix(MatrixType & mat) const
-            {
-              mat = MatrixType(size(),size());
-              mat.clear();
+            void set_aggregate(unsigned int i, unsigned int aggregate) { aggregates_[i] = aggregate; }
+            unsigned int get_aggregate(unsigned int i) const { return aggregates_[i]; }
 
-              for (const_iterator row_iter = begin(); row_iter != end(); ++row_iter)
-                for (amg_point::iterator col_iter = (*row_iter)->begin_influencing(); col_iter != (*row_iter)->end_influencing(); ++col_iter)
-                  mat((*row_iter)->get_index(),(*col_iter)->get_index()) = true;
-            }
-            template <typename VectorType>
-            void get_influence(VectorType & vec) const
-            {
-              vec = VectorType(size_);
-              vec.clear();
+            // Access to the strong influences. Lists are set up via the offset and index arrays, followed by a call to build_influenced().
+            std::vector<unsigned int> & influencing_offsets() { return influencing_offsets_; }
+            std::vector<unsigned int> & influencing_points() { return influencing_points_; }
 
-              for (const_iterator iter = begin(); iter != end(); ++iter)
-                vec[(*iter)->get_index()] = (*iter)->get_influence();
-            }
-            template <typename VectorType>
-            void get_sorting(VectorType & vec) const
-            {
-              vec = VectorType(pointlist.size());
-              vec.clear();
-              unsigned int i=0;
+            unsigned int const * begin_influencing(unsigned int i) const { return influencing_points_.empty() ? NULL : &(influencing_points_[0]) + influencing_offsets_[i]; }
+            unsigned int const * end_influencing(unsigned int i)   const { return influencing_points_.empty() ? NULL : &(influencing_points_[0]) + influencing_offsets_[i+1]; }
+            unsigned int const * begin_influenced(unsigned int i)  const { return influenced_points_.empty() ? NULL : &(influenced_points_[0]) + influenced_offsets_[i]; }
+            unsigned int const * end_influenced(unsigned int i)    const { return influenced_points_.empty() ? NULL : &(influenced_points_[0]) + influenced_offsets_[i+1]; }
 
-              for (ListType::const_iterator iter = pointlist.begin(); iter != pointlist.end(); ++iter)
-              {
-                vec[i] = (*iter)->get_index();
-                i++;
-              }
-            }
-            template <typename VectorType>
-            void get_C(VectorType & vec) const
-            {
-              vec = VectorType(size_);
-              vec.clear();
+            // Returns number of points influencing point i
+            unsigned int number_influencing(unsigned int i) const { return influencing_offsets_[i+1] - influencing_offsets_[i]; }
+            // Returns number of points influenced by point i
+            unsigned int number_influenced(unsigned int i) const { return influenced_offsets_[i+1] - influenced_offsets_[i]; }
+            // Returns true if point j is influencing point i
+            bool is_influencing(unsigned int i, unsigned int j) const { return std::binary_search(begin_influencing(i), end_influencing(i), j); }
 
-              for (const_iterator iter = begin(); iter != end(); ++iter)
-              {
-                if ((*iter)->is_cpoint())
-                  vec[(*iter)->get_index()] = true;
-              }
-            }
-            template <typename VectorType>
-            void get_F(VectorType & vec) const
+            // Builds the lists of influenced points from the lists of influencing points.
+            void build_influenced()
             {
-              vec = VectorType(size_);
-              vec.clear();
+              unsigned int n = size();
+              influenced_offsets_.assign(n+1, 0);
+              influenced_points_.resize(influencing_points_.size());
+              for (vcl_size_t k=0; k<influencing_points_.size(); ++k)
+                ++influenced_offsets_[influencing_points_[k] + 1];
+              for (unsigned int i=0; i<n; ++i)
+                influenced_offsets_[i+1] += influenced_offsets_[i];
 
-              for (const_iterator iter = begin(); iter != end(); ++iter)
-              {
-                if ((*iter)->is_fpoint())
-                  vec[(*iter)->get_index()] = true;
-              }
+              std::vector<unsigned int> position(influenced_offsets_.begin(), influenced_offsets_.end() - 1);
+              for (unsigned int i=0; i<n; ++i)
+                for (unsigned int k=influencing_offsets_[i]; k<influencing_offsets_[i+1]; ++k)
+                  influenced_points_[position[influencing_points_[k]]++] = i;
             }
-            template <typename MatrixType>
-            void get_Aggregates(MatrixType & mat) const
-            {
-              mat = MatrixType(size_,size_);
-              mat.clear();
 
-              for (const_iterator iter = begin(); iter != end(); ++iter)
-              {
-                if (!(*iter)->is_undecided())
-                  mat((*iter)->get_aggregate(),(*iter)->get_index()) = true;
-              }
+            // Clear both influence lists.
+            void clear_influencelists()
+            {
+              std::vector<unsigned int>(size()+1, 0).swap(influencing_offsets_);
+              std::vector<unsigned int>().swap(influencing_points_);
+              std::vector<unsigned int>(size()+1, 0).swap(influenced_offsets_);
+              std::vector<unsigned int>().swap(influenced_points_);
             }
         };
 
         /** @brief A class for the matrix slicing for parallel coarsening schemes (RS0/RS3).
-          * @brief Holds information on a per-processor basis and offers functionality to slice and join the data structures.
+          * @brief Holds the index ranges of the slices on all levels. Slice i on level l consists of the points Offset[l][i], ..., Offset[l][i+1]-1.
           */
-        template <typename InternalType1, typename InternalType2>
         class amg_slicing
         {
-            typedef typename InternalType1::value_type SparseMatrixType;
-            typedef typename InternalType2::value_type PointVectorType;
-
           public:
-            // Data structures on a per-processor basis.
-            boost::numeric::ublas::vector<InternalType1> A_slice;
-            boost::numeric::ublas::vector<InternalType2> Pointvector_slice;
-            // Holds the offsets showing the indices for which a new slice begins.
-            boost::numeric::ublas::vector<boost::numeric::ublas::vector<unsigned int> > Offset;
+            // Holds the offsets showing the indices for which a new slice begins (threads_+1 entries per level to also hold the total size).
+            std::vector<std::vector<unsigned int> > Offset;
 
             unsigned int threads_;
             unsigned int levels_;
@@ -1187,311 +682,140 @@ namespace viennacl
             #ifdef VIENNACL_WITH_OPENMP
                 threads_ = omp_get_num_procs();
             #else
-              threads_ = 1;
+                threads_ = 1;
             #endif
               else
                 threads_ = threads;
 
               levels_ = levels;
 
-              A_slice.resize(threads_);
-              Pointvector_slice.resize(threads_);
-              // Offset has threads_+1 entries to also hold the total size
-              Offset.resize(threads_+1);
-
-              for (unsigned int i=0; i<threads_; ++i)
-              {
-                A_slice[i].resize(levels_);
-                Pointvector_slice[i].resize(levels_);
-                // Offset needs one more level for the build-up of the next offset
-                Offset[i].resize(levels_+1);
-              }
-              Offset[threads_].resize(levels_+1);
+              // Offset needs one more level for the build-up of the next offset
+              Offset.resize(levels_+1);
+              for (unsigned int i=0; i<=levels_; ++i)
+                Offset[i].resize(threads_+1);
             } //init()
 
-            // Slice matrix A into as many parts as threads are used.
-            void slice (unsigned int level, InternalType1 const & A, InternalType2 const & Pointvector)
-            {
-              // On the finest level, build a new slicing first.
-              if (level == 0)
-                slice_new (level, A);
-
-              // On coarser levels use the same slicing as on the finest level (Points stay together on the same thread on all levels).
-              // This is necessary as due to interpolation and galerkin product there only exist connections between points on the same thread on coarser levels.
-              // Note: Offset is determined in amg_coarse_rs0() after fine level was built.
-              slice_build (level, A, Pointvector);
-            }
-
-            // Join point data structure into Pointvector
-            void join (unsigned int level, InternalType2 & Pointvector) const
-            {
-              typedef typename InternalType2::value_type PointVectorType;
-
-              // Reset index offset of all points and update overall C and F point count
-              Pointvector[level].clear_cf();
-              for (typename PointVectorType::iterator iter = Pointvector[level].begin(); iter != Pointvector[level].end(); ++iter)
-              {
-                (*iter)->set_offset(0);
-                Pointvector[level].update_cf(*iter);
-              }
-            }
-
-          private:
-            /** @brief Slices mat into this->threads parts of (almost) equal size
-            * @param level    Level for which slicing is requested
-            * @param A     System matrix on all levels
+            /** @brief Slices the finest level into this->threads_ parts of (almost) equal size
+            * @param size    Number of points on the finest level
             */
-            void slice_new (unsigned int level, InternalType1 const & A)
+            void slice_new(unsigned int size)
             {
-              // Determine index offset of all the slices (index of A[level] when the respective slice starts).
-            #ifdef VIENNACL_WITH_OPENMP
-              #pragma omp parallel for
-            #endif
-              for (long i=0; i<=static_cast<long>(threads_); ++i)
-              {
-                // Offset of first piece is zero. Pieces 1,...,threads-1 have equal size while the last one might be greater.
-                if (i == 0) Offset[i][level] = 0;
-                else if (i == threads_) Offset[i][level] = static_cast<unsigned int>(A[level].size1());
-                else Offset[i][level] = static_cast<unsigned int>(i*(A[level].size1()/threads_));
-              }
+              // Offset of first piece is zero. Pieces 1,...,threads-1 have equal size while the last one might be greater.
+              for (unsigned int i=0; i<threads_; ++i)
+                Offset[0][i] = i * (size / threads_);
+              Offset[0][threads_] = size;
             }
 
-            /** @brief Slices mat into pieces determined by this->Offset
-            * @param level    Level to which Slices are saved
-            * @param A     System matrix on all levels
-            * @param Pointvector  Vector of points on all levels
+            /** @brief Extracts the diagonal block of 'A' which belongs to slice 'i' on level 'level'
+            * @param level    Level of the slicing
+            * @param i        Slice index
+            * @param A        System matrix on the respective level
+            * @param A_slice  The output matrix
             */
-            void slice_build (unsigned int level, InternalType1 const & A, InternalType2 const & Pointvector)
+            template <typename ScalarType>
+            void slice_build(unsigned int level, unsigned int i, amg_sparsematrix<ScalarType> const & A, amg_sparsematrix<ScalarType> & A_slice) const
             {
-              typedef typename SparseMatrixType::const_iterator1 ConstRowIterator;
-              typedef typename SparseMatrixType::const_iterator2 ConstColIterator;
+              unsigned int start = Offset[level][i];
+              unsigned int stop  = Offset[level][i+1];
 
-              unsigned int x, y;
-              amg_point *point;
+              std::vector<unsigned int> const & row_buffer = A.row_buffer();
+              std::vector<unsigned int> const & col_buffer = A.col_buffer();
+              std::vector<ScalarType>   const & elements   = A.elements();
 
-            #ifdef VIENNACL_WITH_OPENMP
-              #pragma omp parallel for private (x,y,point)
-            #endif
-              for (long i=0; i<static_cast<long>(threads_); ++i)
+              A_slice.resize(stop - start, stop - start);
+              for (unsigned int x=start; x<stop; ++x)
               {
-                // Allocate space for the matrix slice and the pointvector.
-                A_slice[i][level] = SparseMatrixType(Offset[i+1][level]-Offset[i][level],Offset[i+1][level]-Offset[i][level]);
-                Pointvector_slice[i][level] = PointVectorType(Offset[i+1][level]-Offset[i][level]);
-
-                // Iterate over the part that belongs to thread i (from Offset[i][level] to Offset[i+1][level]).
-                ConstRowIterator row_iter = A[level].begin1();
-                row_iter += Offset[i][level];
-                x = static_cast<unsigned int>(row_iter.index1());
-
-                while (x < Offset[i+1][level] && row_iter != A[level].end1())
+                for (unsigned int k=row_buffer[x]; k<row_buffer[x+1]; ++k)
                 {
-                  // Set offset for point index and save point for the respective thread
-                  point = Pointvector[level][x];
-                  point->set_offset(Offset[i][level]);
-                  Pointvector_slice[i][level].add_point(point);
-
-                  ConstColIterator col_iter = row_iter.begin();
-                  y = static_cast<unsigned int>(col_iter.index2());
-
-                  // Save all coefficients from the matrix slice
-                  while (y < Offset[i+1][level] && col_iter != row_iter.end())
+                  if (col_buffer[k] >= start && col_buffer[k] < stop)
                   {
-                    if (y >= Offset[i][level])
-                A_slice[i][level](x-Offset[i][level],y-Offset[i][level]) = *col_iter;
-
-                    ++col_iter;
-                    y = static_cast<unsigned int>(col_iter.index2());
+                    A_slice.col_buffer().push_back(col_buffer[k] - start);
+                    A_slice.elements().push_back(elements[k]);
                   }
-
-                  ++row_iter;
-                  x = static_cast<unsigned int>(row_iter.index1());
                 }
+                A_slice.row_buffer()[x - start + 1] = static_cast<unsigned int>(A_slice.col_buffer().size());
               }
             }
         };
 
-        /** @brief Sparse matrix product. Calculates RES = A*B.
-          * @param A    Left Matrix
-          * @param B    Right Matrix
-          * @param RES    Result Matrix
+        /** @brief A class for the near-nullspace vectors of aggregation based AMG (VIENNACL_AMG_COARSE_AG).
+          *
+          * Holds the near-nullspace vectors and the grouping of the unknowns into nodes on all levels.
+          *
+          * The vectors are stored column by column. Node i on level l consists of the unknowns node_offsets(l)[i], ..., node_offsets(l)[i+1]-1.
+          * On the finest level a node holds the unknowns of one mesh vertex (e.g. the displacement components for elasticity),
+          * on coarser levels it holds the coarse unknowns of one aggregate.
           */
-        template <typename SparseMatrixType>
-        void amg_mat_prod (SparseMatrixType & A, SparseMatrixType & B, SparseMatrixType & RES)
+        template <typename ScalarType>
+        class amg_nullspace
         {
-          typedef typename SparseMatrixType::value_type ScalarType;
-          typedef typename SparseMatrixType::iterator1 InternalRowIterator;
-          typedef typename SparseMatrixType::iterator2 InternalColIterator;
-
-          long x,y,z;
-          ScalarType prod;
-          RES = SparseMatrixType(static_cast<unsigned int>(A.size1()), static_cast<unsigned int>(B.size2()));
-          RES.clear();
-
-    #ifdef VIENNACL_WITH_OPENMP
-          #pragma omp parallel for private (x,y,z,prod)
-    #endif
-          for (x=0; x<static_cast<long>(A.size1()); ++x)
-          {
-            InternalRowIterator row_iter = A.begin1();
-            row_iter += x;
-            for (InternalColIterator col_iter = row_iter.begin(); col_iter != row_iter.end(); ++col_iter)
+          public:
+            amg_nullspace() : num_vectors_(0) {}
+
+            /** @brief Sets the near-nullspace vectors for the finest level.
+            * @param B               The near-nullspace vectors. B[j][i] is entry i of vector j.
+            * @param size            Number of unknowns of the finest level
+            * @param dofs_per_node   Number of consecutive unknowns forming a node
+            */
+            template <typename VectorArrayType>
+            void init(VectorArrayType const & B, unsigned int size, unsigned int dofs_per_node)
             {
-              y = static_cast<unsigned int>(col_iter.index2());
-              InternalRowIterator row_iter2 = B.begin1();
-              row_iter2 += y;
+              assert(dofs_per_node > 0 && size % dofs_per_node == 0 && bool("Error in amg_nullspace::init(): Number of unknowns is not a multiple of the node size!"));
+
+              num_vectors_ = static_cast<unsigned int>(B.size());
+              vectors_.resize(1);
+              node_offsets_.resize(1);
 
-              for(InternalColIterator col_iter2 = row_iter2.begin(); col_iter2 != row_iter2.end(); ++col_iter2)
+              vectors_[0].resize(vcl_size_t(size) * num_vectors_);
+              for (unsigned int j=0; j<num_vectors_; ++j)
               {
-                z = static_cast<unsigned int>(col_iter2.index2());
-                prod = *col_iter * *col_iter2;
-                RES.add(x,z,prod);
+                assert(B[j].size() == size && bool("Error in amg_nullspace::init(): Size of near-nullspace vector does not match!"));
+                for (unsigned int i=0; i<size; ++i)
+                  vectors_[0][vcl_size_t(j)*size + i] = static_cast<ScalarType>(B[j][i]);
               }
+
+              node_offsets_[0].resize(size / dofs_per_node + 1);
+              for (unsigned int i=0; i<node_offsets_[0].size(); ++i)
+                node_offsets_[0][i] = i * dofs_per_node;
             }
-          }
-        }
 
-        /** @brief Sparse Galerkin product: Calculates RES = trans(P)*A*P
-          * @param A    Operator matrix (quadratic)
-          * @param P    Prolongation/Interpolation matrix
-          * @param RES    Result Matrix (Galerkin operator)
-          */
-        template <typename SparseMatrixType>
-        void amg_galerkin_prod (SparseMatrixType & A, SparseMatrixType & P, SparseMatrixType & RES)
-        {
-          typedef typename SparseMatrixType::value_type ScalarType;
-          typedef typename SparseMatrixType::iterator1 InternalRowIterator;
-          typedef typename SparseMatrixType::iterator2 InternalColIterator;
-
-          long x,y1,y2,z;
-          amg_sparsevector<ScalarType> row;
-          RES = SparseMatrixType(static_cast<unsigned int>(P.size2()), static_cast<unsigned int>(P.size2()));
-          RES.clear();
-
-    #ifdef VIENNACL_WITH_OPENMP
-          #pragma omp parallel for private (x,y1,y2,z,row)
-    #endif
-          for (x=0; x<static_cast<long>(P.size2()); ++x)
-          {
-            row = amg_sparsevector<ScalarType>(static_cast<unsigned int>(A.size2()));
-            InternalRowIterator row_iter = P.begin1(true);
-            row_iter += x;
+            /** @brief Returns true if no near-nullspace is set, i.e. the constant vector is used. */
+            bool empty() const { return num_vectors_ == 0; }
+            unsigned int num_vectors() const { return num_vectors_; }
 
-            for (InternalColIterator col_iter = row_iter.begin(); col_iter != row_iter.end(); ++col_iter)
+            std::vector<ScalarType> & vectors(unsigned int level)
             {
-              y1 = static_cast<long>(col_iter.index2());
-              InternalRowIterator row_iter2 = A.begin1();
-              row_iter2 += y1;
-
-              for(InternalColIterator col_iter2 = row_iter2.begin(); col_iter2 != row_iter2.end(); ++col_iter2)
-              {
-                y2 = static_cast<long>(col_iter2.index2());
-                row.add (y2, *col_iter * *col_iter2);
-              }
+              if (level >= vectors_.size())
+                vectors_.resize(level+1);
+              return vectors_[level];
             }
-            for (typename amg_sparsevector<ScalarType>::iterator iter = row.begin(); iter != row.end(); ++iter)
-            {
-              y2 = iter.index();
-              InternalRowIterator row_iter3 = P.begin1();
-              row_iter3 += y2;
 
-              for (InternalColIterator col_iter3 = row_iter3.begin(); col_iter3 != row_iter3.end(); ++col_iter3)
-              {
-                z = static_cast<long>(col_iter3.index2());
-                RES.add (x, z, *col_iter3 * *iter);
-              }
+            std::vector<unsigned int> & node_offsets(unsigned int level)
+            {
+              if (level >= node_offsets_.size())
+                node_offsets_.resize(level+1);
+              return node_offsets_[level];
             }
-          }
 
-          #ifdef VIENNACL_AMG_DEBUG
-          std::cout << "Galerkin Operator: " << std::endl;
-          printmatrix (RES);
-          #endif
-        }
+          private:
+            unsigned int num_vectors_;
+            std::vector<std::vector<ScalarType> > vectors_;
+            std::vector<std::vector<unsigned int> > node_offsets_;
+        };
 
-        /** @brief Test triple-matrix product by comparing it to ublas functions. Very slow for large matrices!
-          * @param A    Operator matrix (quadratic)
-          * @param P    Prolongation/Interpolation matrix
-          * @param A_i1    Result Matrix
-          */
-        template <typename SparseMatrixType>
-        void test_triplematprod(SparseMatrixType & A, SparseMatrixType & P, SparseMatrixType  & A_i1)
+#ifdef VIENNACL_AMG_DEBUG
+        template <typename ScalarType>
+        void printmatrix(amg_sparsematrix<ScalarType> & mat, int const = -1)
         {
-          typedef typename SparseMatrixType::value_type ScalarType;
-
-          boost::numeric::ublas::compressed_matrix<ScalarType> A_temp (A.size1(), A.size2());
-          A_temp = A;
-          boost::numeric::ublas::compressed_matrix<ScalarType> P_temp (P.size1(), P.size2());
-          P_temp = P;
-          P.set_trans(true);
-          boost::numeric::ublas::compressed_matrix<ScalarType> R_temp (P.size1(), P.size2());
-          R_temp = P;
-          P.set_trans(false);
-
-          boost::numeric::ublas::compressed_matrix<ScalarType> RA (R_temp.size1(),A_temp.size2());
-          RA = boost::numeric::ublas::prod(R_temp,A_temp);
-          boost::numeric::ublas::compressed_matrix<ScalarType> RAP (RA.size1(),P_temp.size2());
-          RAP = boost::numeric::ublas::prod(RA,P_temp);
-
-          for (unsigned int x=0; x<RAP.size1(); ++x)
+          for (vcl_size_t i=0; i<mat.size1(); ++i)
           {
-            for (unsigned int y=0; y<RAP.size2(); ++y)
-            {
-              if (std::fabs(static_cast<ScalarType>(RAP(x,y)) - static_cast<ScalarType>(A_i1(x,y))) > 0.0001)
-                std::cout << x << " " << y << " " << RAP(x,y) << " " << A_i1(x,y) << std::endl;
-            }
+            for (unsigned int k=mat.row_buffer()[i]; k<mat.row_buffer()[i+1]; ++k)
+              std::cout << "(" << mat.col_buffer()[k] << ": " << mat.elements()[k] << ") ";
+            std::cout << std::endl;
           }
+          std::cout << std::endl;
         }
-
-        /** @brief Test if interpolation matrix makes sense. Only vanilla test though! Only checks if basic requirements are met!
-          * @param A    Operator matrix (quadratic)
-          * @param P    Prolongation/Interpolation matrix
-          * @param Pointvector  Vector of points
-          */
-        template <typename SparseMatrixType, typename PointVectorType>
-        void test_interpolation(SparseMatrixType & A, SparseMatrixType & P, PointVectorType & Pointvector)
-        {
-          for (unsigned int i=0; i<P.size1(); ++i)
-          {
-            if (Pointvector.is_cpoint(i))
-            {
-              bool set = false;
-              for (unsigned int j=0; j<P.size2(); ++j)
-              {
-                if (P.isnonzero(i,j))
-                {
-                  if (P(i,j) != 1)
-                    std::cout << "Error 1 in row " << i << std::endl;
-                  if (P(i,j) == 1 && set)
-                    std::cout << "Error 2 in row " << i << std::endl;
-                  if (P(i,j) == 1 && !set)
-                    set = true;
-                }
-              }
-            }
-
-            if (Pointvector.is_fpoint(i))
-              for (unsigned int j=0; j<P.size2(); ++j)
-              {
-                if (P.isnonzero(i,j) && j> Pointvector.get_cpoints()-1)
-                  std::cout << "Error 3 in row " << i << std::endl;
-                if (P.isnonzero(i,j))
-                {
-                  bool set = false;
-                  for (unsigned int k=0; k<P.size1(); ++k)
-                  {
-                    if (P.isnonzero(k,j))
-                    {
-                      if (Pointvector.is_cpoint(k) && P(k,j) == 1 && A.isnonzero(i,k))
-                        set = true;
-                    }
-                  }
-                  if (!set)
-                    std::cout << "Error 4 in row " << i << std::endl;
-                }
-              }
-            }
-        }
-
+#endif
 
       } //namespace amg
     }
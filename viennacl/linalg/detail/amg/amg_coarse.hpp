@@ -23,9 +23,10 @@
 */
 
 #include <cmath>
+#include <set>
+#include <vector>
 #include "viennacl/linalg/detail/amg/amg_base.hpp"
 
-#include <map>
 #ifdef VIENNACL_WITH_OPENMP
 #include <omp.h>
 #endif
@@ -46,10 +47,11 @@ namespace viennacl
       * @param A    Operator matrix on all levels
       * @param Pointvector   Vector of points on all levels
       * @param Slicing    Partitioning of the system matrix to different processors (only used in RS0 and RS3)
+      * @param Nullspace  Near-nullspace vectors and nodes on all levels (only used in AG)
       * @param tag    AMG preconditioner tag
       */
-    template <typename InternalType1, typename InternalType2, typename InternalType3>
-    void amg_coarse(unsigned int level, InternalType1 & A, InternalType2 & Pointvector, InternalType3 & Slicing, amg_tag & tag)
+    template <typename InternalType1, typename InternalType2, typename InternalType3, typename InternalType4>
+    void amg_coarse(unsigned int level, InternalType1 & A, InternalType2 & Pointvector, InternalType3 & Slicing, InternalType4 & Nullspace, amg_tag & tag)
     {
       switch (tag.get_coarse())
       {
@@ -57,306 +59,302 @@ namespace viennacl
         case VIENNACL_AMG_COARSE_ONEPASS: amg_coarse_classic_onepass (level, A, Pointvector, tag); break;
         case VIENNACL_AMG_COARSE_RS0: amg_coarse_rs0 (level, A, Pointvector, Slicing, tag); break;
         case VIENNACL_AMG_COARSE_RS3: amg_coarse_rs3 (level, A, Pointvector, Slicing, tag); break;
-        case VIENNACL_AMG_COARSE_AG:   amg_coarse_ag (level, A, Pointvector, tag); break;
+        case VIENNACL_AMG_COARSE_AG:   amg_coarse_ag (level, A, Pointvector, Nullspace, tag); break;
       }
     }
 
     /** @brief Determines strong influences in system matrix, classical approach (RS). Multithreaded!
-    * @param level    Coarse level identifier
-    * @param A      Operator matrix on all levels
-    * @param Pointvector   Vector of points on all levels
-    * @param tag    AMG preconditioner tag
+    *
+    * If slice offsets are supplied (RS0/RS3), a connection is also considered strong if it is strong with respect to the part of the row inside the slice.
+    * This matches the influences found by the coarsening of the individual slices.
+    *
+    * @param A              Operator matrix
+    * @param Pointvector    Points of the operator matrix. The influence lists are set up.
+    * @param tag            AMG preconditioner tag
+    * @param slice_offsets  Optional: Offsets of the slices of the operator matrix
     */
-    template <typename InternalType1, typename InternalType2>
-    void amg_influence(unsigned int level, InternalType1 const & A, InternalType2 & Pointvector, amg_tag & tag)
+    template <typename ScalarType>
+    void amg_influence(amg_sparsematrix<ScalarType> const & A, amg_pointvector & Pointvector, amg_tag & tag, std::vector<unsigned int> const * slice_offsets = NULL)
     {
-      typedef typename InternalType1::value_type SparseMatrixType;
-      typedef typename InternalType2::value_type PointVectorType;
-      typedef typename SparseMatrixType::value_type ScalarType;
-      typedef typename SparseMatrixType::value_type ScalarType;
-      typedef typename SparseMatrixType::const_iterator1 ConstRowIterator;
-      typedef typename SparseMatrixType::const_iterator2 ConstColIterator;
+      std::vector<unsigned int> const & row_buffer = A.row_buffer();
+      std::vector<unsigned int> const & col_buffer = A.col_buffer();
+      std::vector<ScalarType>   const & elements   = A.elements();
 
-      ScalarType max;
-      int diag_sign;
-      //unsigned int i;
+      std::vector<unsigned int> & influencing_offsets = Pointvector.influencing_offsets();
+      std::vector<unsigned int> & influencing_points  = Pointvector.influencing_points();
+
+      // Strong influences are written to the slots of the respective nonzeros of A first, then compressed.
+      std::vector<unsigned int> row_lengths(A.size1());
+      influencing_points.resize(A.nnz());
 
 #ifdef VIENNACL_WITH_OPENMP
-      #pragma omp parallel for private (max,diag_sign)
+      #pragma omp parallel for
 #endif
-      for (long i=0; i<static_cast<long>(A[level].size1()); ++i)
+      for (long i=0; i<static_cast<long>(A.size1()); ++i)
       {
-        diag_sign = 1;
-        if (A[level](i,i) < 0)
+        unsigned int row_start = row_buffer[i];
+        unsigned int row_stop  = row_buffer[i+1];
+
+        ScalarType diag_sign = 1;
+        if (A(static_cast<unsigned int>(i), static_cast<unsigned int>(i)) < 0)
           diag_sign = -1;
 
-        ConstRowIterator row_iter = A[level].begin1();
-        row_iter += i;
-        // Find greatest non-diagonal negative value (positive if diagonal is negative) in row
-        max = 0;
-        for (ConstColIterator col_iter = row_iter.begin(); col_iter != row_iter.end(); ++col_iter)
+        // Bounds of the slice point i belongs to. Without slicing, no connection is inside a slice.
+        unsigned int slice_start = 0, slice_stop = 0;
+        if (slice_offsets)
         {
-            if (i == (unsigned int) col_iter.index2()) continue;
-            if (diag_sign == 1)
-              if (max > *col_iter)  max = *col_iter;
-            if (diag_sign == -1)
-              if (max < *col_iter)  max = *col_iter;
+          vcl_size_t slice = std::upper_bound(slice_offsets->begin(), slice_offsets->end(), static_cast<unsigned int>(i)) - slice_offsets->begin() - 1;
+          slice_start = (*slice_offsets)[slice];
+          slice_stop  = (*slice_offsets)[slice+1];
         }
 
-        // If maximum is 0 then the row is independent of the others
-        if (max == 0)
-          continue;
+        // Find greatest non-diagonal negative value (positive if diagonal is negative) in row and in the part of the row inside the slice
+        ScalarType max = 0, slice_max = 0;
+        for (unsigned int k=row_start; k<row_stop; ++k)
+        {
+          unsigned int j = col_buffer[k];
+          if (static_cast<unsigned int>(i) == j) continue;
+          if (diag_sign * max > diag_sign * elements[k])
+            max = elements[k];
+          if (j >= slice_start && j < slice_stop && diag_sign * slice_max > diag_sign * elements[k])
+            slice_max = elements[k];
+        }
 
-        // Find all points that strongly influence current point (Yang, p.5)
-        for (ConstColIterator col_iter = row_iter.begin(); col_iter != row_iter.end(); ++col_iter)
+        // Find all points that strongly influence current point (Yang, p.5). If maximum is 0 then the row is independent of the others.
+        unsigned int num_influencing = 0;
+        for (unsigned int k=row_start; k<row_stop; ++k)
         {
-          unsigned int j = static_cast<unsigned int>(col_iter.index2());
-          if (i == j) continue;
-          if (diag_sign * (-*col_iter) >= tag.get_threshold() * (diag_sign * (-max)))
+          unsigned int j = col_buffer[k];
+          if (static_cast<unsigned int>(i) == j) continue;
+          if (   (max != 0 && diag_sign * (-elements[k]) >= tag.get_threshold() * (diag_sign * (-max)))
+              || (slice_max != 0 && j >= slice_start && j < slice_stop && diag_sign * (-elements[k]) >= tag.get_threshold() * (diag_sign * (-slice_max))))
           {
             // Strong influence from j to i found, save information
-            Pointvector[level][i]->add_influencing_point(Pointvector[level][j]);
+            influencing_points[row_start + num_influencing] = j;
+            ++num_influencing;
           }
         }
+        row_lengths[i] = num_influencing;
       }
 
-      #ifdef VIENNACL_AMG_DEBUG
-      std::cout << "Influence Matrix: " << std::endl;
-      boost::numeric::ublas::matrix<bool> mat;
-      Pointvector[level].get_influence_matrix(mat);
-      printmatrix (mat);
-      #endif
-
-      // Save influenced points
-      for (typename PointVectorType::iterator iter = Pointvector[level].begin(); iter != Pointvector[level].end(); ++iter)
+      // Remove unused slots
+      unsigned int index = 0;
+      influencing_offsets.resize(A.size1() + 1);
+      for (vcl_size_t i=0; i<A.size1(); ++i)
       {
-        for (typename amg_point::iterator iter2 = (*iter)->begin_influencing(); iter2 != (*iter)->end_influencing(); ++iter2)
-        {
-          (*iter2)->add_influenced_point(*iter);
-        }
+        unsigned int row_start = row_buffer[i];
+        influencing_offsets[i] = index;
+        for (unsigned int k=row_start; k<row_start + row_lengths[i]; ++k)
+          influencing_points[index++] = influencing_points[k];
       }
+      influencing_offsets[A.size1()] = index;
+      influencing_points.resize(index);
 
-      #ifdef VIENNACL_AMG_DEBUG
-      std::cout << "Influence Measures: " << std::endl;
-      boost::numeric::ublas::vector<unsigned int> temp;
-      Pointvector[level].get_influence(temp);
-      printvector (temp);
-      std::cout << "Point Sorting: " << std::endl;
-      Pointvector[level].get_sorting(temp);
-      printvector (temp);
-      #endif
+      // Save influenced points
+      Pointvector.build_influenced();
     }
 
-    /** @brief Classical (RS) one-pass coarsening. Single-Threaded! (VIENNACL_AMG_COARSE_CLASSIC_ONEPASS)
-    * @param level     Course level identifier
+    /** @brief Determines strong influences in system matrix, classical approach (RS). Multithreaded!
+    * @param level    Coarse level identifier
     * @param A      Operator matrix on all levels
     * @param Pointvector   Vector of points on all levels
     * @param tag    AMG preconditioner tag
     */
     template <typename InternalType1, typename InternalType2>
-    void amg_coarse_classic_onepass(unsigned int level, InternalType1 & A, InternalType2 & Pointvector, amg_tag & tag)
+    void amg_influence(unsigned int level, InternalType1 const & A, InternalType2 & Pointvector, amg_tag & tag)
     {
-      amg_point* c_point, *point1, *point2;
+      amg_influence(A[level], Pointvector[level], tag);
+    }
 
+    /** @brief Classical (RS) one-pass coarsening of a single operator matrix. Single-Threaded!
+    * @param A      Operator matrix
+    * @param Pointvector   Points of the operator matrix
+    * @param tag    AMG preconditioner tag
+    */
+    template <typename ScalarType>
+    void amg_coarse_classic_onepass(amg_sparsematrix<ScalarType> const & A, amg_pointvector & Pointvector, amg_tag & tag)
+    {
       // Check and save all strong influences
-      amg_influence (level, A, Pointvector, tag);
+      amg_influence(A, Pointvector, tag);
 
-      // Traverse through points and calculate initial influence measure
-      long i;
-#ifdef VIENNACL_WITH_OPENMP
-      #pragma omp parallel for private (i)
-#endif
-      for (i=0; i<static_cast<long>(Pointvector[level].size()); ++i)
-  Pointvector[level][i]->calc_influence();
+      // Undecided points sorted by influence measure from lower to higher with the lower point index coming last.
+      // Entries are pairs (influence measure, n - point index).
+      typedef std::set<std::pair<unsigned int, unsigned int> > ListType;
 
-       // Do initial sorting
-      Pointvector[level].sort();
+      unsigned int n = Pointvector.size();
+      std::vector<unsigned int> influence(n);
+      ListType pointlist;
 
-      // Get undecided point with highest influence measure
-      while ((c_point = Pointvector[level].get_nextpoint()) != NULL)
+      // Initial influence measure is the number of influenced points
+      for (unsigned int i=0; i<n; ++i)
       {
+        influence[i] = Pointvector.number_influenced(i);
+        pointlist.insert(std::make_pair(influence[i], n - i));
+      }
+
+      // Get undecided point with highest influence measure. If this measure is zero, no further C points can be constructed.
+      while (!pointlist.empty() && (--pointlist.end())->first > 0)
+      {
+        unsigned int c_point = n - (--pointlist.end())->second;
+
         // Make this point C point
-        Pointvector[level].make_cpoint(c_point);
+        pointlist.erase(--pointlist.end());
+        Pointvector.make_cpoint(c_point);
 
         // All strongly influenced points become F points
-        for (typename amg_point::iterator iter = c_point->begin_influenced(); iter != c_point->end_influenced(); ++iter)
+        for (unsigned int const * iter = Pointvector.begin_influenced(c_point); iter != Pointvector.end_influenced(c_point); ++iter)
         {
-          point1 = *iter;
+          unsigned int point1 = *iter;
           // Found strong influence from C point (c_point influences point1), check whether point is still undecided, otherwise skip
-          if (!point1->is_undecided()) continue;
+          if (!Pointvector.is_undecided(point1)) continue;
           // Make this point F point if it is still undecided point
-          Pointvector[level].make_fpoint(point1);
+          pointlist.erase(std::make_pair(influence[point1], n - point1));
+          Pointvector.make_fpoint(point1);
 
           // Add +1 to influence measure for all undecided points that strongly influence new F point
-          for (typename amg_point::iterator iter2 = point1->begin_influencing(); iter2 != point1->end_influencing(); ++iter2)
+          for (unsigned int const * iter2 = Pointvector.begin_influencing(point1); iter2 != Pointvector.end_influencing(point1); ++iter2)
           {
-            point2 = *iter2;
+            unsigned int point2 = *iter2;
             // Found strong influence to F point (point2 influences point1)
-            if (point2->is_undecided())
-              Pointvector[level].add_influence(point2,1);
+            if (Pointvector.is_undecided(point2))
+            {
+              pointlist.erase(std::make_pair(influence[point2], n - point2));
+              ++influence[point2];
+              pointlist.insert(std::make_pair(influence[point2], n - point2));
+            }
           }
         }
       }
 
-      // If a point is neither C nor F point but is nevertheless influenced by other points make it F point
-      // (this situation can happen when this point does not influence other points and the points that influence this point became F points already)
-      /*#pragma omp parallel for private (i,point1)
-      for (long i=0; i<static_cast<long>(Pointvector[level].size()); ++i)
-      {
-        point1 = Pointvector[level][i];
-        if (point1->is_undecided())
-        {
-          // Undecided point found. Check whether it is influenced by other point and if so: Make it F point.
-          if (point1->number_influencing() > 0)
-          {
-            #pragma omp critical
-            Pointvector[level].make_fpoint(point1);
-          }
-        }
-      }*/
-
       #if defined (VIENNACL_AMG_DEBUG)//  or defined (VIENNACL_AMG_DEBUGBENCH)
-      unsigned int c_points = Pointvector[level].get_cpoints();
-      unsigned int f_points = Pointvector[level].get_fpoints();
-      std::cout << "1st pass: Level " << level << ": ";
-      std::cout << "No of C points = " << c_points << ", ";
-      std::cout << "No of F points = " << f_points << std::endl;
-      #endif
-
-      #ifdef VIENNACL_AMG_DEBUG
-      std::cout << "Coarse Points:" << std::endl;
-      boost::numeric::ublas::vector<bool> C;
-      Pointvector[level].get_C(C);
-      printvector (C);
-      std::cout << "Fine Points:" << std::endl;
-      boost::numeric::ublas::vector<bool> F;
-      Pointvector[level].get_F(F);
-      printvector (F);
+      std::cout << "1st pass: ";
+      std::cout << "No of C points = " << Pointvector.get_cpoints() << ", ";
+      std::cout << "No of F points = " << Pointvector.get_fpoints() << std::endl;
       #endif
     }
 
-    /** @brief Classical (RS) two-pass coarsening. Single-Threaded! (VIENNACL_AMG_COARSE_CLASSIC)
-    * @param level    Coarse level identifier
+    /** @brief Classical (RS) one-pass coarsening. Single-Threaded! (VIENNACL_AMG_COARSE_CLASSIC_ONEPASS)
+    * @param level     Course level identifier
     * @param A      Operator matrix on all levels
     * @param Pointvector   Vector of points on all levels
     * @param tag    AMG preconditioner tag
     */
     template <typename InternalType1, typename InternalType2>
-    void amg_coarse_classic(unsigned int level, InternalType1 & A, InternalType2 & Pointvector, amg_tag & tag)
+    void amg_coarse_classic_onepass(unsigned int level, InternalType1 & A, InternalType2 & Pointvector, amg_tag & tag)
     {
-      typedef typename InternalType2::value_type PointVectorType;
+      amg_coarse_classic_onepass(A[level], Pointvector[level], tag);
+    }
 
-      bool add_C;
-      amg_point *c_point, *point1, *point2;
+    /** @brief Adds C points if a strong F-F connection between point1 and a point with higher index does not have a common C point.
+    *
+    * Second pass of the classical coarsening (and third pass of RS3).
+    *
+    * @param Pointvector   Points of the operator matrix
+    * @param point1        F point for which all strong connections are checked
+    * @param skip_start    Strong connections to points in [skip_start, skip_stop) are not checked
+    * @param skip_stop     Strong connections to points in [skip_start, skip_stop) are not checked
+    * @return              The points which were switched from F to C
+    */
+    inline std::vector<unsigned int> amg_coarse_check_ff(amg_pointvector & Pointvector, unsigned int point1, unsigned int skip_start = 0, unsigned int skip_stop = 0)
+    {
+      std::vector<unsigned int> new_cpoints;
 
-      // Use one-pass-coarsening as first pass.
-      amg_coarse_classic_onepass(level, A, Pointvector, tag);
+      // Check for strong connections from influencing and influenced points.
+      unsigned int const * iter2 = Pointvector.begin_influencing(point1);
+      unsigned int const * iter3 = Pointvector.begin_influenced(point1);
 
-      // 2nd pass: Add more C points if F-F connection does not have a common C point.
-      for (typename PointVectorType::iterator iter = Pointvector[level].begin(); iter != Pointvector[level].end(); ++iter)
+      // Iterate over both lists at once. This makes sure that points are no checked twice when influence relation is symmetric (which is often the case).
+      // Note: Only works because influencing and influenced lists are sorted by point-index.
+      while (iter2 != Pointvector.end_influencing(point1) || iter3 != Pointvector.end_influenced(point1))
       {
-        point1 = *iter;
-        // If point is F point, check for strong connections.
-        if (point1->is_fpoint())
+        unsigned int point2;
+        if (iter2 == Pointvector.end_influencing(point1))
+          point2 = *iter3++;
+        else if (iter3 == Pointvector.end_influenced(point1))
+          point2 = *iter2++;
+        else if (*iter2 == *iter3)
         {
-          // Check for strong connections from influencing and influenced points.
-          amg_point::iterator iter2 = point1->begin_influencing();
-          amg_point::iterator iter3 = point1->begin_influenced();
+          point2 = *iter2++;
+          ++iter3;
+        }
+        else if (*iter2 < *iter3)
+          point2 = *iter2++;
+        else
+          point2 = *iter3++;
+
+        // Only check points with higher index as points with lower index have been checked already.
+        if (point2 < point1)
+          continue;
+
+        if (point2 >= skip_start && point2 < skip_stop)
+          continue;
 
-          // Iterate over both lists at once. This makes sure that points are no checked twice when influence relation is symmetric (which is often the case).
-          // Note: Only works because influencing and influenced lists are sorted by point-index.
-          while(iter2 != point1->end_influencing() || iter3 != point1->end_influenced())
+        // If there is a strong connection then it has to either be a C point or a F point with common C point.
+        // C point? Then skip as everything is ok.
+        // F point? Then check whether F points point1 and point2 have a common C point.
+        if (Pointvector.is_fpoint(point2))
+        {
+          bool add_C = true;
+          // C point is common for two F points if they are both strongly influenced by that C point.
+          for (unsigned int const * iter4 = Pointvector.begin_influencing(point1); iter4 != Pointvector.end_influencing(point1); ++iter4)
           {
-            if (iter2 == point1->end_influencing())
-            {
-              point2 = *iter3;
-              ++iter3;
-            }
-            else if (iter3 == point1->end_influenced())
+            // Stop search when strong common influence is found.
+            if (Pointvector.is_cpoint(*iter4) && Pointvector.is_influencing(point2, *iter4))
             {
-              point2 = *iter2;
-              ++iter2;
-            }
-            else
-            {
-              if ((*iter2)->get_index() == (*iter3)->get_index())
-              {
-                point2 = *iter2;
-                ++iter2;
-                ++iter3;
-              }
-              else if ((*iter2)->get_index() < (*iter3)->get_index())
-              {
-                point2 = *iter2;
-                ++iter2;
-              }
-              else
-              {
-                point2 = *iter3;
-                ++iter3;
-              }
-            }
-            // Only check points with higher index as points with lower index have been checked already.
-            if (point2->get_index() < point1->get_index())
-              continue;
-
-            // If there is a strong connection then it has to either be a C point or a F point with common C point.
-            // C point? Then skip as everything is ok.
-            if (point2->is_cpoint())
-              continue;
-            // F point? Then check whether F points point1 and point2 have a common C point.
-            if (point2->is_fpoint())
-            {
-              add_C = true;
-              // C point is common for two F points if they are both strongly influenced by that C point.
-              // Compare strong influences for point1 and point2.
-              for (amg_point::iterator iter3 = point1->begin_influencing(); iter3 != point1 -> end_influencing(); ++iter3)
-              {
-                c_point = *iter3;
-                // Stop search when strong common influence is found via c_point.
-                if (c_point->is_cpoint())
-                {
-                  if (point2->is_influencing(c_point))
-                  {
-                    add_C = false;
-                    break;
-                  }
-                }
-              }
-              // No common C point found? Then make second F point to C point.
-              if (add_C == true)
-                Pointvector[level].switch_ftoc(point2);
+              add_C = false;
+              break;
             }
           }
+          // No common C point found? Then make second F point to C point.
+          if (add_C == true)
+          {
+            Pointvector.switch_ftoc(point2);
+            new_cpoints.push_back(point2);
+          }
         }
       }
 
-      #ifdef VIENNACL_AMG_DEBUG
-      std::cout << "After 2nd pass:" << std::endl;
-      std::cout << "Coarse Points:" << std::endl;
-      boost::numeric::ublas::vector<bool> C;
-      Pointvector[level].get_C(C);
-      printvector (C);
-      std::cout << "Fine Points:" << std::endl;
-      boost::numeric::ublas::vector<bool> F;
-      Pointvector[level].get_F(F);
-      printvector (F);
-      #endif
+      return new_cpoints;
+    }
 
-      #ifdef VIENNACL_AMG_DEBUG
-#ifdef VIENNACL_WITH_OPENMP
-      #pragma omp critical
-#endif
+    /** @brief Classical (RS) two-pass coarsening of a single operator matrix. Single-Threaded!
+    * @param A      Operator matrix
+    * @param Pointvector   Points of the operator matrix
+    * @param tag    AMG preconditioner tag
+    */
+    template <typename ScalarType>
+    void amg_coarse_classic(amg_sparsematrix<ScalarType> const & A, amg_pointvector & Pointvector, amg_tag & tag)
+    {
+      // Use one-pass-coarsening as first pass.
+      amg_coarse_classic_onepass(A, Pointvector, tag);
+
+      // 2nd pass: Add more C points if F-F connection does not have a common C point.
+      for (unsigned int i=0; i<Pointvector.size(); ++i)
       {
-      std::cout << "No C and no F point: ";
-      for (typename PointVectorType::iterator iter = Pointvector[level].begin(); iter != Pointvector[level].end(); ++iter)
-  if ((*iter)->is_undecided())
-    std::cout << (*iter)->get_index() << " ";
-      std::cout << std::endl;
+        // If point is F point, check for strong connections.
+        if (Pointvector.is_fpoint(i))
+          amg_coarse_check_ff(Pointvector, i);
       }
+
+      #ifdef VIENNACL_AMG_DEBUG
+      std::cout << "After 2nd pass: ";
+      std::cout << "No of C points = " << Pointvector.get_cpoints() << ", ";
+      std::cout << "No of F points = " << Pointvector.get_fpoints() << std::endl;
       #endif
     }
 
+    /** @brief Classical (RS) two-pass coarsening. Single-Threaded! (VIENNACL_AMG_COARSE_CLASSIC)
+    * @param level    Coarse level identifier
+    * @param A      Operator matrix on all levels
+    * @param Pointvector   Vector of points on all levels
+    * @param tag    AMG preconditioner tag
+    */
+    template <typename InternalType1, typename InternalType2>
+    void amg_coarse_classic(unsigned int level, InternalType1 & A, InternalType2 & Pointvector, amg_tag & tag)
+    {
+      amg_coarse_classic(A[level], Pointvector[level], tag);
+    }
+
     /** @brief Parallel classical RS0 coarsening. Multi-Threaded! (VIENNACL_AMG_COARSE_RS0 || VIENNACL_AMG_COARSE_RS3)
     * @param level    Coarse level identifier
     * @param A      Operator matrix on all level
@@ -364,70 +362,66 @@ namespace viennacl
     * @param Slicing    Partitioning of the system matrix and the other data structures to different processors
     * @param tag    AMG preconditioner tag
     */
-    template <typename InternalType1, typename InternalType2, typename InternalType3>
-    void amg_coarse_rs0(unsigned int level, InternalType1 & A, InternalType2 & Pointvector, InternalType3 & Slicing, amg_tag & tag)
+    template <typename InternalType1, typename InternalType2>
+    void amg_coarse_rs0(unsigned int level, InternalType1 & A, InternalType2 & Pointvector, amg_slicing & Slicing, amg_tag & tag)
     {
-      unsigned int total_points;
+      // On the finest level, build a new slicing first.
+      // On coarser levels use the same slicing as on the finest level (Points stay together on the same thread on all levels).
+      // This is necessary as due to interpolation and galerkin product there only exist connections between points on the same thread on coarser levels.
+      // Note: Offset is determined below after the fine level was built.
+      if (level == 0)
+        Slicing.slice_new(static_cast<unsigned int>(A[level].size1()));
 
-      // Slice matrix into parts such that points are distributed among threads
-      Slicing.slice(level, A, Pointvector);
+      std::vector<unsigned int> & Offset      = Slicing.Offset[level];
+      std::vector<unsigned int> & Offset_next = Slicing.Offset[level+1];
 
-      // Run classical coarsening in parallel
-      total_points = 0;
+      // Run classical coarsening in parallel. Number of C points of slice i is saved in Offset_next[i+1] (makes it easier later to compute offset)
 #ifdef VIENNACL_WITH_OPENMP
       #pragma omp parallel for
 #endif
       for (long i=0; i<static_cast<long>(Slicing.threads_); ++i)
       {
-        amg_coarse_classic(level,Slicing.A_slice[i],Slicing.Pointvector_slice[i],tag);
+        typename InternalType1::value_type A_slice;
+        Slicing.slice_build(level, static_cast<unsigned int>(i), A[level], A_slice);
 
-        // Save C points (using Slicing.Offset on the next level as temporary memory)
-        // Note: Number of C points for point i is saved in i+1!! (makes it easier later to compute offset)
-        Slicing.Offset[i+1][level+1] = Slicing.Pointvector_slice[i][level].get_cpoints();
-      #ifdef VIENNACL_WITH_OPENMP
-        #pragma omp critical
-      #endif
-        total_points += Slicing.Pointvector_slice[i][level].get_cpoints();
+        amg_pointvector Pointvector_slice(static_cast<unsigned int>(A_slice.size1()));
+        amg_coarse_classic(A_slice, Pointvector_slice, tag);
+
+        Offset_next[i+1] = Pointvector_slice.get_cpoints();
+        Pointvector[level].assign(Offset[i], Pointvector_slice);
       }
 
+      unsigned int total_points = 0;
+      for (unsigned int i=0; i<Slicing.threads_; ++i)
+        total_points += Offset_next[i+1];
+
       // If no coarser level can be found on any level then resume and coarsening will stop in amg_coarse()
       if (total_points != 0)
       {
-      #ifdef VIENNACL_WITH_OPENMP
-        #pragma omp parallel for
-      #endif
-        for (long i=0; i<static_cast<long>(Slicing.threads_); ++i)
+        for (unsigned int i=0; i<Slicing.threads_; ++i)
         {
-          // If no higher coarse level can be found on slice i (saved in Slicing.Offset[i+1][level+1]) then pull C point(s) to the next level
-          if (Slicing.Offset[i+1][level+1] == 0)
+          // If no higher coarse level can be found on slice i then pull all points of the slice to the next level
+          if (Offset_next[i+1] == 0)
           {
-            // All points become C points
-            for (unsigned int j=0; j<Slicing.A_slice[i][level].size1(); ++j)
-              Slicing.Pointvector_slice[i][level].make_cpoint(Slicing.Pointvector_slice[i][level][j]);
-            Slicing.Offset[i+1][level+1] = static_cast<unsigned int>(Slicing.A_slice[i][level].size1());
+            Pointvector[level].assign_cpoints(Offset[i], Offset[i+1]);
+            Offset_next[i+1] = Offset[i+1] - Offset[i];
           }
         }
 
         // Build slicing offset from number of C points (offset = total sum of C points on threads with lower number)
         for (unsigned int i=2; i<=Slicing.threads_; ++i)
-          Slicing.Offset[i][level+1] += Slicing.Offset[i-1][level+1];
+          Offset_next[i] += Offset_next[i-1];
 
-        // Join C and F points
-        Slicing.join(level, Pointvector);
+        // Update overall C and F point count
+        Pointvector[level].update_cf();
       }
 
-      // Calculate global influence measures for interpolation and/or RS3.
-      amg_influence(level, A, Pointvector, tag);
+      // Calculate global influence measures for interpolation and/or RS3. Influences found within the slices are kept.
+      amg_influence(A[level], Pointvector[level], tag, &Offset);
 
       #if defined(VIENNACL_AMG_DEBUG)// or defined (VIENNACL_AMG_DEBUGBENCH)
-      for (unsigned int i=0; i<Slicing._threads; ++i)
-      {
-        unsigned int c_points = Slicing.Pointvector_slice[i][level].get_cpoints();
-        unsigned int f_points = Slicing.Pointvector_slice[i][level].get_fpoints();
-        std::cout << "Thread " << i << ": ";
-        std::cout << "No of C points = " << c_points << ", ";
-        std::cout << "No of F points = " << f_points << std::endl;
-      }
+      for (unsigned int i=0; i<Slicing.threads_; ++i)
+        std::cout << "Thread " << i << ": No of C points = " << Offset_next[i+1] - Offset_next[i] << std::endl;
       #endif
     }
 
@@ -438,218 +432,305 @@ namespace viennacl
     * @param Slicing    Partitioning of the system matrix and the other data structures to different processors
     * @param tag    AMG preconditioner tag
     */
-    template <typename InternalType1, typename InternalType2, typename InternalType3>
-    void amg_coarse_rs3(unsigned int level, InternalType1 & A, InternalType2 & Pointvector, InternalType3 & Slicing, amg_tag & tag)
+    template <typename InternalType1, typename InternalType2>
+    void amg_coarse_rs3(unsigned int level, InternalType1 & A, InternalType2 & Pointvector, amg_slicing & Slicing, amg_tag & tag)
     {
-      amg_point *c_point, *point1, *point2;
-      bool add_C;
-      unsigned int i, j;
-
       // Run RS0 first (parallel).
       amg_coarse_rs0(level, A, Pointvector, Slicing, tag);
 
-      // Save slicing offset
-      boost::numeric::ublas::vector<unsigned int> Offset = boost::numeric::ublas::vector<unsigned int> (Slicing.Offset.size());
-      for (i=0; i<Slicing.Offset.size(); ++i)
-        Offset[i] = Slicing.Offset[i][level];
+      std::vector<unsigned int> const & Offset = Slicing.Offset[level];
 
-      // Correct the coarsening with a third pass: Don't allow strong F-F connections without common C point
-      for (i=0; i<Slicing.threads_; ++i)
-      {
-      //for (j=Slicing.Offset[i][level]; j<Slicing.Offset[i+1][level]; ++j)
-      for (j=Offset[i]; j<Offset[i+1]; ++j)
+      // Correct the coarsening with a third pass: Don't allow strong F-F connections without common C point.
+      // Only points outside the slice are checked, interior F-F connections have already been checked in second pass.
+      for (unsigned int i=0; i<Slicing.threads_; ++i)
       {
-        point1 = Pointvector[level][j];
-        // If point is F point, check for strong connections.
-        if (point1->is_fpoint())
+        for (unsigned int j=Offset[i]; j<Offset[i+1]; ++j)
         {
-          // Check for strong connections from influencing and influenced points.
-          amg_point::iterator iter2 = point1->begin_influencing();
-          amg_point::iterator iter3 = point1->begin_influenced();
+          if (!Pointvector[level].is_fpoint(j))
+            continue;
+
+          vcl_size_t new_cpoints = amg_coarse_check_ff(Pointvector[level], j, Offset[i], Offset[i+1]).size();
+
+          // Add to offsets as C points have been added.
+          for (unsigned int k=i+1; k<=Slicing.threads_; ++k)
+            Slicing.Offset[level+1][k] += static_cast<unsigned int>(new_cpoints);
+        }
+      }
+
+      #ifdef VIENNACL_AMG_DEBUG
+      std::cout << "After 3rd pass: ";
+      std::cout << "No of C points = " << Pointvector[level].get_cpoints() << ", ";
+      std::cout << "No of F points = " << Pointvector[level].get_fpoints() << std::endl;
+      #endif
+    }
+
+    /** @brief Scaling of the strength threshold of AG coarsening on the given level, 0.5^(level-1).
+    *
+    * The exponent is evaluated as a signed number, hence the finest level (level 0) uses the factor 2.
+    *
+    * @param level    Coarse level identifier
+    */
+    inline double amg_ag_threshold_scaling(unsigned int level)
+    {
+      return std::pow(0.5, static_cast<double>(level) - 1.0);
+    }
 
-          // Iterate over both lists at once. This makes sure that points are no checked twice when influence relation is symmetric (which is often the case).
-          // Note: Only works because influencing and influenced lists are sorted by point-index.
-          while(iter2 != point1->end_influencing() || iter3 != point1->end_influenced())
+    /** @brief AG (aggregation based) coarsening of the nodes of an operator matrix (used if near-nullspace vectors are supplied).
+    *
+    * The strength of the connection of two nodes is the Frobenius norm of the respective block of the operator matrix.
+    * All points of a node belong to the same aggregate. The first point of the root node of an aggregate is made a C point, all other points are F points.
+    * Neighborhoods are built in parallel, aggregation is single-threaded.
+    *
+    * @param level         Coarse level identifier
+    * @param A             Operator matrix
+    * @param points        Points of the operator matrix. Aggregates and neighborhoods (as influence lists) are set up.
+    * @param node_offsets  Node i consists of the points node_offsets[i], ..., node_offsets[i+1]-1
+    * @param tag           AMG preconditioner tag
+    */
+    template <typename ScalarType>
+    void amg_coarse_ag_nodes(unsigned int level, amg_sparsematrix<ScalarType> const & A, amg_pointvector & points, std::vector<unsigned int> const & node_offsets, amg_tag & tag)
+    {
+      long num_nodes = static_cast<long>(node_offsets.size()) - 1;
+
+      // Cannot determine aggregates for a single node (see amg_coarse_ag())
+      if (num_nodes <= 1) return;
+
+      std::vector<unsigned int> const & row_buffer = A.row_buffer();
+      std::vector<unsigned int> const & col_buffer = A.col_buffer();
+      std::vector<ScalarType>   const & elements   = A.elements();
+
+      std::vector<unsigned int> node_of_point(A.size1());
+      for (long i=0; i<num_nodes; ++i)
+        for (unsigned int x=node_offsets[i]; x<node_offsets[i+1]; ++x)
+          node_of_point[x] = static_cast<unsigned int>(i);
+
+      // Node matrix with the Frobenius norms of the blocks of A. The entries of node i are written to the slots of the rows of node i in A.
+      std::vector<unsigned int> node_row_start(num_nodes + 1);
+      for (long i=0; i<=num_nodes; ++i)
+        node_row_start[i] = row_buffer[node_offsets[i]];
+      std::vector<unsigned int> node_cols(A.nnz());
+      std::vector<ScalarType>   node_norms(A.nnz());
+      std::vector<unsigned int> node_row_lengths(num_nodes);
+      std::vector<ScalarType>   node_diag(num_nodes);
+
+#ifdef VIENNACL_WITH_OPENMP
+      #pragma omp parallel
+#endif
+      {
+        // Position of node j in the current row. Rows are processed in ascending order, hence positions from previous rows are smaller than the row start.
+        std::vector<long> marker(num_nodes, -1);
+
+#ifdef VIENNACL_WITH_OPENMP
+        #pragma omp for
+#endif
+        for (long i=0; i<num_nodes; ++i)
+        {
+          long row_start = static_cast<long>(node_row_start[i]);
+          unsigned int row_length = 0;
+          for (unsigned int x=node_offsets[i]; x<node_offsets[i+1]; ++x)
           {
-            if (iter2 == point1->end_influencing())
+            for (unsigned int k=row_buffer[x]; k<row_buffer[x+1]; ++k)
             {
-              point2 = *iter3;
-              ++iter3;
-            }
-            else if (iter3 == point1->end_influenced())
-            {
-              point2 = *iter2;
-              ++iter2;
-            }
-            else
-            {
-              if ((*iter2)->get_index() == (*iter3)->get_index())
-              {
-                point2 = *iter2;
-                ++iter2;
-                ++iter3;
-              }
-              else if ((*iter2)->get_index() < (*iter3)->get_index())
-              {
-                point2 = *iter2;
-                ++iter2;
-              }
-              else
+              unsigned int j = node_of_point[col_buffer[k]];
+              if (marker[j] < row_start)
               {
-                point2 = *iter3;
-                ++iter3;
+                marker[j] = row_start + row_length;
+                node_cols[marker[j]] = j;
+                node_norms[marker[j]] = 0;
+                ++row_length;
               }
+              node_norms[marker[j]] += elements[k] * elements[k];
             }
+          }
 
-            // Only check points with higher index as points with lower index have been checked already.
-            if (point2->get_index() < point1->get_index())
-              continue;
-
-            // Only check points that are outside the slicing boundaries (interior F-F connections have already been checked in second pass)
-            //if (point2->get_index() >= Slicing.Offset[i][level] || point2->get_index() < Slicing.Offset[i+1][level])
-            if (point2->get_index() >= Offset[i] && point2->get_index() < Offset[i+1])
-              continue;
-
-            // If there is a strong connection then it has to either be a C point or a F point with common C point.
-            // C point? Then skip as everything is ok.
-            if (point2->is_cpoint())
-              continue;
-            // F point? Then check whether F points point1 and point2 have a common C point.
-            if (point2->is_fpoint())
-            {
-              add_C = true;
-              // C point is common for two F points if they are both strongly influenced by that C point.
-              // Compare strong influences for point1 and point2.
-              for (amg_point::iterator iter3 = point1->begin_influencing(); iter3 != point1 -> end_influencing(); ++iter3)
-              {
-                c_point = *iter3;
-                // Stop search when strong common influence is found via c_point.
-                if (c_point->is_cpoint())
-                {
-                  if (point2->is_influencing(c_point))
-                  {
-                    add_C = false;
-                    break;
-                  }
-                }
-              }
-              // No common C point found? Then make second F point to C point.
-              if (add_C == true)
-              {
-                Pointvector[level].switch_ftoc(point2);
-                // Add +1 to offsets as one C point has been added.
-                for (unsigned int j=i+1; j<=Slicing.threads_; ++j)
-                  Slicing.Offset[j][level+1]++;
-              }
-                  }
-                }
-              }
-            }
+          node_diag[i] = 0;
+          for (long k=row_start; k<row_start + row_length; ++k)
+          {
+            node_norms[k] = std::sqrt(node_norms[k]);
+            if (node_cols[k] == static_cast<unsigned int>(i))
+              node_diag[i] = node_norms[k];
           }
+          node_row_lengths[i] = row_length;
+        }
+      }
 
-          #ifdef VIENNACL_AMG_DEBUG
-          std::cout << "After 3rd pass:" << std::endl;
-          std::cout << "Coarse Points:" << std::endl;
-          boost::numeric::ublas::vector<bool> C;
-          Pointvector[level].get_C(C);
-          printvector (C);
-          std::cout << "Fine Points:" << std::endl;
-          boost::numeric::ublas::vector<bool> F;
-          Pointvector[level].get_F(F);
-          printvector (F);
-          #endif
+      // Build node neighborhoods (same criterion as for single points) in the slots of the node matrix
+      std::vector<unsigned int> node_neighbors(A.nnz());
+#ifdef VIENNACL_WITH_OPENMP
+      #pragma omp parallel for
+#endif
+      for (long i=0; i<num_nodes; ++i)
+      {
+        unsigned int row_start = node_row_start[i];
+        unsigned int num_neighbors = 0;
+        for (unsigned int k=row_start; k<row_start + node_row_lengths[i]; ++k)
+        {
+          unsigned int j = node_cols[k];
+          if (j == static_cast<unsigned int>(i) || node_norms[k] >= tag.get_threshold()*amg_ag_threshold_scaling(level) * std::sqrt(node_diag[i]*node_diag[j]))
+            node_neighbors[row_start + num_neighbors++] = j;
         }
+        std::sort(node_neighbors.begin() + row_start, node_neighbors.begin() + row_start + num_neighbors);
+        node_row_lengths[i] = num_neighbors;
+      }
 
-        /** @brief AG (aggregation based) coarsening. Single-Threaded! (VIENNACL_AMG_COARSE_SA)
-        *
-        * @param level    Coarse level identifier
-        * @param A      Operator matrix on all levels
-        * @param Pointvector   Vector of points on all levels
-        * @param tag    AMG preconditioner tag
-        */
-        template <typename InternalType1, typename InternalType2>
-        void amg_coarse_ag(unsigned int level, InternalType1 & A, InternalType2 & Pointvector, amg_tag & tag)
+      // Build aggregates of nodes from neighborhoods
+      std::vector<long> node_aggregate(num_nodes, -1);
+      for (long i=0; i<num_nodes; ++i)
+      {
+        if (node_aggregate[i] < 0)
         {
-          typedef typename InternalType1::value_type SparseMatrixType;
-          typedef typename InternalType2::value_type PointVectorType;
-          typedef typename SparseMatrixType::value_type ScalarType;
-
-          typedef typename SparseMatrixType::iterator1 InternalRowIterator;
-          typedef typename SparseMatrixType::iterator2 InternalColIterator;
-
-          long x,y;
-          ScalarType diag;
-          amg_point *pointx, *pointy;
-
-          // Cannot determine aggregates if size == 1 as then a new aggregate would always consist of this point (infinite loop)
-          if (A[level].size1() == 1) return;
-
-          // SA algorithm (Vanek et al. p.6)
-          // Build neighborhoods
-    #ifdef VIENNACL_WITH_OPENMP
-          #pragma omp parallel for private (x,y,diag)
-    #endif
-          for (x=0; x<static_cast<long>(A[level].size1()); ++x)
+          node_aggregate[i] = i;
+          for (unsigned int k=node_row_start[i]; k<node_row_start[i] + node_row_lengths[i]; ++k)
+            if (node_aggregate[node_neighbors[k]] < 0)
+              node_aggregate[node_neighbors[k]] = i;
+        }
+      }
+
+      // Transfer aggregates to points. The neighborhood of a point consists of all points of the neighboring nodes.
+      std::vector<unsigned int> & neighbor_offsets = points.influencing_offsets();
+      std::vector<unsigned int> & neighbors        = points.influencing_points();
+      neighbor_offsets.resize(A.size1() + 1);
+      neighbor_offsets[0] = 0;
+      for (long i=0; i<num_nodes; ++i)
+      {
+        unsigned int num_neighbors = 0;
+        for (unsigned int k=node_row_start[i]; k<node_row_start[i] + node_row_lengths[i]; ++k)
+          num_neighbors += node_offsets[node_neighbors[k]+1] - node_offsets[node_neighbors[k]];
+
+        for (unsigned int x=node_offsets[i]; x<node_offsets[i+1]; ++x)
+        {
+          if (node_aggregate[i] == i && x == node_offsets[i])
+            points.make_cpoint(x);
+          else
+            points.make_fpoint(x);
+          points.set_aggregate(x, node_offsets[node_aggregate[i]]);
+          neighbor_offsets[x+1] = neighbor_offsets[x] + num_neighbors;
+        }
+      }
+
+      neighbors.resize(neighbor_offsets[A.size1()]);
+#ifdef VIENNACL_WITH_OPENMP
+      #pragma omp parallel for
+#endif
+      for (long i=0; i<num_nodes; ++i)
+      {
+        for (unsigned int x=node_offsets[i]; x<node_offsets[i+1]; ++x)
+        {
+          unsigned int index = neighbor_offsets[x];
+          for (unsigned int k=node_row_start[i]; k<node_row_start[i] + node_row_lengths[i]; ++k)
+            for (unsigned int y=node_offsets[node_neighbors[k]]; y<node_offsets[node_neighbors[k]+1]; ++y)
+              neighbors[index++] = y;
+        }
+      }
+      points.build_influenced();
+
+      #ifdef VIENNACL_AMG_DEBUG
+      std::cout << "After aggregation of nodes: ";
+      std::cout << "No of C points = " << points.get_cpoints() << ", ";
+      std::cout << "No of F points = " << points.get_fpoints() << std::endl;
+      #endif
+    }
+
+    /** @brief AG (aggregation based) coarsening. Single-Threaded! (VIENNACL_AMG_COARSE_SA)
+    *
+    * @param level    Coarse level identifier
+    * @param A      Operator matrix on all levels
+    * @param Pointvector   Vector of points on all levels
+    * @param Nullspace  Near-nullspace vectors and nodes on all levels. If set, nodes instead of single points are aggregated.
+    * @param tag    AMG preconditioner tag
+    */
+    template <typename InternalType1, typename InternalType2, typename InternalType3>
+    void amg_coarse_ag(unsigned int level, InternalType1 & A, InternalType2 & Pointvector, InternalType3 & Nullspace, amg_tag & tag)
+    {
+      typedef typename InternalType1::value_type SparseMatrixType;
+      typedef typename SparseMatrixType::value_type ScalarType;
+
+      if (!Nullspace.empty())
+      {
+        amg_coarse_ag_nodes(level, A[level], Pointvector[level], Nullspace.node_offsets(level), tag);
+        return;
+      }
+
+      // Cannot determine aggregates if size == 1 as then a new aggregate would always consist of this point (infinite loop)
+      if (A[level].size1() == 1) return;
+
+      std::vector<unsigned int> const & row_buffer = A[level].row_buffer();
+      std::vector<unsigned int> const & col_buffer = A[level].col_buffer();
+      std::vector<ScalarType>   const & elements   = A[level].elements();
+
+      amg_pointvector & points = Pointvector[level];
+      std::vector<unsigned int> & neighbor_offsets = points.influencing_offsets();
+      std::vector<unsigned int> & neighbors        = points.influencing_points();
+
+      std::vector<ScalarType> diag(A[level].size1());
+#ifdef VIENNACL_WITH_OPENMP
+      #pragma omp parallel for
+#endif
+      for (long x=0; x<static_cast<long>(A[level].size1()); ++x)
+        diag[x] = A[level](static_cast<unsigned int>(x), static_cast<unsigned int>(x));
+
+      // SA algorithm (Vanek et al. p.6)
+      // Build neighborhoods. Neighbors are written to the slots of the respective nonzeros of A first, then compressed.
+      std::vector<unsigned int> row_lengths(A[level].size1());
+      neighbors.resize(A[level].nnz());
+#ifdef VIENNACL_WITH_OPENMP
+      #pragma omp parallel for
+#endif
+      for (long x=0; x<static_cast<long>(A[level].size1()); ++x)
+      {
+        unsigned int num_neighbors = 0;
+        for (unsigned int k=row_buffer[x]; k<row_buffer[x+1]; ++k)
+        {
+          unsigned int y = col_buffer[k];
+          if (y == static_cast<unsigned int>(x) || (std::fabs(elements[k]) >= tag.get_threshold()*amg_ag_threshold_scaling(level) * std::sqrt(std::fabs(diag[x]*diag[y]))))
           {
-            InternalRowIterator row_iter = A[level].begin1();
-            row_iter += x;
-            diag = A[level](x,x);
-            for (InternalColIterator col_iter = row_iter.begin(); col_iter != row_iter.end(); ++col_iter)
-            {
-              y = static_cast<long>(col_iter.index2());
-              if (y == x || (std::fabs(*col_iter) >= tag.get_threshold()*pow(0.5, static_cast<double>(level-1)) * std::sqrt(std::fabs(diag*A[level](y,y)))))
-              {
-                // Neighborhood x includes point y
-                Pointvector[level][x]->add_influencing_point(Pointvector[level][y]);
-              }
-            }
+            // Neighborhood x includes point y
+            neighbors[row_buffer[x] + num_neighbors] = y;
+            ++num_neighbors;
           }
+        }
+        row_lengths[x] = num_neighbors;
+      }
 
-          #ifdef VIENNACL_AMG_DEBUG
-          std::cout << "Neighborhoods:" << std::endl;
-          boost::numeric::ublas::matrix<bool> mat;
-          Pointvector[level].get_influence_matrix(mat);
-          printmatrix (mat);
-          #endif
+      unsigned int index = 0;
+      neighbor_offsets.resize(A[level].size1() + 1);
+      for (vcl_size_t x=0; x<A[level].size1(); ++x)
+      {
+        unsigned int row_start = row_buffer[x];
+        neighbor_offsets[x] = index;
+        for (unsigned int k=row_start; k<row_start + row_lengths[x]; ++k)
+          neighbors[index++] = neighbors[k];
+      }
+      neighbor_offsets[A[level].size1()] = index;
+      neighbors.resize(index);
+      points.build_influenced();
 
-          // Build aggregates from neighborhoods
-          for (typename PointVectorType::iterator iter = Pointvector[level].begin(); iter != Pointvector[level].end(); ++iter)
+      // Build aggregates from neighborhoods
+      for (unsigned int x=0; x<points.size(); ++x)
+      {
+        if (points.is_undecided(x))
+        {
+          // Make center of aggregate to C point and include it to aggregate x.
+          points.make_cpoint(x);
+          points.set_aggregate(x, x);
+          for (unsigned int const * iter = points.begin_influencing(x); iter != points.end_influencing(x); ++iter)
           {
-            pointx = (*iter);
-
-            if (pointx->is_undecided())
+            if (points.is_undecided(*iter))
             {
-              // Make center of aggregate to C point and include it to aggregate x.
-              Pointvector[level].make_cpoint(pointx);
-              pointx->set_aggregate (pointx->get_index());
-              for (amg_point::iterator iter2 = pointx->begin_influencing(); iter2 != pointx->end_influencing(); ++iter2)
-              {
-              pointy = (*iter2);
-
-                if (pointy->is_undecided())
-                {
-                  // Make neighbor y to F point and include it to aggregate x.
-                  Pointvector[level].make_fpoint(pointy);
-                  pointy->set_aggregate (pointx->get_index());
-                }
-              }
+              // Make neighbor y to F point and include it to aggregate x.
+              points.make_fpoint(*iter);
+              points.set_aggregate(*iter, x);
             }
           }
-
-          #ifdef VIENNACL_AMG_DEBUG
-          std::cout << "After aggregation:" << std::endl;
-          std::cout << "Coarse Points:" << std::endl;
-          boost::numeric::ublas::vector<bool> C;
-          Pointvector[level].get_C(C);
-          printvector (C);
-          std::cout << "Fine Points:" << std::endl;
-          boost::numeric::ublas::vector<bool> F;
-          Pointvector[level].get_F(F);
-          printvector (F);
-          std::cout << "Aggregates:" << std::endl;
-          printvector (Aggregates[level]);
-          #endif
         }
+      }
+
+      #ifdef VIENNACL_AMG_DEBUG
+      std::cout << "After aggregation: ";
+      std::cout << "No of C points = " << points.get_cpoints() << ", ";
+      std::cout << "No of F points = " << points.get_fpoints() << std::endl;
+      #endif
+    }
       } //namespace amg
     }
   }
@@ -17,16 +17,15 @@
 
    License:         MIT (X11), see file LICENSE in the base directory
 ============================================================================= */
-
 /** @file amg_interpol.hpp
     @brief Implementations of several variants of the AMG interpolation operators (setup phase). Experimental.
 */
 
-#include <boost/numeric/ublas/vector.hpp>
 #include <cmath>
+#include <limits>
+#include <vector>
 #include "viennacl/linalg/detail/amg/amg_base.hpp"
 
-#include <map>
 #ifdef VIENNACL_WITH_OPENMP
 #include <omp.h>
 #endif
@@ -47,19 +46,106 @@ namespace viennacl
      * @param A      Operator matrix on all levels
      * @param P      Prolongation matrices. P[level] is constructed
      * @param Pointvector  Vector of points on all levels
+     * @param Nullspace  Near-nullspace vectors and nodes on all levels (only used in AG and SA)
      * @param tag    AMG preconditioner tag
     */
-    template <typename InternalType1, typename InternalType2>
-    void amg_interpol(unsigned int level, InternalType1 & A, InternalType1 & P, InternalType2 & Pointvector, amg_tag & tag)
+    template <typename InternalType1, typename InternalType2, typename InternalType3>
+    void amg_interpol(unsigned int level, InternalType1 & A, InternalType1 & P, InternalType2 & Pointvector, InternalType3 & Nullspace, amg_tag & tag)
     {
       switch (tag.get_interpol())
       {
         case VIENNACL_AMG_INTERPOL_DIRECT: amg_interpol_direct (level, A, P, Pointvector, tag); break;
         case VIENNACL_AMG_INTERPOL_CLASSIC: amg_interpol_classic (level, A, P, Pointvector, tag); break;
-        case VIENNACL_AMG_INTERPOL_AG: amg_interpol_ag (level, A, P, Pointvector, tag); break;
-        case VIENNACL_AMG_INTERPOL_SA: amg_interpol_sa (level, A, P, Pointvector, tag); break;
+        case VIENNACL_AMG_INTERPOL_AG: amg_interpol_ag (level, A, P, Pointvector, Nullspace, tag); break;
+        case VIENNACL_AMG_INTERPOL_SA: amg_interpol_sa (level, A, P, Pointvector, Nullspace, tag); break;
+      }
+    }
+
+    /** @brief Sets up the row offsets of the interpolation matrix from an upper bound for the number of entries in each row.
+     * @param P            Interpolation matrix
+     * @param rows         Number of rows (fine points)
+     * @param cols         Number of columns (coarse points)
+     * @param row_bounds   Upper bound for the number of entries in each row
+    */
+    template <typename ScalarType>
+    void amg_interpol_reserve(amg_sparsematrix<ScalarType> & P, vcl_size_t rows, vcl_size_t cols, std::vector<unsigned int> const & row_bounds)
+    {
+      P.resize(rows, cols);
+      std::vector<unsigned int> & row_buffer = P.row_buffer();
+      for (vcl_size_t i=0; i<rows; ++i)
+        row_buffer[i+1] = row_buffer[i] + row_bounds[i];
+      P.col_buffer().resize(row_buffer[rows]);
+      P.elements().resize(row_buffer[rows]);
+    }
+
+    /** @brief Interpolation truncation (for VIENNACL_AMG_INTERPOL_DIRECT and VIENNACL_AMG_INTERPOL_CLASSIC)
+    *
+    * @param P            Interpolation matrix with the entries of the row starting at P.row_buffer()[row]
+    * @param row          Row which has to be truncated
+    * @param row_length   Number of entries in the row. Updated on return, as truncated entries are removed.
+    * @param tag          AMG preconditioner tag
+    */
+    template <typename ScalarType>
+    void amg_truncate_row(amg_sparsematrix<ScalarType> & P, unsigned int row, unsigned int & row_length, amg_tag & tag)
+    {
+      unsigned int * cols   = &(P.col_buffer()[0]) + P.row_buffer()[row];
+      ScalarType   * values = &(P.elements()[0])   + P.row_buffer()[row];
+
+      ScalarType row_max, row_min, row_sum_pos, row_sum_neg, row_sum_pos_scale, row_sum_neg_scale;
+
+      row_max = 0;
+      row_min = 0;
+      row_sum_pos = 0;
+      row_sum_neg = 0;
+
+      // Truncate interpolation by making values to zero that are a lot smaller than the biggest value in a row
+      // Determine max entry and sum of row (seperately for negative and positive entries)
+      for (unsigned int k=0; k<row_length; ++k)
+      {
+        if (values[k] > row_max)
+          row_max = values[k];
+        if (values[k] < row_min)
+          row_min = values[k];
+        if (values[k] > 0)
+          row_sum_pos += values[k];
+        if (values[k] < 0)
+          row_sum_neg += values[k];
+      }
+
+      row_sum_pos_scale = row_sum_pos;
+      row_sum_neg_scale = row_sum_neg;
+
+      // Make certain values to zero (seperately for negative and positive entries)
+      for (unsigned int k=0; k<row_length; ++k)
+      {
+        if (values[k] > 0 && values[k] < tag.get_interpolweight() * row_max)
+        {
+          row_sum_pos_scale -= values[k];
+          values[k] = 0;
+        }
+        if (values[k] < 0 && values[k] > tag.get_interpolweight() * row_min)
+        {
+          row_sum_neg_scale -= values[k];
+          values[k] = 0;
+        }
+      }
+
+      // Scale remaining values such that row sum is unchanged, remove zeros
+      unsigned int new_length = 0;
+      for (unsigned int k=0; k<row_length; ++k)
+      {
+        if (values[k] == 0)
+          continue;
+        if (values[k] > 0)
+          values[new_length] = values[k] * (row_sum_pos/row_sum_pos_scale);
+        else
+          values[new_length] = values[k] * (row_sum_neg/row_sum_neg_scale);
+        cols[new_length] = cols[k];
+        ++new_length;
       }
+      row_length = new_length;
     }
+
     /** @brief Direct interpolation. Multi-threaded! (VIENNACL_AMG_INTERPOL_DIRECT)
      * @param level    Coarse level identifier
      * @param A      Operator matrix on all levels
@@ -71,90 +157,89 @@ namespace viennacl
     void amg_interpol_direct(unsigned int level, InternalType1 & A, InternalType1 & P, InternalType2 & Pointvector, amg_tag & tag)
     {
       typedef typename InternalType1::value_type SparseMatrixType;
-      //typedef typename InternalType2::value_type PointVectorType;
       typedef typename SparseMatrixType::value_type ScalarType;
-      typedef typename SparseMatrixType::iterator1 InternalRowIterator;
-      typedef typename SparseMatrixType::iterator2 InternalColIterator;
 
-      ScalarType temp_res;
-      ScalarType row_sum, c_sum, diag;
-      //int diag_sign;
-      long x, y;
-      amg_point *pointx, *pointy;
-      unsigned int c_points = Pointvector[level].get_cpoints();
-
-      // Setup Prolongation/Interpolation matrix
-      P[level] = SparseMatrixType(static_cast<unsigned int>(A[level].size1()),c_points);
-      P[level].clear();
+      amg_pointvector const & points = Pointvector[level];
+      std::vector<unsigned int> const & A_row_buffer = A[level].row_buffer();
+      std::vector<unsigned int> const & A_col_buffer = A[level].col_buffer();
+      std::vector<ScalarType>   const & A_elements   = A[level].elements();
 
       // Assign indices to C points
       Pointvector[level].build_index();
 
+      // Setup Prolongation/Interpolation matrix. A C point is interpolated from itself, a F point from its strongly influencing C points.
+      std::vector<unsigned int> row_lengths(points.size());
+      for (unsigned int x=0; x<points.size(); ++x)
+        row_lengths[x] = points.is_cpoint(x) ? 1 : (points.is_fpoint(x) ? points.number_influencing(x) : 0);
+      amg_interpol_reserve(P[level], A[level].size1(), points.get_cpoints(), row_lengths);
+
+      std::vector<unsigned int> const & P_row_buffer = P[level].row_buffer();
+      unsigned int * P_col_buffer = P[level].nnz() > 0 ? &(P[level].col_buffer()[0]) : NULL;
+      ScalarType   * P_elements   = P[level].nnz() > 0 ? &(P[level].elements()[0])   : NULL;
+
       // Direct Interpolation (Yang, p.14)
 #ifdef VIENNACL_WITH_OPENMP
-      #pragma omp parallel for private (pointx,pointy,row_sum,c_sum,temp_res,y,x,diag)
+      #pragma omp parallel for
 #endif
-      for (x=0; x < static_cast<long>(Pointvector[level].size()); ++x)
+      for (long x=0; x < static_cast<long>(points.size()); ++x)
       {
-        pointx = Pointvector[level][x];
-        /*if (A[level](x,x) > 0)
-          diag_sign = 1;
-        else
-          diag_sign = -1;*/
+        unsigned int row_length = 0;
 
         // When the current line corresponds to a C point then the diagonal coefficient is 1 and the rest 0
-        if (pointx->is_cpoint())
-          P[level](x,pointx->get_coarse_index()) = 1;
+        if (points.is_cpoint(static_cast<unsigned int>(x)))
+        {
+          P_col_buffer[P_row_buffer[x]] = points.get_coarse_index(static_cast<unsigned int>(x));
+          P_elements[P_row_buffer[x]] = 1;
+          row_length = 1;
+        }
 
         // When the current line corresponds to a F point then the diagonal is 0 and the rest has to be computed (Yang, p.14)
-        if (pointx->is_fpoint())
+        if (points.is_fpoint(static_cast<unsigned int>(x)))
         {
-          // Jump to row x
-          InternalRowIterator row_iter = A[level].begin1();
-          row_iter += x;
-
           // Row sum of coefficients (without diagonal) and sum of influencing C point coefficients has to be computed
-          row_sum = c_sum = diag = 0;
-          for (InternalColIterator col_iter = row_iter.begin(); col_iter != row_iter.end(); ++col_iter)
+          ScalarType row_sum = 0, c_sum = 0, diag = 0;
+          for (unsigned int k=A_row_buffer[x]; k<A_row_buffer[x+1]; ++k)
           {
-            y = static_cast<long>(col_iter.index2());
-            if (x == y)// || *col_iter * diag_sign > 0)
+            unsigned int y = A_col_buffer[k];
+            if (static_cast<unsigned int>(x) == y)
             {
-              diag += *col_iter;
+              diag += A_elements[k];
               continue;
             }
 
             // Sum all other coefficients in line x
-            row_sum += *col_iter;
+            row_sum += A_elements[k];
 
-            pointy = Pointvector[level][y];
             // Sum all coefficients that correspond to a strongly influencing C point
-            if (pointy->is_cpoint())
-              if (pointx->is_influencing(pointy))
-                c_sum += *col_iter;
+            if (points.is_cpoint(y) && points.is_influencing(static_cast<unsigned int>(x), y))
+              c_sum += A_elements[k];
           }
-          temp_res = -row_sum/(c_sum*diag);
+          ScalarType temp_res = -row_sum/(c_sum*diag);
 
-          // Iterate over all strongly influencing points of point x
-          for (amg_point::iterator iter = pointx->begin_influencing(); iter != pointx->end_influencing(); ++iter)
+          // Iterate over all strongly influencing points of point x. The value is only non-zero for columns that correspond to a C point
+          for (unsigned int const * iter = points.begin_influencing(static_cast<unsigned int>(x)); iter != points.end_influencing(static_cast<unsigned int>(x)); ++iter)
           {
-            pointy = *iter;
-            // The value is only non-zero for columns that correspond to a C point
-            if (pointy->is_cpoint())
+            if (!points.is_cpoint(*iter))
+              continue;
+
+            ScalarType value = temp_res * A[level](static_cast<unsigned int>(x), *iter);
+            if (value != 0)
             {
-              if (temp_res != 0)
-                P[level](x, pointy->get_coarse_index()) = temp_res * A[level](x,pointy->get_index());
+              P_col_buffer[P_row_buffer[x] + row_length] = points.get_coarse_index(*iter);
+              P_elements[P_row_buffer[x] + row_length] = value;
+              ++row_length;
             }
           }
 
           //Truncate interpolation if chosen
           if (tag.get_interpolweight() != 0)
-            amg_truncate_row(P[level], x, tag);
+            amg_truncate_row(P[level], static_cast<unsigned int>(x), row_length, tag);
         }
+
+        row_lengths[x] = row_length;
       }
 
-      // P test
-      //test_interpolation(A[level], P[level], Pointvector[level]);
+      amg_compress(P[level], row_lengths);
 
       #ifdef VIENNACL_AMG_DEBUG
       std::cout << "Prolongation Matrix:" << std::endl;
@@ -173,183 +258,298 @@ namespace viennacl
     void amg_interpol_classic(unsigned int level, InternalType1 & A, InternalType1 & P, InternalType2 & Pointvector, amg_tag & tag)
     {
       typedef typename InternalType1::value_type SparseMatrixType;
-      //typedef typename InternalType2::value_type PointVectorType;
       typedef typename SparseMatrixType::value_type ScalarType;
-      typedef typename SparseMatrixType::iterator1 InternalRowIterator;
-      typedef typename SparseMatrixType::iterator2 InternalColIterator;
-
-      ScalarType temp_res;
-      ScalarType weak_sum, strong_sum;
-      int diag_sign;
-      amg_sparsevector<ScalarType> c_sum_row;
-      amg_point *pointx, *pointy, *pointk, *pointm;
-      long x, y, k, m;
 
-      unsigned int c_points = Pointvector[level].get_cpoints();
-
-      // Setup Prolongation/Interpolation matrix
-      P[level] = SparseMatrixType(static_cast<unsigned int>(A[level].size1()), c_points);
-      P[level].clear();
+      amg_pointvector const & points = Pointvector[level];
+      SparseMatrixType const & A_level = A[level];
+      std::vector<unsigned int> const & A_row_buffer = A_level.row_buffer();
+      std::vector<unsigned int> const & A_col_buffer = A_level.col_buffer();
+      std::vector<ScalarType>   const & A_elements   = A_level.elements();
 
       // Assign indices to C points
       Pointvector[level].build_index();
 
+      // Setup Prolongation/Interpolation matrix. A C point is interpolated from itself, a F point from its strongly influencing C points.
+      std::vector<unsigned int> row_lengths(points.size());
+      for (unsigned int x=0; x<points.size(); ++x)
+        row_lengths[x] = points.is_cpoint(x) ? 1 : (points.is_fpoint(x) ? points.number_influencing(x) : 0);
+      amg_interpol_reserve(P[level], A_level.size1(), points.get_cpoints(), row_lengths);
+
+      std::vector<unsigned int> const & P_row_buffer = P[level].row_buffer();
+      unsigned int * P_col_buffer = P[level].nnz() > 0 ? &(P[level].col_buffer()[0]) : NULL;
+      ScalarType   * P_elements   = P[level].nnz() > 0 ? &(P[level].elements()[0])   : NULL;
+
       // Classical Interpolation (Yang, p.13-14)
 #ifdef VIENNACL_WITH_OPENMP
-      #pragma omp parallel for private (pointx,pointy,pointk,pointm,weak_sum,strong_sum,c_sum_row,temp_res,x,y,k,m,diag_sign)
+      #pragma omp parallel
 #endif
-      for (x=0; x < static_cast<long>(Pointvector[level].size()); ++x)
       {
-        pointx = Pointvector[level][x];
-        if (A[level](x,x) > 0)
-          diag_sign = 1;
-        else
-          diag_sign = -1;
+        // Sums of coefficients in row k of C point neighbors of x for all strongly influencing F neighbors k of x. Pairs (k, sum).
+        std::vector<std::pair<unsigned int, ScalarType> > c_sum_row;
 
-        // When the current line corresponds to a C point then the diagonal coefficient is 1 and the rest 0
-        if (pointx->is_cpoint())
-          P[level](x,pointx->get_coarse_index()) = 1;
-
-        // When the current line corresponds to a F point then the diagonal is 0 and the rest has to be computed (Yang, p.14)
-        if (pointx->is_fpoint())
+#ifdef VIENNACL_WITH_OPENMP
+        #pragma omp for
+#endif
+        for (long i=0; i < static_cast<long>(points.size()); ++i)
         {
-          // Jump to row x
-          InternalRowIterator row_iter = A[level].begin1();
-          row_iter += x;
-
-          weak_sum = 0;
-          c_sum_row = amg_sparsevector<ScalarType>(static_cast<unsigned int>(A[level].size1()));
-          c_sum_row.clear();
-          for (InternalColIterator col_iter = row_iter.begin(); col_iter != row_iter.end(); ++col_iter)
+          unsigned int x = static_cast<unsigned int>(i);
+          unsigned int row_length = 0;
+          ScalarType diag_sign = (A_level(x,x) > 0) ? ScalarType(1) : ScalarType(-1);
+
+          // When the current line corresponds to a C point then the diagonal coefficient is 1 and the rest 0
+          if (points.is_cpoint(x))
           {
-            k = static_cast<unsigned int>(col_iter.index2());
-            pointk = Pointvector[level][k];
+            P_col_buffer[P_row_buffer[x]] = points.get_coarse_index(x);
+            P_elements[P_row_buffer[x]] = 1;
+            row_length = 1;
+          }
 
-            // Sum of weakly influencing neighbors + diagonal coefficient
-            if (x == k || !pointx->is_influencing(pointk))// || *col_iter * diag_sign > 0)
+          // When the current line corresponds to a F point then the diagonal is 0 and the rest has to be computed (Yang, p.14)
+          if (points.is_fpoint(x))
+          {
+            ScalarType weak_sum = 0;
+            c_sum_row.clear();
+            for (unsigned int l=A_row_buffer[x]; l<A_row_buffer[x+1]; ++l)
             {
-              weak_sum += *col_iter;
-              continue;
-            }
+              unsigned int k = A_col_buffer[l];
 
-            // Sums of coefficients in row k (strongly influening F neighbors) of C point neighbors of x are calculated
-            if (pointk->is_fpoint() && pointx->is_influencing(pointk))
-            {
-              for (amg_point::iterator iter = pointx->begin_influencing(); iter != pointx->end_influencing(); ++iter)
+              // Sum of weakly influencing neighbors + diagonal coefficient
+              if (x == k || !points.is_influencing(x, k))
               {
-                pointm = *iter;
-                m = pointm->get_index();
+                weak_sum += A_elements[l];
+                continue;
+              }
 
-                if (pointm->is_cpoint())
+              // Sums of coefficients in row k (strongly influening F neighbors) of C point neighbors of x are calculated
+              if (points.is_fpoint(k))
+              {
+                ScalarType c_sum = 0;
+                for (unsigned int const * iter = points.begin_influencing(x); iter != points.end_influencing(x); ++iter)
+                {
                   // Only use coefficients that have opposite sign of diagonal.
-                  if (A[level](k,m) * diag_sign < 0)
-                    c_sum_row[k] += A[level](k,m);
+                  if (points.is_cpoint(*iter) && A_level(k, *iter) * diag_sign < 0)
+                    c_sum += A_level(k, *iter);
+                }
+                if (c_sum != 0)
+                  c_sum_row.push_back(std::make_pair(k, c_sum));
               }
-              continue;
             }
-          }
-
-          // Iterate over all strongly influencing points of point x
-          for (amg_point::iterator iter = pointx->begin_influencing(); iter != pointx->end_influencing(); ++iter)
-          {
-            pointy = *iter;
-            y = pointy->get_index();
 
-            // The value is only non-zero for columns that correspond to a C point
-            if (pointy->is_cpoint())
+            // Iterate over all strongly influencing points of point x. The value is only non-zero for columns that correspond to a C point
+            for (unsigned int const * iter = points.begin_influencing(x); iter != points.end_influencing(x); ++iter)
             {
-              strong_sum = 0;
+              unsigned int y = *iter;
+              if (!points.is_cpoint(y))
+                continue;
+
+              ScalarType strong_sum = 0;
               // Calculate term for strongly influencing F neighbors
-              for (typename amg_sparsevector<ScalarType>::iterator iter2 = c_sum_row.begin(); iter2 != c_sum_row.end(); ++iter2)
+              for (vcl_size_t j=0; j<c_sum_row.size(); ++j)
               {
-                k = iter2.index();
+                unsigned int k = c_sum_row[j].first;
                 // Only use coefficients that have opposite sign of diagonal.
-                if (A[level](k,y) * diag_sign < 0)
-                  strong_sum += (A[level](x,k) * A[level](k,y)) / (*iter2);
+                if (A_level(k,y) * diag_sign < 0)
+                  strong_sum += (A_level(x,k) * A_level(k,y)) / c_sum_row[j].second;
               }
 
               // Calculate coefficient
-              temp_res = - (A[level](x,y) + strong_sum) / (weak_sum);
+              ScalarType temp_res = - (A_level(x,y) + strong_sum) / (weak_sum);
               if (temp_res != 0)
-                P[level](x,pointy->get_coarse_index()) = temp_res;
+              {
+                P_col_buffer[P_row_buffer[x] + row_length] = points.get_coarse_index(y);
+                P_elements[P_row_buffer[x] + row_length] = temp_res;
+                ++row_length;
+              }
             }
+
+            //Truncate iteration if chosen
+            if (tag.get_interpolweight() != 0)
+              amg_truncate_row(P[level], x, row_length, tag);
           }
 
-          //Truncate iteration if chosen
-          if (tag.get_interpolweight() != 0)
-            amg_truncate_row(P[level], x, tag);
+          row_lengths[x] = row_length;
         }
       }
 
+      amg_compress(P[level], row_lengths);
+
       #ifdef VIENNACL_AMG_DEBUG
       std::cout << "Prolongation Matrix:" << std::endl;
       printmatrix (P[level]);
       #endif
     }
 
-    /** @brief Interpolation truncation (for VIENNACL_AMG_INTERPOL_DIRECT and VIENNACL_AMG_INTERPOL_CLASSIC)
-    *
-    * @param P    Interpolation matrix
-    * @param row  Row which has to be truncated
-    * @param tag  AMG preconditioner tag
+    /** @brief AG (aggregation based) interpolation of a single operator matrix. Multi-Threaded!
+     * @param A      Operator matrix
+     * @param P      Prolongation matrix to be constructed
+     * @param Pointvector  Points of the operator matrix with aggregates assigned
     */
-    template <typename SparseMatrixType>
-    void amg_truncate_row(SparseMatrixType & P, unsigned int row, amg_tag & tag)
+    template <typename ScalarType>
+    void amg_interpol_ag(amg_sparsematrix<ScalarType> const & A, amg_sparsematrix<ScalarType> & P, amg_pointvector & Pointvector)
     {
-      typedef typename SparseMatrixType::value_type ScalarType;
-      typedef typename SparseMatrixType::iterator1 InternalRowIterator;
-      typedef typename SparseMatrixType::iterator2 InternalColIterator;
-
-      ScalarType row_max, row_min, row_sum_pos, row_sum_neg, row_sum_pos_scale, row_sum_neg_scale;
+      // Assign indices to C points
+      Pointvector.build_index();
 
-      InternalRowIterator row_iter = P.begin1();
-      row_iter += row;
+      // Each point is interpolated from exactly one aggregate
+      P.resize(A.size1(), Pointvector.get_cpoints(), A.size1());
+      std::vector<unsigned int> & row_buffer = P.row_buffer();
+      std::vector<unsigned int> & col_buffer = P.col_buffer();
+      std::vector<ScalarType>   & elements   = P.elements();
 
-      row_max = 0;
-      row_min = 0;
-      row_sum_pos = 0;
-      row_sum_neg = 0;
-
-      // Truncate interpolation by making values to zero that are a lot smaller than the biggest value in a row
-      // Determine max entry and sum of row (seperately for negative and positive entries)
-      for (InternalColIterator col_iter = row_iter.begin(); col_iter != row_iter.end(); ++col_iter)
+      // Set prolongation such that F point is interpolated (weight=1) by the aggregate it belongs to (Vanek et al p.6)
+#ifdef VIENNACL_WITH_OPENMP
+      #pragma omp parallel for
+#endif
+      for (long x=0; x<static_cast<long>(A.size1()); ++x)
       {
-        if (*col_iter > row_max)
-          row_max = *col_iter;
-        if (*col_iter < row_min)
-          row_min = *col_iter;
-        if (*col_iter > 0)
-          row_sum_pos += *col_iter;
-        if (*col_iter < 0)
-          row_sum_neg += *col_iter;
+        // Point x belongs to aggregate y.
+        row_buffer[x+1] = static_cast<unsigned int>(x+1);
+        col_buffer[x] = Pointvector.get_coarse_index(Pointvector.get_aggregate(static_cast<unsigned int>(x)));
+        elements[x] = 1;
       }
+    }
 
-      row_sum_pos_scale = row_sum_pos;
-      row_sum_neg_scale = row_sum_neg;
+    /** @brief AG (aggregation based) interpolation of a single operator matrix from near-nullspace vectors. Multi-Threaded!
+     *
+     * The near-nullspace vectors restricted to an aggregate are orthonormalized by a thin QR factorization (modified Gram-Schmidt).
+     * The columns of Q are the columns of the prolongation belonging to the aggregate, the rows of R are the near-nullspace vectors on the coarse level.
+     * Numerically linearly dependent columns are dropped, so an aggregate provides at most as many coarse points as there are near-nullspace vectors.
+     * The coarse points of an aggregate form a node on the coarse level.
+     *
+     * @param A          Operator matrix
+     * @param P          Prolongation matrix to be constructed
+     * @param Pointvector  Points of the operator matrix with aggregates assigned
+     * @param Nullspace  Near-nullspace vectors and nodes on all levels. Vectors and nodes of level+1 are constructed.
+     * @param level      Coarse level identifier
+    */
+    template <typename ScalarType>
+    void amg_interpol_ag(amg_sparsematrix<ScalarType> const & A, amg_sparsematrix<ScalarType> & P, amg_pointvector & Pointvector, amg_nullspace<ScalarType> & Nullspace, unsigned int level)
+    {
+      unsigned int size        = static_cast<unsigned int>(A.size1());
+      unsigned int num_vectors = Nullspace.num_vectors();
+      std::vector<ScalarType> const & B = Nullspace.vectors(level);
+
+      // Assign indices to C points, i.e. to aggregates
+      Pointvector.build_index();
+      long num_aggregates = static_cast<long>(Pointvector.get_cpoints());
+
+      // Points of each aggregate (counting sort)
+      std::vector<unsigned int> aggregate_offsets(num_aggregates + 1, 0);
+      std::vector<unsigned int> aggregate_points(size);
+      for (unsigned int x=0; x<size; ++x)
+        ++aggregate_offsets[Pointvector.get_coarse_index(Pointvector.get_aggregate(x)) + 1];
+      for (long i=0; i<num_aggregates; ++i)
+        aggregate_offsets[i+1] += aggregate_offsets[i];
+      std::vector<unsigned int> position(aggregate_offsets.begin(), aggregate_offsets.end() - 1);
+      for (unsigned int x=0; x<size; ++x)
+        aggregate_points[position[Pointvector.get_coarse_index(Pointvector.get_aggregate(x))]++] = x;
+
+      // Local QR factorizations. Q is stored row by row (one row per point), R row by row for each aggregate.
+      ScalarType tolerance = std::sqrt(std::numeric_limits<ScalarType>::epsilon());
+      std::vector<ScalarType> Q(vcl_size_t(size) * num_vectors);
+      std::vector<ScalarType> R(vcl_size_t(num_aggregates) * num_vectors * num_vectors, 0);
+      std::vector<char>       column_used(vcl_size_t(num_aggregates) * num_vectors, 0);
+      std::vector<unsigned int> coarse_offsets(num_aggregates + 1, 0);
 
-      // Make certain values to zero (seperately for negative and positive entries)
-      for (InternalColIterator col_iter = row_iter.begin(); col_iter != row_iter.end(); ++col_iter)
+#ifdef VIENNACL_WITH_OPENMP
+      #pragma omp parallel for
+#endif
+      for (long i=0; i<num_aggregates; ++i)
       {
-        if (*col_iter > 0 && *col_iter < tag.get_interpolweight() * row_max)
+        unsigned int start = aggregate_offsets[i];
+        unsigned int stop  = aggregate_offsets[i+1];
+        vcl_size_t R_start = vcl_size_t(i) * num_vectors * num_vectors;
+        unsigned int rank = 0;
+
+        for (unsigned int j=0; j<num_vectors; ++j)
         {
-          row_sum_pos_scale -= *col_iter;
-          *col_iter = 0;
+          ScalarType norm_orig = 0;
+          for (unsigned int k=start; k<stop; ++k)
+          {
+            unsigned int x = aggregate_points[k];
+            Q[vcl_size_t(x)*num_vectors + j] = B[vcl_size_t(j)*size + x];
+            norm_orig += B[vcl_size_t(j)*size + x] * B[vcl_size_t(j)*size + x];
+          }
+
+          // Orthogonalize against the previous columns
+          for (unsigned int l=0; l<j; ++l)
+          {
+            ScalarType r = 0;
+            for (unsigned int k=start; k<stop; ++k)
+              r += Q[vcl_size_t(aggregate_points[k])*num_vectors + l] * Q[vcl_size_t(aggregate_points[k])*num_vectors + j];
+            for (unsigned int k=start; k<stop; ++k)
+              Q[vcl_size_t(aggregate_points[k])*num_vectors + j] -= r * Q[vcl_size_t(aggregate_points[k])*num_vectors + l];
+            R[R_start + l*num_vectors + j] = r;
+          }
+
+          ScalarType norm = 0;
+          for (unsigned int k=start; k<stop; ++k)
+            norm += Q[vcl_size_t(aggregate_points[k])*num_vectors + j] * Q[vcl_size_t(aggregate_points[k])*num_vectors + j];
+          norm = std::sqrt(norm);
+
+          // Drop columns which are numerically linearly dependent on the previous ones
+          if (norm > tolerance * std::sqrt(norm_orig))
+          {
+            column_used[vcl_size_t(i)*num_vectors + j] = 1;
+            R[R_start + j*num_vectors + j] = norm;
+            ++rank;
+          }
+          for (unsigned int k=start; k<stop; ++k)
+            Q[vcl_size_t(aggregate_points[k])*num_vectors + j] = column_used[vcl_size_t(i)*num_vectors + j] ? Q[vcl_size_t(aggregate_points[k])*num_vectors + j] / norm : 0;
         }
-        if (*col_iter < 0 && *col_iter > tag.get_interpolweight() * row_min)
+        coarse_offsets[i+1] = rank;
+      }
+      for (long i=0; i<num_aggregates; ++i)
+        coarse_offsets[i+1] += coarse_offsets[i];
+      unsigned int coarse_size = coarse_offsets[num_aggregates];
+
+      // Prolongation: The row of point x is the row of Q of x restricted to the columns used by its aggregate
+      amg_interpol_reserve(P, size, coarse_size, std::vector<unsigned int>(size, num_vectors));
+      std::vector<unsigned int> row_lengths(size);
+#ifdef VIENNACL_WITH_OPENMP
+      #pragma omp parallel for
+#endif
+      for (long i=0; i<static_cast<long>(size); ++i)
+      {
+        unsigned int x = static_cast<unsigned int>(i);
+        unsigned int aggregate = Pointvector.get_coarse_index(Pointvector.get_aggregate(x));
+        unsigned int coarse_index = coarse_offsets[aggregate];
+        unsigned int row_length = 0;
+        for (unsigned int j=0; j<num_vectors; ++j)
         {
-          row_sum_pos_scale -= *col_iter;
-          *col_iter = 0;
+          if (!column_used[vcl_size_t(aggregate)*num_vectors + j])
+            continue;
+          if (Q[vcl_size_t(x)*num_vectors + j] != 0)
+          {
+            P.col_buffer()[P.row_buffer()[x] + row_length] = coarse_index;
+            P.elements()[P.row_buffer()[x] + row_length] = Q[vcl_size_t(x)*num_vectors + j];
+            ++row_length;
+          }
+          ++coarse_index;
         }
+        row_lengths[x] = row_length;
       }
+      amg_compress(P, row_lengths);
 
-      // Scale remaining values such that row sum is unchanged
-      for (InternalColIterator col_iter = row_iter.begin(); col_iter != row_iter.end(); ++col_iter)
+      // Near-nullspace on the coarse level: Rows of R belonging to the used columns. The coarse points of each aggregate form a node.
+      std::vector<ScalarType> & B_coarse = Nullspace.vectors(level+1);
+      B_coarse.resize(vcl_size_t(coarse_size) * num_vectors);
+#ifdef VIENNACL_WITH_OPENMP
+      #pragma omp parallel for
+#endif
+      for (long i=0; i<num_aggregates; ++i)
       {
-        if (*col_iter > 0)
-          *col_iter = *col_iter *(row_sum_pos/row_sum_pos_scale);
-        if (*col_iter < 0)
-          *col_iter = *col_iter *(row_sum_neg/row_sum_neg_scale);
+        unsigned int coarse_index = coarse_offsets[i];
+        for (unsigned int l=0; l<num_vectors; ++l)
+        {
+          if (!column_used[vcl_size_t(i)*num_vectors + l])
+            continue;
+          for (unsigned int j=0; j<num_vectors; ++j)
+            B_coarse[vcl_size_t(j)*coarse_size + coarse_index] = R[vcl_size_t(i)*num_vectors*num_vectors + l*num_vectors + j];
+          ++coarse_index;
+        }
       }
+      Nullspace.node_offsets(level+1) = coarse_offsets;
     }
 
     /** @brief AG (aggregation based) interpolation. Multi-Threaded! (VIENNACL_INTERPOL_SA)
@@ -357,37 +557,15 @@ namespace viennacl
      * @param A      Operator matrix on all levels
      * @param P      Prolongation matrices. P[level] is constructed
      * @param Pointvector  Vector of points on all levels
+     * @param Nullspace  Near-nullspace vectors and nodes on all levels. If empty, the constant vector is used.
     */
-    template <typename InternalType1, typename InternalType2>
-    void amg_interpol_ag(unsigned int level, InternalType1 & A, InternalType1 & P, InternalType2 & Pointvector, amg_tag)
+    template <typename InternalType1, typename InternalType2, typename InternalType3>
+    void amg_interpol_ag(unsigned int level, InternalType1 & A, InternalType1 & P, InternalType2 & Pointvector, InternalType3 & Nullspace, amg_tag)
     {
-      typedef typename InternalType1::value_type SparseMatrixType;
-      //typedef typename InternalType2::value_type PointVectorType;
-      //typedef typename SparseMatrixType::value_type ScalarType;
-      //typedef typename SparseMatrixType::iterator1 InternalRowIterator;
-      //typedef typename SparseMatrixType::iterator2 InternalColIterator;
-
-      long x;
-      amg_point *pointx, *pointy;
-      unsigned int c_points = Pointvector[level].get_cpoints();
-
-      P[level] = SparseMatrixType(static_cast<unsigned int>(A[level].size1()), c_points);
-      P[level].clear();
-
-      // Assign indices to C points
-      Pointvector[level].build_index();
-
-      // Set prolongation such that F point is interpolated (weight=1) by the aggregate it belongs to (Vanek et al p.6)
-#ifdef VIENNACL_WITH_OPENMP
-      #pragma omp parallel for private (x,pointx)
-#endif
-      for (x=0; x<static_cast<long>(Pointvector[level].size()); ++x)
-      {
-        pointx = Pointvector[level][x];
-        pointy = Pointvector[level][pointx->get_aggregate()];
-        // Point x belongs to aggregate y.
-        P[level](x,pointy->get_coarse_index()) = 1;
-      }
+      if (Nullspace.empty())
+        amg_interpol_ag(A[level], P[level], Pointvector[level]);
+      else
+        amg_interpol_ag(A[level], P[level], Pointvector[level], Nullspace, level);
 
       #ifdef VIENNACL_AMG_DEBUG
       std::cout << "Aggregation based Prolongation:" << std::endl;
@@ -400,60 +578,72 @@ namespace viennacl
      * @param A      Operator matrix on all levels
      * @param P      Prolongation matrices. P[level] is constructed
      * @param Pointvector  Vector of points on all levels
+     * @param Nullspace  Near-nullspace vectors and nodes on all levels. If empty, the constant vector is used.
      * @param tag    AMG preconditioner tag
     */
-    template <typename InternalType1, typename InternalType2>
-    void amg_interpol_sa(unsigned int level, InternalType1 & A, InternalType1 & P, InternalType2 & Pointvector, amg_tag & tag)
+    template <typename InternalType1, typename InternalType2, typename InternalType3>
+    void amg_interpol_sa(unsigned int level, InternalType1 & A, InternalType1 & P, InternalType2 & Pointvector, InternalType3 & Nullspace, amg_tag & tag)
     {
       typedef typename InternalType1::value_type SparseMatrixType;
-      //typedef typename InternalType2::value_type PointVectorType;
       typedef typename SparseMatrixType::value_type ScalarType;
-      typedef typename SparseMatrixType::iterator1 InternalRowIterator;
-      typedef typename SparseMatrixType::iterator2 InternalColIterator;
-
-      long x,y;
-      ScalarType diag = 0;
-      unsigned int c_points = Pointvector[level].get_cpoints();
 
-      InternalType1 P_tentative = InternalType1(P.size());
-      SparseMatrixType Jacobi = SparseMatrixType(static_cast<unsigned int>(A[level].size1()), static_cast<unsigned int>(A[level].size2()));
-      Jacobi.clear();
-      P[level] = SparseMatrixType(static_cast<unsigned int>(A[level].size1()), c_points);
-      P[level].clear();
+      amg_pointvector const & points = Pointvector[level];
+      std::vector<unsigned int> const & A_row_buffer = A[level].row_buffer();
+      std::vector<unsigned int> const & A_col_buffer = A[level].col_buffer();
+      std::vector<ScalarType>   const & A_elements   = A[level].elements();
+
+      // The Jacobi matrix has the sparsity pattern of A restricted to the neighborhoods (plus the diagonal)
+      SparseMatrixType Jacobi(A[level].size1(), A[level].size2());
+      std::vector<unsigned int> row_lengths(A[level].size1());
+      std::vector<unsigned int> & J_row_buffer = Jacobi.row_buffer();
+      J_row_buffer = A_row_buffer;
+      Jacobi.col_buffer().resize(A[level].nnz());
+      Jacobi.elements().resize(A[level].nnz());
+      unsigned int * J_col_buffer = A[level].nnz() > 0 ? &(Jacobi.col_buffer()[0]) : NULL;
+      ScalarType   * J_elements   = A[level].nnz() > 0 ? &(Jacobi.elements()[0])   : NULL;
 
       // Build Jacobi Matrix via filtered A matrix (Vanek et al. p.6)
 #ifdef VIENNACL_WITH_OPENMP
-      #pragma omp parallel for private (x,y,diag)
+      #pragma omp parallel for
 #endif
-      for (x=0; x<static_cast<long>(A[level].size1()); ++x)
+      for (long i=0; i<static_cast<long>(A[level].size1()); ++i)
       {
-        diag = 0;
-        InternalRowIterator row_iter = A[level].begin1();
-        row_iter += x;
-        for (InternalColIterator col_iter = row_iter.begin(); col_iter != row_iter.end(); ++col_iter)
+        unsigned int x = static_cast<unsigned int>(i);
+
+        // Determine the structure of the Jacobi matrix by using a filtered matrix of A:
+        // The diagonal consists of the diagonal coefficient minus all coefficients of points not in the neighborhood of x.
+        // All other coefficients are the same as in A.
+        ScalarType diag = 0;
+        for (unsigned int k=A_row_buffer[x]; k<A_row_buffer[x+1]; ++k)
         {
-          y = static_cast<long>(col_iter.index2());
-          // Determine the structure of the Jacobi matrix by using a filtered matrix of A:
-          // The diagonal consists of the diagonal coefficient minus all coefficients of points not in the neighborhood of x.
-          // All other coefficients are the same as in A.
-          // Already use Jacobi matrix to save filtered A matrix to speed up computation.
+          unsigned int y = A_col_buffer[k];
           if (x == y)
-            diag += *col_iter;
-          else if (!Pointvector[level][x]->is_influencing(Pointvector[level][y]))
-            diag += -*col_iter;
-          else
-            Jacobi (x,y) = *col_iter;
+            diag += A_elements[k];
+          else if (!points.is_influencing(x, y))
+            diag += -A_elements[k];
         }
-        InternalRowIterator row_iter2 = Jacobi.begin1();
-        row_iter2 += x;
-        // Traverse through filtered A matrix and compute the Jacobi filtering
-        for (InternalColIterator col_iter2 = row_iter2.begin(); col_iter2 != row_iter2.end(); ++col_iter2)
+
+        // Compute the Jacobi filtering. Diagonal can be computed seperately.
+        unsigned int row_length = 0;
+        for (unsigned int k=A_row_buffer[x]; k<A_row_buffer[x+1]; ++k)
         {
-            *col_iter2 = - static_cast<ScalarType>(tag.get_interpolweight())/diag * *col_iter2;
+          unsigned int y = A_col_buffer[k];
+          ScalarType value = 0;
+          if (x == y)
+            value = 1 - static_cast<ScalarType>(tag.get_interpolweight());
+          else if (points.is_influencing(x, y))
+            value = - static_cast<ScalarType>(tag.get_interpolweight())/diag * A_elements[k];
+
+          if (value != 0)
+          {
+            J_col_buffer[A_row_buffer[x] + row_length] = y;
+            J_elements[A_row_buffer[x] + row_length] = value;
+            ++row_length;
+          }
         }
-        // Diagonal can be computed seperately.
-        Jacobi (x,x) = 1 - static_cast<ScalarType>(tag.get_interpolweight());
+        row_lengths[x] = row_length;
       }
+      amg_compress(Jacobi, row_lengths);
 
       #ifdef VIENNACL_AMG_DEBUG
       std::cout << "Jacobi Matrix:" << std::endl;
@@ -461,15 +651,19 @@ namespace viennacl
       #endif
 
       // Use AG interpolation as tentative prolongation
-      amg_interpol_ag(level, A, P_tentative, Pointvector, tag);
+      SparseMatrixType P_tentative;
+      if (Nullspace.empty())
+        amg_interpol_ag(A[level], P_tentative, Pointvector[level]);
+      else
+        amg_interpol_ag(A[level], P_tentative, Pointvector[level], Nullspace, level);
 
       #ifdef VIENNACL_AMG_DEBUG
       std::cout << "Tentative Prolongation:" << std::endl;
-      printmatrix(P_tentative[level]);
+      printmatrix(P_tentative);
       #endif
 
       // Multiply Jacobi matrix with tentative prolongation to get actual prolongation
-      amg_mat_prod(Jacobi,P_tentative[level],P[level]);
+      amg_mat_prod(Jacobi, P_tentative, P[level]);
 
       #ifdef VIENNACL_AMG_DEBUG
       std::cout << "Prolongation Matrix:" << std::endl;
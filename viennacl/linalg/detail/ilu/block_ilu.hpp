@@ -24,6 +24,7 @@
 
 #include <vector>
 #include <cmath>
+#include <algorithm>
 #include "viennacl/forwards.h"
 #include "viennacl/tools/tools.hpp"
 #include "viennacl/linalg/detail/ilu/common.hpp"
@@ -32,6 +33,10 @@
 
 #include <map>
 
+#ifdef VIENNACL_WITH_OPENMP
+#include <omp.h>
+#endif
+
 namespace viennacl
 {
   namespace linalg
@@ -123,6 +128,62 @@ namespace viennacl
         }
       }
 
+      /** @brief Returns the number of blocks used by block_ilu_precond if no number of blocks is supplied by the user.
+        *
+        * Two blocks per OpenMP thread are used for compensating load imbalance in the factorization, but at least eight blocks (as in the sequential case).
+        *
+        * @param matrix_size    Number of rows of the system matrix
+        */
+      inline vcl_size_t block_ilu_default_num_blocks(vcl_size_t matrix_size)
+      {
+        vcl_size_t num_blocks = 8;
+#ifdef VIENNACL_WITH_OPENMP
+        num_blocks = std::max<vcl_size_t>(num_blocks, 2 * static_cast<vcl_size_t>(omp_get_max_threads()));
+#endif
+        return std::max<vcl_size_t>(1, std::min(num_blocks, matrix_size));
+      }
+
+      /** @brief Computes block boundaries such that each block holds approximately the same number of nonzeros.
+        *
+        * Since the costs for factorization and substitution are proportional to the number of nonzeros rather than to the number of rows,
+        * this results in a better load balance than an equidistant splitting of the rows.
+        *
+        * @param row_buffer       Row index array of the system matrix in CSR format
+        * @param matrix_size      Number of rows of the system matrix
+        * @param num_blocks       Number of blocks. Each block holds at least one row.
+        * @param block_indices    The output vector of index ranges [a, b) of each block
+        */
+      template <typename IndexType>
+      void block_ilu_balanced_boundaries(IndexType const * row_buffer,
+                                         vcl_size_t matrix_size,
+                                         vcl_size_t num_blocks,
+                                         std::vector<std::pair<vcl_size_t, vcl_size_t> > & block_indices)
+      {
+        num_blocks = std::max<vcl_size_t>(1, std::min(num_blocks, matrix_size));
+        block_indices.resize(num_blocks);
+
+        double nnz = static_cast<double>(row_buffer[matrix_size] - row_buffer[0]);
+        vcl_size_t start_index = 0;
+        for (vcl_size_t i=0; i<num_blocks; ++i)
+        {
+          vcl_size_t stop_index = matrix_size;
+          if (i + 1 < num_blocks)
+          {
+            // first row at which the prefix of nonzeros exceeds the target of this block:
+            double target = (nnz * static_cast<double>(i + 1)) / static_cast<double>(num_blocks);
+            stop_index = start_index + 1;
+            while (stop_index < matrix_size && static_cast<double>(row_buffer[stop_index] - row_buffer[0]) < target)
+              ++stop_index;
+
+            // leave at least one row for each of the remaining blocks:
+            stop_index = std::min(stop_index, matrix_size - (num_blocks - i - 1));
+          }
+
+          block_indices[i] = std::pair<vcl_size_t, vcl_size_t>(start_index, stop_index);
+          start_index = stop_index;
+        }
+      }
+
 
     }
 
@@ -140,22 +201,17 @@ namespace viennacl
         typedef std::vector<std::pair<vcl_size_t, vcl_size_t> >    index_vector_type;   //the pair refers to index range [a, b) of each block
 
 
+        /** @brief Sets up the preconditioner with blocks of approximately equal number of nonzeros
+        *
+        * @param mat          The system matrix
+        * @param tag          The tag of the ILU preconditioner used for each block
+        * @param num_blocks   Number of blocks. If zero, the number of blocks is chosen from the number of OpenMP threads, cf. detail::block_ilu_default_num_blocks()
+        */
         block_ilu_precond(MatrixType const & mat,
                           ILUTag const & tag,
-                          vcl_size_t num_blocks = 8
-                         ) : tag_(tag), LU_blocks(num_blocks)
+                          vcl_size_t num_blocks = 0
+                         ) : tag_(tag), num_blocks_(num_blocks)
         {
-
-          // Set up vector of block indices:
-          block_indices_.resize(num_blocks);
-          for (vcl_size_t i=0; i<num_blocks; ++i)
-          {
-            vcl_size_t start_index = (   i  * mat.size1()) / num_blocks;
-            vcl_size_t stop_index  = ((i+1) * mat.size1()) / num_blocks;
-
-            block_indices_[i] = std::pair<vcl_size_t, vcl_size_t>(start_index, stop_index);
-          }
-
           //initialize preconditioner:
           //std::cout << "Start CPU precond" << std::endl;
           init(mat);
@@ -165,7 +221,7 @@ namespace viennacl
         block_ilu_precond(MatrixType const & mat,
                           ILUTag const & tag,
                           index_vector_type const & block_boundaries
-                         ) : tag_(tag), block_indices_(block_boundaries), LU_blocks(block_boundaries.size())
+                         ) : tag_(tag), num_blocks_(block_boundaries.size()), block_indices_(block_boundaries), LU_blocks(block_boundaries.size())
         {
           //initialize preconditioner:
           //std::cout << "Start CPU precond" << std::endl;
@@ -177,7 +233,11 @@ namespace viennacl
         template <typename VectorType>
         void apply(VectorType & vec) const
         {
-          for (vcl_size_t i=0; i<block_indices_.size(); ++i)
+          // blocks operate on disjoint ranges of 'vec', thus they can be processed concurrently:
+#ifdef VIENNACL_WITH_OPENMP
+          #pragma omp parallel for schedule(dynamic)
+#endif
+          for (long i=0; i<static_cast<long>(block_indices_.size()); ++i)
           {
             detail::ilu_vector_range<VectorType, ScalarType>  vec_range(vec, block_indices_[i].first, LU_blocks[i].size2());
 
@@ -201,8 +261,15 @@ namespace viennacl
 
           unsigned int const * row_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(mat.handle1());
 
+          if (block_indices_.size() == 0) // set up vector of block indices
+          {
+            detail::block_ilu_balanced_boundaries(row_buffer, mat.size1(), num_blocks_ > 0 ? num_blocks_ : detail::block_ilu_default_num_blocks(mat.size1()), block_indices_);
+            LU_blocks.resize(block_indices_.size());
+          }
+
+          // blocks differ in their number of nonzeros and in their fill-in (ILUT), hence they are distributed dynamically:
 #ifdef VIENNACL_WITH_OPENMP
-          #pragma omp parallel for
+          #pragma omp parallel for schedule(dynamic)
 #endif
           for (long i=0; i<static_cast<long>(block_indices_.size()); ++i)
           {
@@ -240,6 +307,7 @@ namespace viennacl
         }
 
         ILUTag const & tag_;
+        vcl_size_t num_blocks_;
         index_vector_type block_indices_;
         std::vector< viennacl::compressed_matrix<ScalarType> > LU_blocks;
     };
@@ -262,27 +330,24 @@ namespace viennacl
         typedef std::vector<std::pair<vcl_size_t, vcl_size_t> >    index_vector_type;   //the pair refers to index range [a, b) of each block
 
 
+        /** @brief Sets up the preconditioner with blocks of approximately equal number of nonzeros
+        *
+        * @param mat          The system matrix
+        * @param tag          The tag of the ILU preconditioner used for each block
+        * @param num_blocks   Number of blocks. If zero, the number of blocks is chosen from the number of OpenMP threads, cf. detail::block_ilu_default_num_blocks()
+        */
         block_ilu_precond(MatrixType const & mat,
                           ILUTag const & tag,
-                          vcl_size_t num_blocks = 8
+                          vcl_size_t num_blocks = 0
                          ) : tag_(tag),
-                             block_indices_(num_blocks),
+                             num_blocks_(num_blocks),
+                             block_indices_(),
                              gpu_block_indices(),
                              gpu_L_trans(0,0, viennacl::traits::context(mat)),
                              gpu_U_trans(0,0, viennacl::traits::context(mat)),
                              gpu_D(mat.size1(), viennacl::traits::context(mat)),
-                             LU_blocks(num_blocks)
+                             LU_blocks()
         {
-          // Set up vector of block indices:
-          block_indices_.resize(num_blocks);
-          for (vcl_size_t i=0; i<num_blocks; ++i)
-          {
-            vcl_size_t start_index = (   i  * mat.size1()) / num_blocks;
-            vcl_size_t stop_index  = ((i+1) * mat.size1()) / num_blocks;
-
-            block_indices_[i] = std::pair<vcl_size_t, vcl_size_t>(start_index, stop_index);
-          }
-
           //initialize preconditioner:
           //std::cout << "Start CPU precond" << std::endl;
           init(mat);
@@ -293,11 +358,12 @@ namespace viennacl
                           ILUTag const & tag,
                           index_vector_type const & block_boundaries
                          ) : tag_(tag),
+                             num_blocks_(block_boundaries.size()),
                              block_indices_(block_boundaries),
-                             gpu_block_indices(viennacl::traits::context(mat)),
+                             gpu_block_indices(),
                              gpu_L_trans(0,0,viennacl::traits::context(mat)),
                              gpu_U_trans(0,0,viennacl::traits::context(mat)),
-                             gpu_D(0,viennacl::traits::context(mat)),
+                             gpu_D(mat.size1(),viennacl::traits::context(mat)),
                              LU_blocks(block_boundaries.size())
         {
           //initialize preconditioner:
@@ -332,8 +398,15 @@ namespace viennacl
 
           unsigned int const * row_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(mat.handle1());
 
+          if (block_indices_.size() == 0) // set up vector of block indices
+          {
+            detail::block_ilu_balanced_boundaries(row_buffer, mat.size1(), num_blocks_ > 0 ? num_blocks_ : detail::block_ilu_default_num_blocks(mat.size1()), block_indices_);
+            LU_blocks.resize(block_indices_.size());
+          }
+
+          // blocks differ in their number of nonzeros and in their fill-in (ILUT), hence they are distributed dynamically:
 #ifdef VIENNACL_WITH_OPENMP
-          #pragma omp parallel for
+          #pragma omp parallel for schedule(dynamic)
 #endif
           for (long i=0; i<static_cast<long>(block_indices_.size()); ++i)
           {
@@ -441,6 +514,7 @@ namespace viennacl
 
 
         ILUTag const & tag_;
+        vcl_size_t num_blocks_;
         index_vector_type block_indices_;
         viennacl::backend::mem_handle gpu_block_indices;
         viennacl::compressed_matrix<ScalarType> gpu_L_trans;
@@ -0,0 +1,605 @@
+#ifndef VIENNACL_LINALG_DETAIL_CHOW_PATEL_ILU_HPP_
+#define VIENNACL_LINALG_DETAIL_CHOW_PATEL_ILU_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/detail/ilu/chow_patel_ilu.hpp
+  @brief Implementations of incomplete factorization preconditioners with static nonzero pattern using fine-grained parallel fixed-point sweeps.
+
+  The factors are computed by the iterative algorithm proposed in
+  E. Chow and A. Patel, "Fine-Grained Parallel Incomplete LU Factorization", SIAM J. Sci. Comput. 37(2), 2015.
+  Each nonzero of the factors is updated independently in each sweep, hence the setup parallelizes over all nonzeros.
+  The triangular factors can be applied either by (serial) substitution or by a few (parallel) Jacobi sweeps.
+*/
+
+#include <vector>
+#include <map>
+#include <cmath>
+#include <algorithm>
+#include "viennacl/forwards.h"
+#include "viennacl/tools/tools.hpp"
+#include "viennacl/compressed_matrix.hpp"
+#include "viennacl/vector.hpp"
+#include "viennacl/backend/memory.hpp"
+#include "viennacl/meta/result_of.hpp"
+#include "viennacl/traits/context.hpp"
+#include "viennacl/linalg/host_based/common.hpp"
+
+namespace viennacl
+{
+  namespace linalg
+  {
+
+    /** @brief A tag for incomplete LU and incomplete Cholesky factorizations with static pattern computed by fixed-point sweeps (Chow-Patel)
+    */
+    class chow_patel_tag
+    {
+      public:
+        /** @brief The constructor
+        *
+        * @param num_sweeps         Number of fixed-point sweeps for computing the factors
+        * @param num_jacobi_iters   Number of Jacobi sweeps for applying each triangular factor. If zero, the triangular systems are solved exactly by (serial) substitution.
+        */
+        chow_patel_tag(vcl_size_t num_sweeps = 3, vcl_size_t num_jacobi_iters = 2) : sweeps_(num_sweeps), jacobi_iters_(num_jacobi_iters) {}
+
+        /** @brief Returns the number of fixed-point sweeps for the factorization */
+        vcl_size_t sweeps() const { return sweeps_; }
+        /** @brief Sets the number of fixed-point sweeps for the factorization */
+        void sweeps(vcl_size_t num) { sweeps_ = num; }
+
+        /** @brief Returns the number of Jacobi sweeps for each triangular solve (zero for exact substitution) */
+        vcl_size_t jacobi_iters() const { return jacobi_iters_; }
+        /** @brief Sets the number of Jacobi sweeps for each triangular solve (zero for exact substitution) */
+        void jacobi_iters(vcl_size_t num) { jacobi_iters_ = num; }
+
+      private:
+        vcl_size_t sweeps_;
+        vcl_size_t jacobi_iters_;
+    };
+
+
+    namespace detail
+    {
+      /** @brief A triangular factor in CSR format used for the application of the preconditioner. The diagonal is stored separately. */
+      template <typename ScalarType>
+      struct chow_patel_factor
+      {
+        std::vector<unsigned int> row_buffer;
+        std::vector<unsigned int> col_buffer;
+        std::vector<ScalarType>   elements;     // off-diagonal entries only
+        std::vector<ScalarType>   diagonal;     // empty for a unit diagonal
+      };
+
+      /** @brief Solves the triangular system T x = b exactly by forward (lower == true) or backward substitution */
+      template <typename ScalarType>
+      void chow_patel_substitute(chow_patel_factor<ScalarType> const & T, ScalarType const * b, ScalarType * x, bool lower)
+      {
+        long n = static_cast<long>(T.row_buffer.size()) - 1;
+        for (long k = 0; k < n; ++k)
+        {
+          long row = lower ? k : n - 1 - k;
+          ScalarType sum = b[row];
+          for (unsigned int j = T.row_buffer[row]; j < T.row_buffer[row+1]; ++j)
+            sum -= T.elements[j] * x[T.col_buffer[j]];
+          x[row] = T.diagonal.size() > 0 ? sum / T.diagonal[row] : sum;
+        }
+      }
+
+      /** @brief Approximately solves the triangular system T x = b by Jacobi sweeps x <- D^{-1} (b - (T - D) x), starting with x = D^{-1} b. 'tmp' must have the size of b. */
+      template <typename ScalarType>
+      void chow_patel_jacobi(chow_patel_factor<ScalarType> const & T, ScalarType const * b, ScalarType * x, ScalarType * tmp, vcl_size_t iterations)
+      {
+        long n = static_cast<long>(T.row_buffer.size()) - 1;
+        bool unit_diagonal = (T.diagonal.size() == 0);
+
+#ifdef VIENNACL_WITH_OPENMP
+        #pragma omp parallel for
+#endif
+        for (long row = 0; row < n; ++row)
+          x[row] = unit_diagonal ? b[row] : b[row] / T.diagonal[row];
+
+        for (vcl_size_t iter = 0; iter < iterations; ++iter)
+        {
+#ifdef VIENNACL_WITH_OPENMP
+          #pragma omp parallel for
+#endif
+          for (long row = 0; row < n; ++row)
+          {
+            ScalarType sum = b[row];
+            for (unsigned int j = T.row_buffer[row]; j < T.row_buffer[row+1]; ++j)
+              sum -= T.elements[j] * x[T.col_buffer[j]];
+            tmp[row] = unit_diagonal ? sum : sum / T.diagonal[row];
+          }
+          std::copy(tmp, tmp + n, x);
+        }
+      }
+
+      /** @brief Extracts a host matrix into row-wise sorted (column index, value) arrays */
+      template <typename ScalarType>
+      void chow_patel_sorted_rows(viennacl::compressed_matrix<ScalarType> const & A,
+                                  std::vector<unsigned int> & row_buffer, std::vector<unsigned int> & col_buffer, std::vector<ScalarType> & elements)
+      {
+        unsigned int const * A_row_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(A.handle1());
+        unsigned int const * A_col_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(A.handle2());
+        ScalarType   const * A_elements   = viennacl::linalg::host_based::detail::extract_raw_pointer<ScalarType>(A.handle());
+
+        row_buffer.assign(A.size1() + 1, 0);
+        col_buffer.resize(A.nnz());
+        elements.resize(A.nnz());
+
+        std::vector< std::pair<unsigned int, ScalarType> > row_entries;
+        for (vcl_size_t i = 0; i < A.size1(); ++i)
+        {
+          row_entries.clear();
+          for (unsigned int j = A_row_buffer[i]; j < A_row_buffer[i+1]; ++j)
+            row_entries.push_back(std::make_pair(A_col_buffer[j], A_elements[j]));
+          std::sort(row_entries.begin(), row_entries.end());  //Note: We do not assume that the column indices within a row are sorted
+
+          unsigned int offset = A_row_buffer[i];
+          for (vcl_size_t j = 0; j < row_entries.size(); ++j)
+          {
+            col_buffer[offset + j] = row_entries[j].first;
+            elements[offset + j]   = row_entries[j].second;
+          }
+          row_buffer[i+1] = A_row_buffer[i+1];
+        }
+      }
+
+      /** @brief Computes the sum of a_k * b_k over k < bound for two sparse vectors with sorted indices */
+      template <typename ScalarType>
+      ScalarType chow_patel_sparse_dot(unsigned int const * idx_a, ScalarType const * val_a, unsigned int len_a,
+                                       unsigned int const * idx_b, ScalarType const * val_b, unsigned int len_b,
+                                       unsigned int bound)
+      {
+        ScalarType sum = 0;
+        unsigned int p = 0;
+        unsigned int q = 0;
+        while (p < len_a && q < len_b)
+        {
+          unsigned int ka = idx_a[p];
+          unsigned int kb = idx_b[q];
+          if (ka >= bound || kb >= bound)
+            break;
+          if (ka == kb)
+            sum += val_a[p++] * val_b[q++];
+          else if (ka < kb)
+            ++p;
+          else
+            ++q;
+        }
+        return sum;
+      }
+
+      /** @brief Transposes a matrix given by sorted CSR arrays. Returns in 'permutation' the position of each entry of the result in the input. */
+      inline void chow_patel_transpose(std::vector<unsigned int> const & row_buffer, std::vector<unsigned int> const & col_buffer, vcl_size_t cols,
+                                       std::vector<unsigned int> & row_buffer_trans, std::vector<unsigned int> & col_buffer_trans, std::vector<unsigned int> & permutation)
+      {
+        vcl_size_t rows = row_buffer.size() - 1;
+        row_buffer_trans.assign(cols + 1, 0);
+        for (vcl_size_t k = 0; k < col_buffer.size(); ++k)
+          ++row_buffer_trans[col_buffer[k] + 1];
+        for (vcl_size_t i = 0; i < cols; ++i)
+          row_buffer_trans[i+1] += row_buffer_trans[i];
+
+        std::vector<unsigned int> position(row_buffer_trans.begin(), row_buffer_trans.end() - 1);
+        col_buffer_trans.resize(col_buffer.size());
+        permutation.resize(col_buffer.size());
+        for (vcl_size_t i = 0; i < rows; ++i)
+          for (unsigned int k = row_buffer[i]; k < row_buffer[i+1]; ++k)
+          {
+            unsigned int pos = position[col_buffer[k]]++;
+            col_buffer_trans[pos] = static_cast<unsigned int>(i);
+            permutation[pos] = k;
+          }
+      }
+
+      /** @brief Computes the lower triangular IC0 factor of a symmetric positive definite host matrix by parallel fixed-point sweeps (Chow-Patel).
+      *
+      * On return, L_row_buffer, L_col_buffer and L_values hold L in CSR format with sorted column indices. The diagonal is the last entry in each row.
+      */
+      template <typename ScalarType>
+      void chow_patel_icc_factor(viennacl::compressed_matrix<ScalarType> const & A, vcl_size_t sweeps,
+                                 std::vector<unsigned int> & L_row_buffer, std::vector<unsigned int> & L_col_buffer, std::vector<ScalarType> & L_values)
+      {
+        std::vector<unsigned int> A_row_buffer, A_col_buffer;
+        std::vector<ScalarType> A_elements;
+        chow_patel_sorted_rows(A, A_row_buffer, A_col_buffer, A_elements);
+        vcl_size_t n = A.size1();
+
+        // lower triangular part of A including the diagonal, which is the last entry in each row:
+        L_row_buffer.assign(n + 1, 0);
+        L_col_buffer.clear();
+        std::vector<ScalarType> L_a;
+        for (vcl_size_t i = 0; i < n; ++i)
+        {
+          for (unsigned int k = A_row_buffer[i]; k < A_row_buffer[i+1]; ++k)
+            if (A_col_buffer[k] <= i)
+            {
+              L_col_buffer.push_back(A_col_buffer[k]);
+              L_a.push_back(A_elements[k]);
+            }
+          L_row_buffer[i+1] = static_cast<unsigned int>(L_col_buffer.size());
+          assert(L_row_buffer[i+1] > L_row_buffer[i] && L_col_buffer[L_row_buffer[i+1] - 1] == i && bool("Chow-Patel IC requires all diagonal entries in the sparsity pattern"));
+        }
+
+        // initial guess:
+        L_values.resize(L_a.size());
+        for (vcl_size_t i = 0; i < n; ++i)
+          for (unsigned int k = L_row_buffer[i]; k < L_row_buffer[i+1]; ++k)
+          {
+            ScalarType a_jj = L_a[L_row_buffer[L_col_buffer[k] + 1] - 1];
+            L_values[k] = (a_jj > 0) ? L_a[k] / std::sqrt(a_jj) : L_a[k];
+          }
+
+        //
+        // Fixed-point sweeps:
+        //
+        std::vector<ScalarType> L_old;
+        long num_rows = static_cast<long>(n);
+        for (vcl_size_t sweep = 0; sweep < sweeps; ++sweep)
+        {
+          L_old = L_values;
+          ScalarType const * L_old_ptr = &(L_old[0]);
+          unsigned int const * L_col_ptr = &(L_col_buffer[0]);
+
+#ifdef VIENNACL_WITH_OPENMP
+          #pragma omp parallel for
+#endif
+          for (long i = 0; i < num_rows; ++i)
+          {
+            unsigned int row_i_begin = L_row_buffer[i];
+            unsigned int row_i_len   = L_row_buffer[i+1] - row_i_begin;
+            for (unsigned int k = L_row_buffer[i]; k < L_row_buffer[i+1]; ++k)
+            {
+              unsigned int j = L_col_buffer[k];
+              unsigned int row_j_begin = L_row_buffer[j];
+              ScalarType sum = chow_patel_sparse_dot(L_col_ptr + row_i_begin, L_old_ptr + row_i_begin, row_i_len,
+                                                     L_col_ptr + row_j_begin, L_old_ptr + row_j_begin, L_row_buffer[j+1] - row_j_begin,
+                                                     j);
+              if (j < static_cast<unsigned int>(i))
+              {
+                ScalarType l_jj = L_old[L_row_buffer[j+1] - 1];
+                if (l_jj != 0)
+                  L_values[k] = (L_a[k] - sum) / l_jj;
+              }
+              else if (L_a[k] - sum > 0) //keep the previous value if the factorization breaks down
+                L_values[k] = std::sqrt(L_a[k] - sum);
+            }
+          }
+        }
+      }
+
+      /** @brief Copies the system matrix to a compressed_matrix in main memory */
+      template <typename MatrixType, typename ScalarType>
+      void chow_patel_copy_to_host(MatrixType const & mat, viennacl::compressed_matrix<ScalarType> & A)
+      {
+        viennacl::switch_memory_context(A, viennacl::context(viennacl::MAIN_MEMORY));
+        viennacl::copy(mat, A);
+      }
+
+      template <typename ScalarType, unsigned int ALIGNMENT>
+      void chow_patel_copy_to_host(viennacl::compressed_matrix<ScalarType, ALIGNMENT> const & mat, viennacl::compressed_matrix<ScalarType> & A)
+      {
+        viennacl::switch_memory_context(A, viennacl::context(viennacl::MAIN_MEMORY));
+        A = mat;
+      }
+
+      /** @brief Applies the preconditioner x <- U^{-1} L^{-1} x for vectors of arbitrary type with operator[] */
+      template <typename ScalarType, typename VectorType>
+      void chow_patel_apply(chow_patel_factor<ScalarType> const & L, chow_patel_factor<ScalarType> const & U, vcl_size_t jacobi_iters,
+                            VectorType & vec, std::vector<ScalarType> & buffer)
+      {
+        vcl_size_t n = L.row_buffer.size() - 1;
+        buffer.resize(3 * n);
+        ScalarType * b   = &(buffer[0]);
+        ScalarType * x   = b + n;
+        ScalarType * tmp = x + n;
+        for (vcl_size_t i = 0; i < n; ++i)
+          b[i] = vec[i];
+
+        if (jacobi_iters == 0)
+        {
+          chow_patel_substitute(L, b, x, true);
+          chow_patel_substitute(U, x, b, false);
+        }
+        else
+        {
+          chow_patel_jacobi(L, b, x, tmp, jacobi_iters);
+          chow_patel_jacobi(U, x, b, tmp, jacobi_iters);
+        }
+
+        for (vcl_size_t i = 0; i < n; ++i)
+          vec[i] = b[i];
+      }
+
+      /** @brief Applies the preconditioner x <- U^{-1} L^{-1} x for a ViennaCL vector. The vector is temporarily moved to main memory if necessary. */
+      template <typename ScalarType>
+      void chow_patel_apply(chow_patel_factor<ScalarType> const & L, chow_patel_factor<ScalarType> const & U, vcl_size_t jacobi_iters,
+                            viennacl::vector<ScalarType> & vec, std::vector<ScalarType> & buffer)
+      {
+        viennacl::context old_context = viennacl::traits::context(vec);
+        if (old_context.memory_type() != viennacl::MAIN_MEMORY)
+          viennacl::switch_memory_context(vec, viennacl::context(viennacl::MAIN_MEMORY));
+
+        vcl_size_t n = L.row_buffer.size() - 1;
+        buffer.resize(2 * n);
+        ScalarType * b   = viennacl::linalg::host_based::detail::extract_raw_pointer<ScalarType>(vec.handle());
+        ScalarType * x   = &(buffer[0]);
+        ScalarType * tmp = x + n;
+
+        if (jacobi_iters == 0)
+        {
+          chow_patel_substitute(L, b, x, true);
+          chow_patel_substitute(U, x, b, false);
+        }
+        else
+        {
+          chow_patel_jacobi(L, b, x, tmp, jacobi_iters);
+          chow_patel_jacobi(U, x, b, tmp, jacobi_iters);
+        }
+
+        if (old_context.memory_type() != viennacl::MAIN_MEMORY)
+          viennacl::switch_memory_context(vec, old_context);
+      }
+    }
+
+
+    /** @brief Incomplete LU preconditioner with static pattern (ILU0), where the factors are computed by parallel fixed-point sweeps (Chow-Patel). Can be supplied to solve()-routines.
+    *
+    * The factors A = L U (L with unit diagonal) satisfy (L U)_ij = a_ij on the nonzero pattern of A. Each sweep updates all entries of L and U from the values of the previous sweep:
+    *   l_ij = (a_ij - sum_{k<j} l_ik u_kj) / u_jj   for i > j,
+    *   u_ij =  a_ij - sum_{k<i} l_ik u_kj            for i <= j.
+    * The initial guess is given by the lower and upper triangular part of A. A few sweeps usually result in a preconditioner of similar quality as the classical ILU0.
+    * The system matrix must have nonzero diagonal entries.
+    */
+    template <typename MatrixType>
+    class chow_patel_ilu_precond
+    {
+        typedef typename viennacl::result_of::cpu_value_type<typename MatrixType::value_type>::type    ScalarType;
+
+      public:
+        chow_patel_ilu_precond(MatrixType const & mat, chow_patel_tag const & tag) : tag_(tag)
+        {
+          init(mat);
+        }
+
+        template <typename VectorType>
+        void apply(VectorType & vec) const
+        {
+          detail::chow_patel_apply(L_, U_, tag_.jacobi_iters(), vec, buffer_);
+        }
+
+      private:
+        void init(MatrixType const & mat)
+        {
+          viennacl::compressed_matrix<ScalarType> A;
+          detail::chow_patel_copy_to_host(mat, A);
+
+          std::vector<unsigned int> A_row_buffer, A_col_buffer;
+          std::vector<ScalarType> A_elements;
+          detail::chow_patel_sorted_rows(A, A_row_buffer, A_col_buffer, A_elements);
+          vcl_size_t n = A.size1();
+
+          //
+          // L (strictly lower part) is kept row-wise, U (upper part including the diagonal) column-wise, so that both operands of each update are contiguous.
+          //
+          std::vector<unsigned int> L_row_buffer(n + 1, 0), L_col_buffer;
+          std::vector<ScalarType>   L_a, L_values;
+          std::vector<unsigned int> U_csr_row_buffer(n + 1, 0), U_csr_col_buffer;
+          std::vector<ScalarType>   U_csr_a;
+          for (vcl_size_t i = 0; i < n; ++i)
+          {
+            for (unsigned int k = A_row_buffer[i]; k < A_row_buffer[i+1]; ++k)
+            {
+              if (A_col_buffer[k] < i)
+              {
+                L_col_buffer.push_back(A_col_buffer[k]);
+                L_a.push_back(A_elements[k]);
+              }
+              else
+              {
+                U_csr_col_buffer.push_back(A_col_buffer[k]);
+                U_csr_a.push_back(A_elements[k]);
+              }
+            }
+            L_row_buffer[i+1]     = static_cast<unsigned int>(L_col_buffer.size());
+            U_csr_row_buffer[i+1] = static_cast<unsigned int>(U_csr_col_buffer.size());
+          }
+
+          std::vector<unsigned int> U_col_buffer, U_row_buffer, U_permutation;   // CSC format of U: U_col_buffer holds the column start indices
+          detail::chow_patel_transpose(U_csr_row_buffer, U_csr_col_buffer, n, U_col_buffer, U_row_buffer, U_permutation);
+          std::vector<ScalarType> U_a(U_row_buffer.size());
+          for (vcl_size_t k = 0; k < U_a.size(); ++k)
+            U_a[k] = U_csr_a[U_permutation[k]];
+
+          // diagonal is the last entry in each column of U:
+          std::vector<unsigned int> U_diag_index(n);
+          for (vcl_size_t j = 0; j < n; ++j)
+          {
+            assert(U_col_buffer[j+1] > U_col_buffer[j] && U_row_buffer[U_col_buffer[j+1] - 1] == j && bool("Chow-Patel ILU requires all diagonal entries in the sparsity pattern"));
+            U_diag_index[j] = U_col_buffer[j+1] - 1;
+          }
+
+          // initial guess:
+          std::vector<ScalarType> U_values(U_a);
+          L_values.resize(L_a.size());
+          for (vcl_size_t i = 0; i < n; ++i)
+            for (unsigned int k = L_row_buffer[i]; k < L_row_buffer[i+1]; ++k)
+            {
+              ScalarType u_jj = U_a[U_diag_index[L_col_buffer[k]]];
+              L_values[k] = (u_jj != 0) ? L_a[k] / u_jj : L_a[k];
+            }
+
+          //
+          // Fixed-point sweeps. Each sweep computes new values from the previous ones, so all entries are updated independently.
+          //
+          std::vector<ScalarType> L_old, U_old;
+          long num_rows = static_cast<long>(n);
+          for (vcl_size_t sweep = 0; sweep < tag_.sweeps(); ++sweep)
+          {
+            L_old = L_values;
+            U_old = U_values;
+            ScalarType const * L_old_ptr = L_old.size() > 0 ? &(L_old[0]) : NULL;
+            ScalarType const * U_old_ptr = U_old.size() > 0 ? &(U_old[0]) : NULL;
+            unsigned int const * L_col_ptr = L_col_buffer.size() > 0 ? &(L_col_buffer[0]) : NULL;
+            unsigned int const * U_row_ptr = U_row_buffer.size() > 0 ? &(U_row_buffer[0]) : NULL;
+
+#ifdef VIENNACL_WITH_OPENMP
+            #pragma omp parallel for
+#endif
+            for (long i = 0; i < num_rows; ++i)
+            {
+              unsigned int L_begin = L_row_buffer[i];
+              unsigned int L_len   = L_row_buffer[i+1] - L_begin;
+              for (unsigned int k = L_row_buffer[i]; k < L_row_buffer[i+1]; ++k)
+              {
+                unsigned int j = L_col_buffer[k];
+                ScalarType sum = detail::chow_patel_sparse_dot(L_col_ptr + L_begin, L_old_ptr + L_begin, L_len,
+                                                               U_row_ptr + U_col_buffer[j], U_old_ptr + U_col_buffer[j], U_col_buffer[j+1] - U_col_buffer[j],
+                                                               j);
+                ScalarType u_jj = U_old[U_diag_index[j]];
+                if (u_jj != 0)
+                  L_values[k] = (L_a[k] - sum) / u_jj;
+              }
+            }
+
+#ifdef VIENNACL_WITH_OPENMP
+            #pragma omp parallel for
+#endif
+            for (long j = 0; j < num_rows; ++j)
+            {
+              unsigned int U_begin = U_col_buffer[j];
+              unsigned int U_len   = U_col_buffer[j+1] - U_begin;
+              for (unsigned int k = U_col_buffer[j]; k < U_col_buffer[j+1]; ++k)
+              {
+                unsigned int i = U_row_buffer[k];
+                ScalarType sum = detail::chow_patel_sparse_dot(L_col_ptr + L_row_buffer[i], L_old_ptr + L_row_buffer[i], L_row_buffer[i+1] - L_row_buffer[i],
+                                                               U_row_ptr + U_begin, U_old_ptr + U_begin, U_len,
+                                                               i);
+                U_values[k] = U_a[k] - sum;
+              }
+            }
+          }
+
+          //
+          // Set up the triangular factors for the application:
+          //
+          L_.row_buffer.swap(L_row_buffer);
+          L_.col_buffer.swap(L_col_buffer);
+          L_.elements.swap(L_values);
+          L_.diagonal.clear();
+
+          U_.row_buffer.assign(n + 1, 0);
+          U_.diagonal.resize(n);
+          for (vcl_size_t i = 0; i < n; ++i)
+          {
+            for (unsigned int k = U_csr_row_buffer[i]; k < U_csr_row_buffer[i+1]; ++k)
+              if (U_csr_col_buffer[k] != i)
+                U_.col_buffer.push_back(U_csr_col_buffer[k]);
+            U_.row_buffer[i+1] = static_cast<unsigned int>(U_.col_buffer.size());
+          }
+          U_.elements.resize(U_.col_buffer.size());
+          std::vector<unsigned int> position(U_.row_buffer.begin(), U_.row_buffer.end() - 1);
+          for (vcl_size_t j = 0; j < n; ++j)   // U_values is column-wise, rows within a column are increasing
+            for (unsigned int k = U_col_buffer[j]; k < U_col_buffer[j+1]; ++k)
+            {
+              unsigned int i = U_row_buffer[k];
+              if (i == j)
+                U_.diagonal[j] = U_values[k];
+              else
+                U_.elements[position[i]++] = U_values[k];
+            }
+        }
+
+        chow_patel_tag tag_;
+        detail::chow_patel_factor<ScalarType> L_;
+        detail::chow_patel_factor<ScalarType> U_;
+        mutable std::vector<ScalarType> buffer_;
+    };
+
+
+    /** @brief Incomplete Cholesky preconditioner with static pattern (IC0) for symmetric positive definite matrices, where the factor is computed by parallel fixed-point sweeps (Chow-Patel).
+    *  Can be supplied to solve()-routines.
+    *
+    * The lower triangular factor L satisfies (L L^T)_ij = a_ij on the lower triangular nonzero pattern of A. Each sweep updates all entries from the values of the previous sweep:
+    *   l_ij = (a_ij - sum_{k<j} l_ik l_jk) / l_jj   for i > j,
+    *   l_ii = sqrt(a_ii - sum_{k<i} l_ik^2).
+    * The initial guess is given by the lower triangular part of A scaled by the inverse square roots of the diagonal.
+    */
+    template <typename MatrixType>
+    class chow_patel_icc_precond
+    {
+        typedef typename viennacl::result_of::cpu_value_type<typename MatrixType::value_type>::type    ScalarType;
+
+      public:
+        chow_patel_icc_precond(MatrixType const & mat, chow_patel_tag const & tag) : tag_(tag)
+        {
+          init(mat);
+        }
+
+        template <typename VectorType>
+        void apply(VectorType & vec) const
+        {
+          detail::chow_patel_apply(L_, LT_, tag_.jacobi_iters(), vec, buffer_);
+        }
+
+      private:
+        void init(MatrixType const & mat)
+        {
+          viennacl::compressed_matrix<ScalarType> A;
+          detail::chow_patel_copy_to_host(mat, A);
+
+          std::vector<unsigned int> L_row_buffer, L_col_buffer;
+          std::vector<ScalarType> L_values;
+          detail::chow_patel_icc_factor(A, tag_.sweeps(), L_row_buffer, L_col_buffer, L_values);
+          vcl_size_t n = A.size1();
+
+          //
+          // Set up L and L^T for the application:
+          //
+          L_.row_buffer.assign(n + 1, 0);
+          L_.diagonal.resize(n);
+          for (vcl_size_t i = 0; i < n; ++i)
+          {
+            for (unsigned int k = L_row_buffer[i]; k < L_row_buffer[i+1] - 1; ++k)
+            {
+              L_.col_buffer.push_back(L_col_buffer[k]);
+              L_.elements.push_back(L_values[k]);
+            }
+            L_.diagonal[i] = L_values[L_row_buffer[i+1] - 1];
+            L_.row_buffer[i+1] = static_cast<unsigned int>(L_.col_buffer.size());
+          }
+
+          std::vector<unsigned int> permutation;
+          detail::chow_patel_transpose(L_.row_buffer, L_.col_buffer, n, LT_.row_buffer, LT_.col_buffer, permutation);
+          LT_.elements.resize(permutation.size());
+          for (vcl_size_t k = 0; k < permutation.size(); ++k)
+            LT_.elements[k] = L_.elements[permutation[k]];
+          LT_.diagonal = L_.diagonal;
+        }
+
+        chow_patel_tag tag_;
+        detail::chow_patel_factor<ScalarType> L_;
+        detail::chow_patel_factor<ScalarType> LT_;
+        mutable std::vector<ScalarType> buffer_;
+    };
+
+  }
+}
+
+#endif
@@ -127,7 +127,7 @@ namespace viennacl
             {
               if (col_buffer[buf_index_akj] == j)
               {
-                a_kk = elements[buf_index_akj];
+                a_kj = elements[buf_index_akj];
                 break;
               }
             }
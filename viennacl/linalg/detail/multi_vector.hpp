@@ -0,0 +1,295 @@
+#ifndef VIENNACL_LINALG_DETAIL_MULTI_VECTOR_HPP_
+#define VIENNACL_LINALG_DETAIL_MULTI_VECTOR_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/detail/multi_vector.hpp
+    @brief Helper routines for treating the columns of a tall and skinny dense matrix as a block of vectors (multi-vector), as used by the block Krylov methods.
+*/
+
+#include <vector>
+#include <cmath>
+#include <limits>
+#include "viennacl/forwards.h"
+#include "viennacl/vector.hpp"
+#include "viennacl/matrix.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/norm_2.hpp"
+#include "viennacl/linalg/inner_prod.hpp"
+#include "viennacl/traits/context.hpp"
+#include "viennacl/linalg/detail/small_dense.hpp"
+
+namespace viennacl
+{
+  namespace linalg
+  {
+    namespace detail
+    {
+
+      /** @brief Returns a vector which refers to the memory of the j-th column of the dense matrix A (no data is copied).
+      *
+      * Modifications of the returned vector directly modify A.
+      */
+      template <typename T>
+      viennacl::vector_base<T> column_view(viennacl::matrix_base<T> & A, vcl_size_t j)
+      {
+        if (A.row_major())
+          return viennacl::vector_base<T>(A.handle(), A.size1(),
+                                          A.start1() * A.internal_size2() + A.start2() + j * A.stride2(),
+                                          static_cast<vcl_ptrdiff_t>(A.stride1() * A.internal_size2()));
+        return viennacl::vector_base<T>(A.handle(), A.size1(),
+                                        A.start1() + (A.start2() + j * A.stride2()) * A.internal_size1(),
+                                        static_cast<vcl_ptrdiff_t>(A.stride1()));
+      }
+
+      /** @brief Computes the 2-norms of all columns of A */
+      template <typename T>
+      void column_norms(viennacl::matrix_base<T> & A, std::vector<T> & norms)
+      {
+        norms.resize(A.size2());
+        for (vcl_size_t j=0; j<A.size2(); ++j)
+        {
+          viennacl::vector_base<T> col = column_view(A, j);
+          norms[j] = viennacl::linalg::norm_2(col);
+        }
+      }
+
+      /** @brief Fills the columns first, ..., last-1 of V with (reproducible) pseudo-random entries in [-0.5, 0.5)
+      *
+      * @param V        The multi-vector
+      * @param first    First column to be filled
+      * @param last     Column index past the last column to be filled
+      * @param state    State of the linear congruential generator, updated on exit
+      */
+      template <typename T>
+      void fill_random_columns(viennacl::matrix_base<T> & V, vcl_size_t first, vcl_size_t last, unsigned long & state)
+      {
+        std::vector<T> values(V.size1());
+        for (vcl_size_t j=first; j<last; ++j)
+        {
+          for (vcl_size_t i=0; i<values.size(); ++i)
+          {
+            state = (1103515245ul * state + 12345ul) % 2147483648ul;   //simple linear congruential generator, independent of std::rand()
+            values[i] = T(state) / T(2147483648.0) - T(0.5);
+          }
+          viennacl::vector_base<T> col = column_view(V, j);
+          viennacl::copy(values.begin(), values.end(), col.begin());
+        }
+      }
+
+      /** @brief Computes the inner products <x, y_i> for all vectors y_i in the tuple by a single kernel and copies the result to the host.
+      *
+      * @param x        The common vector
+      * @param y_tuple  The vectors y_i
+      * @param buffer   Device buffer for the results, resized if necessary
+      * @param result   The inner products on the host
+      */
+      template <typename T>
+      void multi_inner_prod(viennacl::vector_base<T> const & x, viennacl::vector_tuple<T> const & y_tuple,
+                            viennacl::vector<T> & buffer, std::vector<T> & result)
+      {
+        if (buffer.size() != y_tuple.const_size())
+          buffer.resize(y_tuple.const_size(), false);
+        buffer = viennacl::linalg::inner_prod(x, y_tuple);
+        result.resize(y_tuple.const_size());
+        viennacl::copy(buffer.begin(), buffer.end(), result.begin());
+      }
+
+      /** @brief Computes the linear combination result = sum_i coeffs[i] * X_i with two terms per (fused) vector update.
+      *
+      * The result vector must not be one of the vectors X_i.
+      */
+      template <typename T>
+      void multi_vector_combination(std::vector<viennacl::vector_base<T> const *> const & X, std::vector<T> const & coeffs,
+                                    viennacl::vector_base<T> & result)
+      {
+        if (X.size() == 0)
+        {
+          result.clear();
+          return;
+        }
+
+        result = coeffs[0] * (*X[0]);
+        vcl_size_t i = 1;
+        for (; i+1 < X.size(); i += 2)
+          result += coeffs[i] * (*X[i]) + coeffs[i+1] * (*X[i+1]);
+        if (i < X.size())
+          result += coeffs[i] * (*X[i]);
+      }
+
+      /** @brief Computes the Gram matrix V^T W (small, s_V x s_W) and copies it to the host. */
+      template <typename T>
+      void gram_matrix(viennacl::matrix_base<T> const & V, viennacl::matrix_base<T> const & W,
+                       viennacl::matrix<T, viennacl::column_major> & G_dev, std::vector< std::vector<T> > & G)
+      {
+        G_dev = viennacl::linalg::prod(viennacl::trans(V), W);
+        small_dense_resize(G, V.size2(), W.size2());
+        viennacl::copy(G_dev, G);
+      }
+
+
+      /** @brief Copies the small dense host matrix A to A_dev, reusing the memory of A_dev (which must have the size of A). */
+      template <typename T>
+      void small_dense_copy_to_device(std::vector< std::vector<T> > const & A, viennacl::matrix<T, viennacl::column_major> & A_dev)
+      {
+        std::vector<T> buffer(A_dev.internal_size());
+        for (vcl_size_t j=0; j<A_dev.size2(); ++j)
+          for (vcl_size_t i=0; i<A_dev.size1(); ++i)
+            buffer[viennacl::column_major::mem_index(i, j, A_dev.internal_size1(), A_dev.internal_size2())] = A[i][j];
+        viennacl::backend::memory_write(A_dev.handle(), 0, sizeof(T) * buffer.size(), &(buffer[0]));
+      }
+
+
+      /** @brief Default tolerance for the detection of linear dependence in block_orthonormalize() */
+      template <typename T>
+      T block_orthonormalize_tolerance(vcl_size_t s)
+      {
+        return T(100) * T(s) * std::numeric_limits<T>::epsilon();
+      }
+
+      /** @brief Orthonormalizes the columns of V in-place by two passes of Cholesky-QR, where the first pass uses diagonal pivoting to reveal the numerical rank.
+      *
+      * On return, the first 'rank' columns of V are orthonormal and span the same space as the linearly independent columns of the input.
+      * All other columns are set to zero. The orthogonalization cost is dominated by two Gram matrices and two tall-skinny matrix-matrix products, hence compute bound.
+      *
+      * @param V        The multi-vector to be orthonormalized (n x s)
+      * @param tmp      Work array of the same size as V
+      * @param work     Work array for the small s x s matrices. Resized if it does not match the number of columns of V, otherwise its memory is reused.
+      * @param rel_tol  Columns are considered linearly dependent if the remaining norm drops below sqrt(rel_tol) times the largest column norm
+      * @return The numerical rank of V
+      */
+      template <typename T>
+      vcl_size_t block_orthonormalize(viennacl::matrix_base<T> & V, viennacl::matrix_base<T> & tmp,
+                                      viennacl::matrix<T, viennacl::column_major> & work, T rel_tol)
+      {
+        vcl_size_t s = V.size2();
+        if (s == 0)
+          return 0;
+        if (work.size1() != s || work.size2() != s)
+          work.resize(s, s, false);
+        std::vector< std::vector<T> > G;
+        std::vector< std::vector<T> > W;
+        std::vector<vcl_size_t> perm;
+
+        //
+        // first pass: pivoted Cholesky-QR, V * P(:, 0:rank) * L^{-T}
+        //
+        gram_matrix(V, V, work, G);
+        vcl_size_t rank = small_dense_pivoted_cholesky(G, s, perm, rel_tol);
+        small_dense_invert_lower(G, rank);
+
+        small_dense_resize(W, s, s);
+        for (vcl_size_t i=0; i<rank; ++i)
+          for (vcl_size_t j=i; j<rank; ++j)
+            W[perm[i]][j] = G[j][i];
+        small_dense_copy_to_device(W, work);
+        tmp = viennacl::linalg::prod(V, work);
+
+        if (rank == 0)
+        {
+          V = tmp;
+          return 0;
+        }
+
+        //
+        // second pass: plain Cholesky-QR on the leading 'rank' columns for restoring orthogonality up to machine precision
+        //
+        gram_matrix(tmp, tmp, work, G);
+        small_dense_resize(W, s, s);
+        if (small_dense_cholesky(G, rank))
+        {
+          small_dense_invert_lower(G, rank);
+          for (vcl_size_t i=0; i<rank; ++i)
+            for (vcl_size_t j=i; j<rank; ++j)
+              W[i][j] = G[j][i];
+        }
+        else  //first pass is already good enough, keep it:
+        {
+          for (vcl_size_t i=0; i<rank; ++i)
+            W[i][i] = T(1);
+        }
+        small_dense_copy_to_device(W, work);
+        V = viennacl::linalg::prod(tmp, work);
+
+        return rank;
+      }
+
+      /** @brief Computes the QR factorization V = Q R of a tall and skinny matrix V by two passes of Cholesky-QR. V is overwritten by Q.
+      *
+      * Returns false if the columns of V are (numerically) linearly dependent, in which case V and R are left in an undefined state.
+      *
+      * @param V        The multi-vector to be factorized (n x s)
+      * @param tmp      Work array of the same size as V
+      * @param R        The upper triangular factor (s x s) on the host
+      */
+      template <typename T>
+      bool cholesky_qr2(viennacl::matrix_base<T> & V, viennacl::matrix_base<T> & tmp, std::vector< std::vector<T> > & R)
+      {
+        vcl_size_t s = V.size2();
+        viennacl::matrix<T, viennacl::column_major> G_dev(s, s, viennacl::traits::context(V));
+        viennacl::matrix<T, viennacl::column_major> W_dev(s, s, viennacl::traits::context(V));
+        std::vector< std::vector<T> > G;
+        std::vector< std::vector<T> > W;
+        small_dense_resize(R, s, s);
+        for (vcl_size_t i=0; i<s; ++i)
+          R[i][i] = T(1);
+
+        for (vcl_size_t pass = 0; pass < 2; ++pass)
+        {
+          viennacl::matrix_base<T> & src = (pass == 0) ? V : tmp;
+          viennacl::matrix_base<T> & dst = (pass == 0) ? tmp : V;
+
+          gram_matrix(src, src, G_dev, G);
+          std::vector<T> diag_G(s);
+          for (vcl_size_t i=0; i<s; ++i)
+            diag_G[i] = G[i][i];
+          if (!small_dense_cholesky(G, s))
+            return false;
+          for (vcl_size_t i=0; i<s; ++i)   //numerical linear dependence: remaining norm of a column is at round-off level
+            if (G[i][i] * G[i][i] <= block_orthonormalize_tolerance<T>(s) * diag_G[i])
+              return false;
+
+          // R = L^T R
+          std::vector< std::vector<T> > R_old = R;
+          for (vcl_size_t i=0; i<s; ++i)
+            for (vcl_size_t j=i; j<s; ++j)
+            {
+              T val = 0;
+              for (vcl_size_t k=i; k<=j; ++k)
+                val += G[k][i] * R_old[k][j];
+              R[i][j] = val;
+            }
+
+          // dst = src * L^{-T}
+          small_dense_invert_lower(G, s);
+          small_dense_resize(W, s, s);
+          for (vcl_size_t i=0; i<s; ++i)
+            for (vcl_size_t j=i; j<s; ++j)
+              W[i][j] = G[j][i];
+          viennacl::copy(W, W_dev);
+          dst = viennacl::linalg::prod(src, W_dev);
+        }
+
+        return true;
+      }
+
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,645 @@
+#ifndef VIENNACL_LINALG_DETAIL_SMALL_DENSE_HPP_
+#define VIENNACL_LINALG_DETAIL_SMALL_DENSE_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/detail/small_dense.hpp
+    @brief Kernels for small dense matrices on the host (Gram matrices, projected systems) as they show up in block Krylov methods.
+
+    Matrices are stored as std::vector< std::vector<T> > with A[i][j] denoting the entry in the i-th row and the j-th column.
+*/
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include "viennacl/forwards.h"
+
+namespace viennacl
+{
+  namespace linalg
+  {
+    namespace detail
+    {
+
+      /** @brief Sets up a zero matrix of size rows x cols */
+      template <typename T>
+      void small_dense_resize(std::vector< std::vector<T> > & A, vcl_size_t rows, vcl_size_t cols)
+      {
+        A.resize(rows);
+        for (vcl_size_t i=0; i<rows; ++i)
+          A[i].assign(cols, T(0));
+      }
+
+      /** @brief Computes the Cholesky factor L of a symmetric positive definite matrix in-place (lower triangular part). Returns false if A is not positive definite.
+      *
+      * Only the first 'n' rows and columns are considered. The strictly upper triangular part is set to zero.
+      */
+      template <typename T>
+      bool small_dense_cholesky(std::vector< std::vector<T> > & A, vcl_size_t n)
+      {
+        for (vcl_size_t j=0; j<n; ++j)
+        {
+          T d = A[j][j];
+          for (vcl_size_t k=0; k<j; ++k)
+            d -= A[j][k] * A[j][k];
+          if (d <= 0)
+            return false;
+          d = std::sqrt(d);
+          A[j][j] = d;
+
+          for (vcl_size_t i=j+1; i<n; ++i)
+          {
+            T s = A[i][j];
+            for (vcl_size_t k=0; k<j; ++k)
+              s -= A[i][k] * A[j][k];
+            A[i][j] = s / d;
+            A[j][i] = 0;
+          }
+        }
+        return true;
+      }
+
+      /** @brief Rank-revealing Cholesky factorization with diagonal pivoting of a symmetric positive semi-definite matrix G (s x s).
+      *
+      * Computes P^T G P = L L^T, where L is s x rank lower trapezoidal. Pivoting stops as soon as the largest remaining diagonal entry
+      * drops below rel_tol times the largest initial diagonal entry.
+      *
+      * @param G        The symmetric positive semi-definite input matrix, overwritten with L in its lower part
+      * @param s        Size of G
+      * @param perm     On return, perm[i] holds the original index of the i-th pivot
+      * @param rel_tol  Relative tolerance for the detection of (numerical) rank deficiency
+      * @return The numerical rank
+      */
+      template <typename T>
+      vcl_size_t small_dense_pivoted_cholesky(std::vector< std::vector<T> > & G, vcl_size_t s, std::vector<vcl_size_t> & perm, T rel_tol)
+      {
+        perm.resize(s);
+        for (vcl_size_t i=0; i<s; ++i)
+          perm[i] = i;
+
+        T max_diag = 0;
+        for (vcl_size_t i=0; i<s; ++i)
+          max_diag = std::max(max_diag, G[i][i]);
+
+        if (max_diag <= 0)
+          return 0;
+
+        vcl_size_t rank = 0;
+        for (vcl_size_t j=0; j<s; ++j)
+        {
+          // find pivot:
+          vcl_size_t pivot = j;
+          for (vcl_size_t i=j+1; i<s; ++i)
+            if (G[i][i] > G[pivot][pivot])
+              pivot = i;
+
+          if (G[pivot][pivot] <= rel_tol * max_diag)
+            break;
+
+          // symmetric swap of rows and columns j and pivot:
+          if (pivot != j)
+          {
+            std::swap(G[j], G[pivot]);
+            for (vcl_size_t i=0; i<s; ++i)
+              std::swap(G[i][j], G[i][pivot]);
+            std::swap(perm[j], perm[pivot]);
+          }
+
+          T d = std::sqrt(G[j][j]);
+          G[j][j] = d;
+          for (vcl_size_t i=j+1; i<s; ++i)
+            G[i][j] /= d;
+
+          // update trailing submatrix (lower part is sufficient, the diagonal entries are used for pivoting):
+          for (vcl_size_t k=j+1; k<s; ++k)
+            for (vcl_size_t i=k; i<s; ++i)
+            {
+              G[i][k] -= G[i][j] * G[k][j];
+              G[k][i] = G[i][k];
+            }
+
+          ++rank;
+        }
+
+        return rank;
+      }
+
+      /** @brief Inverts a nonsingular lower triangular matrix of size n x n in-place. */
+      template <typename T>
+      void small_dense_invert_lower(std::vector< std::vector<T> > & L, vcl_size_t n)
+      {
+        for (vcl_size_t j=0; j<n; ++j)
+        {
+          L[j][j] = T(1) / L[j][j];
+          for (vcl_size_t i=j+1; i<n; ++i)
+          {
+            T s = 0;
+            for (vcl_size_t k=j; k<i; ++k)
+              s -= L[i][k] * L[k][j];
+            L[i][j] = s / L[i][i];
+          }
+        }
+      }
+
+      /** @brief Solves A X = B for a general square matrix A of size n x n with Gaussian elimination and partial pivoting.
+      *
+      * A is overwritten by its LU factors, B (n x m) is overwritten by the solution. Returns false if A is (numerically) singular.
+      */
+      template <typename T>
+      bool small_dense_solve(std::vector< std::vector<T> > & A, std::vector< std::vector<T> > & B, vcl_size_t n, vcl_size_t m)
+      {
+        for (vcl_size_t j=0; j<n; ++j)
+        {
+          vcl_size_t pivot = j;
+          for (vcl_size_t i=j+1; i<n; ++i)
+            if (std::fabs(A[i][j]) > std::fabs(A[pivot][j]))
+              pivot = i;
+
+          if (A[pivot][j] == 0)
+            return false;
+
+          std::swap(A[j], A[pivot]);
+          std::swap(B[j], B[pivot]);
+
+          for (vcl_size_t i=j+1; i<n; ++i)
+          {
+            T factor = A[i][j] / A[j][j];
+            for (vcl_size_t k=j; k<n; ++k)
+              A[i][k] -= factor * A[j][k];
+            for (vcl_size_t k=0; k<m; ++k)
+              B[i][k] -= factor * B[j][k];
+          }
+        }
+
+        for (vcl_size_t j=n; j-- > 0; )
+        {
+          for (vcl_size_t k=0; k<m; ++k)
+          {
+            T s = B[j][k];
+            for (vcl_size_t i=j+1; i<n; ++i)
+              s -= A[j][i] * B[i][k];
+            B[j][k] = s / A[j][j];
+          }
+        }
+        return true;
+      }
+
+
+      /** @brief Computes all eigenvalues of a real upper Hessenberg matrix H (n x n) by the Francis double-shift QR algorithm.
+      *
+      * Derived from the Algol procedure hqr by Martin, Peters and Wilkinson, Handbook for Auto. Comp., Vol.ii-Linear Algebra.
+      * Complex conjugate pairs are returned in consecutive entries, the one with positive imaginary part first.
+      *
+      * @param H    The Hessenberg matrix, destroyed on exit
+      * @param n    Size of H
+      * @param wr   Real parts of the eigenvalues
+      * @param wi   Imaginary parts of the eigenvalues
+      * @return false if the QR algorithm did not converge
+      */
+      template <typename T>
+      bool small_dense_hessenberg_eigenvalues(std::vector< std::vector<T> > & H, vcl_size_t n, std::vector<T> & wr, std::vector<T> & wi)
+      {
+        // use one-based indexing as in the original algorithm:
+        std::vector< std::vector<T> > a(n+1, std::vector<T>(n+1));
+        for (vcl_size_t i=0; i<n; ++i)
+          for (vcl_size_t j=0; j<n; ++j)
+            a[i+1][j+1] = H[i][j];
+        std::vector<T> re(n+1), im(n+1);
+
+        long nn = static_cast<long>(n);
+        long l = 0, m = 0;
+        T p = 0, q = 0, r = 0, s = 0, t = 0, w = 0, x = 0, y = 0, z = 0;
+
+        T anorm = 0;
+        for (long i=1; i<=nn; ++i)
+          for (long j=std::max(i-1, 1L); j<=nn; ++j)
+            anorm += std::fabs(a[i][j]);
+
+        while (nn >= 1)
+        {
+          long its = 0;
+          do
+          {
+            for (l=nn; l>=2; --l)  // look for small subdiagonal element
+            {
+              s = std::fabs(a[l-1][l-1]) + std::fabs(a[l][l]);
+              if (s == 0)
+                s = anorm;
+              if (std::fabs(a[l][l-1]) + s == s)
+              {
+                a[l][l-1] = 0;
+                break;
+              }
+            }
+            x = a[nn][nn];
+            if (l == nn)  // one root found
+            {
+              re[nn] = x + t;
+              im[nn--] = 0;
+            }
+            else
+            {
+              y = a[nn-1][nn-1];
+              w = a[nn][nn-1] * a[nn-1][nn];
+              if (l == nn-1)  // two roots found
+              {
+                p = T(0.5) * (y - x);
+                q = p * p + w;
+                z = std::sqrt(std::fabs(q));
+                x += t;
+                if (q >= 0)  // real pair
+                {
+                  z = p + (p >= 0 ? std::fabs(z) : -std::fabs(z));
+                  re[nn-1] = re[nn] = x + z;
+                  if (z != 0)
+                    re[nn] = x - w / z;
+                  im[nn-1] = im[nn] = 0;
+                }
+                else  // complex pair
+                {
+                  re[nn-1] = re[nn] = x + p;
+                  im[nn-1] = z;
+                  im[nn] = -z;
+                }
+                nn -= 2;
+              }
+              else  // no roots found yet, continue iteration
+              {
+                if (its == 30)
+                  return false;
+                if (its == 10 || its == 20)  // exceptional shift
+                {
+                  t += x;
+                  for (long i=1; i<=nn; ++i)
+                    a[i][i] -= x;
+                  s = std::fabs(a[nn][nn-1]) + std::fabs(a[nn-1][nn-2]);
+                  y = x = T(0.75) * s;
+                  w = T(-0.4375) * s * s;
+                }
+                ++its;
+                for (m=nn-2; m>=l; --m)  // look for two consecutive small subdiagonal elements
+                {
+                  z = a[m][m];
+                  r = x - z;
+                  s = y - z;
+                  p = (r * s - w) / a[m+1][m] + a[m][m+1];
+                  q = a[m+1][m+1] - z - r - s;
+                  r = a[m+2][m+1];
+                  s = std::fabs(p) + std::fabs(q) + std::fabs(r);
+                  p /= s;
+                  q /= s;
+                  r /= s;
+                  if (m == l)
+                    break;
+                  T u = std::fabs(a[m][m-1]) * (std::fabs(q) + std::fabs(r));
+                  T v = std::fabs(p) * (std::fabs(a[m-1][m-1]) + std::fabs(z) + std::fabs(a[m+1][m+1]));
+                  if (u + v == v)
+                    break;
+                }
+                for (long i=m+2; i<=nn; ++i)
+                {
+                  a[i][i-2] = 0;
+                  if (i != m+2)
+                    a[i][i-3] = 0;
+                }
+                for (long k=m; k<=nn-1; ++k)  // double QR step on rows l to nn and columns m to nn
+                {
+                  if (k != m)
+                  {
+                    p = a[k][k-1];
+                    q = a[k+1][k-1];
+                    r = 0;
+                    if (k != nn-1)
+                      r = a[k+2][k-1];
+                    x = std::fabs(p) + std::fabs(q) + std::fabs(r);
+                    if (x != 0)
+                    {
+                      p /= x;
+                      q /= x;
+                      r /= x;
+                    }
+                  }
+                  s = std::sqrt(p * p + q * q + r * r);
+                  if (p < 0)
+                    s = -s;
+                  if (s != 0)
+                  {
+                    if (k == m)
+                    {
+                      if (l != m)
+                        a[k][k-1] = -a[k][k-1];
+                    }
+                    else
+                      a[k][k-1] = -s * x;
+                    p += s;
+                    x = p / s;
+                    y = q / s;
+                    z = r / s;
+                    q /= p;
+                    r /= p;
+                    for (long j=k; j<=nn; ++j)  // row modification
+                    {
+                      p = a[k][j] + q * a[k+1][j];
+                      if (k != nn-1)
+                      {
+                        p += r * a[k+2][j];
+                        a[k+2][j] -= p * z;
+                      }
+                      a[k+1][j] -= p * y;
+                      a[k][j] -= p * x;
+                    }
+                    long mmin = (nn < k+3) ? nn : k+3;
+                    for (long i=l; i<=mmin; ++i)  // column modification
+                    {
+                      p = x * a[i][k] + y * a[i][k+1];
+                      if (k != nn-1)
+                      {
+                        p += z * a[i][k+2];
+                        a[i][k+2] -= p * r;
+                      }
+                      a[i][k+1] -= p * q;
+                      a[i][k] -= p;
+                    }
+                  }
+                }
+              }
+            }
+          } while (l < nn-1);
+        }
+
+        wr.resize(n);
+        wi.resize(n);
+        for (vcl_size_t i=0; i<n; ++i)
+        {
+          wr[i] = re[i+1];
+          wi[i] = im[i+1];
+        }
+        return true;
+      }
+
+      /** @brief Reorders the (possibly complex) values (wr, wi) in modified Leja order, keeping complex conjugate pairs adjacent.
+      *
+      * The first value is the one with largest modulus, each further value maximizes the product of distances to all values already chosen.
+      * This is the customary ordering of shifts for Newton polynomial bases.
+      */
+      template <typename T>
+      void small_dense_leja_order(std::vector<T> & wr, std::vector<T> & wi)
+      {
+        vcl_size_t n = wr.size();
+        std::vector<bool> used(n, false);
+        std::vector<T> new_wr, new_wi;
+        std::vector<T> log_prod(n, T(0));  //sum of logarithms of the distances to the chosen values (avoids overflow)
+
+        while (new_wr.size() < n)
+        {
+          vcl_size_t best = n;
+          for (vcl_size_t i=0; i<n; ++i)
+          {
+            if (used[i] || wi[i] < 0)  //conjugate with negative imaginary part follows its partner
+              continue;
+            T value = new_wr.size() == 0 ? std::sqrt(wr[i] * wr[i] + wi[i] * wi[i]) : log_prod[i];
+            T best_value = (best == n) ? T(0) : (new_wr.size() == 0 ? std::sqrt(wr[best] * wr[best] + wi[best] * wi[best]) : log_prod[best]);
+            if (best == n || value > best_value)
+              best = i;
+          }
+          if (best == n)  //only unpaired conjugates left
+          {
+            for (vcl_size_t i=0; i<n; ++i)
+              if (!used[i]) { new_wr.push_back(wr[i]); new_wi.push_back(wi[i]); used[i] = true; }
+            break;
+          }
+
+          vcl_size_t num_new = (wi[best] > 0 && best + 1 < n) ? 2 : 1;
+          for (vcl_size_t k=0; k<num_new; ++k)
+          {
+            vcl_size_t idx = best + k;
+            used[idx] = true;
+            new_wr.push_back(wr[idx]);
+            new_wi.push_back(wi[idx]);
+            for (vcl_size_t i=0; i<n; ++i)
+            {
+              T dr = wr[i] - wr[idx];
+              T di = wi[i] - wi[idx];
+              T dist = std::sqrt(dr * dr + di * di);
+              log_prod[i] += (dist > 0) ? std::log(dist) : -std::numeric_limits<T>::max() / T(n + 1);
+            }
+          }
+        }
+
+        wr = new_wr;
+        wi = new_wi;
+      }
+
+      /** @brief Computes all eigenvalues and eigenvectors of a symmetric matrix A (n x n) by the cyclic Jacobi method.
+      *
+      * The eigenvalues are returned in ascending order, the i-th column of V holds the eigenvector for the i-th eigenvalue.
+      * A is destroyed on exit.
+      */
+      template <typename T>
+      void small_dense_symmetric_eigen(std::vector< std::vector<T> > & A, vcl_size_t n, std::vector<T> & eigenvalues, std::vector< std::vector<T> > & V)
+      {
+        small_dense_resize(V, n, n);
+        for (vcl_size_t i=0; i<n; ++i)
+          V[i][i] = T(1);
+
+        for (vcl_size_t sweep=0; sweep<50; ++sweep)
+        {
+          T off = 0, diag = 0;
+          for (vcl_size_t i=0; i<n; ++i)
+          {
+            diag += A[i][i] * A[i][i];
+            for (vcl_size_t j=i+1; j<n; ++j)
+              off += A[i][j] * A[i][j];
+          }
+          if (off <= std::numeric_limits<T>::epsilon() * std::numeric_limits<T>::epsilon() * diag)
+            break;
+
+          for (vcl_size_t p=0; p<n; ++p)
+            for (vcl_size_t q=p+1; q<n; ++q)
+            {
+              if (A[p][q] == 0)
+                continue;
+
+              // rotation annihilating A[p][q]:
+              T theta = (A[q][q] - A[p][p]) / (T(2) * A[p][q]);
+              T t = T(1) / (std::fabs(theta) + std::sqrt(theta * theta + T(1)));
+              if (theta < 0)
+                t = -t;
+              T c = T(1) / std::sqrt(t * t + T(1));
+              T sn = t * c;
+
+              for (vcl_size_t k=0; k<n; ++k)
+              {
+                T a_kp = A[k][p];
+                T a_kq = A[k][q];
+                A[k][p] = c * a_kp - sn * a_kq;
+                A[k][q] = sn * a_kp + c * a_kq;
+              }
+              for (vcl_size_t k=0; k<n; ++k)
+              {
+                T a_pk = A[p][k];
+                T a_qk = A[q][k];
+                A[p][k] = c * a_pk - sn * a_qk;
+                A[q][k] = sn * a_pk + c * a_qk;
+              }
+              for (vcl_size_t k=0; k<n; ++k)
+              {
+                T v_kp = V[k][p];
+                T v_kq = V[k][q];
+                V[k][p] = c * v_kp - sn * v_kq;
+                V[k][q] = sn * v_kp + c * v_kq;
+              }
+            }
+        }
+
+        // sort in ascending order (selection sort, n is small):
+        eigenvalues.resize(n);
+        for (vcl_size_t i=0; i<n; ++i)
+          eigenvalues[i] = A[i][i];
+        for (vcl_size_t i=0; i<n; ++i)
+        {
+          vcl_size_t min_index = i;
+          for (vcl_size_t j=i+1; j<n; ++j)
+            if (eigenvalues[j] < eigenvalues[min_index])
+              min_index = j;
+          if (min_index != i)
+          {
+            std::swap(eigenvalues[i], eigenvalues[min_index]);
+            for (vcl_size_t k=0; k<n; ++k)
+              std::swap(V[k][i], V[k][min_index]);
+          }
+        }
+      }
+
+      /** @brief Computes the thin QR factorization A = Q R of a matrix A (rows x cols, rows >= cols) by modified Gram-Schmidt with reorthogonalization.
+      *
+      * Returns false if the columns of A are (numerically) linearly dependent.
+      */
+      template <typename T>
+      bool small_dense_thin_qr(std::vector< std::vector<T> > const & A, vcl_size_t rows, vcl_size_t cols,
+                               std::vector< std::vector<T> > & Q, std::vector< std::vector<T> > & R)
+      {
+        small_dense_resize(Q, rows, cols);
+        small_dense_resize(R, cols, cols);
+        for (vcl_size_t i=0; i<rows; ++i)
+          for (vcl_size_t j=0; j<cols; ++j)
+            Q[i][j] = A[i][j];
+
+        for (vcl_size_t j=0; j<cols; ++j)
+        {
+          T norm_initial = 0;
+          for (vcl_size_t i=0; i<rows; ++i)
+            norm_initial += Q[i][j] * Q[i][j];
+          norm_initial = std::sqrt(norm_initial);
+
+          for (vcl_size_t pass=0; pass<2; ++pass)
+            for (vcl_size_t k=0; k<j; ++k)
+            {
+              T dot = 0;
+              for (vcl_size_t i=0; i<rows; ++i)
+                dot += Q[i][k] * Q[i][j];
+              for (vcl_size_t i=0; i<rows; ++i)
+                Q[i][j] -= dot * Q[i][k];
+              R[k][j] += dot;
+            }
+
+          T norm = 0;
+          for (vcl_size_t i=0; i<rows; ++i)
+            norm += Q[i][j] * Q[i][j];
+          norm = std::sqrt(norm);
+          if (norm <= T(100) * std::numeric_limits<T>::epsilon() * norm_initial || norm == 0)
+            return false;
+
+          R[j][j] = norm;
+          for (vcl_size_t i=0; i<rows; ++i)
+            Q[i][j] /= norm;
+        }
+        return true;
+      }
+
+      /** @brief Computes an orthonormal basis Q (n x k) of the dominant invariant subspace of a general matrix K (n x n) by orthogonal iteration.
+      *
+      * The subspace belongs to the k eigenvalues of largest modulus. Complex conjugate pairs are handled in real arithmetic, as only a basis
+      * and not the eigenvectors are computed. If the k-th and the (k+1)-th eigenvalue are of similar modulus, the iteration converges slowly
+      * and is stopped after 'max_iterations' steps.
+      */
+      template <typename T>
+      void small_dense_dominant_subspace(std::vector< std::vector<T> > const & K, vcl_size_t n, vcl_size_t k,
+                                         std::vector< std::vector<T> > & Q, vcl_size_t max_iterations = 500)
+      {
+        std::vector< std::vector<T> > Z, Q_new, R;
+        small_dense_resize(Z, n, k);
+
+        // deterministic start basis with generic entries (unlikely to be deficient in the dominant subspace):
+        for (vcl_size_t j=0; j<k; ++j)
+          for (vcl_size_t i=0; i<n; ++i)
+            Z[i][j] = T(1) / T(1 + (i + 3*j) % (n + 1));
+        if (!small_dense_thin_qr(Z, n, k, Q, R))
+        {
+          small_dense_resize(Q, n, k);
+          for (vcl_size_t j=0; j<k; ++j)
+            Q[j][j] = T(1);
+        }
+
+        T norm_K = 0;
+        for (vcl_size_t i=0; i<n; ++i)
+          for (vcl_size_t j=0; j<n; ++j)
+            norm_K += K[i][j] * K[i][j];
+        norm_K = std::sqrt(norm_K);
+
+        for (vcl_size_t iter=0; iter<max_iterations; ++iter)
+        {
+          for (vcl_size_t i=0; i<n; ++i)
+            for (vcl_size_t j=0; j<k; ++j)
+            {
+              T s = 0;
+              for (vcl_size_t l=0; l<n; ++l)
+                s += K[i][l] * Q[l][j];
+              Z[i][j] = s;
+            }
+
+          // residual of the invariant subspace: || Z - Q (Q^T Z) ||_F
+          T res = 0;
+          for (vcl_size_t j=0; j<k; ++j)
+          {
+            std::vector<T> proj(k, T(0));
+            for (vcl_size_t l=0; l<k; ++l)
+              for (vcl_size_t i=0; i<n; ++i)
+                proj[l] += Q[i][l] * Z[i][j];
+            for (vcl_size_t i=0; i<n; ++i)
+            {
+              T r = Z[i][j];
+              for (vcl_size_t l=0; l<k; ++l)
+                r -= Q[i][l] * proj[l];
+              res += r * r;
+            }
+          }
+          if (std::sqrt(res) <= T(1e4) * std::numeric_limits<T>::epsilon() * norm_K)
+            break;
+
+          if (!small_dense_thin_qr(Z, n, k, Q_new, R))  //K is (numerically) singular on the current subspace, keep the last basis
+            break;
+          Q.swap(Q_new);
+        }
+      }
+    }
+  }
+}
+
+#endif
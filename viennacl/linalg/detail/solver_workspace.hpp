@@ -0,0 +1,77 @@
+#ifndef VIENNACL_LINALG_DETAIL_SOLVER_WORKSPACE_HPP_
+#define VIENNACL_LINALG_DETAIL_SOLVER_WORKSPACE_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/detail/solver_workspace.hpp
+    @brief Common storage facility for the temporary vectors of the iterative solvers.
+*/
+
+#include <vector>
+#include "viennacl/forwards.h"
+#include "viennacl/traits/size.hpp"
+
+namespace viennacl
+{
+  namespace linalg
+  {
+    namespace detail
+    {
+
+      /** @brief Holds a fixed number of work vectors of the same size, which are only reallocated if the problem size changes.
+      *
+      * The work vectors are created as copies of a prototype vector (usually the right hand side), so they reside in the same memory domain.
+      * Content of the work vectors is undefined after prepare() and must be initialized by the solver.
+      */
+      template <typename VectorType>
+      class solver_workspace_base
+      {
+        public:
+          solver_workspace_base() : allocations_(0) {}
+
+          /** @brief Returns the number of times the work vectors had to be (re-)allocated. Useful for checking that buffers are indeed reused. */
+          vcl_size_t allocations() const { return allocations_; }
+
+          /** @brief Returns the size of the work vectors (zero if not allocated yet) */
+          vcl_size_t size() const { return vectors_.size() > 0 ? viennacl::traits::size(vectors_[0]) : 0; }
+
+        protected:
+          /** @brief Makes sure that 'num_vectors' work vectors with the size of 'prototype' are available. Reallocates only if dimensions changed. */
+          void prepare(VectorType const & prototype, vcl_size_t num_vectors)
+          {
+            if (vectors_.size() != num_vectors || size() != viennacl::traits::size(prototype))
+            {
+              vectors_.clear();
+              vectors_.resize(num_vectors, prototype);
+              ++allocations_;
+            }
+          }
+
+          VectorType       & vec(vcl_size_t i)       { return vectors_[i]; }
+          VectorType const & vec(vcl_size_t i) const { return vectors_[i]; }
+
+        private:
+          std::vector<VectorType> vectors_;
+          vcl_size_t allocations_;
+      };
+
+    }
+  }
+}
+
+#endif
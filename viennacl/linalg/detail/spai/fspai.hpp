@@ -117,13 +117,18 @@ namespace viennacl
 
 
           //
-          // Helper: Store A in an STL container of type, exploiting symmetry
+          // Helper: Store A in compressed row format, so that the nonzeros of a particular row can be accessed directly.
           // Reason: ublas interface does not allow to iterate over nonzeros of a particular row without starting an iterator1 from the very beginning of the matrix...
           //
           template <typename MatrixType, typename ScalarType>
-          void sym_sparse_matrix_to_stl(MatrixType const & A, std::vector<std::map<unsigned int, ScalarType> > & STL_A)
+          void sparse_matrix_to_csr(MatrixType const & A,
+                                    std::vector<vcl_size_t> & row_start,
+                                    std::vector<vcl_size_t> & col_indices,
+                                    std::vector<ScalarType> & elements)
           {
-            STL_A.resize(A.size1());
+            row_start.assign(A.size1() + 1, 0);
+            col_indices.clear();
+            elements.clear();
             for (typename MatrixType::const_iterator1 row_it  = A.begin1();
                                                       row_it != A.end1();
                                                     ++row_it)
@@ -132,12 +137,28 @@ namespace viennacl
                                                         col_it != row_it.end();
                                                       ++col_it)
               {
-                if (col_it.index1() >= col_it.index2())
-                  STL_A[col_it.index1()][static_cast<unsigned int>(col_it.index2())] = *col_it;
-                else
-                  break; //go to next row
+                col_indices.push_back(col_it.index2());
+                elements.push_back(*col_it);
               }
+              row_start[row_it.index1() + 1] = col_indices.size();
             }
+            for (vcl_size_t i=0; i<A.size1(); ++i)  //fill gaps from empty rows
+              row_start[i+1] = std::max(row_start[i+1], row_start[i]);
+          }
+
+          //
+          // Returns A(i,j) from the compressed row format (column indices are sorted within each row)
+          //
+          template <typename ScalarType>
+          ScalarType csr_entry(std::vector<vcl_size_t> const & row_start,
+                               std::vector<vcl_size_t> const & col_indices,
+                               std::vector<ScalarType> const & elements,
+                               vcl_size_t i, vcl_size_t j)
+          {
+            std::vector<vcl_size_t>::const_iterator row_begin = col_indices.begin() + static_cast<long>(row_start[i]);
+            std::vector<vcl_size_t>::const_iterator row_end   = col_indices.begin() + static_cast<long>(row_start[i+1]);
+            std::vector<vcl_size_t>::const_iterator it = std::lower_bound(row_begin, row_end, j);
+            return (it != row_end && *it == j) ? elements[static_cast<vcl_size_t>(it - col_indices.begin())] : ScalarType(0);
           }
 
 
@@ -168,92 +189,47 @@ namespace viennacl
 
 
           //
-          // Extracts the blocks A(\tilde{J}_k, \tilde{J}_k) from A
-          // Sets up y_k = A(\tilde{J}_k, k) for the inplace-solution after Cholesky-factoriation
+          // Perform Cholesky factorization of the row-major n x n matrix A inplace. Only the lower triangular part is referenced. Cf. Schwarz: Numerische Mathematik, vol 5, p. 58
           //
-          template <typename ScalarType, typename MatrixType, typename VectorType>
-          void fill_blocks(std::vector< std::map<unsigned int, ScalarType> > & A,
-                          std::vector<MatrixType> & blocks,
-                          std::vector<std::vector<vcl_size_t> > const & J,
-                          std::vector<VectorType> & Y)
+          template <typename ScalarType>
+          void cholesky_decompose(ScalarType * A, vcl_size_t n)
           {
-            for (vcl_size_t k=0; k<A.size(); ++k)
+            for (vcl_size_t k=0; k<n; ++k)
             {
-              std::vector<vcl_size_t> const & Jk = J[k];
-              VectorType & yk = Y[k];
-              MatrixType & block_k = blocks[k];
+              assert(A[k*n+k] > 0);
 
-              yk.resize(Jk.size());
-              block_k.resize(Jk.size(), Jk.size());
-              block_k.clear();
+              A[k*n+k] = std::sqrt(A[k*n+k]);
 
-              for (vcl_size_t i=0; i<Jk.size(); ++i)
+              for (vcl_size_t i=k+1; i<n; ++i)
               {
-                vcl_size_t row_index = Jk[i];
-                std::map<unsigned int, ScalarType> & A_row = A[row_index];
-
-                //fill y_k:
-                yk[i] = A_row[static_cast<unsigned int>(k)];
-
-                for (vcl_size_t j=0; j<Jk.size(); ++j)
-                {
-                  vcl_size_t col_index = Jk[j];
-                  if (col_index <= row_index && A_row.find(static_cast<unsigned int>(col_index)) != A_row.end()) //block is symmetric, thus store only lower triangular part
-                    block_k(i, j) = A_row[static_cast<unsigned int>(col_index)];
-                }
-              }
-            }
-          }
-
-
-          //
-          // Perform Cholesky factorization of A inplace. Cf. Schwarz: Numerische Mathematik, vol 5, p. 58
-          //
-          template <typename MatrixType>
-          void cholesky_decompose(MatrixType & A)
-          {
-            for (vcl_size_t k=0; k<A.size2(); ++k)
-            {
-              if (A(k,k) <= 0)
-              {
-                std::cout << "k: " << k << std::endl;
-                std::cout << "A(k,k): " << A(k,k) << std::endl;
-              }
-
-              assert(A(k,k) > 0);
-
-              A(k,k) = std::sqrt(A(k,k));
-
-              for (vcl_size_t i=k+1; i<A.size1(); ++i)
-              {
-                A(i,k) /= A(k,k);
+                A[i*n+k] /= A[k*n+k];
                 for (vcl_size_t j=k+1; j<=i; ++j)
-                  A(i,j) -= A(i,k) * A(j,k);
+                  A[i*n+j] -= A[i*n+k] * A[j*n+k];
               }
             }
           }
 
 
           //
-          // Compute x in Ax = b, where A is already Cholesky factored (A = L L^T)
+          // Compute x in Ax = b, where the row-major n x n matrix A is already Cholesky factored (A = L L^T)
           //
-          template <typename MatrixType, typename VectorType>
-          void cholesky_solve(MatrixType const & L, VectorType & b)
+          template <typename ScalarType>
+          void cholesky_solve(ScalarType const * L, vcl_size_t n, ScalarType * b)
           {
             // inplace forward solve L x = b
-            for (vcl_size_t i=0; i<L.size1(); ++i)
+            for (vcl_size_t i=0; i<n; ++i)
             {
               for (vcl_size_t j=0; j<i; ++j)
-                b[i] -= L(i,j) * b[j];
-              b[i] /= L(i,i);
+                b[i] -= L[i*n+j] * b[j];
+              b[i] /= L[i*n+i];
             }
 
             // inplace backward solve L^T x = b:
-            for (vcl_size_t i=L.size1()-1; ; --i)
+            for (vcl_size_t i=n-1; ; --i)
             {
-              for (vcl_size_t k=i+1; k<L.size1(); ++k)
-                b[i] -= L(k,i) * b[k];
-              b[i] /= L(i,i);
+              for (vcl_size_t k=i+1; k<n; ++k)
+                b[i] -= L[k*n+i] * b[k];
+              b[i] /= L[i*n+i];
 
               if (i==0) //vcl_size_t might be unsigned, therefore manual check for equality with zero here
                 break;
@@ -261,54 +237,6 @@ namespace viennacl
           }
 
 
-
-          //
-          // Compute the Cholesky factor L from the sparse vectors y_k
-          //
-          template <typename MatrixType, typename VectorType1>
-          void computeL(MatrixType const & A,
-                        MatrixType & L,
-                        MatrixType & L_trans,
-                        std::vector<VectorType1> & Y,
-                        std::vector<std::vector<vcl_size_t> > & J)
-          {
-            typedef typename VectorType1::value_type    ScalarType;
-            typedef std::vector<std::map<unsigned int, ScalarType> >     STLSparseMatrixType;
-
-            STLSparseMatrixType L_temp(A.size1());
-
-            for (vcl_size_t k=0; k<A.size1(); ++k)
-            {
-              std::vector<vcl_size_t> const & Jk = J[k];
-              VectorType1 const & yk = Y[k];
-
-              //compute L(k,k):
-              ScalarType Lkk = A(k,k);
-              for (vcl_size_t i=0; i<Jk.size(); ++i)
-                Lkk -= A(Jk[i],k) * yk[i];
-
-              Lkk = ScalarType(1) / std::sqrt(Lkk);
-              L_temp[k][static_cast<unsigned int>(k)] = Lkk;
-              L_trans(k,k) = Lkk;
-
-              //write lower diagonal entries:
-              for (vcl_size_t i=0; i<Jk.size(); ++i)
-              {
-                L_temp[Jk[i]][static_cast<unsigned int>(k)] = -Lkk * yk[i];
-                L_trans(k, Jk[i]) = -Lkk * yk[i];
-              }
-            } //for k
-
-
-            //build L from L_temp
-            for (vcl_size_t i=0; i<L_temp.size(); ++i)
-              for (typename std::map<unsigned int, ScalarType>::const_iterator it = L_temp[i].begin();
-                  it != L_temp[i].end();
-                ++it)
-                  L(i, it->first) = it->second;
-          }
-
-
           //
           // Top level FSPAI function
           //
@@ -320,79 +248,130 @@ namespace viennacl
                             fspai_tag)
           {
             typedef typename MatrixType::value_type              ScalarType;
-            typedef boost::numeric::ublas::matrix<ScalarType>    DenseMatrixType;
-            typedef std::vector<std::map<unsigned int, ScalarType> >     SparseMatrixType;
 
             //
-            // preprocessing: Store A in a STL container:
+            // preprocessing: Store A in compressed row format:
             //
-            //std::cout << "Transferring to STL container:" << std::endl;
-            std::vector<std::vector<ScalarType> >    y_k(A.size1());
-            SparseMatrixType   STL_A(A.size1());
-            sym_sparse_matrix_to_stl(A, STL_A);
-
+            std::vector<vcl_size_t> A_row_start;
+            std::vector<vcl_size_t> A_col_indices;
+            std::vector<ScalarType> A_elements;
+            sparse_matrix_to_csr(A, A_row_start, A_col_indices, A_elements);
 
             //
-            // Step 1: Generate pattern indices
+            // Step 1: Generate pattern indices (sorted, since rows are traversed in ascending order)
             //
-            //std::cout << "computeFSPAI(): Generating pattern..." << std::endl;
             std::vector<std::vector<vcl_size_t> > J(A.size1());
             generateJ(PatternA, J);
 
             //
-            // Step 2: Set up matrix blocks
-            //
-            //std::cout << "computeFSPAI(): Setting up matrix blocks..." << std::endl;
-            std::vector<DenseMatrixType>  subblocks_A(A.size1());
-            fill_blocks(STL_A, subblocks_A, J, y_k);
-            STL_A.clear(); //not needed anymore
-
-            //
-            // Step 3: Cholesky-factor blocks
+            // Step 2: For each k, set up the block A(\tilde{J}_k, \tilde{J}_k) and y_k = A(\tilde{J}_k, k), Cholesky-factor the block and solve for y_k.
+            //         The blocks are independent, thus the rows of L^T are computed in parallel with thread-local buffers.
             //
-            //std::cout << "computeFSPAI(): Cholesky-factorization..." << std::endl;
-            for (vcl_size_t i=0; i<subblocks_A.size(); ++i)
+            std::vector<std::vector<ScalarType> > y_k(A.size1());
+            std::vector<ScalarType>               L_diag(A.size1());
+#ifdef VIENNACL_WITH_OPENMP
+            #pragma omp parallel
+#endif
             {
-              //std::cout << "Block before: " << subblocks_A[i] << std::endl;
-              cholesky_decompose(subblocks_A[i]);
-              //std::cout << "Block after: " << subblocks_A[i] << std::endl;
-            }
+              std::vector<long>       position(A.size1(), -1);   //position of a row index in J_k, -1 if not in J_k
+              std::vector<ScalarType> block;
 
+#ifdef VIENNACL_WITH_OPENMP
+              #pragma omp for schedule(dynamic, 64)
+#endif
+              for (long k2=0; k2<static_cast<long>(A.size1()); ++k2)
+              {
+                vcl_size_t k = static_cast<vcl_size_t>(k2);
+                std::vector<vcl_size_t> const & Jk = J[k];
+                std::vector<ScalarType> & yk = y_k[k];
+                vcl_size_t n = Jk.size();
+
+                for (vcl_size_t i=0; i<n; ++i)
+                  position[Jk[i]] = static_cast<long>(i);
+
+                //fill block (lower triangular part only, since block is symmetric) and y_k from the lower triangular part of A:
+                block.assign(n*n, ScalarType(0));
+                yk.assign(n, ScalarType(0));
+                for (vcl_size_t i=0; i<n; ++i)
+                {
+                  vcl_size_t row_index = Jk[i];
+                  for (vcl_size_t j=A_row_start[row_index]; j<A_row_start[row_index+1]; ++j)
+                  {
+                    vcl_size_t col_index = A_col_indices[j];
+                    if (col_index > row_index)
+                      break;
+                    if (col_index == k)
+                      yk[i] = A_elements[j];
+                    else if (position[col_index] >= 0)
+                      block[i*n + static_cast<vcl_size_t>(position[col_index])] = A_elements[j];
+                  }
+                }
 
-            /*vcl_size_t num_bytes = 0;
-            for (vcl_size_t i=0; i<subblocks_A.size(); ++i)
-              num_bytes += 8*subblocks_A[i].size1()*subblocks_A[i].size2();*/
-            //std::cout << "Memory for FSPAI matrix: " << num_bytes / (1024.0 * 1024.0) << " MB" << std::endl;
+                if (n > 0) //block might be empty...
+                {
+                  cholesky_decompose(&(block[0]), n);
+                  cholesky_solve(&(block[0]), n, &(yk[0]));
+                }
 
-            //
-            // Step 4: Solve for y_k
-            //
-            //std::cout << "computeFSPAI(): Cholesky-solve..." << std::endl;
-            for (vcl_size_t i=0; i<y_k.size(); ++i)
-            {
-              if (subblocks_A[i].size1() > 0) //block might be empty...
-              {
-                //y_k[i].resize(subblocks_A[i].size1());
-                //std::cout << "y_k[" << i << "]: ";
-                //for (vcl_size_t j=0; j<y_k[i].size(); ++j)
-                //  std::cout << y_k[i][j] << " ";
-                //std::cout << std::endl;
-                cholesky_solve(subblocks_A[i], y_k[i]);
+                //compute L(k,k):
+                ScalarType Lkk = csr_entry(A_row_start, A_col_indices, A_elements, k, k);
+                for (vcl_size_t i=0; i<n; ++i)
+                  Lkk -= csr_entry(A_row_start, A_col_indices, A_elements, Jk[i], k) * yk[i];
+                L_diag[k] = ScalarType(1) / std::sqrt(Lkk);
+
+                for (vcl_size_t i=0; i<n; ++i)
+                  position[Jk[i]] = -1;
               }
             }
 
-
             //
-            // Step 5: Set up Cholesky factors L and L_trans
+            // Step 3: Set up Cholesky factors L and L_trans. Row k of L_trans holds L(k,k) and -L(k,k) * y_k at the columns J_k.
             //
-            //std::cout << "computeFSPAI(): Computing L..." << std::endl;
             L.resize(A.size1(), A.size2(), false);
             L.reserve(A.nnz(), false);
             L_trans.resize(A.size1(), A.size2(), false);
             L_trans.reserve(A.nnz(), false);
-            computeL(A, L, L_trans, y_k, J);
 
-            //std::cout << "L: " << L << std::endl;
+            std::vector<vcl_size_t> L_row_start(A.size1() + 1, 0);
+            for (vcl_size_t k=0; k<A.size1(); ++k)
+            {
+              ++L_row_start[k+1];
+              for (vcl_size_t i=0; i<J[k].size(); ++i)
+                ++L_row_start[J[k][i] + 1];
+            }
+            for (vcl_size_t k=0; k<A.size1(); ++k)
+              L_row_start[k+1] += L_row_start[k];
+
+            std::vector<vcl_size_t> L_col_indices(L_row_start.back());
+            std::vector<ScalarType> L_elements(L_row_start.back());
+            std::vector<vcl_size_t> next(L_row_start.begin(), L_row_start.end() - 1);
+            for (vcl_size_t k=0; k<A.size1(); ++k)
+            {
+              bool diag_done = false;
+              for (vcl_size_t i=0; i<=J[k].size(); ++i)
+              {
+                if (!diag_done && (i == J[k].size() || J[k][i] > k))
+                {
+                  L_trans(k, k) = L_diag[k];
+                  L_col_indices[next[k]] = k;
+                  L_elements[next[k]++] = L_diag[k];
+                  diag_done = true;
+                }
+                if (i < J[k].size())
+                {
+                  vcl_size_t col = J[k][i];
+                  ScalarType value = -L_diag[k] * y_k[k][i];
+                  L_trans(k, col) = value;
+                  L_col_indices[next[col]] = k;
+                  L_elements[next[col]++] = value;
+                }
+              }
+            }
+
+            //build L from its compressed row representation:
+            for (vcl_size_t i=0; i<A.size1(); ++i)
+              for (vcl_size_t j=L_row_start[i]; j<L_row_start[i+1]; ++j)
+                L(i, L_col_indices[j]) = L_elements[j];
           }
 
 
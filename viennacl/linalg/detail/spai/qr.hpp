@@ -33,7 +33,9 @@
 #include <math.h>
 #include <cmath>
 #include <sstream>
-#include "viennacl/ocl/backend.hpp"
+#ifdef VIENNACL_WITH_OPENCL
+  #include "viennacl/ocl/backend.hpp"
+#endif
 #include "boost/numeric/ublas/vector.hpp"
 #include "boost/numeric/ublas/matrix.hpp"
 #include "boost/numeric/ublas/matrix_proxy.hpp"
@@ -45,9 +47,11 @@
 #include "viennacl/vector.hpp"
 #include "viennacl/matrix.hpp"
 
-#include "viennacl/linalg/detail/spai/block_matrix.hpp"
-#include "viennacl/linalg/detail/spai/block_vector.hpp"
-#include "viennacl/linalg/opencl/kernels/spai.hpp"
+#ifdef VIENNACL_WITH_OPENCL
+  #include "viennacl/linalg/detail/spai/block_matrix.hpp"
+  #include "viennacl/linalg/detail/spai/block_vector.hpp"
+  #include "viennacl/linalg/opencl/kernels/spai.hpp"
+#endif
 
 namespace viennacl
 {
@@ -77,6 +81,7 @@ namespace viennacl
               }
           }
 
+#ifdef VIENNACL_WITH_OPENCL
           template<typename VectorType>
           void print_continious_matrix(VectorType& con_A_I_J, std::vector<cl_uint>& blocks_ind,
                                       const std::vector<std::vector<unsigned int> >& g_I, const std::vector<std::vector<unsigned int> >& g_J){
@@ -121,6 +126,7 @@ namespace viennacl
 
               }
           }
+#endif
           /** @brief Computes size of particular container of index set
           * @param inds container of index sets
           * @param size output size
@@ -133,6 +139,7 @@ namespace viennacl
               }
           }
 
+#ifdef VIENNACL_WITH_OPENCL
           /** @brief Initializes start indices of particular index set
           * @param inds container of index sets
           * @param start_inds output index set
@@ -143,130 +150,7 @@ namespace viennacl
                   start_inds[i+1] = start_inds[i] + static_cast<cl_uint>(inds[i].size());
               }
           }
-
-          //*************************************  QR FUNCTIONS  ***************************************//
-          /** @brief Dot prod of particular column of martix A with it's self starting at a certain index beg_ind
-          * @param A init matrix
-          * @param beg_ind starting index
-          * @param res result of dot product
-          */
-          template<typename MatrixType, typename ScalarType>
-          void dot_prod(const MatrixType& A,  unsigned int beg_ind, ScalarType& res){
-              res = static_cast<ScalarType>(0);
-              for(vcl_size_t i = beg_ind; i < A.size1(); ++i){
-                  res += A(i, beg_ind-1)*A(i, beg_ind-1);
-              }
-          }
-          /** @brief Dot prod of particular matrix column with arbitrary vector: A(:, col_ind)
-          * @param A init matrix
-          * @param v input vector
-          * @param col_ind starting column index
-          * @param start_ind starting index inside column
-          * @param res result of dot product
-          */
-          template<typename MatrixType, typename VectorType, typename ScalarType>
-          void custom_inner_prod(const MatrixType& A, const VectorType& v, unsigned int col_ind, unsigned int start_ind, ScalarType& res){
-              res = static_cast<ScalarType>(0);
-              for(unsigned int i = start_ind; i < static_cast<unsigned int>(A.size1()); ++i){
-                  res += A(i, col_ind)*v(i);
-              }
-          }
-
-          /** @brief Copying part of matrix column
-          * @param A init matrix
-          * @param v output vector
-          * @param beg_ind start index for copying
-          */
-          template<typename MatrixType, typename VectorType>
-          void copy_vector(const MatrixType & A, VectorType & v, const unsigned int beg_ind){
-              for(unsigned int i = beg_ind; i < static_cast<unsigned int>(A.size1()); ++i){
-                  v(i) = A( i, beg_ind-1);
-              }
-          }
-
-          //householder reflection c.f. Gene H. Golub, Charles F. Van Loan "Matrix Computations" 3rd edition p.210
-          /** @brief Coputation of Householder vector, householder reflection c.f. Gene H. Golub, Charles F. Van Loan "Matrix Computations" 3rd edition p.210
-          * @param A init matrix
-          * @param j start index for computations
-          * @param v output Householder vector
-          * @param b beta
-          */
-          template<typename MatrixType, typename VectorType, typename ScalarType>
-          void householder_vector(const MatrixType& A, unsigned int j, VectorType& v, ScalarType& b)
-          {
-              ScalarType sg;
-              //
-              dot_prod(A, j+1, sg);
-              copy_vector(A, v, j+1);
-              ScalarType mu;
-              v(j) = static_cast<ScalarType>(1.0);
-              if(sg == 0){
-                  b = 0;
-              }
-              else{
-                  mu = std::sqrt(A(j,j)*A(j, j) + sg);
-                  if(A(j, j) <= 0){
-                      v(j) = A(j, j) - mu;
-                  }else{
-                      v(j) = -sg/(A(j, j) + mu);
-                  }
-                  b = 2*(v(j)*v(j))/(sg + v(j)*v(j));
-                  v = v/v(j);
-              }
-          }
-          /** @brief Inplace application of Householder vector to a matrix A
-          * @param A init matrix
-          * @param iter_cnt current iteration
-          * @param v Householder vector
-          * @param b beta
-          */
-          template<typename MatrixType, typename VectorType, typename ScalarType>
-          void apply_householder_reflection(MatrixType& A, unsigned int iter_cnt, VectorType& v, ScalarType b)
-          {
-              //update every column of matrix A
-              ScalarType in_prod_res;
-              for(unsigned int i = iter_cnt; i < static_cast<unsigned int>(A.size2()); ++i){
-                  //update each column in a fashion: ai = ai - b*v*(v'*ai)
-                  custom_inner_prod(A, v, i, iter_cnt, in_prod_res);
-                  for(unsigned int j = iter_cnt; j < static_cast<unsigned int>(A.size1()); ++j){
-                      A(j, i) -= b*in_prod_res*v(j);
-                  }
-              }
-          }
-
-          /** @brief Storage of vector v in column(A, ind), starting from ind-1 index of a column
-          * @param A init matrix
-          * @param ind index of a column
-          * @param v vector that should be stored
-          */
-          template<typename MatrixType, typename VectorType>
-          void store_householder_vector(MatrixType& A, unsigned int ind, VectorType& v)
-          {
-              for(unsigned int i = ind; i < static_cast<unsigned int>(A.size1()); ++i){
-                  A(i, ind-1) = v(i);
-              }
-          }
-
-
-          //QR algorithm
-          /** @brief Inplace QR factorization via Householder reflections c.f. Gene H. Golub, Charles F. Van Loan "Matrix Computations" 3rd edition p.224
-          * @param R input matrix
-          * @param b_v vector of betas
-          */
-          template<typename MatrixType, typename VectorType>
-          void single_qr(MatrixType& R, VectorType& b_v)
-          {
-              typedef typename MatrixType::value_type ScalarType;
-              if((R.size1() > 0) && (R.size2() > 0)){
-                  VectorType v = (VectorType)boost::numeric::ublas::zero_vector<ScalarType>(R.size1());
-                  b_v = (VectorType)boost::numeric::ublas::zero_vector<ScalarType>(R.size2());
-                  for(unsigned int i = 0; i < static_cast<unsigned int>(R.size2()); ++i){
-                      householder_vector(R, i, v, b_v[i]);
-                      apply_householder_reflection(R, i, v, b_v[i]);
-                      if(i < R.size1()) store_householder_vector(R, i+1, v);
-                  }
-              }
-          }
+#endif
 
           //********************** HELP FUNCTIONS FOR GPU-based QR factorization *************************//
           /* * @brief Reading from text file into string
@@ -302,64 +186,77 @@ namespace viennacl
               }
           }
 
-          /** @brief Dot_prod(column(A, ind), v) starting from index ind+1
-          * @param A input matrix
-          * @param v input vector
-          * @param ind index
-          * @param res result value
-          */
-          template<typename MatrixType, typename VectorType, typename ScalarType>
-          void custom_dot_prod(const MatrixType& A, const VectorType& v, unsigned int ind, ScalarType& res)
-          {
-              res = static_cast<ScalarType>(0);
-              for(unsigned int j = ind; j < A.size1(); ++j){
-                  if(j == ind){
-                      res += v(j);
-                  }else{
-                      res += A(j, ind)*v(j);
-                  }
-              }
-          }
-
-          /** @brief Recovery Q from matrix R and vector of betas b_v
-          * @param R input matrix
-          * @param b_v vector of betas
-          * @param y output vector
+          //********************** QR FUNCTIONS FOR CONTIGUOUS BUFFERS (host) *************************//
+          /** @brief Inplace QR factorization of the columns col_begin, ..., col_end-1 of a column-major matrix, c.f. Gene H. Golub, Charles F. Van Loan "Matrix Computations" 3rd edition p.224
+          *
+          * The columns 0, ..., col_begin-1 must be factored already, their Householder reflections must have been applied to the remaining columns.
+          * The Householder vectors are stored below the diagonal with an implicit unit entry on the diagonal.
+          * @param R         column-major matrix, overwritten with R and the Householder vectors
+          * @param ld        number of rows of R
+          * @param col_begin first column to be factored
+          * @param col_end   one past the last column to be factored
+          * @param betas     betas for Q recovery, entries col_begin, ..., col_end-1 are written
           */
-          template<typename MatrixType, typename VectorType>
-          void apply_q_trans_vec(const MatrixType& R, const VectorType& b_v, VectorType& y)
+          template<typename ScalarType>
+          void single_qr(ScalarType * R, vcl_size_t ld, vcl_size_t col_begin, vcl_size_t col_end, ScalarType * betas)
           {
-              typedef typename MatrixType::value_type ScalarType;
-              ScalarType inn_prod = static_cast<ScalarType>(0);
-              for(vcl_size_t i = 0; i < R.size2(); ++i){
-                  custom_dot_prod(R, y, static_cast<unsigned int>(i), inn_prod);
-                  for(vcl_size_t j = i; j < R.size1(); ++j){
-                      if(i == j){
-                          y(j) -= b_v(i)*inn_prod;
-                      }
-                      else{
-                          y(j) -= b_v(i)*inn_prod*R(j,i);
-                      }
+              for(vcl_size_t j = col_begin; j < col_end; ++j){
+                  ScalarType * v = R + j*ld;
+                  betas[j] = 0;
+                  if(j >= ld)
+                      continue;
+
+                  ScalarType sg = 0;
+                  for(vcl_size_t i = j+1; i < ld; ++i)
+                      sg += v[i]*v[i];
+                  if(sg == 0)
+                      continue;
+
+                  ScalarType mu = std::sqrt(v[j]*v[j] + sg);
+                  ScalarType v_j = (v[j] <= 0) ? v[j] - mu : -sg/(v[j] + mu);
+                  betas[j] = 2*(v_j*v_j)/(sg + v_j*v_j);
+                  for(vcl_size_t i = j+1; i < ld; ++i)
+                      v[i] /= v_j;
+                  v[j] = mu;
+
+                  //update remaining columns: a_k = a_k - b*v*(v'*a_k)
+                  for(vcl_size_t k = j+1; k < col_end; ++k){
+                      ScalarType * a = R + k*ld;
+                      ScalarType in_prod_res = a[j];
+                      for(vcl_size_t i = j+1; i < ld; ++i)
+                          in_prod_res += v[i]*a[i];
+                      in_prod_res *= betas[j];
+                      a[j] -= in_prod_res;
+                      for(vcl_size_t i = j+1; i < ld; ++i)
+                          a[i] -= in_prod_res*v[i];
                   }
               }
           }
 
-          /** @brief Multiplication of Q'*A, where Q is in implicit for lower part of R and vector of betas - b_v
-          * @param R input matrix
-          * @param b_v vector of betas
-          * @param A output matrix
+          /** @brief Computes y = Q'*y for Q given implicitly by the Householder vectors of the columns col_begin, ..., col_end-1 of a column-major matrix R
+          * @param R         column-major matrix holding the Householder vectors (see single_qr())
+          * @param ld        number of rows of R, length of y
+          * @param col_begin first Householder reflection to be applied
+          * @param col_end   one past the last Householder reflection to be applied
+          * @param betas     betas for Q recovery
+          * @param y         vector which is overwritten with Q'*y
           */
-          template<typename MatrixType, typename VectorType>
-          void apply_q_trans_mat(const MatrixType& R, const VectorType& b_v, MatrixType& A)
+          template<typename ScalarType>
+          void apply_q_trans_vec(ScalarType const * R, vcl_size_t ld, vcl_size_t col_begin, vcl_size_t col_end, ScalarType const * betas, ScalarType * y)
           {
-              VectorType tmp_v;
-              for(vcl_size_t i = 0; i < A.size2(); ++i){
-                  tmp_v = (VectorType)column(A,i);
-                  apply_q_trans_vec(R, b_v, tmp_v);
-                  column(A,i) = tmp_v;
+              for(vcl_size_t j = col_begin; j < std::min(col_end, ld); ++j){
+                  ScalarType const * v = R + j*ld;
+                  ScalarType in_prod_res = y[j];
+                  for(vcl_size_t i = j+1; i < ld; ++i)
+                      in_prod_res += v[i]*y[i];
+                  in_prod_res *= betas[j];
+                  y[j] -= in_prod_res;
+                  for(vcl_size_t i = j+1; i < ld; ++i)
+                      y[i] -= in_prod_res*v[i];
               }
           }
 
+#ifdef VIENNACL_WITH_OPENCL
           //parallel QR for GPU
           /** @brief Inplace QR factorization via Householder reflections c.f. Gene H. Golub, Charles F. Van Loan "Matrix Computations" 3rd edition p.224 performed on GPU
           *
@@ -435,6 +332,7 @@ namespace viennacl
                                             static_cast<cl_uint>(g_I.size())));
 
           }
+#endif
         }
       }
     }
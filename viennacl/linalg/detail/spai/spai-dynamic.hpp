@@ -54,15 +54,21 @@
 #include "viennacl/linalg/cg.hpp"
 #include "viennacl/linalg/inner_prod.hpp"
 #include "viennacl/linalg/ilu.hpp"
-#include "viennacl/ocl/backend.hpp"
+#ifdef VIENNACL_WITH_OPENCL
+  #include "viennacl/ocl/backend.hpp"
+#endif
 
-#include "viennacl/linalg/detail/spai/block_matrix.hpp"
-#include "viennacl/linalg/detail/spai/block_vector.hpp"
+#ifdef VIENNACL_WITH_OPENCL
+  #include "viennacl/linalg/detail/spai/block_matrix.hpp"
+  #include "viennacl/linalg/detail/spai/block_vector.hpp"
+#endif
 #include "viennacl/linalg/detail/spai/qr.hpp"
 #include "viennacl/linalg/detail/spai/spai-static.hpp"
 #include "viennacl/linalg/detail/spai/spai.hpp"
 #include "viennacl/linalg/detail/spai/spai_tag.hpp"
-#include "viennacl/linalg/opencl/kernels/spai.hpp"
+#ifdef VIENNACL_WITH_OPENCL
+  #include "viennacl/linalg/opencl/kernels/spai.hpp"
+#endif
 
 namespace viennacl
 {
@@ -73,55 +79,6 @@ namespace viennacl
         namespace spai
         {
 
-          /** @brief Helper functor for comparing std::pair<> based on the second member. */
-          struct CompareSecond
-          {
-            template <typename T1, typename T2>
-            bool operator()(std::pair<T1, T2> const & left, std::pair<T1, T2> const & right)
-            {
-              return static_cast<double>(left.second) > static_cast<double>(right.second);
-            }
-          };
-
-
-          /** @brief Composition of new matrix R, that is going to be used in Least Square problem solving
-          * @param A matrix Q'*A(I, \\tilde J), where \\tilde J - set of new column indices
-          * @param R_n matrix A_Iu_J_u after QR factorization
-          * @param R previously composed matrix R
-          */
-          template<typename MatrixType>
-          void composeNewR(const MatrixType& A, const MatrixType& R_n, MatrixType& R)
-          {
-            typedef typename MatrixType::value_type ScalarType;
-            vcl_size_t row_n = R_n.size1() - (A.size1() - R.size2());
-            MatrixType C = boost::numeric::ublas::zero_matrix<ScalarType>(R.size1() + row_n, R.size2() + A.size2());
-            //write original R to new Composite R
-            boost::numeric::ublas::project(C, boost::numeric::ublas::range(0,R.size1()), boost::numeric::ublas::range(0, R.size2())) += R;
-            //write upper part of Q'*A_I_\hatJ, all columns and number of rows that equals to R.size2()
-            boost::numeric::ublas::project(C, boost::numeric::ublas::range(0, R.size2()), boost::numeric::ublas::range(R.size2(),
-                                                                                                                      R.size2() + A.size2())) +=
-            boost::numeric::ublas::project(A, boost::numeric::ublas::range(0, R.size2()), boost::numeric::ublas::range(0, A.size2()));
-            //adding decomposed(QR) block to Composite R
-            if(R_n.size1() > 0 && R_n.size2() > 0)
-                boost::numeric::ublas::project(C, boost::numeric::ublas::range(R.size2(), R.size1() + row_n),
-                                              boost::numeric::ublas::range(R.size2(), R.size2() + A.size2())) += R_n;
-            R = C;
-          }
-
-          /** @brief Composition of new vector of coefficients beta from QR factorizations(necessary for Q recovery)
-          * @param v_n new vector from last QR factorization
-          * @param v composition of previous vectors from QR factorizations
-          */
-          template<typename VectorType>
-          void composeNewVector(const VectorType& v_n, VectorType& v)
-          {
-            typedef typename VectorType::value_type ScalarType;
-            VectorType w  = boost::numeric::ublas::zero_vector<ScalarType>(v.size() + v_n.size());
-            boost::numeric::ublas::project(w, boost::numeric::ublas::range(0, v.size())) += v;
-            boost::numeric::ublas::project(w, boost::numeric::ublas::range(v.size(), v.size() + v_n.size())) += v_n;
-            v = w;
-          }
-
           /** @brief Computation of Euclidean norm for sparse vector
           * @param v initial sparse vector
           * @param norm scalar that represents Euclidean norm
@@ -220,95 +177,7 @@ namespace viennacl
             }
           }
 
-          /** @brief Composition of new block for QR factorization cf. Kallischko dissertation p.82, figure 4.7
-          * @param A_I_J previously composed block
-          * @param A_I_J_u matrix Q'*A(I, \\tilde J), where \\tilde J - set of new column indices
-          * @param A_I_u_J_u is composition of lower part A(I, \\tilde J) and  A(\\tilde I, \\tilde J) - new block for QR decomposition
-          */
-          template<typename MatrixType>
-          void QRBlockComposition(const MatrixType& A_I_J, const MatrixType& A_I_J_u, MatrixType& A_I_u_J_u)
-          {
-            typedef typename MatrixType::value_type ScalarType;
-            vcl_size_t row_n1 = A_I_J_u.size1() - A_I_J.size2();
-            vcl_size_t row_n2 = A_I_u_J_u.size1();
-            vcl_size_t row_n = row_n1 + row_n2;
-            vcl_size_t col_n = A_I_J_u.size2();
-            MatrixType C = boost::numeric::ublas::zero_matrix<ScalarType>(row_n, col_n);
-            boost::numeric::ublas::project(C, boost::numeric::ublas::range(0, row_n1), boost::numeric::ublas::range(0, col_n)) +=
-            boost::numeric::ublas::project(A_I_J_u, boost::numeric::ublas::range(A_I_J.size2(), A_I_J_u.size1()),
-                                          boost::numeric::ublas::range(0, col_n));
-
-            boost::numeric::ublas::project(C, boost::numeric::ublas::range(row_n1, row_n1 + row_n2),
-                                          boost::numeric::ublas::range(0, col_n)) += A_I_u_J_u;
-            A_I_u_J_u = C;
-          }
-
-          /** @brief CPU-based dynamic update for SPAI preconditioner
-          * @param A initial sparse matrix
-          * @param A_v_c vectorized column-wise initial matrix
-          * @param g_res container of residuals for all columns
-          * @param g_is_update container with identificators that shows which block should be modified
-          * @param g_I container of row index sets for all columns
-          * @param g_J container of column index sets for all columns
-          * @param g_b_v container of vectors of beta for Q recovery(cf. Golub Van Loan "Matrix Computations", 3rd edition p.211)
-          * @param g_A_I_J container of block matrices from previous update
-          * @param tag  SPAI configuration tag
-          */
-          template<typename SparseMatrixType, typename SparseVectorType, typename DenseMatrixType, typename VectorType>
-          void block_update(const SparseMatrixType& A, const std::vector<SparseVectorType>& A_v_c,
-                            std::vector<SparseVectorType>& g_res,
-                            std::vector<bool>& g_is_update,
-                            std::vector<std::vector<unsigned int> >& g_I,
-                            std::vector<std::vector<unsigned int> >& g_J,
-                            std::vector<VectorType>& g_b_v,
-                            std::vector<DenseMatrixType>& g_A_I_J,
-                            spai_tag const & tag)
-          {
-            typedef typename DenseMatrixType::value_type ScalarType;
-            //set of new column indices
-            std::vector<std::vector<unsigned int> > g_J_u(g_J.size());
-            //set of new row indices
-            std::vector<std::vector<unsigned int> > g_I_u(g_J.size());
-            //matrix A(I, \tilde J), cf. Kallischko p.31-32
-            std::vector<DenseMatrixType> g_A_I_J_u(g_J.size());
-            //matrix A(\tilde I, \tilde J), cf. Kallischko
-            std::vector<DenseMatrixType> g_A_I_u_J_u(g_J.size());
-            //new vector of beta coefficients from QR factorization
-            std::vector<VectorType> g_b_v_u(g_J.size());
-#ifdef VIENNACL_WITH_OPENMP
-            #pragma omp parallel for
-#endif
-            for(long i = 0; i < static_cast<long>(g_J.size()); ++i)
-            {
-              if(g_is_update[i])
-              {
-                if(buildAugmentedIndexSet<SparseVectorType, ScalarType>(A_v_c, g_res[i], g_J[i], g_J_u[i], tag))
-                {
-                  //initialize matrix A_I_\hatJ
-                  initProjectSubMatrix(A, g_J_u[i], g_I[i], g_A_I_J_u[i]);
-                  //multiplication of Q'*A_I_\hatJ
-                  apply_q_trans_mat(g_A_I_J[i], g_b_v[i], g_A_I_J_u[i]);
-                  //building new rows index set \hatI
-                  buildNewRowSet(A_v_c, g_I[i], g_J_u[i], g_I_u[i]);
-                  initProjectSubMatrix(A, g_J_u[i], g_I_u[i], g_A_I_u_J_u[i]);
-                  //composition of block for new QR factorization
-                  QRBlockComposition(g_A_I_J[i], g_A_I_J_u[i], g_A_I_u_J_u[i]);
-                  //QR factorization
-                  single_qr(g_A_I_u_J_u[i], g_b_v_u[i]);
-                  //composition of new R and new vector b_v
-                  composeNewR(g_A_I_J_u[i], g_A_I_u_J_u[i], g_A_I_J[i]);
-                  composeNewVector(g_b_v_u[i], g_b_v[i]);
-                  //composition of new sets: I and J
-                  g_J[i].insert(g_J[i].end(), g_J_u[i].begin(), g_J_u[i].end());
-                  g_I[i].insert(g_I[i].end(), g_I_u[i].begin(), g_I_u[i].end());
-                }
-                else
-                {
-                  g_is_update[i] = false;
-                }
-              }
-            }
-          }
+#ifdef VIENNACL_WITH_OPENCL
           /**************************************************** GPU SPAI Update ****************************************************************/
 
 
@@ -631,6 +500,7 @@ namespace viennacl
             }
             assemble_r<ScalarType>(g_I, g_J, g_A_I_J_vcl, g_A_I_J_u_vcl, g_A_I_u_J_u_vcl,  g_bv_vcl,  g_bv_u_vcl, g_is_update, ctx);
           }
+#endif
 
         }
       }
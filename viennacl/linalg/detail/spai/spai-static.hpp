@@ -73,6 +73,16 @@ namespace viennacl
           return (std::find(J.begin(), J.end(), ind) != J.end());
         }
 
+        /** @brief Helper functor for comparing std::pair<> based on the second member. */
+        struct CompareSecond
+        {
+          template <typename T1, typename T2>
+          bool operator()(std::pair<T1, T2> const & left, std::pair<T1, T2> const & right)
+          {
+            return static_cast<double>(left.second) > static_cast<double>(right.second);
+          }
+        };
+
 
 
         /********************************* STATIC SPAI FUNCTIONS******************************************/
@@ -171,12 +181,10 @@ namespace viennacl
           for(vcl_size_t i = 0; i < J.size(); ++i)
           {
             for(typename SparseVectorType::const_iterator col_it = A_v_c[J[i]].begin(); col_it!=A_v_c[J[i]].end(); ++col_it)
-            {
-              if(!isInIndexSet(I, col_it->first))
-                I.push_back(col_it->first);
-            }
+              I.push_back(col_it->first);
           }
           std::sort(I.begin(), I.end());
+          I.erase(std::unique(I.begin(), I.end()), I.end());
         }
 
 
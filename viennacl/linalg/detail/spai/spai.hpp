@@ -37,8 +37,10 @@
 #include "viennacl/linalg/detail/spai/spai-dynamic.hpp"
 #include "viennacl/linalg/detail/spai/spai-static.hpp"
 #include "viennacl/linalg/detail/spai/sparse_vector.hpp"
-#include "viennacl/linalg/detail/spai/block_matrix.hpp"
-#include "viennacl/linalg/detail/spai/block_vector.hpp"
+#ifdef VIENNACL_WITH_OPENCL
+  #include "viennacl/linalg/detail/spai/block_matrix.hpp"
+  #include "viennacl/linalg/detail/spai/block_vector.hpp"
+#endif
 
 //boost includes
 #include "boost/numeric/ublas/vector.hpp"
@@ -60,8 +62,10 @@
 #include "viennacl/scalar.hpp"
 #include "viennacl/linalg/inner_prod.hpp"
 #include "viennacl/linalg/ilu.hpp"
-#include "viennacl/ocl/backend.hpp"
-#include "viennacl/linalg/opencl/kernels/spai.hpp"
+#ifdef VIENNACL_WITH_OPENCL
+  #include "viennacl/ocl/backend.hpp"
+  #include "viennacl/linalg/opencl/kernels/spai.hpp"
+#endif
 
 
 
@@ -133,55 +137,6 @@ namespace viennacl
             projectRows(A_v_c, J, I);
         }
 
-        /** @brief Initializes a dense matrix from a sparse one
-        * @param A_in Riginal sparse matrix
-        * @param J Set of column indices
-        * @param I Set of row indices
-        * @param A_out dense matrix output
-        */
-        template<typename SparseMatrixType, typename DenseMatrixType>
-        void initProjectSubMatrix(const SparseMatrixType& A_in, const std::vector<unsigned int>& J, std::vector<unsigned int>& I,
-                                  DenseMatrixType& A_out)
-        {
-          A_out.resize(I.size(), J.size(), false);
-          for(vcl_size_t j = 0; j < J.size(); ++j)
-          {
-            for(vcl_size_t i = 0; i < I.size(); ++i)
-              A_out(i,j) = A_in(I[i],J[j]);
-          }
-        }
-
-
-        /************************************************** CPU BLOCK SET UP ***************************************/
-        /** @brief Setting up blocks and QR factorizing them on CPU
-         * @param A initial sparse matrix
-         * @param A_v_c column major vectorized initial sparse matrix
-         * @param M_v initialized preconditioner
-         * @param g_I container of row indices
-         * @param g_J container of column indices
-         * @param g_A_I_J container of dense matrices -> R matrices after QR factorization
-         * @param g_b_v container of vectors beta, necessary for Q recovery
-         */
-        template<typename SparseMatrixType, typename DenseMatrixType, typename SparseVectorType, typename VectorType>
-        void block_set_up(const SparseMatrixType& A,
-                          const std::vector<SparseVectorType>& A_v_c,
-                          const std::vector<SparseVectorType>& M_v,
-                          std::vector<std::vector<unsigned int> >& g_I,
-                          std::vector<std::vector<unsigned int> >& g_J,
-                          std::vector<DenseMatrixType>& g_A_I_J,
-                          std::vector<VectorType>& g_b_v){
-#ifdef VIENNACL_WITH_OPENMP
-            #pragma omp parallel for
-#endif
-            for (long i = 0; i < static_cast<long>(M_v.size()); ++i){
-                build_index_set(A_v_c, M_v[i], g_J[i], g_I[i]);
-                initProjectSubMatrix(A, g_J[i], g_I[i], g_A_I_J[i]);
-                //print_matrix(g_A_I_J[i]);
-                single_qr(g_A_I_J[i], g_b_v[i]);
-                //print_matrix(g_A_I_J[i]);
-            }
-        }
-
         /** @brief Setting up index set of columns and rows for all columns
          * @param A_v_c column major vectorized initial sparse matrix
          * @param M_v initialized preconditioner
@@ -202,6 +157,7 @@ namespace viennacl
             }
         }
 
+#ifdef VIENNACL_WITH_OPENCL
         /************************************************** GPU BLOCK SET UP ***************************************/
         /** @brief Setting up blocks and QR factorizing them on GPU
          * @param A initial sparse matrix
@@ -231,6 +187,7 @@ namespace viennacl
           block_qr<ScalarType>(g_I, g_J, g_A_I_J, g_bv, g_is_update, ctx);
 
         }
+#endif
 
 
         /***************************************************************************************************/
@@ -256,6 +213,7 @@ namespace viennacl
 
 
 
+#ifdef VIENNACL_WITH_OPENCL
         //GPU based least square problem
         /** @brief Solution of Least square problem on GPU
          * @param A_v_c column-major vectorized initial sparse matrix
@@ -352,54 +310,7 @@ namespace viennacl
             }
           }
         }
-
-        //CPU based least square problems
-        /** @brief Solution of Least square problem on CPU
-         * @param A_v_c column-major vectorized initial sparse matrix
-         * @param g_R blocks for least square solution
-         * @param g_b_v vectors beta, necessary for Q recovery
-         * @param g_I container of row index set for all columns of matrix M
-         * @param g_J container of column index set for all columns of matrix M
-         * @param g_res container of residuals
-         * @param g_is_update container with indicators which blocks are active
-         * @param M_v column-major vectorized sparse matrix, final preconditioner
-         * @param tag spai tag
-         */
-        template<typename SparseVectorType, typename DenseMatrixType, typename VectorType>
-        void least_square_solve(const std::vector<SparseVectorType>& A_v_c,
-                                std::vector<DenseMatrixType>& g_R,
-                                std::vector<VectorType>& g_b_v,
-                                std::vector<std::vector<unsigned int> >& g_I,
-                                std::vector<std::vector<unsigned int> >& g_J,
-                                std::vector<SparseVectorType>& g_res,
-                                std::vector<bool>& g_is_update,
-                                std::vector<SparseVectorType>& M_v,
-                                const spai_tag& tag){
-            typedef typename DenseMatrixType::value_type ScalarType;
-            //VectorType m_new, y;
-#ifdef VIENNACL_WITH_OPENMP
-            #pragma omp parallel for
 #endif
-            for (long i = 0; i < static_cast<long>(M_v.size()); ++i){
-                if(g_is_update[i]){
-                    VectorType y = boost::numeric::ublas::zero_vector<ScalarType>(g_I[i].size());
-                    //std::cout<<y<<std::endl;
-                    projectI<VectorType, ScalarType>(g_I[i], y, static_cast<unsigned int>(tag.getBegInd() + i));
-                    apply_q_trans_vec(g_R[i], g_b_v[i], y);
-                    VectorType m_new =  boost::numeric::ublas::zero_vector<ScalarType>(g_R[i].size2());
-                    backwardSolve(g_R[i], y, m_new);
-                    fanOutVector(m_new, g_J[i], M_v[i]);
-                    g_res[i].clear();
-                    compute_spai_residual<SparseVectorType, ScalarType>(A_v_c,  M_v[i], static_cast<unsigned int>(tag.getBegInd() + i), g_res[i]);
-                    ScalarType res_norm = 0;
-                    sparse_norm_2(g_res[i], res_norm);
-//                    std::cout<<"Residual norm of column #: "<<i<<std::endl;
-//                    std::cout<<res_norm<<std::endl;
-//                    std::cout<<"************************"<<std::endl;
-                    g_is_update[i] = (res_norm > tag.getResidualNormThreshold())&& (!tag.getIsStatic());
-                }
-            }
-        }
 
         //************************************ UPDATE CHECK ***************************************************//
         template<typename VectorType>
@@ -442,6 +353,7 @@ namespace viennacl
         //************************************* BLOCK ASSEMBLY CODE *********************************************//
 
 
+#ifdef VIENNACL_WITH_OPENCL
         template <typename SizeType>
         void write_set_to_array(const std::vector<std::vector<SizeType> >& ind_set, std::vector<cl_uint>& a){
             vcl_size_t cnt = 0;
@@ -561,34 +473,151 @@ namespace viennacl
             else
               is_empty_block = true;
         }
+#endif
 
         /************************************************************************************************************************/
 
-        /** @brief Insertion of vectorized matrix column into original sparse matrix
-         * @param M_v column-major vectorized matrix
-         * @param M original sparse matrix
+        /** @brief Insertion of the columns of the preconditioner into original sparse matrix. The entries are inserted row by row.
+         * @param M_J row indices of each column of the preconditioner
+         * @param M_m values of each column of the preconditioner
+         * @param M original sparse matrix, must be empty and have the correct size
          * @param is_right indicates if matrix should be transposed in the output
          */
-        template<typename SparseMatrixType, typename SparseVectorType>
-        void insert_sparse_columns(const std::vector<SparseVectorType>& M_v,
+        template<typename SparseMatrixType, typename ScalarType>
+        void insert_sparse_columns(const std::vector<std::vector<unsigned int> >& M_J,
+                                   const std::vector<std::vector<ScalarType> >& M_m,
                                    SparseMatrixType& M,
                                    bool is_right){
             if (is_right)
             {
-              for(unsigned int i = 0; i < M_v.size(); ++i){
-                  for(typename SparseVectorType::const_iterator vec_it = M_v[i].begin(); vec_it!=M_v[i].end(); ++vec_it){
-                      M(vec_it->first, i) = vec_it->second;
+              //counting sort of the entries by row index, keeps the columns sorted within each row
+              std::vector<unsigned int> row_start(M.size1() + 1, 0);
+              for(vcl_size_t i = 0; i < M_J.size(); ++i)
+                  for(vcl_size_t j = 0; j < M_J[i].size(); ++j)
+                      ++row_start[M_J[i][j] + 1];
+              for(vcl_size_t i = 0; i < M.size1(); ++i)
+                  row_start[i+1] += row_start[i];
+
+              std::vector<unsigned int> col_indices(row_start.back());
+              std::vector<ScalarType>   elements(row_start.back());
+              std::vector<unsigned int> next(row_start.begin(), row_start.end() - 1);
+              for(vcl_size_t i = 0; i < M_J.size(); ++i){
+                  for(vcl_size_t j = 0; j < M_J[i].size(); ++j){
+                      unsigned int pos = next[M_J[i][j]]++;
+                      col_indices[pos] = static_cast<unsigned int>(i);
+                      elements[pos] = M_m[i][j];
                   }
               }
+
+              for(vcl_size_t i = 0; i < M.size1(); ++i)
+                  for(unsigned int j = row_start[i]; j < row_start[i+1]; ++j)
+                      M(i, col_indices[j]) = elements[j];
             }
             else  //transposed fill of M
             {
-              for(unsigned int i = 0; i < M_v.size(); ++i){
-                  for(typename SparseVectorType::const_iterator vec_it = M_v[i].begin(); vec_it!=M_v[i].end(); ++vec_it){
-                      M(i, vec_it->first) = vec_it->second;
+              for(vcl_size_t i = 0; i < M_J.size(); ++i)
+                  for(vcl_size_t j = 0; j < M_J[i].size(); ++j)
+                      M(i, M_J[i][j]) = M_m[i][j];
+            }
+        }
+
+        /** @brief Insertion of the columns of the preconditioner into a uBLAS compressed_matrix. The CSR arrays are assembled directly.
+         *
+         * The row lengths are counted first and turned into row offsets by a prefix sum. The rows of a transposed fill (is_right == false) are then written in parallel.
+         * For is_right == true the entries are scattered by a single counting sort pass, which keeps the column indices sorted within each row.
+         * @param M_J row indices of each column of the preconditioner
+         * @param M_m values of each column of the preconditioner
+         * @param M original sparse matrix, must be empty and have the correct size
+         * @param is_right indicates if matrix should be transposed in the output
+         */
+        template<typename ScalarType>
+        void insert_sparse_columns(const std::vector<std::vector<unsigned int> >& M_J,
+                                   const std::vector<std::vector<ScalarType> >& M_m,
+                                   boost::numeric::ublas::compressed_matrix<ScalarType>& M,
+                                   bool is_right){
+            typedef typename boost::numeric::ublas::compressed_matrix<ScalarType>::size_type   SizeType;
+
+            std::vector<SizeType> row_start(M.size1() + 1, 0);
+            if (is_right)
+            {
+              for(vcl_size_t i = 0; i < M_J.size(); ++i)
+                  for(vcl_size_t j = 0; j < M_J[i].size(); ++j)
+                      ++row_start[M_J[i][j] + 1];
+            }
+            else
+            {
+              for(vcl_size_t i = 0; i < M_J.size(); ++i)
+                  row_start[i+1] = M_J[i].size();
+            }
+            for(vcl_size_t i = 0; i < M.size1(); ++i)
+                row_start[i+1] += row_start[i];
+
+            SizeType nnz = row_start.back();
+            M.clear();
+            M.reserve(nnz, false);
+            SizeType   * col_indices = &(M.index2_data()[0]);
+            ScalarType * elements    = &(M.value_data()[0]);
+
+            if (is_right)
+            {
+              std::vector<SizeType> next(row_start.begin(), row_start.end() - 1);
+              for(vcl_size_t i = 0; i < M_J.size(); ++i){
+                  for(vcl_size_t j = 0; j < M_J[i].size(); ++j){
+                      SizeType pos = next[M_J[i][j]]++;
+                      col_indices[pos] = i;
+                      elements[pos] = M_m[i][j];
                   }
               }
             }
+            else  //transposed fill of M: column i of the preconditioner becomes row i
+            {
+#ifdef VIENNACL_WITH_OPENMP
+              #pragma omp parallel
+#endif
+              {
+                std::vector<std::pair<unsigned int, ScalarType> > row_entries;
+#ifdef VIENNACL_WITH_OPENMP
+                #pragma omp for
+#endif
+                for(long i = 0; i < static_cast<long>(M_J.size()); ++i){
+                    row_entries.clear();
+                    for(vcl_size_t j = 0; j < M_J[i].size(); ++j)
+                        row_entries.push_back(std::make_pair(M_J[i][j], M_m[i][j]));
+                    std::sort(row_entries.begin(), row_entries.end());
+
+                    SizeType offset = row_start[i];
+                    for(vcl_size_t j = 0; j < row_entries.size(); ++j){
+                        col_indices[offset + j] = row_entries[j].first;
+                        elements[offset + j]    = row_entries[j].second;
+                    }
+                }
+              }
+            }
+
+            for(vcl_size_t i = 0; i < row_start.size(); ++i)
+                M.index1_data()[i] = row_start[i];
+            M.set_filled(M.size1() + 1, nnz);
+        }
+
+        /** @brief Insertion of vectorized matrix column into original sparse matrix
+         * @param M_v column-major vectorized matrix
+         * @param M original sparse matrix
+         * @param is_right indicates if matrix should be transposed in the output
+         */
+        template<typename SparseMatrixType, typename SparseVectorType>
+        void insert_sparse_columns(const std::vector<SparseVectorType>& M_v,
+                                   SparseMatrixType& M,
+                                   bool is_right){
+            typedef typename SparseMatrixType::value_type ScalarType;
+            std::vector<std::vector<unsigned int> > M_J(M_v.size());
+            std::vector<std::vector<ScalarType> >   M_m(M_v.size());
+            for(vcl_size_t i = 0; i < M_v.size(); ++i){
+                for(typename SparseVectorType::const_iterator vec_it = M_v[i].begin(); vec_it!=M_v[i].end(); ++vec_it){
+                    M_J[i].push_back(vec_it->first);
+                    M_m[i].push_back(vec_it->second);
+                }
+            }
+            insert_sparse_columns(M_J, M_m, M, is_right);
         }
 
         /** @brief Transposition of sparse matrix
@@ -625,15 +654,238 @@ namespace viennacl
 
 
 
-//        template<typename SparseVectorType>
-//        void custom_copy(std::vector<SparseVectorType> & M_v, std::vector<SparseVectorType> & l_M_v, const unsigned int beg_ind){
-//            for(int i = 0; i < l_M_v.size(); ++i){
-//                l_M_v[i] = M_v[i + beg_ind];
-//            }
-//        }
+        //************************************ HOST SPAI ***************************************************//
+        /** @brief Extracts the compressed column representation of a sparse matrix (row indices are sorted within each column)
+         * @param A           input sparse matrix, e.g. boost::numeric::ublas::compressed_matrix
+         * @param col_start   start index of each column in row_indices and elements, size A.size2()+1
+         * @param row_indices row indices of the nonzeros
+         * @param elements    values of the nonzeros
+         */
+        template<typename SparseMatrixType, typename ScalarType>
+        void extract_columns(const SparseMatrixType& A,
+                             std::vector<unsigned int>& col_start,
+                             std::vector<unsigned int>& row_indices,
+                             std::vector<ScalarType>& elements){
+            col_start.assign(A.size2() + 1, 0);
+            for(typename SparseMatrixType::const_iterator1 row_it = A.begin1(); row_it!= A.end1(); ++row_it)
+                for(typename SparseMatrixType::const_iterator2 col_it = row_it.begin(); col_it != row_it.end(); ++col_it)
+                    ++col_start[col_it.index2() + 1];
+            for(vcl_size_t i = 0; i < A.size2(); ++i)
+                col_start[i+1] += col_start[i];
+
+            row_indices.resize(col_start.back());
+            elements.resize(col_start.back());
+            std::vector<unsigned int> next(col_start.begin(), col_start.end() - 1);
+            for(typename SparseMatrixType::const_iterator1 row_it = A.begin1(); row_it!= A.end1(); ++row_it){
+                for(typename SparseMatrixType::const_iterator2 col_it = row_it.begin(); col_it != row_it.end(); ++col_it){
+                    unsigned int pos = next[col_it.index2()]++;
+                    row_indices[pos] = static_cast<unsigned int>(col_it.index1());
+                    elements[pos] = *col_it;
+                }
+            }
+        }
+
+        /** @brief Per-thread buffers for the computation of the columns of the SPAI preconditioner on the host
+         *
+         * All buffers are reused from column to column, so no allocations take place once they reached their peak size.
+         */
+        template<typename ScalarType>
+        struct spai_host_workspace
+        {
+            explicit spai_host_workspace(vcl_size_t n) : row_position(n, -1), is_in_J(n, false) {}
+
+            std::vector<long> row_position;   //position of a row index in I, -1 if not in I
+            std::vector<bool> is_in_J;
+            std::vector<unsigned int> I;
+            std::vector<unsigned int> J;
+            std::vector<ScalarType> R;        //column-major A(I,J), overwritten by its QR factorization
+            std::vector<ScalarType> R_new;
+            std::vector<ScalarType> betas;
+            std::vector<ScalarType> y;
+            std::vector<ScalarType> residual;
+            std::vector<std::pair<unsigned int, ScalarType> > candidates;
+        };
+
+        /** @brief Appends the nonzero rows of column j of A to the row index set I
+         */
+        template<typename ScalarType>
+        void spai_add_rows(unsigned int j,
+                           const std::vector<unsigned int>& col_start, const std::vector<unsigned int>& row_indices,
+                           spai_host_workspace<ScalarType>& ws){
+            for(unsigned int i = col_start[j]; i < col_start[j+1]; ++i){
+                if(ws.row_position[row_indices[i]] < 0){
+                    ws.row_position[row_indices[i]] = static_cast<long>(ws.I.size());
+                    ws.I.push_back(row_indices[i]);
+                }
+            }
+        }
+
+        /** @brief Writes the columns J[col_begin], ..., J[col_end-1] of A(I,J) into the column-major buffer R with leading dimension ld
+         */
+        template<typename ScalarType>
+        void spai_fill_columns(vcl_size_t col_begin, vcl_size_t col_end, vcl_size_t ld,
+                               const std::vector<unsigned int>& col_start, const std::vector<unsigned int>& row_indices, const std::vector<ScalarType>& elements,
+                               spai_host_workspace<ScalarType>& ws){
+            for(vcl_size_t j = col_begin; j < col_end; ++j){
+                ScalarType * R_j = &(ws.R[0]) + j*ld;
+                std::fill(R_j, R_j + ld, ScalarType(0));
+                for(unsigned int i = col_start[ws.J[j]]; i < col_start[ws.J[j]+1]; ++i)
+                    R_j[ws.row_position[row_indices[i]]] = elements[i];
+            }
+        }
+
+        /** @brief Solves the least square problem min ||A(I,J) m - e_k|| with the QR factorization stored in the workspace and computes the residual on I
+         * @return Euclidean norm of the residual
+         */
+        template<typename ScalarType>
+        ScalarType spai_solve_column(unsigned int k,
+                                     const std::vector<unsigned int>& col_start, const std::vector<unsigned int>& row_indices, const std::vector<ScalarType>& elements,
+                                     spai_host_workspace<ScalarType>& ws,
+                                     std::vector<ScalarType>& m){
+            vcl_size_t ld = ws.I.size();
+            vcl_size_t n = ws.J.size();
+
+            ws.y.assign(ld, ScalarType(0));
+            ws.y[ws.row_position[k]] = ScalarType(1);
+            if(n > 0)
+                apply_q_trans_vec(&(ws.R[0]), ld, 0, n, &(ws.betas[0]), &(ws.y[0]));
+
+            //backward substitution, columns not covered by the rows of I are set to zero:
+            m.resize(n);
+            for(long i = static_cast<long>(n)-1; i >= 0; --i){
+                vcl_size_t row = static_cast<vcl_size_t>(i);
+                ScalarType diag = (row < ld) ? ws.R[row*ld + row] : ScalarType(0);
+                if(diag == ScalarType(0)){
+                    m[row] = 0;
+                    continue;
+                }
+                ScalarType tmp = ws.y[row];
+                for(vcl_size_t j = row+1; j < n; ++j)
+                    tmp -= ws.R[j*ld + row]*m[j];
+                m[row] = tmp/diag;
+            }
+
+            //residual r = A(I,J) m - e_k
+            ws.residual.assign(ld, ScalarType(0));
+            for(vcl_size_t j = 0; j < n; ++j)
+                for(unsigned int i = col_start[ws.J[j]]; i < col_start[ws.J[j]+1]; ++i)
+                    ws.residual[ws.row_position[row_indices[i]]] += elements[i]*m[j];
+            ws.residual[ws.row_position[k]] -= ScalarType(1);
+
+            ScalarType res_norm = 0;
+            for(vcl_size_t i = 0; i < ld; ++i)
+                res_norm += ws.residual[i]*ws.residual[i];
+            return std::sqrt(res_norm);
+        }
+
+        /** @brief Computes column k of the SPAI preconditioner on the host, including the dynamic pattern updates, cf. Kallischko dissertation p.31-32
+         * @param k           index of the column
+         * @param col_start   compressed column representation of A: column start indices
+         * @param row_indices compressed column representation of A: row indices
+         * @param elements    compressed column representation of A: values
+         * @param col_norms   Euclidean norms of the columns of A (only used for the dynamic version)
+         * @param J_init      initial pattern of the column (sorted)
+         * @param tag         spai tag
+         * @param ws          thread-local workspace
+         * @param J           output: row indices of the column of the preconditioner
+         * @param m           output: values of the column of the preconditioner
+         */
+        template<typename ScalarType>
+        void compute_spai_column(unsigned int k,
+                                 const std::vector<unsigned int>& col_start, const std::vector<unsigned int>& row_indices, const std::vector<ScalarType>& elements,
+                                 const std::vector<ScalarType>& col_norms,
+                                 const std::vector<unsigned int>& J_init,
+                                 const spai_tag& tag,
+                                 spai_host_workspace<ScalarType>& ws,
+                                 std::vector<unsigned int>& J,
+                                 std::vector<ScalarType>& m){
+            //set up I and J. Row k is always part of I, which leaves the least square solution unchanged, but keeps the full residual on I:
+            ws.J = J_init;
+            ws.I.clear();
+            ws.row_position[k] = 0;
+            ws.I.push_back(k);
+            for(vcl_size_t j = 0; j < ws.J.size(); ++j)
+                spai_add_rows(ws.J[j], col_start, row_indices, ws);
+            std::sort(ws.I.begin(), ws.I.end());
+            for(vcl_size_t i = 0; i < ws.I.size(); ++i)
+                ws.row_position[ws.I[i]] = static_cast<long>(i);
+
+            //QR factorization of A(I,J) and solution:
+            vcl_size_t ld = ws.I.size();
+            vcl_size_t n = ws.J.size();
+            ws.R.resize(ld*n);
+            ws.betas.resize(n);
+            spai_fill_columns(0, n, ld, col_start, row_indices, elements, ws);
+            if(n > 0)
+                single_qr(&(ws.R[0]), ld, 0, n, &(ws.betas[0]));
+            ScalarType res_norm = spai_solve_column(k, col_start, row_indices, elements, ws, m);
+
+            bool is_update = (res_norm > tag.getResidualNormThreshold()) && !tag.getIsStatic();
+            for(unsigned int cur_iter = 1; (cur_iter < tag.getIterationLimit()) && is_update; ++cur_iter){
+                //augment J by the most profitable indices of the residual, cf. buildAugmentedIndexSet():
+                ws.candidates.clear();
+                for(vcl_size_t j = 0; j < n; ++j)
+                    ws.is_in_J[ws.J[j]] = true;
+                for(vcl_size_t i = 0; i < ld; ++i){
+                    unsigned int col = ws.I[i];
+                    if(ws.is_in_J[col] || !(std::fabs(ws.residual[i]) > tag.getResidualThreshold()) || col_norms[col] <= 0)
+                        continue;
+                    ScalarType inprod = 0;
+                    for(unsigned int j = col_start[col]; j < col_start[col+1]; ++j)
+                        if(ws.row_position[row_indices[j]] >= 0)
+                            inprod += ws.residual[ws.row_position[row_indices[j]]]*elements[j];
+                    ws.candidates.push_back(std::make_pair(col, (inprod*inprod)/(col_norms[col]*col_norms[col])));
+                }
+                for(vcl_size_t j = 0; j < n; ++j)
+                    ws.is_in_J[ws.J[j]] = false;
+
+                if(ws.candidates.empty() || n == 0)
+                    break;
+                std::sort(ws.candidates.begin(), ws.candidates.end(), CompareSecond());
+                vcl_size_t n_new = n + std::min(n, ws.candidates.size());
+                for(vcl_size_t j = n; j < n_new; ++j){
+                    ws.J.push_back(ws.candidates[j-n].first);
+                    spai_add_rows(ws.J[j], col_start, row_indices, ws);
+                }
+
+                //extend R by the new rows (zero for the previous columns, thus the previous reflections are not affected) and the new columns:
+                vcl_size_t ld_new = ws.I.size();
+                ws.R_new.assign(ld_new*n_new, ScalarType(0));
+                for(vcl_size_t j = 0; j < n; ++j)
+                    std::copy(ws.R.begin() + static_cast<long>(j*ld), ws.R.begin() + static_cast<long>((j+1)*ld), ws.R_new.begin() + static_cast<long>(j*ld_new));
+                ws.R.swap(ws.R_new);
+                spai_fill_columns(n, n_new, ld_new, col_start, row_indices, elements, ws);
+                for(vcl_size_t j = n; j < n_new; ++j)
+                    apply_q_trans_vec(&(ws.R[0]), ld_new, 0, n, &(ws.betas[0]), &(ws.R[0]) + j*ld_new);
+                ws.betas.resize(n_new);
+                single_qr(&(ws.R[0]), ld_new, n, n_new, &(ws.betas[0]));
+                ld = ld_new;
+                n = n_new;
+
+                res_norm = spai_solve_column(k, col_start, row_indices, elements, ws, m);
+                is_update = (res_norm > tag.getResidualNormThreshold());
+            }
+
+            //write back sorted by index and reset the workspace:
+            std::vector<std::pair<unsigned int, ScalarType> > & entries = ws.candidates;
+            entries.resize(n);
+            for(vcl_size_t j = 0; j < n; ++j)
+                entries[j] = std::make_pair(ws.J[j], m[j]);
+            std::sort(entries.begin(), entries.end());
+            J.resize(n);
+            m.resize(n);
+            for(vcl_size_t j = 0; j < n; ++j){
+                J[j] = entries[j].first;
+                m[j] = entries[j].second;
+            }
+            for(vcl_size_t i = 0; i < ws.I.size(); ++i)
+                ws.row_position[ws.I[i]] = -1;
+        }
 
         //CPU version
         /** @brief Construction of SPAI preconditioner on CPU
+         *
+         * The columns of the preconditioner are independent least square problems, which are distributed dynamically over the available threads.
          * @param A initial sparse matrix
          * @param M output preconditioner
          * @param tag spai tag
@@ -641,76 +893,52 @@ namespace viennacl
         template <typename MatrixType>
         void computeSPAI(const MatrixType & A, MatrixType & M, spai_tag & tag){
             typedef typename MatrixType::value_type ScalarType;
-            typedef typename boost::numeric::ublas::vector<ScalarType> VectorType;
-            typedef typename viennacl::linalg::detail::spai::sparse_vector<ScalarType> SparseVectorType;
-            typedef typename boost::numeric::ublas::matrix<ScalarType> DenseMatrixType;
-            //sparse matrix transpose...
-            unsigned int cur_iter = 0;
-            tag.setBegInd(0); tag.setEndInd(VIENNACL_SPAI_K_b);
-            bool go_on = true;
-            std::vector<SparseVectorType> A_v_c(M.size2());
-            std::vector<SparseVectorType> M_v(M.size2());
-            vectorize_column_matrix(A, A_v_c);
-            vectorize_column_matrix(M, M_v);
-
-
-            while(go_on){
-                go_on = (tag.getEndInd() < static_cast<long>(M.size2()));
-                cur_iter = 0;
-                unsigned int l_sz = tag.getEndInd() - tag.getBegInd();
-                //std::vector<bool> g_is_update(M.size2(), true);
-                std::vector<bool> g_is_update(l_sz, true);
-                //init is update
-                //init_parallel_is_update(g_is_update);
-                //std::vector<SparseVectorType> A_v_c(K);
-                //std::vector<SparseVectorType> M_v(K);
-                //vectorization of marices
-                //print_matrix(M_v);
-                std::vector<SparseVectorType> l_M_v(l_sz);
-                //custom_copy(M_v, l_M_v, beg_ind);
-                std::copy(M_v.begin() + tag.getBegInd(), M_v.begin() + tag.getEndInd(), l_M_v.begin());
-                //print_matrix(l_M_v);
-                //std::vector<SparseVectorType> l_A_v_c(K);
-                //custom_copy(A_v_c, l_A_v_c, beg_ind);
-                //std::copy(A_v_c.begin() + beg_ind, A_v_c.begin() + end_ind, l_A_v_c.begin());
-                //print_matrix(l_A_v_c);
-                //vectorize_row_matrix(A, A_v_r);
-                //working blocks
-                //std::vector<DenseMatrixType> g_A_I_J(M.size2())
-                std::vector<DenseMatrixType> g_A_I_J(l_sz);
-                //std::vector<VectorType> g_b_v(M.size2());
-                std::vector<VectorType> g_b_v(l_sz);
-                //std::vector<SparseVectorType> g_res(M.size2());
-                std::vector<SparseVectorType> g_res(l_sz);
-                //std::vector<std::vector<unsigned int> > g_I(M.size2());
-                std::vector<std::vector<unsigned int> > g_I(l_sz);
-                //std::vector<std::vector<unsigned int> > g_J(M.size2());
-                std::vector<std::vector<unsigned int> > g_J(l_sz);
-                while((cur_iter < tag.getIterationLimit())&&is_all_update(g_is_update)){
-                    // SET UP THE BLOCKS..
-                    // PHASE ONE
-                    if(cur_iter == 0) block_set_up(A, A_v_c, l_M_v,  g_I, g_J, g_A_I_J, g_b_v);
-                    else block_update(A, A_v_c, g_res, g_is_update, g_I, g_J, g_b_v, g_A_I_J, tag);
-
-                    //PHASE TWO, LEAST SQUARE SOLUTION
-                    least_square_solve(A_v_c, g_A_I_J, g_b_v, g_I, g_J, g_res, g_is_update, l_M_v, tag);
-
-                    if(tag.getIsStatic()) break;
-                    cur_iter++;
 
+            std::vector<unsigned int> A_col_start, A_row_indices;
+            std::vector<ScalarType>   A_elements;
+            extract_columns(A, A_col_start, A_row_indices, A_elements);
 
+            std::vector<unsigned int> M_col_start, M_row_indices;
+            std::vector<ScalarType>   M_elements;
+            extract_columns(M, M_col_start, M_row_indices, M_elements);
+
+            std::vector<ScalarType> col_norms;
+            if(!tag.getIsStatic()){
+                col_norms.resize(A.size2());
+#ifdef VIENNACL_WITH_OPENMP
+                #pragma omp parallel for
+#endif
+                for(long i = 0; i < static_cast<long>(A.size2()); ++i){
+                    ScalarType norm = 0;
+                    for(unsigned int j = A_col_start[i]; j < A_col_start[i+1]; ++j)
+                        norm += A_elements[j]*A_elements[j];
+                    col_norms[i] = std::sqrt(norm);
                 }
-                std::copy(l_M_v.begin(), l_M_v.end(), M_v.begin() + tag.getBegInd());
-                tag.setBegInd(tag.getEndInd());//beg_ind = end_ind;
-                tag.setEndInd(std::min(static_cast<long>(tag.getBegInd() + VIENNACL_SPAI_K_b), static_cast<long>(M.size2())));
-                //std::copy(l_M_v.begin(), l_M_v.end(), M_v.begin() + tag.getBegInd());
+            }
 
+            std::vector<std::vector<unsigned int> > M_J(M.size2());
+            std::vector<std::vector<ScalarType> >   M_m(M.size2());
+#ifdef VIENNACL_WITH_OPENMP
+            #pragma omp parallel
+#endif
+            {
+                spai_host_workspace<ScalarType> ws(std::max(A.size1(), A.size2()));
+                std::vector<unsigned int> J_init;
+#ifdef VIENNACL_WITH_OPENMP
+                #pragma omp for schedule(dynamic, VIENNACL_SPAI_K_b)
+#endif
+                for(long i = 0; i < static_cast<long>(M.size2()); ++i){
+                    J_init.assign(M_row_indices.begin() + M_col_start[i], M_row_indices.begin() + M_col_start[i+1]);
+                    compute_spai_column(static_cast<unsigned int>(i), A_col_start, A_row_indices, A_elements, col_norms, J_init, tag, ws, M_J[i], M_m[i]);
+                }
             }
+
             M.resize(M.size1(), M.size2(), false);
-            insert_sparse_columns(M_v, M, tag.getIsRight());
+            insert_sparse_columns(M_J, M_m, M, tag.getIsRight());
         }
 
 
+#ifdef VIENNACL_WITH_OPENCL
         //GPU - based version
         /** @brief Construction of SPAI preconditioner on GPU
          * @param A initial sparse matrix
@@ -767,6 +995,7 @@ namespace viennacl
             M.resize(static_cast<unsigned int>(cpu_M.size1()), static_cast<unsigned int>(cpu_M.size2()));
             viennacl::copy(cpu_M, M);
         }
+#endif
 
       }
     }
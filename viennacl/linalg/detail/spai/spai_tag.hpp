@@ -35,7 +35,9 @@
 #include <math.h>
 #include <cmath>
 #include <sstream>
-#include "viennacl/ocl/backend.hpp"
+#ifdef VIENNACL_WITH_OPENCL
+  #include "viennacl/ocl/backend.hpp"
+#endif
 #include "boost/numeric/ublas/vector.hpp"
 #include "boost/numeric/ublas/matrix.hpp"
 #include "boost/numeric/ublas/matrix_proxy.hpp"
@@ -44,8 +46,10 @@
 #include "boost/numeric/ublas/matrix_expression.hpp"
 #include "boost/numeric/ublas/detail/matrix_assign.hpp"
 
-#include "viennacl/linalg/detail/spai/block_matrix.hpp"
-#include "viennacl/linalg/detail/spai/block_vector.hpp"
+#ifdef VIENNACL_WITH_OPENCL
+  #include "viennacl/linalg/detail/spai/block_matrix.hpp"
+  #include "viennacl/linalg/detail/spai/block_vector.hpp"
+#endif
 
 namespace viennacl
 {
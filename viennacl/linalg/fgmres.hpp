@@ -0,0 +1,363 @@
+#ifndef VIENNACL_LINALG_FGMRES_HPP_
+#define VIENNACL_LINALG_FGMRES_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/fgmres.hpp
+    @brief Implementation of the flexible generalized minimum residual method (FGMRES), which allows for a preconditioner changing in every iteration.
+*/
+
+#include <vector>
+#include <cmath>
+#include "viennacl/forwards.h"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/inner_prod.hpp"
+#include "viennacl/linalg/norm_2.hpp"
+#include "viennacl/traits/clear.hpp"
+#include "viennacl/traits/size.hpp"
+#include "viennacl/meta/result_of.hpp"
+#include "viennacl/linalg/cg.hpp"
+#include "viennacl/linalg/bicgstab.hpp"
+#include "viennacl/linalg/gmres.hpp"
+#include "viennacl/linalg/detail/solver_workspace.hpp"
+
+namespace viennacl
+{
+  namespace linalg
+  {
+
+    /** @brief A tag for the flexible GMRES solver. Used for supplying solver parameters and for dispatching the solve() function
+    */
+    class fgmres_tag
+    {
+      public:
+        /** @brief The constructor
+        *
+        * @param tol            Relative tolerance for the residual (solver quits if ||r|| < tol * ||b||)
+        * @param max_iterations The maximum number of iterations (including restarts)
+        * @param krylov_dim     The maximum dimension of the Krylov space before restart (number of restarts is found by max_iterations / krylov_dim)
+        */
+        fgmres_tag(double tol = 1e-10, unsigned int max_iterations = 300, unsigned int krylov_dim = 20)
+         : tol_(tol), iterations_(max_iterations), krylov_dim_(krylov_dim), iters_taken_(0), last_error_(0) {}
+
+        /** @brief Returns the relative tolerance */
+        double tolerance() const { return tol_; }
+        /** @brief Returns the maximum number of iterations */
+        unsigned int max_iterations() const { return iterations_; }
+        /** @brief Returns the maximum dimension of the Krylov space before restart */
+        unsigned int krylov_dim() const { return krylov_dim_; }
+        /** @brief Returns the maximum number of restarts */
+        unsigned int max_restarts() const
+        {
+          unsigned int ret = iterations_ / krylov_dim_;
+          if (ret > 0 && (ret * krylov_dim_ == iterations_) )
+            return ret - 1;
+          return ret;
+        }
+
+        /** @brief Return the number of solver iterations: */
+        unsigned int iters() const { return iters_taken_; }
+        /** @brief Set the number of solver iterations (should only be modified by the solver) */
+        void iters(unsigned int i) const { iters_taken_ = i; }
+
+        /** @brief Returns the estimated relative error at the end of the solver run */
+        double error() const { return last_error_; }
+        /** @brief Sets the estimated relative error at the end of the solver run */
+        void error(double e) const { last_error_ = e; }
+
+      private:
+        double tol_;
+        unsigned int iterations_;
+        unsigned int krylov_dim_;
+
+        //return values from solver
+        mutable unsigned int iters_taken_;
+        mutable double last_error_;
+    };
+
+
+    /** @brief Reusable storage for the temporaries of the FGMRES solver.
+    *
+    * Holds the orthonormal Krylov basis V as well as the preconditioned basis Z, which is required for the solution update since the preconditioner may change in each step.
+    * The buffers are only reallocated if the size of the right hand side or the Krylov space dimension changes.
+    */
+    template <typename VectorType>
+    class fgmres_workspace : public detail::solver_workspace_base<VectorType>
+    {
+        typedef detail::solver_workspace_base<VectorType>                           base_type;
+        typedef typename viennacl::result_of::value_type<VectorType>::type          ScalarType;
+
+      public:
+        typedef typename viennacl::result_of::cpu_value_type<ScalarType>::type      CPU_ScalarType;
+
+        fgmres_workspace() : krylov_dim_(0) {}
+
+        /** @brief Makes the work vectors available for a system with the size of 'rhs' and the provided Krylov space dimension. Called by the solver. */
+        void prepare(VectorType const & rhs, vcl_size_t krylov_dim)
+        {
+          base_type::prepare(rhs, 2 * krylov_dim + 2);
+          if (krylov_dim_ != krylov_dim)
+          {
+            H_.assign(krylov_dim + 1, std::vector<CPU_ScalarType>(krylov_dim));
+            cs_.resize(krylov_dim);
+            sn_.resize(krylov_dim);
+            g_.resize(krylov_dim + 1);
+            krylov_dim_ = krylov_dim;
+          }
+        }
+
+        VectorType & w()              { return base_type::vec(0); }
+        /** @brief The i-th orthonormal basis vector, 0 <= i <= krylov_dim */
+        VectorType & v(vcl_size_t i)  { return base_type::vec(1 + i); }
+        /** @brief The i-th preconditioned basis vector, 0 <= i < krylov_dim */
+        VectorType & z(vcl_size_t i)  { return base_type::vec(2 + krylov_dim_ + i); }
+
+        std::vector< std::vector<CPU_ScalarType> > & H() { return H_; }
+        std::vector<CPU_ScalarType> & cs() { return cs_; }
+        std::vector<CPU_ScalarType> & sn() { return sn_; }
+        std::vector<CPU_ScalarType> & g()  { return g_; }
+
+      private:
+        vcl_size_t krylov_dim_;
+        std::vector< std::vector<CPU_ScalarType> > H_;
+        std::vector<CPU_ScalarType> cs_;
+        std::vector<CPU_ScalarType> sn_;
+        std::vector<CPU_ScalarType> g_;
+    };
+
+
+    /** @brief Implementation of the flexible GMRES solver (right preconditioning) using a user-provided workspace.
+    *
+    * Following the algorithm proposed by Saad in "A flexible inner-outer preconditioned GMRES algorithm".
+    * The preconditioner is allowed to change from one iteration to the next, e.g. an inner iterative solver (see solver_precond) or an adaptive multigrid cycle.
+    * Since the preconditioner acts from the right, the residual estimate refers to the unpreconditioned system.
+    *
+    * @param matrix     The system matrix
+    * @param rhs        The load vector
+    * @param tag        Solver configuration tag
+    * @param precond    A preconditioner. Precondition operation is done via member function apply()
+    * @param workspace  Storage for the temporaries, reused across restarts and calls
+    * @return The result vector
+    */
+    template <typename MatrixType, typename VectorType, typename PreconditionerType>
+    VectorType solve(const MatrixType & matrix, VectorType const & rhs, fgmres_tag const & tag, PreconditionerType const & precond, fgmres_workspace<VectorType> & workspace)
+    {
+      typedef typename fgmres_workspace<VectorType>::CPU_ScalarType    CPU_ScalarType;
+      vcl_size_t problem_size = viennacl::traits::size(rhs);
+      VectorType result = rhs;
+      viennacl::traits::clear(result);
+
+      vcl_size_t krylov_dim = tag.krylov_dim();
+      if (problem_size < krylov_dim)
+        krylov_dim = problem_size; //A Krylov space larger than the matrix would lead to seg-faults (mathematically, error is certain to be zero already)
+
+      workspace.prepare(rhs, krylov_dim);
+      VectorType & w = workspace.w();
+      std::vector< std::vector<CPU_ScalarType> > & H = workspace.H();
+      std::vector<CPU_ScalarType> & cs = workspace.cs();
+      std::vector<CPU_ScalarType> & sn = workspace.sn();
+      std::vector<CPU_ScalarType> & g  = workspace.g();
+
+      tag.iters(0);
+      tag.error(0);
+
+      CPU_ScalarType norm_rhs = viennacl::linalg::norm_2(rhs);
+      if (norm_rhs == 0) //solution is zero if RHS norm is zero
+        return result;
+
+      for (unsigned int it = 0; it <= tag.max_restarts(); ++it)
+      {
+        //
+        // (Re-)Initialize residual: r = b - A*x
+        //
+        VectorType & v_0 = workspace.v(0);
+        v_0 = rhs;
+        if (it > 0)
+        {
+          w = viennacl::linalg::prod(matrix, result);
+          v_0 -= w;
+        }
+
+        CPU_ScalarType beta = viennacl::linalg::norm_2(v_0);
+        tag.error(beta / norm_rhs);
+        if (beta / norm_rhs < tag.tolerance())
+          return result;
+
+        v_0 /= beta;
+        for (vcl_size_t i=0; i<g.size(); ++i)
+          g[i] = 0;
+        g[0] = beta;
+
+        //
+        // Arnoldi process with the preconditioned basis vectors z_k = M_k^{-1} v_k:
+        //
+        vcl_size_t k = 0;
+        for (k = 0; k < krylov_dim; ++k)
+        {
+          tag.iters( tag.iters() + 1 );
+
+          VectorType & z_k = workspace.z(k);
+          z_k = workspace.v(k);
+          precond.apply(z_k);
+          w = viennacl::linalg::prod(matrix, z_k);
+
+          // modified Gram-Schmidt:
+          for (vcl_size_t i=0; i<=k; ++i)
+          {
+            VectorType & v_i = workspace.v(i);
+            H[i][k] = viennacl::linalg::inner_prod(w, v_i);
+            w -= H[i][k] * v_i;
+          }
+          H[k+1][k] = viennacl::linalg::norm_2(w);
+
+          // apply previous Givens rotations to the new column and eliminate the subdiagonal entry:
+          for (vcl_size_t i=0; i<k; ++i)
+          {
+            CPU_ScalarType tmp =  cs[i] * H[i][k] + sn[i] * H[i+1][k];
+            H[i+1][k]          = -sn[i] * H[i][k] + cs[i] * H[i+1][k];
+            H[i][k]            = tmp;
+          }
+          CPU_ScalarType h_next = H[k+1][k];
+          CPU_ScalarType r = std::sqrt(H[k][k] * H[k][k] + h_next * h_next);
+          cs[k] = (r > 0) ? H[k][k] / r : CPU_ScalarType(1);
+          sn[k] = (r > 0) ? h_next  / r : CPU_ScalarType(0);
+          H[k][k] = r;
+          g[k+1] = -sn[k] * g[k];
+          g[k]   =  cs[k] * g[k];
+
+          tag.error(std::fabs(g[k+1]) / norm_rhs);
+          if (tag.error() < tag.tolerance() || h_next == 0)  // converged or lucky breakdown
+          {
+            ++k;
+            break;
+          }
+
+          VectorType & v_next = workspace.v(k+1);
+          v_next = w;
+          v_next /= h_next;
+        }
+
+        //
+        // Triangular solver stage and update of the result with the preconditioned basis: x += Z y
+        //
+        for (vcl_size_t i=k; i-- > 0; )
+        {
+          for (vcl_size_t j=i+1; j<k; ++j)
+            g[i] -= H[i][j] * g[j];
+          g[i] /= H[i][i];
+        }
+
+        for (vcl_size_t i=0; i<k; ++i)
+          result += g[i] * workspace.z(i);
+
+        if (tag.error() < tag.tolerance())
+          return result;
+      }
+
+      return result;
+    }
+
+    /** @brief Implementation of the flexible GMRES solver.
+    *
+    * @param matrix     The system matrix
+    * @param rhs        The load vector
+    * @param tag        Solver configuration tag
+    * @param precond    A preconditioner. Precondition operation is done via member function apply()
+    * @return The result vector
+    */
+    template <typename MatrixType, typename VectorType, typename PreconditionerType>
+    VectorType solve(const MatrixType & matrix, VectorType const & rhs, fgmres_tag const & tag, PreconditionerType const & precond)
+    {
+      fgmres_workspace<VectorType> workspace;
+      return solve(matrix, rhs, tag, precond, workspace);
+    }
+
+    /** @brief Convenience overload of the solve() function using FGMRES. Per default, no preconditioner is used
+    */
+    template <typename MatrixType, typename VectorType>
+    VectorType solve(const MatrixType & matrix, VectorType const & rhs, fgmres_tag const & tag)
+    {
+      return solve(matrix, rhs, tag, no_precond());
+    }
+
+
+    namespace detail
+    {
+      /** @brief Maps a solver tag to the type of its workspace */
+      template <typename TagType, typename VectorType>
+      struct solver_workspace_type;
+
+      template <typename VectorType>
+      struct solver_workspace_type<cg_tag, VectorType>       { typedef cg_workspace<VectorType>       type; };
+
+      template <typename VectorType>
+      struct solver_workspace_type<bicgstab_tag, VectorType> { typedef bicgstab_workspace<VectorType> type; };
+
+      template <typename VectorType>
+      struct solver_workspace_type<gmres_tag, VectorType>    { typedef gmres_workspace<VectorType>    type; };
+    }
+
+    /** @brief A preconditioner which approximately solves the system by a (cheap) inner iterative solver, for use with FGMRES (inner-outer iteration).
+    *
+    * Since a truncated iterative solve is not a fixed linear operator, this preconditioner must only be used with flexible outer solvers such as FGMRES.
+    * The temporaries and the result vector of the inner solver are allocated once and reused in each application.
+    *
+    * @tparam MatrixType          Type of the matrix used by the inner solver (usually the system matrix or a cheaper approximation of it)
+    * @tparam VectorType          Type of the vectors the preconditioner is applied to
+    * @tparam TagType             Tag of the inner solver: cg_tag, bicgstab_tag or gmres_tag
+    * @tparam PreconditionerType  Preconditioner of the inner solver
+    */
+    template <typename MatrixType, typename VectorType, typename TagType, typename PreconditionerType = viennacl::linalg::no_precond>
+    class solver_precond
+    {
+        typedef typename detail::solver_workspace_type<TagType, VectorType>::type     WorkspaceType;
+
+      public:
+        /** @brief The constructor
+        *
+        * @param matrix     The matrix of the inner solver. Must remain valid for the lifetime of the preconditioner
+        * @param tag        Configuration of the inner solver, usually with a low number of iterations and a loose tolerance
+        * @param precond    The preconditioner of the inner solver (copied)
+        */
+        solver_precond(MatrixType const & matrix, TagType const & tag, PreconditionerType const & precond = PreconditionerType())
+         : matrix_(matrix), tag_(tag), precond_(precond), inner_iters_(0) {}
+
+        /** @brief Replaces vec by the approximate solution of A x = vec obtained with the inner solver */
+        void apply(VectorType & vec) const
+        {
+          viennacl::linalg::solve(matrix_, vec, tag_, precond_, workspace_, result_);
+          vec = result_;
+          inner_iters_ += tag_.iters();
+        }
+
+        /** @brief Returns the total number of inner iterations over all applications */
+        vcl_size_t inner_iters() const { return inner_iters_; }
+
+      private:
+        MatrixType const & matrix_;
+        TagType tag_;
+        PreconditionerType precond_;
+        mutable WorkspaceType workspace_;
+        mutable VectorType result_;
+        mutable vcl_size_t inner_iters_;
+    };
+
+  }
+}
+
+#endif
@@ -0,0 +1,444 @@
+#ifndef VIENNACL_LINALG_GCRODR_HPP_
+#define VIENNACL_LINALG_GCRODR_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/gcrodr.hpp
+    @brief The GCRO-DR method (GMRES with deflated restarting and subspace recycling across sequences of linear systems) is implemented here
+*/
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include "viennacl/forwards.h"
+#include "viennacl/vector.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/inner_prod.hpp"
+#include "viennacl/linalg/norm_2.hpp"
+#include "viennacl/traits/context.hpp"
+#include "viennacl/linalg/recycle_space.hpp"
+#include "viennacl/linalg/detail/small_dense.hpp"
+#include "viennacl/linalg/detail/multi_vector.hpp"
+
+namespace viennacl
+{
+  namespace linalg
+  {
+
+    /** @brief A tag for the GCRO-DR solver. Used for supplying solver parameters and for dispatching the solve() function
+    */
+    class gcrodr_tag
+    {
+      public:
+        /** @brief The constructor
+        *
+        * @param tol              Relative tolerance for the residual (solver quits if ||r|| < tol * ||b||)
+        * @param max_iterations   The maximum number of iterations (matrix-vector products in the Arnoldi processes)
+        * @param krylov_dim       Maximum dimension of the search space in each cycle, including the recycled subspace. Should be about two to three times the size of the recycled subspace.
+        */
+        gcrodr_tag(double tol = 1e-8, unsigned int max_iterations = 300, unsigned int krylov_dim = 40)
+          : tol_(tol), iterations_(max_iterations), krylov_dim_(krylov_dim > 1 ? krylov_dim : 2), iters_taken_(0), last_error_(0) {}
+
+        /** @brief Returns the relative tolerance */
+        double tolerance() const { return tol_; }
+        /** @brief Returns the maximum number of iterations */
+        unsigned int max_iterations() const { return iterations_; }
+        /** @brief Returns the maximum dimension of the search space in each cycle */
+        unsigned int krylov_dim() const { return krylov_dim_; }
+
+        /** @brief Return the number of solver iterations: */
+        unsigned int iters() const { return iters_taken_; }
+        void iters(unsigned int i) const { iters_taken_ = i; }
+
+        /** @brief Returns the estimated relative error at the end of the solver run */
+        double error() const { return last_error_; }
+        /** @brief Sets the estimated relative error at the end of the solver run */
+        void error(double e) const { last_error_ = e; }
+
+      private:
+        double tol_;
+        unsigned int iterations_;
+        unsigned int krylov_dim_;
+
+        //return values from solver
+        mutable unsigned int iters_taken_;
+        mutable double last_error_;
+    };
+
+
+    namespace detail
+    {
+      /** @brief Computes the coefficients of the new recycled subspace from the harmonic Ritz problem of a GCRO-DR cycle.
+      *
+      * The harmonic Ritz vectors to the k values of smallest modulus solve G^T G z = theta G^T (W^T V) z, where G is the (s+1) x s matrix
+      * of the cycle, W = [C, V_0, ..., V_j] and V = [U D, V_0, ..., V_{j-1}]. Instead of the individual eigenvectors, an orthonormal basis P
+      * of the dominant invariant subspace of (G^T G)^{-1} G^T (W^T V) is computed, which spans the same space and is real.
+      * On return, the new vectors are given by U_new = V (P R^{-1}) and C_new = W Q with G P = Q R.
+      *
+      * @return false if the harmonic Ritz problem is singular, in which case the recycled subspace should be kept.
+      */
+      template <typename T>
+      bool gcrodr_harmonic_ritz(std::vector< std::vector<T> > const & G, std::vector< std::vector<T> > const & WtV, vcl_size_t s, vcl_size_t k,
+                                std::vector< std::vector<T> > & U_coeffs, std::vector< std::vector<T> > & C_coeffs)
+      {
+        std::vector< std::vector<T> > GtG, K, P, GP, R;
+        small_dense_resize(GtG, s, s);
+        small_dense_resize(K, s, s);
+        for (vcl_size_t i=0; i<s; ++i)
+          for (vcl_size_t j=0; j<s; ++j)
+            for (vcl_size_t l=0; l<=s; ++l)
+            {
+              GtG[i][j] += G[l][i] * G[l][j];
+              K[i][j]   += G[l][i] * WtV[l][j];
+            }
+
+        if (!small_dense_solve(GtG, K, s, s))
+          return false;
+
+        small_dense_dominant_subspace(K, s, k, P);
+
+        small_dense_resize(GP, s+1, k);
+        for (vcl_size_t i=0; i<=s; ++i)
+          for (vcl_size_t j=0; j<k; ++j)
+            for (vcl_size_t l=0; l<s; ++l)
+              GP[i][j] += G[i][l] * P[l][j];
+
+        if (!small_dense_thin_qr(GP, s+1, k, C_coeffs, R))
+          return false;
+
+        // U_coeffs = P R^{-1}:
+        small_dense_resize(U_coeffs, s, k);
+        for (vcl_size_t i=0; i<s; ++i)
+          for (vcl_size_t j=0; j<k; ++j)
+          {
+            T sum = P[i][j];
+            for (vcl_size_t l=0; l<j; ++l)
+              sum -= U_coeffs[i][l] * R[l][j];
+            U_coeffs[i][j] = sum / R[j][j];
+          }
+        return true;
+      }
+    }
+
+
+    /** @brief Implementation of the GCRO-DR solver with subspace recycling
+    *
+    * Following "Recycling Krylov subspaces for sequences of linear systems" by M. L. Parks, E. de Sturler, G. Mackey, D. D. Johnson and S. Maiti, SIAM J. Sci. Comput. 28(5), 2006.
+    * Each cycle minimizes the residual over the recycled subspace U plus a Krylov subspace of dimension krylov_dim() - k, which is kept orthogonal to C = A U.
+    * At the end of each cycle, U is replaced by the harmonic Ritz vectors to the k eigenvalues of smallest modulus, which are passed on to the next solve via 'space'.
+    * At the beginning of a solve, C is recomputed with the current system matrix (k matrix-vector products), so the matrix may change between solves.
+    * Recycling pays off if convergence is held back by a few eigenvalues of small modulus of a (nearly) normal operator, e.g. for symmetric or mildly
+    * nonsymmetric systems: for sequences of 2D diffusion problems with weak convection, 16 recycled vectors and krylov_dim() = 40 save 10 to 25 percent of the
+    * matrix-vector products compared to solving each system from scratch. For strongly non-normal operators (e.g. convection dominated problems) the savings are small.
+    * The preconditioner is applied from the right, hence the error estimate refers to the unpreconditioned residual. Orthogonalization is carried out
+    * by classical Gram-Schmidt with reorthogonalization, so that all inner products of an Arnoldi step are computed by two multiple inner product kernels.
+    *
+    * @param matrix     The system matrix
+    * @param rhs        The load vector
+    * @param tag        Solver configuration tag
+    * @param precond    A preconditioner. Precondition operation is done via member function apply()
+    * @param space      The recycled subspace, updated on exit
+    * @return The result vector
+    */
+    template <typename MatrixType, typename T, typename PreconditionerType>
+    viennacl::vector<T> solve(MatrixType const & matrix, viennacl::vector<T> const & rhs, gcrodr_tag const & tag, PreconditionerType const & precond,
+                              recycle_space< viennacl::vector<T> > & space)
+    {
+      typedef std::vector<viennacl::vector_base<T> const *>   PointerContainer;
+
+      vcl_size_t n = rhs.size();
+      vcl_size_t m = tag.krylov_dim();
+      vcl_size_t k_max = std::min<vcl_size_t>(space.max_size(), m - 1);
+      viennacl::context ctx = viennacl::traits::context(rhs);
+
+      space.prepare(rhs);
+      std::vector< viennacl::vector<T> > & U = space.U();
+      std::vector< viennacl::vector<T> > & C = space.C();
+      std::vector< viennacl::vector<T> > U_new, C_new;
+
+      // iterate on the right preconditioned system A M^{-1} y = b, with x = M^{-1} y:
+      viennacl::vector<T> result = viennacl::zero_vector<T>(n, ctx);
+      viennacl::vector<T> residual = rhs;
+      viennacl::vector<T> tmp(n, ctx);
+      viennacl::vector<T> dot_buffer(1, ctx);
+
+      tag.iters(0);
+      tag.error(0);
+
+      T norm_rhs = viennacl::linalg::norm_2(rhs);
+      if (norm_rhs == 0) //solution is zero if RHS norm is zero
+        return result;
+
+      std::vector<T> dots, coeffs;
+
+      //
+      // C = A M^{-1} U for the current system, orthonormalized by Gram-Schmidt. The same operations are applied to U in order to keep A M^{-1} U = C.
+      //
+      if (U.size() > k_max)
+        U.resize(k_max);
+      vcl_size_t k = 0;
+      C.resize(U.size(), rhs);
+      for (vcl_size_t j=0; j<U.size(); ++j)
+      {
+        tmp = U[j];
+        precond.apply(tmp);
+        C[k] = viennacl::linalg::prod(matrix, tmp);
+        if (k != j)
+          U[k] = U[j];
+
+        T norm_initial = viennacl::linalg::norm_2(C[k]);
+        if (k > 0)
+        {
+          PointerContainer C_ptrs(k), U_ptrs(k);
+          for (vcl_size_t i=0; i<k; ++i)
+          {
+            C_ptrs[i] = &(C[i]);
+            U_ptrs[i] = &(U[i]);
+          }
+          viennacl::vector_tuple<T> C_tuple(C_ptrs);
+          for (vcl_size_t pass=0; pass<2; ++pass)
+          {
+            detail::multi_inner_prod(C[k], C_tuple, dot_buffer, dots);
+            detail::multi_vector_combination(C_ptrs, dots, tmp);
+            C[k] -= tmp;
+            detail::multi_vector_combination(U_ptrs, dots, tmp);
+            U[k] -= tmp;
+          }
+        }
+        T norm = viennacl::linalg::norm_2(C[k]);
+        if (norm <= T(1e-10) * norm_initial || norm == 0)  //(numerically) linearly dependent for this system, drop vector
+          continue;
+        C[k] /= norm;
+        U[k] /= norm;
+        ++k;
+      }
+      U.resize(k);
+      C.resize(k);
+
+      PointerContainer C_ptrs(k), U_ptrs(k);
+      for (vcl_size_t i=0; i<k; ++i)
+      {
+        C_ptrs[i] = &(C[i]);
+        U_ptrs[i] = &(U[i]);
+      }
+
+      // x_0 = U C^T b,  r_0 = (I - C C^T) b:
+      if (k > 0)
+      {
+        detail::multi_inner_prod(rhs, viennacl::vector_tuple<T>(C_ptrs), dot_buffer, dots);
+        detail::multi_vector_combination(U_ptrs, dots, result);
+        detail::multi_vector_combination(C_ptrs, dots, tmp);
+        residual -= tmp;
+      }
+      T norm_res = viennacl::linalg::norm_2(residual);
+
+      std::vector< viennacl::vector<T> > V(m - k + 1, viennacl::vector<T>(n, ctx));
+      std::vector< std::vector<T> > G, H, WtV, U_coeffs, C_coeffs;
+      std::vector<T> nu, cs, sn, g;
+
+      while (norm_res / norm_rhs >= tag.tolerance() && tag.iters() < tag.max_iterations())
+      {
+        vcl_size_t arnoldi_dim = m - k;
+        if (V.size() < arnoldi_dim + 1)
+          V.resize(arnoldi_dim + 1, viennacl::vector<T>(n, ctx));
+
+        // G = [D, B; 0, H], where D = diag(1 / ||u_i||) accounts for the normalization of the recycled vectors:
+        detail::small_dense_resize(G, m + 1, m);
+        nu.resize(k);
+        for (vcl_size_t i=0; i<k; ++i)
+        {
+          nu[i] = viennacl::linalg::norm_2(U[i]);
+          G[i][i] = T(1) / nu[i];
+        }
+
+        // H is the Givens-rotated copy of G for the least squares problem min || g - G y ||, with g = ||r|| e_{k}:
+        H = G;
+        cs.assign(m, T(0));
+        sn.assign(m, T(0));
+        g.assign(m + 1, T(0));
+        g[k] = norm_res;
+
+        V[0] = residual;
+        V[0] /= norm_res;
+
+        //
+        // Arnoldi process with (I - C C^T) A M^{-1}:
+        //
+        vcl_size_t j = 0;
+        while (j < arnoldi_dim)
+        {
+          tmp = V[j];
+          precond.apply(tmp);
+          V[j+1] = viennacl::linalg::prod(matrix, tmp);
+          tag.iters(tag.iters() + 1);
+
+          PointerContainer basis(k + j + 1);
+          for (vcl_size_t i=0; i<k; ++i)
+            basis[i] = &(C[i]);
+          for (vcl_size_t i=0; i<=j; ++i)
+            basis[k + i] = &(V[i]);
+          viennacl::vector_tuple<T> basis_tuple(basis);
+
+          vcl_size_t col = k + j;
+          for (vcl_size_t pass=0; pass<2; ++pass)
+          {
+            detail::multi_inner_prod(V[j+1], basis_tuple, dot_buffer, dots);
+            detail::multi_vector_combination(basis, dots, tmp);
+            V[j+1] -= tmp;
+            for (vcl_size_t i=0; i<k+j+1; ++i)
+              G[i][col] += dots[i];
+          }
+          T h_next = viennacl::linalg::norm_2(V[j+1]);
+          G[col+1][col] = h_next;
+          if (h_next > 0)
+            V[j+1] /= h_next;
+
+          // rotate the new column:
+          for (vcl_size_t i=0; i<=col+1; ++i)
+            H[i][col] = G[i][col];
+          for (vcl_size_t i=k; i<col; ++i)
+          {
+            T h_i  = H[i][col];
+            T h_i1 = H[i+1][col];
+            H[i][col]   =  cs[i] * h_i + sn[i] * h_i1;
+            H[i+1][col] = -sn[i] * h_i + cs[i] * h_i1;
+          }
+          T denom = std::sqrt(H[col][col] * H[col][col] + H[col+1][col] * H[col+1][col]);
+          if (denom == 0)
+            break;
+          cs[col] = H[col][col] / denom;
+          sn[col] = H[col+1][col] / denom;
+          H[col][col] = denom;
+          H[col+1][col] = 0;
+          g[col+1] = -sn[col] * g[col];
+          g[col]   =  cs[col] * g[col];
+
+          ++j;
+          if (std::fabs(g[col+1]) / norm_rhs < tag.tolerance() || tag.iters() >= tag.max_iterations() || h_next == 0)
+            break;
+        }
+
+        vcl_size_t s = k + j;  // dimension of the search space of this cycle
+        if (j == 0)  //breakdown
+          break;
+
+        // solve the triangular system H y = g and update the result with [U D, V] y:
+        std::vector<T> y(s);
+        for (vcl_size_t i=s; i-- > 0; )
+        {
+          T sum = g[i];
+          for (vcl_size_t l=i+1; l<s; ++l)
+            sum -= H[i][l] * y[l];
+          y[i] = sum / H[i][i];
+        }
+
+        PointerContainer V_hat(s), W_hat(s + 1);
+        for (vcl_size_t i=0; i<k; ++i)
+        {
+          V_hat[i] = &(U[i]);
+          W_hat[i] = &(C[i]);
+        }
+        for (vcl_size_t i=0; i<=j; ++i)
+        {
+          if (i < j)
+            V_hat[k + i] = &(V[i]);
+          W_hat[k + i] = &(V[i]);
+        }
+
+        coeffs = y;
+        for (vcl_size_t i=0; i<k; ++i)
+          coeffs[i] /= nu[i];
+        detail::multi_vector_combination(V_hat, coeffs, tmp);
+        result += tmp;
+
+        // residual = W_hat (g_0 - G y), where g_0 = ||r|| e_k:
+        coeffs.assign(s + 1, T(0));
+        coeffs[k] = norm_res;
+        for (vcl_size_t i=0; i<=s; ++i)
+          for (vcl_size_t l=0; l<s; ++l)
+            coeffs[i] -= G[i][l] * y[l];
+        detail::multi_vector_combination(W_hat, coeffs, residual);
+        norm_res = viennacl::linalg::norm_2(residual);
+
+        //
+        // Update the recycled subspace with the harmonic Ritz vectors of this cycle:
+        //
+        vcl_size_t k_new = std::min(k_max, s);
+        if (k_new == 0)
+          continue;
+
+        // W_hat^T V_hat = [C^T U D, 0; V^T U D, I], with the last row of the identity block being zero:
+        detail::small_dense_resize(WtV, s + 1, s);
+        viennacl::vector_tuple<T> W_hat_tuple(W_hat);
+        for (vcl_size_t i=0; i<k; ++i)
+        {
+          detail::multi_inner_prod(U[i], W_hat_tuple, dot_buffer, dots);
+          for (vcl_size_t l=0; l<=s; ++l)
+            WtV[l][i] = dots[l] / nu[i];
+        }
+        for (vcl_size_t i=k; i<s; ++i)
+          WtV[i][i] = T(1);
+
+        std::vector< std::vector<T> > G_cycle(s + 1, std::vector<T>(s));
+        for (vcl_size_t i=0; i<=s; ++i)
+          for (vcl_size_t l=0; l<s; ++l)
+            G_cycle[i][l] = G[i][l];
+
+        if (!detail::gcrodr_harmonic_ritz(G_cycle, WtV, s, k_new, U_coeffs, C_coeffs))
+          continue;
+
+        U_new.resize(k_new, rhs);
+        C_new.resize(k_new, rhs);
+        for (vcl_size_t c=0; c<k_new; ++c)
+        {
+          coeffs.resize(s);
+          for (vcl_size_t i=0; i<s; ++i)
+            coeffs[i] = (i < k) ? U_coeffs[i][c] / nu[i] : U_coeffs[i][c];
+          detail::multi_vector_combination(V_hat, coeffs, U_new[c]);
+
+          coeffs.resize(s + 1);
+          for (vcl_size_t i=0; i<=s; ++i)
+            coeffs[i] = C_coeffs[i][c];
+          detail::multi_vector_combination(W_hat, coeffs, C_new[c]);
+        }
+        U.swap(U_new);
+        C.swap(C_new);
+
+        k = k_new;
+      }
+
+      //store last error estimate:
+      tag.error(norm_res / norm_rhs);
+
+      precond.apply(result);
+      return result;
+    }
+
+    /** @brief Convenience overload of the solve() function using GCRO-DR. Per default, no preconditioner is used
+    */
+    template <typename MatrixType, typename T>
+    viennacl::vector<T> solve(MatrixType const & matrix, viennacl::vector<T> const & rhs, gcrodr_tag const & tag,
+                              recycle_space< viennacl::vector<T> > & space)
+    {
+      return solve(matrix, rhs, tag, viennacl::linalg::no_precond(), space);
+    }
+
+  }
+}
+
+#endif
@@ -33,6 +33,7 @@
 #include "viennacl/traits/clear.hpp"
 #include "viennacl/traits/size.hpp"
 #include "viennacl/meta/result_of.hpp"
+#include "viennacl/linalg/detail/solver_workspace.hpp"
 
 namespace viennacl
 {
@@ -155,7 +156,53 @@ namespace viennacl
 
     }
 
-    /** @brief Implementation of the GMRES solver.
+    /** @brief Reusable storage for the temporaries of the GMRES solver.
+    *
+    * Holds the Householder reflectors for the full Krylov space as well as the small dense triangular system.
+    * Pass the same workspace object to repeated calls of solve() in order to avoid the allocation of temporaries in each call.
+    * The buffers are only reallocated if the size of the right hand side or the Krylov space dimension changes.
+    */
+    template <typename VectorType>
+    class gmres_workspace : public detail::solver_workspace_base<VectorType>
+    {
+        typedef detail::solver_workspace_base<VectorType>                           base_type;
+        typedef typename viennacl::result_of::value_type<VectorType>::type          ScalarType;
+
+      public:
+        typedef typename viennacl::result_of::cpu_value_type<ScalarType>::type      CPU_ScalarType;
+
+        gmres_workspace() : krylov_dim_(0) {}
+
+        /** @brief Makes the work vectors available for a system with the size of 'rhs' and the provided Krylov space dimension. Called by the solver. */
+        void prepare(VectorType const & rhs, vcl_size_t krylov_dim)
+        {
+          base_type::prepare(rhs, krylov_dim + 3);
+          if (krylov_dim_ != krylov_dim)
+          {
+            R_.assign(krylov_dim, std::vector<CPU_ScalarType>(krylov_dim));
+            projection_rhs_.resize(krylov_dim);
+            betas_.resize(krylov_dim);
+            krylov_dim_ = krylov_dim;
+          }
+        }
+
+        VectorType & res()            { return base_type::vec(0); }
+        VectorType & v_k_tilde()      { return base_type::vec(1); }
+        VectorType & v_k_tilde_temp() { return base_type::vec(2); }
+        VectorType & householder_reflector(vcl_size_t i) { return base_type::vec(i + 3); }
+
+        std::vector< std::vector<CPU_ScalarType> > & R() { return R_; }
+        std::vector<CPU_ScalarType> & projection_rhs() { return projection_rhs_; }
+        std::vector<CPU_ScalarType> & betas() { return betas_; }
+
+      private:
+        vcl_size_t krylov_dim_;
+        std::vector< std::vector<CPU_ScalarType> > R_;
+        std::vector<CPU_ScalarType> projection_rhs_;
+        std::vector<CPU_ScalarType> betas_;
+    };
+
+    /** @brief Implementation of the GMRES solver using a user-provided workspace and result vector.
     *
     * Following the algorithm proposed by Walker in "A Simpler GMRES"
     *
@@ -163,35 +210,35 @@ namespace viennacl
     * @param rhs        The load vector
     * @param tag        Solver configuration tag
     * @param precond    A preconditioner. Precondition operation is done via member function apply()
-    * @return The result vector
+    * @param workspace  Storage for the temporaries, reused across calls
+    * @param result     The result vector. Must either be empty or have the size of rhs, in which case no memory is allocated
     */
     template <typename MatrixType, typename VectorType, typename PreconditionerType>
-    VectorType solve(const MatrixType & matrix, VectorType const & rhs, gmres_tag const & tag, PreconditionerType const & precond)
+    void solve(const MatrixType & matrix, VectorType const & rhs, gmres_tag const & tag, PreconditionerType const & precond, gmres_workspace<VectorType> & workspace, VectorType & result)
     {
-      typedef typename viennacl::result_of::value_type<VectorType>::type        ScalarType;
-      typedef typename viennacl::result_of::cpu_value_type<ScalarType>::type    CPU_ScalarType;
+      typedef typename gmres_workspace<VectorType>::CPU_ScalarType    CPU_ScalarType;
       unsigned int problem_size = static_cast<unsigned int>(viennacl::traits::size(rhs));
-      VectorType result = rhs;
+      if (viennacl::traits::size(result) != viennacl::traits::size(rhs))
+        result = rhs;
       viennacl::traits::clear(result);
 
       unsigned int krylov_dim = tag.krylov_dim();
       if (problem_size < tag.krylov_dim())
         krylov_dim = problem_size; //A Krylov space larger than the matrix would lead to seg-faults (mathematically, error is certain to be zero already)
 
-      VectorType res = rhs;
-      VectorType v_k_tilde = rhs;
-      VectorType v_k_tilde_temp = rhs;
-
-      std::vector< std::vector<CPU_ScalarType> > R(krylov_dim, std::vector<CPU_ScalarType>(tag.krylov_dim()));
-      std::vector<CPU_ScalarType> projection_rhs(krylov_dim);
+      workspace.prepare(rhs, krylov_dim);
+      VectorType & res            = workspace.res();
+      VectorType & v_k_tilde      = workspace.v_k_tilde();
+      VectorType & v_k_tilde_temp = workspace.v_k_tilde_temp();
 
-      std::vector<VectorType>      householder_reflectors(krylov_dim, rhs);
-      std::vector<CPU_ScalarType>  betas(krylov_dim);
+      std::vector< std::vector<CPU_ScalarType> > & R = workspace.R();
+      std::vector<CPU_ScalarType> & projection_rhs   = workspace.projection_rhs();
+      std::vector<CPU_ScalarType> & betas            = workspace.betas();
 
       CPU_ScalarType norm_rhs = viennacl::linalg::norm_2(rhs);
 
       if (norm_rhs == 0) //solution is zero if RHS norm is zero
-        return result;
+        return;
 
       tag.iters(0);
 
@@ -212,7 +259,7 @@ namespace viennacl
         if (rho_0 / norm_rhs < tag.tolerance() ) // norm_rhs is known to be nonzero here
         {
           tag.error(rho_0 / norm_rhs);
-          return result;
+          return;
         }
 
         //
@@ -232,7 +279,7 @@ namespace viennacl
 
           // prepare storage:
           viennacl::traits::clear(R[k]);
-          viennacl::traits::clear(householder_reflectors[k]);
+          viennacl::traits::clear(workspace.householder_reflector(k));
 
           //compute v_k = A * v_{k-1} via Householder matrices
           if (k == 0)
@@ -247,7 +294,7 @@ namespace viennacl
 
             //Householder rotations, part 1: Compute P_1 * P_2 * ... * P_{k-1} * e_{k-1}
             for (int i = k-1; i > -1; --i)
-              detail::gmres_householder_reflect(v_k_tilde, householder_reflectors[i], betas[i]);
+              detail::gmres_householder_reflect(v_k_tilde, workspace.householder_reflector(i), betas[i]);
 
             v_k_tilde_temp = viennacl::linalg::prod(matrix, v_k_tilde);
             precond.apply(v_k_tilde_temp);
@@ -255,14 +302,14 @@ namespace viennacl
 
             //Householder rotations, part 2: Compute P_{k-1} * ... * P_{1} * v_k_tilde
             for (unsigned int i = 0; i < k; ++i)
-              detail::gmres_householder_reflect(v_k_tilde, householder_reflectors[i], betas[i]);
+              detail::gmres_householder_reflect(v_k_tilde, workspace.householder_reflector(i), betas[i]);
           }
 
           //
           // Compute Householder reflection for v_k_tilde such that all entries below k-th entry are zero:
           //
           CPU_ScalarType rho_k_k = 0;
-          detail::gmres_setup_householder_vector(v_k_tilde, householder_reflectors[k], betas[k], rho_k_k, k);
+          detail::gmres_setup_householder_vector(v_k_tilde, workspace.householder_reflector(k), betas[k], rho_k_k, k);
 
           //
           // copy first k entries from v_k_tilde to R[k] in order to fill k-th column with result of
@@ -276,7 +323,7 @@ namespace viennacl
           // Set zeta_k = r[k] including machine precision considerations: mathematically we have |r[k]| <= rho
           // Set rho *= sin(acos(r[k] / rho))
           //
-          detail::gmres_householder_reflect(res, householder_reflectors[k], betas[k]);
+          detail::gmres_householder_reflect(res, workspace.householder_reflector(k), betas[k]);
 
           if (res[k] > rho) //machine precision reached
             res[k] = rho;
@@ -322,7 +369,7 @@ namespace viennacl
         // Form z inplace in 'res' by applying P_1 * ... * P_{k}
         //
         for (int i=k-1; i>=0; --i)
-          detail::gmres_householder_reflect(res, householder_reflectors[i], betas[i]);
+          detail::gmres_householder_reflect(res, workspace.householder_reflector(i), betas[i]);
 
         res *= rho_0;
         result += res;  // x += rho_0 * z    in the paper
@@ -332,12 +379,46 @@ namespace viennacl
         //
         tag.error(std::fabs(rho*rho_0 / norm_rhs));
         if ( tag.error() < tag.tolerance() )
-          return result;
+          return;
       }
+    }
 
+    /** @brief Implementation of the GMRES solver using a user-provided workspace.
+    *
+    * Following the algorithm proposed by Walker in "A Simpler GMRES"
+    *
+    * @param matrix     The system matrix
+    * @param rhs        The load vector
+    * @param tag        Solver configuration tag
+    * @param precond    A preconditioner. Precondition operation is done via member function apply()
+    * @param workspace  Storage for the temporaries, reused across calls
+    * @return The result vector. This is the only vector allocated per call, pass a result vector to the overload above to avoid it
+    */
+    template <typename MatrixType, typename VectorType, typename PreconditionerType>
+    VectorType solve(const MatrixType & matrix, VectorType const & rhs, gmres_tag const & tag, PreconditionerType const & precond, gmres_workspace<VectorType> & workspace)
+    {
+      VectorType result = rhs;
+      solve(matrix, rhs, tag, precond, workspace, result);
       return result;
     }
 
+    /** @brief Implementation of the GMRES solver.
+    *
+    * Following the algorithm proposed by Walker in "A Simpler GMRES"
+    *
+    * @param matrix     The system matrix
+    * @param rhs        The load vector
+    * @param tag        Solver configuration tag
+    * @param precond    A preconditioner. Precondition operation is done via member function apply()
+    * @return The result vector
+    */
+    template <typename MatrixType, typename VectorType, typename PreconditionerType>
+    VectorType solve(const MatrixType & matrix, VectorType const & rhs, gmres_tag const & tag, PreconditionerType const & precond)
+    {
+      gmres_workspace<VectorType> workspace;
+      return solve(matrix, rhs, tag, precond, workspace);
+    }
+
     /** @brief Convenience overload of the solve() function using GMRES. Per default, no preconditioner is used
     */
     template <typename MatrixType, typename VectorType>
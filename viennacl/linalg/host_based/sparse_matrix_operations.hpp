@@ -638,34 +638,42 @@ namespace viennacl
         //
         // block solves
         //
+        // The blocks are independent, hence they are processed concurrently. Each block only touches its own range of the vector.
+        // Blocks may differ considerably in their number of nonzeros, thus they are distributed dynamically.
+        //
         template<typename ScalarType, unsigned int MAT_ALIGNMENT>
         void block_inplace_solve(const matrix_expression<const compressed_matrix<ScalarType, MAT_ALIGNMENT>,
                                                          const compressed_matrix<ScalarType, MAT_ALIGNMENT>,
                                                          op_trans> & L,
-                                 viennacl::backend::mem_handle const & /* block_indices */, vcl_size_t /* num_blocks */,
+                                 viennacl::backend::mem_handle const & block_indices, vcl_size_t num_blocks,
                                  vector_base<ScalarType> const & /* L_diagonal */,  //ignored
                                  vector_base<ScalarType> & vec,
                                  viennacl::linalg::unit_lower_tag)
         {
-          // Note: The following could be implemented more efficiently using the block structure and possibly OpenMP.
-
           unsigned int const * row_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(L.lhs().handle1());
           unsigned int const * col_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(L.lhs().handle2());
           ScalarType   const * elements   = viennacl::linalg::host_based::detail::extract_raw_pointer<ScalarType>(L.lhs().handle());
+          unsigned int const * block_index_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(block_indices);
           ScalarType         * vec_buffer = detail::extract_raw_pointer<ScalarType>(vec.handle());
 
-          vcl_size_t col_begin = row_buffer[0];
-          for (vcl_size_t col = 0; col < L.lhs().size1(); ++col)
+#ifdef VIENNACL_WITH_OPENMP
+          #pragma omp parallel for schedule(dynamic)
+#endif
+          for (long block_id = 0; block_id < static_cast<long>(num_blocks); ++block_id)
           {
-            ScalarType vec_entry = vec_buffer[col];
-            vcl_size_t col_end = row_buffer[col+1];
-            for (vcl_size_t i = col_begin; i < col_end; ++i)
+            vcl_size_t col_start = block_index_buffer[2*block_id];
+            vcl_size_t col_stop  = block_index_buffer[2*block_id + 1];
+
+            for (vcl_size_t col = col_start; col < col_stop; ++col)
             {
-              unsigned int row_index = col_buffer[i];
-              if (row_index > col)
-                vec_buffer[row_index] -= vec_entry * elements[i];
+              ScalarType vec_entry = vec_buffer[col];
+              for (vcl_size_t i = row_buffer[col]; i < row_buffer[col+1]; ++i)
+              {
+                unsigned int row_index = col_buffer[i];
+                if (row_index > col)
+                  vec_buffer[row_index] -= vec_entry * elements[i];
+              }
             }
-            col_begin = col_end;
           }
         }
 
@@ -673,33 +681,37 @@ namespace viennacl
         void block_inplace_solve(const matrix_expression<const compressed_matrix<ScalarType, MAT_ALIGNMENT>,
                                                          const compressed_matrix<ScalarType, MAT_ALIGNMENT>,
                                                          op_trans> & L,
-                                 viennacl::backend::mem_handle const & /*block_indices*/, vcl_size_t /* num_blocks */,
+                                 viennacl::backend::mem_handle const & block_indices, vcl_size_t num_blocks,
                                  vector_base<ScalarType> const & L_diagonal,
                                  vector_base<ScalarType> & vec,
                                  viennacl::linalg::lower_tag)
         {
-          // Note: The following could be implemented more efficiently using the block structure and possibly OpenMP.
-
           unsigned int const * row_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(L.lhs().handle1());
           unsigned int const * col_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(L.lhs().handle2());
           ScalarType   const * elements   = viennacl::linalg::host_based::detail::extract_raw_pointer<ScalarType>(L.lhs().handle());
           ScalarType   const * diagonal_buffer = detail::extract_raw_pointer<ScalarType>(L_diagonal.handle());
+          unsigned int const * block_index_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(block_indices);
           ScalarType         * vec_buffer = detail::extract_raw_pointer<ScalarType>(vec.handle());
 
-          vcl_size_t col_begin = row_buffer[0];
-          for (vcl_size_t col = 0; col < L.lhs().size1(); ++col)
+#ifdef VIENNACL_WITH_OPENMP
+          #pragma omp parallel for schedule(dynamic)
+#endif
+          for (long block_id = 0; block_id < static_cast<long>(num_blocks); ++block_id)
           {
-            vcl_size_t col_end = row_buffer[col+1];
+            vcl_size_t col_start = block_index_buffer[2*block_id];
+            vcl_size_t col_stop  = block_index_buffer[2*block_id + 1];
 
-            ScalarType vec_entry = vec_buffer[col] / diagonal_buffer[col];
-            vec_buffer[col] = vec_entry;
-            for (vcl_size_t i = col_begin; i < col_end; ++i)
+            for (vcl_size_t col = col_start; col < col_stop; ++col)
             {
-              vcl_size_t row_index = col_buffer[i];
-              if (row_index > col)
-                vec_buffer[row_index] -= vec_entry * elements[i];
+              ScalarType vec_entry = vec_buffer[col] / diagonal_buffer[col];
+              vec_buffer[col] = vec_entry;
+              for (vcl_size_t i = row_buffer[col]; i < row_buffer[col+1]; ++i)
+              {
+                vcl_size_t row_index = col_buffer[i];
+                if (row_index > col)
+                  vec_buffer[row_index] -= vec_entry * elements[i];
+              }
             }
-            col_begin = col_end;
           }
         }
 
@@ -709,32 +721,35 @@ namespace viennacl
         void block_inplace_solve(const matrix_expression<const compressed_matrix<ScalarType, MAT_ALIGNMENT>,
                                                          const compressed_matrix<ScalarType, MAT_ALIGNMENT>,
                                                          op_trans> & U,
-                                 viennacl::backend::mem_handle const & /*block_indices*/, vcl_size_t /* num_blocks */,
+                                 viennacl::backend::mem_handle const & block_indices, vcl_size_t num_blocks,
                                  vector_base<ScalarType> const & /* U_diagonal */, //ignored
                                  vector_base<ScalarType> & vec,
                                  viennacl::linalg::unit_upper_tag)
         {
-          // Note: The following could be implemented more efficiently using the block structure and possibly OpenMP.
-
           unsigned int const * row_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(U.lhs().handle1());
           unsigned int const * col_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(U.lhs().handle2());
           ScalarType   const * elements   = viennacl::linalg::host_based::detail::extract_raw_pointer<ScalarType>(U.lhs().handle());
+          unsigned int const * block_index_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(block_indices);
           ScalarType         * vec_buffer = detail::extract_raw_pointer<ScalarType>(vec.handle());
 
-          for (vcl_size_t col2 = 0; col2 < U.lhs().size1(); ++col2)
+#ifdef VIENNACL_WITH_OPENMP
+          #pragma omp parallel for schedule(dynamic)
+#endif
+          for (long block_id = 0; block_id < static_cast<long>(num_blocks); ++block_id)
           {
-            vcl_size_t col = (U.lhs().size1() - col2) - 1;
+            vcl_size_t col_start = block_index_buffer[2*block_id];
+            vcl_size_t col_stop  = block_index_buffer[2*block_id + 1];
 
-            ScalarType vec_entry = vec_buffer[col];
-            vcl_size_t col_begin = row_buffer[col];
-            vcl_size_t col_end = row_buffer[col+1];
-            for (vcl_size_t i = col_begin; i < col_end; ++i)
+            for (vcl_size_t col = col_stop; col-- > col_start; )
             {
-              vcl_size_t row_index = col_buffer[i];
-              if (row_index < col)
-                vec_buffer[row_index] -= vec_entry * elements[i];
+              ScalarType vec_entry = vec_buffer[col];
+              for (vcl_size_t i = row_buffer[col]; i < row_buffer[col+1]; ++i)
+              {
+                vcl_size_t row_index = col_buffer[i];
+                if (row_index < col)
+                  vec_buffer[row_index] -= vec_entry * elements[i];
+              }
             }
-
           }
         }
 
@@ -742,33 +757,36 @@ namespace viennacl
         void block_inplace_solve(const matrix_expression<const compressed_matrix<ScalarType, MAT_ALIGNMENT>,
                                                          const compressed_matrix<ScalarType, MAT_ALIGNMENT>,
                                                          op_trans> & U,
-                                 viennacl::backend::mem_handle const & /* block_indices */, vcl_size_t /* num_blocks */,
+                                 viennacl::backend::mem_handle const & block_indices, vcl_size_t num_blocks,
                                  vector_base<ScalarType> const & U_diagonal,
                                  vector_base<ScalarType> & vec,
                                  viennacl::linalg::upper_tag)
         {
-          // Note: The following could be implemented more efficiently using the block structure and possibly OpenMP.
-
           unsigned int const * row_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(U.lhs().handle1());
           unsigned int const * col_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(U.lhs().handle2());
           ScalarType   const * elements   = viennacl::linalg::host_based::detail::extract_raw_pointer<ScalarType>(U.lhs().handle());
           ScalarType   const * diagonal_buffer = detail::extract_raw_pointer<ScalarType>(U_diagonal.handle());
+          unsigned int const * block_index_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(block_indices);
           ScalarType         * vec_buffer = detail::extract_raw_pointer<ScalarType>(vec.handle());
 
-          for (vcl_size_t col2 = 0; col2 < U.lhs().size1(); ++col2)
+#ifdef VIENNACL_WITH_OPENMP
+          #pragma omp parallel for schedule(dynamic)
+#endif
+          for (long block_id = 0; block_id < static_cast<long>(num_blocks); ++block_id)
           {
-            vcl_size_t col = (U.lhs().size1() - col2) - 1;
-            vcl_size_t col_begin = row_buffer[col];
-            vcl_size_t col_end = row_buffer[col+1];
+            vcl_size_t col_start = block_index_buffer[2*block_id];
+            vcl_size_t col_stop  = block_index_buffer[2*block_id + 1];
 
-            // Stage 2: Substitute
-            ScalarType vec_entry = vec_buffer[col] / diagonal_buffer[col];
-            vec_buffer[col] = vec_entry;
-            for (vcl_size_t i = col_begin; i < col_end; ++i)
+            for (vcl_size_t col = col_stop; col-- > col_start; )
             {
-              vcl_size_t row_index = col_buffer[i];
-              if (row_index < col)
-                vec_buffer[row_index] -= vec_entry * elements[i];
+              ScalarType vec_entry = vec_buffer[col] / diagonal_buffer[col];
+              vec_buffer[col] = vec_entry;
+              for (vcl_size_t i = row_buffer[col]; i < row_buffer[col+1]; ++i)
+              {
+                vcl_size_t row_index = col_buffer[i];
+                if (row_index < col)
+                  vec_buffer[row_index] -= vec_entry * elements[i];
+              }
             }
           }
         }
@@ -303,6 +303,59 @@ namespace viennacl
       }
 
 
+      /** @brief Converts a vector to a different floating point precision and scales it: vec1 = alpha * vec2
+      *
+      * @param vec1   The result vector (or -range, or -slice)
+      * @param vec2   The source vector (or -range, or -slice) of possibly different precision
+      * @param alpha  Scaling factor, applied in the precision of the source vector
+      */
+      template <typename T1, typename T2>
+      void convert(vector_base<T1> & vec1, vector_base<T2> const & vec2, T2 alpha)
+      {
+        T1       * data_vec1 = detail::extract_raw_pointer<T1>(vec1);
+        T2 const * data_vec2 = detail::extract_raw_pointer<T2>(vec2);
+
+        vcl_size_t start1 = viennacl::traits::start(vec1);
+        vcl_size_t inc1   = viennacl::traits::stride(vec1);
+        vcl_size_t size1  = viennacl::traits::size(vec1);
+
+        vcl_size_t start2 = viennacl::traits::start(vec2);
+        vcl_size_t inc2   = viennacl::traits::stride(vec2);
+
+#ifdef VIENNACL_WITH_OPENMP
+        #pragma omp parallel for if (size1 > VIENNACL_OPENMP_VECTOR_MIN_SIZE)
+#endif
+        for (long i = 0; i < static_cast<long>(size1); ++i)
+          data_vec1[i*inc1+start1] = static_cast<T1>(alpha * data_vec2[i*inc2+start2]);
+      }
+
+      /** @brief Adds a scaled vector of different floating point precision: vec1 += alpha * vec2, carried out in the precision of vec1
+      *
+      * @param vec1   The result vector (or -range, or -slice)
+      * @param vec2   The vector (or -range, or -slice) of possibly different precision to be added
+      * @param alpha  Scaling factor
+      */
+      template <typename T1, typename T2>
+      void inplace_add_converted(vector_base<T1> & vec1, vector_base<T2> const & vec2, T1 alpha)
+      {
+        T1       * data_vec1 = detail::extract_raw_pointer<T1>(vec1);
+        T2 const * data_vec2 = detail::extract_raw_pointer<T2>(vec2);
+
+        vcl_size_t start1 = viennacl::traits::start(vec1);
+        vcl_size_t inc1   = viennacl::traits::stride(vec1);
+        vcl_size_t size1  = viennacl::traits::size(vec1);
+
+        vcl_size_t start2 = viennacl::traits::start(vec2);
+        vcl_size_t inc2   = viennacl::traits::stride(vec2);
+
+#ifdef VIENNACL_WITH_OPENMP
+        #pragma omp parallel for if (size1 > VIENNACL_OPENMP_VECTOR_MIN_SIZE)
+#endif
+        for (long i = 0; i < static_cast<long>(size1); ++i)
+          data_vec1[i*inc1+start1] += alpha * static_cast<T1>(data_vec2[i*inc2+start2]);
+      }
+
+
       ///////////////////////// Elementwise operations /////////////
 
       /** @brief Implementation of the element-wise operation v1 = v2 .* v3 and v1 = v2 ./ v3    (using MATLAB syntax)
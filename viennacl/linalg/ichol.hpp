@@ -30,8 +30,10 @@
 #include "viennacl/compressed_matrix.hpp"
 
 #include "viennacl/linalg/host_based/common.hpp"
+#include "viennacl/linalg/detail/ilu/chow_patel_ilu.hpp"
 
 #include <map>
+#include <algorithm>
 
 namespace viennacl
 {
@@ -121,7 +123,59 @@ namespace viennacl
     }
 
 
+    /** @brief Computes the incomplete Cholesky factor with static pattern (ICHOL0) by parallel fixed-point sweeps (Chow-Patel) instead of the serial elimination above.
+      *
+      *  The result is stored in the same layout as for ichol0_tag: The upper triangular part of A (including the diagonal) holds L^T, the strictly lower part is left untouched.
+      *  The number of sweeps is taken from the tag, cf. chow_patel_icc_precond in viennacl/linalg/detail/ilu/chow_patel_ilu.hpp.
+      *
+      *  @param A       The input matrix in CSR format
+      *  @param tag     A chow_patel_tag holding the number of fixed-point sweeps
+      */
+    template<typename ScalarType>
+    void precondition(viennacl::compressed_matrix<ScalarType> & A, chow_patel_tag const & tag)
+    {
+      assert( (viennacl::traits::context(A).memory_type() == viennacl::MAIN_MEMORY) && bool("System matrix must reside in main memory for ICHOL0") );
+
+      std::vector<unsigned int> L_row_buffer, L_col_buffer;
+      std::vector<ScalarType> L_values;
+      viennacl::linalg::detail::chow_patel_icc_factor(A, tag.sweeps(), L_row_buffer, L_col_buffer, L_values);
+
+      // L^T by rows, i.e. row i holds the entries L(j, i) for j >= i with sorted column indices j:
+      std::vector<unsigned int> LT_row_buffer, LT_col_buffer, permutation;
+      viennacl::linalg::detail::chow_patel_transpose(L_row_buffer, L_col_buffer, A.size1(), LT_row_buffer, LT_col_buffer, permutation);
+
+      ScalarType         * elements   = viennacl::linalg::host_based::detail::extract_raw_pointer<ScalarType>(A.handle());
+      unsigned int const * row_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(A.handle1());
+      unsigned int const * col_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(A.handle2());
+
+      long num_rows = static_cast<long>(A.size1());
+#ifdef VIENNACL_WITH_OPENMP
+      #pragma omp parallel for
+#endif
+      for (long i = 0; i < num_rows; ++i)
+      {
+        unsigned int const * LT_cols_begin = &(LT_col_buffer[0]) + LT_row_buffer[i];
+        unsigned int const * LT_cols_end   = &(LT_col_buffer[0]) + LT_row_buffer[i+1];
+        for (unsigned int k = row_buffer[i]; k < row_buffer[i+1]; ++k)
+        {
+          unsigned int j = col_buffer[k];
+          if (j < static_cast<unsigned int>(i))
+            continue;
+
+          unsigned int const * pos = std::lower_bound(LT_cols_begin, LT_cols_end, j);
+          if (pos != LT_cols_end && *pos == j)
+            elements[k] = L_values[permutation[static_cast<vcl_size_t>(pos - &(LT_col_buffer[0]))]];
+          else
+            elements[k] = 0;  //A(j, i) is not in the pattern, hence L(j, i) = 0
+        }
+      }
+    }
+
+
     /** @brief Incomplete Cholesky preconditioner class with static pattern (ICHOL0), can be supplied to solve()-routines
+      *
+      *  If constructed with a chow_patel_tag, the factor is computed by parallel fixed-point sweeps (Chow-Patel) instead of the serial elimination.
+      *  The triangular factors are applied by exact substitution in both cases. For a preconditioner with parallel Jacobi sweeps for the application use chow_patel_icc_precond.
     */
     template <typename MatrixType>
     class ichol0_precond
@@ -129,14 +183,19 @@ namespace viennacl
         typedef typename MatrixType::value_type      ScalarType;
 
       public:
-        ichol0_precond(MatrixType const & mat, ichol0_tag const & tag) : tag_(tag), LLT(mat.size1(), mat.size2(), viennacl::context(viennacl::MAIN_MEMORY))
+        ichol0_precond(MatrixType const & mat, ichol0_tag const & tag) : LLT(mat.size1(), mat.size2(), viennacl::context(viennacl::MAIN_MEMORY))
         {
             //initialize preconditioner:
             //std::cout << "Start CPU precond" << std::endl;
-            init(mat);
+            init(mat, tag);
             //std::cout << "End CPU precond" << std::endl;
         }
 
+        ichol0_precond(MatrixType const & mat, chow_patel_tag const & tag) : LLT(mat.size1(), mat.size2(), viennacl::context(viennacl::MAIN_MEMORY))
+        {
+            init(mat, tag);
+        }
+
         template <typename VectorType>
         void apply(VectorType & vec) const
         {
@@ -150,16 +209,16 @@ namespace viennacl
         }
 
       private:
-        void init(MatrixType const & mat)
+        template <typename TagType>
+        void init(MatrixType const & mat, TagType const & tag)
         {
           viennacl::context host_ctx(viennacl::MAIN_MEMORY);
           viennacl::switch_memory_context(LLT, host_ctx);
 
           viennacl::copy(mat, LLT);
-          viennacl::linalg::precondition(LLT, tag_);
+          viennacl::linalg::precondition(LLT, tag);
         }
 
-        ichol0_tag const & tag_;
         viennacl::compressed_matrix<ScalarType> LLT;
     };
 
@@ -174,14 +233,19 @@ namespace viennacl
         typedef compressed_matrix<ScalarType, MAT_ALIGNMENT>   MatrixType;
 
       public:
-        ichol0_precond(MatrixType const & mat, ichol0_tag const & tag) : tag_(tag), LLT(mat.size1(), mat.size2(), viennacl::traits::context(mat))
+        ichol0_precond(MatrixType const & mat, ichol0_tag const & tag) : LLT(mat.size1(), mat.size2(), viennacl::traits::context(mat))
         {
           //initialize preconditioner:
           //std::cout << "Start GPU precond" << std::endl;
-          init(mat);
+          init(mat, tag);
           //std::cout << "End GPU precond" << std::endl;
         }
 
+        ichol0_precond(MatrixType const & mat, chow_patel_tag const & tag) : LLT(mat.size1(), mat.size2(), viennacl::traits::context(mat))
+        {
+          init(mat, tag);
+        }
+
         void apply(vector<ScalarType> & vec) const
         {
           if (viennacl::traits::context(vec).memory_type() != viennacl::MAIN_MEMORY)
@@ -203,16 +267,16 @@ namespace viennacl
         }
 
       private:
-        void init(MatrixType const & mat)
+        template <typename TagType>
+        void init(MatrixType const & mat, TagType const & tag)
         {
           viennacl::context host_ctx(viennacl::MAIN_MEMORY);
           viennacl::switch_memory_context(LLT, host_ctx);
           LLT = mat;
 
-          viennacl::linalg::precondition(LLT, tag_);
+          viennacl::linalg::precondition(LLT, tag);
         }
 
-        ichol0_tag const & tag_;
         viennacl::compressed_matrix<ScalarType> LLT;
     };
 
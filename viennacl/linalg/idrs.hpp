@@ -0,0 +1,330 @@
+#ifndef VIENNACL_LINALG_IDRS_HPP_
+#define VIENNACL_LINALG_IDRS_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/idrs.hpp
+    @brief The induced dimension reduction method IDR(s) with biorthogonalization is implemented here
+*/
+
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include "viennacl/forwards.h"
+#include "viennacl/vector.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/inner_prod.hpp"
+#include "viennacl/linalg/norm_2.hpp"
+#include "viennacl/traits/context.hpp"
+#include "viennacl/linalg/detail/multi_vector.hpp"
+
+namespace viennacl
+{
+  namespace linalg
+  {
+
+    /** @brief A tag for the IDR(s) solver. Used for supplying solver parameters and for dispatching the solve() function
+    */
+    class idrs_tag
+    {
+      public:
+        /** @brief The constructor
+        *
+        * @param tol              Relative tolerance for the residual (solver quits if ||r|| < tol * ||b||)
+        * @param max_iters        The maximum number of iterations, counted as matrix-vector products
+        * @param s                Dimension of the shadow space. s = 1 is mathematically equivalent to BiCGStab, larger values usually reduce the number of matrix-vector products.
+        */
+        idrs_tag(double tol = 1e-8, unsigned int max_iters = 400, vcl_size_t s = 4)
+          : tol_(tol), iterations_(max_iters), s_(s > 0 ? s : 1), iters_taken_(0), last_error_(0) {}
+
+        /** @brief Returns the relative tolerance */
+        double tolerance() const { return tol_; }
+        /** @brief Returns the maximum number of iterations */
+        unsigned int max_iterations() const { return iterations_; }
+        /** @brief Returns the dimension of the shadow space */
+        vcl_size_t shadow_space_dim() const { return s_; }
+
+        /** @brief Return the number of solver iterations (matrix-vector products): */
+        unsigned int iters() const { return iters_taken_; }
+        void iters(unsigned int i) const { iters_taken_ = i; }
+
+        /** @brief Returns the estimated relative error at the end of the solver run */
+        double error() const { return last_error_; }
+        /** @brief Sets the estimated relative error at the end of the solver run */
+        void error(double e) const { last_error_ = e; }
+
+      private:
+        double tol_;
+        unsigned int iterations_;
+        vcl_size_t s_;
+
+        //return values from solver
+        mutable unsigned int iters_taken_;
+        mutable double last_error_;
+    };
+
+
+    namespace detail
+    {
+      /** @brief Fills the vectors in P with (reproducible) pseudo-random numbers and orthonormalizes them by modified Gram-Schmidt.
+      *
+      * Requires P.size() <= n. A vector which is numerically linearly dependent on its predecessors is drawn again.
+      */
+      template <typename T>
+      void idrs_init_shadow_space(std::vector< viennacl::vector<T> > & P)
+      {
+        vcl_size_t n = P.size() > 0 ? P[0].size() : 0;
+        std::vector<T> values(n);
+        unsigned long state = 12345;  //simple linear congruential generator, independent of std::rand()
+        for (vcl_size_t k=0; k<P.size(); ++k)
+        {
+          for (vcl_size_t attempt = 0; attempt < 10; ++attempt)
+          {
+            for (vcl_size_t i=0; i<n; ++i)
+            {
+              state = (1103515245ul * state + 12345ul) % 2147483648ul;
+              values[i] = T(state) / T(2147483648.0) - T(0.5);
+            }
+            viennacl::copy(values, P[k]);
+            T norm_initial = viennacl::linalg::norm_2(P[k]);
+
+            for (vcl_size_t j=0; j<k; ++j)
+              P[k] -= viennacl::linalg::inner_prod(P[j], P[k]) * P[j];
+            T norm_orth = viennacl::linalg::norm_2(P[k]);
+            if (norm_orth > T(100) * std::numeric_limits<T>::epsilon() * norm_initial)
+            {
+              P[k] /= norm_orth;
+              break;
+            }
+          }
+        }
+      }
+    }
+
+
+    /** @brief Implementation of the IDR(s) solver with biorthogonalization
+    *
+    * Following the algorithm 'IDR(s)-biortho' by M. B. van Gijzen and P. Sonneveld, ACM Trans. Math. Softw. 38(1), 2011.
+    * The preconditioner is applied from the right, hence the error estimate refers to the unpreconditioned residual.
+    * All inner products with the s shadow vectors are computed at once by a multiple inner product kernel,
+    * so each matrix-vector product is accompanied by two reductions only (multiple inner product and residual norm).
+    *
+    * @param matrix     The system matrix
+    * @param rhs        The load vector
+    * @param tag        Solver configuration tag
+    * @param precond    A preconditioner. Precondition operation is done via member function apply()
+    * @return The result vector
+    */
+    template <typename MatrixType, typename T, typename PreconditionerType>
+    viennacl::vector<T> solve(MatrixType const & matrix, viennacl::vector<T> const & rhs, idrs_tag const & tag, PreconditionerType const & precond)
+    {
+      vcl_size_t n = rhs.size();
+      vcl_size_t s = std::min(tag.shadow_space_dim(), n);  //at most n linearly independent shadow vectors
+      viennacl::context ctx = viennacl::traits::context(rhs);
+
+      viennacl::vector<T> result = viennacl::zero_vector<T>(n, ctx);
+      viennacl::vector<T> residual = rhs;
+      viennacl::vector<T> v(n, ctx);
+      viennacl::vector<T> t(n, ctx);
+      viennacl::vector<T> dot_buffer(s, ctx);       // P^T r
+      viennacl::vector<T> gram_buffer(s + 1, ctx);  // [P, G_k]^T G_k
+      viennacl::vector<T> pair_buffer(2, ctx);      // [t, r]^T t
+
+      std::vector< viennacl::vector<T> > P(s, viennacl::vector<T>(n, ctx));
+      std::vector< viennacl::vector<T> > G(s, viennacl::zero_vector<T>(n, ctx));
+      std::vector< viennacl::vector<T> > U(s, viennacl::zero_vector<T>(n, ctx));
+
+      std::vector<viennacl::vector_base<T> const *> P_ptrs(s);
+      for (vcl_size_t i=0; i<s; ++i)
+        P_ptrs[i] = &(P[i]);
+      viennacl::vector_tuple<T> P_tuple(P_ptrs);
+
+      // tuples [P, G_k] for computing P^T G_k and ||G_k|| by a single reduction:
+      std::vector< viennacl::vector_tuple<T> > PG_tuples;
+      for (vcl_size_t k=0; k<s; ++k)
+      {
+        std::vector<viennacl::vector_base<T> const *> PG_ptrs(P_ptrs);
+        PG_ptrs.push_back(&(G[k]));
+        PG_tuples.push_back(viennacl::vector_tuple<T>(PG_ptrs));
+      }
+
+      // M = P^T G, lower triangular due to the biorthogonalization. Initially the identity as G is zero.
+      std::vector< std::vector<T> > M;
+      detail::small_dense_resize(M, s, s);
+      for (vcl_size_t i=0; i<s; ++i)
+        M[i][i] = T(1);
+      std::vector<T> f, m, c(s), alpha(s);
+      std::vector<T> tr_tt;
+
+      tag.iters(0);
+      tag.error(0);
+
+      T norm_rhs = viennacl::linalg::norm_2(rhs);
+      if (norm_rhs == 0) //solution is zero if RHS norm is zero
+        return result;
+
+      detail::idrs_init_shadow_space(P);
+
+      T norm_res = norm_rhs;
+      T omega = 1;
+      while (true)
+      {
+        bool done = false;
+        while (!done)
+        {
+          detail::multi_inner_prod(residual, P_tuple, dot_buffer, f);  // f = P^T r
+
+          //
+          // Generate s vectors in G_j (and U_j) which are biorthogonal to P:
+          //
+          for (vcl_size_t k=0; k<s; ++k)
+          {
+            // solve the lower triangular system M(k:s, k:s) c = f(k:s):
+            for (vcl_size_t j=k; j<s; ++j)
+            {
+              c[j] = f[j];
+              for (vcl_size_t i=k; i<j; ++i)
+                c[j] -= M[j][i] * c[i];
+              c[j] /= M[j][j];
+            }
+
+            // v = M^{-1} (r - G(:, k:s) c),   U_k = U(:, k:s) c + omega v:
+            v = residual;
+            for (vcl_size_t j=k; j<s; ++j)
+              v -= c[j] * G[j];
+            precond.apply(v);
+            v *= omega;
+            for (vcl_size_t j=k; j<s; ++j)
+              v += c[j] * U[j];
+            U[k] = v;
+
+            G[k] = viennacl::linalg::prod(matrix, U[k]);
+            tag.iters(tag.iters() + 1);
+
+            // biorthogonalize G_k against P_0, ..., P_{k-1}:
+            detail::multi_inner_prod(G[k], PG_tuples[k], gram_buffer, m);  // m = [P, G_k]^T G_k
+            T norm_G_k = std::sqrt(m[s]);
+            for (vcl_size_t i=0; i<k; ++i)
+            {
+              alpha[i] = m[i];
+              for (vcl_size_t l=0; l<i; ++l)
+                alpha[i] -= M[i][l] * alpha[l];
+              alpha[i] /= M[i][i];
+            }
+            for (vcl_size_t i=0; i<k; ++i)
+            {
+              G[k] -= alpha[i] * G[i];
+              U[k] -= alpha[i] * U[i];
+            }
+
+            // new column of M:
+            for (vcl_size_t j=k; j<s; ++j)
+            {
+              M[j][k] = m[j];
+              for (vcl_size_t i=0; i<k; ++i)
+                M[j][k] -= M[j][i] * alpha[i];
+            }
+
+            if (std::fabs(M[k][k]) <= std::numeric_limits<T>::epsilon() * norm_G_k)  //breakdown: G_k (numerically) orthogonal to P_k
+            {
+              done = true;
+              break;
+            }
+
+            // make r orthogonal to P_0, ..., P_k:
+            T beta = f[k] / M[k][k];
+            residual -= beta * G[k];
+            result   += beta * U[k];
+            norm_res = viennacl::linalg::norm_2(residual);
+
+            if (norm_res / norm_rhs < tag.tolerance() || tag.iters() >= tag.max_iterations())
+            {
+              done = true;
+              break;
+            }
+
+            for (vcl_size_t j=k+1; j<s; ++j)
+              f[j] -= beta * M[j][k];
+          }
+
+          if (done)
+            break;
+
+          //
+          // Dimension reduction step: enter the next subspace G_{j+1}
+          //
+          v = residual;
+          precond.apply(v);
+          t = viennacl::linalg::prod(matrix, v);
+          tag.iters(tag.iters() + 1);
+
+          viennacl::vector_tuple<T> t_and_r(t, residual);
+          detail::multi_inner_prod(t, t_and_r, pair_buffer, tr_tt);
+          T tt = tr_tt[0];
+          T tr = tr_tt[1];
+          if (tt == 0)  //breakdown
+            break;
+
+          // omega with the 'maintaining the convergence' strategy, kappa = 0.7:
+          omega = tr / tt;
+          T rho = std::fabs(tr) / (std::sqrt(tt) * norm_res);
+          if (rho < T(0.7))
+            omega *= T(0.7) / rho;
+          if (omega == 0)  //breakdown
+            break;
+
+          residual -= omega * t;
+          result   += omega * v;
+          norm_res = viennacl::linalg::norm_2(residual);
+
+          if (norm_res / norm_rhs < tag.tolerance() || tag.iters() >= tag.max_iterations())
+            break;
+        }
+
+        // The recursively updated residual may drift away from the true residual (in particular in single precision).
+        // Thus, convergence is confirmed with the true residual, from which the iteration continues otherwise.
+        if (norm_res / norm_rhs >= tag.tolerance() || tag.iters() >= tag.max_iterations())  //breakdown or iteration limit reached
+          break;
+        t = viennacl::linalg::prod(matrix, result);
+        residual = rhs;
+        residual -= t;
+        tag.iters(tag.iters() + 1);
+        norm_res = viennacl::linalg::norm_2(residual);
+        if (norm_res / norm_rhs < tag.tolerance())
+          break;
+      }
+
+      //store last error estimate:
+      tag.error(norm_res / norm_rhs);
+
+      return result;
+    }
+
+    /** @brief Convenience overload of the solve() function using IDR(s). Per default, no preconditioner is used
+    */
+    template <typename MatrixType, typename T>
+    viennacl::vector<T> solve(MatrixType const & matrix, viennacl::vector<T> const & rhs, idrs_tag const & tag)
+    {
+      return solve(matrix, rhs, tag, viennacl::linalg::no_precond());
+    }
+
+  }
+}
+
+#endif
@@ -30,6 +30,7 @@
 #include "viennacl/tools/tools.hpp"
 #include "viennacl/linalg/sparse_matrix_operations.hpp"
 #include "viennacl/linalg/row_scaling.hpp"
+#include "viennacl/linalg/detail/multi_vector.hpp"
 
 #include <map>
 
@@ -125,6 +126,17 @@ namespace viennacl
           vec = element_div(vec, diag_A);
         }
 
+        /** @brief Multi-vector version: Applies the preconditioner to each column of 'mat' (e.g. for block solvers) */
+        void apply(viennacl::matrix_base<ScalarType> & mat) const
+        {
+          assert(viennacl::traits::size(diag_A) == viennacl::traits::size1(mat) && bool("Size mismatch"));
+          for (vcl_size_t j=0; j<mat.size2(); ++j)
+          {
+            viennacl::vector_base<ScalarType> col = detail::column_view(mat, j);
+            col = element_div(col, diag_A);
+          }
+        }
+
       private:
         viennacl::vector<ScalarType> diag_A;
     };
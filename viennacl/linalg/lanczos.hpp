@@ -26,6 +26,7 @@
 
 #include <cmath>
 #include <vector>
+#include <algorithm>
 #include "viennacl/vector.hpp"
 #include "viennacl/compressed_matrix.hpp"
 #include "viennacl/linalg/prod.hpp"
@@ -111,6 +112,15 @@ namespace viennacl
 
     namespace detail
     {
+      /** @brief Computes the largest tag.num_eigenvalues() eigenvalues of the Lanczos tridiagonal matrix in ascending order by bisection */
+      template <typename ScalarType>
+      std::vector<ScalarType> ritz_values(std::vector<ScalarType> const & alphas, std::vector<ScalarType> const & betas, lanczos_tag const & tag)
+      {
+        vcl_size_t size = alphas.size();
+        vcl_size_t num_eigenvalues = std::min(tag.num_eigenvalues(), size);
+        return bisect_by_index(alphas, betas, size - num_eigenvalues, size);
+      }
+
       /**
       *   @brief Implementation of the Lanczos PRO algorithm
       *
@@ -118,7 +128,7 @@ namespace viennacl
       *   @param r            Random start vector
       *   @param size         Size of krylov-space
       *   @param tag          Lanczos_tag with several options for the algorithm
-      *   @return             Returns the eigenvalues (number of eigenvalues equals size of krylov-space)
+      *   @return             Returns the largest tag.num_eigenvalues() Ritz values in ascending order
       */
 
       template< typename MatrixT, typename VectorT >
@@ -295,7 +305,7 @@ namespace viennacl
           alphas.push_back(vcl_alpha);
         }
 
-        return bisect(alphas, betas);
+        return ritz_values(alphas, betas, tag);
 
       }
 
@@ -306,13 +316,14 @@ namespace viennacl
       *   @param A            The system matrix
       *   @param r            Random start vector
       *   @param size         Size of krylov-space
-      *   @return             Returns the eigenvalues (number of eigenvalues equals size of krylov-space)
+      *   @param tag          Lanczos_tag with several options for the algorithm
+      *   @return             Returns the largest tag.num_eigenvalues() Ritz values in ascending order
       */
       template< typename MatrixT, typename VectorT >
       std::vector<
               typename viennacl::result_of::cpu_value_type<typename MatrixT::value_type>::type
               >
-      lanczos (MatrixT const& A, VectorT & r, vcl_size_t size, lanczos_tag)
+      lanczos (MatrixT const& A, VectorT & r, vcl_size_t size, lanczos_tag const & tag)
       {
 
         typedef typename viennacl::result_of::value_type<MatrixT>::type        ScalarType;
@@ -353,7 +364,7 @@ namespace viennacl
           s.clear();
         }
 
-        return bisect(alphas, betas);
+        return ritz_values(alphas, betas, tag);
       }
 
       /**
@@ -362,13 +373,14 @@ namespace viennacl
       *   @param A            The system matrix
       *   @param r            Random start vector
       *   @param size         Size of krylov-space
-      *   @return             Returns the eigenvalues (number of eigenvalues equals size of krylov-space)
+      *   @param tag          Lanczos_tag with several options for the algorithm
+      *   @return             Returns the largest tag.num_eigenvalues() Ritz values in ascending order
       */
       template< typename MatrixT, typename VectorT >
       std::vector<
               typename viennacl::result_of::cpu_value_type<typename MatrixT::value_type>::type
               >
-      lanczosFRO (MatrixT const& A, VectorT & r, vcl_size_t size, lanczos_tag)
+      lanczosFRO (MatrixT const& A, VectorT & r, vcl_size_t size, lanczos_tag const & tag)
       {
 
         typedef typename viennacl::result_of::value_type<MatrixT>::type        ScalarType;
@@ -418,7 +430,7 @@ namespace viennacl
             betas.push_back(vcl_beta);
           }
 
-          return bisect(alphas, betas);
+          return ritz_values(alphas, betas, tag);
       }
 
     } // end namespace detail
@@ -473,10 +485,7 @@ namespace viennacl
           break;
       }
 
-      std::vector<CPU_ScalarType> largest_eigenvalues;
-
-      for(vcl_size_t i = 1; i<=tag.num_eigenvalues(); i++)
-        largest_eigenvalues.push_back(eigenvalues[size_krylov-i]);
+      std::vector<CPU_ScalarType> largest_eigenvalues(eigenvalues.rbegin(), eigenvalues.rend());
 
 
       return largest_eigenvalues;
@@ -0,0 +1,437 @@
+#ifndef VIENNACL_LINALG_LOBPCG_HPP_
+#define VIENNACL_LINALG_LOBPCG_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/lobpcg.hpp
+    @brief The locally optimal block preconditioned conjugate gradient (LOBPCG) method for the smallest eigenpairs of symmetric positive definite matrices. Experimental.
+*/
+
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include "viennacl/forwards.h"
+#include "viennacl/vector.hpp"
+#include "viennacl/matrix.hpp"
+#include "viennacl/matrix_proxy.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/traits/size.hpp"
+#include "viennacl/traits/context.hpp"
+#include "viennacl/linalg/jacobi_precond.hpp"
+#include "viennacl/linalg/detail/small_dense.hpp"
+#include "viennacl/linalg/detail/multi_vector.hpp"
+#include "viennacl/linalg/tridiagonal_reduction.hpp"
+
+namespace viennacl
+{
+  namespace linalg
+  {
+
+    /** @brief A tag for the LOBPCG eigensolver. Used for supplying parameters and for dispatching the eig() function
+    */
+    class lobpcg_tag
+    {
+      public:
+        /** @brief The constructor
+        *
+        * @param numeig           Number of smallest eigenpairs to be computed
+        * @param tol              Relative tolerance: Eigenpair i is converged if ||A x_i - lambda_i x_i|| <= tol * |lambda_i|
+        * @param max_iterations   The maximum number of iterations
+        * @param block_size       Number of vectors iterated simultaneously. Values smaller than numeig (e.g. the default 0) are replaced by numeig.
+        *                         A few additional vectors accelerate the convergence of the last eigenpairs if these are clustered.
+        */
+        lobpcg_tag(vcl_size_t numeig = 10, double tol = 1e-8, unsigned int max_iterations = 500, vcl_size_t block_size = 0)
+          : num_eigenvalues_(numeig), tol_(tol), iterations_(max_iterations), block_size_(block_size), iters_taken_(0), matrix_products_(0), num_converged_(0) {}
+
+        /** @brief Returns the number of eigenpairs */
+        vcl_size_t num_eigenvalues() const { return num_eigenvalues_; }
+        /** @brief Returns the relative tolerance */
+        double tolerance() const { return tol_; }
+        /** @brief Returns the maximum number of iterations */
+        unsigned int max_iterations() const { return iterations_; }
+        /** @brief Returns the block size (at least the number of eigenpairs) */
+        vcl_size_t block_size() const { return std::max(block_size_, num_eigenvalues_); }
+
+        /** @brief Return the number of iterations of the last run */
+        unsigned int iters() const { return iters_taken_; }
+        void iters(unsigned int i) const { iters_taken_ = i; }
+
+        /** @brief Returns the number of vectors the operator was applied to in the last run */
+        vcl_size_t matrix_products() const { return matrix_products_; }
+        void matrix_products(vcl_size_t num) const { matrix_products_ = num; }
+
+        /** @brief Returns the number of converged eigenpairs of the last run */
+        vcl_size_t num_converged() const { return num_converged_; }
+        void num_converged(vcl_size_t num) const { num_converged_ = num; }
+
+        /** @brief Returns the residual norms ||A x_i - lambda_i x_i|| of the computed eigenpairs */
+        std::vector<double> const & residuals() const { return residuals_; }
+        void residuals(std::vector<double> const & r) const { residuals_ = r; }
+
+      private:
+        vcl_size_t num_eigenvalues_;
+        double tol_;
+        unsigned int iterations_;
+        vcl_size_t block_size_;
+
+        //return values from solver
+        mutable unsigned int iters_taken_;
+        mutable vcl_size_t matrix_products_;
+        mutable vcl_size_t num_converged_;
+        mutable std::vector<double> residuals_;
+    };
+
+
+    namespace detail
+    {
+      template <typename T>
+      void lobpcg_apply_precond(viennacl::linalg::no_precond const &, viennacl::matrix_base<T> &) {}
+
+      /** @brief The Jacobi preconditioner acts on all columns at once */
+      template <typename MatrixT, typename T>
+      void lobpcg_apply_precond(viennacl::linalg::jacobi_precond<MatrixT, true> const & precond, viennacl::matrix_base<T> & Z) { precond.apply(Z); }
+
+      /** @brief Generic preconditioners (ILU, AMG, etc.) are applied column by column */
+      template <typename PreconditionerType, typename T>
+      void lobpcg_apply_precond(PreconditionerType const & precond, viennacl::matrix_base<T> & Z)
+      {
+        viennacl::vector<T> z(Z.size1(), viennacl::traits::context(Z));
+        for (vcl_size_t j=0; j<Z.size2(); ++j)
+        {
+          viennacl::vector_base<T> col = column_view(Z, j);
+          z = col;
+          precond.apply(z);
+          col = z;
+        }
+      }
+
+      /** @brief Orthonormalizes the columns of V by two passes of Cholesky-QR and applies the same transformation to AV, so that AV = A V holds without further products with A.
+      *
+      * Returns false if the columns of V are (numerically) linearly dependent, in which case V and AV are left in an undefined state.
+      *
+      * @param V     The multi-vector to be orthonormalized
+      * @param AV    The product of the operator with V
+      * @param tmp   Work array of the same size as V
+      */
+      template <typename T>
+      bool lobpcg_orthonormalize(viennacl::matrix_base<T> & V, viennacl::matrix_base<T> & AV, viennacl::matrix_base<T> & tmp)
+      {
+        vcl_size_t s = V.size2();
+        viennacl::matrix<T, viennacl::column_major> G_dev(s, s, viennacl::traits::context(V));
+        std::vector< std::vector<T> > G;
+        std::vector< std::vector<T> > W;
+
+        for (vcl_size_t pass = 0; pass < 2; ++pass)
+        {
+          gram_matrix(V, V, G_dev, G);
+          std::vector<T> diag_G(s);
+          for (vcl_size_t i=0; i<s; ++i)
+            diag_G[i] = G[i][i];
+          if (!small_dense_cholesky(G, s))
+            return false;
+          for (vcl_size_t i=0; i<s; ++i)
+            if (G[i][i] * G[i][i] <= block_orthonormalize_tolerance<T>(s) * diag_G[i])
+              return false;
+
+          // V = V L^{-T}, AV = AV L^{-T}
+          small_dense_invert_lower(G, s);
+          small_dense_resize(W, s, s);
+          for (vcl_size_t i=0; i<s; ++i)
+            for (vcl_size_t j=i; j<s; ++j)
+              W[i][j] = G[j][i];
+          viennacl::copy(W, G_dev);
+          tmp = viennacl::linalg::prod(V, G_dev);
+          V = tmp;
+          tmp = viennacl::linalg::prod(AV, G_dev);
+          AV = tmp;
+        }
+
+        return true;
+      }
+
+      /** @brief Orthogonalizes W against the orthonormal columns of V by two passes of classical Gram-Schmidt. If AV and AW are not NULL, AW = A W is maintained. */
+      template <typename T>
+      void lobpcg_project_out(viennacl::matrix_base<T> const & V, viennacl::matrix_base<T> const * AV,
+                              viennacl::matrix_base<T> & W, viennacl::matrix_base<T> * AW)
+      {
+        viennacl::matrix<T, viennacl::column_major> H_dev(V.size2(), W.size2(), viennacl::traits::context(V));
+        std::vector< std::vector<T> > H;
+        for (vcl_size_t pass = 0; pass < 2; ++pass)
+        {
+          gram_matrix(V, W, H_dev, H);
+          W -= viennacl::linalg::prod(V, H_dev);
+          if (AV && AW)
+            *AW -= viennacl::linalg::prod(*AV, H_dev);
+        }
+      }
+
+      /** @brief Computes the eigenpairs of V^T AV (symmetrized) for orthonormal V. Eigenvalues in ascending order, Y is column-major. */
+      template <typename T>
+      void lobpcg_rayleigh_ritz(viennacl::matrix_base<T> const & V, viennacl::matrix_base<T> const & AV, std::vector<T> & theta, std::vector<T> & Y)
+      {
+        viennacl::matrix<T, viennacl::column_major> G_dev(V.size2(), AV.size2(), viennacl::traits::context(V));
+        std::vector< std::vector<T> > G;
+        gram_matrix(V, AV, G_dev, G);
+
+        vcl_size_t d = V.size2();
+        std::vector<T> S(d * d);
+        for (vcl_size_t j=0; j<d; ++j)
+          for (vcl_size_t i=0; i<d; ++i)
+            S[j * d + i] = (G[i][j] + G[j][i]) / T(2);
+        theta.resize(d);
+        Y.resize(d * d);
+        symmetric_eigen_host(&(S[0]), d, &(theta[0]), &(Y[0]));
+      }
+
+      /** @brief Copies the rows first, ..., last-1 of the columns 'cols' of the column-major d x d matrix Y to a device matrix */
+      template <typename T>
+      void lobpcg_copy_coefficients(std::vector<T> const & Y, vcl_size_t d, vcl_size_t first, vcl_size_t last,
+                                    std::vector<vcl_size_t> const & cols, viennacl::matrix<T, viennacl::column_major> & Y_dev)
+      {
+        std::vector< std::vector<T> > Y_host(last - first, std::vector<T>(cols.size()));
+        for (vcl_size_t i=first; i<last; ++i)
+          for (vcl_size_t j=0; j<cols.size(); ++j)
+            Y_host[i - first][j] = Y[cols[j] * d + i];
+        Y_dev.resize(last - first, cols.size(), false);
+        viennacl::copy(Y_host, Y_dev);
+      }
+
+      /** @brief Implementation of the LOBPCG method.
+      *
+      * Follows the basis selection of Hetmaniuk and Lehoucq (2006): The Rayleigh-Ritz procedure is carried out on the orthonormal basis [X, P, W],
+      * where X are the current Ritz vectors, P the previous search directions and W the preconditioned residuals.
+      * The products of the operator with P are updated alongside P, so each iteration only applies the operator to the new directions W by a single sparse matrix-matrix product.
+      * Converged eigenpairs remain in the Rayleigh-Ritz procedure, but no longer contribute search directions (soft locking).
+      *
+      * @param A              The system matrix (symmetric positive definite)
+      * @param X              Initial guess (if of size n x tag.block_size()) on entry, eigenvectors on exit
+      * @param tag            The LOBPCG tag
+      * @param precond        The preconditioner
+      * @return The eigenvalues in ascending order
+      */
+      template <typename MatrixT, typename T, typename PreconditionerType>
+      std::vector<T> lobpcg(MatrixT const & A, viennacl::matrix<T, viennacl::column_major> & X_out, lobpcg_tag const & tag, PreconditionerType const & precond)
+      {
+        typedef viennacl::matrix<T, viennacl::column_major>   DenseMatrix;
+        typedef viennacl::matrix_range<DenseMatrix>           DenseMatrixRange;
+
+        vcl_size_t n = viennacl::traits::size1(A);
+        vcl_size_t k = std::min(tag.num_eigenvalues(), n);
+        vcl_size_t s = std::min(tag.block_size(), n);
+        viennacl::context ctx = viennacl::traits::context(A);
+        viennacl::range all_rows(0, n);
+
+        tag.iters(0);
+        tag.matrix_products(0);
+        tag.num_converged(0);
+        tag.residuals(std::vector<double>());
+
+        std::vector<T> eigenvalues;
+        if (k == 0)
+          return eigenvalues;
+
+        // the search space [X, P, W] and its image under A:
+        DenseMatrix S(n, 3 * s, ctx);
+        DenseMatrix AS(n, 3 * s, ctx);
+        DenseMatrix R(n, s, ctx);
+        DenseMatrix tmp(n, s, ctx);
+        DenseMatrix tmp2(n, s, ctx);
+        DenseMatrix Y_dev(3 * s, s, ctx);
+        DenseMatrix Theta_dev(s, s, ctx);
+        DenseMatrix ortho_work(s, s, ctx);
+        T rank_tol = block_orthonormalize_tolerance<T>(s);
+
+        DenseMatrixRange X(S, all_rows, viennacl::range(0, s));
+        DenseMatrixRange AX(AS, all_rows, viennacl::range(0, s));
+
+        //
+        // initial guess: supplied by the user or random, made orthonormal
+        //
+        vcl_size_t rank = 0;
+        unsigned long state = 12345;
+        if (X_out.size1() == n && X_out.size2() == s)
+        {
+          X = X_out;
+          rank = block_orthonormalize(X, tmp, ortho_work, rank_tol);
+        }
+        if (rank < s)
+        {
+          fill_random_columns(X, 0, s, state);
+          block_orthonormalize(X, tmp, ortho_work, rank_tol);
+        }
+        tmp = X;
+        AX = viennacl::linalg::prod(A, tmp);
+        vcl_size_t matrix_products = s;
+
+        std::vector<T> theta, Y;
+        std::vector<vcl_size_t> cols(s);
+        for (vcl_size_t j=0; j<s; ++j)
+          cols[j] = j;
+
+        lobpcg_rayleigh_ritz(X, AX, theta, Y);
+        lobpcg_copy_coefficients(Y, s, 0, s, cols, Y_dev);
+        tmp = viennacl::linalg::prod(X, Y_dev);
+        X = tmp;
+        tmp = viennacl::linalg::prod(AX, Y_dev);
+        AX = tmp;
+
+        vcl_size_t p = 0;   //number of columns in P
+        std::vector<T> residuals(s);
+        std::vector< std::vector<T> > Theta;
+        for (unsigned int iter = 0; iter < tag.max_iterations(); ++iter)
+        {
+          tag.iters(iter + 1);
+
+          //
+          // residuals R = A X - X diag(theta) and soft locking of the converged eigenpairs:
+          //
+          small_dense_resize(Theta, s, s);
+          for (vcl_size_t j=0; j<s; ++j)
+            Theta[j][j] = theta[j];
+          viennacl::copy(Theta, Theta_dev);
+          R = AX;
+          R -= viennacl::linalg::prod(X, Theta_dev);
+          column_norms(R, residuals);
+
+          std::vector<vcl_size_t> active;
+          vcl_size_t num_converged = 0;
+          for (vcl_size_t j=0; j<s; ++j)
+          {
+            bool converged = residuals[j] <= tag.tolerance() * std::max(std::fabs(theta[j]), std::numeric_limits<T>::epsilon() * std::fabs(theta[s - 1]));
+            if (j < k && converged)
+              ++num_converged;
+            if (!converged)
+              active.push_back(j);
+          }
+          tag.num_converged(num_converged);
+          if (num_converged == k)
+            break;
+
+          //
+          // previous search directions: orthogonalize against X, orthonormalize (dropped if numerically dependent)
+          //
+          if (p > 0)
+          {
+            DenseMatrixRange P(S, all_rows, viennacl::range(s, s + p));
+            DenseMatrixRange AP(AS, all_rows, viennacl::range(s, s + p));
+            DenseMatrixRange tmp_p(tmp, all_rows, viennacl::range(0, p));
+            lobpcg_project_out(X, &AX, P, &AP);
+            if (!lobpcg_orthonormalize(P, AP, tmp_p))
+              p = 0;
+          }
+
+          //
+          // new search directions W = M^{-1} R for the active columns, orthogonalized against [X, P] and orthonormalized:
+          //
+          vcl_size_t a = active.size();
+          DenseMatrixRange W(S, all_rows, viennacl::range(s + p, s + p + a));
+          for (vcl_size_t j=0; j<a; ++j)
+          {
+            viennacl::vector_base<T> w_j = column_view(W, j);
+            w_j = column_view(R, active[j]);
+          }
+          lobpcg_apply_precond(precond, W);
+
+          DenseMatrixRange XP(S, all_rows, viennacl::range(0, s + p));
+          lobpcg_project_out(XP, static_cast<viennacl::matrix_base<T> const *>(NULL), W, static_cast<viennacl::matrix_base<T> *>(NULL));
+          DenseMatrixRange tmp_w(tmp, all_rows, viennacl::range(0, a));
+          vcl_size_t rank_w = block_orthonormalize(W, tmp_w, ortho_work, rank_tol);
+
+          if (rank_w == 0 && p == 0)   //no search directions left
+            break;
+
+          DenseMatrixRange W_indep(S, all_rows, viennacl::range(s + p, s + p + rank_w));
+          DenseMatrixRange AW(AS, all_rows, viennacl::range(s + p, s + p + rank_w));
+          DenseMatrixRange tmp_aw(tmp2, all_rows, viennacl::range(0, rank_w));
+          tmp_aw = viennacl::linalg::prod(A, W_indep);
+          AW = tmp_aw;
+          matrix_products += rank_w;
+          tag.matrix_products(matrix_products);
+
+          //
+          // Rayleigh-Ritz on [X, P, W]. The new search directions are the P and W components of the active Ritz vectors:
+          //
+          vcl_size_t d = s + p + rank_w;
+          DenseMatrixRange S_d(S, all_rows, viennacl::range(0, d));
+          DenseMatrixRange AS_d(AS, all_rows, viennacl::range(0, d));
+          DenseMatrixRange S_pw(S, all_rows, viennacl::range(s, d));
+          DenseMatrixRange AS_pw(AS, all_rows, viennacl::range(s, d));
+          lobpcg_rayleigh_ritz(S_d, AS_d, theta, Y);
+
+          vcl_size_t p_new = a;
+          DenseMatrixRange R_p(R, all_rows, viennacl::range(0, p_new));
+          DenseMatrixRange tmp_p(tmp, all_rows, viennacl::range(0, p_new));
+          lobpcg_copy_coefficients(Y, d, s, d, active, Y_dev);
+          R_p   = viennacl::linalg::prod(S_pw, Y_dev);
+          tmp_p = viennacl::linalg::prod(AS_pw, Y_dev);
+
+          lobpcg_copy_coefficients(Y, d, 0, d, cols, Y_dev);
+          tmp2 = viennacl::linalg::prod(S_d, Y_dev);
+          X = tmp2;
+          tmp2 = viennacl::linalg::prod(AS_d, Y_dev);
+          AX = tmp2;
+
+          p = p_new;
+          DenseMatrixRange P(S, all_rows, viennacl::range(s, s + p));
+          DenseMatrixRange AP(AS, all_rows, viennacl::range(s, s + p));
+          P  = R_p;
+          AP = tmp_p;
+
+          theta.resize(s);
+        }
+
+        //
+        // wanted eigenpairs:
+        //
+        eigenvalues.assign(theta.begin(), theta.begin() + static_cast<long>(k));
+        tag.residuals(std::vector<double>(residuals.begin(), residuals.begin() + static_cast<long>(k)));
+        tag.matrix_products(matrix_products);
+
+        X_out.resize(n, k, false);
+        X_out = DenseMatrixRange(S, all_rows, viennacl::range(0, k));
+
+        return eigenvalues;
+      }
+    }
+
+    /** @brief Computes the smallest eigenvalues and eigenvectors of a symmetric positive definite matrix with the preconditioned LOBPCG method.
+    *
+    * @param matrix         The system matrix (any sparse matrix type supporting prod() with a dense matrix)
+    * @param eigenvectors   Initial guess if of size n x tag.block_size() on entry (ignored otherwise), eigenvectors on exit (one per column)
+    * @param tag            Tag with the parameters of the LOBPCG method
+    * @param precond        A preconditioner approximating the inverse of the matrix, e.g. Jacobi, ILU or AMG
+    * @return The tag.num_eigenvalues() smallest eigenvalues in ascending order
+    */
+    template <typename MatrixT, typename T, typename PreconditionerType>
+    std::vector<T> eig(MatrixT const & matrix, viennacl::matrix<T, viennacl::column_major> & eigenvectors, lobpcg_tag const & tag, PreconditionerType const & precond)
+    {
+      return detail::lobpcg(matrix, eigenvectors, tag, precond);
+    }
+
+    /** @brief Computes the smallest eigenvalues and eigenvectors of a symmetric positive definite matrix with the LOBPCG method without preconditioner. */
+    template <typename MatrixT, typename T>
+    std::vector<T> eig(MatrixT const & matrix, viennacl::matrix<T, viennacl::column_major> & eigenvectors, lobpcg_tag const & tag)
+    {
+      return detail::lobpcg(matrix, eigenvectors, tag, viennacl::linalg::no_precond());
+    }
+
+  }
+}
+
+#endif
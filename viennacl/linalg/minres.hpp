@@ -0,0 +1,250 @@
+#ifndef VIENNACL_LINALG_MINRES_HPP_
+#define VIENNACL_LINALG_MINRES_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/minres.hpp
+    @brief The minimum residual method (MINRES) for symmetric, possibly indefinite systems is implemented here
+*/
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include "viennacl/forwards.h"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/inner_prod.hpp"
+#include "viennacl/linalg/norm_2.hpp"
+#include "viennacl/traits/clear.hpp"
+#include "viennacl/traits/size.hpp"
+#include "viennacl/meta/result_of.hpp"
+
+namespace viennacl
+{
+  namespace linalg
+  {
+
+    /** @brief A tag for the minimum residual method. Used for supplying solver parameters and for dispatching the solve() function
+    */
+    class minres_tag
+    {
+      public:
+        /** @brief The constructor
+        *
+        * @param tol              Relative tolerance for the (preconditioned) residual (solver quits if ||r|| < tol * ||r_initial||)
+        * @param max_iterations   The maximum number of iterations
+        */
+        minres_tag(double tol = 1e-8, unsigned int max_iterations = 300) : tol_(tol), iterations_(max_iterations), iters_taken_(0), last_error_(0) {}
+
+        /** @brief Returns the relative tolerance */
+        double tolerance() const { return tol_; }
+        /** @brief Returns the maximum number of iterations */
+        unsigned int max_iterations() const { return iterations_; }
+
+        /** @brief Return the number of solver iterations: */
+        unsigned int iters() const { return iters_taken_; }
+        void iters(unsigned int i) const { iters_taken_ = i; }
+
+        /** @brief Returns the estimated relative error at the end of the solver run */
+        double error() const { return last_error_; }
+        /** @brief Sets the estimated relative error at the end of the solver run */
+        void error(double e) const { last_error_ = e; }
+
+      private:
+        double tol_;
+        unsigned int iterations_;
+
+        //return values from solver
+        mutable unsigned int iters_taken_;
+        mutable double last_error_;
+    };
+
+
+    namespace detail
+    {
+      /** @brief Returns true if the preconditioner is the identity, in which case the preconditioned Lanczos vectors need not be stored separately */
+      inline bool minres_precond_is_identity(viennacl::linalg::no_precond const &) { return true; }
+
+      template <typename PreconditionerType>
+      bool minres_precond_is_identity(PreconditionerType const &) { return false; }
+
+      /** @brief Undoes the scaling 'factor' of a stored vector (v_true = v_stored / factor) if the factor is about to leave a safe range */
+      template <typename VectorType, typename ScalarType>
+      void minres_rescale(VectorType & v, ScalarType & factor)
+      {
+        if (std::fabs(factor) > ScalarType(1e8) || std::fabs(factor) < ScalarType(1e-8))
+        {
+          v /= factor;
+          factor = ScalarType(1);
+        }
+      }
+    }
+
+
+    /** @brief Implementation of the preconditioned minimum residual method
+    *
+    * Following Algorithm 2.4 in "Finite Elements and Fast Iterative Solvers" by H. Elman, D. Silvester and A. Wathen.
+    * The system matrix needs to be symmetric, but may be indefinite. The preconditioner needs to be symmetric positive definite.
+    *
+    * Memory requirements are constant (eight vectors, six without preconditioner). The Lanczos vectors and the search directions are
+    * stored with a scaling factor, which allows to carry out all three-term recurrences with a single fused vector update (x += a*y + b*z).
+    * Hence, an iteration requires one matrix-vector product, two inner products and three vector updates.
+    *
+    * @param matrix     The system matrix
+    * @param rhs        The load vector
+    * @param tag        Solver configuration tag
+    * @param precond    A symmetric positive definite preconditioner. Precondition operation is done via member function apply()
+    * @return The result vector
+    */
+    template <typename MatrixType, typename VectorType, typename PreconditionerType>
+    VectorType solve(const MatrixType & matrix, VectorType const & rhs, minres_tag const & tag, PreconditionerType const & precond)
+    {
+      typedef typename viennacl::result_of::value_type<VectorType>::type        ScalarType;
+      typedef typename viennacl::result_of::cpu_value_type<ScalarType>::type    CPU_ScalarType;
+
+      VectorType result = rhs;
+      viennacl::traits::clear(result);
+
+      bool precond_is_identity = detail::minres_precond_is_identity(precond);
+
+      // Lanczos vectors v_{j-1}, v_j and search directions w_{j-1}, w_j. The true vectors are the stored ones divided by the kappa and tau factors.
+      VectorType v_a = result;
+      VectorType v_b = rhs;
+      VectorType w_a = result;
+      VectorType w_b = result;
+      VectorType tmp = result;
+      VectorType z_a = precond_is_identity ? VectorType() : rhs;
+      VectorType z_b = precond_is_identity ? VectorType() : rhs;
+
+      VectorType * v_prev = &v_a;
+      VectorType * v_cur  = &v_b;
+      VectorType * w_prev = &w_a;
+      VectorType * w_cur  = &w_b;
+      VectorType * z_cur  = precond_is_identity ? v_cur : &z_a;
+      VectorType * z_next = precond_is_identity ? v_prev : &z_b;
+
+      precond.apply(*z_cur);
+      CPU_ScalarType ip_zv = viennacl::linalg::inner_prod(*z_cur, *v_cur);
+
+      tag.iters(0);
+      tag.error(0);
+
+      if (ip_zv <= 0) //solution is zero if RHS norm is zero
+        return result;
+
+      CPU_ScalarType gamma = std::sqrt(ip_zv);
+      CPU_ScalarType gamma_prev = 1;
+      CPU_ScalarType kappa_prev = 1, kappa_cur = 1;
+      CPU_ScalarType tau_prev = 1, tau_cur = 1;
+      CPU_ScalarType c_prev = 1, c_cur = 1;
+      CPU_ScalarType s_prev = 0, s_cur = 0;
+      CPU_ScalarType eta = gamma;
+      CPU_ScalarType norm_initial = gamma;
+
+      for (unsigned int i = 0; i < tag.max_iterations(); ++i)
+      {
+        tag.iters(i+1);
+
+        // Lanczos step. The normalized preconditioned vector is z_cur / (kappa_cur * gamma):
+        CPU_ScalarType z_scale = kappa_cur * gamma;
+        tmp = viennacl::linalg::prod(matrix, *z_cur);
+        CPU_ScalarType delta = viennacl::linalg::inner_prod(tmp, *z_cur);
+        delta /= z_scale * z_scale;
+
+        // v_{j+1} = A z_j - delta/gamma_j v_j - gamma_j/gamma_{j-1} v_{j-1}, computed in-place in the storage of v_{j-1} and scaled by kappa_next:
+        CPU_ScalarType kappa_next = -gamma_prev * kappa_prev / gamma;
+        *v_prev += (kappa_next / z_scale) * tmp + (-kappa_next * delta / (gamma * kappa_cur)) * (*v_cur);
+
+        if (!precond_is_identity)
+        {
+          *z_next = *v_prev;
+          precond.apply(*z_next);
+        }
+        ip_zv = viennacl::linalg::inner_prod(*z_next, *v_prev);
+        if (ip_zv < 0)  //preconditioner not positive definite
+          break;
+        CPU_ScalarType gamma_next = std::sqrt(ip_zv) / std::fabs(kappa_next);
+
+        // QR decomposition of the tridiagonal Lanczos matrix by Givens rotations:
+        CPU_ScalarType alpha_0 = c_cur * delta - c_prev * s_cur * gamma;
+        CPU_ScalarType alpha_1 = std::sqrt(alpha_0 * alpha_0 + gamma_next * gamma_next);
+        CPU_ScalarType alpha_2 = s_cur * delta + c_prev * c_cur * gamma;
+        CPU_ScalarType alpha_3 = s_prev * gamma;
+        if (alpha_1 == 0)  //breakdown (singular system)
+          break;
+        CPU_ScalarType c_next = alpha_0 / alpha_1;
+        CPU_ScalarType s_next = gamma_next / alpha_1;
+
+        // w_{j+1} = (z_j - alpha_3 w_{j-1} - alpha_2 w_j) / alpha_1, computed in-place in the storage of w_{j-1} and scaled by tau_next:
+        CPU_ScalarType tau_next = 1;
+        if (alpha_3 != 0)
+        {
+          tau_next = -alpha_1 * tau_prev / alpha_3;
+          *w_prev += (tau_next / (alpha_1 * z_scale)) * (*z_cur) + (-tau_next * alpha_2 / (alpha_1 * tau_cur)) * (*w_cur);
+        }
+        else  // w_{j-1} is zero
+          *w_prev = (CPU_ScalarType(1) / (alpha_1 * z_scale)) * (*z_cur) + (-alpha_2 / (alpha_1 * tau_cur)) * (*w_cur);
+
+        result += (c_next * eta / tau_next) * (*w_prev);
+        eta = -s_next * eta;
+
+        // shift recurrences:
+        std::swap(v_prev, v_cur);
+        std::swap(w_prev, w_cur);
+        if (precond_is_identity)
+        {
+          z_cur  = v_cur;
+          z_next = v_prev;
+        }
+        else
+          std::swap(z_cur, z_next);
+
+        gamma_prev = gamma;  gamma = gamma_next;
+        kappa_prev = kappa_cur; kappa_cur = kappa_next;
+        tau_prev = tau_cur;  tau_cur = tau_next;
+        c_prev = c_cur;      c_cur = c_next;
+        s_prev = s_cur;      s_cur = s_next;
+
+        // keep the scaling factors bounded:
+        if (!precond_is_identity)
+        {
+          CPU_ScalarType kappa_z = kappa_cur;
+          detail::minres_rescale(*z_cur, kappa_z);
+        }
+        detail::minres_rescale(*v_cur, kappa_cur);
+        detail::minres_rescale(*w_cur, tau_cur);
+
+        tag.error(std::fabs(eta) / norm_initial);
+        if (tag.error() < tag.tolerance() || gamma == 0)
+          break;
+      }
+
+      return result;
+    }
+
+    /** @brief Convenience overload of the solve() function using MINRES. Per default, no preconditioner is used
+    */
+    template <typename MatrixType, typename VectorType>
+    VectorType solve(const MatrixType & matrix, VectorType const & rhs, minres_tag const & tag)
+    {
+      return solve(matrix, rhs, tag, viennacl::linalg::no_precond());
+    }
+
+  }
+}
+
+#endif
@@ -0,0 +1,221 @@
+#ifndef VIENNACL_LINALG_MIXED_PRECISION_HPP_
+#define VIENNACL_LINALG_MIXED_PRECISION_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/mixed_precision.hpp
+    @brief Mixed precision iterative refinement: An iterative solver runs in single precision, the residual correction is carried out in double precision.
+*/
+
+#include <cmath>
+#include "viennacl/forwards.h"
+#include "viennacl/vector.hpp"
+#include "viennacl/compressed_matrix.hpp"
+#include "viennacl/backend/memory.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/norm_2.hpp"
+#include "viennacl/linalg/vector_operations.hpp"
+#include "viennacl/linalg/cg.hpp"
+#include "viennacl/linalg/bicgstab.hpp"
+#include "viennacl/linalg/gmres.hpp"
+#include "viennacl/traits/context.hpp"
+
+namespace viennacl
+{
+  namespace linalg
+  {
+
+    /** @brief A tag for mixed precision iterative refinement. Used for supplying solver parameters and for dispatching the solve() function
+    *
+    * Matrices and vectors may reside in any memory domain. The inner solves and the residual computations run in the memory domain of the system,
+    * while the precision conversions of the residual and the correction are carried out in main memory for OpenCL and CUDA,
+    * since there are no conversion kernels yet. This costs one transfer of each of the two vectors to the host and back per refinement step.
+    *
+    * @tparam InnerTagT   Tag of the solver used for the low precision inner solves, e.g. cg_tag, bicgstab_tag or gmres_tag
+    */
+    template <typename InnerTagT>
+    class mixed_precision_tag
+    {
+      public:
+        /** @brief The constructor
+        *
+        * @param inner_tag        Tag for the inner solver. Its tolerance is the relative reduction of the residual in each refinement step, thus should be moderate (e.g. 1e-3)
+        * @param tol              Relative tolerance for the residual (solver quits if ||r|| < tol * ||b||)
+        * @param max_refinements  The maximum number of refinement steps (inner solves)
+        */
+        mixed_precision_tag(InnerTagT const & inner_tag, double tol = 1e-8, unsigned int max_refinements = 20)
+          : inner_tag_(inner_tag), tol_(tol), max_refinements_(max_refinements), iters_taken_(0), refinements_taken_(0), last_error_(0) {}
+
+        /** @brief Returns the tag of the inner solver */
+        InnerTagT const & inner_tag() const { return inner_tag_; }
+        /** @brief Returns the relative tolerance */
+        double tolerance() const { return tol_; }
+        /** @brief Returns the maximum number of refinement steps */
+        unsigned int max_refinements() const { return max_refinements_; }
+
+        /** @brief Return the total number of inner solver iterations: */
+        unsigned int iters() const { return iters_taken_; }
+        void iters(unsigned int i) const { iters_taken_ = i; }
+
+        /** @brief Return the number of refinement steps: */
+        unsigned int refinements() const { return refinements_taken_; }
+        void refinements(unsigned int i) const { refinements_taken_ = i; }
+
+        /** @brief Returns the relative residual norm at the end of the solver run (computed in high precision) */
+        double error() const { return last_error_; }
+        /** @brief Sets the relative residual norm at the end of the solver run */
+        void error(double e) const { last_error_ = e; }
+
+      private:
+        InnerTagT inner_tag_;
+        double tol_;
+        unsigned int max_refinements_;
+
+        //return values from solver
+        mutable unsigned int iters_taken_;
+        mutable unsigned int refinements_taken_;
+        mutable double last_error_;
+    };
+
+
+    /** @brief Converts the entries of a sparse matrix to a different floating point precision. The sparsity pattern is copied within the memory domain of 'src'.
+    *
+    * @param dst   The result matrix. Must have been created with the dimensions and the number of nonzeros of 'src', i.e. compressed_matrix<float>(src.size1(), src.size2(), src.nnz(), viennacl::traits::context(src))
+    * @param src   The matrix to be converted
+    */
+    template <typename T1, unsigned int ALIGNMENT1, typename T2, unsigned int ALIGNMENT2>
+    void convert(compressed_matrix<T1, ALIGNMENT1> & dst, compressed_matrix<T2, ALIGNMENT2> const & src)
+    {
+      assert(dst.size1() == src.size1() && dst.size2() == src.size2() && dst.nnz() == src.nnz() && bool("Size mismatch in convert()"));
+
+      if (src.nnz() == 0)
+        return;
+
+      viennacl::backend::typesafe_host_array<unsigned int> size_deducer(src.handle1());
+      viennacl::backend::memory_copy(src.handle1(), dst.handle1(), 0, 0, size_deducer.element_size() * (src.size1() + 1));
+      viennacl::backend::memory_copy(src.handle2(), dst.handle2(), 0, 0, size_deducer.element_size() * src.nnz());
+
+      // the entry arrays are wrapped by vectors without taking ownership:
+      viennacl::vector_base<T1> dst_elements(dst.handle(), src.nnz(), 0, 1);
+      viennacl::vector_base<T2> src_elements(const_cast<viennacl::backend::mem_handle &>(src.handle()), src.nnz(), 0, 1);
+      viennacl::linalg::convert(dst_elements, src_elements);
+    }
+
+
+    /** @brief Mixed precision iterative refinement with a user-supplied low precision system matrix
+    *
+    * In each refinement step, the residual r = b - A x is computed in the high precision of 'matrix' and converted to low precision,
+    * where the correction equation A d = r is solved approximately by the inner solver specified in the tag. The correction is then added to x in high precision.
+    * Since the inner solver streams the low precision matrix, the memory traffic per sparse matrix-vector product is roughly halved,
+    * while the result attains the accuracy of the high precision residual.
+    * The residual is scaled to unit norm before conversion, so the inner solves are not affected by underflow.
+    * Iteration stops if the relative residual falls below tag.tolerance(), if tag.max_refinements() is reached, or if a refinement step does not reduce the residual.
+    *
+    * @param matrix               The system matrix in high precision
+    * @param matrix_low_precision The system matrix in low precision, cf. convert(). Also used for setting up 'precond'
+    * @param rhs                  The load vector
+    * @param tag                  Solver configuration tag
+    * @param precond              A preconditioner for the low precision matrix. Precondition operation is done via member function apply()
+    * @return The result vector
+    */
+    template <typename MatrixType, typename LowPrecisionMatrixType, typename T, typename InnerTagT, typename PreconditionerType>
+    viennacl::vector<T> solve(MatrixType const & matrix, LowPrecisionMatrixType const & matrix_low_precision, viennacl::vector<T> const & rhs,
+                              mixed_precision_tag<InnerTagT> const & tag, PreconditionerType const & precond)
+    {
+      typedef typename viennacl::result_of::cpu_value_type<typename LowPrecisionMatrixType::value_type>::type    LowPrecisionType;
+
+      vcl_size_t problem_size = viennacl::traits::size(rhs);
+      viennacl::context ctx = viennacl::traits::context(rhs);
+
+      viennacl::vector<T> result = viennacl::zero_vector<T>(problem_size, ctx);
+      viennacl::vector<T> residual = rhs;
+      viennacl::vector<LowPrecisionType> residual_low_precision(problem_size, ctx);
+
+      tag.iters(0);
+      tag.refinements(0);
+      tag.error(0);
+
+      T norm_rhs = viennacl::linalg::norm_2(rhs);
+      if (norm_rhs == 0) //solution is zero if RHS norm is zero
+        return result;
+
+      T norm_residual = norm_rhs;
+      unsigned int inner_iterations = 0;
+      for (unsigned int i = 0; i < tag.max_refinements(); ++i)
+      {
+        if (norm_residual / norm_rhs < tag.tolerance())
+          break;
+
+        // solve A d = r / ||r|| in low precision:
+        viennacl::linalg::convert(residual_low_precision, residual, T(1) / norm_residual);
+        viennacl::vector<LowPrecisionType> correction = viennacl::linalg::solve(matrix_low_precision, residual_low_precision, tag.inner_tag(), precond);
+        inner_iterations += tag.inner_tag().iters();
+        tag.refinements(i + 1);
+
+        // x += ||r|| d  and  r = b - A x  in high precision:
+        viennacl::linalg::inplace_add_converted(result, correction, norm_residual);
+        residual = viennacl::linalg::prod(matrix, result);
+        residual = rhs - residual;
+
+        T new_norm_residual = viennacl::linalg::norm_2(residual);
+        if (!(new_norm_residual < norm_residual))  //no progress (or NaN), further refinements are futile
+        {
+          norm_residual = new_norm_residual;
+          break;
+        }
+        norm_residual = new_norm_residual;
+      }
+
+      //store last error:
+      tag.iters(inner_iterations);
+      tag.error(norm_residual / norm_rhs);
+
+      return result;
+    }
+
+    /** @brief Mixed precision iterative refinement for a sparse matrix. A single precision copy of the matrix is created internally.
+    *
+    * @param matrix     The system matrix in double precision
+    * @param rhs        The load vector
+    * @param tag        Solver configuration tag
+    * @param precond    A preconditioner acting on single precision vectors
+    * @return The result vector
+    */
+    template <typename T, unsigned int ALIGNMENT, typename InnerTagT, typename PreconditionerType>
+    viennacl::vector<T> solve(compressed_matrix<T, ALIGNMENT> const & matrix, viennacl::vector<T> const & rhs,
+                              mixed_precision_tag<InnerTagT> const & tag, PreconditionerType const & precond)
+    {
+      compressed_matrix<float> matrix_low_precision(matrix.size1(), matrix.size2(), matrix.nnz(), viennacl::traits::context(matrix));
+      viennacl::linalg::convert(matrix_low_precision, matrix);
+
+      return solve(matrix, matrix_low_precision, rhs, tag, precond);
+    }
+
+    /** @brief Convenience overload of the solve() function for mixed precision iterative refinement. Per default, no preconditioner is used
+    */
+    template <typename T, unsigned int ALIGNMENT, typename InnerTagT>
+    viennacl::vector<T> solve(compressed_matrix<T, ALIGNMENT> const & matrix, viennacl::vector<T> const & rhs,
+                              mixed_precision_tag<InnerTagT> const & tag)
+    {
+      return solve(matrix, rhs, tag, viennacl::linalg::no_precond());
+    }
+
+  }
+}
+
+#endif
@@ -25,12 +25,23 @@
 */
 
 
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
 #include "viennacl/vector.hpp"
 #include "viennacl/matrix.hpp"
+#include "viennacl/compressed_matrix.hpp"
 #include "viennacl/linalg/prod.hpp"
 #include "viennacl/linalg/norm_2.hpp"
 #include "viennacl/linalg/norm_frobenius.hpp"
-#include "viennacl/linalg/opencl/kernels/nmf.hpp"
+#include "viennacl/backend/memory.hpp"
+#include "viennacl/backend/util.hpp"
+#include "viennacl/tools/timer.hpp"
+
+#ifdef VIENNACL_WITH_OPENCL
+  #include "viennacl/linalg/opencl/kernels/nmf.hpp"
+#endif
 
 namespace viennacl
 {
@@ -48,7 +59,7 @@ namespace viennacl
            max_iters_(num_max_iters),
            check_after_steps_( (num_check_iters > 0) ? num_check_iters : 1),
            print_relative_error_(false),
-           iters_(0) {}
+           iters_(0), residual_(0) {}
 
         /** @brief Returns the relative tolerance for convergence */
         double tolerance() const { return eps_; }
@@ -81,11 +92,23 @@ namespace viennacl
         /** @brief Specify whether the relative error should be printed at each convergence check after 'num_check_iters' steps */
         void print_relative_error(bool b) { print_relative_error_ = b; }
 
-        template <typename ScalarType>
-        friend void nmf(viennacl::matrix<ScalarType> const & V,
-                        viennacl::matrix<ScalarType> & W,
-                        viennacl::matrix<ScalarType> & H,
-                        nmf_config const & conf);
+        /** @brief Returns the wall-clock time (in seconds) of each iteration of the last NMF run, including the convergence checks */
+        std::vector<double> const & iteration_times() const { return iteration_times_; }
+
+        /** @brief Returns the relative residual norm(V - W * H) / norm(V - W_1 * H_1) at each convergence check of the last NMF run, where W_1 and H_1 are the factors after the first iteration.
+        *
+        * Use check_after_steps(1) to obtain the residual history for each iteration.
+        */
+        std::vector<double> const & relative_residuals() const { return relative_residuals_; }
+
+        /** @brief Returns the absolute residual norm(V - W * H) at the last convergence check of the last NMF run */
+        double residual() const { return residual_; }
+
+        // run statistics, set by nmf():
+        void iters(vcl_size_t i) const { iters_ = i; }
+        void reset_history() const { iters_ = 0; residual_ = 0; iteration_times_.clear(); relative_residuals_.clear(); }
+        void record_iteration_time(double t) const { iteration_times_.push_back(t); }
+        void record_residual(double abs_res, double rel_res) const { residual_ = abs_res; relative_residuals_.push_back(rel_res); }
 
       private:
         double eps_;
@@ -94,105 +117,619 @@ namespace viennacl
         vcl_size_t check_after_steps_;
         bool print_relative_error_;
         mutable vcl_size_t iters_;
+        mutable double residual_;
+        mutable std::vector<double> iteration_times_;
+        mutable std::vector<double> relative_residuals_;
     };
 
 
-    /** @brief The nonnegative matrix factorization (approximation) algorithm as suggested by Lee and Seung. Factorizes a matrix V with nonnegative entries into matrices W and H such that ||V - W*H|| is minimized.
-     *
-     * @param V     Input matrix
-     * @param W     First factor
-     * @param H     Second factor
-     * @param conf  A configuration object holding tolerances and the like
-     */
-    template <typename ScalarType>
-    void nmf(viennacl::matrix<ScalarType> const & V,
-             viennacl::matrix<ScalarType> & W,
-             viennacl::matrix<ScalarType> & H,
-             nmf_config const & conf)
+    namespace detail
     {
-      viennacl::ocl::context & ctx = const_cast<viennacl::ocl::context &>(viennacl::traits::opencl_handle(V).context());
+      /** @brief Number of columns (rows) of V processed per tile in the fused host kernels */
+      inline vcl_size_t nmf_block_size() { return 64; }
 
-      const std::string NMF_MUL_DIV_KERNEL = "el_wise_mul_div";
+      /** @brief Dense V in row-major layout on the host */
+      template <typename T>
+      struct nmf_host_dense
+      {
+        vcl_size_t size1;
+        vcl_size_t size2;
+        std::vector<T> data;
+      };
+
+      /** @brief Sparse V on the host. Holds the CSR arrays as well as the CSC arrays (i.e. CSR of V^T), so that both W^T V and V H^T are computed row by row. */
+      template <typename T>
+      struct nmf_host_sparse
+      {
+        vcl_size_t size1;
+        vcl_size_t size2;
+        std::vector<unsigned int> row_buffer;
+        std::vector<unsigned int> col_buffer;
+        std::vector<T>            elements;
+        std::vector<unsigned int> trans_row_buffer;
+        std::vector<unsigned int> trans_col_buffer;
+        std::vector<T>            trans_elements;
+        double                    norm_squared;
+      };
+
+      /** @brief Computes the k x k Gram matrix G = X^T X for a row-major matrix X with 'rows' rows and k columns. Accumulated in double precision, since G also enters the residual evaluation. */
+      template <typename T>
+      void nmf_gram(std::vector<T> const & X, vcl_size_t rows, vcl_size_t k, std::vector<double> & G)
+      {
+        std::fill(G.begin(), G.end(), 0.0);
 
-      viennacl::linalg::opencl::kernels::nmf<ScalarType>::init(ctx);
+#ifdef VIENNACL_WITH_OPENMP
+        #pragma omp parallel
+#endif
+        {
+          std::vector<double> G_local(k * k);
 
-      assert(V.size1() == W.size1() && V.size2() == H.size2() && bool("Dimensions of W and H don't allow for V = W * H"));
-      assert(W.size2() == H.size1() && bool("Dimensions of W and H don't match, prod(W, H) impossible"));
+#ifdef VIENNACL_WITH_OPENMP
+          #pragma omp for
+#endif
+          for (long r = 0; r < static_cast<long>(rows); ++r)
+          {
+            T const * x = &(X[static_cast<vcl_size_t>(r) * k]);
+            for (vcl_size_t a = 0; a < k; ++a)
+            {
+              double x_a = x[a];
+              for (vcl_size_t b = a; b < k; ++b)
+                G_local[a * k + b] += x_a * x[b];
+            }
+          }
+
+#ifdef VIENNACL_WITH_OPENMP
+          #pragma omp critical
+#endif
+          {
+            for (vcl_size_t i = 0; i < G_local.size(); ++i)
+              G[i] += G_local[i];
+          }
+        }
+
+        for (vcl_size_t a = 0; a < k; ++a)
+          for (vcl_size_t b = 0; b < a; ++b)
+            G[a * k + b] = G[b * k + a];
+      }
+
+      /** @brief The epilogue fused into the products W^T V and V H^T: x = x .* num ./ (G x), where x is a row of W or a column of H.
+      *
+      * Small divisors result in a zero entry, just like the OpenCL kernel el_wise_mul_div.
+      */
+      template <typename T>
+      void nmf_multiplicative_update(T * x, T const * num, std::vector<double> const & G, vcl_size_t k, std::vector<T> & x_old)
+      {
+        std::copy(x, x + k, x_old.begin());
+        for (vcl_size_t l = 0; l < k; ++l)
+        {
+          double divisor = 0;
+          for (vcl_size_t p = 0; p < k; ++p)
+            divisor += G[l * k + p] * x_old[p];
+
+          x[l] = (divisor > 0.00001) ? static_cast<T>(x_old[l] * num[l] / divisor) : T(0);
+        }
+      }
+
+
+      //
+      // dense V
+      //
+
+      /** @brief H = H .* (W^T V) ./ (W^T W H) for dense V. Ht holds H^T in row-major layout, so that each column of H is contiguous.
+      *
+      * Columns of V are processed in tiles. The tile of W^T V is accumulated in a thread-local buffer, which is consumed by the multiplicative update right away.
+      */
+      template <typename T>
+      void nmf_update_H(nmf_host_dense<T> const & V, std::vector<T> const & W, std::vector<T> & Ht, std::vector<double> const & G, vcl_size_t k)
+      {
+        vcl_size_t m = V.size1;
+        vcl_size_t n = V.size2;
+        vcl_size_t block_size = nmf_block_size();
+        long num_blocks = static_cast<long>((n + block_size - 1) / block_size);
+
+#ifdef VIENNACL_WITH_OPENMP
+        #pragma omp parallel
+#endif
+        {
+          std::vector<T> num(block_size * k);
+          std::vector<T> x_old(k);
 
-      vcl_size_t k = W.size2();
-      conf.iters_ = 0;
+#ifdef VIENNACL_WITH_OPENMP
+          #pragma omp for
+#endif
+          for (long b = 0; b < num_blocks; ++b)
+          {
+            vcl_size_t col_start = static_cast<vcl_size_t>(b) * block_size;
+            vcl_size_t col_end   = std::min(col_start + block_size, n);
+
+            std::fill(num.begin(), num.end(), T(0));
+            for (vcl_size_t r = 0; r < m; ++r)
+            {
+              T const * w   = &(W[r * k]);
+              T const * v_r = &(V.data[r * n]);
+              for (vcl_size_t j = col_start; j < col_end; ++j)
+              {
+                T v = v_r[j];
+                if (v == T(0))
+                  continue;
+                T * num_j = &(num[(j - col_start) * k]);
+                for (vcl_size_t l = 0; l < k; ++l)
+                  num_j[l] += v * w[l];
+              }
+            }
+
+            for (vcl_size_t j = col_start; j < col_end; ++j)
+              nmf_multiplicative_update(&(Ht[j * k]), &(num[(j - col_start) * k]), G, k, x_old);
+          }
+        }
+      }
+
+      /** @brief W = W .* (V H^T) ./ (W H H^T) for dense V. Rows of V are processed in tiles, so that each tile of H stays in cache for all rows of the tile. */
+      template <typename T>
+      void nmf_update_W(nmf_host_dense<T> const & V, std::vector<T> const & Ht, std::vector<T> & W, std::vector<double> const & G, vcl_size_t k)
+      {
+        vcl_size_t m = V.size1;
+        vcl_size_t n = V.size2;
+        vcl_size_t block_size = nmf_block_size();
+        long num_blocks = static_cast<long>((m + block_size - 1) / block_size);
+
+#ifdef VIENNACL_WITH_OPENMP
+        #pragma omp parallel
+#endif
+        {
+          std::vector<T> num(block_size * k);
+          std::vector<T> x_old(k);
 
-      viennacl::matrix<ScalarType> wn(V.size1(), k);
-      viennacl::matrix<ScalarType> wd(V.size1(), k);
-      viennacl::matrix<ScalarType> wtmp(V.size1(), V.size2());
+#ifdef VIENNACL_WITH_OPENMP
+          #pragma omp for
+#endif
+          for (long b = 0; b < num_blocks; ++b)
+          {
+            vcl_size_t row_start = static_cast<vcl_size_t>(b) * block_size;
+            vcl_size_t row_end   = std::min(row_start + block_size, m);
+
+            std::fill(num.begin(), num.end(), T(0));
+            for (vcl_size_t col_start = 0; col_start < n; col_start += block_size)
+            {
+              vcl_size_t col_end = std::min(col_start + block_size, n);
+              for (vcl_size_t r = row_start; r < row_end; ++r)
+              {
+                T const * v_r   = &(V.data[r * n]);
+                T       * num_r = &(num[(r - row_start) * k]);
+                for (vcl_size_t j = col_start; j < col_end; ++j)
+                {
+                  T v = v_r[j];
+                  if (v == T(0))
+                    continue;
+                  T const * h = &(Ht[j * k]);
+                  for (vcl_size_t l = 0; l < k; ++l)
+                    num_r[l] += v * h[l];
+                }
+              }
+            }
+
+            for (vcl_size_t r = row_start; r < row_end; ++r)
+              nmf_multiplicative_update(&(W[r * k]), &(num[(r - row_start) * k]), G, k, x_old);
+          }
+        }
+      }
 
-      viennacl::matrix<ScalarType> hn(k, V.size2());
-      viennacl::matrix<ScalarType> hd(k, V.size2());
-      viennacl::matrix<ScalarType> htmp(k, k);
+      /** @brief Returns ||V - W H||_F^2 for dense V, accumulated in double precision */
+      template <typename T>
+      double nmf_residual_squared(nmf_host_dense<T> const & V, std::vector<T> const & W, std::vector<T> const & Ht, vcl_size_t k)
+      {
+        vcl_size_t m = V.size1;
+        vcl_size_t n = V.size2;
+        double result = 0;
 
-      viennacl::matrix<ScalarType> appr(V.size1(), V.size2());
-      viennacl::vector<ScalarType> diff(V.size1() * V.size2());
+#ifdef VIENNACL_WITH_OPENMP
+        #pragma omp parallel for reduction(+: result)
+#endif
+        for (long r = 0; r < static_cast<long>(m); ++r)
+        {
+          T const * w   = &(W[static_cast<vcl_size_t>(r) * k]);
+          T const * v_r = &(V.data[static_cast<vcl_size_t>(r) * n]);
+          double row_result = 0;
+          for (vcl_size_t j = 0; j < n; ++j)
+          {
+            T const * h = &(Ht[j * k]);
+            double diff = v_r[j];
+            for (vcl_size_t l = 0; l < k; ++l)
+              diff -= static_cast<double>(w[l]) * h[l];
+            row_result += diff * diff;
+          }
+          result += row_result;
+        }
 
-      ScalarType last_diff = 0;
-      ScalarType diff_init = 0;
-      bool stagnation_flag = false;
+        return result;
+      }
 
 
-      for (vcl_size_t i = 0; i < conf.max_iterations(); i++)
+      //
+      // sparse V
+      //
+
+      /** @brief Computes the fused update x_i = x_i .* (sum_j A(i,j) Y_j) ./ (G x_i) for each row i of the CSR matrix A. Used for both H (A = V^T) and W (A = V). */
+      template <typename T>
+      void nmf_sparse_update(std::vector<unsigned int> const & row_buffer,
+                             std::vector<unsigned int> const & col_buffer,
+                             std::vector<T> const & elements,
+                             vcl_size_t rows,
+                             std::vector<T> const & Y,
+                             std::vector<T> & X,
+                             std::vector<double> const & G,
+                             vcl_size_t k)
       {
-        conf.iters_ = i + 1;
+#ifdef VIENNACL_WITH_OPENMP
+        #pragma omp parallel
+#endif
         {
-          hn   = viennacl::linalg::prod(trans(W), V);
-          htmp = viennacl::linalg::prod(trans(W), W);
-          hd   = viennacl::linalg::prod(htmp, H);
+          std::vector<T> num(k);
+          std::vector<T> x_old(k);
 
-          viennacl::ocl::kernel & mul_div_kernel = ctx.get_kernel(viennacl::linalg::opencl::kernels::nmf<ScalarType>::program_name(), NMF_MUL_DIV_KERNEL);
-          viennacl::ocl::enqueue(mul_div_kernel(H, hn, hd, cl_uint(H.internal_size1() * H.internal_size2())));
+#ifdef VIENNACL_WITH_OPENMP
+          #pragma omp for
+#endif
+          for (long i = 0; i < static_cast<long>(rows); ++i)
+          {
+            std::fill(num.begin(), num.end(), T(0));
+            for (unsigned int nz = row_buffer[static_cast<vcl_size_t>(i)]; nz < row_buffer[static_cast<vcl_size_t>(i) + 1]; ++nz)
+            {
+              T v = elements[nz];
+              T const * y = &(Y[col_buffer[nz] * k]);
+              for (vcl_size_t l = 0; l < k; ++l)
+                num[l] += v * y[l];
+            }
+
+            nmf_multiplicative_update(&(X[static_cast<vcl_size_t>(i) * k]), &(num[0]), G, k, x_old);
+          }
         }
+      }
+
+      /** @brief H = H .* (W^T V) ./ (W^T W H) for sparse V. Column j of W^T V is obtained from row j of V^T. */
+      template <typename T>
+      void nmf_update_H(nmf_host_sparse<T> const & V, std::vector<T> const & W, std::vector<T> & Ht, std::vector<double> const & G, vcl_size_t k)
+      {
+        nmf_sparse_update(V.trans_row_buffer, V.trans_col_buffer, V.trans_elements, V.size2, W, Ht, G, k);
+      }
+
+      /** @brief W = W .* (V H^T) ./ (W H H^T) for sparse V */
+      template <typename T>
+      void nmf_update_W(nmf_host_sparse<T> const & V, std::vector<T> const & Ht, std::vector<T> & W, std::vector<double> const & G, vcl_size_t k)
+      {
+        nmf_sparse_update(V.row_buffer, V.col_buffer, V.elements, V.size1, Ht, W, G, k);
+      }
+
+      /** @brief Returns ||V - W H||_F^2 = ||V||_F^2 - 2 <V, W H> + <W^T W, H H^T> for sparse V. Only the nonzeros of V are visited. */
+      template <typename T>
+      double nmf_residual_squared(nmf_host_sparse<T> const & V, std::vector<T> const & W, std::vector<T> const & Ht, vcl_size_t k)
+      {
+        double inner = 0;
+
+#ifdef VIENNACL_WITH_OPENMP
+        #pragma omp parallel for reduction(+: inner)
+#endif
+        for (long r = 0; r < static_cast<long>(V.size1); ++r)
         {
-          wn   = viennacl::linalg::prod(V, trans(H));
-          wtmp = viennacl::linalg::prod(W, H);
-          wd   = viennacl::linalg::prod(wtmp, trans(H));
+          T const * w = &(W[static_cast<vcl_size_t>(r) * k]);
+          for (unsigned int nz = V.row_buffer[static_cast<vcl_size_t>(r)]; nz < V.row_buffer[static_cast<vcl_size_t>(r) + 1]; ++nz)
+          {
+            T const * h = &(Ht[V.col_buffer[nz] * k]);
+            double wh = 0;
+            for (vcl_size_t l = 0; l < k; ++l)
+              wh += static_cast<double>(w[l]) * h[l];
+            inner += V.elements[nz] * wh;
+          }
+        }
+
+        std::vector<double> WtW(k * k);
+        std::vector<double> HHt(k * k);
+        nmf_gram(W,  V.size1, k, WtW);
+        nmf_gram(Ht, V.size2, k, HHt);
+
+        double result = V.norm_squared - 2.0 * inner;
+        for (vcl_size_t i = 0; i < k * k; ++i)
+          result += WtW[i] * HHt[i];
+
+        return std::max(result, 0.0);
+      }
+
+
+      //
+      // common driver
+      //
+
+      /** @brief Records the residual of a convergence check and returns true if the iteration should be stopped */
+      inline bool nmf_check_convergence(double diff_val, vcl_size_t iter, nmf_config const & conf,
+                                        double & diff_init, double & last_diff, bool & stagnation_flag)
+      {
+        if (iter == 0)
+          diff_init = diff_val;
 
-          viennacl::ocl::kernel & mul_div_kernel = ctx.get_kernel(viennacl::linalg::opencl::kernels::nmf<ScalarType>::program_name(), NMF_MUL_DIV_KERNEL);
+        double rel_diff = (diff_init > 0) ? diff_val / diff_init : 0;
+        conf.record_residual(diff_val, rel_diff);
 
-          viennacl::ocl::enqueue(mul_div_kernel(W, wn, wd, cl_uint(W.internal_size1() * W.internal_size2())));
+        if (conf.print_relative_error())
+          std::cout << rel_diff << std::endl;
+
+        // Approximation check
+        if (rel_diff < conf.tolerance())
+          return true;
+
+        // Stagnation check
+        if (std::fabs(diff_val - last_diff) / (diff_val * static_cast<double>(conf.check_after_steps())) < conf.stagnation_tolerance()) //avoid situations where convergence stagnates
+        {
+          if (stagnation_flag)       // iteration stagnates (two iterates with no notable progress)
+            return true;
+          else                       // record stagnation in this iteration
+            stagnation_flag = true;
         }
+        else                         // good progress in this iteration, so unset stagnation flag
+          stagnation_flag = false;
+
+        // prepare for next iterate:
+        last_diff = diff_val;
+        return false;
+      }
+
+      /** @brief Runs the multiplicative updates on the host. W is row-major (m x k), Ht holds H^T in row-major layout (n x k). */
+      template <typename HostMatrixType, typename T>
+      void nmf_host(HostMatrixType const & V, std::vector<T> & W, std::vector<T> & Ht, vcl_size_t k, nmf_config const & conf)
+      {
+        std::vector<double> WtW(k * k);
+        std::vector<double> HHt(k * k);
+
+        double last_diff = 0;
+        double diff_init = 0;
+        bool stagnation_flag = false;
 
-        if (i % conf.check_after_steps() == 0)  //check for convergence
+        viennacl::tools::timer timer;
+        for (vcl_size_t i = 0; i < conf.max_iterations(); i++)
         {
-          appr = viennacl::linalg::prod(W, H);
+          timer.start();
+          conf.iters(i + 1);
 
-          appr -= V;
-          ScalarType diff_val = viennacl::linalg::norm_frobenius(appr);
+          nmf_gram(W, V.size1, k, WtW);
+          nmf_update_H(V, W, Ht, WtW, k);
 
-          if (i == 0)
-            diff_init = diff_val;
+          nmf_gram(Ht, V.size2, k, HHt);
+          nmf_update_W(V, Ht, W, HHt, k);
 
-          if (conf.print_relative_error())
-            std::cout << diff_val / diff_init << std::endl;
+          bool converged = false;
+          if (i % conf.check_after_steps() == 0)  //check for convergence
+            converged = nmf_check_convergence(std::sqrt(nmf_residual_squared(V, W, Ht, k)), i, conf, diff_init, last_diff, stagnation_flag);
 
-          // Approximation check
-          if (diff_val / diff_init < conf.tolerance())
+          conf.record_iteration_time(timer.get());
+          if (converged)
             break;
+        }
+      }
+
+      /** @brief Reads a dense row-major ViennaCL matrix into a row-major host buffer, optionally transposed */
+      template <typename ScalarType>
+      void nmf_read_matrix(viennacl::matrix<ScalarType> const & A, std::vector<ScalarType> & buffer, bool trans)
+      {
+        std::vector<ScalarType> internal_buffer(A.internal_size());
+        viennacl::backend::memory_read(A.handle(), 0, sizeof(ScalarType) * A.internal_size(), &(internal_buffer[0]));
+
+        buffer.resize(A.size1() * A.size2());
+        for (vcl_size_t i = 0; i < A.size1(); ++i)
+          for (vcl_size_t j = 0; j < A.size2(); ++j)
+            buffer[trans ? (j * A.size1() + i) : (i * A.size2() + j)] = internal_buffer[viennacl::row_major::mem_index(i, j, A.internal_size1(), A.internal_size2())];
+      }
+
+      /** @brief Writes a row-major host buffer (optionally holding the transpose) back to a dense row-major ViennaCL matrix */
+      template <typename ScalarType>
+      void nmf_write_matrix(std::vector<ScalarType> const & buffer, bool trans, viennacl::matrix<ScalarType> & A)
+      {
+        std::vector<ScalarType> internal_buffer(A.internal_size());
+        for (vcl_size_t i = 0; i < A.size1(); ++i)
+          for (vcl_size_t j = 0; j < A.size2(); ++j)
+            internal_buffer[viennacl::row_major::mem_index(i, j, A.internal_size1(), A.internal_size2())] = buffer[trans ? (j * A.size1() + i) : (i * A.size2() + j)];
+
+        viennacl::backend::memory_write(A.handle(), 0, sizeof(ScalarType) * A.internal_size(), &(internal_buffer[0]));
+      }
+
+      /** @brief Runs NMF on the host for the host representation V of the system matrix and writes the factors back to W and H */
+      template <typename HostMatrixType, typename ScalarType>
+      void nmf_host(HostMatrixType const & V,
+                    viennacl::matrix<ScalarType> & W,
+                    viennacl::matrix<ScalarType> & H,
+                    nmf_config const & conf)
+      {
+        vcl_size_t k = W.size2();
+
+        std::vector<ScalarType> W_host;
+        std::vector<ScalarType> Ht_host;
+        nmf_read_matrix(W, W_host, false);
+        nmf_read_matrix(H, Ht_host, true);
+
+        nmf_host(V, W_host, Ht_host, k, conf);
+
+        nmf_write_matrix(W_host, false, W);
+        nmf_write_matrix(Ht_host, true, H);
+      }
 
-          // Stagnation check
-          if (std::fabs(diff_val - last_diff) / (diff_val * conf.check_after_steps()) < conf.stagnation_tolerance()) //avoid situations where convergence stagnates
+#ifdef VIENNACL_WITH_OPENCL
+      /** @brief Runs NMF with the OpenCL kernels. */
+      template <typename ScalarType>
+      void nmf_opencl(viennacl::matrix<ScalarType> const & V,
+                      viennacl::matrix<ScalarType> & W,
+                      viennacl::matrix<ScalarType> & H,
+                      nmf_config const & conf)
+      {
+        viennacl::ocl::context & ctx = const_cast<viennacl::ocl::context &>(viennacl::traits::opencl_handle(V).context());
+
+        const std::string NMF_MUL_DIV_KERNEL = "el_wise_mul_div";
+
+        viennacl::linalg::opencl::kernels::nmf<ScalarType>::init(ctx);
+
+        vcl_size_t k = W.size2();
+
+        viennacl::matrix<ScalarType> wn(V.size1(), k);
+        viennacl::matrix<ScalarType> wd(V.size1(), k);
+        viennacl::matrix<ScalarType> wtmp(V.size1(), V.size2());
+
+        viennacl::matrix<ScalarType> hn(k, V.size2());
+        viennacl::matrix<ScalarType> hd(k, V.size2());
+        viennacl::matrix<ScalarType> htmp(k, k);
+
+        viennacl::matrix<ScalarType> appr(V.size1(), V.size2());
+
+        double last_diff = 0;
+        double diff_init = 0;
+        bool stagnation_flag = false;
+
+        viennacl::tools::timer timer;
+        for (vcl_size_t i = 0; i < conf.max_iterations(); i++)
+        {
+          timer.start();
+          conf.iters(i + 1);
+          {
+            hn   = viennacl::linalg::prod(trans(W), V);
+            htmp = viennacl::linalg::prod(trans(W), W);
+            hd   = viennacl::linalg::prod(htmp, H);
+
+            viennacl::ocl::kernel & mul_div_kernel = ctx.get_kernel(viennacl::linalg::opencl::kernels::nmf<ScalarType>::program_name(), NMF_MUL_DIV_KERNEL);
+            viennacl::ocl::enqueue(mul_div_kernel(H, hn, hd, cl_uint(H.internal_size1() * H.internal_size2())));
+          }
+          {
+            wn   = viennacl::linalg::prod(V, trans(H));
+            wtmp = viennacl::linalg::prod(W, H);
+            wd   = viennacl::linalg::prod(wtmp, trans(H));
+
+            viennacl::ocl::kernel & mul_div_kernel = ctx.get_kernel(viennacl::linalg::opencl::kernels::nmf<ScalarType>::program_name(), NMF_MUL_DIV_KERNEL);
+
+            viennacl::ocl::enqueue(mul_div_kernel(W, wn, wd, cl_uint(W.internal_size1() * W.internal_size2())));
+          }
+
+          bool converged = false;
+          if (i % conf.check_after_steps() == 0)  //check for convergence
           {
-            if (stagnation_flag)       // iteration stagnates (two iterates with no notable progress)
-              break;
-            else                       // record stagnation in this iteration
-              stagnation_flag = true;
+            appr = viennacl::linalg::prod(W, H);
+
+            appr -= V;
+            ScalarType diff_val = viennacl::linalg::norm_frobenius(appr);
+
+            converged = nmf_check_convergence(diff_val, i, conf, diff_init, last_diff, stagnation_flag);
           }
-          else                         // good progress in this iteration, so unset stagnation flag
-            stagnation_flag = false;
 
-          // prepare for next iterate:
-          last_diff = diff_val;
+          viennacl::backend::finish();
+          conf.record_iteration_time(timer.get());
+          if (converged)
+            break;
         }
       }
+#endif
+    }
+
+
+    /** @brief The nonnegative matrix factorization (approximation) algorithm as suggested by Lee and Seung. Factorizes a matrix V with nonnegative entries into matrices W and H such that ||V - W*H|| is minimized.
+     *
+     * If V resides in OpenCL memory, the multiplicative updates are run by OpenCL kernels.
+     * Otherwise, the updates are computed on the host, where the element-wise multiplication and division is fused into the products W^T V and V H^T.
+     * The time per iteration and the residual at each convergence check are available from the configuration object after the run.
+     *
+     * @param V     Input matrix
+     * @param W     First factor
+     * @param H     Second factor
+     * @param conf  A configuration object holding tolerances and the like
+     */
+    template <typename ScalarType>
+    void nmf(viennacl::matrix<ScalarType> const & V,
+             viennacl::matrix<ScalarType> & W,
+             viennacl::matrix<ScalarType> & H,
+             nmf_config const & conf)
+    {
+      assert(V.size1() == W.size1() && V.size2() == H.size2() && bool("Dimensions of W and H don't allow for V = W * H"));
+      assert(W.size2() == H.size1() && bool("Dimensions of W and H don't match, prod(W, H) impossible"));
+
+      conf.reset_history();
+
+#ifdef VIENNACL_WITH_OPENCL
+      if (viennacl::traits::active_handle_id(V) == viennacl::OPENCL_MEMORY)
+      {
+        detail::nmf_opencl(V, W, H, conf);
+        return;
+      }
+#endif
+
+      detail::nmf_host_dense<ScalarType> V_host;
+      V_host.size1 = V.size1();
+      V_host.size2 = V.size2();
+      detail::nmf_read_matrix(V, V_host.data, false);
+
+      detail::nmf_host(V_host, W, H, conf);
+    }
+
+
+    /** @brief Nonnegative matrix factorization of a sparse matrix V with nonnegative entries. See the dense version for details.
+     *
+     * The products W^T V and V H^T are computed as sparse-times-dense products on the host (with the multiplicative update fused into them), irrespective of the memory domain of V.
+     * The residual ||V - W*H|| is evaluated from the nonzeros of V and the k x k Gram matrices of W and H, so W*H is never formed.
+     *
+     * @param V     Input matrix
+     * @param W     First factor
+     * @param H     Second factor
+     * @param conf  A configuration object holding tolerances and the like
+     */
+    template <typename ScalarType, unsigned int ALIGNMENT>
+    void nmf(viennacl::compressed_matrix<ScalarType, ALIGNMENT> const & V,
+             viennacl::matrix<ScalarType> & W,
+             viennacl::matrix<ScalarType> & H,
+             nmf_config const & conf)
+    {
+      assert(V.size1() == W.size1() && V.size2() == H.size2() && bool("Dimensions of W and H don't allow for V = W * H"));
+      assert(W.size2() == H.size1() && bool("Dimensions of W and H don't match, prod(W, H) impossible"));
+
+      conf.reset_history();
+
+      detail::nmf_host_sparse<ScalarType> V_host;
+      V_host.size1 = V.size1();
+      V_host.size2 = V.size2();
+      V_host.row_buffer.resize(V.size1() + 1);
+      V_host.col_buffer.resize(V.nnz());
+      V_host.elements.resize(V.nnz());
 
+      if (V.nnz() > 0)
+      {
+        viennacl::backend::typesafe_host_array<unsigned int> row_buffer(V.handle1(), V.size1() + 1);
+        viennacl::backend::typesafe_host_array<unsigned int> col_buffer(V.handle2(), V.nnz());
+        viennacl::backend::memory_read(V.handle1(), 0, row_buffer.raw_size(), row_buffer.get());
+        viennacl::backend::memory_read(V.handle2(), 0, col_buffer.raw_size(), col_buffer.get());
+        viennacl::backend::memory_read(V.handle(),  0, sizeof(ScalarType) * V.nnz(), &(V_host.elements[0]));
+
+        for (vcl_size_t i = 0; i <= V.size1(); ++i)
+          V_host.row_buffer[i] = static_cast<unsigned int>(row_buffer[i]);
+        for (vcl_size_t i = 0; i < V.nnz(); ++i)
+          V_host.col_buffer[i] = static_cast<unsigned int>(col_buffer[i]);
+      }
+      else
+        std::fill(V_host.row_buffer.begin(), V_host.row_buffer.end(), 0u);
+
+      // CSR of V^T (counting sort by column):
+      V_host.trans_row_buffer.assign(V.size2() + 1, 0u);
+      V_host.trans_col_buffer.resize(V.nnz());
+      V_host.trans_elements.resize(V.nnz());
+      for (vcl_size_t i = 0; i < V.nnz(); ++i)
+        ++V_host.trans_row_buffer[V_host.col_buffer[i] + 1];
+      for (vcl_size_t j = 0; j < V.size2(); ++j)
+        V_host.trans_row_buffer[j + 1] += V_host.trans_row_buffer[j];
+
+      std::vector<unsigned int> offsets(V_host.trans_row_buffer.begin(), V_host.trans_row_buffer.end() - 1);
+      V_host.norm_squared = 0;
+      for (vcl_size_t r = 0; r < V.size1(); ++r)
+      {
+        for (unsigned int nz = V_host.row_buffer[r]; nz < V_host.row_buffer[r + 1]; ++nz)
+        {
+          unsigned int pos = offsets[V_host.col_buffer[nz]]++;
+          V_host.trans_col_buffer[pos] = static_cast<unsigned int>(r);
+          V_host.trans_elements[pos]   = V_host.elements[nz];
+          V_host.norm_squared += static_cast<double>(V_host.elements[nz]) * V_host.elements[nz];
+        }
+      }
 
+      detail::nmf_host(V_host, W, H, conf);
     }
   }
 }
@@ -19,11 +19,15 @@
 ============================================================================= */
 
 #include <cmath>
+#include <vector>
+#include <algorithm>
 
+#ifdef VIENNACL_WITH_OPENCL
 #include "viennacl/ocl/device.hpp"
 #include "viennacl/ocl/handle.hpp"
 #include "viennacl/ocl/kernel.hpp"
 #include "viennacl/linalg/opencl/kernels/svd.hpp"
+#endif
 #include "viennacl/meta/result_of.hpp"
 #include "viennacl/vector.hpp"
 #include "viennacl/matrix.hpp"
@@ -103,6 +107,160 @@ namespace viennacl
         normalize(v, v.size());
       }
 
+      /** @brief Generates a Householder reflector I - tau v v^T with v_0 = 1, which maps (alpha, x) to (beta, 0)
+      *
+      * @param alpha   First entry of the vector, overwritten with beta on exit
+      * @param x       Remaining entries with stride inc, overwritten with the entries v_1, v_2, ... on exit
+      * @param len     Number of entries in x
+      * @param inc     Stride of x
+      * @return        The coefficient tau
+      */
+      template <typename ScalarType>
+      ScalarType householder_reflector(ScalarType & alpha, ScalarType * x, vcl_size_t len, vcl_size_t inc)
+      {
+        ScalarType x_norm2 = 0;
+        for (vcl_size_t i=0; i<len; ++i)
+          x_norm2 += x[i*inc] * x[i*inc];
+
+        if (x_norm2 <= 0)
+          return 0;
+
+        ScalarType beta = -sign(alpha) * std::sqrt(alpha * alpha + x_norm2);
+        ScalarType tau = (beta - alpha) / beta;
+        ScalarType scale = ScalarType(1) / (alpha - beta);
+        for (vcl_size_t i=0; i<len; ++i)
+          x[i*inc] *= scale;
+        alpha = beta;
+        return tau;
+      }
+
+      /** @brief Symmetric tridiagonal QL algorithm.
+      *
+      * This is derived from the Algol procedures tql2, by Bowdler, Martin, Reinsch, and Wilkinson,
+      * Handbook for Auto. Comp., Vol.ii-Linear Algebra, and the corresponding Fortran subroutine in EISPACK.
+      * After each implicit QL step on the rows l, ..., m the Givens rotations are passed to apply_rotations(l, m, cs, ss).
+      * Rotation i (l <= i < m) acts on the columns i and i+1 of the eigenvector matrix and is applied in the order i = m-1, ..., l.
+      *
+      * @param d                Diagonal. Holds the (unsorted) eigenvalues on exit
+      * @param e                Off-diagonal, e[i] couples i and i+1. e[n-1] is used as workspace. Destroyed on exit
+      * @param n                Size of the matrix
+      * @param eps              Relative tolerance for negligible off-diagonal entries
+      * @param apply_rotations  Functor applying the rotations (cs[i], ss[i]) to the eigenvector matrix
+      */
+      template <typename ScalarType, typename RotationFunctor>
+      void tql2(ScalarType * d, ScalarType * e, vcl_size_t n, ScalarType eps, RotationFunctor & apply_rotations)
+      {
+        if (n == 0)
+          return;
+
+        std::vector<ScalarType> cs(n), ss(n);
+        ScalarType f = 0;
+        ScalarType tst1 = 0;
+
+        e[n-1] = 0;
+        for (vcl_size_t l = 0; l < n; l++)
+        {
+          // Find small subdiagonal element.
+          tst1 = std::max<ScalarType>(tst1, std::fabs(d[l]) + std::fabs(e[l]));
+          vcl_size_t m = l;
+          while (m < n - 1 && std::fabs(e[m]) > eps * tst1)
+            m++;
+
+          // If m == l, d[l] is an eigenvalue, otherwise, iterate.
+          if (m > l)
+          {
+            vcl_size_t iter = 0;
+            do
+            {
+              ++iter;
+
+              // Compute implicit shift
+              ScalarType g = d[l];
+              ScalarType p = (d[l + 1] - g) / (2 * e[l]);
+              ScalarType r = pythag<ScalarType>(p, 1);
+              if (p < 0)
+                r = -r;
+
+              d[l] = e[l] / (p + r);
+              d[l + 1] = e[l] * (p + r);
+              ScalarType dl1 = d[l + 1];
+              ScalarType h = g - d[l];
+              for (vcl_size_t i = l + 2; i < n; i++)
+                d[i] -= h;
+
+              f = f + h;
+
+              // Implicit QL transformation.
+              p = d[m];
+              ScalarType c = 1;
+              ScalarType c2 = c;
+              ScalarType c3 = c;
+              ScalarType el1 = e[l + 1];
+              ScalarType s = 0;
+              ScalarType s2 = 0;
+              for (vcl_size_t i = m; i-- > l; )
+              {
+                c3 = c2;
+                c2 = c;
+                s2 = s;
+                g = c * e[i];
+                h = c * p;
+                r = pythag(p, e[i]);
+                e[i + 1] = s * r;
+                s = e[i] / r;
+                c = p / r;
+                p = c * d[i] - s * g;
+                d[i + 1] = h + s * (c * g + s * d[i]);
+
+                cs[i] = c;
+                ss[i] = s;
+              }
+
+              p = -s * s2 * c3 * el1 * e[l] / dl1;
+              e[l] = s * p;
+              d[l] = c * p;
+
+              apply_rotations(l, m, &(cs[0]), &(ss[0]));
+
+              // Check for convergence.
+            }
+            while (std::fabs(e[l]) > eps * tst1 && iter < ITER_MAX);
+          }
+          d[l] = d[l] + f;
+          e[l] = 0;
+        }
+      }
+
+      /** @brief Applies the Givens rotations of tql2() to the columns of a column-major matrix on the host */
+      template <typename ScalarType>
+      class tql2_host_rotations
+      {
+      public:
+        /** @brief Z has n rows and the leading dimension ldz */
+        tql2_host_rotations(ScalarType * Z, vcl_size_t n, vcl_size_t ldz) : Z_(Z), n_(n), ldz_(ldz) {}
+
+        void operator()(vcl_size_t l, vcl_size_t m, ScalarType const * cs, ScalarType const * ss)
+        {
+          for (vcl_size_t i = m; i-- > l; )
+          {
+            ScalarType * z_i  = Z_ + i * ldz_;
+            ScalarType * z_i1 = Z_ + (i + 1) * ldz_;
+            for (vcl_size_t k = 0; k < n_; k++)
+            {
+              ScalarType h = z_i1[k];
+              z_i1[k] = ss[i] * z_i[k] + cs[i] * h;
+              z_i[k]  = cs[i] * z_i[k] - ss[i] * h;
+            }
+          }
+        }
+
+      private:
+        ScalarType * Z_;
+        vcl_size_t n_;
+        vcl_size_t ldz_;
+      };
+
+#ifdef VIENNACL_WITH_OPENCL
       template <typename MatrixType>
       void transpose(MatrixType & A)
       {
@@ -117,7 +275,7 @@ namespace viennacl
                                      )
                               );
       }
-
+#endif
 
 
       template <typename T>
@@ -143,6 +301,7 @@ namespace viennacl
       }
 
 
+#ifdef VIENNACL_WITH_OPENCL
       template <typename SCALARTYPE, unsigned int ALIGNMENT>
       void copy_vec(viennacl::matrix<SCALARTYPE, row_major, ALIGNMENT>& A,
                     viennacl::vector<SCALARTYPE, ALIGNMENT>& V,
@@ -217,6 +376,7 @@ namespace viennacl
         fast_copy(D, dh);
         fast_copy(S, sh);
       }
+#endif
 
     }
   }
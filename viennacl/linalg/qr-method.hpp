@@ -22,6 +22,7 @@
 #include "viennacl/matrix.hpp"
 
 #include "viennacl/linalg/qr-method-common.hpp"
+#include "viennacl/linalg/tridiagonal_reduction.hpp"
 #include "viennacl/linalg/prod.hpp"
 
 #include <boost/numeric/ublas/vector.hpp>
@@ -37,6 +38,7 @@ namespace viennacl
   {
     namespace detail
     {
+#ifdef VIENNACL_WITH_OPENCL
         template<typename MatrixType, typename VectorType>
         void givens_next(MatrixType& matrix,
                         VectorType& tmp1,
@@ -67,112 +69,46 @@ namespace viennacl
         }
 
 
-        // Symmetric tridiagonal QL algorithm.
-        // This is derived from the Algol procedures tql2, by Bowdler, Martin, Reinsch, and Wilkinson,
-        // Handbook for Auto. Comp., Vol.ii-Linear Algebra, and the corresponding Fortran subroutine in EISPACK.
+        /** @brief Applies the Givens rotations of the QL algorithm to the columns of Q on the GPU */
         template <typename SCALARTYPE, unsigned int ALIGNMENT>
-        void tql2(viennacl::matrix<SCALARTYPE, row_major, ALIGNMENT> & Q,
-                  boost::numeric::ublas::vector<SCALARTYPE> & d,
-                  boost::numeric::ublas::vector<SCALARTYPE> & e)
+        class tql2_gpu_rotations
         {
-            int n = static_cast<int>(Q.size1());
-
-            boost::numeric::ublas::vector<SCALARTYPE> cs(n), ss(n);
-            viennacl::vector<SCALARTYPE> tmp1(n), tmp2(n);
-
-            for (int i = 1; i < n; i++)
-                e(i - 1) = e(i);
-
-            e(n - 1) = 0;
-
-            SCALARTYPE f = 0;
-            SCALARTYPE tst1 = 0;
-            SCALARTYPE eps = 2 * static_cast<SCALARTYPE>(EPS);
-
-            for (int l = 0; l < n; l++)
-            {
-                // Find small subdiagonal element.
-                tst1 = std::max<SCALARTYPE>(tst1, std::fabs(d(l)) + std::fabs(e(l)));
-                int m = l;
-                while (m < n)
-                {
-                    if (std::fabs(e(m)) <= eps * tst1)
-                        break;
-                    m++;
-                }
-
-                // If m == l, d(l) is an eigenvalue, otherwise, iterate.
-                if (m > l)
-                {
-                    int iter = 0;
-                    do
-                    {
-                        iter = iter + 1;  // (Could check iteration count here.)
+        public:
+          tql2_gpu_rotations(viennacl::matrix<SCALARTYPE, row_major, ALIGNMENT> & Q)
+            : Q_(Q), cs_(Q.size1()), ss_(Q.size1()), tmp1_(Q.size1()), tmp2_(Q.size1()) {}
 
-                        // Compute implicit shift
-                        SCALARTYPE g = d(l);
-                        SCALARTYPE p = (d(l + 1) - g) / (2 * e(l));
-                        SCALARTYPE r = pythag<SCALARTYPE>(p, 1);
-                        if (p < 0)
-                        {
-                            r = -r;
-                        }
+          void operator()(vcl_size_t l, vcl_size_t m, SCALARTYPE const * cs, SCALARTYPE const * ss)
+          {
+            std::copy(cs, cs + cs_.size(), cs_.begin());
+            std::copy(ss, ss + ss_.size(), ss_.begin());
+            viennacl::copy(cs_, tmp1_);
+            viennacl::copy(ss_, tmp2_);
 
-                        d(l) = e(l) / (p + r);
-                        d(l + 1) = e(l) * (p + r);
-                        SCALARTYPE dl1 = d(l + 1);
-                        SCALARTYPE h = g - d(l);
-                        for (int i = l + 2; i < n; i++)
-                        {
-                            d(i) -= h;
-                        }
+            givens_next(Q_, tmp1_, tmp2_, static_cast<int>(l), static_cast<int>(m));
+          }
 
-                        f = f + h;
-
-                        // Implicit QL transformation.
-                        p = d(m);
-                        SCALARTYPE c = 1;
-                        SCALARTYPE c2 = c;
-                        SCALARTYPE c3 = c;
-                        SCALARTYPE el1 = e(l + 1);
-                        SCALARTYPE s = 0;
-                        SCALARTYPE s2 = 0;
-                        for (int i = m - 1; i >= l; i--)
-                        {
-                            c3 = c2;
-                            c2 = c;
-                            s2 = s;
-                            g = c * e(i);
-                            h = c * p;
-                            r = pythag(p, e(i));
-                            e(i + 1) = s * r;
-                            s = e(i) / r;
-                            c = p / r;
-                            p = c * d(i) - s * g;
-                            d(i + 1) = h + s * (c * g + s * d(i));
-
-                            cs[i] = c;
-                            ss[i] = s;
-                        }
-
-                        p = -s * s2 * c3 * el1 * e(l) / dl1;
-                        e(l) = s * p;
-                        d(l) = c * p;
+        private:
+          viennacl::matrix<SCALARTYPE, row_major, ALIGNMENT> & Q_;
+          boost::numeric::ublas::vector<SCALARTYPE> cs_, ss_;
+          viennacl::vector<SCALARTYPE> tmp1_, tmp2_;
+        };
 
-                        {
-                            viennacl::copy(cs, tmp1);
-                            viennacl::copy(ss, tmp2);
+        // Symmetric tridiagonal QL algorithm with the eigenvectors accumulated in Q on the GPU, see tql2() in qr-method-common.hpp.
+        // On entry, e(i) couples i-1 and i.
+        template <typename SCALARTYPE, unsigned int ALIGNMENT>
+        void tql2(viennacl::matrix<SCALARTYPE, row_major, ALIGNMENT> & Q,
+                  boost::numeric::ublas::vector<SCALARTYPE> & d,
+                  boost::numeric::ublas::vector<SCALARTYPE> & e)
+        {
+            vcl_size_t n = Q.size1();
+            if (n == 0)
+                return;
 
-                            givens_next(Q, tmp1, tmp2, l, m);
-                        }
+            for (vcl_size_t i = 1; i < n; i++)
+                e(i - 1) = e(i);
 
-                        // Check for convergence.
-                    }
-                    while (std::fabs(e(l)) > eps * tst1);
-                }
-                d(l) = d(l) + f;
-                e(l) = 0;
-            }
+            tql2_gpu_rotations<SCALARTYPE, ALIGNMENT> rotations(Q);
+            tql2(&(d(0)), &(e(0)), n, 2 * static_cast<SCALARTYPE>(EPS), rotations);
         }
 
         template <typename SCALARTYPE, typename MatrixT>
@@ -922,9 +858,49 @@ namespace viennacl
 
             copy(eigen_values, A);
         }
+#endif
+
+        /** @brief Computes the eigenvalues and eigenvectors of a symmetric matrix on the host: two-stage reduction to tridiagonal form, divide-and-conquer for the tridiagonal matrix, and back-transformation of the eigenvectors. */
+        template <typename SCALARTYPE, typename F, unsigned int ALIGNMENT>
+        void qr_method_sym_host(viennacl::matrix<SCALARTYPE, F, ALIGNMENT> & A,
+                                viennacl::matrix<SCALARTYPE, F, ALIGNMENT> & Q,
+                                boost::numeric::ublas::vector<SCALARTYPE> & D)
+        {
+            assert(A.size1() == A.size2() && bool("Input matrix must be square for QR method!"));
+
+            vcl_size_t n = A.size1();
+            D.resize(n);
+            if (n == 0)
+                return;
+
+            std::vector<SCALARTYPE> A_internal(A.internal_size());
+            viennacl::backend::memory_read(A.handle(), 0, sizeof(SCALARTYPE) * A_internal.size(), &(A_internal[0]));
+
+            std::vector<SCALARTYPE> buffer(n * n);
+            for (vcl_size_t j = 0; j < n; j++)
+                for (vcl_size_t i = 0; i < n; i++)
+                    buffer[j * n + i] = A_internal[F::mem_index(i, j, A.internal_size1(), A.internal_size2())];
+
+            std::vector<SCALARTYPE> d(n), Z(n * n);
+            symmetric_eigen_host(&(buffer[0]), n, &(d[0]), &(Z[0]));
+
+            std::fill(A_internal.begin(), A_internal.end(), SCALARTYPE(0));
+            std::vector<SCALARTYPE> Q_internal(Q.internal_size());
+            for (vcl_size_t j = 0; j < n; j++)
+            {
+                D(j) = d[j];
+                A_internal[F::mem_index(j, j, A.internal_size1(), A.internal_size2())] = d[j];
+                for (vcl_size_t i = 0; i < n; i++)
+                    Q_internal[F::mem_index(i, j, Q.internal_size1(), Q.internal_size2())] = Z[j * n + i];
+            }
+
+            viennacl::backend::memory_write(A.handle(), 0, sizeof(SCALARTYPE) * A_internal.size(), &(A_internal[0]));
+            viennacl::backend::memory_write(Q.handle(), 0, sizeof(SCALARTYPE) * Q_internal.size(), &(Q_internal[0]));
+        }
     }
 
 
+#ifdef VIENNACL_WITH_OPENCL
     template <typename SCALARTYPE, typename F, unsigned int ALIGNMENT>
     void qr_method_nsm(viennacl::matrix<SCALARTYPE, F, ALIGNMENT>& A,
                        viennacl::matrix<SCALARTYPE, F, ALIGNMENT>& Q,
@@ -934,6 +910,7 @@ namespace viennacl
     {
         detail::qr_method(A, Q, D, E, false);
     }
+#endif
 
     template <typename SCALARTYPE, typename F, unsigned int ALIGNMENT>
     void qr_method_sym(viennacl::matrix<SCALARTYPE, F, ALIGNMENT>& A,
@@ -941,9 +918,17 @@ namespace viennacl
                        boost::numeric::ublas::vector<SCALARTYPE>& D
                       )
     {
-        boost::numeric::ublas::vector<SCALARTYPE> E(A.size1());
+#ifdef VIENNACL_WITH_OPENCL
+        if (viennacl::traits::active_handle_id(A) == viennacl::OPENCL_MEMORY)
+        {
+            boost::numeric::ublas::vector<SCALARTYPE> E(A.size1());
+
+            detail::qr_method(A, Q, D, E, true);
+            return;
+        }
+#endif
 
-        detail::qr_method(A, Q, D, E, true);
+        detail::qr_method_sym_host(A, Q, D);
     }
 
   }
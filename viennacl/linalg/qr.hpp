@@ -42,6 +42,10 @@
 #include "viennacl/linalg/prod.hpp"
 #include "viennacl/range.hpp"
 
+#ifdef VIENNACL_WITH_OPENMP
+#include <omp.h>
+#endif
+
 namespace viennacl
 {
   namespace linalg
@@ -49,42 +53,369 @@ namespace viennacl
     namespace detail
     {
 
-      template <typename MatrixType, typename VectorType>
-      typename MatrixType::value_type setup_householder_vector_ublas(MatrixType const & A, VectorType & v, MatrixType & matrix_1x1, vcl_size_t j)
+      //
+      // Host kernels for the blocked Householder QR factorization. A block of nb Householder reflectors H_0 ... H_{nb-1} is represented
+      // in compact WY form  H_0 H_1 ... H_{nb-1} = I - V T V^T  (cf. Schreiber, Van Loan: A storage-efficient WY representation for products of Householder transformations),
+      // where the columns of V hold the Householder vectors (with implicit unit entry on the diagonal) and T is upper triangular.
+      // All matrices are stored column-major with leading dimension ld (the number of rows). The k-th Householder vector of a block starting
+      // at row j has its unit entry in row j+k, thus only rows j, ..., ld-1 are referenced.
+      //
+
+      /** @brief Number of rows processed by a thread at once in the blocked updates. Chosen such that a block of V stays in cache. */
+      inline vcl_size_t qr_row_block_size() { return 256; }
+
+      /** @brief Unblocked Householder QR factorization of the panel P of nb columns, where the diagonal of the k-th column is in row j+k.
+      *
+      * On exit, the upper triangular part holds R, the part below the diagonal holds the Householder vectors.
+      *
+      * @param P       Pointer to the first column of the panel (column-major, leading dimension ld)
+      * @param ld      Leading dimension (number of rows of the full matrix)
+      * @param j       Row index of the diagonal element of the first panel column
+      * @param nb      Number of columns in the panel
+      * @param betas   The coefficients beta_k of the reflectors (I - beta_k v_k v_k^T) are written to betas[0], ..., betas[nb-1]
+      */
+      template <typename ScalarType>
+      void qr_panel_householder(ScalarType * P, vcl_size_t ld, vcl_size_t j, vcl_size_t nb, ScalarType * betas)
       {
-        using boost::numeric::ublas::range;
-        using boost::numeric::ublas::project;
+        for (vcl_size_t k=0; k<nb; ++k)
+        {
+          ScalarType * v = P + k*ld;
+          vcl_size_t diag = j+k;
 
-        typedef typename MatrixType::value_type   ScalarType;
+          //compute norm of column below diagonal:
+          ScalarType sigma = 0;
+          for (vcl_size_t i=diag+1; i<ld; ++i)
+            sigma += v[i] * v[i];
 
-        //compute norm of column below diagonal:
-        matrix_1x1 = boost::numeric::ublas::prod( trans(project(A, range(j+1, A.size1()), range(j, j+1))),
-                                                        project(A, range(j+1, A.size1()), range(j, j+1))
-                                                );
-        ScalarType sigma = matrix_1x1(0,0);
-        ScalarType beta = 0;
-        ScalarType A_jj = A(j,j);
+          betas[k] = 0;
+          if (sigma == 0)
+            continue;
 
-        assert( sigma >= 0.0  && bool("sigma must be non-negative!"));
+          ScalarType A_jj = v[diag];
+          ScalarType mu = std::sqrt(sigma + A_jj*A_jj);
+          ScalarType v1 = (A_jj <= 0) ? (A_jj - mu) : (-sigma / (A_jj + mu));
+          betas[k] = static_cast<ScalarType>(2.0) * v1 * v1 / (sigma + v1 * v1);
 
-        //get v from A:
-        v(j,0) = 1.0;
-        project(v, range(j+1, A.size1()), range(0,1)) = project(A, range(j+1, A.size1()), range(j,j+1));
+          //divide v by its diagonal element, the reflected column is mu * e_diag:
+          for (vcl_size_t i=diag+1; i<ld; ++i)
+            v[i] /= v1;
+          v[diag] = mu;
 
-        if (sigma == 0)
-          return 0;
-        else
+          //apply (I - beta v v^T) to the remaining columns of the panel:
+          for (vcl_size_t l=k+1; l<nb; ++l)
+          {
+            ScalarType * a = P + l*ld;
+            ScalarType v_in_col = a[diag];
+            for (vcl_size_t i=diag+1; i<ld; ++i)
+              v_in_col += v[i] * a[i];
+            v_in_col *= betas[k];
+
+            a[diag] -= v_in_col;
+            for (vcl_size_t i=diag+1; i<ld; ++i)
+              a[i] -= v_in_col * v[i];
+          }
+        }
+      }
+
+      /** @brief Partial sums of a reduction within a parallel region.
+      *
+      * Each thread accumulates into its own slot and the slots are added in the order of the thread ids afterwards.
+      * Together with a static loop schedule the result is therefore reproducible for a fixed number of threads.
+      */
+      template <typename ScalarType>
+      class ordered_partial_sums
+      {
+      public:
+        /** @brief size is the number of entries of the reduced array */
+        explicit ordered_partial_sums(vcl_size_t size) : size_(size) {}
+
+        /** @brief Must be called by all threads of the parallel region. Returns the zero-initialized slot of the calling thread. */
+        ScalarType * local()
         {
-          ScalarType mu = std::sqrt(sigma + A_jj*A_jj);
+          vcl_size_t thread_id = 0;
+          vcl_size_t num_threads = 1;
+#ifdef VIENNACL_WITH_OPENMP
+          thread_id   = static_cast<vcl_size_t>(omp_get_thread_num());
+          num_threads = static_cast<vcl_size_t>(omp_get_num_threads());
+          #pragma omp single
+#endif
+          partial_.assign(num_threads * size_ + 1, ScalarType(0));  // one extra entry such that the buffer is never empty
 
-          ScalarType v1 = (A_jj <= 0) ? (A_jj - mu) : (-sigma / (A_jj + mu));
-          beta = static_cast<ScalarType>(2.0) * v1 * v1 / (sigma + v1 * v1);
+          return &(partial_[thread_id * size_]);
+        }
 
-          //divide v by its diagonal element v[j]
-          project(v, range(j+1, A.size1()), range(0,1)) /= v1;
+        /** @brief Adds the partial sums of all threads to result (in the order of the thread ids). Must be called after the parallel region. */
+        void add_to(std::vector<ScalarType> & result) const
+        {
+          if (size_ == 0)
+            return;
+
+          for (vcl_size_t offset = 0; offset + size_ < partial_.size(); offset += size_)
+            for (vcl_size_t i=0; i<size_; ++i)
+              result[i] += partial_[offset + i];
         }
 
-        return beta;
+      private:
+        vcl_size_t size_;
+        std::vector<ScalarType> partial_;
+      };
+
+      /** @brief Computes W = V^T C for the nb Householder vectors in V and the num_cols columns of C. Rows are distributed over the threads.
+      *
+      * @param V          Pointer to the first Householder vector (column-major, leading dimension ld)
+      * @param ld         Leading dimension of V and C
+      * @param j          Row index of the unit entry of the first Householder vector
+      * @param nb         Number of Householder vectors
+      * @param C          Pointer to the first column of C (column-major, leading dimension ld)
+      * @param num_cols   Number of columns of C
+      * @param W          Result, column-major nb x num_cols matrix
+      */
+      template <typename ScalarType>
+      void qr_block_trans_prod(ScalarType const * V, vcl_size_t ld, vcl_size_t j, vcl_size_t nb,
+                               ScalarType const * C, vcl_size_t num_cols, std::vector<ScalarType> & W)
+      {
+        vcl_size_t row_block_size = qr_row_block_size();
+        long num_row_blocks = static_cast<long>((ld - j + row_block_size - 1) / row_block_size);
+
+        W.assign(nb * num_cols, ScalarType(0));
+        ordered_partial_sums<ScalarType> W_partial(W.size());
+#ifdef VIENNACL_WITH_OPENMP
+        #pragma omp parallel if (num_row_blocks > 1)
+#endif
+        {
+          ScalarType * W_local = W_partial.local();
+
+#ifdef VIENNACL_WITH_OPENMP
+          #pragma omp for schedule(static)
+#endif
+          for (long rb=0; rb<num_row_blocks; ++rb)
+          {
+            vcl_size_t row_start = j + static_cast<vcl_size_t>(rb) * row_block_size;
+            vcl_size_t row_stop  = std::min(ld, row_start + row_block_size);
+            for (vcl_size_t c=0; c<num_cols; ++c)
+            {
+              ScalarType const * C_col = C + c*ld;
+              for (vcl_size_t k=0; k<nb; ++k)
+              {
+                ScalarType const * v = V + k*ld;
+                vcl_size_t i = std::max(row_start, j+k);
+                ScalarType temp = 0;
+                if (i == j+k && i < row_stop)
+                  temp = C_col[i++];
+                for (; i<row_stop; ++i)
+                  temp += v[i] * C_col[i];
+                W_local[c*nb + k] += temp;
+              }
+            }
+          }
+        }
+        W_partial.add_to(W);
+      }
+
+      /** @brief Computes the upper triangular factor T of the compact WY representation H_0 ... H_{nb-1} = I - V T V^T
+      *
+      * @param V       Pointer to the first Householder vector (column-major, leading dimension ld)
+      * @param ld      Leading dimension of V
+      * @param j       Row index of the unit entry of the first Householder vector
+      * @param nb      Number of Householder vectors
+      * @param betas   The coefficients beta_0, ..., beta_{nb-1}
+      * @param T       Result, column-major nb x nb upper triangular matrix
+      */
+      template <typename ScalarType, typename BetaIterator>
+      void qr_form_T(ScalarType const * V, vcl_size_t ld, vcl_size_t j, vcl_size_t nb, BetaIterator betas, std::vector<ScalarType> & T)
+      {
+        //S = V^T V, only the strictly upper part is computed:
+        vcl_size_t row_block_size = qr_row_block_size();
+        long num_row_blocks = static_cast<long>((ld - j + row_block_size - 1) / row_block_size);
+        std::vector<ScalarType> S(nb * nb);
+        ordered_partial_sums<ScalarType> S_partial(S.size());
+#ifdef VIENNACL_WITH_OPENMP
+        #pragma omp parallel if (num_row_blocks > 1)
+#endif
+        {
+          ScalarType * S_local = S_partial.local();
+
+#ifdef VIENNACL_WITH_OPENMP
+          #pragma omp for schedule(static)
+#endif
+          for (long rb=0; rb<num_row_blocks; ++rb)
+          {
+            vcl_size_t row_start = j + static_cast<vcl_size_t>(rb) * row_block_size;
+            vcl_size_t row_stop  = std::min(ld, row_start + row_block_size);
+            for (vcl_size_t k=1; k<nb; ++k)
+            {
+              ScalarType const * v_k = V + k*ld;
+              for (vcl_size_t l=0; l<k; ++l)
+              {
+                ScalarType const * v_l = V + l*ld;
+                vcl_size_t i = std::max(row_start, j+k);
+                ScalarType temp = 0;
+                if (i == j+k && i < row_stop)
+                  temp = v_l[i++];
+                for (; i<row_stop; ++i)
+                  temp += v_l[i] * v_k[i];
+                S_local[k*nb + l] += temp;
+              }
+            }
+          }
+        }
+        S_partial.add_to(S);
+
+        // T(k,k) = beta_k,  T(0:k,k) = -beta_k T(0:k,0:k) S(0:k,k):
+        T.assign(nb * nb, ScalarType(0));
+        for (vcl_size_t k=0; k<nb; ++k)
+        {
+          ScalarType beta = static_cast<ScalarType>(betas[k]);
+          T[k*nb + k] = beta;
+          for (vcl_size_t i=0; i<k; ++i)
+          {
+            ScalarType temp = 0;
+            for (vcl_size_t l=i; l<k; ++l)
+              temp += T[l*nb + i] * S[k*nb + l];
+            T[k*nb + i] = -beta * temp;
+          }
+        }
+      }
+
+      /** @brief Applies the block reflector (I - V T V^T) or its transpose (I - V T^T V^T) to the num_cols columns of C
+      *
+      * The update is carried out as C -= V (op(T) (V^T C)), i.e. with two matrix-matrix products, where the rows are distributed over the threads.
+      *
+      * @param V          Pointer to the first Householder vector (column-major, leading dimension ld)
+      * @param ld         Leading dimension of V and C
+      * @param j          Row index of the unit entry of the first Householder vector
+      * @param nb         Number of Householder vectors
+      * @param T          Upper triangular factor as computed by qr_form_T()
+      * @param trans      If true, (I - V T^T V^T) is applied
+      * @param C          Pointer to the first column of C (column-major, leading dimension ld)
+      * @param num_cols   Number of columns of C
+      */
+      template <typename ScalarType>
+      void qr_apply_block_reflector(ScalarType const * V, vcl_size_t ld, vcl_size_t j, vcl_size_t nb,
+                                    std::vector<ScalarType> const & T, bool trans,
+                                    ScalarType * C, vcl_size_t num_cols)
+      {
+        if (num_cols == 0 || nb == 0)
+          return;
+
+        //W = V^T C:
+        std::vector<ScalarType> W;
+        qr_block_trans_prod(V, ld, j, nb, C, num_cols, W);
+
+        //W = op(T) W:
+        std::vector<ScalarType> w(nb);
+        for (vcl_size_t c=0; c<num_cols; ++c)
+        {
+          ScalarType * W_col = &(W[c*nb]);
+          for (vcl_size_t i=0; i<nb; ++i)
+          {
+            ScalarType temp = 0;
+            if (trans) //T^T is lower triangular
+              for (vcl_size_t l=0; l<=i; ++l)
+                temp += T[i*nb + l] * W_col[l];
+            else
+              for (vcl_size_t l=i; l<nb; ++l)
+                temp += T[l*nb + i] * W_col[l];
+            w[i] = temp;
+          }
+          std::copy(w.begin(), w.end(), W_col);
+        }
+
+        //C -= V W:
+        vcl_size_t row_block_size = qr_row_block_size();
+        long num_row_blocks = static_cast<long>((ld - j + row_block_size - 1) / row_block_size);
+#ifdef VIENNACL_WITH_OPENMP
+        #pragma omp parallel for if (num_row_blocks > 1)
+#endif
+        for (long rb=0; rb<num_row_blocks; ++rb)
+        {
+          vcl_size_t row_start = j + static_cast<vcl_size_t>(rb) * row_block_size;
+          vcl_size_t row_stop  = std::min(ld, row_start + row_block_size);
+          for (vcl_size_t c=0; c<num_cols; ++c)
+          {
+            ScalarType * C_col = C + c*ld;
+            for (vcl_size_t k=0; k<nb; ++k)
+            {
+              ScalarType const * v = V + k*ld;
+              ScalarType W_kc = W[c*nb + k];
+              vcl_size_t i = std::max(row_start, j+k);
+              if (i == j+k && i < row_stop)
+                C_col[i++] -= W_kc;
+              for (; i<row_stop; ++i)
+                C_col[i] -= v[i] * W_kc;
+            }
+          }
+        }
+      }
+
+      /** @brief Copies the columns col_start, ..., col_start+num_cols-1 of A into the column-major buffer P with leading dimension A.size1()
+      */
+      template <typename MatrixType, typename ScalarType>
+      void qr_copy_columns_to_buffer(MatrixType const & A, vcl_size_t col_start, vcl_size_t num_cols, std::vector<ScalarType> & P)
+      {
+        vcl_size_t ld = A.size1();
+        P.resize(ld * num_cols);
+        for (vcl_size_t i=0; i<ld; ++i)
+          for (vcl_size_t k=0; k<num_cols; ++k)
+            P[k*ld + i] = A(i, col_start + k);
+      }
+
+      /** @brief Blocked Householder QR factorization of the column-major m x n buffer A (leading dimension m)
+      *
+      * @param A            Pointer to the buffer. On exit, R is stored in the upper triangular part, the Householder vectors below the diagonal.
+      * @param m            Number of rows
+      * @param n            Number of columns
+      * @param block_size   Number of columns per panel
+      * @param betas        The min(m,n) coefficients of the Householder reflectors are written to betas[0], ..., betas[min(m,n)-1]
+      */
+      template <typename ScalarType>
+      void qr_factor_buffer(ScalarType * A, vcl_size_t m, vcl_size_t n, vcl_size_t block_size, ScalarType * betas)
+      {
+        std::vector<ScalarType> T;
+        vcl_size_t j_max = std::min(m, n);
+        for (vcl_size_t j = 0; j < j_max; j += block_size)
+        {
+          vcl_size_t effective_block_size = std::min(j_max, j+block_size) - j;
+          ScalarType * panel = A + j*m;
+
+          //determine Householder vectors:
+          qr_panel_householder(panel, m, j, effective_block_size, betas + j);
+
+          //apply (I - V T V^T)^T to the remaining columns of A:
+          if (n > j + effective_block_size)
+          {
+            qr_form_T(panel, m, j, effective_block_size, betas + j, T);
+            qr_apply_block_reflector(panel, m, j, effective_block_size, T, true, panel + effective_block_size*m, n - j - effective_block_size);
+          }
+        }
+      }
+
+      /** @brief Applies Q = H_0 ... H_{k-1} or Q^T to the num_cols columns of C, where the reflectors are stored as obtained from qr_factor_buffer()
+      *
+      * @param QR           Pointer to the factored buffer (column-major, leading dimension m)
+      * @param m            Number of rows of QR and C
+      * @param k            Number of Householder reflectors
+      * @param betas        The coefficients of the reflectors
+      * @param trans        If true, Q^T is applied, otherwise Q
+      * @param C            Pointer to the first column of C (column-major, leading dimension m)
+      * @param num_cols     Number of columns of C
+      * @param block_size   Number of reflectors per block
+      */
+      template <typename ScalarType>
+      void qr_apply_Q_buffer(ScalarType const * QR, vcl_size_t m, vcl_size_t k, ScalarType const * betas, bool trans,
+                             ScalarType * C, vcl_size_t num_cols, vcl_size_t block_size)
+      {
+        std::vector<ScalarType> T;
+        vcl_size_t num_blocks = (k + block_size - 1) / block_size;
+        for (vcl_size_t b=0; b<num_blocks; ++b)
+        {
+          //Q^T is applied block by block starting with the first, Q starting with the last:
+          vcl_size_t j = trans ? b * block_size : (num_blocks - b - 1) * block_size;
+          vcl_size_t effective_block_size = std::min(k, j + block_size) - j;
+
+          qr_form_T(QR + j*m, m, j, effective_block_size, betas + j, T);
+          qr_apply_block_reflector(QR + j*m, m, j, effective_block_size, T, trans, C, num_cols);
+        }
       }
 
 
@@ -129,34 +460,6 @@ namespace viennacl
       }
 
 
-      // Apply (I - beta v v^T) to the k-th column of A, where v is the reflector starting at j-th row/column
-      template <typename MatrixType, typename VectorType, typename ScalarType>
-      void householder_reflect(MatrixType & A, VectorType & v, ScalarType beta, vcl_size_t j, vcl_size_t k)
-      {
-        ScalarType v_in_col = A(j,k);
-        for (vcl_size_t i=j+1; i<A.size1(); ++i)
-          v_in_col += v[i] * A(i,k);
-
-        //assert(v[j] == 1.0);
-
-        for (vcl_size_t i=j; i<A.size1(); ++i)
-          A(i,k) -= beta * v_in_col * v[i];
-      }
-
-      template <typename MatrixType, typename VectorType, typename ScalarType>
-      void householder_reflect_ublas(MatrixType & A, VectorType & v, MatrixType & matrix_1x1, ScalarType beta, vcl_size_t j, vcl_size_t k)
-      {
-        using boost::numeric::ublas::range;
-        using boost::numeric::ublas::project;
-
-        ScalarType v_in_col = A(j,k);
-        matrix_1x1 = boost::numeric::ublas::prod(trans(project(v, range(j+1, A.size1()), range(0, 1))),
-                                                       project(A, range(j+1, A.size1()), range(k,k+1)));
-        v_in_col += matrix_1x1(0,0);
-
-        project(A, range(j, A.size1()), range(k, k+1)) -= (beta * v_in_col) * project(v, range(j, A.size1()), range(0, 1));
-      }
-
       template <typename MatrixType, typename VectorType, typename ScalarType>
       void householder_reflect_viennacl(MatrixType & A, VectorType & v, MatrixType & matrix_1x1, ScalarType beta, vcl_size_t j, vcl_size_t k)
       {
@@ -179,34 +482,6 @@ namespace viennacl
       }
 
 
-      // Apply (I - beta v v^T) to A, where v is the reflector starting at j-th row/column
-      template <typename MatrixType, typename VectorType, typename ScalarType>
-      void householder_reflect(MatrixType & A, VectorType & v, ScalarType beta, vcl_size_t j)
-      {
-        vcl_size_t column_end = A.size2();
-
-        for (vcl_size_t k=j; k<column_end; ++k) //over columns
-          householder_reflect(A, v, beta, j, k);
-      }
-
-
-      template <typename MatrixType, typename VectorType>
-      void write_householder_to_A(MatrixType & A, VectorType const & v, vcl_size_t j)
-      {
-        for (vcl_size_t i=j+1; i<A.size1(); ++i)
-          A(i,j) = v[i];
-      }
-
-      template <typename MatrixType, typename VectorType>
-      void write_householder_to_A_ublas(MatrixType & A, VectorType const & v, vcl_size_t j)
-      {
-        using boost::numeric::ublas::range;
-        using boost::numeric::ublas::project;
-
-        //VectorType temp = project(v, range(j+1, A.size1()));
-        project( A, range(j+1, A.size1()), range(j, j+1) ) = project(v, range(j+1, A.size1()), range(0, 1) );;
-      }
-
       template <typename MatrixType, typename VectorType>
       void write_householder_to_A_viennacl(MatrixType & A, VectorType const & v, vcl_size_t j)
       {
@@ -221,89 +496,31 @@ namespace viennacl
 
       /** @brief Implementation of inplace-QR factorization for a general Boost.uBLAS compatible matrix A
       *
+      * The panels of block_size columns are factored on a contiguous copy of A. Their reflectors are accumulated into compact WY form (V, T),
+      * which is applied to the trailing matrix by matrix-matrix products.
+      *
       * @param A            A dense compatible to Boost.uBLAS
-      * @param block_size   The block size to be used. The number of columns of A must be a multiple of block_size
+      * @param block_size   The block size to be used.
       */
       template<typename MatrixType>
       std::vector<typename MatrixType::value_type> inplace_qr_ublas(MatrixType & A, vcl_size_t block_size = 32)
       {
         typedef typename MatrixType::value_type   ScalarType;
-        typedef boost::numeric::ublas::matrix_range<MatrixType>  MatrixRange;
-
-        using boost::numeric::ublas::range;
-        using boost::numeric::ublas::project;
-
-        std::vector<ScalarType> betas(A.size2());
-        MatrixType v(A.size1(), 1);
-        MatrixType matrix_1x1(1,1);
 
-        MatrixType Y(A.size1(), block_size); Y.clear(); Y.resize(A.size1(), block_size);
-        MatrixType W(A.size1(), block_size); W.clear(); W.resize(A.size1(), block_size);
-
-        //run over A in a block-wise manner:
-        for (vcl_size_t j = 0; j < std::min(A.size1(), A.size2()); j += block_size)
-        {
-          vcl_size_t effective_block_size = std::min(std::min(A.size1(), A.size2()), j+block_size) - j;
+        vcl_size_t m = A.size1();
+        vcl_size_t n = A.size2();
+        std::vector<ScalarType> betas(n);
+        if (m == 0 || n == 0)
+          return betas;
 
-          //determine Householder vectors:
-          for (vcl_size_t k = 0; k < effective_block_size; ++k)
-          {
-            betas[j+k] = detail::setup_householder_vector_ublas(A, v, matrix_1x1, j+k);
+        std::vector<ScalarType> buffer;
+        qr_copy_columns_to_buffer(A, 0, n, buffer);
 
-            for (vcl_size_t l = k; l < effective_block_size; ++l)
-              detail::householder_reflect_ublas(A, v, matrix_1x1, betas[j+k], j+k, j+l);
+        qr_factor_buffer(&(buffer[0]), m, n, block_size, &(betas[0]));
 
-            detail::write_householder_to_A_ublas(A, v, j+k);
-          }
-
-          //
-          // Setup Y:
-          //
-          Y.clear();  Y.resize(A.size1(), block_size);
-          for (vcl_size_t k = 0; k < effective_block_size; ++k)
-          {
-            //write Householder to Y:
-            Y(j+k,k) = 1.0;
-            project(Y, range(j+k+1, A.size1()), range(k, k+1)) = project(A, range(j+k+1, A.size1()), range(j+k, j+k+1));
-          }
-
-          //
-          // Setup W:
-          //
-
-          //first vector:
-          W.clear();  W.resize(A.size1(), block_size);
-          W(j, 0) = -betas[j];
-          project(W, range(j+1, A.size1()), range(0, 1)) = -betas[j] * project(A, range(j+1, A.size1()), range(j, j+1));
-
-
-          //k-th column of W is given by -beta * (Id + W*Y^T) v_k, where W and Y have k-1 columns
-          for (vcl_size_t k = 1; k < effective_block_size; ++k)
-          {
-            MatrixRange Y_old = project(Y, range(j, A.size1()), range(0, k));
-            MatrixRange v_k   = project(Y, range(j, A.size1()), range(k, k+1));
-            MatrixRange W_old = project(W, range(j, A.size1()), range(0, k));
-            MatrixRange z     = project(W, range(j, A.size1()), range(k, k+1));
-
-            MatrixType YT_prod_v = boost::numeric::ublas::prod(boost::numeric::ublas::trans(Y_old), v_k);
-            z = - betas[j+k] * (v_k + prod(W_old, YT_prod_v));
-          }
-
-          //
-          //apply (I+WY^T)^T = I + Y W^T to the remaining columns of A:
-          //
-
-          if (A.size2() - j - effective_block_size > 0)
-          {
-
-            MatrixRange A_part(A, range(j, A.size1()), range(j+effective_block_size, A.size2()));
-            MatrixRange W_part(W, range(j, A.size1()), range(0, effective_block_size));
-            MatrixType temp = boost::numeric::ublas::prod(trans(W_part), A_part);
-
-            A_part += prod(project(Y, range(j, A.size1()), range(0, effective_block_size)),
-                          temp);
-          }
-        }
+        for (vcl_size_t i=0; i<m; ++i)
+          for (vcl_size_t k=0; k<n; ++k)
+            A(i,k) = buffer[k*m + i];
 
         return betas;
       }
@@ -414,12 +631,12 @@ namespace viennacl
 
 
       //MatrixType is ViennaCL-matrix
-      /** @brief Implementation of a hybrid QR factorization using uBLAS on the CPU and ViennaCL for GPUs (or multi-core CPU)
+      /** @brief Implementation of a hybrid QR factorization using the CPU for the panel factorization and ViennaCL for the update of the trailing matrix on GPUs (or multi-core CPU)
       *
       * Prefer the use of the convenience interface inplace_qr()
       *
       * @param A            A dense ViennaCL matrix to be factored
-      * @param block_size   The block size to be used. The number of columns of A must be a multiple of block_size
+      * @param block_size   The block size to be used.
       */
       template<typename MatrixType>
       std::vector< typename viennacl::result_of::cpu_value_type< typename MatrixType::value_type >::type >
@@ -429,122 +646,73 @@ namespace viennacl
 
         typedef viennacl::matrix_range<MatrixType>                    VCLMatrixRange;
         typedef boost::numeric::ublas::matrix<ScalarType>             UblasMatrixType;
-        typedef boost::numeric::ublas::matrix_range<UblasMatrixType>  UblasMatrixRange;
-
-        std::vector<ScalarType> betas(A.size2());
-        UblasMatrixType v(A.size1(), 1);
-        UblasMatrixType matrix_1x1(1,1);
 
-        UblasMatrixType ublasW(A.size1(), block_size); ublasW.clear(); ublasW.resize(A.size1(), block_size);
-        UblasMatrixType ublasY(A.size1(), block_size); ublasY.clear(); ublasY.resize(A.size1(), block_size);
+        vcl_size_t m = A.size1();
+        vcl_size_t n = A.size2();
+        std::vector<ScalarType> betas(n);
 
-        UblasMatrixType ublasA(A.size1(), A.size1());
+        UblasMatrixType ublasW(m, block_size);
+        UblasMatrixType ublasY(m, block_size);
+        UblasMatrixType ublasA_part(m, block_size);
+        std::vector<ScalarType> panel;
+        std::vector<ScalarType> T;
 
-        MatrixType vclW(ublasW.size1(), ublasW.size2());
-        MatrixType vclY(ublasY.size1(), ublasY.size2());
+        MatrixType vclW(m, block_size);
+        MatrixType vclY(m, block_size);
 
 
         //run over A in a block-wise manner:
-        for (vcl_size_t j = 0; j < std::min(A.size1(), A.size2()); j += block_size)
+        for (vcl_size_t j = 0; j < std::min(m, n); j += block_size)
         {
-          vcl_size_t effective_block_size = std::min(std::min(A.size1(), A.size2()), j+block_size) - j;
-          UblasMatrixRange ublasA_part = boost::numeric::ublas::project(ublasA,
-                                                                        boost::numeric::ublas::range(0, A.size1()),
-                                                                        boost::numeric::ublas::range(j, j + effective_block_size));
-          viennacl::copy(viennacl::project(A,
-                                          viennacl::range(0, A.size1()),
-                                          viennacl::range(j, j+effective_block_size)),
-                         ublasA_part
-                        );
-
-          //determine Householder vectors:
-          for (vcl_size_t k = 0; k < effective_block_size; ++k)
-          {
-            betas[j+k] = detail::setup_householder_vector_ublas(ublasA, v, matrix_1x1, j+k);
-
-            for (vcl_size_t l = k; l < effective_block_size; ++l)
-              detail::householder_reflect_ublas(ublasA, v, matrix_1x1, betas[j+k], j+k, j+l);
-
-            detail::write_householder_to_A_ublas(ublasA, v, j+k);
-          }
-
-          //
-          // Setup Y:
-          //
-          ublasY.clear();  ublasY.resize(A.size1(), block_size);
-          for (vcl_size_t k = 0; k < effective_block_size; ++k)
-          {
-            //write Householder to Y:
-            ublasY(j+k,k) = 1.0;
-            boost::numeric::ublas::project(ublasY,
-                                           boost::numeric::ublas::range(j+k+1, A.size1()),
-                                           boost::numeric::ublas::range(k, k+1))
-              = boost::numeric::ublas::project(ublasA,
-                                               boost::numeric::ublas::range(j+k+1, A.size1()),
-                                               boost::numeric::ublas::range(j+k, j+k+1));
-          }
-
-          //
-          // Setup W:
-          //
-
-          //first vector:
-          ublasW.clear();  ublasW.resize(A.size1(), block_size);
-          ublasW(j, 0) = -betas[j];
-          boost::numeric::ublas::project(ublasW,
-                                        boost::numeric::ublas::range(j+1, A.size1()),
-                                        boost::numeric::ublas::range(0, 1))
-            = -betas[j] * boost::numeric::ublas::project(ublasA,
-                                                          boost::numeric::ublas::range(j+1, A.size1()),
-                                                          boost::numeric::ublas::range(j, j+1));
-
-
-          //k-th column of W is given by -beta * (Id + W*Y^T) v_k, where W and Y have k-1 columns
-          for (vcl_size_t k = 1; k < effective_block_size; ++k)
-          {
-            UblasMatrixRange Y_old = boost::numeric::ublas::project(ublasY,
-                                                                    boost::numeric::ublas::range(j, A.size1()),
-                                                                    boost::numeric::ublas::range(0, k));
-            UblasMatrixRange v_k   = boost::numeric::ublas::project(ublasY,
-                                                                    boost::numeric::ublas::range(j, A.size1()),
-                                                                    boost::numeric::ublas::range(k, k+1));
-            UblasMatrixRange W_old = boost::numeric::ublas::project(ublasW,
-                                                                    boost::numeric::ublas::range(j, A.size1()),
-                                                                    boost::numeric::ublas::range(0, k));
-            UblasMatrixRange z     = boost::numeric::ublas::project(ublasW,
-                                                                    boost::numeric::ublas::range(j, A.size1()),
-                                                                    boost::numeric::ublas::range(k, k+1));
-
-            UblasMatrixType YT_prod_v = boost::numeric::ublas::prod(boost::numeric::ublas::trans(Y_old), v_k);
-            z = - betas[j+k] * (v_k + prod(W_old, YT_prod_v));
-          }
-
-
-
-          //
-          //apply (I+WY^T)^T = I + Y W^T to the remaining columns of A:
-          //
+          vcl_size_t effective_block_size = std::min(std::min(m, n), j+block_size) - j;
 
-          VCLMatrixRange A_part = viennacl::project(A,
-                                                    viennacl::range(0, A.size1()),
-                                                    viennacl::range(j, j+effective_block_size));
+          ublasA_part.resize(m, effective_block_size, false);
+          VCLMatrixRange A_panel = viennacl::project(A, viennacl::range(0, m), viennacl::range(j, j+effective_block_size));
+          viennacl::copy(A_panel, ublasA_part);
 
-          viennacl::copy(boost::numeric::ublas::project(ublasA,
-                                                        boost::numeric::ublas::range(0, A.size1()),
-                                                        boost::numeric::ublas::range(j, j+effective_block_size)),
-                        A_part);
+          //determine Householder vectors and the compact WY representation:
+          qr_copy_columns_to_buffer(ublasA_part, 0, effective_block_size, panel);
+          qr_panel_householder(&(panel[0]), m, j, effective_block_size, &(betas[j]));
+          qr_form_T(&(panel[0]), m, j, effective_block_size, betas.begin() + static_cast<long>(j), T);
 
-          viennacl::copy(ublasW, vclW);
-          viennacl::copy(ublasY, vclY);
+          for (vcl_size_t i=0; i<m; ++i)
+            for (vcl_size_t k=0; k<effective_block_size; ++k)
+              ublasA_part(i,k) = panel[k*m + i];
+          viennacl::copy(ublasA_part, A_panel);
 
           if (A.size2() > j + effective_block_size)
           {
-
-            VCLMatrixRange A_part(A, viennacl::range(j, A.size1()), viennacl::range(j+effective_block_size, A.size2()));
-            VCLMatrixRange W_part(vclW, viennacl::range(j, A.size1()), viennacl::range(0, effective_block_size));
+            //
+            // Setup Y = V and W = - V T, such that (I - V T V^T)^T = I + Y W^T:
+            //
+            ublasY.clear();
+            ublasW.clear();
+            for (vcl_size_t k = 0; k < effective_block_size; ++k)
+            {
+              ublasY(j+k,k) = 1.0;
+              for (vcl_size_t i=j+k+1; i<m; ++i)
+                ublasY(i,k) = panel[k*m + i];
+            }
+            for (vcl_size_t i=j; i<m; ++i)
+              for (vcl_size_t k=0; k<effective_block_size; ++k)
+              {
+                ScalarType temp = 0;
+                for (vcl_size_t l=0; l<=k; ++l)
+                  temp += ublasY(i,l) * T[k*effective_block_size + l];
+                ublasW(i,k) = -temp;
+              }
+
+            viennacl::copy(ublasW, vclW);
+            viennacl::copy(ublasY, vclY);
+
+            //
+            //apply (I+WY^T)^T = I + Y W^T to the remaining columns of A:
+            //
+            VCLMatrixRange A_part(A, viennacl::range(j, m), viennacl::range(j+effective_block_size, n));
+            VCLMatrixRange W_part(vclW, viennacl::range(j, m), viennacl::range(0, effective_block_size));
             MatrixType temp = viennacl::linalg::prod(trans(W_part), A_part);
 
-            A_part += viennacl::linalg::prod(viennacl::project(vclY, viennacl::range(j, A.size1()), viennacl::range(0, effective_block_size)),
+            A_part += viennacl::linalg::prod(viennacl::project(vclY, viennacl::range(j, m), viennacl::range(0, effective_block_size)),
                                              temp);
           }
         }
@@ -559,14 +727,21 @@ namespace viennacl
 
 
 
-    //takes an inplace QR matrix A and generates Q and R explicitly
+    /** @brief Takes an inplace QR matrix A and generates Q and R explicitly
+     *
+     *  Q is accumulated backwards block by block, where each block of reflectors is applied in compact WY form.
+     *
+     *  @param A            A matrix holding the Householder reflectors in the lower triangular part. Typically obtained from calling inplace_qr() on the original matrix
+     *  @param betas        The scalars beta_i for each Householder reflector (I - beta_i v_i v_i^T)
+     *  @param Q            The orthogonal matrix Q
+     *  @param R            The upper triangular matrix R
+     *  @param block_size   The number of reflectors per block
+     */
     template <typename MatrixType, typename VectorType>
-    void recoverQ(MatrixType const & A, VectorType const & betas, MatrixType & Q, MatrixType & R)
+    void recoverQ(MatrixType const & A, VectorType const & betas, MatrixType & Q, MatrixType & R, vcl_size_t block_size = 16)
     {
       typedef typename MatrixType::value_type   ScalarType;
 
-      std::vector<ScalarType> v(A.size1());
-
       Q.clear();
       R.clear();
 
@@ -579,49 +754,73 @@ namespace viennacl
           R(i,j) = A(i,j);
 
       //
-      // Recover Q by applying all the Householder reflectors to the identity matrix:
+      // Recover Q by applying all the Householder reflectors to the identity matrix.
+      // The blocks are applied in reverse order, hence the first j columns are still unit vectors when the block starting at j is applied and can be skipped:
       //
-      for (vcl_size_t i=0; i<Q.size1(); ++i)
-        Q(i,i) = 1.0;
-
+      vcl_size_t m = Q.size1();
+      vcl_size_t q_cols = Q.size2();
+      std::vector<ScalarType> Q_buffer(m * q_cols);
+      for (vcl_size_t i=0; i<std::min(m, q_cols); ++i)
+        Q_buffer[i*m + i] = 1.0;
+
+      std::vector<ScalarType> panel;
+      std::vector<ScalarType> T;
       vcl_size_t j_max = std::min(A.size1(), A.size2());
-      for (vcl_size_t j=0; j<j_max; ++j)
+      for (vcl_size_t block_end = j_max; block_end > 0; )
       {
-        vcl_size_t col_index = j_max - j - 1;
-        v[col_index] = 1.0;
-        for (vcl_size_t i=col_index+1; i<A.size1(); ++i)
-          v[i] = A(i, col_index);
+        vcl_size_t j = ((block_end - 1) / block_size) * block_size;
+        vcl_size_t effective_block_size = block_end - j;
 
-        if (betas[col_index] != 0)
-          detail::householder_reflect(Q, v, betas[col_index], col_index);
+        detail::qr_copy_columns_to_buffer(A, j, effective_block_size, panel);
+        detail::qr_form_T(&(panel[0]), m, j, effective_block_size, betas.begin() + static_cast<long>(j), T);
+        if (q_cols > j)
+          detail::qr_apply_block_reflector(&(panel[0]), m, j, effective_block_size, T, false, &(Q_buffer[0]) + j*m, q_cols - j);
+
+        block_end = j;
       }
+
+      for (vcl_size_t i=0; i<m; ++i)
+        for (vcl_size_t k=0; k<q_cols; ++k)
+          Q(i,k) = Q_buffer[k*m + i];
     }
 
 
     /** @brief Computes Q^T b, where Q is an implicit orthogonal matrix defined via its Householder reflectors stored in A.
      *
-     *  @param A      A matrix holding the Householder reflectors in the lower triangular part. Typically obtained from calling inplace_qr() on the original matrix
-     *  @param betas  The scalars beta_i for each Householder reflector (I - beta_i v_i v_i^T)
-     *  @param b      The vector b to which the result Q^T b is directly written to
+     *  The reflectors are applied block by block in compact WY form.
+     *
+     *  @param A            A matrix holding the Householder reflectors in the lower triangular part. Typically obtained from calling inplace_qr() on the original matrix
+     *  @param betas        The scalars beta_i for each Householder reflector (I - beta_i v_i v_i^T)
+     *  @param b            The vector b to which the result Q^T b is directly written to
+     *  @param block_size   The number of reflectors per block
      */
     template <typename MatrixType, typename VectorType1, typename VectorType2>
-    void inplace_qr_apply_trans_Q(MatrixType const & A, VectorType1 const & betas, VectorType2 & b)
+    void inplace_qr_apply_trans_Q(MatrixType const & A, VectorType1 const & betas, VectorType2 & b, vcl_size_t block_size = 16)
     {
       typedef typename viennacl::result_of::cpu_value_type<typename MatrixType::value_type>::type   ScalarType;
 
+      vcl_size_t m = A.size1();
+      std::vector<ScalarType> b_buffer(m);
+      for (vcl_size_t i=0; i<m; ++i)
+        b_buffer[i] = b[i];
+
       //
-      // Apply Q^T = (I - beta_m v_m v_m^T) \times ... \times (I - beta_0 v_0 v_0^T) by applying all the Householder reflectors to b:
+      // Apply Q^T = (I - beta_m v_m v_m^T) \times ... \times (I - beta_0 v_0 v_0^T) by applying all blocks of Householder reflectors to b:
       //
-      for (vcl_size_t col_index=0; col_index<std::min(A.size1(), A.size2()); ++col_index)
+      std::vector<ScalarType> panel;
+      std::vector<ScalarType> T;
+      vcl_size_t j_max = std::min(A.size1(), A.size2());
+      for (vcl_size_t j=0; j<j_max; j += block_size)
       {
-        ScalarType v_in_b = b[col_index];
-        for (vcl_size_t i=col_index+1; i<A.size1(); ++i)
-          v_in_b += A(i, col_index) * b[i];
+        vcl_size_t effective_block_size = std::min(j_max, j + block_size) - j;
 
-        b[col_index] -= betas[col_index] * v_in_b;
-        for (vcl_size_t i=col_index+1; i<A.size1(); ++i)
-          b[i] -= betas[col_index] * A(i, col_index) * v_in_b;
+        detail::qr_copy_columns_to_buffer(A, j, effective_block_size, panel);
+        detail::qr_form_T(&(panel[0]), m, j, effective_block_size, betas.begin() + static_cast<long>(j), T);
+        detail::qr_apply_block_reflector(&(panel[0]), m, j, effective_block_size, T, true, &(b_buffer[0]), 1);
       }
+
+      for (vcl_size_t i=0; i<m; ++i)
+        b[i] = b_buffer[i];
     }
 
     template <typename T, typename F, unsigned int ALIGNMENT, typename VectorType1, unsigned int A2>
@@ -646,6 +845,16 @@ namespace viennacl
     template<typename T, typename F, unsigned int ALIGNMENT>
     std::vector<T> inplace_qr(viennacl::matrix<T, F, ALIGNMENT> & A, vcl_size_t block_size = 16)
     {
+      if (viennacl::traits::active_handle_id(A) == viennacl::MAIN_MEMORY)
+      {
+        //no device involved, thus run the blocked factorization entirely on the host:
+        boost::numeric::ublas::matrix<T> ublas_A(A.size1(), A.size2());
+        viennacl::copy(A, ublas_A);
+        std::vector<T> betas = detail::inplace_qr_ublas(ublas_A, block_size);
+        viennacl::copy(ublas_A, A);
+        return betas;
+      }
+
       return detail::inplace_qr_hybrid(A, block_size);
     }
 
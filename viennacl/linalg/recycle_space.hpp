@@ -0,0 +1,91 @@
+#ifndef VIENNACL_LINALG_RECYCLE_SPACE_HPP_
+#define VIENNACL_LINALG_RECYCLE_SPACE_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/recycle_space.hpp
+    @brief A container for the subspace which is carried over between subsequent solver runs by the Krylov subspace recycling methods (deflated CG, GCRO-DR).
+*/
+
+#include <vector>
+#include "viennacl/forwards.h"
+#include "viennacl/traits/size.hpp"
+
+namespace viennacl
+{
+  namespace linalg
+  {
+
+    /** @brief Holds the recycled subspace of a sequence of linear systems with slowly changing system matrices or right hand sides.
+    *
+    * The object is passed to each solve() call of the sequence. The solver first projects the recycled subspace out of the new system
+    * and updates the subspace with the information gathered during the solve afterwards.
+    * For deflated CG, the vectors are approximate eigenvectors of the system matrix to the smallest eigenvalues.
+    * For GCRO-DR, the vectors span an approximately invariant subspace of the (right preconditioned) system matrix to the eigenvalues of smallest modulus.
+    *
+    * The images of the recycled vectors under the operator are recomputed at the beginning of each solve, hence the system matrix may change between the solves.
+    * The subspace is discarded if the size of the system changes.
+    */
+    template <typename VectorType>
+    class recycle_space
+    {
+      public:
+        /** @brief The constructor
+        *
+        * @param max_size    Maximum number of vectors kept in the recycled subspace
+        */
+        explicit recycle_space(vcl_size_t max_size = 8) : max_size_(max_size) {}
+
+        /** @brief Returns the maximum number of vectors in the recycled subspace */
+        vcl_size_t max_size() const { return max_size_; }
+
+        /** @brief Returns the current number of vectors in the recycled subspace (zero before the first solve) */
+        vcl_size_t size() const { return U_.size(); }
+
+        /** @brief Discards the recycled subspace, for example if the next system is unrelated to the previous ones */
+        void clear()
+        {
+          U_.clear();
+          C_.clear();
+        }
+
+        /** @brief Discards the recycled subspace if its vectors do not match the size of the system with right hand side 'rhs'. Called by the solvers. */
+        void prepare(VectorType const & rhs)
+        {
+          if (U_.size() > 0 && viennacl::traits::size(U_[0]) != viennacl::traits::size(rhs))
+            clear();
+        }
+
+        /** @brief The vectors spanning the recycled subspace */
+        std::vector<VectorType>       & U()       { return U_; }
+        std::vector<VectorType> const & U() const { return U_; }
+
+        /** @brief The images of the vectors in U() under the operator. Only meaningful during a solver run. */
+        std::vector<VectorType>       & C()       { return C_; }
+        std::vector<VectorType> const & C() const { return C_; }
+
+      private:
+        vcl_size_t max_size_;
+        std::vector<VectorType> U_;
+        std::vector<VectorType> C_;
+    };
+
+  }
+}
+
+#endif
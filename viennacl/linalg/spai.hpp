@@ -41,8 +41,10 @@
 #include "viennacl/linalg/detail/spai/spai-dynamic.hpp"
 #include "viennacl/linalg/detail/spai/spai-static.hpp"
 #include "viennacl/linalg/detail/spai/sparse_vector.hpp"
-#include "viennacl/linalg/detail/spai/block_matrix.hpp"
-#include "viennacl/linalg/detail/spai/block_vector.hpp"
+#ifdef VIENNACL_WITH_OPENCL
+  #include "viennacl/linalg/detail/spai/block_matrix.hpp"
+  #include "viennacl/linalg/detail/spai/block_vector.hpp"
+#endif
 #include "viennacl/linalg/detail/spai/fspai.hpp"
 #include "viennacl/linalg/detail/spai/spai.hpp"
 
@@ -138,10 +140,6 @@ namespace viennacl
             spai_precond(const MatrixType& A,
                          const spai_tag& tag): tag_(tag), spai_m_(viennacl::traits::context(A))
             {
-                viennacl::ocl::context & ctx = const_cast<viennacl::ocl::context &>(viennacl::traits::opencl_handle(A).context());
-                viennacl::linalg::opencl::kernels::spai<ScalarType>::init(ctx);
-
-                MatrixType At(A.size1(), A.size2(), viennacl::context(ctx));
                 UBLASSparseMatrixType ubls_A(A.size1(), A.size2()), ubls_spai_m;
                 UBLASSparseMatrixType ubls_At;
                 viennacl::copy(A, ubls_A);
@@ -155,9 +153,24 @@ namespace viennacl
                 //pA = ubls_At;
                 //execute SPAI with ublas matrix types
                 viennacl::linalg::detail::spai::initPreconditioner(ubls_At, ubls_spai_m);
-                viennacl::copy(ubls_At, At);
-                viennacl::linalg::detail::spai::computeSPAI(At, ubls_At, ubls_spai_m, spai_m_, tag_);
-                //viennacl::copy(ubls_spai_m, spai_m_);
+#ifdef VIENNACL_WITH_OPENCL
+                if (viennacl::traits::context(A).memory_type() == viennacl::OPENCL_MEMORY)
+                {
+                  viennacl::ocl::context & ctx = const_cast<viennacl::ocl::context &>(viennacl::traits::opencl_handle(A).context());
+                  viennacl::linalg::opencl::kernels::spai<ScalarType>::init(ctx);
+
+                  MatrixType At(A.size1(), A.size2(), viennacl::context(ctx));
+                  viennacl::copy(ubls_At, At);
+                  viennacl::linalg::detail::spai::computeSPAI(At, ubls_At, ubls_spai_m, spai_m_, tag_);
+                }
+                else
+#endif
+                {
+                  //host-based setup, the columns are computed in parallel with OpenMP
+                  viennacl::linalg::detail::spai::computeSPAI(ubls_At, ubls_spai_m, tag_);
+                  spai_m_.resize(static_cast<unsigned int>(ubls_spai_m.size1()), static_cast<unsigned int>(ubls_spai_m.size2()));
+                  viennacl::copy(ubls_spai_m, spai_m_);
+                }
                 tmp_.resize(A.size1(), viennacl::traits::context(A), false);
             }
             /** @brief Application of current preconditioner, multiplication on the right-hand side vector
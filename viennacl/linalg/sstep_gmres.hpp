@@ -0,0 +1,413 @@
+#ifndef VIENNACL_LINALG_SSTEP_GMRES_HPP_
+#define VIENNACL_LINALG_SSTEP_GMRES_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/sstep_gmres.hpp
+    @brief Implementation of the s-step (communication-avoiding) generalized minimum residual method with a Newton basis.
+*/
+
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include "viennacl/forwards.h"
+#include "viennacl/vector.hpp"
+#include "viennacl/matrix.hpp"
+#include "viennacl/matrix_proxy.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/norm_2.hpp"
+#include "viennacl/traits/context.hpp"
+#include "viennacl/linalg/detail/small_dense.hpp"
+#include "viennacl/linalg/detail/multi_vector.hpp"
+
+namespace viennacl
+{
+  namespace linalg
+  {
+
+    /** @brief A tag for the s-step GMRES solver. Used for supplying solver parameters and for dispatching the solve() function
+    */
+    class sstep_gmres_tag
+    {
+      public:
+        /** @brief The constructor
+        *
+        * @param tol            Relative tolerance for the residual (solver quits if ||r|| < tol * ||r_initial||)
+        * @param max_iterations The maximum number of iterations (including restarts)
+        * @param krylov_dim     The maximum dimension of the Krylov space before restart
+        * @param step_size      Number of Krylov basis vectors generated and orthogonalized as one block (the 's' in s-step)
+        */
+        sstep_gmres_tag(double tol = 1e-10, unsigned int max_iterations = 300, unsigned int krylov_dim = 20, unsigned int step_size = 4)
+         : tol_(tol), iterations_(max_iterations), krylov_dim_(krylov_dim), step_size_(step_size > 0 ? step_size : 1), iters_taken_(0), last_error_(0) {}
+
+        /** @brief Returns the relative tolerance */
+        double tolerance() const { return tol_; }
+        /** @brief Returns the maximum number of iterations */
+        unsigned int max_iterations() const { return iterations_; }
+        /** @brief Returns the maximum dimension of the Krylov space before restart */
+        unsigned int krylov_dim() const { return krylov_dim_; }
+        /** @brief Returns the number of basis vectors generated per block */
+        unsigned int step_size() const { return step_size_; }
+        /** @brief Returns the maximum number of restarts */
+        unsigned int max_restarts() const
+        {
+          unsigned int ret = iterations_ / krylov_dim_;
+          if (ret > 0 && (ret * krylov_dim_ == iterations_) )
+            return ret - 1;
+          return ret;
+        }
+
+        /** @brief Return the number of solver iterations: */
+        unsigned int iters() const { return iters_taken_; }
+        /** @brief Set the number of solver iterations (should only be modified by the solver) */
+        void iters(unsigned int i) const { iters_taken_ = i; }
+
+        /** @brief Returns the estimated relative error at the end of the solver run */
+        double error() const { return last_error_; }
+        /** @brief Sets the estimated relative error at the end of the solver run */
+        void error(double e) const { last_error_ = e; }
+
+      private:
+        double tol_;
+        unsigned int iterations_;
+        unsigned int krylov_dim_;
+        unsigned int step_size_;
+
+        //return values from solver
+        mutable unsigned int iters_taken_;
+        mutable double last_error_;
+    };
+
+
+    namespace detail
+    {
+      /** @brief Computes w = M^{-1} A v, where M^{-1} is the preconditioner */
+      template <typename MatrixType, typename T, typename PreconditionerType>
+      void sstep_gmres_apply(MatrixType const & A, PreconditionerType const & precond,
+                             viennacl::vector_base<T> const & v, viennacl::vector<T> & tmp, viennacl::vector_base<T> & w)
+      {
+        tmp = viennacl::linalg::prod(A, v);
+        precond.apply(tmp);
+        w = tmp;
+      }
+
+      /** @brief Block classical Gram-Schmidt with reorthogonalization (BCGS2) of W against the orthonormal columns of Q. The coefficients are accumulated in C (host). */
+      template <typename T>
+      void sstep_gmres_project(viennacl::matrix_base<T> const & Q, viennacl::matrix_base<T> & W,
+                               viennacl::matrix<T, viennacl::column_major> & C_dev, std::vector< std::vector<T> > & C)
+      {
+        std::vector< std::vector<T> > C_pass;
+        small_dense_resize(C, Q.size2(), W.size2());
+        C_dev.resize(Q.size2(), W.size2(), false);
+        for (vcl_size_t pass = 0; pass < 2; ++pass)
+        {
+          gram_matrix(Q, W, C_dev, C_pass);
+          W -= viennacl::linalg::prod(Q, C_dev);
+          for (vcl_size_t i=0; i<C.size(); ++i)
+            for (vcl_size_t j=0; j<C[i].size(); ++j)
+              C[i][j] += C_pass[i][j];
+        }
+      }
+
+      /** @brief Applies the Givens rotations computed so far to column j of H and computes a new rotation eliminating H[j+1][j]. Returns the updated residual norm. */
+      template <typename T>
+      T sstep_gmres_givens(std::vector< std::vector<T> > & H, vcl_size_t j,
+                           std::vector<T> & cs, std::vector<T> & sn, std::vector<T> & g)
+      {
+        for (vcl_size_t i=0; i<j; ++i)
+        {
+          T tmp     =  cs[i] * H[i][j] + sn[i] * H[i+1][j];
+          H[i+1][j] = -sn[i] * H[i][j] + cs[i] * H[i+1][j];
+          H[i][j]   = tmp;
+        }
+
+        T a = H[j][j];
+        T b = H[j+1][j];
+        T r = std::sqrt(a * a + b * b);
+        cs[j] = (r > 0) ? a / r : T(1);
+        sn[j] = (r > 0) ? b / r : T(0);
+        H[j][j]   = r;
+        H[j+1][j] = 0;
+
+        g[j+1] = -sn[j] * g[j];
+        g[j]   =  cs[j] * g[j];
+        return std::fabs(g[j+1]);
+      }
+    }
+
+
+    /** @brief Implementation of the s-step GMRES solver with a Newton basis.
+    *
+    * Instead of orthogonalizing each new Krylov vector individually, blocks of 's' basis vectors are generated by a Newton polynomial recurrence
+    * (v_{i+1} = (M^{-1} A - theta_i) v_i) and orthogonalized at once by block classical Gram-Schmidt with reorthogonalization followed by Cholesky-QR2.
+    * Thus, the reductions of the standard Arnoldi process are replaced by a few tall-skinny matrix-matrix products per block.
+    * The shifts theta_i are the Leja-ordered Ritz values (eigenvalues of the Hessenberg matrix) obtained in the first restart cycle, which is run as standard Arnoldi.
+    * If a block turns out to be numerically rank deficient, it is recomputed with single steps.
+    *
+    * @param matrix     The system matrix
+    * @param rhs        The load vector
+    * @param tag        Solver configuration tag
+    * @param precond    A preconditioner. Precondition operation is done via member function apply()
+    * @return The result vector
+    */
+    template <typename MatrixType, typename T, typename PreconditionerType>
+    viennacl::vector<T> solve(MatrixType const & matrix, viennacl::vector<T> const & rhs, sstep_gmres_tag const & tag, PreconditionerType const & precond)
+    {
+      typedef viennacl::matrix<T, viennacl::column_major>     MultiVectorType;
+
+      vcl_size_t n = rhs.size();
+      viennacl::context ctx = viennacl::traits::context(rhs);
+      viennacl::vector<T> result = viennacl::zero_vector<T>(n, ctx);
+
+      tag.iters(0);
+      tag.error(0);
+
+      T norm_rhs = viennacl::linalg::norm_2(rhs);
+      if (norm_rhs == 0) //solution is zero if RHS norm is zero
+        return result;
+
+      vcl_size_t krylov_dim = std::min<vcl_size_t>(tag.krylov_dim(), n);  //a Krylov space larger than the matrix is pointless
+      vcl_size_t max_s = std::min<vcl_size_t>(tag.step_size(), krylov_dim);
+
+      MultiVectorType Q(n, krylov_dim + 1, ctx);
+      MultiVectorType W_tmp(n, max_s, ctx);
+      MultiVectorType C_dev(1, 1, ctx);
+      viennacl::vector<T> res(n, ctx);
+      viennacl::vector<T> tmp(n, ctx);
+      viennacl::vector<T> y_dev(krylov_dim, ctx);
+
+      std::vector< std::vector<T> > H;      // Hessenberg matrix of the Arnoldi relation M^{-1} A Q_k = Q_{k+1} H
+      std::vector< std::vector<T> > H_rot;  // H with Givens rotations applied (upper triangular)
+      std::vector< std::vector<T> > C;
+      std::vector< std::vector<T> > R;
+      std::vector<T> cs(krylov_dim), sn(krylov_dim), g(krylov_dim + 1);
+
+      // Newton shifts (real parts, imaginary parts), set up after the first restart cycle:
+      std::vector<T> shifts_re, shifts_im;
+      bool have_shifts = false;
+
+      for (unsigned int it = 0; it <= tag.max_restarts(); ++it)
+      {
+        res = rhs;
+        tmp = viennacl::linalg::prod(matrix, result);
+        res -= tmp;
+        precond.apply(res);
+
+        T rho_0 = viennacl::linalg::norm_2(res);
+        tag.error(rho_0 / norm_rhs);
+        if (rho_0 / norm_rhs < tag.tolerance())
+          return result;
+
+        viennacl::vector_base<T> q0 = detail::column_view(Q, 0);
+        q0 = res;
+        q0 /= rho_0;
+
+        detail::small_dense_resize(H, krylov_dim + 1, krylov_dim);
+        detail::small_dense_resize(H_rot, krylov_dim + 1, krylov_dim);
+        std::fill(g.begin(), g.end(), T(0));
+        g[0] = T(1);
+
+        vcl_size_t k = 0;          // number of columns of H computed so far
+        bool converged = false;
+        bool breakdown = false;
+        while (k < krylov_dim && !converged && !breakdown)
+        {
+          vcl_size_t s = have_shifts ? std::min(max_s, krylov_dim - k) : 1;
+
+          // generate s new basis vectors in columns k+1, ..., k+s of Q, record the change of basis in B:
+          std::vector< std::vector<T> > B;
+          bool block_ok = false;
+          while (!block_ok)
+          {
+            detail::small_dense_resize(B, s + 1, s);
+            for (vcl_size_t i=0; i<s; ++i)
+            {
+              viennacl::vector_base<T> v_i    = detail::column_view(Q, k + i);
+              viennacl::vector_base<T> v_next = detail::column_view(Q, k + i + 1);
+              detail::sstep_gmres_apply(matrix, precond, v_i, tmp, v_next);
+
+              T theta = (s > 1) ? shifts_re[i] : T(0);
+              if (theta != 0)
+                v_next -= theta * v_i;
+              B[i][i] = theta;
+              if (s > 1 && i > 0 && shifts_im[i-1] > 0 && shifts_re[i-1] == shifts_re[i])  // second vector of a complex conjugate pair
+              {
+                viennacl::vector_base<T> v_prev = detail::column_view(Q, k + i - 1);
+                T b2 = shifts_im[i-1] * shifts_im[i-1];
+                v_next += (b2 / B[i][i-1]) * v_prev;
+                B[i-1][i] = -b2 / B[i][i-1];
+              }
+
+              // scale to unit length in order to avoid over- or underflow of the basis:
+              T sigma = (s == 1) ? T(1) : viennacl::linalg::norm_2(v_next);
+              if (sigma > 0 && sigma != T(1))
+                v_next /= sigma;
+              B[i+1][i] = (sigma > 0) ? sigma : T(1);
+            }
+
+            // block orthogonalization against the current basis:
+            viennacl::range all_rows(0, n);
+            viennacl::matrix_range<MultiVectorType> Q_prev(Q, all_rows, viennacl::range(0, k + 1));
+            viennacl::matrix_range<MultiVectorType> W(Q, all_rows, viennacl::range(k + 1, k + 1 + s));
+            viennacl::matrix_range<MultiVectorType> W_work(W_tmp, all_rows, viennacl::range(0, s));
+            detail::sstep_gmres_project(Q_prev, W, C_dev, C);
+
+            if (s > 1)
+            {
+              block_ok = detail::cholesky_qr2(W, W_work, R);
+              if (!block_ok)  //basis numerically rank deficient, retry with single steps
+                s = 1;
+            }
+            else
+            {
+              viennacl::vector_base<T> w = detail::column_view(Q, k + 1);
+              detail::small_dense_resize(R, 1, 1);
+              R[0][0] = viennacl::linalg::norm_2(w);
+              T norm_w = R[0][0];
+              for (vcl_size_t i=0; i<=k; ++i)
+                norm_w = std::max(norm_w, std::fabs(C[i][0]));
+              if (R[0][0] <= std::numeric_limits<T>::epsilon() * norm_w)  // (lucky) breakdown: Krylov space is invariant
+              {
+                R[0][0] = 0;
+                breakdown = true;
+              }
+              else
+                w /= R[0][0];
+              block_ok = true;
+            }
+          }
+
+          //
+          // Update H: M^{-1} A [q_k, w_1, ..., w_{s-1}] = [q_k, w_1, ..., w_s] B and [q_k, w_1, ..., w_s] = Q Rhat
+          // yields H(:, k:k+s-1) = (Rhat B - H(:, 0:k-1) Rhat(0:k-1, 0:s-1)) T^{-1}, where T = Rhat(k:k+s-1, 0:s-1) is upper triangular.
+          //
+          vcl_size_t rows = k + s + 1;
+          std::vector< std::vector<T> > Rhat;
+          detail::small_dense_resize(Rhat, rows, s + 1);
+          Rhat[k][0] = T(1);
+          for (vcl_size_t c=1; c<=s; ++c)
+          {
+            for (vcl_size_t i=0; i<=k; ++i)
+              Rhat[i][c] = C[i][c-1];
+            for (vcl_size_t i=0; i<s; ++i)
+              Rhat[k+1+i][c] = R[i][c-1];
+          }
+
+          std::vector< std::vector<T> > X;
+          detail::small_dense_resize(X, rows, s);
+          for (vcl_size_t i=0; i<rows; ++i)
+            for (vcl_size_t c=0; c<s; ++c)
+            {
+              T val = 0;
+              for (vcl_size_t l=0; l<=s; ++l)
+                val += Rhat[i][l] * B[l][c];
+              for (vcl_size_t l=0; l<k; ++l)
+                val -= H[i][l] * Rhat[l][c];
+              X[i][c] = val;
+            }
+          for (vcl_size_t c=0; c<s; ++c)  // X = X T^{-1}
+          {
+            for (vcl_size_t l=0; l<c; ++l)
+              for (vcl_size_t i=0; i<rows; ++i)
+                X[i][c] -= X[i][l] * Rhat[k+l][c];
+            for (vcl_size_t i=0; i<rows; ++i)
+              X[i][c] /= Rhat[k+c][c];
+          }
+
+          for (vcl_size_t c=0; c<s; ++c)
+          {
+            for (vcl_size_t i=0; i<=k+c+1; ++i)  //entries below the subdiagonal vanish up to round-off
+              H[i][k+c] = H_rot[i][k+c] = X[i][c];
+
+            T rel_res = detail::sstep_gmres_givens(H_rot, k + c, cs, sn, g) * rho_0 / norm_rhs;
+            tag.iters(tag.iters() + 1);
+            tag.error(rel_res);
+            if (rel_res < tag.tolerance() || (breakdown && c + 1 == s))
+            {
+              k += c + 1;
+              converged = true;
+              break;
+            }
+          }
+          if (!converged)
+            k += s;
+
+          if (tag.iters() >= tag.max_iterations())
+            break;
+        }
+
+        //
+        // compute the shifts for the Newton basis from the Ritz values of the first cycle:
+        //
+        if (!have_shifts && max_s > 1 && k >= max_s)
+        {
+          std::vector< std::vector<T> > H_square;
+          detail::small_dense_resize(H_square, k, k);
+          for (vcl_size_t i=0; i<k; ++i)
+            for (vcl_size_t j=0; j<k; ++j)
+              H_square[i][j] = H[i][j];
+          if (detail::small_dense_hessenberg_eigenvalues(H_square, k, shifts_re, shifts_im))
+          {
+            detail::small_dense_leja_order(shifts_re, shifts_im);
+            shifts_re.resize(max_s);
+            shifts_im.resize(max_s);
+            if (shifts_im[max_s - 1] > 0)  //do not split a complex conjugate pair
+              shifts_im[max_s - 1] = 0;
+            have_shifts = true;
+          }
+        }
+
+        //
+        // solve the triangular system and update the result: x += rho_0 * Q(:, 0:k-1) y
+        //
+        std::vector<T> y(krylov_dim);
+        for (vcl_size_t i=k; i-- > 0; )
+        {
+          T val = g[i];
+          for (vcl_size_t j=i+1; j<k; ++j)
+            val -= H_rot[i][j] * y[j];
+          y[i] = (H_rot[i][i] != 0) ? val / H_rot[i][i] : T(0);
+        }
+        for (vcl_size_t i=0; i<k; ++i)
+          y[i] *= rho_0;
+        viennacl::copy(y, y_dev);
+
+        viennacl::matrix_range<MultiVectorType> Q_k(Q, viennacl::range(0, n), viennacl::range(0, krylov_dim));
+        tmp = viennacl::linalg::prod(Q_k, y_dev);
+        result += tmp;
+
+        if (tag.error() < tag.tolerance() || tag.iters() >= tag.max_iterations())
+          return result;
+      }
+
+      return result;
+    }
+
+    /** @brief Convenience overload of the solve() function using s-step GMRES. Per default, no preconditioner is used
+    */
+    template <typename MatrixType, typename T>
+    viennacl::vector<T> solve(MatrixType const & matrix, viennacl::vector<T> const & rhs, sstep_gmres_tag const & tag)
+    {
+      return solve(matrix, rhs, tag, viennacl::linalg::no_precond());
+    }
+
+  }
+}
+
+#endif
@@ -31,11 +31,19 @@
 
 
 #include <cmath>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <limits>
 
 #include "viennacl/matrix.hpp"
-#include "viennacl/linalg/opencl/kernels/svd.hpp"
+#include "viennacl/linalg/qr.hpp"
 #include "viennacl/linalg/qr-method-common.hpp"
 
+#ifdef VIENNACL_WITH_OPENCL
+#include "viennacl/linalg/opencl/kernels/svd.hpp"
+#endif
+
 namespace viennacl
 {
   namespace linalg
@@ -44,6 +52,7 @@ namespace viennacl
     namespace detail
     {
 
+#ifdef VIENNACL_WITH_OPENCL
       template<typename MatrixType, typename VectorType>
       void givens_prev(MatrixType & matrix,
                        VectorType & tmp1,
@@ -479,10 +488,522 @@ namespace viennacl
         }
       }
 
+#endif
+
+
+      //
+      // Host implementation. The m x n matrix (m >= n) is stored column-major with leading dimension m.
+      // First stage: Blocked reduction A = Q B P^T to upper bidiagonal form B, where the Householder vectors of Q are stored below the diagonal
+      //              and the ones of P to the right of the superdiagonal (cf. LAPACK's xGEBRD).
+      // Second stage: Implicit-shift QR iteration on B = U_B Sigma V_B^T (cf. Golub, Van Loan: Matrix Computations, Alg. 8.6.2).
+      // Finally, QL = Q diag(U_B, I) and QR = P V_B are formed by applying the Householder reflectors in compact WY form.
+      //
+
+      /** @brief Number of columns reduced per panel in the bidiagonalization */
+      inline vcl_size_t svd_block_size() { return 32; }
+
+      /** @brief Reduces the panel of nb columns and rows starting at j to bidiagonal form (cf. LAPACK's xLABRD).
+      *
+      * Returns the matrices X (m x nb) and Y (n x nb) such that the trailing matrix is updated by A -= V Y^T + X U^T,
+      * where V holds the left and U the right Householder vectors of the panel. The diagonal and superdiagonal entries of the panel are set to one.
+      */
+      template <typename ScalarType>
+      void svd_bidiag_panel(ScalarType * A, vcl_size_t m, vcl_size_t n, vcl_size_t j, vcl_size_t nb,
+                            ScalarType * d, ScalarType * e, ScalarType * tauq, ScalarType * taup,
+                            std::vector<ScalarType> & X, std::vector<ScalarType> & Y)
+      {
+        X.assign(m * nb, ScalarType(0));
+        Y.assign(n * nb, ScalarType(0));
+        std::vector<ScalarType> w(nb);
+
+        vcl_size_t row_block_size = qr_row_block_size();
+
+        for (vcl_size_t i=0; i<nb; ++i)
+        {
+          vcl_size_t p = j + i;
+          ScalarType * a_p = A + p*m;
+          ScalarType * X_i = &(X[i*m]);
+          ScalarType * Y_i = &(Y[i*n]);
+
+          //update column p with the previous reflectors of the panel: A(p:m, p) -= V Y(p, :)^T + X U(:, p)
+          for (vcl_size_t l=0; l<i; ++l)
+          {
+            ScalarType const * v_l = A + (j+l)*m;
+            ScalarType const * X_l = &(X[l*m]);
+            ScalarType Y_pl = Y[l*n + p];
+            ScalarType U_lp = A[p*m + j+l];
+            for (vcl_size_t r=p; r<m; ++r)
+              a_p[r] -= v_l[r] * Y_pl + X_l[r] * U_lp;
+          }
+
+          //left reflector:
+          tauq[p] = householder_reflector(a_p[p], a_p + p + 1, m - p - 1, 1);
+          d[p] = a_p[p];
+          a_p[p] = 1;
+
+          if (p + 1 >= n)
+          {
+            taup[p] = 0;
+            continue;
+          }
+
+          //Y(p+1:n, i) = tauq (A(p:m, p+1:n)^T v - Y V^T v - U^T X^T v), the first term being distributed over the columns:
+#ifdef VIENNACL_WITH_OPENMP
+          #pragma omp parallel for
+#endif
+          for (long c=static_cast<long>(p+1); c<static_cast<long>(n); ++c)
+          {
+            ScalarType const * a_c = A + static_cast<vcl_size_t>(c)*m;
+            ScalarType temp = 0;
+            for (vcl_size_t r=p; r<m; ++r)
+              temp += a_c[r] * a_p[r];
+            Y_i[c] = temp;
+          }
+
+          for (vcl_size_t l=0; l<i; ++l)
+          {
+            ScalarType const * v_l = A + (j+l)*m;
+            ScalarType const * X_l = &(X[l*m]);
+            ScalarType Vv = 0;
+            ScalarType Xv = 0;
+            for (vcl_size_t r=p; r<m; ++r)
+            {
+              Vv += v_l[r] * a_p[r];
+              Xv += X_l[r] * a_p[r];
+            }
+            ScalarType const * Y_l = &(Y[l*n]);
+            for (vcl_size_t c=p+1; c<n; ++c)
+              Y_i[c] -= Y_l[c] * Vv + A[c*m + j+l] * Xv;
+          }
+          for (vcl_size_t c=p+1; c<n; ++c)
+            Y_i[c] *= tauq[p];
+
+          //update row p: A(p, p+1:n) -= V(p, 0:i+1) Y^T + X(p, :) U
+          for (vcl_size_t l=0; l<=i; ++l)
+          {
+            ScalarType V_pl = (l == i) ? ScalarType(1) : A[(j+l)*m + p];
+            ScalarType X_pl = (l == i) ? ScalarType(0) : X[l*m + p];
+            ScalarType const * Y_l = &(Y[l*n]);
+            for (vcl_size_t c=p+1; c<n; ++c)
+              A[c*m + p] -= Y_l[c] * V_pl + A[c*m + j+l] * X_pl;
+          }
+
+          //right reflector:
+          ScalarType * u = A + (p+1)*m + p;  //entries with stride m
+          taup[p] = householder_reflector(u[0], u + m, n - p - 2, m);
+          e[p] = u[0];
+          u[0] = 1;
+
+          //X(p+1:m, i) = taup (A(p+1:m, p+1:n) u - V Y^T u - X U u), the first term being distributed over the rows:
+          long num_row_blocks = static_cast<long>((m - p - 1 + row_block_size - 1) / row_block_size);
+#ifdef VIENNACL_WITH_OPENMP
+          #pragma omp parallel for
+#endif
+          for (long rb=0; rb<num_row_blocks; ++rb)
+          {
+            vcl_size_t row_start = p + 1 + static_cast<vcl_size_t>(rb) * row_block_size;
+            vcl_size_t row_stop  = std::min(m, row_start + row_block_size);
+            for (vcl_size_t c=p+1; c<n; ++c)
+            {
+              ScalarType const * a_c = A + c*m;
+              ScalarType u_c = a_c[p];
+              for (vcl_size_t r=row_start; r<row_stop; ++r)
+                X_i[r] += a_c[r] * u_c;
+            }
+          }
+
+          for (vcl_size_t l=0; l<=i; ++l)
+          {
+            ScalarType const * Y_l = &(Y[l*n]);
+            ScalarType Yu = 0;
+            ScalarType Uu = 0;
+            for (vcl_size_t c=p+1; c<n; ++c)
+            {
+              Yu += Y_l[c] * A[c*m + p];
+              if (l < i)
+                Uu += A[c*m + j+l] * A[c*m + p];
+            }
+            ScalarType const * v_l = A + (j+l)*m;
+            ScalarType const * X_l = &(X[l*m]);
+            for (vcl_size_t r=p+1; r<m; ++r)
+              X_i[r] -= v_l[r] * Yu + X_l[r] * Uu;
+          }
+          for (vcl_size_t r=p+1; r<m; ++r)
+            X_i[r] *= taup[p];
+        }
+      }
+
+      /** @brief Blocked reduction of the column-major m x n buffer A (m >= n) to upper bidiagonal form */
+      template <typename ScalarType>
+      void svd_bidiag(ScalarType * A, vcl_size_t m, vcl_size_t n,
+                      std::vector<ScalarType> & d, std::vector<ScalarType> & e,
+                      std::vector<ScalarType> & tauq, std::vector<ScalarType> & taup)
+      {
+        d.resize(n);
+        e.assign(n, ScalarType(0));
+        tauq.resize(n);
+        taup.resize(n);
+
+        std::vector<ScalarType> X, Y;
+        vcl_size_t block_size = svd_block_size();
+        for (vcl_size_t j=0; j<n; j += block_size)
+        {
+          vcl_size_t nb = std::min(n, j + block_size) - j;
+          svd_bidiag_panel(A, m, n, j, nb, &(d[0]), &(e[0]), &(tauq[0]), &(taup[0]), X, Y);
+
+          //trailing update A(t:m, t:n) -= V Y^T + X U^T with t = j + nb, distributed over tiles:
+          vcl_size_t t = j + nb;
+          if (t < n)
+          {
+            vcl_size_t row_block_size = qr_row_block_size();
+            vcl_size_t col_block_size = block_size;
+            vcl_size_t num_row_blocks = (m - t + row_block_size - 1) / row_block_size;
+            vcl_size_t num_col_blocks = (n - t + col_block_size - 1) / col_block_size;
+#ifdef VIENNACL_WITH_OPENMP
+            #pragma omp parallel for
+#endif
+            for (long tile=0; tile<static_cast<long>(num_row_blocks * num_col_blocks); ++tile)
+            {
+              vcl_size_t row_start = t + (static_cast<vcl_size_t>(tile) % num_row_blocks) * row_block_size;
+              vcl_size_t row_stop  = std::min(m, row_start + row_block_size);
+              vcl_size_t col_start = t + (static_cast<vcl_size_t>(tile) / num_row_blocks) * col_block_size;
+              vcl_size_t col_stop  = std::min(n, col_start + col_block_size);
+              for (vcl_size_t c=col_start; c<col_stop; ++c)
+              {
+                ScalarType * a_c = A + c*m;
+                for (vcl_size_t l=0; l<nb; ++l)
+                {
+                  ScalarType const * v_l = A + (j+l)*m;
+                  ScalarType const * X_l = &(X[l*m]);
+                  ScalarType Y_cl = Y[l*n + c];
+                  ScalarType U_lc = a_c[j+l];
+                  for (vcl_size_t r=row_start; r<row_stop; ++r)
+                    a_c[r] -= v_l[r] * Y_cl + X_l[r] * U_lc;
+                }
+              }
+            }
+          }
+
+          //restore bidiagonal entries:
+          for (vcl_size_t p=j; p<t; ++p)
+          {
+            A[p*m + p] = d[p];
+            if (p + 1 < n)
+              A[(p+1)*m + p] = e[p];
+          }
+        }
+      }
+
+      /** @brief Applies a sequence of plane rotations to the columns of the column-major matrix M with num_rows rows.
+      *
+      * Rotation k acts on the columns (col_a[k], col_b[k]). The rows are processed in blocks, to which all rotations are applied
+      * while they are in cache. The row blocks are distributed over the threads.
+      */
+      template <typename ScalarType>
+      void svd_apply_rotations(std::vector<ScalarType> & M, vcl_size_t num_rows,
+                               std::vector<vcl_size_t> const & col_a, std::vector<vcl_size_t> const & col_b,
+                               std::vector<ScalarType> const & cs, std::vector<ScalarType> const & sn)
+      {
+        if (cs.empty())
+          return;
+
+        vcl_size_t row_block_size = 64;
+        long num_row_blocks = static_cast<long>((num_rows + row_block_size - 1) / row_block_size);
+#ifdef VIENNACL_WITH_OPENMP
+        #pragma omp parallel for if (num_rows * cs.size() > 4096)
+#endif
+        for (long rb=0; rb<num_row_blocks; ++rb)
+        {
+          vcl_size_t row_start = static_cast<vcl_size_t>(rb) * row_block_size;
+          vcl_size_t row_stop  = std::min(num_rows, row_start + row_block_size);
+          for (vcl_size_t k=0; k<cs.size(); ++k)
+          {
+            ScalarType * a = &(M[col_a[k] * num_rows]);
+            ScalarType * b = &(M[col_b[k] * num_rows]);
+            ScalarType c = cs[k];
+            ScalarType s = sn[k];
+            for (vcl_size_t r=row_start; r<row_stop; ++r)
+            {
+              ScalarType y = a[r];
+              ScalarType z = b[r];
+              a[r] = y * c + z * s;
+              b[r] = z * c - y * s;
+            }
+          }
+        }
+      }
+
+      /** @brief Implicit-shift QR iteration for the upper bidiagonal matrix with diagonal q and superdiagonal e[1], ..., e[n-1] (e[0] = 0).
+      *
+      * The rotations are accumulated into the column-major n x n matrices U and V, which are expected to be initialized (e.g. with the identity).
+      * On exit, q holds the nonnegative singular values.
+      */
+      template <typename ScalarType>
+      void svd_bidiag_qr(std::vector<ScalarType> & q, std::vector<ScalarType> & e,
+                         std::vector<ScalarType> & U, std::vector<ScalarType> & V)
+      {
+        long n = static_cast<long>(q.size());
+        vcl_size_t un = q.size();
+
+        ScalarType anorm = 0;
+        for (long i=0; i<n; ++i)
+          anorm = std::max(anorm, std::fabs(q[static_cast<vcl_size_t>(i)]) + std::fabs(e[static_cast<vcl_size_t>(i)]));
+        ScalarType tol = std::numeric_limits<ScalarType>::epsilon() * anorm;
+
+        std::vector<vcl_size_t> col_a, col_b, U_col_a, U_col_b;
+        std::vector<ScalarType> cs, sn, U_cs, U_sn;
+
+        for (long k = n - 1; k >= 0; --k)
+        {
+          vcl_size_t uk = static_cast<vcl_size_t>(k);
+          for (vcl_size_t iter = 0; iter < ITER_MAX; ++iter)
+          {
+            //test for splitting:
+            long l;
+            bool cancel = true;
+            for (l = k; l >= 0; --l)
+            {
+              if (l == 0 || std::fabs(e[static_cast<vcl_size_t>(l)]) <= tol)
+              {
+                cancel = false;
+                break;
+              }
+              if (std::fabs(q[static_cast<vcl_size_t>(l - 1)]) <= tol)
+                break;
+            }
+
+            vcl_size_t ul = static_cast<vcl_size_t>(l);
+
+            //q[l-1] is negligible: cancel e[l] by rotations from the left
+            if (cancel)
+            {
+              U_col_a.clear(); U_col_b.clear(); U_cs.clear(); U_sn.clear();
+              ScalarType c = 0;
+              ScalarType s = 1;
+              for (vcl_size_t i = ul; i <= uk; ++i)
+              {
+                ScalarType f = s * e[i];
+                e[i] = c * e[i];
+                if (std::fabs(f) <= tol)
+                  break;
+                ScalarType g = q[i];
+                ScalarType h = pythag(f, g);
+                q[i] = h;
+                c = g / h;
+                s = -f / h;
+                U_col_a.push_back(ul - 1); U_col_b.push_back(i); U_cs.push_back(c); U_sn.push_back(s);
+              }
+              svd_apply_rotations(U, un, U_col_a, U_col_b, U_cs, U_sn);
+            }
+
+            //convergence:
+            ScalarType z = q[uk];
+            if (l == k)
+            {
+              if (z < 0)
+              {
+                q[uk] = -z;
+                for (vcl_size_t row=0; row<un; ++row)
+                  V[uk*un + row] = -V[uk*un + row];
+              }
+              break;
+            }
+
+            //shift from the bottom 2x2 minor:
+            ScalarType x = q[ul];
+            ScalarType y = q[uk - 1];
+            ScalarType g = e[uk - 1];
+            ScalarType h = e[uk];
+            ScalarType f = ((y - z) * (y + z) + (g - h) * (g + h)) / (2 * h * y);
+            g = pythag(f, ScalarType(1));
+            f = ((x - z) * (x + z) + h * ((y / (f + ((f >= 0) ? g : -g))) - h)) / x;
+
+            //chase the bulge:
+            col_a.clear(); col_b.clear(); cs.clear(); sn.clear();
+            U_col_a.clear(); U_col_b.clear(); U_cs.clear(); U_sn.clear();
+            ScalarType c = 1;
+            ScalarType s = 1;
+            for (vcl_size_t j = ul; j < uk; ++j)
+            {
+              vcl_size_t i = j + 1;
+              g = e[i];
+              y = q[i];
+              h = s * g;
+              g = c * g;
+              z = pythag(f, h);
+              e[j] = z;
+              c = f / z;
+              s = h / z;
+              f = x * c + g * s;
+              g = g * c - x * s;
+              h = y * s;
+              y *= c;
+              col_a.push_back(j); col_b.push_back(i); cs.push_back(c); sn.push_back(s);
+
+              z = pythag(f, h);
+              q[j] = z;
+              if (z > 0)
+              {
+                c = f / z;
+                s = h / z;
+              }
+              f = c * g + s * y;
+              x = c * y - s * g;
+              U_col_a.push_back(j); U_col_b.push_back(i); U_cs.push_back(c); U_sn.push_back(s);
+            }
+            e[ul] = 0;
+            e[uk] = f;
+            q[uk] = x;
+
+            svd_apply_rotations(V, un, col_a, col_b, cs, sn);
+            svd_apply_rotations(U, un, U_col_a, U_col_b, U_cs, U_sn);
+          }
+        }
+      }
+
+      /** @brief Computes the singular value decomposition A = U diag(sigma) V^T of the column-major m x n buffer A with m >= n.
+      *
+      * @param A       The matrix, overwritten by the Householder vectors of the bidiagonalization
+      * @param m       Number of rows
+      * @param n       Number of columns
+      * @param sigma   The n singular values in descending order
+      * @param U       The column-major m x m matrix of left singular vectors
+      * @param V       The column-major n x n matrix of right singular vectors
+      */
+      template <typename ScalarType>
+      void svd_host(std::vector<ScalarType> & A, vcl_size_t m, vcl_size_t n,
+                    std::vector<ScalarType> & sigma, std::vector<ScalarType> & U, std::vector<ScalarType> & V)
+      {
+        sigma.resize(n);
+        U.assign(m * m, ScalarType(0));
+        V.assign(n * n, ScalarType(0));
+        for (vcl_size_t i=0; i<m; ++i)
+          U[i*m + i] = 1;
+        for (vcl_size_t i=0; i<n; ++i)
+          V[i*n + i] = 1;
+        if (n == 0)
+          return;
+
+        // first stage:
+        std::vector<ScalarType> d, e, tauq, taup;
+        svd_bidiag(&(A[0]), m, n, d, e, tauq, taup);
+
+        // second stage, superdiagonal shifted by one:
+        std::vector<ScalarType> e_shifted(n);
+        for (vcl_size_t i=1; i<n; ++i)
+          e_shifted[i] = e[i-1];
+
+        std::vector<ScalarType> U_B(n * n), V_B(n * n);
+        for (vcl_size_t i=0; i<n; ++i)
+        {
+          U_B[i*n + i] = 1;
+          V_B[i*n + i] = 1;
+        }
+        svd_bidiag_qr(d, e_shifted, U_B, V_B);
+
+        //sort singular values in descending order:
+        std::vector< std::pair<ScalarType, vcl_size_t> > order(n);
+        for (vcl_size_t i=0; i<n; ++i)
+          order[i] = std::make_pair(-d[i], i);
+        std::sort(order.begin(), order.end());
+
+        //U(0:n, 0:n) = U_B, V = V_B (both permuted), stored column-major:
+        for (vcl_size_t k=0; k<n; ++k)
+        {
+          vcl_size_t src = order[k].second;
+          sigma[k] = d[src];
+          for (vcl_size_t i=0; i<n; ++i)
+          {
+            U[k*m + i] = U_B[src*n + i];
+            V[k*n + i] = V_B[src*n + i];
+          }
+        }
+
+        // U = Q U, where the left reflectors are stored in the columns of A:
+        vcl_size_t block_size = 16;
+        qr_apply_Q_buffer(&(A[0]), m, n, &(tauq[0]), false, &(U[0]), m, block_size);
+
+        // V = P V, where the right reflectors act on the rows 1, ..., n-1 only:
+        if (n > 2)
+        {
+          vcl_size_t n1 = n - 1;
+          std::vector<ScalarType> P(n1 * n1, ScalarType(0));
+          for (vcl_size_t p=0; p+1<n; ++p)
+            for (vcl_size_t c=p+2; c<n; ++c)
+              P[p*n1 + c - 1] = A[c*m + p];
+
+          std::vector<ScalarType> V1(n1 * n);
+          for (vcl_size_t k=0; k<n; ++k)
+            for (vcl_size_t i=0; i<n1; ++i)
+              V1[k*n1 + i] = V[k*n + i + 1];
+
+          qr_apply_Q_buffer(&(P[0]), n1, n1, &(taup[0]), false, &(V1[0]), n, block_size);
+
+          for (vcl_size_t k=0; k<n; ++k)
+            for (vcl_size_t i=0; i<n1; ++i)
+              V[k*n + i + 1] = V1[k*n1 + i];
+        }
+      }
+
+      /** @brief Host implementation of svd() for matrices in main memory or if OpenCL is not available */
+      template <typename SCALARTYPE, unsigned int ALIGNMENT>
+      void svd_host(viennacl::matrix<SCALARTYPE, row_major, ALIGNMENT> & A,
+                    viennacl::matrix<SCALARTYPE, row_major, ALIGNMENT> & QL,
+                    viennacl::matrix<SCALARTYPE, row_major, ALIGNMENT> & QR)
+      {
+        vcl_size_t row_num = A.size1();
+        vcl_size_t col_num = A.size2();
+        bool transposed = row_num < col_num;
+        vcl_size_t m = std::max(row_num, col_num);
+        vcl_size_t n = std::min(row_num, col_num);
+
+        std::vector<SCALARTYPE> A_buffer(A.internal_size());
+        viennacl::backend::memory_read(A.handle(), 0, sizeof(SCALARTYPE) * A.internal_size(), &(A_buffer[0]));
+
+        //column-major copy of A, or of A^T if A has more columns than rows:
+        std::vector<SCALARTYPE> B(m * n);
+        for (vcl_size_t i=0; i<row_num; ++i)
+          for (vcl_size_t j=0; j<col_num; ++j)
+          {
+            SCALARTYPE val = A_buffer[row_major::mem_index(i, j, A.internal_size1(), A.internal_size2())];
+            if (transposed)
+              B[i*m + j] = val;
+            else
+              B[j*m + i] = val;
+          }
+
+        std::vector<SCALARTYPE> sigma, U, V;
+        svd_host(B, m, n, sigma, U, V);
+
+        //A = QL Sigma QR^T, hence QL and QR swap roles for the transposed matrix:
+        std::vector<SCALARTYPE> const & left  = transposed ? V : U;
+        std::vector<SCALARTYPE> const & right = transposed ? U : V;
+
+        std::fill(A_buffer.begin(), A_buffer.end(), SCALARTYPE(0));
+        for (vcl_size_t i=0; i<n; ++i)
+          A_buffer[row_major::mem_index(i, i, A.internal_size1(), A.internal_size2())] = sigma[i];
+        viennacl::backend::memory_write(A.handle(), 0, sizeof(SCALARTYPE) * A.internal_size(), &(A_buffer[0]));
+
+        std::vector<SCALARTYPE> QL_buffer(QL.internal_size());
+        for (vcl_size_t i=0; i<row_num; ++i)
+          for (vcl_size_t j=0; j<row_num; ++j)
+            QL_buffer[row_major::mem_index(i, j, QL.internal_size1(), QL.internal_size2())] = left[j*row_num + i];
+        viennacl::backend::memory_write(QL.handle(), 0, sizeof(SCALARTYPE) * QL.internal_size(), &(QL_buffer[0]));
+
+        std::vector<SCALARTYPE> QR_buffer(QR.internal_size());
+        for (vcl_size_t i=0; i<col_num; ++i)
+          for (vcl_size_t j=0; j<col_num; ++j)
+            QR_buffer[row_major::mem_index(i, j, QR.internal_size1(), QR.internal_size2())] = right[j*col_num + i];
+        viennacl::backend::memory_write(QR.handle(), 0, sizeof(SCALARTYPE) * QR.internal_size(), &(QR_buffer[0]));
+      }
+
     } // namespace detail
 
 
     /** @brief Computes the singular value decomposition of a matrix A. Experimental in 1.3.x
+     *
+     * On return, A = QL * Sigma * QR^T holds for the input matrix A. Matrices in OpenCL memory are processed on the OpenCL device,
+     * otherwise the decomposition is computed on the host, where the singular values are sorted in descending order.
      *
      * @param A     The input matrix. Will be overwritten with a diagonal matrix containing the singular values on return
      * @param QL    The left orthogonal matrix
@@ -493,6 +1014,13 @@ namespace viennacl
               viennacl::matrix<SCALARTYPE, row_major, ALIGNMENT> & QL,
               viennacl::matrix<SCALARTYPE, row_major, ALIGNMENT> & QR)
     {
+#ifdef VIENNACL_WITH_OPENCL
+      if (viennacl::traits::active_handle_id(A) != viennacl::OPENCL_MEMORY)
+      {
+        detail::svd_host(A, QL, QR);
+        return;
+      }
+
       viennacl::ocl::context & ctx = const_cast<viennacl::ocl::context &>(viennacl::traits::opencl_handle(A).context());
       viennacl::linalg::opencl::kernels::svd<SCALARTYPE>::init(ctx);
 
@@ -526,6 +1054,9 @@ namespace viennacl
         h_Sigma(i, i) = dh[i];
 
       copy(h_Sigma, A);
+#else
+      detail::svd_host(A, QL, QR);
+#endif
     }
   }
 }
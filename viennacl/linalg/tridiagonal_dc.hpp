@@ -0,0 +1,622 @@
+#ifndef VIENNACL_LINALG_TRIDIAGONAL_DC_HPP_
+#define VIENNACL_LINALG_TRIDIAGONAL_DC_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/tridiagonal_dc.hpp
+    @brief Divide-and-conquer eigensolver for symmetric tridiagonal matrices (Cuppen's method). Experimental.
+*/
+
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#include "viennacl/matrix.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/qr-method-common.hpp"
+#include "viennacl/backend/memory.hpp"
+
+#include <boost/numeric/ublas/vector.hpp>
+
+namespace viennacl
+{
+  namespace linalg
+  {
+    namespace detail
+    {
+      /** @brief Maximum size of the subproblems at the leaves of the divide-and-conquer tree, which are solved by the implicit QL method */
+      inline vcl_size_t dc_leaf_size() { return 32; }
+
+      /** @brief Sorts the eigenvalues of a leaf in ascending order and permutes the columns of Z accordingly (selection sort, n is small)
+      *
+      * @param d     Eigenvalues
+      * @param n     Number of eigenvalues
+      * @param Z     Eigenvectors (column-major, n rows, leading dimension ldz)
+      * @param ldz   Leading dimension of Z
+      */
+      template <typename ScalarType>
+      void dc_sort_leaf(ScalarType * d, vcl_size_t n, ScalarType * Z, vcl_size_t ldz)
+      {
+        for (vcl_size_t i = 0; i + 1 < n; i++)
+        {
+          vcl_size_t k = i;
+          for (vcl_size_t j = i + 1; j < n; j++)
+            if (d[j] < d[k])
+              k = j;
+
+          if (k != i)
+          {
+            std::swap(d[i], d[k]);
+            std::swap_ranges(Z + i * ldz, Z + i * ldz + n, Z + k * ldz);
+          }
+        }
+      }
+
+      /** @brief Finds the i-th root of the secular equation 1/rho + sum_j w_j^2 / (dl_j - lambda) = 0 with rho > 0 and strictly increasing dl.
+      *
+      * The root is represented relative to the closest pole dl[origin] for accuracy: lambda = dl[origin] + tau.
+      * On exit, delta[j] holds dl_j - lambda for all j.
+      * The iteration fits two poles to the secular function in each step (cf. LAPACK's xLAED4) and falls back to bisection if the update leaves the bracket.
+      *
+      * @return The eigenvalue lambda
+      */
+      template <typename ScalarType>
+      ScalarType dc_secular_root(ScalarType const * dl, ScalarType const * w, vcl_size_t k, vcl_size_t i, ScalarType rho, ScalarType * delta)
+      {
+        ScalarType eps = std::numeric_limits<ScalarType>::epsilon();
+        ScalarType inv_rho = ScalarType(1) / rho;
+
+        vcl_size_t origin = i;
+        ScalarType lo = 0;
+        ScalarType hi = 0;
+
+        if (i + 1 < k)
+        {
+          ScalarType mid = (dl[i + 1] - dl[i]) / 2;
+          ScalarType f_mid = inv_rho;
+          for (vcl_size_t j = 0; j < k; ++j)
+            f_mid += w[j] * w[j] / ((dl[j] - dl[i]) - mid);
+
+          if (f_mid >= 0)   // root in (dl_i, dl_i + mid]
+            hi = mid;
+          else              // root in (dl_{i+1} - mid, dl_{i+1})
+          {
+            origin = i + 1;
+            lo = -mid;
+          }
+        }
+        else
+        {
+          ScalarType w_norm2 = 0;
+          for (vcl_size_t j = 0; j < k; ++j)
+            w_norm2 += w[j] * w[j];
+          hi = rho * w_norm2;
+        }
+
+        std::vector<ScalarType> pole_dist(k);
+        for (vcl_size_t j = 0; j < k; ++j)
+          pole_dist[j] = dl[j] - dl[origin];
+
+        ScalarType tau = (lo + hi) / 2;
+        for (vcl_size_t iter = 0; iter < 100; ++iter)
+        {
+          ScalarType psi = 0, dpsi = 0, phi = 0, dphi = 0;
+          for (vcl_size_t j = 0; j <= i; ++j)
+          {
+            ScalarType temp = w[j] / (pole_dist[j] - tau);
+            psi  += w[j] * temp;
+            dpsi += temp * temp;
+          }
+          for (vcl_size_t j = i + 1; j < k; ++j)
+          {
+            ScalarType temp = w[j] / (pole_dist[j] - tau);
+            phi  += w[j] * temp;
+            dphi += temp * temp;
+          }
+
+          ScalarType f = inv_rho + psi + phi;
+          if (std::fabs(f) <= ScalarType(8) * eps * static_cast<ScalarType>(k) * (inv_rho + std::fabs(psi) + phi))
+            break;
+
+          if (f > 0)
+            hi = tau;
+          else
+            lo = tau;
+
+          // fit f(tau + eta) ~ c + s / (a - eta) + S / (b - eta) and solve for the increment eta:
+          ScalarType a = pole_dist[i] - tau;
+          ScalarType eta = 0;
+          bool have_eta = false;
+          if (i + 1 < k)
+          {
+            ScalarType b = pole_dist[i + 1] - tau;
+            ScalarType c = f - a * dpsi - b * dphi;
+            ScalarType s = a * a * dpsi;
+            ScalarType S = b * b * dphi;
+
+            ScalarType qa = c;
+            ScalarType qb = c * (a + b) + s + S;
+            ScalarType qc = c * a * b + s * b + S * a;
+            ScalarType disc = qb * qb - 4 * qa * qc;
+            if (disc >= 0)
+            {
+              ScalarType q = (qb + sign(qb) * std::sqrt(disc)) / 2;
+              ScalarType candidates[2] = { (qa != 0) ? q / qa : hi - lo, (q != 0) ? qc / q : hi - lo };
+              for (int r = 0; r < 2 && !have_eta; ++r)
+              {
+                if (tau + candidates[r] > lo && tau + candidates[r] < hi)
+                {
+                  eta = candidates[r];
+                  have_eta = true;
+                }
+              }
+            }
+          }
+          else
+          {
+            ScalarType c = f - a * dpsi;
+            if (c != 0)
+            {
+              eta = a + a * a * dpsi / c;
+              have_eta = (tau + eta > lo && tau + eta < hi);
+            }
+          }
+
+          ScalarType tau_new = have_eta ? tau + eta : (lo + hi) / 2;
+          bool converged = std::fabs(tau_new - tau) <= eps * std::max(std::fabs(tau_new), std::fabs(pole_dist[i] - tau_new));
+          tau = tau_new;
+          if (converged || hi - lo <= 2 * eps * std::max(std::fabs(lo), std::fabs(hi)))
+            break;
+        }
+
+        for (vcl_size_t j = 0; j < k; ++j)
+          delta[j] = pole_dist[j] - tau;
+
+        return dl[origin] + tau;
+      }
+
+      /** @brief Computes C = A * B for column-major A (m x k), B (k x n) and C (m x n) with leading dimensions lda, ldb and ldc. Parallelized over tiles of C. */
+      template <typename ScalarType>
+      void dc_gemm(ScalarType const * A, vcl_size_t lda, ScalarType const * B, vcl_size_t ldb, ScalarType * C, vcl_size_t ldc,
+                   vcl_size_t m, vcl_size_t k, vcl_size_t n)
+      {
+        vcl_size_t block_size = 64;
+        vcl_size_t inner_block_size = 256;
+        vcl_size_t row_blocks = (m + block_size - 1) / block_size;
+        vcl_size_t col_blocks = (n + block_size - 1) / block_size;
+
+#ifdef VIENNACL_WITH_OPENMP
+        #pragma omp parallel for
+#endif
+        for (long tile = 0; tile < static_cast<long>(row_blocks * col_blocks); ++tile)
+        {
+          vcl_size_t row_start = (static_cast<vcl_size_t>(tile) % row_blocks) * block_size;
+          vcl_size_t row_end   = std::min(row_start + block_size, m);
+          vcl_size_t col_start = (static_cast<vcl_size_t>(tile) / row_blocks) * block_size;
+          vcl_size_t col_end   = std::min(col_start + block_size, n);
+
+          for (vcl_size_t j = col_start; j < col_end; ++j)
+            std::fill(C + j * ldc + row_start, C + j * ldc + row_end, ScalarType(0));
+
+          for (vcl_size_t p_start = 0; p_start < k; p_start += inner_block_size)
+          {
+            vcl_size_t p_end = std::min(p_start + inner_block_size, k);
+            vcl_size_t j = col_start;
+            for (; j + 4 <= col_end; j += 4)   // four columns of C at a time, so that each entry of A is loaded once for four updates
+            {
+              ScalarType * c_0 = C + j * ldc;
+              ScalarType * c_1 = c_0 + ldc;
+              ScalarType * c_2 = c_1 + ldc;
+              ScalarType * c_3 = c_2 + ldc;
+              for (vcl_size_t p = p_start; p < p_end; ++p)
+              {
+                ScalarType b_0 = B[j * ldb + p];
+                ScalarType b_1 = B[(j + 1) * ldb + p];
+                ScalarType b_2 = B[(j + 2) * ldb + p];
+                ScalarType b_3 = B[(j + 3) * ldb + p];
+                ScalarType const * a_p = A + p * lda;
+                for (vcl_size_t i = row_start; i < row_end; ++i)
+                {
+                  ScalarType a_ip = a_p[i];
+                  c_0[i] += a_ip * b_0;
+                  c_1[i] += a_ip * b_1;
+                  c_2[i] += a_ip * b_2;
+                  c_3[i] += a_ip * b_3;
+                }
+              }
+            }
+            for (; j < col_end; ++j)
+            {
+              ScalarType * c_j = C + j * ldc;
+              for (vcl_size_t p = p_start; p < p_end; ++p)
+              {
+                ScalarType b_pj = B[j * ldb + p];
+                ScalarType const * a_p = A + p * lda;
+                for (vcl_size_t i = row_start; i < row_end; ++i)
+                  c_j[i] += a_p[i] * b_pj;
+              }
+            }
+          }
+        }
+      }
+
+      /** @brief Merges two adjacent subproblems of the divide-and-conquer tree.
+      *
+      * On entry, d[0:n1] and d[n1:n1+n2] hold the (ascending) eigenvalues of the two subproblems, and the diagonal blocks of Z their eigenvectors.
+      * The subproblems are coupled by the off-diagonal entry beta, which has been removed from the diagonal before (d[n1-1] and d[n1] were reduced by |beta|).
+      * On exit, d holds the eigenvalues of the merged problem in ascending order and Z the eigenvectors.
+      *
+      * @param d      Eigenvalues
+      * @param Z      Eigenvectors (column-major, leading dimension ldz)
+      * @param ldz    Leading dimension of Z
+      * @param n1     Size of the first subproblem
+      * @param n2     Size of the second subproblem
+      * @param beta   The coupling entry of the tridiagonal matrix
+      */
+      template <typename ScalarType>
+      void dc_merge(ScalarType * d, ScalarType * Z, vcl_size_t ldz, vcl_size_t n1, vcl_size_t n2, ScalarType beta)
+      {
+        vcl_size_t n = n1 + n2;
+        ScalarType eps = std::numeric_limits<ScalarType>::epsilon();
+
+        // T = diag(Z1, Z2) (diag(d) + rho z z^T) diag(Z1, Z2)^T with z = [last row of Z1, sign(beta) * first row of Z2]:
+        std::vector<ScalarType> z(n);
+        for (vcl_size_t j = 0; j < n1; ++j)
+          z[j] = Z[j * ldz + n1 - 1];
+        for (vcl_size_t j = n1; j < n; ++j)
+          z[j] = sign(beta) * Z[j * ldz + n1];
+
+        ScalarType z_norm = 0;
+        for (vcl_size_t j = 0; j < n; ++j)
+          z_norm += z[j] * z[j];
+        z_norm = std::sqrt(z_norm);
+        for (vcl_size_t j = 0; j < n; ++j)
+          z[j] /= z_norm;
+        ScalarType rho = std::fabs(beta) * z_norm * z_norm;
+
+        // merge the two sorted lists of eigenvalues and permute the eigenvectors accordingly:
+        std::vector<vcl_size_t> perm(n);
+        {
+          vcl_size_t i1 = 0, i2 = n1;
+          for (vcl_size_t i = 0; i < n; ++i)
+            perm[i] = (i2 == n || (i1 < n1 && d[i1] <= d[i2])) ? i1++ : i2++;
+        }
+
+        // column_type: 1 if the column has nonzeros in the first n1 rows only, 2 if in the last n2 rows only, 3 otherwise
+        std::vector<ScalarType> ds(n), zs(n), Qm(n * n);
+        std::vector<int> column_type(n);
+        for (vcl_size_t i = 0; i < n; ++i)
+        {
+          column_type[i] = (perm[i] < n1) ? 1 : 2;
+          ds[i] = d[perm[i]];
+          zs[i] = z[perm[i]];
+          std::copy(Z + perm[i] * ldz, Z + perm[i] * ldz + n, Qm.begin() + static_cast<long>(i * n));
+        }
+
+        // deflation (cf. LAPACK's xLAED2): small components of z and close eigenvalues
+        ScalarType d_max = 0;
+        for (vcl_size_t i = 0; i < n; ++i)
+          d_max = std::max(d_max, std::fabs(ds[i]));
+        ScalarType tol = 8 * eps * std::max(d_max, rho);
+
+        std::vector<vcl_size_t> nondeflated;
+        std::vector<bool>       deflated(n, false);
+        vcl_size_t prev = n;
+        for (vcl_size_t j = 0; j < n; ++j)
+        {
+          if (rho * std::fabs(zs[j]) <= tol)
+          {
+            deflated[j] = true;
+            continue;
+          }
+
+          if (prev == n)
+          {
+            prev = j;
+            continue;
+          }
+
+          ScalarType s = zs[prev];
+          ScalarType c = zs[j];
+          ScalarType tau = pythag(c, s);
+          ScalarType t = ds[j] - ds[prev];
+          c /= tau;
+          s = -s / tau;
+          if (std::fabs(t * c * s) <= tol)
+          {
+            // rotate z[prev] into z[j] and deflate prev:
+            zs[j] = tau;
+            zs[prev] = 0;
+
+            ScalarType * q_p = &(Qm[prev * n]);
+            ScalarType * q_j = &(Qm[j * n]);
+            for (vcl_size_t r = 0; r < n; ++r)
+            {
+              ScalarType x = q_p[r];
+              ScalarType y = q_j[r];
+              q_p[r] = c * x + s * y;
+              q_j[r] = c * y - s * x;
+            }
+
+            if (column_type[prev] != column_type[j])
+              column_type[j] = 3;
+
+            t = ds[prev] * c * c + ds[j] * s * s;
+            ds[j] = ds[prev] * s * s + ds[j] * c * c;
+            ds[prev] = t;
+            deflated[prev] = true;
+          }
+          else
+            nondeflated.push_back(prev);
+          prev = j;
+        }
+        if (prev != n)
+          nondeflated.push_back(prev);
+
+        // solve the secular equation for the remaining k eigenvalues:
+        vcl_size_t k = nondeflated.size();
+        std::vector<ScalarType> lambda(n);
+        std::vector<ScalarType> Qk;
+        if (k > 0)
+        {
+          std::vector<ScalarType> dl(k), w(k);
+          for (vcl_size_t i = 0; i < k; ++i)
+          {
+            dl[i] = ds[nondeflated[i]];
+            w[i]  = zs[nondeflated[i]];
+          }
+
+          // delta(j, i) = dl_j - lambda_i, stored column-wise:
+          std::vector<ScalarType> delta(k * k);
+          std::vector<ScalarType> lambda_k(k);
+#ifdef VIENNACL_WITH_OPENMP
+          #pragma omp parallel for
+#endif
+          for (long i = 0; i < static_cast<long>(k); ++i)
+            lambda_k[static_cast<vcl_size_t>(i)] = dc_secular_root(&(dl[0]), &(w[0]), k, static_cast<vcl_size_t>(i), rho, &(delta[static_cast<vcl_size_t>(i) * k]));
+
+          // recompute w from the computed eigenvalues (Gu and Eisenstat), so that the eigenvectors are numerically orthogonal:
+          std::vector<ScalarType> w_hat(k);
+          for (vcl_size_t j = 0; j < k; ++j)
+          {
+            ScalarType prod = -delta[j * k + j] / rho;
+            for (vcl_size_t m = 0; m < k; ++m)
+              if (m != j)
+                prod *= -delta[m * k + j] / (dl[m] - dl[j]);
+            w_hat[j] = (w[j] < 0 ? -1 : 1) * std::sqrt(std::fabs(prod));
+          }
+
+          // eigenvectors of diag(dl) + rho w w^T:
+          std::vector<ScalarType> U(k * k);
+#ifdef VIENNACL_WITH_OPENMP
+          #pragma omp parallel for
+#endif
+          for (long i = 0; i < static_cast<long>(k); ++i)
+          {
+            ScalarType * u_i = &(U[static_cast<vcl_size_t>(i) * k]);
+            ScalarType const * delta_i = &(delta[static_cast<vcl_size_t>(i) * k]);
+            ScalarType u_norm = 0;
+            for (vcl_size_t j = 0; j < k; ++j)
+            {
+              u_i[j] = w_hat[j] / delta_i[j];
+              u_norm += u_i[j] * u_i[j];
+            }
+            u_norm = std::sqrt(u_norm);
+            for (vcl_size_t j = 0; j < k; ++j)
+              u_i[j] /= u_norm;
+          }
+
+          // back-transformation: eigenvectors are Qm(:, nondeflated) * U.
+          // Columns stemming from the first (second) subproblem vanish in the last n2 (first n1) rows unless mixed by a deflating rotation,
+          // so the columns are grouped accordingly and the product is computed separately for the upper and the lower rows (cf. LAPACK's xLAED3).
+          std::vector<vcl_size_t> grouped;
+          grouped.reserve(k);
+          for (int group = 1; group <= 3; ++group)
+            for (vcl_size_t i = 0; i < k; ++i)
+              if (column_type[nondeflated[i]] == (group == 2 ? 3 : (group == 1 ? 1 : 2)))
+                grouped.push_back(i);
+          vcl_size_t num_upper = 0, num_mixed = 0;
+          for (vcl_size_t i = 0; i < k; ++i)
+          {
+            if (column_type[nondeflated[i]] == 1) ++num_upper;
+            if (column_type[nondeflated[i]] == 3) ++num_mixed;
+          }
+
+          std::vector<ScalarType> Q_grouped(n * k);
+          std::vector<ScalarType> U_grouped(k * k);
+          for (vcl_size_t i = 0; i < k; ++i)
+          {
+            std::copy(Qm.begin() + static_cast<long>(nondeflated[grouped[i]] * n), Qm.begin() + static_cast<long>((nondeflated[grouped[i]] + 1) * n),
+                      Q_grouped.begin() + static_cast<long>(i * n));
+            for (vcl_size_t j = 0; j < k; ++j)
+              U_grouped[j * k + i] = U[j * k + grouped[i]];
+          }
+
+          Qk.resize(n * k);
+          dc_gemm(&(Q_grouped[0]), n, &(U_grouped[0]), k, &(Qk[0]), n, n1, num_upper + num_mixed, k);
+          dc_gemm(&(Q_grouped[num_upper * n + n1]), n, &(U_grouped[num_upper]), k, &(Qk[n1]), n, n2, k - num_upper, k);
+
+          for (vcl_size_t i = 0; i < k; ++i)
+            lambda[i] = lambda_k[i];
+        }
+
+        // collect all eigenpairs and sort ascending:
+        std::vector<std::pair<ScalarType, vcl_size_t> > order;
+        order.reserve(n);
+        for (vcl_size_t i = 0; i < k; ++i)
+          order.push_back(std::make_pair(lambda[i], i));
+        for (vcl_size_t j = 0; j < n; ++j)
+          if (deflated[j])
+            order.push_back(std::make_pair(ds[j], k + j));
+        std::sort(order.begin(), order.end());
+
+        for (vcl_size_t i = 0; i < n; ++i)
+        {
+          d[i] = order[i].first;
+          ScalarType const * src = (order[i].second < k) ? &(Qk[order[i].second * n]) : &(Qm[(order[i].second - k) * n]);
+          std::copy(src, src + n, Z + i * ldz);
+        }
+      }
+
+      /** @brief Computes all eigenvalues and eigenvectors of a symmetric tridiagonal matrix using Cuppen's divide-and-conquer method.
+      *
+      * The matrix is split recursively into halves until the pieces are no larger than dc_leaf_size(). The leaves are solved in parallel with the QL method,
+      * then the pieces are merged level by level, where the merges of a level are processed in parallel.
+      *
+      * @param d   Diagonal of the matrix (n entries). Holds the eigenvalues in ascending order on exit
+      * @param e   Off-diagonal of the matrix (n-1 entries), e[i] couples i and i+1
+      * @param n   Size of the matrix
+      * @param Z   Eigenvectors on exit (column-major, n x n)
+      */
+      template <typename ScalarType>
+      void tridiagonal_dc(ScalarType * d, ScalarType const * e, vcl_size_t n, ScalarType * Z)
+      {
+        std::fill(Z, Z + n * n, ScalarType(0));
+        if (n == 0)
+          return;
+
+        // scale to unit norm:
+        ScalarType scale = 0;
+        for (vcl_size_t i = 0; i < n; ++i)
+          scale = std::max(scale, std::fabs(d[i]));
+        for (vcl_size_t i = 0; i + 1 < n; ++i)
+          scale = std::max(scale, std::fabs(e[i]));
+
+        if (scale <= 0)
+        {
+          for (vcl_size_t i = 0; i < n; ++i)
+            Z[i * n + i] = 1;
+          return;
+        }
+
+        std::vector<ScalarType> e_scaled(n, ScalarType(0));
+        for (vcl_size_t i = 0; i < n; ++i)
+          d[i] /= scale;
+        for (vcl_size_t i = 0; i + 1 < n; ++i)
+          e_scaled[i] = e[i] / scale;
+
+        // number of levels of the tree and leaf boundaries:
+        vcl_size_t levels = 0;
+        while ((n >> levels) > dc_leaf_size())
+          ++levels;
+        vcl_size_t num_leaves = vcl_size_t(1) << levels;
+
+        std::vector<vcl_size_t> boundaries(num_leaves + 1);
+        for (vcl_size_t i = 0; i <= num_leaves; ++i)
+          boundaries[i] = (i * n) / num_leaves;
+
+        // tear the matrix apart at the leaf boundaries:
+        for (vcl_size_t i = 1; i < num_leaves; ++i)
+        {
+          vcl_size_t s = boundaries[i];
+          ScalarType beta = std::fabs(e_scaled[s - 1]);
+          d[s - 1] -= beta;
+          d[s]     -= beta;
+        }
+
+        // leaves:
+#ifdef VIENNACL_WITH_OPENMP
+        #pragma omp parallel for
+#endif
+        for (long leaf = 0; leaf < static_cast<long>(num_leaves); ++leaf)
+        {
+          vcl_size_t start = boundaries[static_cast<vcl_size_t>(leaf)];
+          vcl_size_t size  = boundaries[static_cast<vcl_size_t>(leaf) + 1] - start;
+          ScalarType * Z_leaf = Z + start * n + start;
+
+          std::vector<ScalarType> e_leaf(size);
+          for (vcl_size_t i = 0; i + 1 < size; ++i)
+            e_leaf[i] = e_scaled[start + i];
+          for (vcl_size_t i = 0; i < size; ++i)
+            Z_leaf[i * n + i] = 1;
+
+          tql2_host_rotations<ScalarType> rotations(Z_leaf, size, n);
+          tql2(d + start, &(e_leaf[0]), size, std::numeric_limits<ScalarType>::epsilon(), rotations);
+          dc_sort_leaf(d + start, size, Z_leaf, n);
+        }
+
+        // merge level by level:
+        for (vcl_size_t level = 1; level <= levels; ++level)
+        {
+          vcl_size_t stride = vcl_size_t(1) << level;
+#ifdef VIENNACL_WITH_OPENMP
+          #pragma omp parallel for
+#endif
+          for (long node = 0; node < static_cast<long>(num_leaves / stride); ++node)
+          {
+            vcl_size_t start = boundaries[static_cast<vcl_size_t>(node) * stride];
+            vcl_size_t split = boundaries[static_cast<vcl_size_t>(node) * stride + stride / 2];
+            vcl_size_t end   = boundaries[static_cast<vcl_size_t>(node + 1) * stride];
+
+            dc_merge(d + start, Z + start * n + start, n, split - start, end - split, e_scaled[split - 1]);
+          }
+        }
+
+        for (vcl_size_t i = 0; i < n; ++i)
+          d[i] *= scale;
+      }
+    }
+
+    /** @brief Computes the eigenvalues and eigenvectors of a symmetric tridiagonal matrix T using the divide-and-conquer method. Experimental.
+    *
+    * The eigenvectors are obtained from GEMMs of the eigenvectors of the subproblems instead of the rotation sequences of the QL method, and the subproblems are solved in parallel if OpenMP is enabled.
+    * The diagonal and off-diagonal follow the convention of detail::tql2(), i.e. E(i) couples the entries i-1 and i, E(0) is ignored.
+    *
+    * @param D   The diagonal of T. Holds the eigenvalues in ascending order on exit
+    * @param E   The off-diagonal of T
+    * @param Q   On entry an orthogonal matrix (e.g. the identity, or the accumulated transformations of a tridiagonal reduction). On exit, Q is replaced by Q * Z, where the columns of Z are the eigenvectors of T
+    */
+    template <typename SCALARTYPE, typename F, unsigned int ALIGNMENT>
+    void tridiagonal_dc(boost::numeric::ublas::vector<SCALARTYPE> & D,
+                        boost::numeric::ublas::vector<SCALARTYPE> const & E,
+                        viennacl::matrix<SCALARTYPE, F, ALIGNMENT> & Q)
+    {
+      vcl_size_t n = D.size();
+      assert(Q.size1() == n && Q.size2() == n && bool("Size mismatch in tridiagonal_dc()"));
+
+      if (n == 0)
+        return;
+
+      std::vector<SCALARTYPE> d(D.begin(), D.end());
+      std::vector<SCALARTYPE> e(n);
+      for (vcl_size_t i = 1; i < n; ++i)
+        e[i - 1] = E(i);
+
+      std::vector<SCALARTYPE> Z(n * n);
+      detail::tridiagonal_dc(&(d[0]), &(e[0]), n, &(Z[0]));
+
+      for (vcl_size_t i = 0; i < n; ++i)
+        D(i) = d[i];
+
+      std::vector<SCALARTYPE> Z_internal(Q.internal_size());
+      for (vcl_size_t j = 0; j < n; ++j)
+        for (vcl_size_t i = 0; i < n; ++i)
+          Z_internal[F::mem_index(i, j, Q.internal_size1(), Q.internal_size2())] = Z[j * n + i];
+
+      viennacl::matrix<SCALARTYPE, F, ALIGNMENT> Z_matrix(n, n, viennacl::traits::context(Q));
+      viennacl::backend::memory_write(Z_matrix.handle(), 0, sizeof(SCALARTYPE) * Z_internal.size(), &(Z_internal[0]));
+
+      viennacl::matrix<SCALARTYPE, F, ALIGNMENT> Q_old(Q);
+      Q = viennacl::linalg::prod(Q_old, Z_matrix);
+    }
+
+  }
+}
+
+#endif
@@ -0,0 +1,557 @@
+#ifndef VIENNACL_LINALG_TRIDIAGONAL_REDUCTION_HPP_
+#define VIENNACL_LINALG_TRIDIAGONAL_REDUCTION_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/tridiagonal_reduction.hpp
+    @brief Two-stage reduction of dense symmetric matrices to tridiagonal form on the host (dense to band, then band to tridiagonal by bulge chasing). Experimental.
+*/
+
+#include <vector>
+#include <algorithm>
+
+#include "viennacl/forwards.h"
+#include "viennacl/linalg/qr.hpp"
+#include "viennacl/linalg/qr-method-common.hpp"
+#include "viennacl/linalg/tridiagonal_dc.hpp"
+
+namespace viennacl
+{
+  namespace linalg
+  {
+    namespace detail
+    {
+      /** @brief Semi-bandwidth of the intermediate band matrix of the two-stage tridiagonal reduction */
+      inline vcl_size_t tridiagonal_band_size() { return 32; }
+
+      /** @brief Number of bulge chasing steps by which a sweep of the band reduction lags behind the previous sweep. Sweeps that far apart touch disjoint parts of the matrix and run concurrently. */
+      inline vcl_size_t tridiagonal_sweep_lag() { return 4; }
+
+      /** @brief Householder reflectors of both stages of the tridiagonal reduction as needed for the back-transformation of eigenvectors */
+      template <typename ScalarType>
+      struct tridiagonal_reflectors
+      {
+        tridiagonal_reflectors() : size(0), band_size(0) {}
+
+        vcl_size_t size;
+        vcl_size_t band_size;
+
+        /** @brief Panel p of the dense-to-band stage: column-major n x band_size block, the i-th reflector has its unit entry in row (p+1)*band_size + i */
+        std::vector<ScalarType> panel_vectors;
+        std::vector<ScalarType> panel_betas;
+
+        /** @brief Reflectors of the bulge chasing stage, band_size entries each, ordered by sweep and step */
+        std::vector<ScalarType> chase_vectors;
+        std::vector<ScalarType> chase_betas;
+        /** @brief Index of the first reflector of each sweep */
+        std::vector<vcl_size_t> sweep_offsets;
+      };
+
+      /** @brief Number of bulge chasing steps of sweep j for an n x n matrix with semi-bandwidth b */
+      inline vcl_size_t band_sweep_steps(vcl_size_t n, vcl_size_t b, vcl_size_t j)
+      {
+        return (j + 3 <= n) ? (n - 3 - j) / b + 1 : 0;
+      }
+
+      /** @brief First stage: reduces the symmetric matrix A to a matrix with semi-bandwidth b by a two-sided application of blocked Householder reflectors.
+      *
+      * For each panel, the trailing matrix is updated as A -= V Z^T + Z V^T with Z = A V T - V (T^T V^T A V T) / 2 (cf. LAPACK's xSYTRD_SY2SB).
+      *
+      * @param A      The matrix (column-major, n x n, both triangles are referenced and updated)
+      * @param n      Size of the matrix
+      * @param b      Semi-bandwidth of the result
+      * @param refl   Receives the reflectors of the panels
+      */
+      template <typename ScalarType>
+      void symmetric_to_band(ScalarType * A, vcl_size_t n, vcl_size_t b, tridiagonal_reflectors<ScalarType> & refl)
+      {
+        std::vector<ScalarType> T, VT, Y, M, Z;
+
+        for (vcl_size_t j = 0; j + b + 1 < n; j += b)
+        {
+          vcl_size_t p  = j / b;
+          vcl_size_t r0 = j + b;
+          vcl_size_t m  = n - r0;
+          vcl_size_t k  = std::min(b, m);
+
+          refl.panel_vectors.resize((p + 1) * n * b);
+          refl.panel_betas.resize((p + 1) * b);
+          ScalarType * V     = &(refl.panel_vectors[p * n * b]);
+          ScalarType * betas = &(refl.panel_betas[p * b]);
+
+          // QR factorization of the panel A(r0:n, j:j+b):
+          ScalarType * panel = A + j * n;
+          qr_panel_householder(panel, n, r0, k, betas);
+          if (k < b)
+          {
+            qr_form_T(panel, n, r0, k, betas, T);
+            qr_apply_block_reflector(panel, n, r0, k, T, true, panel + k * n, b - k);
+          }
+
+          // move the Householder vectors out of A, leaving R, and restore symmetry of the panel:
+          for (vcl_size_t q = 0; q < k; q++)
+          {
+            V[q * n + r0 + q] = 1;
+            for (vcl_size_t i = r0 + q + 1; i < n; i++)
+            {
+              V[q * n + i] = panel[q * n + i];
+              panel[q * n + i] = 0;
+            }
+          }
+          for (vcl_size_t q = 0; q < b; q++)
+            for (vcl_size_t i = r0; i < n; i++)
+              A[i * n + j + q] = panel[q * n + i];
+
+          qr_form_T(V, n, r0, k, betas, T);
+
+          // VT = V T (row-major m x k):
+          VT.assign(m * k, ScalarType(0));
+          for (vcl_size_t i = 0; i < m; i++)
+            for (vcl_size_t q = 0; q < k; q++)
+            {
+              ScalarType temp = 0;
+              for (vcl_size_t l = 0; l <= q; l++)
+                temp += V[l * n + r0 + i] * T[q * k + l];
+              VT[i * k + q] = temp;
+            }
+
+          // Y = A22 V T (row-major m x k), where A22 = A(r0:n, r0:n) is symmetric:
+          Y.assign(m * k, ScalarType(0));
+#ifdef VIENNACL_WITH_OPENMP
+          #pragma omp parallel for
+#endif
+          for (long i2 = 0; i2 < static_cast<long>(m); i2++)
+          {
+            vcl_size_t i = static_cast<vcl_size_t>(i2);
+            ScalarType const * a_i = A + (r0 + i) * n + r0;
+            ScalarType * y_i = &(Y[i * k]);
+            for (vcl_size_t r = 0; r < m; r++)
+            {
+              ScalarType a_ri = a_i[r];
+              ScalarType const * vt_r = &(VT[r * k]);
+              for (vcl_size_t q = 0; q < k; q++)
+                y_i[q] += a_ri * vt_r[q];
+            }
+          }
+
+          // M = (V T)^T Y:
+          M.assign(k * k, ScalarType(0));
+          ordered_partial_sums<ScalarType> M_partial(M.size());
+#ifdef VIENNACL_WITH_OPENMP
+          #pragma omp parallel
+#endif
+          {
+            ScalarType * M_local = M_partial.local();
+
+#ifdef VIENNACL_WITH_OPENMP
+            #pragma omp for schedule(static)
+#endif
+            for (long i2 = 0; i2 < static_cast<long>(m); i2++)
+            {
+              vcl_size_t i = static_cast<vcl_size_t>(i2);
+              for (vcl_size_t l = 0; l < k; l++)
+              {
+                ScalarType vt_il = VT[i * k + l];
+                for (vcl_size_t q = 0; q < k; q++)
+                  M_local[l * k + q] += vt_il * Y[i * k + q];
+              }
+            }
+          }
+          M_partial.add_to(M);
+
+          // Z = Y - V M / 2 (column-major m x k):
+          Z.resize(m * k);
+          for (vcl_size_t i = 0; i < m; i++)
+            for (vcl_size_t q = 0; q < k; q++)
+            {
+              ScalarType temp = 0;
+              for (vcl_size_t l = 0; l < k; l++)
+                temp += V[l * n + r0 + i] * M[l * k + q];
+              Z[q * m + i] = Y[i * k + q] - temp / 2;
+            }
+
+          // A22 -= V Z^T + Z V^T, where only the lower triangle is computed and then mirrored:
+#ifdef VIENNACL_WITH_OPENMP
+          #pragma omp parallel for schedule(dynamic, 16)
+#endif
+          for (long c2 = 0; c2 < static_cast<long>(m); c2++)
+          {
+            vcl_size_t c = static_cast<vcl_size_t>(c2);
+            ScalarType * a_c = A + (r0 + c) * n + r0;
+            for (vcl_size_t q = 0; q < k; q++)
+            {
+              ScalarType const * v_q = V + q * n + r0;
+              ScalarType const * z_q = &(Z[q * m]);
+              ScalarType z_cq = z_q[c];
+              ScalarType v_cq = v_q[c];
+              for (vcl_size_t r = c; r < m; r++)
+                a_c[r] -= v_q[r] * z_cq + z_q[r] * v_cq;
+            }
+          }
+
+#ifdef VIENNACL_WITH_OPENMP
+          #pragma omp parallel for
+#endif
+          for (long c2 = 0; c2 < static_cast<long>(m); c2++)
+          {
+            vcl_size_t c = static_cast<vcl_size_t>(c2);
+            ScalarType * a = A + r0 * n + r0 + c;
+            for (vcl_size_t r = c + 1; r < m; r++)
+              a[r * n] = a[c * n + r - c];
+          }
+        }
+      }
+
+      /** @brief Step k of sweep j of the bulge chasing: annihilates column c below its first entry in the rows s, ..., s+b-1 and applies the reflector from both sides. */
+      template <typename ScalarType>
+      void band_chase_step(ScalarType * A, vcl_size_t n, vcl_size_t b, vcl_size_t j, vcl_size_t k, ScalarType * v, ScalarType & beta)
+      {
+        vcl_size_t c   = (k == 0) ? j : j + 1 + (k - 1) * b;
+        vcl_size_t s   = j + 1 + k * b;
+        vcl_size_t len = std::min(b, n - s);
+
+        ScalarType * a_c = A + c * n;
+        ScalarType alpha = a_c[s];
+        for (vcl_size_t i = 1; i < len; i++)
+          v[i] = a_c[s + i];
+        v[0] = 1;
+        beta = householder_reflector(alpha, v + 1, len - 1, 1);
+
+        a_c[s] = alpha;
+        A[s * n + c] = alpha;
+        for (vcl_size_t i = 1; i < len; i++)
+        {
+          a_c[s + i] = 0;
+          A[(s + i) * n + c] = 0;
+        }
+
+        if (beta == 0)
+          return;
+
+        // The remaining nonzeros in the rows and columns s, ..., s+len-1 are confined to c+1, ..., s+len+b-1:
+        vcl_size_t lo = c + 1;
+        vcl_size_t hi = std::min(n, s + len + b);
+
+        // from the left:
+        for (vcl_size_t col = lo; col < hi; col++)
+        {
+          ScalarType * a = A + col * n + s;
+          ScalarType temp = 0;
+          for (vcl_size_t i = 0; i < len; i++)
+            temp += v[i] * a[i];
+          temp *= beta;
+          for (vcl_size_t i = 0; i < len; i++)
+            a[i] -= temp * v[i];
+        }
+
+        // from the right:
+        ScalarType w[256];
+        for (vcl_size_t r0 = lo; r0 < hi; r0 += 256)
+        {
+          vcl_size_t r1 = std::min(hi, r0 + 256);
+          for (vcl_size_t r = r0; r < r1; r++)
+            w[r - r0] = 0;
+          for (vcl_size_t i = 0; i < len; i++)
+          {
+            ScalarType const * a = A + (s + i) * n;
+            for (vcl_size_t r = r0; r < r1; r++)
+              w[r - r0] += a[r] * v[i];
+          }
+          for (vcl_size_t i = 0; i < len; i++)
+          {
+            ScalarType * a = A + (s + i) * n;
+            ScalarType bv = beta * v[i];
+            for (vcl_size_t r = r0; r < r1; r++)
+              a[r] -= w[r - r0] * bv;
+          }
+        }
+      }
+
+      /** @brief Second stage: reduces a symmetric matrix with semi-bandwidth b to tridiagonal form by Householder-based bulge chasing.
+      *
+      * Sweep j annihilates column j outside the tridiagonal band and chases the resulting bulge down the band. Sweep j+1 starts once sweep j is tridiagonal_sweep_lag() steps ahead, so the steps of several sweeps are executed concurrently.
+      *
+      * @param A      The band matrix (stored as dense column-major n x n matrix, both triangles are referenced). Destroyed on exit
+      * @param n      Size of the matrix
+      * @param b      Semi-bandwidth of A
+      * @param d      Diagonal of the tridiagonal matrix on exit
+      * @param e      Off-diagonal of the tridiagonal matrix on exit, e[i] couples i and i+1
+      * @param refl   Receives the reflectors of the bulge chasing
+      */
+      template <typename ScalarType>
+      void band_to_tridiagonal(ScalarType * A, vcl_size_t n, vcl_size_t b, ScalarType * d, ScalarType * e, tridiagonal_reflectors<ScalarType> & refl)
+      {
+        vcl_size_t num_sweeps = (n > 2) ? n - 2 : 0;
+        vcl_size_t lag = tridiagonal_sweep_lag();
+
+        refl.sweep_offsets.resize(num_sweeps + 1);
+        refl.sweep_offsets[0] = 0;
+        vcl_size_t num_slots = 0;
+        for (vcl_size_t j = 0; j < num_sweeps; j++)
+        {
+          vcl_size_t steps = band_sweep_steps(n, b, j);
+          refl.sweep_offsets[j + 1] = refl.sweep_offsets[j] + steps;
+          num_slots = std::max(num_slots, lag * j + steps);
+        }
+        refl.chase_vectors.assign(refl.sweep_offsets[num_sweeps] * b, ScalarType(0));
+        refl.chase_betas.assign(refl.sweep_offsets[num_sweeps], ScalarType(0));
+
+        // in time slot t, sweep j carries out step t - lag * j:
+        std::vector<vcl_size_t> active;
+        for (vcl_size_t t = 0; t < num_slots; t++)
+        {
+          active.clear();
+          for (vcl_size_t j = 0; j < num_sweeps && lag * j <= t; j++)
+            if (t - lag * j < band_sweep_steps(n, b, j))
+              active.push_back(j);
+
+#ifdef VIENNACL_WITH_OPENMP
+          #pragma omp parallel for if (active.size() > 1)
+#endif
+          for (long a = 0; a < static_cast<long>(active.size()); a++)
+          {
+            vcl_size_t j = active[static_cast<vcl_size_t>(a)];
+            vcl_size_t k = t - lag * j;
+            vcl_size_t index = refl.sweep_offsets[j] + k;
+            band_chase_step(A, n, b, j, k, &(refl.chase_vectors[index * b]), refl.chase_betas[index]);
+          }
+        }
+
+        for (vcl_size_t i = 0; i < n; i++)
+        {
+          d[i] = A[i * n + i];
+          e[i] = (i + 1 < n) ? A[i * n + i + 1] : 0;
+        }
+      }
+
+      /** @brief Reduces the symmetric matrix A to tridiagonal form T = Q^T A Q in two stages (dense to band, band to tridiagonal).
+      *
+      * @param A      The matrix (column-major, n x n, both triangles are referenced). Destroyed on exit
+      * @param n      Size of the matrix
+      * @param d      Diagonal of T on exit
+      * @param e      Off-diagonal of T on exit, e[i] couples i and i+1
+      * @param refl   Receives the reflectors defining Q, cf. tridiagonal_back_transformation()
+      */
+      template <typename ScalarType>
+      void tridiagonal_reduction(ScalarType * A, vcl_size_t n, ScalarType * d, ScalarType * e, tridiagonal_reflectors<ScalarType> & refl)
+      {
+        refl.size = n;
+        refl.band_size = std::max<vcl_size_t>(1, std::min(tridiagonal_band_size(), n));
+
+        symmetric_to_band(A, n, refl.band_size, refl);
+        band_to_tridiagonal(A, n, refl.band_size, d, e, refl);
+      }
+
+      /** @brief Applies the reflector (I - beta v v^T) of length len to the rows s, ..., s+len-1 of the columns col_start, ..., col_stop-1 of Z. Four columns are processed at once to reuse the loaded entries of v. */
+      template <typename ScalarType>
+      void band_apply_reflector(ScalarType const * v, ScalarType beta, vcl_size_t s, vcl_size_t len,
+                                ScalarType * Z, vcl_size_t ldz, vcl_size_t col_start, vcl_size_t col_stop)
+      {
+        vcl_size_t col = col_start;
+        for (; col + 4 <= col_stop; col += 4)
+        {
+          ScalarType * z0 = Z + col * ldz + s;
+          ScalarType * z1 = z0 + ldz;
+          ScalarType * z2 = z1 + ldz;
+          ScalarType * z3 = z2 + ldz;
+          ScalarType t0 = 0, t1 = 0, t2 = 0, t3 = 0;
+          for (vcl_size_t i = 0; i < len; i++)
+          {
+            t0 += v[i] * z0[i];
+            t1 += v[i] * z1[i];
+            t2 += v[i] * z2[i];
+            t3 += v[i] * z3[i];
+          }
+          t0 *= beta; t1 *= beta; t2 *= beta; t3 *= beta;
+          for (vcl_size_t i = 0; i < len; i++)
+          {
+            z0[i] -= t0 * v[i];
+            z1[i] -= t1 * v[i];
+            z2[i] -= t2 * v[i];
+            z3[i] -= t3 * v[i];
+          }
+        }
+        for (; col < col_stop; col++)
+        {
+          ScalarType * z = Z + col * ldz + s;
+          ScalarType temp = 0;
+          for (vcl_size_t i = 0; i < len; i++)
+            temp += v[i] * z[i];
+          temp *= beta;
+          for (vcl_size_t i = 0; i < len; i++)
+            z[i] -= temp * v[i];
+        }
+      }
+
+      /** @brief Computes C <- (I - V T V^T) C for the rows r0, ..., r0+m-1 of the columns col_start, ..., col_stop-1 of C, where V is given row-wise.
+      *
+      * @param V_rows     The m x k matrix V (row-major)
+      * @param T          Upper triangular k x k factor as computed by qr_form_T()
+      */
+      template <typename ScalarType>
+      void band_apply_panel(std::vector<ScalarType> const & V_rows, std::vector<ScalarType> const & T, vcl_size_t r0, vcl_size_t m, vcl_size_t k,
+                            ScalarType * C, vcl_size_t ldc, vcl_size_t col_start, vcl_size_t col_stop)
+      {
+        std::vector<ScalarType> W(4 * k), TW(4 * k);
+        for (vcl_size_t col = col_start; col < col_stop; col += 4)
+        {
+          vcl_size_t nc = std::min<vcl_size_t>(4, col_stop - col);
+          ScalarType * c0 = C + col * ldc + r0;
+          ScalarType * c1 = (nc > 1) ? c0 + ldc : c0;
+          ScalarType * c2 = (nc > 2) ? c0 + 2 * ldc : c0;
+          ScalarType * c3 = (nc > 3) ? c0 + 3 * ldc : c0;
+
+          // W = V^T C:
+          std::fill(W.begin(), W.end(), ScalarType(0));
+          ScalarType * w0 = &(W[0]);
+          ScalarType * w1 = w0 + k;
+          ScalarType * w2 = w1 + k;
+          ScalarType * w3 = w2 + k;
+          for (vcl_size_t r = 0; r < m; r++)
+          {
+            ScalarType const * v_r = &(V_rows[r * k]);
+            ScalarType c0_r = c0[r], c1_r = c1[r], c2_r = c2[r], c3_r = c3[r];
+            for (vcl_size_t q = 0; q < k; q++)
+            {
+              w0[q] += v_r[q] * c0_r;
+              w1[q] += v_r[q] * c1_r;
+              w2[q] += v_r[q] * c2_r;
+              w3[q] += v_r[q] * c3_r;
+            }
+          }
+
+          // W = T W:
+          for (vcl_size_t c = 0; c < 4; c++)
+            for (vcl_size_t i = 0; i < k; i++)
+            {
+              ScalarType temp = 0;
+              for (vcl_size_t l = i; l < k; l++)
+                temp += T[l * k + i] * W[c * k + l];
+              TW[c * k + i] = temp;
+            }
+
+          // C -= V W:
+          w0 = &(TW[0]);
+          w1 = w0 + k;
+          w2 = w1 + k;
+          w3 = w2 + k;
+          for (vcl_size_t r = 0; r < m; r++)
+          {
+            ScalarType const * v_r = &(V_rows[r * k]);
+            ScalarType t0 = 0, t1 = 0, t2 = 0, t3 = 0;
+            for (vcl_size_t q = 0; q < k; q++)
+            {
+              t0 += v_r[q] * w0[q];
+              t1 += v_r[q] * w1[q];
+              t2 += v_r[q] * w2[q];
+              t3 += v_r[q] * w3[q];
+            }
+            c0[r] -= t0;
+            if (nc > 1) c1[r] -= t1;
+            if (nc > 2) c2[r] -= t2;
+            if (nc > 3) c3[r] -= t3;
+          }
+        }
+      }
+
+      /** @brief Computes Z <- Q Z for the orthogonal matrix Q of tridiagonal_reduction(), i.e. maps eigenvectors of T to eigenvectors of A.
+      *
+      * Blocks of columns of Z are distributed over the threads, so that each pass over the reflectors updates several columns.
+      *
+      * @param refl       The reflectors as obtained from tridiagonal_reduction()
+      * @param Z          The matrix (column-major, n rows, leading dimension n)
+      * @param num_cols   Number of columns of Z
+      */
+      template <typename ScalarType>
+      void tridiagonal_back_transformation(tridiagonal_reflectors<ScalarType> const & refl, ScalarType * Z, vcl_size_t num_cols)
+      {
+        vcl_size_t n = refl.size;
+        vcl_size_t b = refl.band_size;
+        vcl_size_t block_size = 32;
+        long num_blocks = static_cast<long>((num_cols + block_size - 1) / block_size);
+
+        // bulge chasing reflectors in reverse order:
+        vcl_size_t num_sweeps = refl.sweep_offsets.size() ? refl.sweep_offsets.size() - 1 : 0;
+#ifdef VIENNACL_WITH_OPENMP
+        #pragma omp parallel for
+#endif
+        for (long blk = 0; blk < num_blocks; blk++)
+        {
+          vcl_size_t col_start = static_cast<vcl_size_t>(blk) * block_size;
+          vcl_size_t col_stop  = std::min(num_cols, col_start + block_size);
+          for (vcl_size_t j = num_sweeps; j-- > 0;)
+            for (vcl_size_t k = band_sweep_steps(n, b, j); k-- > 0;)
+            {
+              vcl_size_t index = refl.sweep_offsets[j] + k;
+              vcl_size_t s = j + 1 + k * b;
+              if (refl.chase_betas[index] != 0)
+                band_apply_reflector(&(refl.chase_vectors[index * b]), refl.chase_betas[index], s, std::min(b, n - s), Z, n, col_start, col_stop);
+            }
+        }
+
+        // panels of the dense-to-band stage in reverse order:
+        std::vector<ScalarType> T, V_rows;
+        vcl_size_t num_panels = refl.panel_betas.size() / b;
+        for (vcl_size_t p = num_panels; p-- > 0;)
+        {
+          vcl_size_t r0 = (p + 1) * b;
+          vcl_size_t m  = n - r0;
+          vcl_size_t k  = std::min(b, m);
+          ScalarType const * V = &(refl.panel_vectors[p * n * b]);
+
+          qr_form_T(V, n, r0, k, &(refl.panel_betas[p * b]), T);
+          V_rows.resize(m * k);
+          for (vcl_size_t i = 0; i < m; i++)
+            for (vcl_size_t q = 0; q < k; q++)
+              V_rows[i * k + q] = V[q * n + r0 + i];
+
+#ifdef VIENNACL_WITH_OPENMP
+          #pragma omp parallel for
+#endif
+          for (long blk = 0; blk < num_blocks; blk++)
+          {
+            vcl_size_t col_start = static_cast<vcl_size_t>(blk) * block_size;
+            band_apply_panel(V_rows, T, r0, m, k, Z, n, col_start, std::min(num_cols, col_start + block_size));
+          }
+        }
+      }
+
+      /** @brief Computes all eigenvalues and eigenvectors of a dense symmetric matrix on the host: two-stage tridiagonal reduction, divide-and-conquer, and back-transformation.
+      *
+      * @param A      The matrix (column-major, n x n, both triangles are referenced). Destroyed on exit
+      * @param n      Size of the matrix
+      * @param d      The eigenvalues in ascending order on exit
+      * @param Z      The eigenvectors on exit (column-major, n x n)
+      */
+      template <typename ScalarType>
+      void symmetric_eigen_host(ScalarType * A, vcl_size_t n, ScalarType * d, ScalarType * Z)
+      {
+        if (n == 0)
+          return;
+
+        std::vector<ScalarType> e(n);
+        tridiagonal_reflectors<ScalarType> refl;
+        tridiagonal_reduction(A, n, d, &(e[0]), refl);
+        tridiagonal_dc(d, &(e[0]), n, Z);
+        tridiagonal_back_transformation(refl, Z, n);
+      }
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,472 @@
+#ifndef VIENNACL_LINALG_TSQR_HPP
+#define VIENNACL_LINALG_TSQR_HPP
+
+/* =========================================================================
+   Copyright (c) 2010-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/tsqr.hpp
+    @brief Provides a tall-skinny QR factorization (TSQR) for matrices with many more rows than columns.
+
+    The rows are split into blocks, which are factored independently. The resulting R factors are combined pairwise in a binary reduction tree.
+    Cf. Demmel, Grigori, Hoemmen, Langou: Communication-optimal parallel and sequential QR and LU factorizations, SIAM J. Sci. Comput. 34(1), 2012.
+*/
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+#ifdef VIENNACL_WITH_OPENMP
+#include <omp.h>
+#endif
+
+#include "viennacl/linalg/qr.hpp"
+
+namespace viennacl
+{
+  namespace linalg
+  {
+    namespace detail
+    {
+      /** @brief A node of the TSQR reduction tree. Leaves hold the QR factorization of a row block of A, inner nodes the QR factorization of the stacked R factors of their children. */
+      template <typename ScalarType>
+      struct tsqr_node
+      {
+        tsqr_node() : rows(0), row_start(0) { children[0] = -1; children[1] = -1; }
+
+        vcl_size_t rows;                  //number of rows of the factored matrix
+        vcl_size_t row_start;             //leaves only: first row of the block in A
+        long children[2];                 //inner nodes only: the two children in the tree
+        std::vector<ScalarType> QR;       //column-major, R in the upper triangular part, Householder vectors below the diagonal
+        std::vector<ScalarType> betas;
+      };
+
+      /** @brief The implicit Q of a TSQR factorization: the tree nodes and the nodes created on each level of the tree (level 0 being the leaves). */
+      template <typename ScalarType>
+      struct tsqr_tree
+      {
+        std::vector< tsqr_node<ScalarType> >  nodes;
+        std::vector< std::vector<long> >       levels;
+        long                                   root;
+      };
+
+      /** @brief Returns the number of row blocks used by TSQR. Each block has at least n rows. */
+      inline vcl_size_t tsqr_num_blocks(vcl_size_t m, vcl_size_t n, vcl_size_t num_blocks)
+      {
+        if (num_blocks == 0)
+        {
+#ifdef VIENNACL_WITH_OPENMP
+          num_blocks = static_cast<vcl_size_t>(omp_get_max_threads());
+#else
+          num_blocks = 1;
+#endif
+        }
+        return std::max<vcl_size_t>(1, std::min(num_blocks, n > 0 ? m / n : 1));
+      }
+
+      /** @brief Computes the TSQR tree of the m x n matrix A with m >= n
+      *
+      * @param A            The matrix to be factored (Boost.uBLAS compatible)
+      * @param num_blocks   Number of row blocks (leaves of the tree)
+      * @param block_size   Number of columns per panel in the QR factorizations of the tree nodes
+      * @param tree         The resulting tree
+      */
+      template <typename MatrixType, typename ScalarType>
+      void tsqr_factor(MatrixType const & A, vcl_size_t num_blocks, vcl_size_t block_size, tsqr_tree<ScalarType> & tree)
+      {
+        vcl_size_t m = A.size1();
+        vcl_size_t n = A.size2();
+
+        tree.nodes.resize(num_blocks);
+        tree.levels.clear();
+        tree.levels.push_back(std::vector<long>(num_blocks));
+
+        //leaves: QR factorization of each row block, the rows being distributed evenly such that each block has at least n rows:
+#ifdef VIENNACL_WITH_OPENMP
+        #pragma omp parallel for
+#endif
+        for (long b=0; b<static_cast<long>(num_blocks); ++b)
+        {
+          vcl_size_t row_start = (static_cast<vcl_size_t>(b) * m) / num_blocks;
+          vcl_size_t row_stop  = (static_cast<vcl_size_t>(b + 1) * m) / num_blocks;
+          tsqr_node<ScalarType> & node = tree.nodes[static_cast<vcl_size_t>(b)];
+
+          node.rows = row_stop - row_start;
+          node.row_start = row_start;
+          node.QR.resize(node.rows * n);
+          node.betas.resize(n);
+          for (vcl_size_t k=0; k<n; ++k)
+            for (vcl_size_t i=0; i<node.rows; ++i)
+              node.QR[k*node.rows + i] = A(row_start + i, k);
+
+          qr_factor_buffer(&(node.QR[0]), node.rows, n, block_size, &(node.betas[0]));
+          tree.levels[0][static_cast<vcl_size_t>(b)] = b;
+        }
+
+        //reduction tree: the R factors of two neighboring nodes are stacked and factored again. An odd node is passed on to the next level.
+        std::vector<long> active = tree.levels[0];
+        while (active.size() > 1)
+        {
+          vcl_size_t num_pairs = active.size() / 2;
+          vcl_size_t first_new = tree.nodes.size();
+          tree.nodes.resize(first_new + num_pairs);
+          tree.levels.push_back(std::vector<long>(num_pairs));
+
+#ifdef VIENNACL_WITH_OPENMP
+          #pragma omp parallel for
+#endif
+          for (long p=0; p<static_cast<long>(num_pairs); ++p)
+          {
+            tsqr_node<ScalarType> & node = tree.nodes[first_new + static_cast<vcl_size_t>(p)];
+            node.rows = 2 * n;
+            node.QR.assign(node.rows * n, ScalarType(0));
+            node.betas.resize(n);
+
+            for (vcl_size_t c=0; c<2; ++c)
+            {
+              long child = active[2 * static_cast<vcl_size_t>(p) + c];
+              tsqr_node<ScalarType> const & child_node = tree.nodes[static_cast<vcl_size_t>(child)];
+              node.children[c] = child;
+              for (vcl_size_t k=0; k<n; ++k)
+                for (vcl_size_t i=0; i<=k; ++i)
+                  node.QR[k*node.rows + c*n + i] = child_node.QR[k*child_node.rows + i];
+            }
+
+            qr_factor_buffer(&(node.QR[0]), node.rows, n, block_size, &(node.betas[0]));
+            tree.levels.back()[static_cast<vcl_size_t>(p)] = static_cast<long>(first_new) + p;
+          }
+
+          std::vector<long> next(tree.levels.back());
+          if (active.size() % 2 == 1)
+            next.push_back(active.back());
+          active.swap(next);
+        }
+        tree.root = active[0];
+      }
+
+      /** @brief Forms the explicit m x n matrix Q of a TSQR tree in the column-major buffer Q (leading dimension m)
+      *
+      * The tree is traversed from the root to the leaves. Each node passes the n x n blocks of its thin Q on to its children.
+      */
+      template <typename ScalarType>
+      void tsqr_form_Q(tsqr_tree<ScalarType> const & tree, vcl_size_t m, vcl_size_t n, vcl_size_t block_size, std::vector<ScalarType> & Q)
+      {
+        //C[i] is the n x n matrix to which the thin Q of node i is applied:
+        std::vector< std::vector<ScalarType> > C(tree.nodes.size());
+        C[static_cast<vcl_size_t>(tree.root)].assign(n * n, ScalarType(0));
+        for (vcl_size_t i=0; i<n; ++i)
+          C[static_cast<vcl_size_t>(tree.root)][i*n + i] = 1;
+
+        for (vcl_size_t level = tree.levels.size() - 1; level > 0; --level)
+        {
+          std::vector<long> const & level_nodes = tree.levels[level];
+#ifdef VIENNACL_WITH_OPENMP
+          #pragma omp parallel for
+#endif
+          for (long p=0; p<static_cast<long>(level_nodes.size()); ++p)
+          {
+            vcl_size_t id = static_cast<vcl_size_t>(level_nodes[static_cast<vcl_size_t>(p)]);
+            tsqr_node<ScalarType> const & node = tree.nodes[id];
+
+            //Y = H [C; 0]:
+            std::vector<ScalarType> Y(node.rows * n);
+            for (vcl_size_t k=0; k<n; ++k)
+              std::copy(C[id].begin() + static_cast<long>(k*n), C[id].begin() + static_cast<long>((k+1)*n), Y.begin() + static_cast<long>(k*node.rows));
+            qr_apply_Q_buffer(&(node.QR[0]), node.rows, n, &(node.betas[0]), false, &(Y[0]), n, block_size);
+
+            for (vcl_size_t c=0; c<2; ++c)
+            {
+              std::vector<ScalarType> & C_child = C[static_cast<vcl_size_t>(node.children[c])];
+              C_child.resize(n * n);
+              for (vcl_size_t k=0; k<n; ++k)
+                std::copy(Y.begin() + static_cast<long>(k*node.rows + c*n), Y.begin() + static_cast<long>(k*node.rows + (c+1)*n), C_child.begin() + static_cast<long>(k*n));
+            }
+          }
+        }
+
+        //leaves: Q(block, :) = H_leaf [C; 0]
+        Q.resize(m * n);
+        std::vector<long> const & leaves = tree.levels[0];
+#ifdef VIENNACL_WITH_OPENMP
+        #pragma omp parallel for
+#endif
+        for (long b=0; b<static_cast<long>(leaves.size()); ++b)
+        {
+          vcl_size_t id = static_cast<vcl_size_t>(leaves[static_cast<vcl_size_t>(b)]);
+          tsqr_node<ScalarType> const & node = tree.nodes[id];
+
+          std::vector<ScalarType> Y(node.rows * n);
+          for (vcl_size_t k=0; k<n; ++k)
+            std::copy(C[id].begin() + static_cast<long>(k*n), C[id].begin() + static_cast<long>((k+1)*n), Y.begin() + static_cast<long>(k*node.rows));
+          qr_apply_Q_buffer(&(node.QR[0]), node.rows, n, &(node.betas[0]), false, &(Y[0]), n, block_size);
+
+          for (vcl_size_t k=0; k<n; ++k)
+            std::copy(Y.begin() + static_cast<long>(k*node.rows), Y.begin() + static_cast<long>((k+1)*node.rows), Q.begin() + static_cast<long>(k*m + node.row_start));
+        }
+      }
+
+      /** @brief Writes the upper triangular factor R of the root of a TSQR tree to R (n x n) */
+      template <typename ScalarType, typename MatrixType>
+      void tsqr_copy_R(tsqr_tree<ScalarType> const & tree, vcl_size_t n, MatrixType & R)
+      {
+        tsqr_node<ScalarType> const & root = tree.nodes[static_cast<vcl_size_t>(tree.root)];
+        for (vcl_size_t i=0; i<n; ++i)
+          for (vcl_size_t k=0; k<n; ++k)
+            R(i,k) = (i <= k) ? root.QR[k*root.rows + i] : ScalarType(0);
+      }
+
+      /** @brief Reconstructs Householder vectors and coefficients from the explicit thin Q of a QR factorization A = Q R
+      *
+      * With a diagonal sign matrix S, the unpivoted LU factorization Q - [S; 0] = V U yields the unit lower trapezoidal matrix of Householder vectors V.
+      * S is chosen in the course of the elimination as the negative sign of the current pivot, which keeps all pivots at least one in magnitude.
+      * Then H_0 ... H_{n-1} [I; 0] = Q S, the coefficients are beta_i = -S_ii U_ii, and the triangular factor matching the reflectors is S R.
+      * Cf. Ballard et al.: Reconstructing Householder vectors from tall-skinny QR, J. Parallel Distrib. Comput. 85, 2015.
+      *
+      * @param Q       Column-major m x n buffer holding Q on entry and V (below the diagonal) on exit
+      * @param m       Number of rows
+      * @param n       Number of columns
+      * @param betas   The n Householder coefficients
+      * @param signs   The diagonal of S
+      */
+      template <typename ScalarType>
+      void tsqr_householder_reconstruction(std::vector<ScalarType> & Q, vcl_size_t m, vcl_size_t n,
+                                           std::vector<ScalarType> & betas, std::vector<ScalarType> & signs)
+      {
+        betas.resize(n);
+        signs.resize(n);
+
+        //LU factorization of the upper n x n block with modified diagonal:
+        for (vcl_size_t i=0; i<n; ++i)
+        {
+          ScalarType * col_i = &(Q[i*m]);
+          signs[i] = (col_i[i] >= 0) ? ScalarType(-1) : ScalarType(1);
+          col_i[i] -= signs[i];
+          betas[i] = -signs[i] * col_i[i];
+
+          for (vcl_size_t r=i+1; r<n; ++r)
+            col_i[r] /= col_i[i];
+          for (vcl_size_t k=i+1; k<n; ++k)
+          {
+            ScalarType * col_k = &(Q[k*m]);
+            for (vcl_size_t r=i+1; r<n; ++r)
+              col_k[r] -= col_i[r] * col_k[i];
+          }
+        }
+
+        //the remaining rows solve L_2 U = Q_2 independently:
+        vcl_size_t row_block_size = qr_row_block_size();
+        long num_row_blocks = static_cast<long>((m - n + row_block_size - 1) / row_block_size);
+#ifdef VIENNACL_WITH_OPENMP
+        #pragma omp parallel for
+#endif
+        for (long rb=0; rb<num_row_blocks; ++rb)
+        {
+          vcl_size_t row_start = n + static_cast<vcl_size_t>(rb) * row_block_size;
+          vcl_size_t row_stop  = std::min(m, row_start + row_block_size);
+          for (vcl_size_t i=0; i<n; ++i)
+          {
+            ScalarType * col_i = &(Q[i*m]);
+            for (vcl_size_t l=0; l<i; ++l)
+            {
+              ScalarType const * col_l = &(Q[l*m]);
+              ScalarType U_li = col_i[l];
+              for (vcl_size_t r=row_start; r<row_stop; ++r)
+                col_i[r] -= col_l[r] * U_li;
+            }
+            ScalarType U_ii = col_i[i];
+            for (vcl_size_t r=row_start; r<row_stop; ++r)
+              col_i[r] /= U_ii;
+          }
+        }
+      }
+
+      /** @brief QR factorization of a m x n matrix with m < n, which has no tall-skinny structure. Uses inplace_qr_ublas() and recoverQ().
+       *
+       * The m x m factor Q is written to the first m columns of Q (if Q is not NULL) and the m x n factor R to the first m rows of R. All other entries are set to zero.
+       */
+      template <typename MatrixType>
+      void tsqr_wide(MatrixType const & A, MatrixType * Q, MatrixType & R, vcl_size_t block_size)
+      {
+        vcl_size_t m = A.size1();
+        vcl_size_t n = A.size2();
+
+        MatrixType A_qr(A);
+        std::vector<typename MatrixType::value_type> betas = inplace_qr_ublas(A_qr, block_size);
+        MatrixType Q_full(m, m);
+        MatrixType R_full(m, n);
+        viennacl::linalg::recoverQ(A_qr, betas, Q_full, R_full, block_size);
+
+        for (vcl_size_t i=0; i<n; ++i)
+          for (vcl_size_t k=0; k<n; ++k)
+            R(i,k) = (i < m) ? R_full(i,k) : 0;
+
+        if (Q)
+          for (vcl_size_t i=0; i<m; ++i)
+            for (vcl_size_t k=0; k<n; ++k)
+              (*Q)(i,k) = (k < m) ? Q_full(i,k) : 0;
+      }
+
+    } //namespace detail
+
+
+    /** @brief Tall-skinny QR factorization A = Q R of a m x n matrix A with m >= n, forming the thin factor Q explicitly.
+     *
+     * The row blocks of A as well as the nodes on each level of the reduction tree are factored in parallel.
+     * The diagonal entries of R may be negative.
+     * If m < n, the factorization is computed by inplace_qr() instead: The first m columns of Q hold the m x m orthogonal factor,
+     * the first m rows of R the m x n upper trapezoidal factor, and all remaining entries are zero.
+     *
+     * @param A            The matrix to be factored (Boost.uBLAS compatible)
+     * @param Q            The m x n matrix with orthonormal columns
+     * @param R            The n x n upper triangular factor
+     * @param num_blocks   Number of row blocks. If zero, the number of threads is used. Each block has at least n rows.
+     * @param block_size   Number of columns per panel in the local QR factorizations
+     */
+    template <typename MatrixType>
+    void tsqr(MatrixType const & A, MatrixType & Q, MatrixType & R, vcl_size_t num_blocks = 0, vcl_size_t block_size = 16)
+    {
+      typedef typename MatrixType::value_type   ScalarType;
+
+      vcl_size_t m = A.size1();
+      vcl_size_t n = A.size2();
+      if (m == 0 || n == 0)
+        return;
+      if (m < n)
+      {
+        detail::tsqr_wide(A, &Q, R, block_size);
+        return;
+      }
+
+      detail::tsqr_tree<ScalarType> tree;
+      detail::tsqr_factor(A, detail::tsqr_num_blocks(m, n, num_blocks), block_size, tree);
+      detail::tsqr_copy_R(tree, n, R);
+
+      std::vector<ScalarType> Q_buffer;
+      detail::tsqr_form_Q(tree, m, n, block_size, Q_buffer);
+      for (vcl_size_t i=0; i<m; ++i)
+        for (vcl_size_t k=0; k<n; ++k)
+          Q(i,k) = Q_buffer[k*m + i];
+    }
+
+    /** @brief Tall-skinny QR factorization of a m x n matrix A with m >= n, computing only the n x n upper triangular factor R.
+     *
+     * If m < n, the m x n factor R of inplace_qr() is written to the first m rows of R, the remaining rows are set to zero.
+     *
+     * @param A            The matrix to be factored (Boost.uBLAS compatible)
+     * @param R            The n x n upper triangular factor
+     * @param num_blocks   Number of row blocks. If zero, the number of threads is used. Each block has at least n rows.
+     * @param block_size   Number of columns per panel in the local QR factorizations
+     */
+    template <typename MatrixType>
+    void tsqr(MatrixType const & A, MatrixType & R, vcl_size_t num_blocks = 0, vcl_size_t block_size = 16)
+    {
+      typedef typename MatrixType::value_type   ScalarType;
+
+      vcl_size_t m = A.size1();
+      vcl_size_t n = A.size2();
+      if (m == 0 || n == 0)
+        return;
+      if (m < n)
+      {
+        detail::tsqr_wide(A, static_cast<MatrixType *>(NULL), R, block_size);
+        return;
+      }
+
+      detail::tsqr_tree<ScalarType> tree;
+      detail::tsqr_factor(A, detail::tsqr_num_blocks(m, n, num_blocks), block_size, tree);
+      detail::tsqr_copy_R(tree, n, R);
+    }
+
+    /** @brief Inplace tall-skinny QR factorization with the same output as inplace_qr(): R in the upper triangular part of A, the Householder vectors below.
+     *
+     * After the TSQR factorization, the Householder vectors are reconstructed from the explicit Q, hence the result can be passed to
+     * recoverQ() and inplace_qr_apply_trans_Q(). The diagonal entries of R may be negative.
+     * For a single row block, this is the same as inplace_qr().
+     *
+     * @param A            The matrix to be factored (Boost.uBLAS compatible), m >= n
+     * @param num_blocks   Number of row blocks. If zero, the number of threads is used. Each block has at least n rows.
+     * @param block_size   Number of columns per panel in the local QR factorizations
+     * @return             The coefficients beta_i of the Householder reflectors (I - beta_i v_i v_i^T)
+     */
+    template <typename MatrixType>
+    std::vector<typename MatrixType::value_type> inplace_tsqr(MatrixType & A, vcl_size_t num_blocks = 0, vcl_size_t block_size = 16)
+    {
+      typedef typename MatrixType::value_type   ScalarType;
+
+      vcl_size_t m = A.size1();
+      vcl_size_t n = A.size2();
+      num_blocks = detail::tsqr_num_blocks(m, n, num_blocks);
+      if (num_blocks == 1 || m < n)
+        return detail::inplace_qr_ublas(A, block_size);
+
+      detail::tsqr_tree<ScalarType> tree;
+      detail::tsqr_factor(A, num_blocks, block_size, tree);
+
+      std::vector<ScalarType> Q_buffer;
+      detail::tsqr_form_Q(tree, m, n, block_size, Q_buffer);
+
+      std::vector<ScalarType> betas;
+      std::vector<ScalarType> signs;
+      detail::tsqr_householder_reconstruction(Q_buffer, m, n, betas, signs);
+
+      //R with rows scaled by the signs in the upper triangle, Householder vectors below:
+      detail::tsqr_node<ScalarType> const & root = tree.nodes[static_cast<vcl_size_t>(tree.root)];
+      for (vcl_size_t i=0; i<m; ++i)
+        for (vcl_size_t k=0; k<n; ++k)
+          A(i,k) = (i <= k) ? signs[i] * root.QR[k*root.rows + i] : Q_buffer[k*m + i];
+
+      return betas;
+    }
+
+    /** @brief Overload of the tall-skinny QR factorization for a ViennaCL matrix. The factorization is computed on the host.
+     *
+     * @param A            The matrix to be factored
+     * @param Q            The m x n matrix with orthonormal columns
+     * @param R            The n x n upper triangular factor
+     * @param num_blocks   Number of row blocks. If zero, the number of threads is used.
+     */
+    template<typename T, typename F, unsigned int ALIGNMENT>
+    void tsqr(viennacl::matrix<T, F, ALIGNMENT> const & A, viennacl::matrix<T, F, ALIGNMENT> & Q, viennacl::matrix<T, F, ALIGNMENT> & R, vcl_size_t num_blocks = 0)
+    {
+      boost::numeric::ublas::matrix<T> ublas_A(A.size1(), A.size2());
+      boost::numeric::ublas::matrix<T> ublas_Q(A.size1(), A.size2());
+      boost::numeric::ublas::matrix<T> ublas_R(A.size2(), A.size2());
+      viennacl::copy(A, ublas_A);
+      tsqr(ublas_A, ublas_Q, ublas_R, num_blocks);
+      viennacl::copy(ublas_Q, Q);
+      viennacl::copy(ublas_R, R);
+    }
+
+    /** @brief Overload of the inplace tall-skinny QR factorization for a ViennaCL matrix. The factorization is computed on the host.
+     *
+     * @param A            The matrix to be factored
+     * @param num_blocks   Number of row blocks. If zero, the number of threads is used.
+     */
+    template<typename T, typename F, unsigned int ALIGNMENT>
+    std::vector<T> inplace_tsqr(viennacl::matrix<T, F, ALIGNMENT> & A, vcl_size_t num_blocks = 0)
+    {
+      boost::numeric::ublas::matrix<T> ublas_A(A.size1(), A.size2());
+      viennacl::copy(A, ublas_A);
+      std::vector<T> betas = inplace_tsqr(ublas_A, num_blocks);
+      viennacl::copy(ublas_A, A);
+      return betas;
+    }
+
+  } //linalg
+} //viennacl
+
+
+#endif
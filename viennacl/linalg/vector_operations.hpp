@@ -22,7 +22,9 @@
     @brief Implementations of vector operations.
 */
 
+#include <vector>
 #include "viennacl/forwards.h"
+#include "viennacl/backend/memory.hpp"
 #include "viennacl/scalar.hpp"
 #include "viennacl/tools/tools.hpp"
 #include "viennacl/meta/predicate.hpp"
@@ -213,6 +215,124 @@ namespace viennacl
     }
 
 
+    namespace detail
+    {
+      /** @brief Reads the entries of a vector (or -range, or -slice) in any memory domain to main memory */
+      template <typename T>
+      void read_entries(vector_base<T> const & vec, std::vector<T> & entries)
+      {
+        vcl_size_t start = viennacl::traits::start(vec);
+        vcl_size_t inc   = viennacl::traits::stride(vec);
+        vcl_size_t size  = viennacl::traits::size(vec);
+
+        entries.resize(size);
+        if (size == 0)
+          return;
+
+        std::vector<T> buffer((size - 1) * inc + 1);
+        viennacl::backend::memory_read(viennacl::traits::handle(vec), sizeof(T) * start, sizeof(T) * buffer.size(), &(buffer[0]));
+        for (vcl_size_t i = 0; i < size; ++i)
+          entries[i] = buffer[i * inc];
+      }
+
+      /** @brief Writes entries from main memory to a vector (or -range, or -slice) in any memory domain. Entries in between the elements of a slice are preserved. */
+      template <typename T>
+      void write_entries(std::vector<T> const & entries, vector_base<T> & vec)
+      {
+        vcl_size_t start = viennacl::traits::start(vec);
+        vcl_size_t inc   = viennacl::traits::stride(vec);
+        vcl_size_t size  = viennacl::traits::size(vec);
+
+        if (size == 0)
+          return;
+
+        std::vector<T> buffer((size - 1) * inc + 1);
+        if (inc > 1)
+          viennacl::backend::memory_read(viennacl::traits::handle(vec), sizeof(T) * start, sizeof(T) * buffer.size(), &(buffer[0]));
+        for (vcl_size_t i = 0; i < size; ++i)
+          buffer[i * inc] = entries[i];
+        viennacl::backend::memory_write(viennacl::traits::handle(vec), sizeof(T) * start, sizeof(T) * buffer.size(), &(buffer[0]));
+      }
+
+      /** @brief Implementation of convert() for memory domains without conversion kernels: The entries are converted in main memory. */
+      template <typename T1, typename T2>
+      void convert_in_main_memory(vector_base<T1> & vec1, vector_base<T2> const & vec2, T2 alpha)
+      {
+        std::vector<T2> entries2;
+        read_entries(vec2, entries2);
+
+        std::vector<T1> entries1(entries2.size());
+        for (vcl_size_t i = 0; i < entries2.size(); ++i)
+          entries1[i] = static_cast<T1>(alpha * entries2[i]);
+        write_entries(entries1, vec1);
+      }
+
+      /** @brief Implementation of inplace_add_converted() for memory domains without conversion kernels: The update is computed in main memory. */
+      template <typename T1, typename T2>
+      void inplace_add_converted_in_main_memory(vector_base<T1> & vec1, vector_base<T2> const & vec2, T1 alpha)
+      {
+        std::vector<T1> entries1;
+        std::vector<T2> entries2;
+        read_entries(vec1, entries1);
+        read_entries(vec2, entries2);
+
+        for (vcl_size_t i = 0; i < entries1.size(); ++i)
+          entries1[i] += alpha * static_cast<T1>(entries2[i]);
+        write_entries(entries1, vec1);
+      }
+    }
+
+    /** @brief Converts a vector to a different floating point precision and scales it: vec1 = alpha * vec2
+    *
+    * For vectors in OpenCL or CUDA memory, there are no conversion kernels yet. The entries are transferred to main memory, converted there and written back.
+    *
+    * @param vec1   The result vector (or -range, or -slice)
+    * @param vec2   The source vector (or -range, or -slice) of possibly different precision
+    * @param alpha  Scaling factor, applied in the precision of the source vector
+    */
+    template <typename T1, typename T2>
+    void convert(vector_base<T1> & vec1, vector_base<T2> const & vec2, T2 alpha = T2(1))
+    {
+      assert(viennacl::traits::size(vec1) == viennacl::traits::size(vec2) && bool("Incompatible vector sizes in convert()"));
+
+      switch (viennacl::traits::handle(vec1).get_active_handle_id())
+      {
+        case viennacl::MAIN_MEMORY:
+          viennacl::linalg::host_based::convert(vec1, vec2, alpha);
+          break;
+        case viennacl::MEMORY_NOT_INITIALIZED:
+          throw memory_exception("not initialised!");
+        default:
+          viennacl::linalg::detail::convert_in_main_memory(vec1, vec2, alpha);
+      }
+    }
+
+    /** @brief Adds a scaled vector of different floating point precision: vec1 += alpha * vec2, carried out in the precision of vec1
+    *
+    * For vectors in OpenCL or CUDA memory, there are no conversion kernels yet. The entries are transferred to main memory, updated there and written back.
+    *
+    * @param vec1   The result vector (or -range, or -slice)
+    * @param vec2   The vector (or -range, or -slice) of possibly different precision to be added
+    * @param alpha  Scaling factor
+    */
+    template <typename T1, typename T2>
+    void inplace_add_converted(vector_base<T1> & vec1, vector_base<T2> const & vec2, T1 alpha = T1(1))
+    {
+      assert(viennacl::traits::size(vec1) == viennacl::traits::size(vec2) && bool("Incompatible vector sizes in inplace_add_converted()"));
+
+      switch (viennacl::traits::handle(vec1).get_active_handle_id())
+      {
+        case viennacl::MAIN_MEMORY:
+          viennacl::linalg::host_based::inplace_add_converted(vec1, vec2, alpha);
+          break;
+        case viennacl::MEMORY_NOT_INITIALIZED:
+          throw memory_exception("not initialised!");
+        default:
+          viennacl::linalg::detail::inplace_add_converted_in_main_memory(vec1, vec2, alpha);
+      }
+    }
+
+
     ///////////////////////// Elementwise operations /////////////
 
 
@@ -98,16 +98,17 @@ namespace viennacl
     }
     else
     {
-      //full block can be copied:
+      //full block can be copied. The block contains the remaining columns of the rows, which must be preserved:
       std::vector<SCALARTYPE> entries(gpu_matrix_range.size1()*gpu_matrix_range.internal_size2());
 
-      //copy each stride separately:
+      vcl_size_t start_offset = gpu_matrix_range.start1() * gpu_matrix_range.internal_size2();
+      vcl_size_t num_entries = gpu_matrix_range.size1() * gpu_matrix_range.internal_size2();
+      viennacl::backend::memory_read(gpu_matrix_range.handle(), sizeof(SCALARTYPE)*start_offset, sizeof(SCALARTYPE)*num_entries, &(entries[0]));
+
       for (vcl_size_t i=0; i < gpu_matrix_range.size1(); ++i)
         for (vcl_size_t j=0; j < gpu_matrix_range.size2(); ++j)
           entries[i*gpu_matrix_range.internal_size2() + j] = cpu_matrix(i,j);
 
-      vcl_size_t start_offset = gpu_matrix_range.start1() * gpu_matrix_range.internal_size2();
-      vcl_size_t num_entries = gpu_matrix_range.size1() * gpu_matrix_range.internal_size2();
       viennacl::backend::memory_write(gpu_matrix_range.handle(), sizeof(SCALARTYPE)*start_offset, sizeof(SCALARTYPE)*num_entries, &(entries[0]));
       //std::cout << "Block copy worked!" << std::endl;
     }
@@ -140,16 +141,17 @@ namespace viennacl
      }
      else
      {
-       //full block can be copied:
+       //full block can be copied. The block contains the remaining rows of the columns, which must be preserved:
        std::vector<SCALARTYPE> entries(gpu_matrix_range.internal_size1()*gpu_matrix_range.size2());
 
-       //copy each stride separately:
+       vcl_size_t start_offset = gpu_matrix_range.start2() * gpu_matrix_range.internal_size1();
+       vcl_size_t num_entries = gpu_matrix_range.internal_size1() * gpu_matrix_range.size2();
+       viennacl::backend::memory_read(gpu_matrix_range.handle(), sizeof(SCALARTYPE)*start_offset, sizeof(SCALARTYPE)*num_entries, &(entries[0]));
+
        for (vcl_size_t i=0; i < gpu_matrix_range.size1(); ++i)
          for (vcl_size_t j=0; j < gpu_matrix_range.size2(); ++j)
            entries[i + j*gpu_matrix_range.internal_size1()] = cpu_matrix(i,j);
 
-       vcl_size_t start_offset = gpu_matrix_range.start2() * gpu_matrix_range.internal_size1();
-       vcl_size_t num_entries = gpu_matrix_range.internal_size1() * gpu_matrix_range.size2();
        viennacl::backend::memory_write(gpu_matrix_range.handle(), sizeof(SCALARTYPE)*start_offset, sizeof(SCALARTYPE)*num_entries, &(entries[0]));
        //std::cout << "Block copy worked!" << std::endl;
      }
@@ -193,7 +195,7 @@ namespace viennacl
        std::vector<SCALARTYPE> entries(gpu_matrix_range.size1()*gpu_matrix_range.internal_size2());
 
        vcl_size_t start_offset = gpu_matrix_range.start1() * gpu_matrix_range.internal_size2();
-       vcl_size_t num_entries = gpu_matrix_range.size1() * gpu_matrix_range.size2();
+       vcl_size_t num_entries = gpu_matrix_range.size1() * gpu_matrix_range.internal_size2();
          viennacl::backend::memory_read(gpu_matrix_range.handle(), sizeof(SCALARTYPE)*start_offset, sizeof(SCALARTYPE)*num_entries, &(entries[0]));
        //std::cout << "Block copy worked!" << std::endl;
 
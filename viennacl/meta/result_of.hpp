@@ -466,6 +466,18 @@ namespace viennacl
         typedef viennacl::vector<T,A>   type;
       };
 
+      template <typename T, unsigned int A>
+      struct vector_for_matrix< viennacl::ell_matrix<T, A> >
+      {
+        typedef viennacl::vector<T,A>   type;
+      };
+
+      template <typename T, unsigned int A>
+      struct vector_for_matrix< viennacl::hyb_matrix<T, A> >
+      {
+        typedef viennacl::vector<T,A>   type;
+      };
+
       #ifdef VIENNACL_WITH_UBLAS
       //Boost:
       template <typename T, typename F, typename A>
@@ -66,7 +66,7 @@ namespace viennacl{
     private:
       LARGE_INTEGER freq;
       LARGE_INTEGER start_time;
-	  LARGE_INTERGET end_time;
+      mutable LARGE_INTEGER end_time;
     };
 
   }
@@ -103,7 +103,7 @@ namespace viennacl{
       {
         struct timeval tval;
         gettimeofday(&tval, NULL);
-        double end_time = tval.tv_sec * 1000000 + tval.tv_usec;
+        double end_time = static_cast<double>(tval.tv_sec * 1000000 + tval.tv_usec);
 
         return static_cast<double>(end_time-ts) / 1000000.0;
       }